@@ -29,17 +29,106 @@
 #include <TStyle.h>
 #include <TSystem.h>
 #include <TTree.h>
+#include <TVector2.h>
 
 #include <CLHEP/Vector/ThreeVector.h>  // for Hep3Vector
 
+#include <omp.h>
+
 #include <algorithm>  // for max, max_element
 #include <cmath>      // for abs
+#include <cstdint>
 #include <iostream>
 #include <map>      // for _Rb_tree_const_iterator
 #include <string>   // for string
 #include <utility>  // for pair
 #include <vector>   // for vector
 
+namespace
+{
+  // pi0 pair cuts, the values keep the precision they always had in the loops
+  struct Pi0PairCuts
+  {
+    double pt1cut;
+    double pt2cut;
+    double pi0ptcut;
+    double alphacutval;
+    double deltaRconecut;
+  };
+
+  // cuts of Loop, iCs is the number of clusters of the event
+  Pi0PairCuts tower_by_tower_cuts(int iCs)
+  {
+    /////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////
+    // *********************************
+    //
+    //  CUTS FOLLOW HERE (e.g. pt cuts)
+    //
+    //*************************************
+    ///////////////////////////////////
+
+    // centrality dependent pt cuts designed to keep
+    // statistical cluster count   contribution (& sig/bkg)
+    // constant with all centrality
+    // in order to maximize statistical power i.e. using all events
+    // in the calibration not just peripheral events.
+    // this is neccessary for the summer 23 data because
+    // the event rate was small and the total statistics per
+    // stable calibration period (typically a daq run-length) is small
+
+    float modCutFactor = 1.0;
+    float pt1cut = 0;
+    float pt2cut = 0;
+
+    if (iCs < 30)
+    {
+      // pt1cut =  1.65*modCutFactor;
+      // pt2cut  = 0.8*modCutFactor;
+
+      pt1cut = 1.3 * modCutFactor;
+      pt2cut = 0.7 * modCutFactor;
+    }
+    else
+    {
+      // pt1cut = 1.65*modCutFactor +  1.4*(iCs-29)/200.0*modCutFactor;
+      // pt2cut = 0.8*modCutFactor +  1.4*(iCs-29)/200.0*modCutFactor;
+
+      pt1cut = 1.3 * modCutFactor + 1.4 * (iCs - 29) / 200.0 * modCutFactor;
+      pt2cut = 0.7 * modCutFactor + 1.4 * (iCs - 29) / 200.0 * modCutFactor;
+    }
+
+    float pi0ptcut = 1.22 * (pt1cut + pt2cut);
+
+    // energy asymmetry alpha cut
+    float alphacutval = 0.6;
+
+    float deltaRconecut = 1.1;  // 2-gamma opening angle(dR) cut
+    // value relevant for background extent in mass
+    //  not in peak area.
+
+    ////////////////////////////////////////////////////////
+    //////////////////////////////////
+    //   END CUTS
+    ///////////////////////////////////////
+    /////////////////////////////////////
+
+    return {pt1cut, pt2cut, pi0ptcut, alphacutval, deltaRconecut};
+  }
+
+  // cuts of Loop_for_eta_slices
+  constexpr Pi0PairCuts eta_slice_cuts{1.0, 0.6, 1.0, 0.50, 0.45};
+
+  // events with more clusters are skipped
+  constexpr int tower_by_tower_max_nclusters = 1000;
+  constexpr int eta_slice_max_nclusters = 60;
+
+  // margins of the candidate selection of the pair cache, far above the rounding
+  // of the cluster directions and pt with different correction factors
+  constexpr double pair_cache_pt_margin = 1e-4;
+  constexpr double pair_cache_dr_margin = 1e-4;
+}  // namespace
+
 //____________________________________________________________________________..
 CaloCalibEmc_Pi0::CaloCalibEmc_Pi0(const std::string &name, const std::string &filename)
   : SubsysReco(name)
@@ -417,13 +506,12 @@ int CaloCalibEmc_Pi0::End(PHCompositeNode *topNode)
 //______________________________________________________________________________..
 void CaloCalibEmc_Pi0::Loop(int nevts, const std::string &filename, TTree *intree, const std::string &incorrFile)
 {
-  // KINEMATIC CUTS ON PI0's ARE LISTED BELOW IN ONE SECTION OF COMMENTS
+  // KINEMATIC CUTS ON PI0's ARE LISTED IN tower_by_tower_cuts() AT THE TOP OF THIS FILE
   //
   //  search for  "CUTS FOLLOW HERE"
   //
-  //  they are centrality dependent (centrality = nclusters > minpt)  so they can only
-  //  defined after loading up this values from the ntuples
-  //  so they can't be moved here
+  //  they are centrality dependent (centrality = nclusters > minpt)  so they are
+  //  evaluated for every event after loading up this values from the ntuples
   //
 
   //  std::arrays have their indices backward, this is the old float myaggcorr[96][260];
@@ -470,35 +558,19 @@ void CaloCalibEmc_Pi0::Loop(int nevts, const std::string &filename, TTree *intre
     delete infileNt;
   }
 
-  std::cout << "in loop" << std::endl;
-
-  TTree *t1 = intree;
-  if (!intree)
+  if (!m_pair_cache_file.empty())
   {
-    TFile *f = new TFile(filename.c_str());
-    f->GetObject("_eventTree", t1);
-    if (!t1)
-    {
-      std::cout << PHWHERE << " could not load _eventTree from " << filename << std::endl;
-      gSystem->Exit(1);
-      exit(1);
-    }
+    Loop_pair_cache(CaloCalibEmc_Pi0PairCache::kTowerByTower, nevts, filename, intree, myaggcorr);
+    return;
   }
 
-  // Set Branches
-  //  t1->SetBranchAddress("_eventNumber", &_eventNumber);
-  t1->SetBranchAddress("_nClusters", &_nClusters);
-  //  t1->SetBranchAddress("_clusterIDs", _clusterIDs);
-  t1->SetBranchAddress("_clusterEnergies", _clusterEnergies);
-  t1->SetBranchAddress("_clusterPts", _clusterPts);
-  t1->SetBranchAddress("_clusterEtas", _clusterEtas);
-  t1->SetBranchAddress("_clusterPhis", _clusterPhis);
-  t1->SetBranchAddress("_maxTowerEtas", _maxTowerEtas);
-  t1->SetBranchAddress("_maxTowerPhis", _maxTowerPhis);
+  std::cout << "in loop" << std::endl;
+
+  TTree *t1 = get_event_tree(filename, intree);
 
   // pre-loop to save all the clusters LorentzVector
 
-  TLorentzVector *savClusLV[10000];
+  std::vector<TLorentzVector> savClusLV;
 
   //  int nEntries = (int) t1->GetEntriesFast();
   int nEntries = (int) t1->GetEntries();
@@ -527,15 +599,13 @@ void CaloCalibEmc_Pi0::Loop(int nevts, const std::string &filename, TTree *intre
 
     // see below this is like centrality cut, but currently need central events
     // as well as peripheral to maximize statistical power
-    if (nClusters > 1000)
+    if (nClusters > tower_by_tower_max_nclusters)
     {
       discarded_clusters += 1;
       continue;
     }
 
-    float pt1cut = 0;
-    float pt2cut = 0;
-
+    savClusLV.resize(nClusters);
     for (int j = 0; j < nClusters; j++)
     {
       // float px, py, pz;
@@ -567,69 +637,16 @@ void CaloCalibEmc_Pi0::Loop(int nevts, const std::string &filename, TTree *intre
       pt *= aggcv;
       E *= aggcv;
 
-      savClusLV[j] = new TLorentzVector();
-      savClusLV[j]->SetPtEtaPhiE(pt, eta, phi, E);
+      savClusLV[j].SetPtEtaPhiE(pt, eta, phi, E);
     }
 
-    TLorentzVector *pho1;
-    TLorentzVector *pho2;
     int iCs = nClusters;
+    const Pi0PairCuts cuts = tower_by_tower_cuts(iCs);
     for (int jCs = 0; jCs < iCs; jCs++)
     {
-      pho1 = savClusLV[jCs];
-      /////////////////////////////////////////////////////////////////
-      //////////////////////////////////////////////////////
-      // *********************************
-      //
-      //  CUTS FOLLOW HERE (e.g. pt cuts)
-      //
-      //*************************************
-      ///////////////////////////////////
-
-      // centrality dependent pt cuts designed to keep
-      // statistical cluster count   contribution (& sig/bkg)
-      // constant with all centrality
-      // in order to maximize statistical power i.e. using all events
-      // in the calibration not just peripheral events.
-      // this is neccessary for the summer 23 data because
-      // the event rate was small and the total statistics per
-      // stable calibration period (typically a daq run-length) is small
-
-      float modCutFactor = 1.0;
-
-      if (iCs < 30)
-      {
-        // pt1cut =  1.65*modCutFactor;
-        // pt2cut  = 0.8*modCutFactor;
-
-        pt1cut = 1.3 * modCutFactor;
-        pt2cut = 0.7 * modCutFactor;
-      }
-      else
-      {
-        // pt1cut = 1.65*modCutFactor +  1.4*(iCs-29)/200.0*modCutFactor;
-        // pt2cut = 0.8*modCutFactor +  1.4*(iCs-29)/200.0*modCutFactor;
-
-        pt1cut = 1.3 * modCutFactor + 1.4 * (iCs - 29) / 200.0 * modCutFactor;
-        pt2cut = 0.7 * modCutFactor + 1.4 * (iCs - 29) / 200.0 * modCutFactor;
-      }
-
-      float pi0ptcut = 1.22 * (pt1cut + pt2cut);
-
-      // energy asymmetry alpha cut
-      float alphacutval = 0.6;
-
-      float deltaRconecut = 1.1;  // 2-gamma opening angle(dR) cut
-      // value relevant for background extent in mass
-      //  not in peak area.
+      const TLorentzVector *pho1 = &savClusLV[jCs];
 
-      ////////////////////////////////////////////////////////
-      //////////////////////////////////
-      //   END CUTS
-      ///////////////////////////////////////
-      /////////////////////////////////////
-
-      if (std::abs(pho1->Pt()) < pt1cut)
+      if (std::abs(pho1->Pt()) < cuts.pt1cut)
       {
         continue;
       }
@@ -642,29 +659,29 @@ void CaloCalibEmc_Pi0::Loop(int nevts, const std::string &filename, TTree *intre
           continue;
         }
 
-        pho2 = savClusLV[kCs];
+        const TLorentzVector *pho2 = &savClusLV[kCs];
 
-        if (std::abs(pho2->Pt()) < pt2cut)
+        if (std::abs(pho2->Pt()) < cuts.pt2cut)
         {
           continue;
         }
 
         alphaCut = std::abs((pho1->E() - pho2->E()) / (pho1->E() + pho2->E()));
 
-        if (alphaCut > alphacutval)
+        if (alphaCut > cuts.alphacutval)
         {
           continue;
         }
 
         TLorentzVector pi0lv;
 
-        if (pho1->DeltaR(*pho2) > deltaRconecut)
+        if (pho1->DeltaR(*pho2) > cuts.deltaRconecut)
         {
           continue;
         }
 
         pi0lv = *pho1 + *pho2;
-        if (std::abs(pi0lv.Pt()) > pi0ptcut)
+        if (std::abs(pi0lv.Pt()) > cuts.pi0ptcut)
         {
           float pairInvMass = pi0lv.M();
 
@@ -732,35 +749,19 @@ void CaloCalibEmc_Pi0::Loop_for_eta_slices(int nevts, const std::string &filenam
     delete infileNt;
   }
 
-  std::cout << "in loop" << std::endl;
-
-  TTree *t1 = intree;
-  if (!intree)
+  if (!m_pair_cache_file.empty())
   {
-    TFile *f = new TFile(filename.c_str());
-    f->GetObject("_eventTree", t1);
-    if (!t1)
-    {
-      std::cout << PHWHERE << " could not load _eventTree from " << filename << std::endl;
-      gSystem->Exit(1);
-      exit(1);
-    }
+    Loop_pair_cache(CaloCalibEmc_Pi0PairCache::kEtaSlices, nevts, filename, intree, myaggcorr);
+    return;
   }
 
-  // Set Branches
-  //  t1->SetBranchAddress("_eventNumber", &_eventNumber);
-  t1->SetBranchAddress("_nClusters", &_nClusters);
-  //  t1->SetBranchAddress("_clusterIDs", _clusterIDs);
-  t1->SetBranchAddress("_clusterEnergies", _clusterEnergies);
-  t1->SetBranchAddress("_clusterPts", _clusterPts);
-  t1->SetBranchAddress("_clusterEtas", _clusterEtas);
-  t1->SetBranchAddress("_clusterPhis", _clusterPhis);
-  t1->SetBranchAddress("_maxTowerEtas", _maxTowerEtas);
-  t1->SetBranchAddress("_maxTowerPhis", _maxTowerPhis);
+  std::cout << "in loop" << std::endl;
+
+  TTree *t1 = get_event_tree(filename, intree);
 
   // pre-loop to save all the clusters LorentzVector
 
-  std::array<TLorentzVector *, 10000> savClusLV{};
+  std::vector<TLorentzVector> savClusLV;
 
   //  int nEntries = (int) t1->GetEntriesFast();
   int nEntries = (int) t1->GetEntries();
@@ -784,11 +785,12 @@ void CaloCalibEmc_Pi0::Loop_for_eta_slices(int nevts, const std::string &filenam
 
     int nClusters = _nClusters;
 
-    if (nClusters > 60)
+    if (nClusters > eta_slice_max_nclusters)
     {
       continue;
     }
 
+    savClusLV.resize(nClusters);
     for (int j = 0; j < nClusters; j++)
     {
       // float px, py, pz;
@@ -806,18 +808,15 @@ void CaloCalibEmc_Pi0::Loop_for_eta_slices(int nevts, const std::string &filenam
       pt *= aggcv;
       E *= aggcv;
 
-      savClusLV.at(j) = new TLorentzVector();
-      savClusLV.at(j)->SetPtEtaPhiE(pt, eta, phi, E);
+      savClusLV.at(j).SetPtEtaPhiE(pt, eta, phi, E);
     }
 
-    TLorentzVector *pho1;
-    TLorentzVector *pho2;
     int iCs = nClusters;
     for (int jCs = 0; jCs < iCs; jCs++)
     {
-      pho1 = savClusLV.at(jCs);
+      const TLorentzVector *pho1 = &savClusLV.at(jCs);
 
-      if (std::abs(pho1->Pt()) < 1.0)
+      if (std::abs(pho1->Pt()) < eta_slice_cuts.pt1cut)
       {
         continue;
       }
@@ -830,21 +829,21 @@ void CaloCalibEmc_Pi0::Loop_for_eta_slices(int nevts, const std::string &filenam
           continue;
         }
 
-        pho2 = savClusLV.at(kCs);
+        const TLorentzVector *pho2 = &savClusLV.at(kCs);
 
-        if (std::abs(pho2->Pt()) < 0.6)
+        if (std::abs(pho2->Pt()) < eta_slice_cuts.pt2cut)
         {
           continue;
         }
 
         TLorentzVector pi0lv;
-        if (pho1->DeltaR(*pho2) > 0.45)
+        if (pho1->DeltaR(*pho2) > eta_slice_cuts.deltaRconecut)
         {
           continue;
         }
         pi0lv = *pho1 + *pho2;
         float pairInvMass = pi0lv.M();
-        if (pi0lv.Pt() < 1.0)
+        if (pi0lv.Pt() < eta_slice_cuts.pi0ptcut)
         {
           continue;
         }
@@ -858,7 +857,7 @@ void CaloCalibEmc_Pi0::Loop_for_eta_slices(int nevts, const std::string &filenam
         */
 
         alphaCut = std::abs((pho1->E() - pho2->E()) / (pho1->E() + pho2->E()));
-        if (alphaCut > 0.50)
+        if (alphaCut > eta_slice_cuts.alphacutval)
         {
           continue;  // 0.50 to begin with
         }
@@ -882,6 +881,341 @@ void CaloCalibEmc_Pi0::Loop_for_eta_slices(int nevts, const std::string &filenam
   }
 }
 
+//__________oo00oo__________oo00oo_________________
+TTree *CaloCalibEmc_Pi0::get_event_tree(const std::string &filename, TTree *intree)
+{
+  TTree *t1 = intree;
+  if (!intree)
+  {
+    TFile *f = new TFile(filename.c_str());
+    f->GetObject("_eventTree", t1);
+    if (!t1)
+    {
+      std::cout << PHWHERE << " could not load _eventTree from " << filename << std::endl;
+      gSystem->Exit(1);
+      exit(1);
+    }
+  }
+
+  // Set Branches
+  //  t1->SetBranchAddress("_eventNumber", &_eventNumber);
+  t1->SetBranchAddress("_nClusters", &_nClusters);
+  //  t1->SetBranchAddress("_clusterIDs", _clusterIDs);
+  t1->SetBranchAddress("_clusterEnergies", _clusterEnergies);
+  t1->SetBranchAddress("_clusterPts", _clusterPts);
+  t1->SetBranchAddress("_clusterEtas", _clusterEtas);
+  t1->SetBranchAddress("_clusterPhis", _clusterPhis);
+  t1->SetBranchAddress("_maxTowerEtas", _maxTowerEtas);
+  t1->SetBranchAddress("_maxTowerPhis", _maxTowerPhis);
+
+  return t1;
+}
+
+//__________oo00oo__________oo00oo_________________
+// Loop and Loop_for_eta_slices from the pair cache
+void CaloCalibEmc_Pi0::Loop_pair_cache(CaloCalibEmc_Pi0PairCache::Mode mode, int nevts, const std::string &filename, TTree *intree, const CorrectionTable &myaggcorr)
+{
+  float maxcorr = 0;
+  for (const auto &row : myaggcorr)
+  {
+    for (float corr : row)
+    {
+      maxcorr = std::max(maxcorr, std::abs(corr));
+    }
+  }
+
+  // the cache in memory was made from another input file
+  if (filename != m_pair_cache_input)
+  {
+    m_pair_cache_loaded = false;
+    m_pair_cache_input = filename;
+  }
+
+  if (!m_pair_cache_loaded)
+  {
+    m_pair_cache_loaded = m_pair_cache.read(m_pair_cache_file);
+    if (m_pair_cache_loaded)
+    {
+      // the cache file has to be made from this input file, with the same entries
+      TTree *t1 = get_event_tree(filename, intree);
+      if (m_pair_cache.source() != filename || m_pair_cache.nentries() != t1->GetEntries())
+      {
+        std::cout << "pair cache " << m_pair_cache_file << " was made from " << m_pair_cache.source()
+                  << " (" << m_pair_cache.nentries() << " entries), not from " << filename
+                  << " (" << t1->GetEntries() << " entries)" << std::endl;
+        m_pair_cache_loaded = false;
+      }
+      else
+      {
+        std::cout << "read pair cache " << m_pair_cache_file << ": " << m_pair_cache.nevents()
+                  << " events, " << m_pair_cache.npairs() << " pair candidates" << std::endl;
+      }
+    }
+  }
+
+  // the cache has to be made for this loop, the same events and large enough corrections
+  bool usable = m_pair_cache_loaded && m_pair_cache.mode() == mode && maxcorr <= m_pair_cache.max_corr();
+  if (usable)
+  {
+    const int nentries = m_pair_cache.nentries();
+    const int nevts2 = (nevts < 0 || nentries < nevts) ? nentries : nevts;
+    usable = (nevts2 == m_pair_cache.nevents_read());
+  }
+
+  if (!usable)
+  {
+    build_pair_cache(mode, nevts, filename, intree, std::max(m_pair_cache_max_corr, maxcorr));
+    m_pair_cache.write(m_pair_cache_file);
+    m_pair_cache_loaded = true;
+  }
+
+  fill_from_pair_cache(myaggcorr);
+
+  if (mode == CaloCalibEmc_Pi0PairCache::kTowerByTower)
+  {
+    std::cout << "total number of events: " << m_pair_cache.nentries() << std::endl;
+    std::cout << "total number of events discarded: " << m_pair_cache.ndiscarded() << std::endl;
+  }
+}
+
+//__________oo00oo__________oo00oo_________________
+// first pass over the _eventTree, collecting the pair candidates
+void CaloCalibEmc_Pi0::build_pair_cache(CaloCalibEmc_Pi0PairCache::Mode mode, int nevts, const std::string &filename, TTree *intree, float max_corr)
+{
+  std::cout << "building pair cache " << m_pair_cache_file << " for corrections up to " << max_corr << std::endl;
+
+  const bool tower_by_tower = (mode == CaloCalibEmc_Pi0PairCache::kTowerByTower);
+  const int max_nclusters = tower_by_tower ? tower_by_tower_max_nclusters : eta_slice_max_nclusters;
+  m_pair_cache.clear(mode, max_corr, filename);
+
+  TTree *t1 = get_event_tree(filename, intree);
+
+  int nEntries = (int) t1->GetEntries();
+  int nevts2 = nevts;
+
+  if (nevts < 0 || nEntries < nevts)
+  {
+    nevts2 = nEntries;
+  }
+
+  int discarded_clusters = 0;
+
+  // uncalibrated clusters, their direction does not depend on the calibration
+  std::vector<TLorentzVector> savClusLV;
+  // index of the clusters in the cache, -1 if the cluster cannot pass the pt cuts
+  std::vector<int> cacheIndex;
+  std::vector<std::pair<int, int>> candidates;
+
+  for (int i = 0; i < nevts2; i++)
+  {
+    t1->GetEntry(i);
+
+    if ((i % 10 == 0 && i < 200) || (i % 100 == 0 && i < 1000) || (i % 1000 == 0 && i < 37003) || i % 10000 == 0)
+    {
+      std::cout << "evt no " << i << std::endl;
+    }
+
+    int nClusters = _nClusters;
+    if (nClusters > max_nclusters)
+    {
+      discarded_clusters += 1;
+      continue;
+    }
+
+    // smallest raw pt passing the pt cuts with the largest correction
+    const Pi0PairCuts cuts = tower_by_tower ? tower_by_tower_cuts(nClusters) : eta_slice_cuts;
+    const double pt1min = cuts.pt1cut / (max_corr * (1 + pair_cache_pt_margin));
+    const double pt2min = cuts.pt2cut / (max_corr * (1 + pair_cache_pt_margin));
+
+    savClusLV.resize(nClusters);
+    cacheIndex.assign(nClusters, -1);
+    int nkept = 0;
+    for (int j = 0; j < nClusters; j++)
+    {
+      if (std::abs(_clusterPts[j]) < std::min(pt1min, pt2min))
+      {
+        continue;
+      }
+      cacheIndex[j] = nkept++;
+      savClusLV[j].SetPtEtaPhiE(_clusterPts[j], _clusterEtas[j], _clusterPhis[j], _clusterEnergies[j]);
+    }
+
+    // same order as the pair loops
+    candidates.clear();
+    for (int jCs = 0; jCs < nClusters; jCs++)
+    {
+      if (cacheIndex[jCs] < 0 || std::abs(_clusterPts[jCs]) < pt1min)
+      {
+        continue;
+      }
+      for (int kCs = 0; kCs < nClusters; kCs++)
+      {
+        if (jCs == kCs || cacheIndex[kCs] < 0 || std::abs(_clusterPts[kCs]) < pt2min)
+        {
+          continue;
+        }
+        if (savClusLV[jCs].DeltaR(savClusLV[kCs]) > cuts.deltaRconecut + pair_cache_dr_margin)
+        {
+          continue;
+        }
+        candidates.emplace_back(cacheIndex[jCs], cacheIndex[kCs]);
+      }
+    }
+
+    if (candidates.empty())
+    {
+      continue;
+    }
+
+    m_pair_cache.add_event(nClusters);
+    for (int j = 0; j < nClusters; j++)
+    {
+      if (cacheIndex[j] >= 0)
+      {
+        m_pair_cache.add_cluster(_clusterPts[j], _clusterEnergies[j], _clusterEtas[j], _clusterPhis[j], _maxTowerEtas[j], _maxTowerPhis[j]);
+      }
+    }
+    for (const auto &[first, second] : candidates)
+    {
+      m_pair_cache.add_pair(first, second);
+    }
+  }
+
+  m_pair_cache.set_nevents_read(nevts2, nEntries, discarded_clusters);
+  std::cout << "pair cache: " << m_pair_cache.nevents() << " events, " << m_pair_cache.nclusters()
+            << " clusters, " << m_pair_cache.npairs() << " pair candidates" << std::endl;
+}
+
+//__________oo00oo__________oo00oo_________________
+// refill the histograms from the pair cache with the given corrections.
+// The pairs are calibrated and cut in parallel, event by event, and filled
+// in the order of the pair loops
+void CaloCalibEmc_Pi0::fill_from_pair_cache(const CorrectionTable &myaggcorr)
+{
+  const auto &cache = m_pair_cache;
+  const bool tower_by_tower = (cache.mode() == CaloCalibEmc_Pi0PairCache::kTowerByTower);
+
+  const auto pt = cache.pt();
+  const auto energy = cache.energy();
+  const auto eta = cache.eta();
+  const auto phi = cache.phi();
+  const auto tower_eta = cache.tower_eta();
+  const auto tower_phi = cache.tower_phi();
+  const auto pair_first = cache.pair_first();
+  const auto pair_second = cache.pair_second();
+
+  const size_t npairs = cache.npairs();
+  std::vector<unsigned char> accepted(npairs, 0);
+  std::vector<float> pairInvMass(npairs);
+  std::vector<double> pho1Pt(npairs);
+  std::vector<double> pi0Pt(npairs);
+  std::vector<float> pairAlpha(npairs);
+
+  size_t max_event_clusters = 0;
+  for (size_t event = 0; event < cache.nevents(); ++event)
+  {
+    max_event_clusters = std::max(max_event_clusters, cache.cluster_end(event) - cache.cluster_begin(event));
+  }
+
+  const int nthreads = Verbosity() > 0 ? 1 : (m_num_threads >= 1 ? m_num_threads : omp_get_max_threads());
+  const auto nevents = static_cast<int64_t>(cache.nevents());
+
+#pragma omp parallel num_threads(nthreads)
+  {
+    // calibrated clusters of the event, with the direction and pt used by the cuts
+    std::vector<TLorentzVector> savClusLV(max_event_clusters);
+    std::vector<double> clusEta(max_event_clusters);
+    std::vector<double> clusPhi(max_event_clusters);
+    std::vector<double> clusPt(max_event_clusters);
+
+#pragma omp for schedule(dynamic)
+    for (int64_t event = 0; event < nevents; ++event)
+    {
+      const size_t cluster_begin = cache.cluster_begin(event);
+      const size_t nClusters = cache.cluster_end(event) - cluster_begin;
+      for (size_t j = 0; j < nClusters; ++j)
+      {
+        const size_t cluster = cluster_begin + j;
+        const float aggcv = myaggcorr.at(tower_eta[cluster]).at(tower_phi[cluster]);
+        float clusPtCorr = pt[cluster];
+        float clusECorr = energy[cluster];
+        clusPtCorr *= aggcv;
+        clusECorr *= aggcv;
+        savClusLV[j].SetPtEtaPhiE(clusPtCorr, eta[cluster], phi[cluster], clusECorr);
+        clusEta[j] = savClusLV[j].Eta();
+        clusPhi[j] = savClusLV[j].Phi();
+        clusPt[j] = savClusLV[j].Pt();
+      }
+
+      const Pi0PairCuts cuts = tower_by_tower ? tower_by_tower_cuts(cache.event_nclusters(event)) : eta_slice_cuts;
+      for (size_t ipair = cache.pair_begin(event); ipair < cache.pair_end(event); ++ipair)
+      {
+        const TLorentzVector &pho1 = savClusLV[pair_first[ipair]];
+        const TLorentzVector &pho2 = savClusLV[pair_second[ipair]];
+        if (std::abs(clusPt[pair_first[ipair]]) < cuts.pt1cut || std::abs(clusPt[pair_second[ipair]]) < cuts.pt2cut)
+        {
+          continue;
+        }
+
+        // pho1.DeltaR(pho2) with the directions computed once per cluster
+        const double deta = clusEta[pair_first[ipair]] - clusEta[pair_second[ipair]];
+        const double dphi = TVector2::Phi_mpi_pi(clusPhi[pair_first[ipair]] - clusPhi[pair_second[ipair]]);
+        if (std::sqrt(deta * deta + dphi * dphi) > cuts.deltaRconecut)
+        {
+          continue;
+        }
+
+        const float alpha = std::abs((pho1.E() - pho2.E()) / (pho1.E() + pho2.E()));
+        if (alpha > cuts.alphacutval)
+        {
+          continue;
+        }
+
+        const TLorentzVector pi0lv = pho1 + pho2;
+        const double pi0lvPt = pi0lv.Pt();
+        if (tower_by_tower ? !(std::abs(pi0lvPt) > cuts.pi0ptcut) : (pi0lvPt < cuts.pi0ptcut))
+        {
+          continue;
+        }
+
+        accepted[ipair] = 1;
+        pairInvMass[ipair] = pi0lv.M();
+        pho1Pt[ipair] = clusPt[pair_first[ipair]];
+        pi0Pt[ipair] = pi0lvPt;
+        pairAlpha[ipair] = alpha;
+      }
+    }
+  }
+
+  // histograms are filled serially, in the order of the pair loops
+  for (size_t event = 0; event < cache.nevents(); ++event)
+  {
+    const size_t cluster_begin = cache.cluster_begin(event);
+    for (size_t ipair = cache.pair_begin(event); ipair < cache.pair_end(event); ++ipair)
+    {
+      if (!accepted[ipair])
+      {
+        continue;
+      }
+
+      const size_t cluster = cluster_begin + pair_first[ipair];
+      if (tower_by_tower)
+      {
+        eta_hist.at(tower_eta[cluster])->Fill(pairInvMass[ipair]);
+        pt1_ptpi0_alpha->Fill(pho1Pt[ipair], pi0Pt[ipair], pairAlpha[ipair]);
+        pairInvMassTotal->Fill(pairInvMass[ipair]);
+        mass_eta->Fill(pairInvMass[ipair], eta[cluster]);
+        mass_eta_phi->Fill(pairInvMass[ipair], eta[cluster], phi[cluster]);
+      }
+      else
+      {
+        cemc_hist_eta_phi.at(tower_eta[cluster]).at(tower_phi[cluster])->Fill(pairInvMass[ipair]);
+        eta_hist.at(tower_eta[cluster])->Fill(pairInvMass[ipair]);
+      }
+    }
+  }
+}
+
 // _______________________________________________________________..
 void CaloCalibEmc_Pi0::Fit_Histos(const std::string &incorrFile)
 {
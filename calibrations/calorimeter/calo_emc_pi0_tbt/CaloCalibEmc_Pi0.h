@@ -3,6 +3,8 @@
 #ifndef CALOEMCPI0TBT_CALOCALIBEMCPI0_H
 #define CALOEMCPI0TBT_CALOCALIBEMCPI0_H
 
+#include "CaloCalibEmc_Pi0PairCache.h"
+
 #include <fun4all/SubsysReco.h>
 
 #include <array>
@@ -47,6 +49,21 @@ class CaloCalibEmc_Pi0 : public SubsysReco
 
   void set_centrality_nclusters_cut(int n) { m_cent_nclus_cut = n; }
 
+  /** run Loop and Loop_for_eta_slices from a pair cache file:
+      the pair candidates are read from the _eventTree and written to cachefile
+      by the first iteration, the following iterations only refill the histograms
+      from the cache. Candidates are kept for correction factors up to max_corr,
+      the cache is rebuilt if a larger correction (or another loop or number of events) is used
+   */
+  void set_pair_cache(const std::string &cachefile, float max_corr = 1.5)
+  {
+    m_pair_cache_file = cachefile;
+    m_pair_cache_max_corr = max_corr;
+  }
+
+  //! threads used to refill the histograms from the pair cache, 1 by default, 0 uses all available
+  void set_num_threads(int value) { m_num_threads = value; }
+
   void Add_32();
   void Add_96();
 
@@ -73,6 +90,16 @@ class CaloCalibEmc_Pi0 : public SubsysReco
   }
 
  private:
+  using CorrectionTable = std::array<std::array<float, 260>, 96>;
+
+  //! _eventTree of the given file (if intree is null), with the branches set
+  TTree *get_event_tree(const std::string &filename, TTree *intree);
+
+  //! pair loops using the pair cache
+  void Loop_pair_cache(CaloCalibEmc_Pi0PairCache::Mode mode, int nevts, const std::string &filename, TTree *intree, const CorrectionTable &myaggcorr);
+  void build_pair_cache(CaloCalibEmc_Pi0PairCache::Mode mode, int nevts, const std::string &filename, TTree *intree, float max_corr);
+  void fill_from_pair_cache(const CorrectionTable &myaggcorr);
+
   //  float setMassVal = 0.135;
   float _setMassVal{0.152};
   // currently defaulting to 0.152 to match sim
@@ -125,6 +152,14 @@ class CaloCalibEmc_Pi0 : public SubsysReco
   TFile *f_temp{nullptr};
 
   int m_UseTowerInfo{0};  // 0 only old tower, 1 only new (TowerInfo based),
+
+  std::string m_pair_cache_file;
+  float m_pair_cache_max_corr{1.5};
+  CaloCalibEmc_Pi0PairCache m_pair_cache;
+  bool m_pair_cache_loaded{false};
+  //! input file of the last pair cache loop
+  std::string m_pair_cache_input;
+  int m_num_threads{1};
 };
 
 #endif  //   CALOEMCPI0TBT_CALOCALIBEMC_PI0_H
@@ -0,0 +1,198 @@
+#include "CaloCalibEmc_Pi0PairCache.h"
+
+#include <array>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+  constexpr std::array<char, 8> cache_magic{'P', 'I', '0', 'P', 'A', 'I', 'R', 'S'};
+  constexpr uint32_t cache_version = 2;
+
+  template <typename T>
+  void write_value(std::ofstream &out, const T &value)
+  {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  bool read_value(std::ifstream &in, T &value)
+  {
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+  }
+
+  template <typename T>
+  void write_column(std::ofstream &out, const std::vector<T> &column)
+  {
+    write_value(out, static_cast<uint64_t>(column.size()));
+    out.write(reinterpret_cast<const char *>(column.data()), column.size() * sizeof(T));
+  }
+
+  template <typename T>
+  bool read_column(std::ifstream &in, std::vector<T> &column)
+  {
+    uint64_t size = 0;
+    if (!read_value(in, size))
+    {
+      return false;
+    }
+    column.resize(size);
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(column.data()), size * sizeof(T)));
+  }
+}  // namespace
+
+void CaloCalibEmc_Pi0PairCache::clear(Mode mode, float max_corr, const std::string &source)
+{
+  m_mode = mode;
+  m_max_corr = max_corr;
+  m_source = source;
+  m_nevents_read = 0;
+  m_nentries = 0;
+  m_ndiscarded = 0;
+
+  m_event_nclusters.clear();
+  m_event_cluster_offset.assign(1, 0);
+  m_event_pair_offset.assign(1, 0);
+
+  m_pt.clear();
+  m_energy.clear();
+  m_eta.clear();
+  m_phi.clear();
+  m_tower_eta.clear();
+  m_tower_phi.clear();
+
+  m_pair_first.clear();
+  m_pair_second.clear();
+}
+
+size_t CaloCalibEmc_Pi0PairCache::add_event(int nclusters_event)
+{
+  m_event_nclusters.push_back(nclusters_event);
+  m_event_cluster_offset.push_back(m_event_cluster_offset.back());
+  m_event_pair_offset.push_back(m_event_pair_offset.back());
+  return m_event_nclusters.size() - 1;
+}
+
+void CaloCalibEmc_Pi0PairCache::add_cluster(float pt, float energy, float eta, float phi, int tower_eta, int tower_phi)
+{
+  m_pt.push_back(pt);
+  m_energy.push_back(energy);
+  m_eta.push_back(eta);
+  m_phi.push_back(phi);
+  m_tower_eta.push_back(tower_eta);
+  m_tower_phi.push_back(tower_phi);
+  ++m_event_cluster_offset.back();
+}
+
+bool CaloCalibEmc_Pi0PairCache::write(const std::string &filename) const
+{
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  if (!out)
+  {
+    std::cout << "CaloCalibEmc_Pi0PairCache: could not open " << filename << " for writing" << std::endl;
+    return false;
+  }
+
+  out.write(cache_magic.data(), cache_magic.size());
+  write_value(out, cache_version);
+  write_value(out, static_cast<int32_t>(m_mode));
+  write_value(out, m_max_corr);
+  write_value(out, static_cast<uint64_t>(m_source.size()));
+  out.write(m_source.data(), m_source.size());
+  write_value(out, static_cast<int32_t>(m_nevents_read));
+  write_value(out, static_cast<int32_t>(m_nentries));
+  write_value(out, static_cast<int32_t>(m_ndiscarded));
+
+  write_column(out, m_event_nclusters);
+  write_column(out, m_event_cluster_offset);
+  write_column(out, m_event_pair_offset);
+  write_column(out, m_pt);
+  write_column(out, m_energy);
+  write_column(out, m_eta);
+  write_column(out, m_phi);
+  write_column(out, m_tower_eta);
+  write_column(out, m_tower_phi);
+  write_column(out, m_pair_first);
+  write_column(out, m_pair_second);
+
+  if (!out)
+  {
+    std::cout << "CaloCalibEmc_Pi0PairCache: error writing " << filename << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool CaloCalibEmc_Pi0PairCache::read(const std::string &filename)
+{
+  std::ifstream in(filename, std::ios::binary);
+  if (!in)
+  {
+    return false;
+  }
+
+  std::array<char, 8> magic{};
+  uint32_t version = 0;
+  int32_t mode = 0;
+  uint64_t source_size = 0;
+  int32_t nevents_read = 0;
+  int32_t nentries = 0;
+  int32_t ndiscarded = 0;
+  if (!in.read(magic.data(), magic.size()) || magic != cache_magic ||
+      !read_value(in, version) || version != cache_version)
+  {
+    std::cout << "CaloCalibEmc_Pi0PairCache: " << filename << " is not a pair cache of version "
+              << cache_version << std::endl;
+    return false;
+  }
+
+  bool good = read_value(in, mode) &&
+              read_value(in, m_max_corr) &&
+              read_value(in, source_size) &&
+              source_size < 65536;
+  if (good)
+  {
+    m_source.resize(source_size);
+    good = static_cast<bool>(in.read(m_source.data(), source_size));
+  }
+  good = good &&
+         read_value(in, nevents_read) &&
+         read_value(in, nentries) &&
+         read_value(in, ndiscarded) &&
+         read_column(in, m_event_nclusters) &&
+         read_column(in, m_event_cluster_offset) &&
+         read_column(in, m_event_pair_offset) &&
+         read_column(in, m_pt) &&
+         read_column(in, m_energy) &&
+         read_column(in, m_eta) &&
+         read_column(in, m_phi) &&
+         read_column(in, m_tower_eta) &&
+         read_column(in, m_tower_phi) &&
+         read_column(in, m_pair_first) &&
+         read_column(in, m_pair_second);
+
+  // consistency of the offsets with the columns
+  good = good &&
+         m_event_cluster_offset.size() == m_event_nclusters.size() + 1 &&
+         m_event_pair_offset.size() == m_event_nclusters.size() + 1 &&
+         m_event_cluster_offset.back() == m_pt.size() &&
+         m_energy.size() == m_pt.size() &&
+         m_eta.size() == m_pt.size() &&
+         m_phi.size() == m_pt.size() &&
+         m_tower_eta.size() == m_pt.size() &&
+         m_tower_phi.size() == m_pt.size() &&
+         m_event_pair_offset.back() == m_pair_first.size() &&
+         m_pair_second.size() == m_pair_first.size();
+  if (!good)
+  {
+    std::cout << "CaloCalibEmc_Pi0PairCache: " << filename << " is truncated or corrupted" << std::endl;
+    clear(kTowerByTower, 1.);
+    return false;
+  }
+
+  m_mode = static_cast<Mode>(mode);
+  m_nevents_read = nevents_read;
+  m_nentries = nentries;
+  m_ndiscarded = ndiscarded;
+  return true;
+}
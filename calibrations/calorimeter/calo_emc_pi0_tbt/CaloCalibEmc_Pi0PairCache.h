@@ -0,0 +1,117 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef CALOEMCPI0TBT_CALOCALIBEMCPI0PAIRCACHE_H
+#define CALOEMCPI0TBT_CALOCALIBEMCPI0PAIRCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * columnar cache of the pi0 pair candidates of the _eventTree, for the
+ * iterations of the tower by tower calibration.
+ * The clusters of the accepted events are stored column by column (raw pt, energy,
+ * eta, phi and leading tower), the candidate pairs as indices of the two clusters
+ * in their event, in the order of the pair loop of CaloCalibEmc_Pi0.
+ * Candidates are selected with the cuts which do not depend on the calibration:
+ * the opening angle and the pt cuts for a correction factor up to max_corr,
+ * the remaining cuts are applied when refilling the histograms.
+ * The cache is written to and read from a binary file.
+ */
+class CaloCalibEmc_Pi0PairCache
+{
+ public:
+  //! pair loop the candidates were selected for
+  enum Mode : int32_t
+  {
+    kTowerByTower = 0,  // CaloCalibEmc_Pi0::Loop
+    kEtaSlices = 1      // CaloCalibEmc_Pi0::Loop_for_eta_slices
+  };
+
+  CaloCalibEmc_Pi0PairCache() = default;
+  ~CaloCalibEmc_Pi0PairCache() = default;
+
+  //! remove all events and set the input file and the selection the candidates are made with
+  void clear(Mode mode, float max_corr, const std::string &source = "");
+
+  //! add an event, returns its index. Clusters and pairs are added to the last event
+  size_t add_event(int nclusters_event);
+  void add_cluster(float pt, float energy, float eta, float phi, int tower_eta, int tower_phi);
+  void add_pair(int first, int second)
+  {
+    m_pair_first.push_back(first);
+    m_pair_second.push_back(second);
+    ++m_event_pair_offset.back();
+  }
+
+  bool write(const std::string &filename) const;
+  //! false if the file does not exist or is not a pair cache of this version
+  bool read(const std::string &filename);
+
+  Mode mode() const { return m_mode; }
+  float max_corr() const { return m_max_corr; }
+  //! file the _eventTree was read from
+  const std::string &source() const { return m_source; }
+
+  //! events read from the tree, and those discarded by the multiplicity cut
+  int nevents_read() const { return m_nevents_read; }
+  int nentries() const { return m_nentries; }
+  int ndiscarded() const { return m_ndiscarded; }
+  void set_nevents_read(int nevents, int nentries, int ndiscarded)
+  {
+    m_nevents_read = nevents;
+    m_nentries = nentries;
+    m_ndiscarded = ndiscarded;
+  }
+
+  size_t nevents() const { return m_event_nclusters.size(); }
+  size_t nclusters() const { return m_pt.size(); }
+  size_t npairs() const { return m_pair_first.size(); }
+
+  //! number of clusters of the event in the tree (before any selection)
+  int event_nclusters(size_t event) const { return m_event_nclusters[event]; }
+  //! clusters of an event are [cluster_begin, cluster_end)
+  size_t cluster_begin(size_t event) const { return m_event_cluster_offset[event]; }
+  size_t cluster_end(size_t event) const { return m_event_cluster_offset[event + 1]; }
+  //! pairs of an event are [pair_begin, pair_end)
+  size_t pair_begin(size_t event) const { return m_event_pair_offset[event]; }
+  size_t pair_end(size_t event) const { return m_event_pair_offset[event + 1]; }
+
+  //! cluster columns
+  std::span<const float> pt() const { return m_pt; }
+  std::span<const float> energy() const { return m_energy; }
+  std::span<const float> eta() const { return m_eta; }
+  std::span<const float> phi() const { return m_phi; }
+  std::span<const int16_t> tower_eta() const { return m_tower_eta; }
+  std::span<const int16_t> tower_phi() const { return m_tower_phi; }
+
+  //! pair columns, cluster indices within the event
+  std::span<const uint16_t> pair_first() const { return m_pair_first; }
+  std::span<const uint16_t> pair_second() const { return m_pair_second; }
+
+ private:
+  Mode m_mode{kTowerByTower};
+  float m_max_corr{1.};
+  std::string m_source;
+  int m_nevents_read{0};
+  int m_nentries{0};
+  int m_ndiscarded{0};
+
+  std::vector<int32_t> m_event_nclusters;
+  std::vector<uint32_t> m_event_cluster_offset{0};
+  std::vector<uint64_t> m_event_pair_offset{0};
+
+  std::vector<float> m_pt;
+  std::vector<float> m_energy;
+  std::vector<float> m_eta;
+  std::vector<float> m_phi;
+  std::vector<int16_t> m_tower_eta;
+  std::vector<int16_t> m_tower_phi;
+
+  std::vector<uint16_t> m_pair_first;
+  std::vector<uint16_t> m_pair_second;
+};
+
+#endif  // CALOEMCPI0TBT_CALOCALIBEMCPI0PAIRCACHE_H
@@ -43,6 +43,14 @@ class CaloPacket : public OfflinePacketv1
 
   virtual void setSample(int /*ipmt*/, int /*ichan*/, uint32_t /*val*/) { return; }
   virtual uint32_t getSample(int /*ipmt*/, int /*ichan*/) const { return std::numeric_limits<uint32_t>::max(); }
+  //! copy the first nsamples samples of a channel (same values as iValue(sample, channel))
+  virtual void getWaveform(const int channel, const int nsamples, float *waveform) const
+  {
+    for (int samp = 0; samp < nsamples; samp++)
+    {
+      waveform[samp] = iValue(samp, channel);
+    }
+  }
   virtual void setPacketEvtSequence(int /*i*/) { return; }
   virtual int getPacketEvtSequence() const { return std::numeric_limits<int>::max(); }
   virtual void setNrChannels(int /*i*/) { return; }
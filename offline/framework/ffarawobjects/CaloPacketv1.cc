@@ -245,6 +245,20 @@ int CaloPacketv1::iValue(const int sample, const int channel) const
   return samples.at(sample).at(channel);
 }
 
+void CaloPacketv1::getWaveform(const int channel, const int nsamples, float *waveform) const
+{
+  // out of range requests go through iValue, which throws
+  if (channel < 0 || channel >= MAX_NUM_CHANNELS || nsamples > MAX_NUM_SAMPLES)
+  {
+    CaloPacket::getWaveform(channel, nsamples, waveform);
+    return;
+  }
+  for (int samp = 0; samp < nsamples; samp++)
+  {
+    waveform[samp] = static_cast<int>(samples[samp][channel]);
+  }
+}
+
 void CaloPacketv1::identify(std::ostream &os) const
 {
   os << "CaloPacketv1: " << std::endl;
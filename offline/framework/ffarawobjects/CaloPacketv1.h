@@ -70,6 +70,7 @@ class CaloPacketv1 : public CaloPacket
   int getPacketEvtSequence() const override { return PacketEvtSequence; }
   int iValue(const int n, const std::string &what) const override;
   int iValue(const int sample, const int channel) const override;
+  void getWaveform(const int channel, const int nsamples, float *waveform) const override;
   void dump(std::ostream &os = std::cout) const override;
   void dump_iddigitizer(std::ostream &os = std::cout) const;
 
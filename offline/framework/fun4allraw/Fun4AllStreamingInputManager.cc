@@ -39,8 +39,11 @@
 #include <TH2.h>
 #include <TSystem.h>
 
+#include <omp.h>
+
 #include <algorithm>  // for max
 #include <cassert>
+#include <chrono>
 #include <cstdint>  // for uint64_t, uint16_t
 #include <cstdlib>
 #include <format>
@@ -48,6 +51,8 @@
 #include <sstream>
 #include <utility>   // for pair
 
+thread_local Fun4AllStreamingInputManager::StagedRawHits *Fun4AllStreamingInputManager::m_CurrentStagedRawHits = nullptr;
+
 Fun4AllStreamingInputManager::Fun4AllStreamingInputManager(const std::string &name, const std::string &dstnodename, const std::string &topnodename)
   : Fun4AllInputManager(name, dstnodename, topnodename)
   , m_SyncObject(new SyncObjectv1())
@@ -62,12 +67,17 @@ Fun4AllStreamingInputManager::Fun4AllStreamingInputManager(const std::string &na
 
 Fun4AllStreamingInputManager::~Fun4AllStreamingInputManager()
 {
+  if (Verbosity() > 0)
+  {
+    Print("THROUGHPUT");
+  }
   if (IsOpen())
   {
     fileclose();
   }
   delete m_SyncObject;
   // clear leftover raw event maps and vectors with poolreaders
+  // raw hits are owned (and possibly pooled) by the inputs, only the maps are cleared here
   // GL1
   for (auto *iter : m_Gl1InputVector)
   {
@@ -79,10 +89,6 @@ Fun4AllStreamingInputManager::~Fun4AllStreamingInputManager()
   // MVTX
   for (auto const &mapiter : m_MvtxRawHitMap)
   {
-    for (auto *mvtxhititer : mapiter.second.MvtxRawHitVector)
-    {
-      delete mvtxhititer;
-    }
     for (auto *mvtxFeeIdInfo : mapiter.second.MvtxFeeIdInfoVector)
     {
       delete mvtxFeeIdInfo;
@@ -97,13 +103,6 @@ Fun4AllStreamingInputManager::~Fun4AllStreamingInputManager()
   m_MvtxInputVector.clear();
 
   // INTT
-  for (auto const &mapiter : m_InttRawHitMap)
-  {
-    for (auto *intthititer : mapiter.second.InttRawHitVector)
-    {
-      delete intthititer;
-    }
-  }
   m_InttRawHitMap.clear();
 
   for (auto *iter : m_InttInputVector)
@@ -113,14 +112,6 @@ Fun4AllStreamingInputManager::~Fun4AllStreamingInputManager()
   m_InttInputVector.clear();
 
   // TPC
-  for (auto const &mapiter : m_TpcRawHitMap)
-  {
-    for (auto *tpchititer : mapiter.second.TpcRawHitVector)
-    {
-      delete tpchititer;
-    }
-  }
-
   m_TpcRawHitMap.clear();
   for (auto *iter : m_TpcInputVector)
   {
@@ -129,14 +120,7 @@ Fun4AllStreamingInputManager::~Fun4AllStreamingInputManager()
   m_TpcInputVector.clear();
 
   // Micromegas
-
-  for (auto const &mapiter : m_MicromegasRawHitMap)
-  {
-    for (auto *micromegashititer : mapiter.second.MicromegasRawHitVector)
-    {
-      delete micromegashititer;
-    }
-  }
+  m_MicromegasRawHitMap.clear();
   for (auto *iter : m_MicromegasInputVector)
   {
     delete iter;
@@ -309,6 +293,22 @@ void Fun4AllStreamingInputManager::Print(const std::string &what) const
                 << std::endl;
     }
   }
+  if (what == "ALL" || what == "THROUGHPUT")
+  {
+    std::cout << "-----------------------------" << std::endl;
+    for (const auto &[name, throughput] : m_InputThroughput)
+    {
+      std::cout << "Single Streaming Input Manager " << name
+                << " FillPool calls: " << throughput.FillPoolCalls
+                << " raw hits: " << throughput.RawHits
+                << " time: " << throughput.FillPoolTime << " s";
+      if (throughput.FillPoolTime > 0)
+      {
+        std::cout << " (" << throughput.RawHits / throughput.FillPoolTime << " hits/s)";
+      }
+      std::cout << std::endl;
+    }
+  }
   Fun4AllInputManager::Print(what);
   return;
 }
@@ -495,6 +495,11 @@ void Fun4AllStreamingInputManager::AddGl1RawHit(uint64_t bclk, Gl1Packet *hit)
 
 void Fun4AllStreamingInputManager::AddMvtxRawHit(uint64_t bclk, MvtxRawHit *hit)
 {
+  if (m_CurrentStagedRawHits)
+  {
+    m_CurrentStagedRawHits->MvtxRawHitVector.emplace_back(bclk, hit);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding mvtx hit to bclk 0x"
@@ -505,6 +510,11 @@ void Fun4AllStreamingInputManager::AddMvtxRawHit(uint64_t bclk, MvtxRawHit *hit)
 
 void Fun4AllStreamingInputManager::AddMvtxFeeIdInfo(uint64_t bclk, uint16_t feeid, uint32_t detField)
 {
+  if (m_CurrentStagedRawHits)
+  {
+    m_CurrentStagedRawHits->MvtxFeeIdInfoVector.emplace_back(bclk, feeid, detField);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding mvtx feeid info to bclk 0x"
@@ -519,6 +529,11 @@ void Fun4AllStreamingInputManager::AddMvtxFeeIdInfo(uint64_t bclk, uint16_t feei
 
 void Fun4AllStreamingInputManager::AddMvtxL1TrgBco(uint64_t bclk, uint64_t lv1Bco)
 {
+  if (m_CurrentStagedRawHits)
+  {
+    m_CurrentStagedRawHits->MvtxL1TrgBcoVector.emplace_back(bclk, lv1Bco);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding mvtx L1Trg to bclk 0x"
@@ -529,6 +544,11 @@ void Fun4AllStreamingInputManager::AddMvtxL1TrgBco(uint64_t bclk, uint64_t lv1Bc
 
 void Fun4AllStreamingInputManager::AddInttRawHit(uint64_t bclk, InttRawHit *hit)
 {
+  if (m_CurrentStagedRawHits)
+  {
+    m_CurrentStagedRawHits->InttRawHitVector.emplace_back(bclk, hit);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding intt hit to bclk 0x"
@@ -540,6 +560,11 @@ void Fun4AllStreamingInputManager::AddInttRawHit(uint64_t bclk, InttRawHit *hit)
 
 void Fun4AllStreamingInputManager::AddMicromegasRawHit(uint64_t bclk, MicromegasRawHit *hit)
 {
+  if (m_CurrentStagedRawHits)
+  {
+    m_CurrentStagedRawHits->MicromegasRawHitVector.emplace_back(bclk, hit);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding micromegas hit to bclk 0x"
@@ -550,6 +575,11 @@ void Fun4AllStreamingInputManager::AddMicromegasRawHit(uint64_t bclk, Micromegas
 
 void Fun4AllStreamingInputManager::AddTpcRawHit(uint64_t bclk, TpcRawHit *hit)
 {
+  if (m_CurrentStagedRawHits)
+  {
+    m_CurrentStagedRawHits->TpcRawHitVector.emplace_back(bclk, hit);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding tpc hit to bclk 0x"
@@ -1416,8 +1446,10 @@ int Fun4AllStreamingInputManager::FillInttPool()
     {
       std::cout << "Fun4AllStreamingInputManager::FillInttPool - fill pool for " << iter->Name() << std::endl;
     }
-    iter->FillPool(ref_bco_minus_range);
-    // iter->FillPool();
+  }
+  FillInputPools(m_InttInputVector, ref_bco_minus_range);
+  for (auto *iter : m_InttInputVector)
+  {
     if (m_RunNumber == 0)
     {
       m_RunNumber = iter->RunNumber();
@@ -1453,13 +1485,16 @@ int Fun4AllStreamingInputManager::FillTpcPool()
     ref_bco_minus_range = m_RefBCO - m_tpc_negative_bco;
   }
 
-  for (auto *iter : m_TpcInputVector)
+  if (Verbosity() > 0)
   {
-    if (Verbosity() > 0)
+    for (auto *iter : m_TpcInputVector)
     {
       std::cout << "Fun4AllStreamingInputManager::FillTpcPool - fill pool for " << iter->Name() << std::endl;
     }
-    iter->FillPool(ref_bco_minus_range);
+  }
+  FillInputPools(m_TpcInputVector, ref_bco_minus_range);
+  for (auto *iter : m_TpcInputVector)
+  {
     const int fill_pool_status = iter->FillPoolStatus();
     if (fill_pool_status < 0)
     {
@@ -1501,13 +1536,16 @@ int Fun4AllStreamingInputManager::FillMicromegasPool()
     ref_bco_minus_range = m_RefBCO - m_micromegas_negative_bco;
   }
 
-  for (auto *iter : m_MicromegasInputVector)
+  if (Verbosity() > 0)
   {
-    if (Verbosity() > 0)
+    for (auto *iter : m_MicromegasInputVector)
     {
       std::cout << "Fun4AllStreamingInputManager::FillMicromegasPool - fill pool for " << iter->Name() << std::endl;
     }
-    iter->FillPool(ref_bco_minus_range);
+  }
+  FillInputPools(m_MicromegasInputVector, ref_bco_minus_range);
+  for (auto *iter : m_MicromegasInputVector)
+  {
     if (m_RunNumber == 0)
     {
       m_RunNumber = iter->RunNumber();
@@ -1538,13 +1576,16 @@ int Fun4AllStreamingInputManager::FillMicromegasPool()
 int Fun4AllStreamingInputManager::FillMvtxPool()
 {
   uint64_t ref_bco_minus_range = m_RefBCO < m_mvtx_negative_bco ? m_mvtx_negative_bco : m_RefBCO - m_mvtx_negative_bco;
-  for (auto *iter : m_MvtxInputVector)
+  if (Verbosity() > 3)
   {
-    if (Verbosity() > 3)
+    for (auto *iter : m_MvtxInputVector)
     {
       std::cout << "Fun4AllStreamingInputManager::FillMvtxPool - fill pool for " << iter->Name() << std::endl;
     }
-    iter->FillPool(ref_bco_minus_range);
+  }
+  FillInputPools(m_MvtxInputVector, ref_bco_minus_range);
+  for (auto *iter : m_MvtxInputVector)
+  {
     if (m_RunNumber == 0)
     {
       m_RunNumber = iter->RunNumber();
@@ -1571,6 +1612,93 @@ int Fun4AllStreamingInputManager::FillMvtxPool()
   }
   return 0;
 }
+
+void Fun4AllStreamingInputManager::FillInputPools(const std::vector<SingleStreamingInput *> &inputs, const uint64_t ref_bco)
+{
+  if (m_StagedRawHits.size() < inputs.size())
+  {
+    m_StagedRawHits.resize(inputs.size());
+  }
+
+  // counters are created up front, the map is not modified by the worker threads
+  std::vector<InputThroughput *> throughputs;
+  throughputs.reserve(inputs.size());
+  for (auto *iter : inputs)
+  {
+    throughputs.push_back(&m_InputThroughput[iter->Name()]);
+  }
+
+  // each input only touches its own file, decoder and staging area
+  const int nthreads = m_FillPoolThreads >= 1 ? m_FillPoolThreads : omp_get_max_threads();
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+  for (size_t i = 0; i < inputs.size(); ++i)
+  {
+    auto &staged = m_StagedRawHits[i];
+    staged.clear();
+
+    const auto start = std::chrono::steady_clock::now();
+    m_CurrentStagedRawHits = &staged;
+    inputs[i]->FillPool(ref_bco);
+    m_CurrentStagedRawHits = nullptr;
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    ++throughputs[i]->FillPoolCalls;
+    throughputs[i]->RawHits += staged.size();
+    throughputs[i]->FillPoolTime += elapsed.count();
+  }
+
+  // merge in registration order, which is the order of the serial filling
+  for (size_t i = 0; i < inputs.size(); ++i)
+  {
+    inputs[i]->ConfigureRun();
+    MergeStagedRawHits(m_StagedRawHits[i]);
+    m_StagedRawHits[i].clear();
+  }
+}
+
+void Fun4AllStreamingInputManager::MergeStagedRawHits(const StagedRawHits &staged)
+{
+  for (const auto &[bclk, hit] : staged.InttRawHitVector)
+  {
+    AddInttRawHit(bclk, hit);
+  }
+  for (const auto &[bclk, hit] : staged.MicromegasRawHitVector)
+  {
+    AddMicromegasRawHit(bclk, hit);
+  }
+  for (const auto &[bclk, feeid, detField] : staged.MvtxFeeIdInfoVector)
+  {
+    AddMvtxFeeIdInfo(bclk, feeid, detField);
+  }
+  for (const auto &[bclk, lv1Bco] : staged.MvtxL1TrgBcoVector)
+  {
+    AddMvtxL1TrgBco(bclk, lv1Bco);
+  }
+  for (const auto &[bclk, hit] : staged.MvtxRawHitVector)
+  {
+    AddMvtxRawHit(bclk, hit);
+  }
+  for (const auto &[bclk, hit] : staged.TpcRawHitVector)
+  {
+    AddTpcRawHit(bclk, hit);
+  }
+}
+
+void Fun4AllStreamingInputManager::StagedRawHits::clear()
+{
+  InttRawHitVector.clear();
+  MicromegasRawHitVector.clear();
+  MvtxFeeIdInfoVector.clear();
+  MvtxL1TrgBcoVector.clear();
+  MvtxRawHitVector.clear();
+  TpcRawHitVector.clear();
+}
+
+size_t Fun4AllStreamingInputManager::StagedRawHits::size() const
+{
+  return InttRawHitVector.size() + MicromegasRawHitVector.size() + MvtxRawHitVector.size() + TpcRawHitVector.size();
+}
+
 void Fun4AllStreamingInputManager::createQAHistos()
 {
   auto *hm = QAHistManagerDef::getHistoManager();
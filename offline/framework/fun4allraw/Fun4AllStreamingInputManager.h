@@ -10,6 +10,8 @@
 #include <map>
 #include <set>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 #include <cinttypes>
 
@@ -69,6 +71,17 @@ class Fun4AllStreamingInputManager : public Fun4AllInputManager
   int FillTpcPool();
   void Streaming(bool b = true) { m_StreamingFlag = b; }
 
+  //! number of threads used to fill the pools of the inputs of a given subsystem
+  /**
+   * the inputs of a subsystem (e.g. the TPC EBDCs) read and decode their files independently.
+   * Raw hits are staged per input and merged in registration order afterwards,
+   * so that the result does not depend on the number of threads.
+   * The pools are filled fork-join when an event needs them: decoding does not overlap with the
+   * processing of the previous event, there are no reader threads filling ahead.
+   * 1 (default) fills the pools serially, 0 uses the OpenMP default
+   */
+  void SetFillPoolThreads(const int i) { m_FillPoolThreads = i; }
+
   void runMvtxTriggered(bool b = true) { m_mvtx_is_triggered = b; }
 
   // configuration for INTT hit carry-over issue mitigation (hit duplication)
@@ -115,8 +128,38 @@ class Fun4AllStreamingInputManager : public Fun4AllInputManager
     unsigned int EventFoundCounter{0};
   };
 
+  //! raw hits added by one input during FillPool, merged into the raw hit maps afterwards
+  struct StagedRawHits
+  {
+    std::vector<std::pair<uint64_t, InttRawHit *>> InttRawHitVector;
+    std::vector<std::pair<uint64_t, MicromegasRawHit *>> MicromegasRawHitVector;
+    std::vector<std::tuple<uint64_t, uint16_t, uint32_t>> MvtxFeeIdInfoVector;
+    std::vector<std::pair<uint64_t, uint64_t>> MvtxL1TrgBcoVector;
+    std::vector<std::pair<uint64_t, MvtxRawHit *>> MvtxRawHitVector;
+    std::vector<std::pair<uint64_t, TpcRawHit *>> TpcRawHitVector;
+    void clear();
+    size_t size() const;
+  };
+
+  //! per input throughput counters
+  struct InputThroughput
+  {
+    unsigned long FillPoolCalls{0};
+    unsigned long RawHits{0};
+    double FillPoolTime{0};  // seconds
+  };
+
   void createQAHistos();
 
+  //! fill pools of all inputs of one subsystem, possibly in parallel, and merge their raw hits
+  void FillInputPools(const std::vector<SingleStreamingInput *> &inputs, const uint64_t ref_bco);
+
+  //! add staged raw hits to the raw hit maps
+  void MergeStagedRawHits(const StagedRawHits &staged);
+
+  //! staging area of the input being filled by the current thread. Raw hits are added directly if null
+  static thread_local StagedRawHits *m_CurrentStagedRawHits;
+
   SyncObject *m_SyncObject{nullptr};
   PHCompositeNode *m_topNode{nullptr};
 
@@ -152,6 +195,10 @@ class Fun4AllStreamingInputManager : public Fun4AllInputManager
   std::map<uint64_t, TpcRawHitInfo> m_TpcRawHitMap;
   std::map<int, std::map<int, uint64_t>> m_InttPacketFeeBcoMap;
 
+  int m_FillPoolThreads{1};
+  std::vector<StagedRawHits> m_StagedRawHits;
+  std::map<std::string, InputThroughput> m_InputThroughput;
+
   // QA histos
   TH1 *h_refbco_mvtx[12]{nullptr};
   TH1 *h_taggedAllFelixes_mvtx{nullptr};
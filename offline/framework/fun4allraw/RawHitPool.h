@@ -0,0 +1,90 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef FUN4ALLRAW_RAWHITPOOL_H
+#define FUN4ALLRAW_RAWHITPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+//! recycled raw hits for streaming inputs
+/**
+ * hits are allocated in slabs and given back to the pool once their beam clock
+ * has been consumed (CleanupUsedPackets), rather than one new/delete per hit.
+ * A released hit is reset to its default constructed state.
+ * The pool owns its hits: they are freed with the pool and must never be deleted.
+ */
+template <class T>
+class RawHitPool
+{
+ public:
+  explicit RawHitPool(const size_t slab_size = 4096)
+    : m_SlabSize(slab_size)
+  {
+  }
+
+  //! default constructed hit
+  T *get()
+  {
+    if (m_Free.empty())
+    {
+      add_slab();
+    }
+    T *hit = m_Free.back();
+    m_Free.pop_back();
+    return hit;
+  }
+
+  //! give hit back to the pool
+  void release(T *hit)
+  {
+    std::destroy_at(hit);
+    std::construct_at(hit);
+    m_Free.push_back(hit);
+  }
+
+  //! unique_ptr deleter which gives the hit back to the pool
+  class Releaser
+  {
+   public:
+    explicit Releaser(RawHitPool *pool = nullptr)
+      : m_Pool(pool)
+    {
+    }
+    void operator()(T *hit) const { m_Pool->release(hit); }
+
+   private:
+    RawHitPool *m_Pool{nullptr};
+  };
+
+  using pointer = std::unique_ptr<T, Releaser>;
+
+  //! hit owned by a unique_ptr until it is released to a hit map
+  pointer make() { return pointer(get(), Releaser(this)); }
+
+  //! number of allocated hits
+  size_t capacity() const { return m_Slabs.size() * m_SlabSize; }
+
+  //! number of hits currently handed out
+  size_t size() const { return capacity() - m_Free.size(); }
+
+ private:
+  void add_slab()
+  {
+    m_Slabs.push_back(std::make_unique<T[]>(m_SlabSize));
+    T *slab = m_Slabs.back().get();
+    m_Free.reserve(capacity());
+
+    // hand out the slab in address order
+    for (size_t i = m_SlabSize; i > 0; --i)
+    {
+      m_Free.push_back(slab + i - 1);
+    }
+  }
+
+  size_t m_SlabSize{4096};
+  std::vector<std::unique_ptr<T[]>> m_Slabs;
+  std::vector<T *> m_Free;
+};
+
+#endif
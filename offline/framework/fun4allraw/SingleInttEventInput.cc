@@ -37,6 +37,13 @@ SingleInttEventInput::SingleInttEventInput(const std::string &name)
 SingleInttEventInput::~SingleInttEventInput()
 {
   delete[] plist;
+  for (const auto &iter : m_InttRawHitMap)
+  {
+    for (auto *rawhit : iter.second)
+    {
+      delete rawhit;
+    }
+  }
   for (auto iter : poolmap)
   {
     if (Verbosity() > 2)
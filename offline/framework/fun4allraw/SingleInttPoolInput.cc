@@ -87,16 +87,6 @@ void SingleInttPoolInput::FillPool(const uint64_t minBCO)
       std::cout << "Fetching next Event" << evt->getEvtSequence() << std::endl;
     }
     RunNumber(evt->getRunNumber());
-    if (m_SavedRunNumber != RunNumber())
-    {
-      if (GetVerbosity() > 1)
-      {
-        std::cout << "setting streaming mode for run " << RunNumber() << std::endl;
-      }
-      streamingMode(IsStreaming(RunNumber()));
-      m_SavedRunNumber = RunNumber();
-      ConfigureStreamingInputManagerLocal(m_SavedRunNumber);
-    }
 
     if (GetVerbosity() > 1)
     {
@@ -287,7 +277,7 @@ void SingleInttPoolInput::FillPool(const uint64_t minBCO)
             {
               continue;
             }
-            auto newhit = std::make_unique<InttRawHitv2>();
+            auto newhit = m_RawHitPool.make();
             int FEE = pool->iValue(j, "FEE");
             newhit->set_packetid(pool->getIdentifier());
             newhit->set_fee(FEE);
@@ -394,7 +384,7 @@ void SingleInttPoolInput::CleanupUsedPackets(const uint64_t bclk)
   {
     for (const auto &rawhit : it->second)
     {
-      delete rawhit;
+      m_RawHitPool.release(static_cast<InttRawHitv2 *>(rawhit));
     }
   }
   m_InttRawHitMap.erase(m_InttRawHitMap.begin(), m_InttRawHitMap.upper_bound(bclk));
@@ -520,6 +510,22 @@ void SingleInttPoolInput::CreateDSTNode(PHCompositeNode *topNode)
 }
 //_______________________________________________________
 
+void SingleInttPoolInput::ConfigureRun()
+{
+  // the database is not thread safe, this is not called from FillPool
+  if (m_SavedRunNumber == RunNumber())
+  {
+    return;
+  }
+  if (GetVerbosity() > 1)
+  {
+    std::cout << "setting streaming mode for run " << RunNumber() << std::endl;
+  }
+  streamingMode(IsStreaming(RunNumber()));
+  m_SavedRunNumber = RunNumber();
+  ConfigureStreamingInputManagerLocal(m_SavedRunNumber);
+}
+
 void SingleInttPoolInput::ConfigureStreamingInputManagerLocal(const int runnumber)
 {
   if (StreamingInputManager())
@@ -1,6 +1,7 @@
 #ifndef FUN4ALLRAW_SINGLEINTTPOOLINPUT_H
 #define FUN4ALLRAW_SINGLEINTTPOOLINPUT_H
 
+#include "RawHitPool.h"
 #include "SingleStreamingInput.h"
 
 #include <array>
@@ -12,6 +13,7 @@
 #include <vector>
 
 class InttRawHit;
+class InttRawHitv2;
 class Packet;
 class PHCompositeNode;
 class intt_pool;
@@ -28,6 +30,7 @@ class SingleInttPoolInput : public SingleStreamingInput
   explicit SingleInttPoolInput(const std::string &name);
   ~SingleInttPoolInput() override;
   void FillPool(const uint64_t minBCO) override;
+  void ConfigureRun() override;
   void CleanupUsedPackets(const uint64_t bclk) override;
   bool CheckPoolDepth(const uint64_t bclk) override;
   void ClearCurrentEvent() override;
@@ -58,6 +61,7 @@ class SingleInttPoolInput : public SingleStreamingInput
   std::array<uint64_t, 14> m_Rollover{};
   std::map<uint64_t, std::set<int>> m_BeamClockFEE;
   std::map<uint64_t, std::vector<InttRawHit *>> m_InttRawHitMap;
+  RawHitPool<InttRawHitv2> m_RawHitPool;
   std::map<int, uint64_t> m_FEEBclkMap;
   std::set<uint64_t> m_BclkStack;
 
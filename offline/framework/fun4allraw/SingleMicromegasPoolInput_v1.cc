@@ -292,7 +292,7 @@ void SingleMicromegasPoolInput_v1::FillPool(const unsigned int /*nbclks*/)
         }
 
         // create new hit
-        auto newhit = std::make_unique<MicromegasRawHitv3>();
+        auto newhit = m_RawHitPool.make();
         newhit->set_bco(fee_bco);
         newhit->set_gtm_bco(gtm_bco);
 
@@ -405,7 +405,7 @@ void SingleMicromegasPoolInput_v1::CleanupUsedPackets(const uint64_t bclk, bool
         ++m_waveform_count_dropped_pool[rawhit->get_packetid()];
         h_waveform_count_dropped_pool->Fill(std::to_string(rawhit->get_packetid()).c_str(), 1);
       }
-      delete rawhit;
+      m_RawHitPool.release(static_cast<MicromegasRawHitv3 *>(rawhit));
     }
   }
 
@@ -2,6 +2,7 @@
 #define FUN4ALLRAW_SINGLEMICROMEGASPOOLINPUT_V1_H
 
 #include "MicromegasBcoMatchingInformation_v1.h"
+#include "RawHitPool.h"
 #include "SingleStreamingInput.h"
 
 #include <phool/PHTimer.h>
@@ -15,6 +16,7 @@
 #include <vector>
 
 class MicromegasRawHit;
+class MicromegasRawHitv3;
 class Packet;
 
 class TFile;
@@ -75,6 +77,9 @@ class SingleMicromegasPoolInput_v1 : public SingleStreamingInput
   //! store list of raw hits matching a given bco
   std::map<uint64_t, std::vector<MicromegasRawHit *>> m_MicromegasRawHitMap;
 
+  //! recycled raw hits
+  RawHitPool<MicromegasRawHitv3> m_RawHitPool;
+
   //! store current list of BCO on a per fee basis.
   /** only packets for which a given FEE have data are stored */
   std::map<int, uint64_t> m_FEEBclkMap;
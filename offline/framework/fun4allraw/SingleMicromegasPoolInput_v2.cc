@@ -357,8 +357,8 @@ void SingleMicromegasPoolInput_v2::CleanupUsedPackets(const uint64_t bclk, bool
           h_fee_waveform_count_dropped_pool->Fill(rawhit->get_fee(), 1);
         }
 
-        // delete raw hit
-        delete rawhit;
+        // give raw hit back to the pool
+        m_RawHitPool.release(static_cast<MicromegasRawHit_impl*>(rawhit));
       }
     }
   }
@@ -922,7 +922,7 @@ void SingleMicromegasPoolInput_v2::process_fee_data(int packet_id, unsigned int
     }
 
     // create new hit
-    auto newhit = std::make_unique<MicromegasRawHit_impl>();
+    auto newhit = m_RawHitPool.make();
     newhit->set_bco(fee_bco);
     newhit->set_gtm_bco(gtm_bco);
 
@@ -1067,7 +1067,7 @@ void SingleMicromegasPoolInput_v2::recover_truncated_waveforms( const uint64_t t
     }
 
     // keep track of newly created hits
-    using rawhit_impl_pointer_t = std::unique_ptr<MicromegasRawHit_impl>; // unique_ptr to raw hit implementation object
+    using rawhit_impl_pointer_t = RawHitPool<MicromegasRawHit_impl>::pointer; // unique_ptr to pooled raw hit implementation object
     using rawhit_impl_array_t = std::array<rawhit_impl_pointer_t, MAX_FEECHANNELCOUNT>; // fixed size array of the above
     rawhit_impl_array_t new_rawhits{};
 
@@ -1114,8 +1114,9 @@ void SingleMicromegasPoolInput_v2::recover_truncated_waveforms( const uint64_t t
             // get FEE BCO from GTM
             const auto target_fee_bco = bco_matching_information.get_predicted_fee_bco( target_bco_corrected ).value();
 
-            // create new hit with shifted waveform
-            target = new MicromegasRawHit_impl;
+            // create new hit with shifted waveform, stored in new array
+            new_rawhits[channel] = m_RawHitPool.make();
+            target = new_rawhits[channel].get();
 
             // copy relevant members from source
             target->set_bco(target_fee_bco);
@@ -1126,9 +1127,6 @@ void SingleMicromegasPoolInput_v2::recover_truncated_waveforms( const uint64_t t
             target->set_sampaaddress(source->get_sampaaddress());
             target->set_sampachannel(source->get_sampachannel());
 
-            // store in new array
-            new_rawhits[target->get_channel()].reset(target);
-
           }
 
           // calculate waveform shift
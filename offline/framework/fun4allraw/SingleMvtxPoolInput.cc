@@ -177,7 +177,7 @@ void SingleMvtxPoolInput::FillPool(const uint64_t minBCO)
             auto hits = pool->get_hits(feeId, i_strb);
             for (auto &&hit : hits)
             {
-              auto newhit = std::make_unique<MvtxRawHitv1>();
+              auto newhit = m_RawHitPool.make();
               newhit->set_bco(strb_bco);
               newhit->set_strobe_bc(strb_bc);
               newhit->set_chip_bc(hit->bunchcounter);
@@ -298,7 +298,7 @@ void SingleMvtxPoolInput::CleanupUsedPackets(const uint64_t bclk)
   {
     for (const auto &rawhit : it->second)
     {
-      delete rawhit;
+      m_RawHitPool.release(static_cast<MvtxRawHitv1 *>(rawhit));
     }
   }
   m_MvtxRawHitMap.erase(m_MvtxRawHitMap.begin(), m_MvtxRawHitMap.upper_bound(bclk));
@@ -1,6 +1,7 @@
 #ifndef FUN4ALLRAW_SINGLEMVTXPOOLINPUT_H
 #define FUN4ALLRAW_SINGLEMVTXPOOLINPUT_H
 
+#include "RawHitPool.h"
 #include "SingleStreamingInput.h"
 
 #include <algorithm>
@@ -8,6 +9,7 @@
 #include <vector>
 
 class MvtxRawHit;
+class MvtxRawHitv1;
 class Packet;
 class mvtx_pool;
 
@@ -46,6 +48,7 @@ class SingleMvtxPoolInput : public SingleStreamingInput
   std::string m_rawEventHeaderName = "MVTXRAWEVTHEADER";
 
   std::map<uint64_t, std::vector<MvtxRawHit *>> m_MvtxRawHitMap;
+  RawHitPool<MvtxRawHitv1> m_RawHitPool;
   std::map<int, uint64_t> m_FEEBclkMap;
   std::map<int, uint64_t> m_FeeStrobeMap;
   std::set<uint64_t> m_BclkStack;
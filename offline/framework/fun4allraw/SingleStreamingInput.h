@@ -23,6 +23,8 @@ class SingleStreamingInput : public Fun4AllBase, public InputFileHandler
   virtual void FillPool(const uint64_t) { return; }
   virtual void FillPool(const unsigned int = 1) { return; }
   virtual int FillPoolStatus() const { return 0; }
+  //! per run configuration (e.g. database lookups), called serially after FillPool
+  virtual void ConfigureRun() { return; }
   virtual void RunNumber(const int runno) { m_RunNumber = runno; }
   virtual int RunNumber() const { return m_RunNumber; }
   virtual int fileopen(const std::string &filename) override;
@@ -167,24 +167,23 @@ void SingleTpcPoolInput::FillPool(const uint64_t minBCO)
       else
       {
         int m_nWaveFormInFrame = packet->iValue(0, "NR_WF");
-        static int once = 0;
         for (int wf = 0; wf < m_nWaveFormInFrame; wf++)
         {
           if (m_TpcRawHitMap[gtm_bco].size() > 20000)
           {
-            if (!once)
+            if (!m_TooManyHitsCount)
             {
               std::cout << "too many hits" << std::endl;
             }
-            once++;
+            m_TooManyHitsCount++;
             continue;
           }
           
-                      if (once)
+                      if (m_TooManyHitsCount)
             {
-              std::cout << "many more hits: " << once << std::endl;
+              std::cout << "many more hits: " << m_TooManyHitsCount << std::endl;
             }
-            once = 0;
+            m_TooManyHitsCount = 0;
          
           bool checksumerror = (packet->iValue(wf, "CHECKSUMERROR") > 0);
           if (checksumerror)
@@ -192,7 +191,7 @@ void SingleTpcPoolInput::FillPool(const uint64_t minBCO)
             continue;
           }
           bool parityerror = (packet->iValue(wf, "DATAPARITYERROR") > 0);
-          auto newhit = std::make_unique<TpcRawHitv2>();
+          auto newhit = m_RawHitPool.make();
           int FEE = packet->iValue(wf, "FEE");
           newhit->set_bco(packet->iValue(wf, "BCO"));
 
@@ -333,7 +332,7 @@ void SingleTpcPoolInput::CleanupUsedPackets(const uint64_t bclk)
     {
       for (auto *pktiter : iter.second)
       {
-        delete pktiter;
+        m_RawHitPool.release(static_cast<TpcRawHitv2 *>(pktiter));
       }
       toclearbclk.push_back(iter.first);
     }
@@ -33,8 +33,15 @@
 #include <Event/fileEventiterator.h>
 
 #include <memory>
+#include <mutex>
 #include <set>
 
+namespace
+{
+  //! builders register their QA histograms in the shared histogram manager
+  std::mutex builder_creation_mutex;
+}  // namespace
+
 SingleTpcTimeFrameInput::SingleTpcTimeFrameInput(const std::string &name)
   : SingleStreamingInput(name)
   , plist(new Packet *[NTPCPACKETS])
@@ -118,10 +125,9 @@ void SingleTpcTimeFrameInput::FillPool(const uint64_t targetBCO)
 {
   m_FillPoolStatus = Fun4AllReturnCodes::EVENT_OK;
   {
-    static bool first = true;
-    if (first)
+    if (m_FirstFillPool)
     {
-      first = false;
+      m_FirstFillPool = false;
 
       if (!m_SelectedPacketIDs.empty())
       {
@@ -318,6 +324,8 @@ void SingleTpcTimeFrameInput::FillPool(const uint64_t targetBCO)
 
       if (!m_TpcTimeFrameBuilderMap.contains(packet_id))
       {
+        // inputs may be filled in parallel by Fun4AllStreamingInputManager
+        std::lock_guard<std::mutex> lock(builder_creation_mutex);
         TpcTimeFrameBuilderBase *builder = nullptr;
         if (hit_format == IDTPCFEEV4)
         {
@@ -87,6 +87,7 @@ class SingleTpcTimeFrameInput : public SingleStreamingInput
   };
 
   int m_FillPoolStatus{0};
+  bool m_FirstFillPool{true};
   std::string m_digitalCurrentDebugTTreeName;
   std::string m_bxCounterSyncCDBTTreeName;
 };
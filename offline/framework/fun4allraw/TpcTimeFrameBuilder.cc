@@ -24,6 +24,7 @@
 #include <TTree.h>
 #include <TVector3.h>
 
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <limits>
@@ -413,8 +414,9 @@ void TpcTimeFrameBuilder::CleanupUsedPackets(const uint64_t& bclk)
 
 int TpcTimeFrameBuilder::ProcessPacket(Packet* packet)
 {
-  static size_t call_count = 0;
-  ++call_count;
+  // shared by all packets, which may be processed on different threads
+  static std::atomic<size_t> total_call_count{0};
+  const size_t call_count = ++total_call_count;
 
   if (m_verbosity > 1)
   {
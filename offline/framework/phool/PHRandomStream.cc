@@ -0,0 +1,138 @@
+#include "PHRandomStream.h"
+#include "PHRandomSeed.h"
+#include "recoConsts.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+  //! FNV-1a hash of the module name
+  uint64_t hash_name(const std::string &name)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const auto &c : name)
+    {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+}  // namespace
+
+uint64_t PHRandomStream::GetKey(const std::string &name)
+{
+  uint64_t key = 0;
+  recoConsts *rc = recoConsts::instance();
+  if (rc->FlagExist("RANDOMSEED"))
+  {
+    // mix fixed seed and module name through one Philox block
+    const auto seed = static_cast<uint32_t>(rc->get_IntFlag("RANDOMSEED"));
+    const uint64_t hash = hash_name(name);
+    const auto block = Philox({static_cast<uint32_t>(hash), static_cast<uint32_t>(hash >> 32U), 0, 0}, {seed, 0});
+    key = (static_cast<uint64_t>(block[1]) << 32U) | block[0];
+  }
+  else
+  {
+    key = (static_cast<uint64_t>(PHRandomSeed::GetSeed()) << 32U) | PHRandomSeed::GetSeed();
+  }
+
+  if (PHRandomSeed::Verbosity())
+  {
+    std::cout << "PHRandomStream::GetKey - " << name << " key: " << key << std::endl;
+  }
+  return key;
+}
+
+void PHRandomStream::Uniform(double *values, const std::size_t size)
+{
+  std::size_t i = 0;
+
+  // use remaining values from current block
+  for (; i < size && m_position < 4; ++i)
+  {
+    values[i] = ToUniform(m_block[m_position++]);
+  }
+
+  // full blocks
+  for (; i + 4 <= size; i += 4)
+  {
+    const auto block = Philox(m_counter, m_key);
+    ++m_counter[0];
+    for (std::size_t j = 0; j < 4; ++j)
+    {
+      values[i + j] = ToUniform(block[j]);
+    }
+  }
+
+  // tail
+  for (; i < size; ++i)
+  {
+    values[i] = Uniform();
+  }
+}
+
+double PHRandomStream::Gaus(const double sigma)
+{
+  if (m_has_gaus)
+  {
+    m_has_gaus = false;
+    return sigma * m_gaus;
+  }
+
+  // Box-Muller
+  const double radius = std::sqrt(-2. * std::log(Uniform()));
+  const double phi = 2. * M_PI * Uniform();
+  m_gaus = radius * std::sin(phi);
+  m_has_gaus = true;
+  return sigma * radius * std::cos(phi);
+}
+
+unsigned int PHRandomStream::Poisson(const double mu)
+{
+  if (mu <= 0)
+  {
+    return 0;
+  }
+
+  if (mu < 10)
+  {
+    // multiplication of uniform numbers (Knuth)
+    const double limit = std::exp(-mu);
+    unsigned int count = 0;
+    double product = Uniform();
+    while (product > limit)
+    {
+      ++count;
+      product *= Uniform();
+    }
+    return count;
+  }
+
+  // transformed rejection with squeeze (PTRS, Hormann 1993)
+  const double slam = std::sqrt(mu);
+  const double loglam = std::log(mu);
+  const double b = 0.931 + 2.53 * slam;
+  const double a = -0.059 + 0.02483 * b;
+  const double invalpha = 1.1239 + 1.1328 / (b - 3.4);
+  const double vr = 0.9277 - 3.6224 / (b - 2);
+  while (true)
+  {
+    const double u = Uniform() - 0.5;
+    const double v = Uniform();
+    const double us = 0.5 - std::abs(u);
+    const double k = std::floor((2 * a / us + b) * u + mu + 0.43);
+    if (us >= 0.07 && v <= vr)
+    {
+      return static_cast<unsigned int>(k);
+    }
+    if (k < 0 || (us < 0.013 && v > us))
+    {
+      continue;
+    }
+    if ((std::log(v) + std::log(invalpha) - std::log(a / (us * us) + b)) <= (-mu + k * loglam - std::lgamma(k + 1)))
+    {
+      return static_cast<unsigned int>(k);
+    }
+  }
+}
@@ -0,0 +1,122 @@
+#ifndef PHOOL_PHRANDOMSTREAM_H
+#define PHOOL_PHRANDOMSTREAM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//! counter based random number stream (Philox4x32-10)
+/**
+ * the random numbers are a pure function of (key, run, event, stream, index),
+ * there is no shared state. Any thread can create the stream it needs and
+ * the result does not depend on the order in which streams are used.
+ *
+ * typical use:
+ * - in the module constructor: `m_key = PHRandomStream::GetKey(Name());`
+ * - for each event and independent unit of work (sector, channel, ...):
+ *   `PHRandomStream rng(m_key, run, event, stream);`
+ *
+ * The key is reproducible if recoConsts RANDOMSEED is set, see GetKey
+ */
+class PHRandomStream
+{
+ public:
+  using counter_type = std::array<uint32_t, 4>;
+  using key_type = std::array<uint32_t, 2>;
+
+  PHRandomStream(const uint64_t key, const uint32_t run, const uint32_t event, const uint32_t stream)
+  {
+    Reset(key, run, event, stream);
+  }
+
+  //! restart at the beginning of a new stream
+  void Reset(const uint64_t key, const uint32_t run, const uint32_t event, const uint32_t stream)
+  {
+    m_key = {static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32U)};
+    m_counter = {0, stream, event, run};
+    m_position = 4;
+    m_has_gaus = false;
+  }
+
+  //! next 32 bit random integer
+  uint32_t operator()()
+  {
+    if (m_position == 4)
+    {
+      m_block = Philox(m_counter, m_key);
+      ++m_counter[0];
+      m_position = 0;
+    }
+    return m_block[m_position++];
+  }
+
+  //! uniform random number in ]0,1]
+  double Uniform()
+  {
+    return ToUniform((*this)());
+  }
+
+  //! fill array with uniform random numbers in ]0,1]
+  /** whole Philox blocks are generated, which the compiler can vectorize */
+  void Uniform(double *values, const std::size_t size);
+
+  //! gaussian random number with mean 0 and given sigma
+  double Gaus(const double sigma = 1);
+
+  //! poisson random number with given mean
+  unsigned int Poisson(const double mu);
+
+  //! 32 bit seed, for modules which keep using their gsl/std generator for a given stream
+  static uint32_t Seed(const uint64_t key, const uint32_t run, const uint32_t event, const uint32_t stream)
+  {
+    return PHRandomStream(key, run, event, stream)();
+  }
+
+  //! module key
+  /**
+   * if recoConsts RANDOMSEED is set, the key only depends on RANDOMSEED and the module name,
+   * not on the order in which modules are created.
+   * otherwise it is obtained from PHRandomSeed
+   */
+  static uint64_t GetKey(const std::string &name);
+
+  //! Philox4x32 block function with 10 rounds
+  static constexpr counter_type Philox(counter_type counter, key_type key)
+  {
+    for (int round = 0; round < 10; ++round)
+    {
+      if (round > 0)
+      {
+        key[0] += 0x9E3779B9U;
+        key[1] += 0xBB67AE85U;
+      }
+      const uint64_t product0 = static_cast<uint64_t>(0xD2511F53U) * counter[0];
+      const uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57U) * counter[2];
+      counter = {
+          static_cast<uint32_t>(product1 >> 32U) ^ counter[1] ^ key[0],
+          static_cast<uint32_t>(product1),
+          static_cast<uint32_t>(product0 >> 32U) ^ counter[3] ^ key[1],
+          static_cast<uint32_t>(product0)};
+    }
+    return counter;
+  }
+
+  //! convert 32 bit integer to double in ]0,1]
+  static constexpr double ToUniform(const uint32_t value)
+  {
+    return (static_cast<double>(value) + 1.) * (1. / 4294967296.);
+  }
+
+ private:
+  key_type m_key{};
+  counter_type m_counter{};
+  counter_type m_block{};
+  unsigned int m_position = 4;
+
+  //! second gaussian from Box-Muller
+  bool m_has_gaus = false;
+  double m_gaus = 0;
+};
+
+#endif
@@ -0,0 +1,165 @@
+// unit test of PHRandomStream: Philox4x32-10 known answers and seed derivation
+// run with "make check"
+
+#include "PHRandomStream.h"
+#include "recoConsts.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  int nfailed = 0;
+
+  void check(const bool condition, const std::string &what)
+  {
+    if (!condition)
+    {
+      std::cout << "PHRandomStreamTest - FAILED: " << what << std::endl;
+      ++nfailed;
+    }
+  }
+
+  // known answer tests of the Random123 distribution (kat_vectors, philox4x32_10)
+  void test_known_answers()
+  {
+    struct KnownAnswer
+    {
+      PHRandomStream::counter_type counter;
+      PHRandomStream::key_type key;
+      PHRandomStream::counter_type expected;
+    };
+    const std::array<KnownAnswer, 3> answers = {{
+        {{0x00000000, 0x00000000, 0x00000000, 0x00000000}, {0x00000000, 0x00000000}, {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+        {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}, {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+        {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}, {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}},
+    }};
+    for (const auto &answer : answers)
+    {
+      check(PHRandomStream::Philox(answer.counter, answer.key) == answer.expected, "Philox4x32-10 known answer");
+    }
+
+    // the block function is usable at compile time
+    static_assert(PHRandomStream::Philox({0, 0, 0, 0}, {0, 0})[0] == 0x6627e8d5U);
+  }
+
+  // the stream is (key, run, event, stream) -> counter (index, stream, event, run)
+  void test_stream_layout()
+  {
+    const uint64_t key = 0x0123456789abcdefULL;
+    PHRandomStream rng(key, 54321, 17, 5);
+    for (uint32_t index = 0; index < 3; ++index)
+    {
+      const auto block = PHRandomStream::Philox({index, 5, 17, 54321}, {0x89abcdef, 0x01234567});
+      for (const auto value : block)
+      {
+        check(rng() == value, "stream values are the Philox blocks of consecutive counters");
+      }
+    }
+
+    // Seed() is the first value of the stream
+    check(PHRandomStream::Seed(key, 54321, 17, 5) == PHRandomStream::Philox({0, 5, 17, 54321}, {0x89abcdef, 0x01234567})[0], "Seed() is the first value of the stream");
+
+    // all inputs change the seed
+    const uint32_t seed = PHRandomStream::Seed(key, 1, 2, 3);
+    check(seed != PHRandomStream::Seed(key + 1, 1, 2, 3), "seed depends on the key");
+    check(seed != PHRandomStream::Seed(key, 2, 2, 3), "seed depends on the run");
+    check(seed != PHRandomStream::Seed(key, 1, 3, 3), "seed depends on the event");
+    check(seed != PHRandomStream::Seed(key, 1, 2, 4), "seed depends on the stream");
+  }
+
+  // the values do not depend on the order in which streams are used
+  void test_order_independence()
+  {
+    const uint64_t key = 42;
+    std::vector<uint32_t> forward;
+    for (uint32_t stream = 0; stream < 24; ++stream)
+    {
+      forward.push_back(PHRandomStream::Seed(key, 1, 100, stream));
+    }
+    for (uint32_t stream = 24; stream-- > 0;)
+    {
+      check(PHRandomStream::Seed(key, 1, 100, stream) == forward[stream], "seed independent of the order of the streams");
+    }
+
+    // a stream reset to the same inputs restarts
+    PHRandomStream rng(key, 1, 100, 3);
+    const uint32_t first = rng();
+    rng();
+    rng.Reset(key, 1, 100, 3);
+    check(rng() == first, "Reset() restarts the stream");
+  }
+
+  // bulk fill gives the same numbers as single calls
+  void test_bulk_uniform()
+  {
+    PHRandomStream single(7, 1, 2, 3);
+    PHRandomStream bulk(7, 1, 2, 3);
+    std::vector<double> values(23);
+    // start in the middle of a block
+    single.Uniform();
+    bulk.Uniform();
+    bulk.Uniform(values.data(), values.size());
+    for (const double value : values)
+    {
+      check(value == single.Uniform(), "bulk Uniform() equals single Uniform()");
+      check(value > 0 && value <= 1, "Uniform() in ]0,1]");
+    }
+  }
+
+  void test_distributions()
+  {
+    PHRandomStream rng(11, 1, 1, 0);
+    const int n = 200000;
+    double sum = 0;
+    double sum2 = 0;
+    double psum = 0;
+    for (int i = 0; i < n; ++i)
+    {
+      const double x = rng.Gaus(2.);
+      sum += x;
+      sum2 += x * x;
+      psum += rng.Poisson(3.5);
+    }
+    const double mean = sum / n;
+    const double sigma = std::sqrt(sum2 / n - mean * mean);
+    check(std::abs(mean) < 0.03, "gaussian mean");
+    check(std::abs(sigma - 2.) < 0.03, "gaussian sigma");
+    check(std::abs(psum / n - 3.5) < 0.03, "poisson mean");
+  }
+
+  // with RANDOMSEED the module key only depends on the seed and the module name
+  void test_module_key()
+  {
+    recoConsts *rc = recoConsts::instance();
+    rc->set_IntFlag("RANDOMSEED", 12345);
+    const uint64_t drift = PHRandomStream::GetKey("PHG4TpcElectronDrift");
+    const uint64_t digitizer = PHRandomStream::GetKey("PHG4TpcDigitizer");
+    check(drift == PHRandomStream::GetKey("PHG4TpcElectronDrift"), "module key reproducible");
+    check(drift != digitizer, "module key depends on the module name");
+    rc->set_IntFlag("RANDOMSEED", 12346);
+    check(drift != PHRandomStream::GetKey("PHG4TpcElectronDrift"), "module key depends on RANDOMSEED");
+  }
+}  // namespace
+
+int main()
+{
+  test_known_answers();
+  test_stream_layout();
+  test_order_independence();
+  test_bulk_uniform();
+  test_distributions();
+  test_module_key();
+
+  if (nfailed)
+  {
+    std::cout << "PHRandomStreamTest - " << nfailed << " checks failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "PHRandomStreamTest - all checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}
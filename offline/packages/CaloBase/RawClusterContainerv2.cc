@@ -0,0 +1,190 @@
+#include "RawClusterContainerv2.h"
+
+#include "RawCluster.h"
+#include "RawClusterContainer.h"
+
+#include <phool/phool.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <utility>
+
+void RawClusterContainerv2::Reset()
+{
+  // keep the allocated memory for the next event
+  _clusters.clear();
+  _tower_keys.clear();
+  _tower_energies.clear();
+}
+
+void RawClusterContainerv2::identify(std::ostream &os) const
+{
+  os << "RawClusterContainerv2, number of clusters: " << size()
+     << ", number of towers: " << _tower_keys.size() << std::endl;
+}
+
+RawClusterv2 *RawClusterContainerv2::add_cluster()
+{
+  bind();
+  const RawClusterDefs::keytype key = _clusters.empty() ? 0 : _clusters.back().get_id() + 1;
+  auto &cluster = _clusters.emplace_back();
+  cluster.set_id(key);
+  cluster._tower_begin = _tower_keys.size();
+  cluster._container = this;
+  return &cluster;
+}
+
+RawClusterv2 *RawClusterContainerv2::add_cluster(const RawCluster &source)
+{
+  auto *cluster = add_cluster();
+  cluster->set_energy(source.get_energy());
+  cluster->set_r(source.get_r());
+  cluster->set_phi(source.get_phi());
+  cluster->set_z(source.get_z());
+
+  // the tower map is sorted by key, towers are appended as they are
+  for (const auto &[key, energy] : source.get_towermap())
+  {
+    _tower_keys.push_back(key);
+    _tower_energies.push_back(energy);
+  }
+  cluster->_ntowers = _tower_keys.size() - cluster->_tower_begin;
+
+  for (int slot = 0; slot < RawClusterv2::nprop_slots; ++slot)
+  {
+    const auto prop_id = RawClusterv2::get_slot_property(slot);
+    if (!source.has_property(prop_id))
+    {
+      continue;
+    }
+
+    switch (RawCluster::get_property_info(prop_id).second)
+    {
+    case RawCluster::type_int:
+      cluster->set_property(prop_id, source.get_property_int(prop_id));
+      break;
+    case RawCluster::type_uint:
+      cluster->set_property(prop_id, source.get_property_uint(prop_id));
+      break;
+    case RawCluster::type_float:
+      cluster->set_property(prop_id, source.get_property_float(prop_id));
+      break;
+    default:
+      break;
+    }
+  }
+  return cluster;
+}
+
+void RawClusterContainerv2::fill(const RawClusterContainer &clusters)
+{
+  Reset();
+  _clusters.reserve(clusters.size());
+  for (const auto &[key, source] : clusters.getClustersMap())
+  {
+    // map keys are increasing, so that the clusters stay sorted by id
+    add_cluster(*source)->set_id(key);
+  }
+}
+
+size_t RawClusterContainerv2::find(const RawClusterDefs::keytype key) const
+{
+  // clusters are usually numbered from 0
+  if (key < _clusters.size() && _clusters[key].get_id() == key)
+  {
+    return key;
+  }
+
+  const auto iter = std::lower_bound(_clusters.begin(), _clusters.end(), key, [](const RawClusterv2 &cluster, const RawClusterDefs::keytype value)
+                                     { return cluster.get_id() < value; });
+  if (iter == _clusters.end() || iter->get_id() != key)
+  {
+    return _clusters.size();
+  }
+  return iter - _clusters.begin();
+}
+
+RawClusterv2 *RawClusterContainerv2::getCluster(const RawClusterDefs::keytype key)
+{
+  const auto index = find(key);
+  if (index == _clusters.size())
+  {
+    return nullptr;
+  }
+  bind();
+  return &_clusters[index];
+}
+
+const RawClusterv2 *RawClusterContainerv2::getCluster(const RawClusterDefs::keytype key) const
+{
+  const auto index = find(key);
+  if (index == _clusters.size())
+  {
+    return nullptr;
+  }
+  bind();
+  return &_clusters[index];
+}
+
+std::span<RawClusterv2> RawClusterContainerv2::getClusters()
+{
+  bind();
+  return _clusters;
+}
+
+std::span<const RawClusterv2> RawClusterContainerv2::getClusters() const
+{
+  bind();
+  return _clusters;
+}
+
+double RawClusterContainerv2::getTotalEdep() const
+{
+  double totalenergy = 0;
+  for (const auto &cluster : _clusters)
+  {
+    totalenergy += cluster.get_energy();
+  }
+  return totalenergy;
+}
+
+void RawClusterContainerv2::add_tower(RawClusterv2 &cluster, const RawTowerDefs::keytype key, const float energy)
+{
+  if (_clusters.empty() || &cluster != &_clusters.back())
+  {
+    std::cout << PHWHERE << " towers can only be added to the last cluster of the container, cluster id "
+              << cluster.get_id() << std::endl;
+    exit(1);
+  }
+
+  const auto begin = _tower_keys.begin() + cluster._tower_begin;
+  const auto iter = std::lower_bound(begin, _tower_keys.end(), key);
+  if (iter != _tower_keys.end() && *iter == key)
+  {
+    std::cout << "tower 0x" << std::hex << key << ", dec: " << std::dec
+              << key << " already exists, that is bad" << std::endl;
+    exit(1);
+  }
+
+  // only the towers of the last cluster are moved
+  const auto index = iter - _tower_keys.begin();
+  _tower_keys.insert(iter, key);
+  _tower_energies.insert(_tower_energies.begin() + index, energy);
+  ++cluster._ntowers;
+}
+
+void RawClusterContainerv2::bind() const
+{
+  if (_clusters.empty() || _clusters.front()._container == this)
+  {
+    return;
+  }
+
+  auto *container = const_cast<RawClusterContainerv2 *>(this);
+  for (const auto &cluster : _clusters)
+  {
+    cluster._container = container;
+    cluster._towermap_filled = false;
+  }
+}
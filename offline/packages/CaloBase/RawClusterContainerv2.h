@@ -0,0 +1,80 @@
+#ifndef CALOBASE_RAWCLUSTERCONTAINERV2_H
+#define CALOBASE_RAWCLUSTERCONTAINERV2_H
+
+#include "RawClusterDefs.h"
+#include "RawClusterv2.h"
+#include "RawTowerDefs.h"
+
+#include <phool/PHObject.h>
+
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <vector>
+
+class RawCluster;
+class RawClusterContainer;
+
+/**
+ * flat cluster container.
+ * clusters are stored as contiguous RawClusterv2 records, sorted by id,
+ * and the towers of all clusters in one shared pool of tower keys and energies:
+ * the towers of a cluster are a range of the pool (compressed sparse rows).
+ * Towers can only be added to the last cluster, pointers to clusters are invalidated
+ * when a cluster is added.
+ * Reset() keeps the allocated memory for the next event.
+ */
+class RawClusterContainerv2 : public PHObject
+{
+ public:
+  RawClusterContainerv2() = default;
+  ~RawClusterContainerv2() override = default;
+
+  PHObject *CloneMe() const override { return new RawClusterContainerv2(*this); }
+  void Reset() override;
+  int isValid() const override { return !_clusters.empty(); }
+  void identify(std::ostream &os = std::cout) const override;
+
+  //! new cluster, with an id following the last cluster
+  RawClusterv2 *add_cluster();
+
+  //! copy of a cluster of any version (not of this container), with an id following the last cluster
+  RawClusterv2 *add_cluster(const RawCluster &cluster);
+
+  //! replace the content by the clusters of an old style container, keeping their ids
+  void fill(const RawClusterContainer &clusters);
+
+  RawClusterv2 *getCluster(const RawClusterDefs::keytype key);
+  const RawClusterv2 *getCluster(const RawClusterDefs::keytype key) const;
+
+  //! all clusters, sorted by id
+  std::span<RawClusterv2> getClusters();
+  std::span<const RawClusterv2> getClusters() const;
+
+  size_t size() const { return _clusters.size(); }
+  double getTotalEdep() const;
+
+  //! tower pool, the towers of all clusters one after the other
+  std::span<const RawTowerDefs::keytype> get_tower_keys() const { return _tower_keys; }
+  std::span<const float> get_tower_energies() const { return _tower_energies; }
+
+ private:
+  friend class RawClusterv2;
+
+  //! add a tower to the last cluster, keeping its towers sorted by key
+  void add_tower(RawClusterv2 &cluster, const RawTowerDefs::keytype key, const float energy);
+
+  //! point the clusters to this container, after a copy or reading from file
+  void bind() const;
+
+  //! index of a cluster, size() if not found
+  size_t find(const RawClusterDefs::keytype key) const;
+
+  std::vector<RawClusterv2> _clusters;
+  std::vector<RawTowerDefs::keytype> _tower_keys;
+  std::vector<float> _tower_energies;
+
+  ClassDefOverride(RawClusterContainerv2, 1)
+};
+
+#endif
@@ -0,0 +1,6 @@
+#ifdef __CINT__
+
+#pragma link C++ class RawClusterContainerv2 + ;
+#pragma link C++ class std::vector<RawClusterv2> + ;
+
+#endif /* __CINT__ */
@@ -0,0 +1,567 @@
+#include "RawClusterv2.h"
+
+#include "RawClusterContainerv2.h"
+#include "RawTowerDefs.h"
+
+#include <phool/phool.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace
+{
+  //! convert between 32bit inputs and the slot storage
+  union u_property
+  {
+    float fdata;
+    int32_t idata;
+    uint32_t uidata;
+  };
+
+  //! type of the property of each slot
+  const std::array<RawCluster::PROPERTY_TYPE, RawClusterv2::nprop_slots>& slot_types()
+  {
+    static const std::array<RawCluster::PROPERTY_TYPE, RawClusterv2::nprop_slots> types = []
+    {
+      std::array<RawCluster::PROPERTY_TYPE, RawClusterv2::nprop_slots> t{};
+      for (int slot = 0; slot < RawClusterv2::nprop_slots; ++slot)
+      {
+        t[slot] = RawCluster::get_property_info(RawClusterv2::get_slot_property(slot)).second;
+      }
+      return t;
+    }();
+    return types;
+  }
+}  // namespace
+
+int RawClusterv2::get_property_slot(const PROPERTY prop_id)
+{
+  switch (prop_id)
+  {
+  case prop_ecore:
+    return 0;
+  case prop_prob:
+    return 1;
+  case prop_chi2:
+    return 2;
+  case prop_merged_cluster_prob:
+    return 3;
+  case prop_et_iso_calotower_sub_R01:
+    return 4;
+  case prop_et_iso_calotower_R01:
+    return 5;
+  case prop_et_iso_calotower_sub_R02:
+    return 6;
+  case prop_et_iso_calotower_R02:
+    return 7;
+  case prop_et_iso_calotower_sub_R03:
+    return 8;
+  case prop_et_iso_calotower_R03:
+    return 9;
+  case prop_et_iso_calotower_sub_R04:
+    return 10;
+  case prop_et_iso_calotower_R04:
+    return 11;
+  case prop_tower_x_raw:
+    return 12;
+  case prop_tower_y_raw:
+    return 13;
+  case prop_tower_x_corr:
+    return 14;
+  case prop_tower_y_corr:
+    return 15;
+  case prop_tower_t_mean:
+    return 16;
+  case prop_incidence_alpha_phi:
+    return 17;
+  case prop_incidence_alpha_eta:
+    return 18;
+  default:
+    return -1;
+  }
+}
+
+RawCluster::PROPERTY RawClusterv2::get_slot_property(const int slot)
+{
+  static const PROPERTY slot_properties[nprop_slots] = {
+      prop_ecore,
+      prop_prob,
+      prop_chi2,
+      prop_merged_cluster_prob,
+      prop_et_iso_calotower_sub_R01,
+      prop_et_iso_calotower_R01,
+      prop_et_iso_calotower_sub_R02,
+      prop_et_iso_calotower_R02,
+      prop_et_iso_calotower_sub_R03,
+      prop_et_iso_calotower_R03,
+      prop_et_iso_calotower_sub_R04,
+      prop_et_iso_calotower_R04,
+      prop_tower_x_raw,
+      prop_tower_y_raw,
+      prop_tower_x_corr,
+      prop_tower_y_corr,
+      prop_tower_t_mean,
+      prop_incidence_alpha_phi,
+      prop_incidence_alpha_eta};
+  return slot_properties[slot];
+}
+
+void RawClusterv2::Reset()
+{
+  // the towers stay in the pool of the container until the container is reset
+  clusterid = 0;
+  _z = std::numeric_limits<float>::quiet_NaN();
+  _r = std::numeric_limits<float>::quiet_NaN();
+  _phi = std::numeric_limits<float>::quiet_NaN();
+  _energy = std::numeric_limits<float>::quiet_NaN();
+  _ntowers = 0;
+  _prop_set = 0;
+  std::fill(std::begin(_props), std::end(_props), 0);
+  _towermap.clear();
+  _towermap_filled = false;
+}
+
+std::span<const RawTowerDefs::keytype> RawClusterv2::get_tower_keys() const
+{
+  if (!_container || _ntowers == 0)
+  {
+    return {};
+  }
+  return {_container->_tower_keys.data() + _tower_begin, _ntowers};
+}
+
+std::span<const float> RawClusterv2::get_tower_energies() const
+{
+  if (!_container || _ntowers == 0)
+  {
+    return {};
+  }
+  return {_container->_tower_energies.data() + _tower_begin, _ntowers};
+}
+
+const RawCluster::TowerMap& RawClusterv2::get_towermap() const
+{
+  if (!_towermap_filled)
+  {
+    _towermap.clear();
+    const auto keys = get_tower_keys();
+    const auto energies = get_tower_energies();
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+      _towermap.emplace_hint(_towermap.end(), keys[i], energies[i]);
+    }
+    _towermap_filled = true;
+  }
+  return _towermap;
+}
+
+RawCluster::TowerConstRange RawClusterv2::get_towers() const
+{
+  const auto& towermap = get_towermap();
+  return make_pair(towermap.begin(), towermap.end());
+}
+
+void RawClusterv2::addTower(const RawClusterDefs::keytype twrid, const float etower)
+{
+  if (!_container)
+  {
+    std::cout << PHWHERE << " cluster " << get_id() << " does not belong to a RawClusterContainerv2, towers cannot be added" << std::endl;
+    exit(1);
+  }
+  _container->add_tower(*this, twrid, etower);
+  _towermap_filled = false;
+}
+
+void RawClusterv2::identify(std::ostream& os) const
+{
+  os << "RawClusterv2 ID " << get_id() << " consist of " << getNTowers() << " towers with total energy of " << get_energy() << " GeV ";
+  os << "@ (r,phi,z) = (" << get_r() << ", " << get_phi() << ", " << get_z() << "), (x,y,z) = (" << get_x() << ", " << get_y() << ", " << get_z() << ")";
+
+  for (int slot = 0; slot < nprop_slots; ++slot)
+  {
+    if (!(_prop_set & (1U << slot)))
+    {
+      continue;
+    }
+    PROPERTY prop_id = get_slot_property(slot);
+    std::pair<const std::string, PROPERTY_TYPE> property_info = get_property_info(prop_id);
+    os << "\t" << prop_id << ":\t" << property_info.first << " = \t";
+    switch (property_info.second)
+    {
+    case type_int:
+      os << get_property_int(prop_id);
+      break;
+    case type_uint:
+      os << get_property_uint(prop_id);
+      break;
+    case type_float:
+      os << get_property_float(prop_id);
+      break;
+    default:
+      os << " unknown type ";
+      break;
+    }
+    os << std::endl;
+  }
+}
+
+int RawClusterv2::check_property_slot(const PROPERTY prop_id, const PROPERTY_TYPE prop_type) const
+{
+  const int slot = get_property_slot(prop_id);
+  if (slot < 0)
+  {
+    std::pair<const std::string, PROPERTY_TYPE> property_info = get_property_info(prop_id);
+    std::cout << PHWHERE << " Property " << property_info.first << " with id "
+              << prop_id << " has no slot in RawClusterv2" << std::endl;
+    exit(1);
+  }
+  if (slot_types()[slot] != prop_type)
+  {
+    std::pair<const std::string, PROPERTY_TYPE> property_info = get_property_info(prop_id);
+    std::cout << PHWHERE << " Property " << property_info.first << " with id "
+              << prop_id << " is of type " << get_property_type(property_info.second)
+              << " not " << get_property_type(prop_type) << std::endl;
+    exit(1);
+  }
+  return slot;
+}
+
+bool RawClusterv2::has_property(const PROPERTY prop_id) const
+{
+  const int slot = get_property_slot(prop_id);
+  return slot >= 0 && (_prop_set & (1U << slot));
+}
+
+float RawClusterv2::get_property_float(const PROPERTY prop_id) const
+{
+  const int slot = check_property_slot(prop_id, type_float);
+  if (_prop_set & (1U << slot))
+  {
+    u_property u{};
+    u.uidata = _props[slot];
+    return u.fdata;
+  }
+  return std::numeric_limits<float>::quiet_NaN();
+}
+
+int RawClusterv2::get_property_int(const PROPERTY prop_id) const
+{
+  const int slot = check_property_slot(prop_id, type_int);
+  if (_prop_set & (1U << slot))
+  {
+    u_property u{};
+    u.uidata = _props[slot];
+    return u.idata;
+  }
+  return std::numeric_limits<int>::min();
+}
+
+unsigned int RawClusterv2::get_property_uint(const PROPERTY prop_id) const
+{
+  const int slot = check_property_slot(prop_id, type_uint);
+  if (_prop_set & (1U << slot))
+  {
+    return _props[slot];
+  }
+  return std::numeric_limits<unsigned int>::max();
+}
+
+void RawClusterv2::set_property(const PROPERTY prop_id, const float value)
+{
+  const int slot = check_property_slot(prop_id, type_float);
+  u_property u{};
+  u.fdata = value;
+  set_property_nocheck(slot, u.uidata);
+}
+
+void RawClusterv2::set_property(const PROPERTY prop_id, const int value)
+{
+  const int slot = check_property_slot(prop_id, type_int);
+  u_property u{};
+  u.idata = value;
+  set_property_nocheck(slot, u.uidata);
+}
+
+void RawClusterv2::set_property(const PROPERTY prop_id, const unsigned int value)
+{
+  const int slot = check_property_slot(prop_id, type_uint);
+  set_property_nocheck(slot, value);
+}
+
+void RawClusterv2::set_et_iso(const float et_iso, const int radiusx10, bool subtracted, bool clusterTower = true)
+{
+  if (clusterTower)
+  {
+    if (subtracted)
+    {
+      switch (radiusx10)
+      {
+      case 1:
+        set_property(prop_et_iso_calotower_sub_R01, et_iso);
+        break;
+      case 2:
+        set_property(prop_et_iso_calotower_sub_R02, et_iso);
+        break;
+      case 3:
+        set_property(prop_et_iso_calotower_sub_R03, et_iso);
+        break;
+      case 4:
+        set_property(prop_et_iso_calotower_sub_R04, et_iso);
+        break;
+      default:
+        std::string warning = "set_et_iso(const int radiusx10, bool subtracted, bool clusterTower) - radius:" + std::to_string(radiusx10) + " has not been defined";
+        PHOOL_VIRTUAL_WARN(warning.c_str());
+        break;
+      }
+    }
+    else
+    {
+      switch (radiusx10)
+      {
+      case 1:
+        set_property(prop_et_iso_calotower_R01, et_iso);
+        break;
+      case 2:
+        set_property(prop_et_iso_calotower_R02, et_iso);
+        break;
+      case 3:
+        set_property(prop_et_iso_calotower_R03, et_iso);
+        break;
+      case 4:
+        set_property(prop_et_iso_calotower_R04, et_iso);
+        break;
+      default:
+        std::string warning = "set_et_iso(const int radiusx10, bool subtracted, bool clusterTower) - radius:" + std::to_string(radiusx10) + " has not been defined";
+        PHOOL_VIRTUAL_WARN(warning.c_str());
+        break;
+      }
+    }
+  }
+  else
+  {
+    PHOOL_VIRTUAL_WARN("set_et_iso(const int radiusx10, bool subtracted, bool clusterTower) - nonclusterTower algorithms have not been defined");
+  }
+}
+
+float RawClusterv2::get_et_iso(const int radiusx10 = 3, bool subtracted = false, bool clusterTower = true) const
+{
+  float r;
+  if (clusterTower)
+  {
+    if (subtracted)
+    {
+      switch (radiusx10)
+      {
+      case 1:
+        r = get_property_float(prop_et_iso_calotower_sub_R01);
+        break;
+      case 2:
+        r = get_property_float(prop_et_iso_calotower_sub_R02);
+        break;
+      case 3:
+        r = get_property_float(prop_et_iso_calotower_sub_R03);
+        break;
+      case 4:
+        r = get_property_float(prop_et_iso_calotower_sub_R04);
+        break;
+      default:
+        std::string warning = "get_et_iso(const int radiusx10, bool subtracted, bool clusterTower) - radius:" + std::to_string(radiusx10) + " has not been defined";
+        PHOOL_VIRTUAL_WARN(warning.c_str());
+        r = std::numeric_limits<float>::quiet_NaN();
+        break;
+      }
+    }
+    else
+    {
+      switch (radiusx10)
+      {
+      case 1:
+        r = get_property_float(prop_et_iso_calotower_R01);
+        break;
+      case 2:
+        r = get_property_float(prop_et_iso_calotower_R02);
+        break;
+      case 3:
+        r = get_property_float(prop_et_iso_calotower_R03);
+        break;
+      case 4:
+        r = get_property_float(prop_et_iso_calotower_R04);
+        break;
+      default:
+        std::string warning = "get_et_iso(const int radiusx10, bool subtracted, bool clusterTower) - radius:" + std::to_string(radiusx10) + " has not been defined";
+        PHOOL_VIRTUAL_WARN(warning.c_str());
+        r = std::numeric_limits<float>::quiet_NaN();
+        break;
+      }
+    }
+  }
+  else
+  {
+    PHOOL_VIRTUAL_WARN("get_et_iso(const int radiusx10, bool subtracted, bool clusterTower) - nonclusterTower algorithms have not been defined");
+    r = std::numeric_limits<float>::quiet_NaN();
+  }
+  return r;
+}
+
+std::vector<float> RawClusterv2::get_shower_shapes(float tower_thresh) const
+{
+  // same as RawClusterv1, looping over the tower arrays
+  const auto keys = get_tower_keys();
+  const auto energies = get_tower_energies();
+
+  RawTowerDefs::keytype maxtowerkey = 0;
+  float maxtowerE = 0;
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    if (energies[i] > maxtowerE)
+    {
+      maxtowerE = energies[i];
+      maxtowerkey = keys[i];
+    }
+  }
+
+  // check if there are no towers
+  if (keys.empty() || maxtowerE == 0)
+  {
+    std::vector<float> v;
+    return v;
+  }
+  int maxtowerieta = RawTowerDefs::decode_index1(maxtowerkey);
+  int maxtoweriphi = RawTowerDefs::decode_index2(maxtowerkey);
+  // energy weighted avg eta and phi
+  float deta1 = 0;
+  float dphi1 = 0;
+  // energy weighted second moment in eta and phi
+  float deta2 = 0;
+  float dphi2 = 0;
+
+  float totalE = 0;
+
+  // I will hard code the EMCal dim here for now hoping no one will read this :)
+  int totalphibins = 256;
+  auto dphiwrap = [totalphibins](float towerphi, float maxiphi)
+  {
+    float idphi = towerphi - maxiphi;
+    float idphiwrap = totalphibins - std::abs(idphi);
+    if (std::abs(idphiwrap) < std::abs(idphi))
+    {
+      return (idphi > 0) ? -idphiwrap : idphiwrap;
+    }
+    return idphi;
+  };
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    RawTowerDefs::keytype towerkey = keys[i];
+    float E = energies[i];
+    float eta = RawTowerDefs::decode_index1(towerkey);
+    float phi = RawTowerDefs::decode_index2(towerkey);
+    float deta = eta - maxtowerieta;
+
+    float dphi = dphiwrap(phi, maxtoweriphi);
+    if (E > tower_thresh)
+    {
+      totalE += E;
+      deta1 += E * deta;
+      dphi1 += E * dphi;
+      deta2 += E * deta * deta;
+      dphi2 += E * dphi * dphi;
+    }
+  }
+  deta1 /= totalE;
+  dphi1 /= totalE;
+  deta2 = deta2 / totalE - (deta1 * deta1);
+  dphi2 = dphi2 / totalE - (dphi1 * dphi1);
+  // find the index of the center 4 towers
+  int centertowerieta = std::floor(deta1 + 0.5);
+  int centertoweriphi = std::floor(dphi1 + 0.5);
+  int etashift = (deta1 - centertowerieta) < 0 ? -1 : 1;
+  int phishift = (dphi1 - centertoweriphi) < 0 ? -1 : 1;
+
+  auto wraptowerphi = [totalphibins](int phi) -> int
+  {
+    if (phi < 0)
+    {
+      return phi + totalphibins;
+    }
+    if (phi >= totalphibins)
+    {
+      return phi - totalphibins;
+    }
+    return phi;
+  };
+
+  int eta1 = centertowerieta + maxtowerieta;
+  int eta2 = centertowerieta + etashift + maxtowerieta;
+  int phi1 = wraptowerphi(centertoweriphi + maxtoweriphi);
+  int phi2 = wraptowerphi(centertoweriphi + phishift + maxtoweriphi);
+
+  // towers are sorted by key
+  auto gettowerenergy = [totalphibins, tower_thresh, &keys, &energies](int ieta, int phi) -> float
+  {
+    if (phi < 0)
+    {
+      return phi + totalphibins;
+    }
+    if (phi >= totalphibins)
+    {
+      return phi - totalphibins;
+    }
+    RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::CEMC, ieta, phi);
+    const auto iter = std::lower_bound(keys.begin(), keys.end(), key);
+    if (iter != keys.end() && *iter == key)
+    {
+      const float E = energies[iter - keys.begin()];
+      if (E > tower_thresh)
+      {
+        return E;
+      }
+    }
+    return 0;
+  };
+
+  float e1 = gettowerenergy(eta1, phi1);
+  float e2 = gettowerenergy(eta1, phi2);
+  float e3 = gettowerenergy(eta2, phi2);
+  float e4 = gettowerenergy(eta2, phi1);
+
+  float e1t = (e1 + e2 + e3 + e4) / totalE;
+  float e2t = (e1 + e2 - e3 - e4) / totalE;
+  float e3t = (e1 - e2 - e3 + e4) / totalE;
+  float e4t = (e3) / totalE;
+
+  std::vector<float> v = {e1t, e2t, e3t, e4t, deta1 + maxtowerieta, dphi1 + maxtoweriphi, deta2, dphi2, e1, e2, e3, e4, totalE};
+  return v;
+}
+
+std::pair<int, int> RawClusterv2::get_lead_tower() const
+{
+  const auto keys = get_tower_keys();
+  const auto energies = get_tower_energies();
+  if (keys.empty())
+  {
+    return {0, 0};  // or some indication of "no tower"
+  }
+
+  int phi_max = 0;
+  int eta_max = 0;
+  float e_max = std::numeric_limits<float>::lowest();
+
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    RawTowerDefs::keytype towerkey = keys[i];
+    float E = energies[i];
+    float eta = RawTowerDefs::decode_index1(towerkey);
+    float phi = RawTowerDefs::decode_index2(towerkey);
+    if (E > e_max)
+    {
+      phi_max = phi;
+      eta_max = eta;
+      e_max = E;
+    }
+  }
+  return {eta_max, phi_max};
+}
@@ -0,0 +1,209 @@
+#ifndef CALOBASE_RAWCLUSTERV2_H
+#define CALOBASE_RAWCLUSTERV2_H
+
+#include "RawCluster.h"
+#include "RawClusterDefs.h"
+#include "RawTowerDefs.h"
+
+#include <CLHEP/Vector/ThreeVector.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+class PHObject;
+class RawClusterContainerv2;
+
+/**
+ * cluster record of a RawClusterContainerv2.
+ * towers are not stored in the cluster but in the tower pool of its container,
+ * as a range of towers sorted by key (the same order as the RawClusterv1 tower map).
+ * The known properties have a fixed slot each, instead of a map.
+ * Clusters are created by the container, a cluster and its copies are only valid
+ * as long as the container is not reset
+ */
+class RawClusterv2 : public RawCluster
+{
+ public:
+  //! number of fixed property slots
+  static constexpr int nprop_slots = 19;
+
+  RawClusterv2() = default;
+  ~RawClusterv2() override = default;
+
+  void Reset() override;
+  PHObject* CloneMe() const override { return new RawClusterv2(*this); }
+  int isValid() const override { return _ntowers > 0; }
+  void identify(std::ostream& os = std::cout) const override;
+
+  /** @defgroup getters
+   *  @{
+   */
+  //! cluster ID
+  RawClusterDefs::keytype get_id() const override { return clusterid; }
+  //! total energy
+  float get_energy() const override { return _energy; }
+  //! Tower operations
+  size_t getNTowers() const override { return _ntowers; }
+  //! tower map, filled from the tower pool on first use
+  RawCluster::TowerConstRange get_towers() const override;
+  const TowerMap& get_towermap() const override;
+  //! towers keys and energies, sorted by key
+  std::span<const RawTowerDefs::keytype> get_tower_keys() const;
+  std::span<const float> get_tower_energies() const;
+  //
+  //! cluster position in 3D
+  CLHEP::Hep3Vector get_position() const override
+  {
+    return CLHEP::Hep3Vector(get_x(), get_y(), get_z());
+  }
+  //!  access to intrinsic cylindrical coordinate system
+  float get_phi() const override { return _phi; }
+  float get_r() const override { return _r; }
+  float get_z() const override { return _z; }
+  //
+  //! access Cartesian coordinate system
+  float get_x() const override { return get_r() * std::cos(get_phi()); }
+  float get_y() const override { return get_r() * std::sin(get_phi()); }
+  //
+  //! access additional optional properties
+  //! cluster core energy for EM shower
+  float get_ecore() const override { return get_property_float(prop_ecore); }
+  //! reduced chi2 for EM shower
+  float get_chi2() const override { return get_property_float(prop_chi2); }
+  //! cluster template probability for EM shower
+  float get_prob() const override { return get_property_float(prop_prob); }
+  //! cluster template merged pi0 cluster probability for EM shower
+  float get_merged_cluster_prob() const override { return get_property_float(prop_merged_cluster_prob); }
+  //! isolation ET default
+  float get_et_iso() const override { return get_property_float(prop_et_iso_calotower_R03); }
+  //! isolation ET the radius and hueristic can be specified
+  float get_et_iso(const int radiusx10, bool subtracted, bool clusterTower) const override;
+
+  //! tower-space CoG in tower units
+  float x_tower_raw() const override { return get_property_float(prop_tower_x_raw); }
+  float y_tower_raw() const override { return get_property_float(prop_tower_y_raw); }
+  float x_tower_corr() const override { return get_property_float(prop_tower_x_corr); }
+  float y_tower_corr() const override { return get_property_float(prop_tower_y_corr); }
+
+  //! energy-weighted mean time
+  float mean_time() const override { return get_property_float(prop_tower_t_mean); }
+
+  //! optional convenience accessors for mechanical incidence (return NaN if unset)
+  float alpha_mech_phi() const { return get_property_float(prop_incidence_alpha_phi); }
+  float alpha_mech_eta() const { return get_property_float(prop_incidence_alpha_eta); }
+
+  std::vector<float> get_shower_shapes(float tower_thresh) const override;
+  std::pair<int, int> get_lead_tower() const override;  // eta,phi of leading tower in cluster
+  /** @} */  // end of getters
+
+  /** @defgroup setters
+   *  @{
+   */
+  //! cluster ID
+  void set_id(const RawClusterDefs::keytype id) override { clusterid = id; }
+  //! Tower operations, towers can only be added to the last cluster of the container
+  void addTower(const RawClusterDefs::keytype twrid, const float etower) override;
+  //! total energy
+  void set_energy(const float energy) override { _energy = energy; }
+  //!  access to intrinsic cylindrical coordinate system
+  void set_phi(const float phi) override { _phi = phi; }
+  void set_z(const float z) override { _z = z; }
+  void set_r(const float r) override { _r = r; }
+  //
+  //! access additional optional properties
+  //! cluster core energy for EM shower
+  void set_ecore(const float ecore) override { set_property(prop_ecore, ecore); }
+  //! reduced chi2 for EM shower
+  void set_chi2(const float chi2) override { set_property(prop_chi2, chi2); }
+  //! cluster template probability for EM shower
+  void set_prob(const float prob) override { set_property(prop_prob, prob); }
+  //! cluster template merged pi0 cluster probability for EM shower
+  void set_merged_cluster_prob(const float probmergedcluster) override { set_property(prop_merged_cluster_prob, probmergedcluster); }
+  //! isolation ET default
+  void set_et_iso(const float e) override { set_property(prop_et_iso_calotower_R03, e); }
+  //! isolation ET the radius and hueristic can be specified
+  void set_et_iso(const float et_iso, const int radiusx10, bool subtracted, bool clusterTower) override;
+
+  //! tower-space CoG in tower units
+  void set_tower_cog(float xr, float yr, float xc, float yc) override
+  {
+    set_property(prop_tower_x_raw, xr);
+    set_property(prop_tower_y_raw, yr);
+    set_property(prop_tower_x_corr, xc);
+    set_property(prop_tower_y_corr, yc);
+  }
+
+  //! energy-weighted mean time
+  void set_mean_time(float t) override
+  {
+    set_property(prop_tower_t_mean, t);
+  }
+  /** @} */  // end of setters
+
+  /** @defgroup property_map property slot definitions
+   *  @{
+   */
+ public:
+  bool has_property(const PROPERTY prop_id) const override;
+  float get_property_float(const PROPERTY prop_id) const override;
+  int get_property_int(const PROPERTY prop_id) const override;
+  unsigned int get_property_uint(const PROPERTY prop_id) const override;
+  void set_property(const PROPERTY prop_id, const float value) override;
+  void set_property(const PROPERTY prop_id, const int value) override;
+  void set_property(const PROPERTY prop_id, const unsigned int value) override;
+
+  //! slot of a property, -1 if the property has no slot
+  static int get_property_slot(const PROPERTY prop_id);
+  //! property stored in a slot
+  static PROPERTY get_slot_property(const int slot);
+
+ protected:
+  //! storage of a property of the given type, exits if the type or the slot is wrong
+  int check_property_slot(const PROPERTY prop_id, const PROPERTY_TYPE prop_type) const;
+  void set_property_nocheck(const int slot, const uint32_t value)
+  {
+    _props[slot] = value;
+    _prop_set |= (1U << slot);
+  }
+
+  /** @} */  // end of property slot definitions
+
+ private:
+  friend class RawClusterContainerv2;
+
+  //! cluster ID
+  RawClusterDefs::keytype clusterid{0};
+  //! total energy
+  float _energy{std::numeric_limits<float>::quiet_NaN()};
+
+  //! location of cluster in cylindrical coordinate
+  float _r{std::numeric_limits<float>::quiet_NaN()};
+  float _phi{std::numeric_limits<float>::quiet_NaN()};
+  float _z{std::numeric_limits<float>::quiet_NaN()};
+
+  //! towers of the cluster in the tower pool of the container
+  unsigned int _tower_begin{0};
+  unsigned int _ntowers{0};
+
+  //! one bit per property slot which has been set
+  uint32_t _prop_set{0};
+  //! property values, as 32 bit words
+  uint32_t _props[nprop_slots]{};
+
+  //! container holding the towers, set by the container on access
+  mutable RawClusterContainerv2* _container{nullptr};  //!
+
+  //! tower map for the RawCluster interface, filled on demand
+  mutable TowerMap _towermap;  //!
+  mutable bool _towermap_filled{false};  //!
+
+  ClassDefOverride(RawClusterv2, 1)
+};
+
+#endif
@@ -4,8 +4,10 @@
 #include <phool/PHObject.h>
 
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <map>
+#include <span>
 
 class TowerInfo;
 
@@ -56,6 +58,14 @@ class TowerInfoContainer : public PHObject
   virtual DETECTOR get_detectorid() const { return DETECTOR_INVALID; }
   virtual int get_channels(DETECTOR detec);
 
+  // bulk access to the towers, indexed by channel, for versions storing one array per quantity (v6).
+  // The spans are empty for the other versions, which have to be accessed tower by tower
+  virtual std::span<float> get_energy_array() { return {}; }
+  virtual std::span<short> get_time_array() { return {}; }  // in units of 1/1000 sample
+  virtual std::span<float> get_chi2_array() { return {}; }
+  virtual std::span<float> get_pedestal_array() { return {}; }
+  virtual std::span<uint8_t> get_status_array() { return {}; }
+
  private:
   ClassDefOverride(TowerInfoContainer, 0);
 };
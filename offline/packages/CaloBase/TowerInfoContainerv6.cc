@@ -0,0 +1,73 @@
+#include "TowerInfoContainerv6.h"
+#include "TowerInfov6.h"
+
+#include <algorithm>
+
+TowerInfoContainerv6::TowerInfoContainerv6(DETECTOR detec)
+  : _detector(detec)
+{
+  // tower numbers are fixed, the arrays are allocated once per run
+  size_t nchannels = get_channels(detec);
+  _energy.resize(nchannels, 0);
+  _time.resize(nchannels, 0);
+  _chi2.resize(nchannels, 0);
+  _pedestal.resize(nchannels, 0);
+  _status.resize(nchannels, 0);
+}
+
+TowerInfoContainerv6::TowerInfoContainerv6(const TowerInfoContainerv6& source)
+  : TowerInfoContainer(source)
+  , _detector(source.get_detectorid())
+  , _energy(source._energy)
+  , _time(source._time)
+  , _chi2(source._chi2)
+  , _pedestal(source._pedestal)
+  , _status(source._status)
+{
+  // the views of the source point to the source, they are made again on first access
+}
+
+void TowerInfoContainerv6::identify(std::ostream& os) const
+{
+  os << "TowerInfoContainerv6 of size " << size() << std::endl;
+}
+
+void TowerInfoContainerv6::Reset()
+{
+  // clear content of towers in the container for the next event
+  std::fill(_energy.begin(), _energy.end(), 0);
+  std::fill(_time.begin(), _time.end(), 0);
+  std::fill(_chi2.begin(), _chi2.end(), 0);
+  std::fill(_pedestal.begin(), _pedestal.end(), 0);
+  std::fill(_status.begin(), _status.end(), 0);
+}
+
+void TowerInfoContainerv6::make_views()
+{
+  if (_towers.size() == size())
+  {
+    return;
+  }
+  _towers.clear();
+  _towers.reserve(size());
+  for (size_t i = 0; i < size(); ++i)
+  {
+    _towers.emplace_back(this, i);
+  }
+}
+
+TowerInfov6* TowerInfoContainerv6::get_tower_at_channel(int pos)
+{
+  if (pos < 0 || pos >= (int) size())
+  {
+    return nullptr;
+  }
+  make_views();
+  return &_towers[pos];
+}
+
+TowerInfov6* TowerInfoContainerv6::get_tower_at_key(int pos)
+{
+  int index = decode_key(pos);
+  return get_tower_at_channel(index);
+}
@@ -0,0 +1,72 @@
+#ifndef TOWERINFOCONTAINERV6_H
+#define TOWERINFOCONTAINERV6_H
+
+#include "TowerInfoContainer.h"
+#include "TowerInfov6.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <vector>
+
+class PHObject;
+
+// content of TowerInfoContainerv2 (towers of TowerInfov2) stored as one array per
+// quantity instead of one object per tower. The towers returned by get_tower_at_channel()
+// and get_tower_at_key() are views on the arrays, the arrays can be accessed directly
+// with the bulk accessors
+class TowerInfoContainerv6 : public TowerInfoContainer
+{
+ public:
+  TowerInfoContainerv6(DETECTOR detec);
+
+  // default constructor for ROOT IO
+  TowerInfoContainerv6() = default;
+  PHObject *CloneMe() const override { return new TowerInfoContainerv6(*this); }
+  TowerInfoContainerv6(const TowerInfoContainerv6 &);
+  TowerInfoContainerv6 &operator=(const TowerInfoContainerv6 &) = delete;
+
+  ~TowerInfoContainerv6() override = default;
+
+  void identify(std::ostream &os = std::cout) const override;
+
+  void Reset() override;
+  TowerInfov6 *get_tower_at_channel(int pos) override;
+  TowerInfov6 *get_tower_at_key(int pos) override;
+
+  size_t size() const override { return _energy.size(); }
+  DETECTOR get_detectorid() const override { return _detector; }
+
+  std::span<float> get_energy_array() override { return _energy; }
+  std::span<short> get_time_array() override { return _time; }
+  std::span<float> get_chi2_array() override { return _chi2; }
+  std::span<float> get_pedestal_array() override { return _pedestal; }
+  std::span<uint8_t> get_status_array() override { return _status; }
+
+  std::span<const float> get_energy_array() const { return _energy; }
+  std::span<const short> get_time_array() const { return _time; }
+  std::span<const float> get_chi2_array() const { return _chi2; }
+  std::span<const float> get_pedestal_array() const { return _pedestal; }
+  std::span<const uint8_t> get_status_array() const { return _status; }
+
+ private:
+  friend class TowerInfov6;
+
+  // (re)create the views if the arrays changed size (first access, reading from file)
+  void make_views();
+
+  DETECTOR _detector{DETECTOR_INVALID};
+
+  std::vector<float> _energy;
+  std::vector<short> _time;  // in units of 1/1000 sample, see TowerInfov6::encode_time()
+  std::vector<float> _chi2;
+  std::vector<float> _pedestal;
+  std::vector<uint8_t> _status;
+
+  std::vector<TowerInfov6> _towers;  //!
+
+  ClassDefOverride(TowerInfoContainerv6, 1);
+};
+
+#endif
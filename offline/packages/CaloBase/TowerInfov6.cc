@@ -0,0 +1,98 @@
+#include "TowerInfov6.h"
+#include "TowerInfoContainerv6.h"
+
+void TowerInfov6::Reset()
+{
+  _container->_energy[_channel] = 0;
+  _container->_time[_channel] = 0;
+  _container->_chi2[_channel] = 0;
+  _container->_pedestal[_channel] = 0;
+  _container->_status[_channel] = 0;
+}
+
+void TowerInfov6::set_time(float t)
+{
+  _container->_time[_channel] = encode_time(t);
+}
+
+float TowerInfov6::get_time()
+{
+  return decode_time(_container->_time[_channel]);
+}
+
+void TowerInfov6::set_time_short(short t)
+{
+  _container->_time[_channel] = t * 1000;
+}
+
+short TowerInfov6::get_time_short()
+{
+  return short(_container->_time[_channel] / 1000);
+}
+
+void TowerInfov6::set_energy(float energy)
+{
+  _container->_energy[_channel] = energy;
+}
+
+float TowerInfov6::get_energy()
+{
+  return _container->_energy[_channel];
+}
+
+void TowerInfov6::set_chi2(float chi2)
+{
+  _container->_chi2[_channel] = chi2;
+}
+
+float TowerInfov6::get_chi2()
+{
+  return _container->_chi2[_channel];
+}
+
+void TowerInfov6::set_pedestal(float pedestal)
+{
+  _container->_pedestal[_channel] = pedestal;
+}
+
+float TowerInfov6::get_pedestal()
+{
+  return _container->_pedestal[_channel];
+}
+
+uint8_t TowerInfov6::get_status() const
+{
+  return _container->_status[_channel];
+}
+
+void TowerInfov6::set_status(uint8_t status)
+{
+  _container->_status[_channel] = status;
+}
+
+void TowerInfov6::set_status_bit(StatusBit bit, bool value)
+{
+  uint8_t &status = _container->_status[_channel];
+  status &= ~status_mask(bit);
+  status |= (uint8_t) value << bit;
+}
+
+void TowerInfov6::copy_tower(TowerInfo *tower)
+{
+  // towers of the same version are copied without converting the time
+  if (auto *source = dynamic_cast<TowerInfov6 *>(tower))
+  {
+    _container->_energy[_channel] = source->_container->_energy[source->_channel];
+    _container->_time[_channel] = source->_container->_time[source->_channel];
+    _container->_chi2[_channel] = source->_container->_chi2[source->_channel];
+    _container->_pedestal[_channel] = source->_container->_pedestal[source->_channel];
+    _container->_status[_channel] = source->_container->_status[source->_channel];
+    return;
+  }
+
+  set_time(tower->get_time());
+  set_energy(tower->get_energy());
+  set_chi2(tower->get_chi2());
+  set_pedestal(tower->get_pedestal());
+  set_status(tower->get_status());
+}
@@ -0,0 +1,100 @@
+#ifndef TOWERINFOV6_H
+#define TOWERINFOV6_H
+
+#include "TowerInfo.h"
+
+#include <cstdint>
+
+class TowerInfoContainerv6;
+
+// tower of a TowerInfoContainerv6: a view on one channel of the arrays of the container.
+// The views are created by the container and are only valid as long as it exists.
+// The content is the one of TowerInfov2
+class TowerInfov6 : public TowerInfo
+{
+ public:
+  // status bits, the same as in TowerInfov2 to v5
+  enum StatusBit
+  {
+    kHot = 0,
+    kFitStatus = 1,
+    kBadChi2 = 2,
+    kNotInstr = 3,
+    kNoCalib = 4,
+    kZS = 5,
+    kRecovered = 6,
+    kSaturated = 7
+  };
+  static constexpr uint8_t status_mask(StatusBit bit) { return (uint8_t) 1 << bit; }
+
+  // towers which are not good (see get_isGood())
+  static constexpr uint8_t bad_status_mask = (1U << kHot) | (1U << kBadChi2) | (1U << kNoCalib) | (1U << kNotInstr);
+
+  // the time is stored as a short in units of 1/1000 sample
+  static short encode_time(float t) { return t * 1000; }
+  static float decode_time(short t) { return t / 1000.; }
+
+  TowerInfov6() = default;
+  TowerInfov6(TowerInfoContainerv6 *container, int channel)
+    : _container(container)
+    , _channel(channel)
+  {
+  }
+
+  ~TowerInfov6() override = default;
+
+  void Reset() override;
+
+  void set_time(float t) override;
+  float get_time() override;
+  void set_time_short(short t) override;
+  short get_time_short() override;
+  void set_energy(float energy) override;
+  float get_energy() override;
+  void set_chi2(float chi2) override;
+  float get_chi2() override;
+  void set_pedestal(float pedestal) override;
+  float get_pedestal() override;
+
+  void set_isHot(bool isHot) override { set_status_bit(kHot, isHot); }
+  bool get_isHot() const override { return get_status_bit(kHot); }
+
+  void set_FitStatus(bool fitstatus) override { set_status_bit(kFitStatus, fitstatus); }
+  bool get_FitStatus() const override { return get_status_bit(kFitStatus); }
+
+  void set_isBadChi2(bool isBadChi2) override { set_status_bit(kBadChi2, isBadChi2); }
+  bool get_isBadChi2() const override { return get_status_bit(kBadChi2); }
+
+  void set_isNotInstr(bool isNotInstr) override { set_status_bit(kNotInstr, isNotInstr); }
+  bool get_isNotInstr() const override { return get_status_bit(kNotInstr); }
+
+  void set_isNoCalib(bool isNoCalib) override { set_status_bit(kNoCalib, isNoCalib); }
+  bool get_isNoCalib() const override { return get_status_bit(kNoCalib); }
+
+  void set_isZS(bool isZS) override { set_status_bit(kZS, isZS); }
+  bool get_isZS() const override { return get_status_bit(kZS); }
+
+  void set_isRecovered(bool isRecovered) override { set_status_bit(kRecovered, isRecovered); }
+  bool get_isRecovered() const override { return get_status_bit(kRecovered); }
+
+  void set_isSaturated(bool isSaturated) override { set_status_bit(kSaturated, isSaturated); }
+  bool get_isSaturated() const override { return get_status_bit(kSaturated); }
+
+  bool get_isGood() const override { return (get_status() & bad_status_mask) == 0; }
+
+  uint8_t get_status() const override;
+  void set_status(uint8_t status) override;
+
+  void copy_tower(TowerInfo *tower) override;
+
+ private:
+  void set_status_bit(StatusBit bit, bool value);
+  bool get_status_bit(StatusBit bit) const { return (get_status() & status_mask(bit)) != 0; }
+
+  TowerInfoContainerv6 *_container{nullptr};  //!
+  int _channel{0};                             //!
+
+  ClassDefOverride(TowerInfov6, 1);
+};
+
+#endif
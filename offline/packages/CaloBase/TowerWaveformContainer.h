@@ -0,0 +1,41 @@
+#ifndef TOWERWAVEFORMCONTAINER_H
+#define TOWERWAVEFORMCONTAINER_H
+
+#include <phool/PHObject.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <vector>
+
+// waveforms of all channels of a calorimeter, stored next to a TowerInfoContainer
+// without waveforms instead of in every tower (TowerInfov3/v4/v5).
+// Waveforms are added channel by channel in channel order
+class TowerWaveformContainer : public PHObject
+{
+ public:
+  TowerWaveformContainer() = default;
+  ~TowerWaveformContainer() override = default;
+  void identify(std::ostream& os = std::cout) const override { os << "TowerWaveformContainer base class" << std::endl; }
+
+  void Reset() override {}
+
+  // number of channels
+  virtual size_t size() const { return 0; }
+
+  // add the waveform of the next channel
+  virtual void add_waveform(std::span<const int16_t> /*waveform*/) { return; }
+  // samples are converted to int16_t as by TowerInfo::set_waveform_value()
+  virtual void add_waveform(std::span<const float> /*waveform*/) { return; }
+
+  virtual int get_nsample(int /*channel*/) const { return 0; }
+  virtual int16_t get_waveform_value(int /*channel*/, int /*index*/) const { return -1; }
+  // all samples of a channel
+  virtual void get_waveform(int /*channel*/, std::vector<int16_t>& waveform) const { waveform.clear(); }
+
+ private:
+  ClassDefOverride(TowerWaveformContainer, 1);
+};
+
+#endif
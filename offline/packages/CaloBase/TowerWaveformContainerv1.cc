@@ -0,0 +1,196 @@
+#include "TowerWaveformContainerv1.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace
+{
+  uint32_t zigzag_encode(int32_t value)
+  {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+  }
+
+  int32_t zigzag_decode(uint32_t value)
+  {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+  }
+}  // namespace
+
+void TowerWaveformContainerv1::identify(std::ostream& os) const
+{
+  os << "TowerWaveformContainerv1 with " << size() << " channels, "
+     << (get_encoding() == kDelta ? "delta" : "packed") << " encoding, "
+     << packed_size() << " bytes" << std::endl;
+}
+
+void TowerWaveformContainerv1::Reset()
+{
+  _nsamples.clear();
+  _bits.clear();
+  _base.clear();
+  _offset.clear();
+  _data.clear();
+  _nbits = 0;
+}
+
+bool TowerWaveformContainerv1::set_encoding(Encoding encoding)
+{
+  if (!_offset.empty() && encoding != _encoding)
+  {
+    std::cout << "TowerWaveformContainerv1::set_encoding: cannot change the encoding of "
+              << size() << " stored channels, call Reset() first" << std::endl;
+    return false;
+  }
+  _encoding = encoding;
+  return true;
+}
+
+void TowerWaveformContainerv1::add_waveform(std::span<const int16_t> waveform)
+{
+  _nsamples.push_back(waveform.size());
+  _offset.push_back(_nbits);
+  if (waveform.empty())
+  {
+    _bits.push_back(0);
+    _base.push_back(0);
+    return;
+  }
+
+  if (get_encoding() == kDelta)
+  {
+    uint32_t max_value = 0;
+    for (size_t i = 1; i < waveform.size(); ++i)
+    {
+      max_value = std::max(max_value, zigzag_encode(waveform[i] - waveform[i - 1]));
+    }
+    int nbits = std::bit_width(max_value);
+    _bits.push_back(nbits);
+    _base.push_back(waveform[0]);
+    reserve_bits((uint64_t) nbits * (waveform.size() - 1));
+    for (size_t i = 1; i < waveform.size(); ++i)
+    {
+      write_bits(zigzag_encode(waveform[i] - waveform[i - 1]), nbits);
+    }
+    return;
+  }
+
+  const auto [min_value, max_value] = std::minmax_element(waveform.begin(), waveform.end());
+  int nbits = std::bit_width(static_cast<uint32_t>(*max_value - *min_value));
+  _bits.push_back(nbits);
+  _base.push_back(*min_value);
+  reserve_bits((uint64_t) nbits * waveform.size());
+  for (int16_t sample : waveform)
+  {
+    write_bits(sample - *min_value, nbits);
+  }
+}
+
+void TowerWaveformContainerv1::add_waveform(std::span<const float> waveform)
+{
+  _samples.assign(waveform.begin(), waveform.end());
+  add_waveform(std::span<const int16_t>(_samples));
+}
+
+int TowerWaveformContainerv1::get_nsample(int channel) const
+{
+  if (channel < 0 || channel >= (int) size())
+  {
+    return 0;
+  }
+  return _nsamples[channel];
+}
+
+int16_t TowerWaveformContainerv1::get_waveform_value(int channel, int index) const
+{
+  if (index < 0 || index >= get_nsample(channel))
+  {
+    return 0;
+  }
+  const int nbits = _bits[channel];
+  const uint64_t offset = _offset[channel];
+  if (get_encoding() == kDelta)
+  {
+    int32_t value = _base[channel];
+    for (int i = 0; i < index; ++i)
+    {
+      value += zigzag_decode(read_bits(offset + (uint64_t) i * nbits, nbits));
+    }
+    return value;
+  }
+  return _base[channel] + read_bits(offset + (uint64_t) index * nbits, nbits);
+}
+
+void TowerWaveformContainerv1::get_waveform(int channel, std::vector<int16_t>& waveform) const
+{
+  const int nsamples = get_nsample(channel);
+  waveform.resize(nsamples);
+  if (nsamples == 0)
+  {
+    return;
+  }
+  const int nbits = _bits[channel];
+  uint64_t position = _offset[channel];
+  if (get_encoding() == kDelta)
+  {
+    int32_t value = _base[channel];
+    waveform[0] = value;
+    for (int i = 1; i < nsamples; ++i, position += nbits)
+    {
+      value += zigzag_decode(read_bits(position, nbits));
+      waveform[i] = value;
+    }
+    return;
+  }
+  for (int i = 0; i < nsamples; ++i, position += nbits)
+  {
+    waveform[i] = _base[channel] + read_bits(position, nbits);
+  }
+}
+
+size_t TowerWaveformContainerv1::packed_size() const
+{
+  return sizeof(_encoding) +
+         _nsamples.size() * sizeof(uint16_t) +
+         _bits.size() * sizeof(uint8_t) +
+         _base.size() * sizeof(int16_t) +
+         _offset.size() * sizeof(uint32_t) +
+         _data.size() * sizeof(uint32_t);
+}
+
+void TowerWaveformContainerv1::reserve_bits(uint64_t nbits)
+{
+  _data.resize((_nbits + nbits + 31) >> 5U, 0);
+}
+
+void TowerWaveformContainerv1::write_bits(uint32_t value, int nbits)
+{
+  if (nbits == 0)
+  {
+    return;
+  }
+  const uint64_t word = _nbits >> 5U;
+  const int shift = _nbits & 31U;
+  _nbits += nbits;
+  const uint64_t bits = static_cast<uint64_t>(value) << shift;
+  _data[word] |= static_cast<uint32_t>(bits);
+  if (shift + nbits > 32)
+  {
+    _data[word + 1] |= static_cast<uint32_t>(bits >> 32U);
+  }
+}
+
+uint32_t TowerWaveformContainerv1::read_bits(uint64_t position, int nbits) const
+{
+  if (nbits == 0)
+  {
+    return 0;
+  }
+  const uint64_t word = position >> 5U;
+  const int shift = position & 31U;
+  uint64_t bits = _data[word];
+  if (shift + nbits > 32)
+  {
+    bits |= static_cast<uint64_t>(_data[word + 1]) << 32U;
+  }
+  return (bits >> shift) & ((1U << nbits) - 1);
+}
@@ -0,0 +1,83 @@
+#ifndef TOWERWAVEFORMCONTAINERV1_H
+#define TOWERWAVEFORMCONTAINERV1_H
+
+#include "TowerWaveformContainer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <vector>
+
+class PHObject;
+
+// waveforms of all channels in one bit packed buffer, decoded on access.
+// Every channel stores its samples relative to a base value with the number of bits
+// needed for this channel (at most 14 for ADC samples):
+//  kPacked: samples minus the minimum of the channel, random access
+//  kDelta: first sample, then the differences between consecutive samples
+//          (zigzag encoded), smaller for flat waveforms, decoded sequentially
+class TowerWaveformContainerv1 : public TowerWaveformContainer
+{
+ public:
+  enum Encoding : uint8_t
+  {
+    kPacked = 0,
+    kDelta = 1
+  };
+
+  TowerWaveformContainerv1() = default;
+  explicit TowerWaveformContainerv1(Encoding encoding)
+    : _encoding(encoding)
+  {
+  }
+  ~TowerWaveformContainerv1() override = default;
+
+  PHObject* CloneMe() const override { return new TowerWaveformContainerv1(*this); }
+  void identify(std::ostream& os = std::cout) const override;
+
+  // remove all channels, keeps the encoding and the allocated memory
+  void Reset() override;
+
+  size_t size() const override { return _offset.size(); }
+
+  void add_waveform(std::span<const int16_t> waveform) override;
+  void add_waveform(std::span<const float> waveform) override;
+
+  int get_nsample(int channel) const override;
+  int16_t get_waveform_value(int channel, int index) const override;
+  void get_waveform(int channel, std::vector<int16_t>& waveform) const override;
+
+  // encoding of all channels, can only be changed while the container is empty
+  // (e.g. after Reset()), returns false otherwise
+  bool set_encoding(Encoding encoding);
+  Encoding get_encoding() const { return static_cast<Encoding>(_encoding); }
+
+  // size of the packed samples and the per channel headers, in bytes
+  size_t packed_size() const;
+
+ private:
+  // make room for nbits more bits, to be called before write_bits()
+  void reserve_bits(uint64_t nbits);
+  void write_bits(uint32_t value, int nbits);
+  uint32_t read_bits(uint64_t position, int nbits) const;
+
+  uint8_t _encoding{kPacked};
+
+  // per channel: number of samples, bits per stored value, base value
+  // and position of the first stored value in _data (in bits)
+  std::vector<uint16_t> _nsamples;
+  std::vector<uint8_t> _bits;
+  std::vector<int16_t> _base;
+  std::vector<uint32_t> _offset;
+
+  // stored values of all channels, least significant bit first
+  std::vector<uint32_t> _data;
+
+  uint64_t _nbits{0};              //! bits used in _data while filling
+  std::vector<int16_t> _samples;  //! conversion of float samples
+
+  ClassDefOverride(TowerWaveformContainerv1, 1);
+};
+
+#endif
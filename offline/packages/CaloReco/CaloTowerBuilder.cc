@@ -1,5 +1,6 @@
 #include "CaloTowerBuilder.h"
 #include "CaloTowerDefs.h"
+#include "CaloWaveformBuffer.h"
 
 #include <calobase/TowerInfo.h>
 #include <calobase/TowerInfoContainer.h>
@@ -9,6 +10,8 @@
 #include <calobase/TowerInfoContainerv2.h>
 #include <calobase/TowerInfoContainerv3.h>
 #include <calobase/TowerInfoContainerv4.h>
+#include <calobase/TowerInfoContainerv6.h>
+#include <calobase/TowerWaveformContainerv1.h>
 
 #include <ffarawobjects/CaloPacket.h>
 #include <ffarawobjects/CaloPacketContainer.h>
@@ -34,6 +37,7 @@
 
 #include <TSystem.h>
 
+#include <algorithm>
 #include <climits>
 #include <iostream>  // for operator<<, endl, basic...
 #include <memory>    // for allocator_traits<>::val...
@@ -46,6 +50,47 @@ static const std::map<CaloTowerDefs::DetectorSystem, std::string> nodemap{
     {CaloTowerDefs::HCALOUT, "HCALPackets"},
     {CaloTowerDefs::ZDC, "ZDCPackets"},
     {CaloTowerDefs::SEPD, "SEPDPackets"}};
+
+namespace
+{
+  // offline packets give direct access to their content,
+  // event library packets only through iValue
+  bool isSuppressed(CaloPacket *packet, int channel)
+  {
+    return packet->getSuppressed(channel);
+  }
+
+  bool isSuppressed(Packet *packet, int channel)
+  {
+    return packet->iValue(channel, "SUPPRESSED");
+  }
+
+  void decodePrePost(CaloPacket *packet, int channel, float *waveform)
+  {
+    waveform[0] = static_cast<int>(packet->getPre(channel));
+    waveform[1] = static_cast<int>(packet->getPost(channel));
+  }
+
+  void decodePrePost(Packet *packet, int channel, float *waveform)
+  {
+    waveform[0] = packet->iValue(channel, "PRE");
+    waveform[1] = packet->iValue(channel, "POST");
+  }
+
+  void decodeWaveform(CaloPacket *packet, int channel, int nsamples, float *waveform)
+  {
+    packet->getWaveform(channel, nsamples, waveform);
+  }
+
+  void decodeWaveform(Packet *packet, int channel, int nsamples, float *waveform)
+  {
+    for (int samp = 0; samp < nsamples; samp++)
+    {
+      waveform[samp] = packet->iValue(samp, channel);
+    }
+  }
+}  // namespace
+
 //____________________________________________________________________________..
 CaloTowerBuilder::CaloTowerBuilder(const std::string &name)
   : SubsysReco(name)
@@ -184,13 +229,11 @@ int CaloTowerBuilder::InitRun(PHCompositeNode *topNode)
 
 int CaloTowerBuilder::process_sim()
 {
-  std::vector<std::vector<float>> waveforms;
+  m_waveforms.clear(std::max({m_nsamples, m_nzerosuppsamples, 2}));
 
   for (int ich = 0; ich < (int) m_CalowaveformContainer->size(); ich++)
   {
     TowerInfo *towerinfo = m_CalowaveformContainer->get_tower_at_channel(ich);
-    std::vector<float> waveform;
-    waveform.reserve(m_nsamples);
     bool fillwaveform = true;
     // get key
     if (m_dotbtszs)
@@ -204,36 +247,38 @@ int CaloTowerBuilder::process_sim()
       {
         // zero suppressed
         fillwaveform = false;
-        waveform.push_back(pre);
-        waveform.push_back(post);
+        float *waveform = m_waveforms.add_channel(2);
+        waveform[0] = pre;
+        waveform[1] = post;
       }
     }
     if (fillwaveform)
     {
+      float *waveform = m_waveforms.add_channel(m_nsamples);
       for (int samp = 0; samp < m_nsamples; samp++)
       {
-        waveform.push_back(towerinfo->get_waveform_value(samp));
+        waveform[samp] = towerinfo->get_waveform_value(samp);
       }
     }
-    waveforms.push_back(waveform);
-    waveform.clear();
   }
 
-  std::vector<std::vector<float>> processed_waveforms = WaveformProcessing->process_waveform(waveforms);
-  int n_channels = processed_waveforms.size();
+  WaveformProcessing->process_waveform(m_waveforms);
+  int n_channels = m_waveforms.size();
   for (int i = 0; i < n_channels; i++)
   {
+    const auto result = m_waveforms.results(i);
+    const auto waveform = m_waveforms.samples(i);
     // this is for copying the truth info to the downstream object
     TowerInfo *towerwaveform = m_CalowaveformContainer->get_tower_at_channel(i);
     TowerInfo *towerinfo = m_CaloInfoContainer->get_tower_at_channel(i);
     towerinfo->copy_tower(towerwaveform);
-    towerinfo->set_time(processed_waveforms.at(i).at(1));
-    towerinfo->set_energy(processed_waveforms.at(i).at(0));
-    towerinfo->set_time(processed_waveforms.at(i).at(1));
-    towerinfo->set_pedestal(processed_waveforms.at(i).at(2));
-    towerinfo->set_chi2(processed_waveforms.at(i).at(3));
-    bool SZS = isSZS(processed_waveforms.at(i).at(1), processed_waveforms.at(i).at(3));
-    if (processed_waveforms.at(i).at(4) == 0)
+    towerinfo->set_time(result[1]);
+    towerinfo->set_energy(result[0]);
+    towerinfo->set_time(result[1]);
+    towerinfo->set_pedestal(result[2]);
+    towerinfo->set_chi2(result[3]);
+    bool SZS = isSZS(result[1], result[3]);
+    if (result[4] == 0)
     {
       towerinfo->set_isRecovered(false);
     }
@@ -241,28 +286,29 @@ int CaloTowerBuilder::process_sim()
     {
       towerinfo->set_isRecovered(true);
     }
-    towerinfo->set_FitStatus(static_cast<bool>(processed_waveforms.at(i).at(5)));
-    int n_samples = waveforms.at(i).size();
+    towerinfo->set_FitStatus(static_cast<bool>(result[5]));
+    int n_samples = waveform.size();
     if (n_samples == m_nzerosuppsamples || SZS)
     {
       towerinfo->set_isZS(true);
     }
     for (int j = 0; j < n_samples; j++)
     {
-      towerinfo->set_waveform_value(j, waveforms.at(i).at(j));
-      if (std::round(waveforms.at(i).at(j)) >= m_saturation)
+      towerinfo->set_waveform_value(j, waveform[j]);
+      if (std::round(waveform[j]) >= m_saturation)
       {
         towerinfo->set_isSaturated(true);
       }
     }
   }
-  waveforms.clear();
+  fill_packed_waveforms();
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
-int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::vector<float>> &waveforms)
+int CaloTowerBuilder::process_data(PHCompositeNode *topNode, CaloWaveformBuffer &waveforms)
 {
+  waveforms.clear(std::max({m_nsamples, m_nzerosuppsamples, 2}));
   std::variant<CaloPacketContainer *, Event *> event;
   if (m_UseOfflinePacketFlag)
   {
@@ -317,13 +363,7 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
           {
             continue;
           }
-          std::vector<float> waveform;
-          waveform.reserve(m_nzerosuppsamples);
-          for (int samp = 0; samp < m_nzerosuppsamples; samp++)
-          {
-            waveform.push_back(-1);
-          }
-          waveforms.push_back(waveform);
+          waveforms.add_channel(m_nzerosuppsamples, -1);
         }
         return Fun4AllReturnCodes::EVENT_OK;
       }
@@ -358,36 +398,20 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
               for (int iskip = 0; iskip < 64; iskip++)
               {
                 n_pad_skip_mask++;
-                std::vector<float> waveform;
-                waveform.reserve(m_nsamples);
-
-                for (int samp = 0; samp < m_nzerosuppsamples; samp++)
-                {
-                  waveform.push_back(0);
-                }
-                waveforms.push_back(waveform);
-                waveform.clear();
+                waveforms.add_channel(m_nzerosuppsamples, 0);
               }
             }
           }
         }
 
-        std::vector<float> waveform;
-        waveform.reserve(m_nsamples);
-        if (packet->iValue(channel, "SUPPRESSED"))
+        if (isSuppressed(packet, channel))
         {
-          waveform.push_back(packet->iValue(channel, "PRE"));
-          waveform.push_back(packet->iValue(channel, "POST"));
+          decodePrePost(packet, channel, waveforms.add_channel(2));
         }
         else
         {
-          for (int samp = 0; samp < m_nsamples; samp++)
-          {
-            waveform.push_back(packet->iValue(samp, channel));
-          }
+          decodeWaveform(packet, channel, m_nsamples, waveforms.add_channel(m_nsamples));
         }
-        waveforms.push_back(waveform);
-        waveform.clear();
       }
 
       int nch_padded = nchannels;
@@ -403,15 +427,7 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
           {
             continue;
           }
-          std::vector<float> waveform;
-          waveform.reserve(m_nsamples);
-
-          for (int samp = 0; samp < m_nzerosuppsamples; samp++)
-          {
-            waveform.push_back(0);
-          }
-          waveforms.push_back(waveform);
-          waveform.clear();
+          waveforms.add_channel(m_nzerosuppsamples, 0);
         }
       }
     }
@@ -423,14 +439,7 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
         {
           continue;
         }
-        std::vector<float> waveform;
-        waveform.reserve(2);
-        for (int samp = 0; samp < m_nzerosuppsamples; samp++)
-        {
-          waveform.push_back(-1);  // push back -1 for missing packets
-        }
-        waveforms.push_back(waveform);
-        waveform.clear();
+        waveforms.add_channel(m_nzerosuppsamples, -1);  // -1 for missing packets
       }
     }
     return Fun4AllReturnCodes::EVENT_OK;
@@ -476,20 +485,19 @@ int CaloTowerBuilder::process_event(PHCompositeNode *topNode)
   {
     return process_sim();
   }
-  std::vector<std::vector<float>> waveforms;
-  if (process_data(topNode, waveforms) == Fun4AllReturnCodes::ABORTEVENT)
+  if (process_data(topNode, m_waveforms) == Fun4AllReturnCodes::ABORTEVENT)
   {
     return Fun4AllReturnCodes::ABORTEVENT;
   }
-  if (waveforms.empty())
+  if (m_waveforms.empty())
   {
     return Fun4AllReturnCodes::EVENT_OK;
   }
-  // waveform vector is filled here, now fill our output. methods from the base class make sure
+  // waveform buffer is filled here, now fill our output. methods from the base class make sure
   // we only fill what the chosen container version supports
-  std::vector<std::vector<float>> processed_waveforms = WaveformProcessing->process_waveform(waveforms);
+  WaveformProcessing->process_waveform(m_waveforms);
 
-  int n_channels = processed_waveforms.size();
+  int n_channels = m_waveforms.size();
   for (int i = 0; i < n_channels; i++)
   {
     int idx = i;
@@ -498,15 +506,17 @@ int CaloTowerBuilder::process_event(PHCompositeNode *topNode)
     {
       idx = cdbttree_sepd_map->GetIntValue(i, m_fieldname);
     }
+    const auto result = m_waveforms.results(idx);
+    const auto waveform = m_waveforms.samples(idx);
     TowerInfo *towerinfo = m_CaloInfoContainer->get_tower_at_channel(i);
-    towerinfo->set_time(processed_waveforms.at(idx).at(1));
-    towerinfo->set_energy(processed_waveforms.at(idx).at(0));
-    towerinfo->set_time(processed_waveforms.at(idx).at(1));
-    towerinfo->set_pedestal(processed_waveforms.at(idx).at(2));
-    towerinfo->set_chi2(processed_waveforms.at(idx).at(3));
-    bool SZS = isSZS(processed_waveforms.at(idx).at(1), processed_waveforms.at(idx).at(3));
-
-    if (processed_waveforms.at(idx).at(4) == 0)
+    towerinfo->set_time(result[1]);
+    towerinfo->set_energy(result[0]);
+    towerinfo->set_time(result[1]);
+    towerinfo->set_pedestal(result[2]);
+    towerinfo->set_chi2(result[3]);
+    bool SZS = isSZS(result[1], result[3]);
+
+    if (result[4] == 0)
     {
       towerinfo->set_isRecovered(false);
     }
@@ -514,11 +524,11 @@ int CaloTowerBuilder::process_event(PHCompositeNode *topNode)
     {
       towerinfo->set_isRecovered(true);
     }
-    towerinfo->set_FitStatus(static_cast<bool>(processed_waveforms.at(idx).at(5)));
-    int n_samples = waveforms.at(idx).size();
+    towerinfo->set_FitStatus(static_cast<bool>(result[5]));
+    int n_samples = waveform.size();
     if (n_samples == m_nzerosuppsamples || SZS)
     {
-      if (waveforms.at(idx).at(0) == -1)
+      if (waveform[0] == -1)
       {
         towerinfo->set_isNotInstr(true);
       }
@@ -530,18 +540,38 @@ int CaloTowerBuilder::process_event(PHCompositeNode *topNode)
 
     for (int j = 0; j < n_samples; j++)
     {
-      if (std::round(waveforms.at(idx).at(j)) >= m_saturation)
+      if (std::round(waveform[j]) >= m_saturation)
       {
         towerinfo->set_isSaturated(true);
       }
-      towerinfo->set_waveform_value(j, waveforms.at(idx).at(j));
+      towerinfo->set_waveform_value(j, waveform[j]);
     }
   }
-  waveforms.clear();
+  fill_packed_waveforms();
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void CaloTowerBuilder::fill_packed_waveforms()
+{
+  if (!m_PackedWaveformContainer)
+  {
+    return;
+  }
+  m_PackedWaveformContainer->Reset();
+  int n_channels = m_waveforms.size();
+  for (int i = 0; i < n_channels; i++)
+  {
+    int idx = i;
+    // Align sEPD ADC channels to TowerInfoContainer, as for the towers
+    if (m_isdata && m_dettype == CaloTowerDefs::SEPD)
+    {
+      idx = cdbttree_sepd_map->GetIntValue(i, m_fieldname);
+    }
+    m_PackedWaveformContainer->add_waveform(m_waveforms.samples(idx));
+  }
+}
+
 bool CaloTowerBuilder::skipChannel(int ich, int pid)
 {
   if (m_dettype == CaloTowerDefs::SEPD)
@@ -669,6 +699,10 @@ void CaloTowerBuilder::CreateNodeTree(PHCompositeNode *topNode)
   {
     m_CaloInfoContainer = new TowerInfoContainerSimv1(DetectorEnum);
   }
+  else if (m_buildertype == CaloTowerDefs::kWaveformTowerv6)
+  {
+    m_CaloInfoContainer = new TowerInfoContainerv6(DetectorEnum);
+  }
   else
   {
     std::cout << PHWHERE << "invalid builder type " << m_buildertype << std::endl;
@@ -678,4 +712,17 @@ void CaloTowerBuilder::CreateNodeTree(PHCompositeNode *topNode)
   TowerNodeName = m_outputNodePrefix + m_detector;
   PHIODataNode<PHObject> *newTowerNode = new PHIODataNode<PHObject>(m_CaloInfoContainer, TowerNodeName, "PHObject");
   DetNode->addNode(newTowerNode);
+
+  if (m_dopackedwaveforms)
+  {
+    // the same node as CaloWaveformSim, if it is already there it is refilled here
+    std::string PackedWaveformNodeName = "PACKEDWAVEFORM_" + m_detector;
+    m_PackedWaveformContainer = findNode::getClass<TowerWaveformContainer>(DetNode, PackedWaveformNodeName);
+    if (!m_PackedWaveformContainer)
+    {
+      m_PackedWaveformContainer = new TowerWaveformContainerv1(m_packedwaveformencoding);
+      PHIODataNode<PHObject> *newWaveformNode = new PHIODataNode<PHObject>(m_PackedWaveformContainer, PackedWaveformNodeName, "PHObject");
+      DetNode->addNode(newWaveformNode);
+    }
+  }
 }
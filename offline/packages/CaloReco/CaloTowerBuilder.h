@@ -4,8 +4,11 @@
 #define CALORECO_CALOTOWERBUILDER_H
 
 #include "CaloTowerDefs.h"
+#include "CaloWaveformBuffer.h"
 #include "CaloWaveformProcessing.h"
 
+#include <calobase/TowerWaveformContainerv1.h>
+
 #include <cdbobjects/CDBTTree.h>  // for CDBTTree
 
 #include <fun4all/SubsysReco.h>
@@ -17,6 +20,7 @@ class CaloWaveformProcessing;
 class PHCompositeNode;
 class TowerInfoContainer;
 class TowerInfoContainerv3;
+class TowerWaveformContainer;
 
 class CaloTowerBuilder : public SubsysReco
 {
@@ -29,7 +33,7 @@ public:
 
   void CreateNodeTree(PHCompositeNode *topNode);
 
-  int process_data(PHCompositeNode *topNode, std::vector<std::vector<float>> &waveforms);
+  int process_data(PHCompositeNode *topNode, CaloWaveformBuffer &waveforms);
 
   void set_detector_type(CaloTowerDefs::DetectorSystem dettype)
   {
@@ -127,15 +131,30 @@ public:
     return;
   }
 
+  // store the waveforms of all channels packed in one buffer, in the node
+  // PACKEDWAVEFORM_<detector>. To be used with a builder type without
+  // waveforms in the towers (kWaveformTowerv2, kWaveformTowerv6).
+  // Off by default, macros/Fun4All_PackedWaveformSize.C compares the DST size
+  // and read time with kPRDFWaveform
+  void set_packed_waveforms(bool dopackedwaveforms = true, TowerWaveformContainerv1::Encoding encoding = TowerWaveformContainerv1::kPacked)
+  {
+    m_dopackedwaveforms = dopackedwaveforms;
+    m_packedwaveformencoding = encoding;
+    return;
+  }
+
   CaloWaveformProcessing *get_WaveformProcessing() { return WaveformProcessing; }
 
 private:
   int process_sim();
+  void fill_packed_waveforms();
   bool skipChannel(int ich, int pid);
   static bool isSZS(float time, float chi2);
   CaloWaveformProcessing *WaveformProcessing{nullptr};
+  CaloWaveformBuffer m_waveforms;  // reused from event to event
   TowerInfoContainer *m_CaloInfoContainer{nullptr};      //! Calo info
   TowerInfoContainer *m_CalowaveformContainer{nullptr};  // waveform from simulation
+  TowerWaveformContainer *m_PackedWaveformContainer{nullptr};  //! packed waveforms
   CDBTTree *cdbttree = nullptr;
   CDBTTree *cdbttree_sepd_map = nullptr;
   CDBTTree *cdbttree_tbt_zs = nullptr;
@@ -162,6 +181,8 @@ private:
   float m_timeLim_low{-3.0};
   float m_timeLim_high{4.0};
   bool m_dobitfliprecovery{false};
+  bool m_dopackedwaveforms{false};
+  TowerWaveformContainerv1::Encoding m_packedwaveformencoding{TowerWaveformContainerv1::kPacked};
 
   int m_saturation{16383};
   std::string calibdir;
@@ -7,6 +7,7 @@
 #include <calobase/TowerInfoContainerv2.h>
 #include <calobase/TowerInfov1.h>
 #include <calobase/TowerInfov2.h>
+#include <calobase/TowerInfov6.h>
 
 #include <cdbobjects/CDBTTree.h>  // for CDBTTree
 
@@ -28,9 +29,12 @@
 
 #include <TSystem.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>    // for exit
 #include <exception>  // for exception
 #include <iostream>   // for operator<<, basic_ostream
+#include <span>
 #include <stdexcept>  // for runtime_error
 
 //____________________________________________________________________________..
@@ -269,6 +273,14 @@ int CaloTowerCalib::process_event(PHCompositeNode *topNode)
   TowerInfoContainer *_calib_towers = findNode::getClass<TowerInfoContainer>(topNode, CalibTowerNodeName);
   unsigned int ntowers = _raw_towers->size();
 
+  // containers with array storage are calibrated in one pass over the arrays
+  if (_raw_towers->get_energy_array().size() == ntowers &&
+      _calib_towers->get_energy_array().size() == ntowers && ntowers > 0)
+  {
+    calibrate_arrays(_raw_towers, _calib_towers);
+    return Fun4AllReturnCodes::EVENT_OK;
+  }
+
   for (unsigned int channel = 0; channel < ntowers; channel++)
   {
     TowerInfo *caloinfo_raw = _raw_towers->get_tower_at_channel(channel);
@@ -310,6 +322,43 @@ int CaloTowerCalib::process_event(PHCompositeNode *topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void CaloTowerCalib::calibrate_arrays(TowerInfoContainer *raw_towers, TowerInfoContainer *calib_towers)
+{
+  std::span<const float> raw_energy = raw_towers->get_energy_array();
+  std::span<const short> raw_time = raw_towers->get_time_array();
+  std::span<const uint8_t> raw_status = raw_towers->get_status_array();
+
+  std::span<float> energy = calib_towers->get_energy_array();
+  std::span<short> time = calib_towers->get_time_array();
+  std::span<uint8_t> status = calib_towers->get_status_array();
+
+  // copy_tower()
+  std::copy(raw_time.begin(), raw_time.end(), time.begin());
+  std::copy(raw_towers->get_chi2_array().begin(), raw_towers->get_chi2_array().end(), calib_towers->get_chi2_array().begin());
+  std::copy(raw_towers->get_pedestal_array().begin(), raw_towers->get_pedestal_array().end(), calib_towers->get_pedestal_array().begin());
+
+  constexpr uint8_t zs_mask = TowerInfov6::status_mask(TowerInfov6::kZS);
+  for (size_t channel = 0; channel < raw_energy.size(); channel++)
+  {
+    const CDBInfo &cdbInfo = m_cdbInfo_vec[channel];
+    bool isZS = raw_status[channel] & zs_mask;
+
+    float crosscalibconst = 1;
+    if (isZS && m_doZScrosscalib && cdbInfo.crosscalibconst != 0)
+    {
+      crosscalibconst = cdbInfo.crosscalibconst;
+    }
+    energy[channel] = raw_energy[channel] * cdbInfo.calibconst * crosscalibconst;
+    status[channel] = raw_status[channel] | ((uint8_t) (cdbInfo.calibconst == 0) << TowerInfov6::kNoCalib);
+
+    // timing is not useful for ZS towers
+    if (m_dotimecalib && !isZS)
+    {
+      time[channel] = TowerInfov6::encode_time(TowerInfov6::decode_time(raw_time[channel]) - cdbInfo.meantime);
+    }
+  }
+}
+
 void CaloTowerCalib::CreateNodeTree(PHCompositeNode *topNode)
 {
   PHNodeIterator iter(topNode);
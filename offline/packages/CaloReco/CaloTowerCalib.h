@@ -161,6 +161,9 @@ class CaloTowerCalib : public SubsysReco
 
   void LoadCalib(PHCompositeNode *topNode);
 
+  // process_event() for containers with array storage (TowerInfoContainerv6)
+  void calibrate_arrays(TowerInfoContainer *raw_towers, TowerInfoContainer *calib_towers);
+
   struct CDBInfo
   {
     float calibconst{0};
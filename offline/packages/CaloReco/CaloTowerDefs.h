@@ -20,7 +20,8 @@ namespace CaloTowerDefs
     kPRDFWaveform = 1,
     kWaveformTowerv2 = 2,
     kPRDFTowerv4 = 3,
-    kWaveformTowerSimv1 = 4
+    kWaveformTowerSimv1 = 4,
+    kWaveformTowerv6 = 5  // content of kWaveformTowerv2, stored as arrays
   };
 }
 
@@ -3,6 +3,7 @@
 
 #include <calobase/TowerInfo.h>  // for TowerInfo
 #include <calobase/TowerInfoContainer.h>
+#include <calobase/TowerInfov6.h>
 
 #include <cdbobjects/CDBTTree.h>  // for CDBTTree
 
@@ -18,7 +19,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <iostream>  // for operator<<, basic_ostream
+#include <span>
 
 //____________________________________________________________________________..
 CaloTowerStatus::CaloTowerStatus(const std::string &name)
@@ -173,65 +176,81 @@ void CaloTowerStatus::LoadCalib(CDBTTree *cdbttree_chi2, CDBTTree *cdbttree_hotM
       }
     }
   }
+
+  // the hot status only depends on the calibrations, it is evaluated once per run
+  m_isHot_vec.assign(ntowers, 0);
+  for (unsigned int channel = 0; channel < ntowers; channel++)
+  {
+    m_isHot_vec[channel] = is_hot(m_cdbInfo_vec[channel]);
+  }
 }
 
-//____________________________________________________________________________..
-int CaloTowerStatus::process_event(PHCompositeNode * /*topNode*/)
+bool CaloTowerStatus::is_hot(const CDBInfo &cdbInfo) const
 {
-  unsigned int ntowers = m_raw_towers->size();
-  float fraction_badChi2 = 0;
-  int hotMap_val = 0;
-  float z_score = 0;
-  for (unsigned int channel = 0; channel < ntowers; channel++)
+  if (m_doHotChi2 && cdbInfo.fraction_badChi2 > fraction_badChi2_threshold)
   {
-    // only reset what we will set
-    m_raw_towers->get_tower_at_channel(channel)->set_isHot(false);
-    m_raw_towers->get_tower_at_channel(channel)->set_isBadChi2(false);
+    return true;
+  }
+  if (m_doHotMap)
+  {
+    bool is_hot_tower = false;
 
-    if (m_doHotChi2)
+    // 1. Default behavior: rely on valid positive hotMap status codes only
+    if (z_score_threshold == z_score_threshold_default)
     {
-      fraction_badChi2 = m_cdbInfo_vec[channel].fraction_badChi2;
+      is_hot_tower = (cdbInfo.hotMap_val > 0);
     }
-    if (m_doHotMap)
+    // 2. Custom behavior: evaluate based on the custom z_score threshold
+    else
     {
-      hotMap_val = m_cdbInfo_vec[channel].hotMap_val;
-      z_score = m_cdbInfo_vec[channel].z_score;
+      bool is_dead = (cdbInfo.hotMap_val == 1);
+      bool exceeds_zscore_limit = (std::abs(cdbInfo.z_score) > z_score_threshold);                              // Captures both hot and cold by sigma
+      bool is_low_yield_cold = (cdbInfo.hotMap_val == 3 && cdbInfo.z_score >= -1 * z_score_threshold_default);  // Captures the mean-based cold towers
+
+      is_hot_tower = (is_dead || exceeds_zscore_limit || is_low_yield_cold);
     }
-    float chi2 = m_raw_towers->get_tower_at_channel(channel)->get_chi2();
-    float adc = m_raw_towers->get_tower_at_channel(channel)->get_energy();
+    return is_hot_tower;
+  }
+  return false;
+}
 
-    if (fraction_badChi2 > fraction_badChi2_threshold && m_doHotChi2)
+//____________________________________________________________________________..
+int CaloTowerStatus::process_event(PHCompositeNode * /*topNode*/)
+{
+  unsigned int ntowers = m_raw_towers->size();
+
+  // containers with array storage are flagged in one pass over the arrays
+  std::span<uint8_t> status = m_raw_towers->get_status_array();
+  if (status.size() == ntowers && ntowers > 0)
+  {
+    std::span<const float> chi2 = m_raw_towers->get_chi2_array();
+    std::span<const float> adc = m_raw_towers->get_energy_array();
+    constexpr uint8_t reset_mask = TowerInfov6::status_mask(TowerInfov6::kHot) | TowerInfov6::status_mask(TowerInfov6::kBadChi2);
+    for (unsigned int channel = 0; channel < ntowers; channel++)
     {
-      m_raw_towers->get_tower_at_channel(channel)->set_isHot(true);
+      // only reset what we will set
+      uint8_t tower_status = status[channel] & ~reset_mask;
+      tower_status |= m_isHot_vec[channel] << TowerInfov6::kHot;
+      bool isBadChi2 = chi2[channel] > std::min(std::max(badChi2_treshold_const, adc[channel] * adc[channel] * badChi2_treshold_quadratic), badChi2_treshold_max);
+      tower_status |= (uint8_t) isBadChi2 << TowerInfov6::kBadChi2;
+      status[channel] = tower_status;
     }
-    if (m_doHotMap)
-    {
-      bool is_hot_tower = false;
+    return Fun4AllReturnCodes::EVENT_OK;
+  }
 
-      // 1. Default behavior: rely on valid positive hotMap status codes only
-      if (z_score_threshold == z_score_threshold_default)
-      {
-        is_hot_tower = (hotMap_val > 0);
-      }
-      // 2. Custom behavior: evaluate based on the custom z_score threshold
-      else
-      {
-        bool is_dead = (hotMap_val == 1);
-        bool exceeds_zscore_limit = (std::abs(z_score) > z_score_threshold);                      // Captures both hot and cold by sigma
-        bool is_low_yield_cold = (hotMap_val == 3 && z_score >= -1 * z_score_threshold_default);  // Captures the mean-based cold towers
+  for (unsigned int channel = 0; channel < ntowers; channel++)
+  {
+    TowerInfo *tower = m_raw_towers->get_tower_at_channel(channel);
 
-        is_hot_tower = (is_dead || exceeds_zscore_limit || is_low_yield_cold);
-      }
+    // only reset what we will set
+    tower->set_isHot(m_isHot_vec[channel]);
+    tower->set_isBadChi2(false);
 
-      // Apply the result
-      if (is_hot_tower)
-      {
-        m_raw_towers->get_tower_at_channel(channel)->set_isHot(true);
-      }
-    }
+    float chi2 = tower->get_chi2();
+    float adc = tower->get_energy();
     if (chi2 > std::min(std::max(badChi2_treshold_const, adc * adc * badChi2_treshold_quadratic), badChi2_treshold_max))
     {
-      m_raw_towers->get_tower_at_channel(channel)->set_isBadChi2(true);
+      tower->set_isBadChi2(true);
     }
   }
   return Fun4AllReturnCodes::EVENT_OK;
@@ -7,6 +7,7 @@
 
 #include <fun4all/SubsysReco.h>
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -131,6 +132,10 @@ class CaloTowerStatus : public SubsysReco
   };
 
   std::vector<CDBInfo> m_cdbInfo_vec;
+
+  // hot status of the channels from the calibrations
+  bool is_hot(const CDBInfo &cdbInfo) const;
+  std::vector<uint8_t> m_isHot_vec;
 };
 
 #endif  // CALOTOWERBUILDER_H
@@ -0,0 +1,112 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef CALORECO_CALOWAVEFORMBUFFER_H
+#define CALORECO_CALOWAVEFORMBUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ * waveforms of one event as a channel major matrix.
+ * every channel owns a slot of stride() samples, of which nsamples(channel) are used
+ * (the full waveform, or pre/post for zero suppressed channels).
+ * The fit results (amplitude, time, pedestal, chi2, recovered, fit status) are stored
+ * next to it, nresults per channel.
+ * clear() keeps the allocated memory, the buffer is meant to be reused event by event
+ */
+class CaloWaveformBuffer
+{
+ public:
+  static constexpr int nresults = 6;
+
+  //! remove all channels, slots hold up to stride samples
+  void clear(int stride)
+  {
+    m_stride = stride;
+    m_nsamples.clear();
+    m_results.clear();
+  }
+
+  //! add a channel with nsamples (<= stride) samples, returns its samples to be filled
+  float *add_channel(int nsamples)
+  {
+    const size_t channel = m_nsamples.size();
+    m_nsamples.push_back(nsamples);
+    const size_t needed = (channel + 1) * m_stride;
+    if (m_samples.size() < needed)
+    {
+      m_samples.resize(needed);
+    }
+    return m_samples.data() + channel * m_stride;
+  }
+
+  //! add a channel with all samples set to value
+  void add_channel(int nsamples, float value)
+  {
+    std::fill_n(add_channel(nsamples), nsamples, value);
+  }
+
+  //! copy from one vector per channel
+  void assign(const std::vector<std::vector<float>> &waveforms)
+  {
+    size_t stride = 0;
+    for (const auto &waveform : waveforms)
+    {
+      stride = std::max(stride, waveform.size());
+    }
+    clear(stride);
+    for (const auto &waveform : waveforms)
+    {
+      std::copy(waveform.begin(), waveform.end(), add_channel(waveform.size()));
+    }
+  }
+
+  size_t size() const { return m_nsamples.size(); }
+  bool empty() const { return m_nsamples.empty(); }
+  int stride() const { return m_stride; }
+  int nsamples(size_t channel) const { return m_nsamples[channel]; }
+
+  std::span<const float> samples(size_t channel) const
+  {
+    return {m_samples.data() + channel * m_stride, static_cast<size_t>(m_nsamples[channel])};
+  }
+
+  //! one result row per channel, to be called before filling the results
+  void init_results()
+  {
+    m_results.assign(size() * nresults, 0);
+  }
+
+  std::span<float> results(size_t channel)
+  {
+    return {m_results.data() + channel * nresults, nresults};
+  }
+
+  std::span<const float> results(size_t channel) const
+  {
+    return {m_results.data() + channel * nresults, nresults};
+  }
+
+  //! copy of the results, one vector per channel
+  std::vector<std::vector<float>> get_results() const
+  {
+    std::vector<std::vector<float>> results;
+    results.reserve(size());
+    for (size_t channel = 0; channel < size(); ++channel)
+    {
+      const auto row = this->results(channel);
+      results.emplace_back(row.begin(), row.end());
+    }
+    return results;
+  }
+
+ private:
+  int m_stride{0};
+  std::vector<int> m_nsamples;
+  std::vector<float> m_samples;
+  std::vector<float> m_results;
+};
+
+#endif
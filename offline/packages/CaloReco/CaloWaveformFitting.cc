@@ -1,4 +1,5 @@
 #include "CaloWaveformFitting.h"
+#include "CaloWaveformBuffer.h"
 
 #include <TF1.h>
 #include <TFile.h>
@@ -14,6 +15,7 @@
 #include <HFitInterface.h>
 #include <Math/WrappedMultiTF1.h>
 #include <Math/WrappedTF1.h>
+#include <ROOT/TSeq.hxx>
 #include <ROOT/TThreadExecutor.hxx>
 #include <ROOT/TThreadedObject.hxx>
 
@@ -50,268 +52,244 @@ void CaloWaveformFitting::initialize_processing(const std::string &templatefile)
 
 std::vector<std::vector<float>> CaloWaveformFitting::process_waveform(std::vector<std::vector<float>> waveformvector)
 {
-  int size1 = waveformvector.size();
-  std::vector<std::vector<float>> fitresults;
-  for (int i = 0; i < size1; i++)
+  CaloWaveformBuffer waveforms;
+  waveforms.assign(waveformvector);
+  calo_processing_templatefit(waveforms);
+  return waveforms.get_results();
+}
+
+std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit(std::vector<std::vector<float>> chnlvector)
+{
+  // strip the channel number
+  for (auto &v : chnlvector)
   {
-    waveformvector.at(i).push_back(i);
+    v.pop_back();
   }
-  fitresults = calo_processing_templatefit(waveformvector);
-  return fitresults;
+  CaloWaveformBuffer waveforms;
+  waveforms.assign(chnlvector);
+  calo_processing_templatefit(waveforms);
+  return waveforms.get_results();
 }
 
-std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit(std::vector<std::vector<float>> chnlvector)
+void CaloWaveformFitting::calo_processing_templatefit(CaloWaveformBuffer &waveforms)
+{
+  waveforms.init_results();
+  auto func = [&](unsigned int channel)
+  {
+    process_channel_templatefit(waveforms.samples(channel), channel, waveforms.results(channel));
+  };
+  t->Foreach(func, ROOT::TSeq<unsigned int>(waveforms.size()));
+}
+
+void CaloWaveformFitting::process_channel_templatefit(std::span<const float> v, int channel, std::span<float> result)
 {
-  auto func = [&](std::vector<float> &v)
+  int size1 = v.size();
+  if (size1 == _nzerosuppresssamples)
   {
-    int size1 = v.size() - 1;
-    if (size1 == _nzerosuppresssamples)
+    result[0] = v[1] - v[0];                         // returns peak sample - pedestal sample
+    result[1] = std::numeric_limits<float>::quiet_NaN();  // set time to qnan for ZS
+    result[2] = v[0];
+    if (v[0] != 0 && v[1] == 0)  // check if post-sample is 0, if so set high chi2
     {
-      v.push_back(v.at(1) - v.at(0));                        // returns peak sample - pedestal sample
-      v.push_back(std::numeric_limits<float>::quiet_NaN());  // set time to qnan for ZS
-      v.push_back(v.at(0));
-      if (v.at(0) != 0 && v.at(1) == 0)  // check if post-sample is 0, if so set high chi2
-      {
-        v.push_back(1000000);
-      }
-      else
-      {
-        v.push_back(std::numeric_limits<float>::quiet_NaN());
-      }
-      v.push_back(0);
-      v.push_back(0);
+      result[3] = 1000000;
+    }
+    else
+    {
+      result[3] = std::numeric_limits<float>::quiet_NaN();
+    }
+    result[4] = 0;
+    result[5] = 0;
+    return;
+  }
+
+  float maxheight = 0;
+  int maxbin = 0;
+  for (int i = 0; i < size1; i++)
+  {
+    if (v[i] > maxheight)
+    {
+      maxheight = v[i];
+      maxbin = i;
+    }
+  }
+  float pedestal = 1500;
+  if (maxbin > 4)
+  {
+    pedestal = 0.5 * (v[maxbin - 4] + v[maxbin - 5]);
+  }
+  else if (maxbin > 3)
+  {
+    pedestal = (v[maxbin - 4]);
+  }
+  else
+  {
+    pedestal = 0.5 * (v[size1 - 3] + v[size1 - 2]);
+  }
+
+  if ((_bdosoftwarezerosuppression && v[6] - v[0] < _nsoftwarezerosuppression) || (_maxsoftwarezerosuppression && maxheight - pedestal < _nsoftwarezerosuppression))
+  {
+    result[0] = v[6] - v[0];
+    result[1] = std::numeric_limits<float>::quiet_NaN();
+    result[2] = v[0];
+    if (v[0] != 0 && v[1] == 0)  // check if post-sample is 0, if so set high chi2
+    {
+      result[3] = 1000000;
     }
     else
     {
-      float maxheight = 0;
-      int maxbin = 0;
+      result[3] = std::numeric_limits<float>::quiet_NaN();
+    }
+    result[4] = 0;
+    result[5] = 0;
+    return;
+  }
+
+  auto *h = new TH1F(std::string("h_" + std::to_string(channel)).c_str(), "", size1, -0.5, size1 - 0.5);
+
+  int ndata = 0;
+  for (int i = 0; i < size1; ++i)
+  {
+    if ((v[i] == 16383) && _handleSaturation)
+    {
+      continue;
+    }
+
+    h->SetBinContent(i + 1, v[i]);
+    h->SetBinError(i + 1, 1);
+    ndata++;
+  }
+  // if too many are saturated don't do the saturation recovery need enough ndf
+  if (ndata < (size1 - 4))
+  {
+    ndata = size1;
+    for (int i = 0; i < size1; ++i)
+    {
+      h->SetBinContent(i + 1, v[i]);
+      h->SetBinError(i + 1, 1);
+    }
+  }
+
+  auto *f = new TF1(std::string("f_" + std::to_string(channel)).c_str(), this, &CaloWaveformFitting::template_function, 0, 31, 3, "CaloWaveformFitting", "template_function");
+  ROOT::Math::WrappedMultiTF1 *fitFunction = new ROOT::Math::WrappedMultiTF1(*f, 3);
+  ROOT::Fit::BinData data(size1, 1);
+  ROOT::Fit::FillData(data, h);
+  ROOT::Fit::Chi2Function *EPChi2 = new ROOT::Fit::Chi2Function(data, *fitFunction);
+  ROOT::Fit::Fitter *fitter = new ROOT::Fit::Fitter();
+  fitter->Config().MinimizerOptions().SetMinimizerType("GSLMultiFit");
+  fitter->Config().MinimizerOptions().SetPrintLevel(-1);
+  double params[] = {static_cast<double>(maxheight - pedestal), static_cast<double>(maxbin - m_peakTimeTemp), static_cast<double>(pedestal)};
+  // double params[] = {static_cast<double>(maxheight - pedestal), 0, static_cast<double>(pedestal)};
+  fitter->Config().SetParamsSettings(3, params);
+  fitter->Config().ParSettings(1).SetLimits(-1 * m_peakTimeTemp, size1 - m_peakTimeTemp);  // set lim on time par
+  if (m_setTimeLim)
+  {
+    fitter->Config().ParSettings(1).SetLimits(m_timeLim_low, m_timeLim_high);
+  }
+  fitter->FitFCN(*EPChi2, nullptr, data.Size(), true);
+  ROOT::Fit::FitResult fitres = fitter->Result();
+  // get the fit status code (0 means successful fit)
+  int validfit = fitres.Status();
+  double chi2min = fitres.MinFcnValue();
+  // chi2min /= size1 - 3;  // divide by the number of dof
+  chi2min /= ndata - 3;  // divide by the number of dof
+  if (chi2min > _chi2threshold && (f->GetParameter(2) < _bfr_highpedestalthreshold || pedestal < _bfr_highpedestalthreshold) && (f->GetParameter(2) > _bfr_lowpedestalthreshold || pedestal > _bfr_lowpedestalthreshold) && _dobitfliprecovery)
+  {
+    std::vector<float> rv(v.begin(), v.end());  // temporary recovered waveform
+    unsigned int bits[3] = {8192, 4096, 2048};
+    for (auto bit : bits)
+    {
       for (int i = 0; i < size1; i++)
       {
-        if (v.at(i) > maxheight)
+        if (((unsigned int) rv.at(i) & bit) && ((unsigned int) rv.at(i) % bit > _bfr_lowpedestalthreshold))
         {
-          maxheight = v.at(i);
-          maxbin = i;
+          rv.at(i) = rv.at(i) - bit;
         }
       }
-      float pedestal = 1500;
-      if (maxbin > 4)
-      {
-        pedestal = 0.5 * (v.at(maxbin - 4) + v.at(maxbin - 5));
-      }
-      else if (maxbin > 3)
-      {
-        pedestal = (v.at(maxbin - 4));
-      }
-      else
+    }
+    for (int i = 0; i < size1; i++)
+    {
+      h->SetBinContent(i + 1, rv.at(i));
+      h->SetBinError(i + 1, 1);
+    }
+
+    maxheight = 0;
+    maxbin = 0;
+    for (int i = 0; i < size1; i++)
+    {
+      if (rv.at(i) > maxheight)
       {
-        pedestal = 0.5 * (v.at(size1 - 3) + v.at(size1 - 2));
+        maxheight = rv.at(i);
+        maxbin = i;
       }
+    }
+    if (maxbin > 4)
+    {
+      pedestal = 0.5 * (rv.at(maxbin - 4) + rv.at(maxbin - 5));
+    }
+    else if (maxbin > 3)
+    {
+      pedestal = (rv.at(maxbin - 4));
+    }
+    else
+    {
+      pedestal = 0.5 * (rv.at(size1 - 3) + rv.at(size1 - 2));
+    }
 
-      if ((_bdosoftwarezerosuppression && v.at(6) - v.at(0) < _nsoftwarezerosuppression) || (_maxsoftwarezerosuppression && maxheight - pedestal < _nsoftwarezerosuppression))
+    auto *recover_f = new TF1(std::string("recover_f_" + std::to_string(channel)).c_str(), this, &CaloWaveformFitting::template_function, 0, 31, 3, "CaloWaveformFitting", "template_function");
+    ROOT::Math::WrappedMultiTF1 *recoverFitFunction = new ROOT::Math::WrappedMultiTF1(*recover_f, 3);
+    ROOT::Fit::BinData recoverData(rv.size() - 1, 1);
+    ROOT::Fit::FillData(recoverData, h);
+    ROOT::Fit::Chi2Function *recoverEPChi2 = new ROOT::Fit::Chi2Function(recoverData, *recoverFitFunction);
+    ROOT::Fit::Fitter *recoverFitter = new ROOT::Fit::Fitter();
+    recoverFitter->Config().MinimizerOptions().SetMinimizerType("GSLMultiFit");
+    double recover_params[] = {static_cast<double>(maxheight - pedestal), 0, static_cast<double>(pedestal)};
+    recoverFitter->Config().SetParamsSettings(3, recover_params);
+    recoverFitter->Config().ParSettings(1).SetLimits(-1 * m_peakTimeTemp, size1 - m_peakTimeTemp);  // set lim on time par
+    recoverFitter->FitFCN(*recoverEPChi2, nullptr, recoverData.Size(), true);
+    ROOT::Fit::FitResult recover_fitres = recoverFitter->Result();
+    int recover_validfit = recover_fitres.Status();
+    double recover_chi2min = recover_fitres.MinFcnValue();
+    recover_chi2min /= size1 - 3;  // divide by the number of dof
+    if (recover_chi2min < _chi2lowthreshold && recover_f->GetParameter(2) < _bfr_highpedestalthreshold && recover_f->GetParameter(2) > _bfr_lowpedestalthreshold)
+    {
+      for (int i = 0; i < 3; i++)
       {
-        v.push_back(v.at(6) - v.at(0));
-        v.push_back(std::numeric_limits<float>::quiet_NaN());
-        v.push_back(v.at(0));
-        if (v.at(0) != 0 && v.at(1) == 0)  // check if post-sample is 0, if so set high chi2
-        {
-          v.push_back(1000000);
-        }
-        else
-        {
-          v.push_back(std::numeric_limits<float>::quiet_NaN());
-        }
-        v.push_back(0);
-        v.push_back(0);
+        result[i] = recover_f->GetParameter(i);
       }
-      else
+      result[3] = recover_chi2min;
+      result[4] = 1;
+      result[5] = recover_validfit;
+    }
+    else
+    {
+      for (int i = 0; i < 3; i++)
       {
-        auto *h = new TH1F(std::string("h_" + std::to_string((int) round(v.at(size1)))).c_str(), "", size1, -0.5, size1 - 0.5);
-
-        int ndata = 0;
-        for (int i = 0; i < size1; ++i)
-        {
-          if ((v.at(i) == 16383) && _handleSaturation)
-          {
-            continue;
-          }
-
-          h->SetBinContent(i + 1, v.at(i));
-          h->SetBinError(i + 1, 1);
-          ndata++;
-        }
-        // if too many are saturated don't do the saturation recovery need enough ndf
-        if (ndata < (size1 - 4))
-        {
-          ndata = size1;
-          for (int i = 0; i < size1; ++i)
-          {
-            h->SetBinContent(i + 1, v.at(i));
-            h->SetBinError(i + 1, 1);
-          }
-        }
-
-        auto *f = new TF1(std::string("f_" + std::to_string((int) round(v.at(size1)))).c_str(), this, &CaloWaveformFitting::template_function, 0, 31, 3, "CaloWaveformFitting", "template_function");
-        ROOT::Math::WrappedMultiTF1 *fitFunction = new ROOT::Math::WrappedMultiTF1(*f, 3);
-        ROOT::Fit::BinData data(v.size() - 1, 1);
-        ROOT::Fit::FillData(data, h);
-        ROOT::Fit::Chi2Function *EPChi2 = new ROOT::Fit::Chi2Function(data, *fitFunction);
-        ROOT::Fit::Fitter *fitter = new ROOT::Fit::Fitter();
-        fitter->Config().MinimizerOptions().SetMinimizerType("GSLMultiFit");
-        fitter->Config().MinimizerOptions().SetPrintLevel(-1);
-        double params[] = {static_cast<double>(maxheight - pedestal), static_cast<double>(maxbin - m_peakTimeTemp), static_cast<double>(pedestal)};
-        // double params[] = {static_cast<double>(maxheight - pedestal), 0, static_cast<double>(pedestal)};
-        fitter->Config().SetParamsSettings(3, params);
-        fitter->Config().ParSettings(1).SetLimits(-1 * m_peakTimeTemp, size1 - m_peakTimeTemp);  // set lim on time par
-        if (m_setTimeLim)
-        {
-          fitter->Config().ParSettings(1).SetLimits(m_timeLim_low, m_timeLim_high);
-        }
-        fitter->FitFCN(*EPChi2, nullptr, data.Size(), true);
-        ROOT::Fit::FitResult fitres = fitter->Result();
-        // get the fit status code (0 means successful fit)
-        int validfit = fitres.Status();
-        /*
-        if(validfit != 0)
-        {
-          std::cout<<"invalid fit status in waveform fitting: " << validfit <<std::endl;
-          for (int i = 0; i < size1; ++i)
-        {
-          std::cout<<v.at(i) << " ";
-        }
-        std::cout<<std::endl;
-        }
-        */
-        double chi2min = fitres.MinFcnValue();
-        // chi2min /= size1 - 3;  // divide by the number of dof
-        chi2min /= ndata - 3;  // divide by the number of dof
-        if (chi2min > _chi2threshold && (f->GetParameter(2) < _bfr_highpedestalthreshold || pedestal < _bfr_highpedestalthreshold) && (f->GetParameter(2) > _bfr_lowpedestalthreshold || pedestal > _bfr_lowpedestalthreshold) && _dobitfliprecovery)
-        {
-          std::vector<float> rv;  // temporary recovered waveform
-          rv.reserve(size1);
-          for (int i = 0; i < size1; i++)
-          {
-            rv.push_back(v.at(i));
-          }
-          unsigned int bits[3] = {8192, 4096, 2048};
-          for (auto bit : bits)
-          {
-            for (int i = 0; i < size1; i++)
-            {
-              if (((unsigned int) rv.at(i) & bit) && ((unsigned int) rv.at(i) % bit > _bfr_lowpedestalthreshold))
-              {
-                rv.at(i) = rv.at(i) - bit;
-              }
-            }
-          }
-          for (int i = 0; i < size1; i++)
-          {
-            h->SetBinContent(i + 1, rv.at(i));
-            h->SetBinError(i + 1, 1);
-          }
-
-          maxheight = 0;
-          maxbin = 0;
-          for (int i = 0; i < size1; i++)
-          {
-            if (rv.at(i) > maxheight)
-            {
-              maxheight = rv.at(i);
-              maxbin = i;
-            }
-          }
-          if (maxbin > 4)
-          {
-            pedestal = 0.5 * (rv.at(maxbin - 4) + rv.at(maxbin - 5));
-          }
-          else if (maxbin > 3)
-          {
-            pedestal = (rv.at(maxbin - 4));
-          }
-          else
-          {
-            pedestal = 0.5 * (rv.at(size1 - 3) + rv.at(size1 - 2));
-          }
-
-          auto *recover_f = new TF1(std::string("recover_f_" + std::to_string((int) round(v.at(size1)))).c_str(), this, &CaloWaveformFitting::template_function, 0, 31, 3, "CaloWaveformFitting", "template_function");
-          ROOT::Math::WrappedMultiTF1 *recoverFitFunction = new ROOT::Math::WrappedMultiTF1(*recover_f, 3);
-          ROOT::Fit::BinData recoverData(rv.size() - 1, 1);
-          ROOT::Fit::FillData(recoverData, h);
-          ROOT::Fit::Chi2Function *recoverEPChi2 = new ROOT::Fit::Chi2Function(recoverData, *recoverFitFunction);
-          ROOT::Fit::Fitter *recoverFitter = new ROOT::Fit::Fitter();
-          recoverFitter->Config().MinimizerOptions().SetMinimizerType("GSLMultiFit");
-          double recover_params[] = {static_cast<double>(maxheight - pedestal), 0, static_cast<double>(pedestal)};
-          recoverFitter->Config().SetParamsSettings(3, recover_params);
-          recoverFitter->Config().ParSettings(1).SetLimits(-1 * m_peakTimeTemp, size1 - m_peakTimeTemp);  // set lim on time par
-          recoverFitter->FitFCN(*recoverEPChi2, nullptr, recoverData.Size(), true);
-          ROOT::Fit::FitResult recover_fitres = recoverFitter->Result();
-          int recover_validfit = recover_fitres.Status();
-          double recover_chi2min = recover_fitres.MinFcnValue();
-          recover_chi2min /= size1 - 3;  // divide by the number of dof
-          if (recover_chi2min < _chi2lowthreshold && recover_f->GetParameter(2) < _bfr_highpedestalthreshold && recover_f->GetParameter(2) > _bfr_lowpedestalthreshold)
-          {
-            for (int i = 0; i < size1; i++)
-            {
-              v.at(i) = rv.at(i);
-            }
-            for (int i = 0; i < 3; i++)
-            {
-              v.push_back(recover_f->GetParameter(i));
-            }
-            v.push_back(recover_chi2min);
-            v.push_back(1);
-            v.push_back(recover_validfit);
-          }
-          else
-          {
-            for (int i = 0; i < 3; i++)
-            {
-              v.push_back(f->GetParameter(i));
-            }
-            v.push_back(chi2min);
-            v.push_back(0);
-            v.push_back(validfit);
-          }
-          recover_f->Delete();
-          delete recoverFitFunction;
-          delete recoverFitter;
-          delete recoverEPChi2;
-        }
-        else
-        {
-          for (int i = 0; i < 3; i++)
-          {
-            v.push_back(f->GetParameter(i));
-          }
-          v.push_back(chi2min);
-          v.push_back(0);
-          v.push_back(validfit);
-        }
-        h->Delete();
-        f->Delete();
-        delete fitFunction;
-        delete fitter;
-        delete EPChi2;
+        result[i] = f->GetParameter(i);
       }
+      result[3] = chi2min;
+      result[4] = 0;
+      result[5] = validfit;
     }
-  };
-
-  t->Foreach(func, chnlvector);
-  int size3 = chnlvector.size();
-  std::vector<std::vector<float>> fit_params;
-  std::vector<float> fit_params_tmp;
-  for (int i = 0; i < size3; i++)
+    recover_f->Delete();
+    delete recoverFitFunction;
+    delete recoverFitter;
+    delete recoverEPChi2;
+  }
+  else
   {
-    const std::vector<float> &tv = chnlvector.at(i);
-    int size2 = tv.size();
-    for (int q = 6; q > 0; q--)
+    for (int i = 0; i < 3; i++)
     {
-      fit_params_tmp.push_back(tv.at(size2 - q));
+      result[i] = f->GetParameter(i);
     }
-    fit_params.push_back(fit_params_tmp);
-    fit_params_tmp.clear();
+    result[3] = chi2min;
+    result[4] = 0;
+    result[5] = validfit;
   }
-  chnlvector.clear();
-  return fit_params;
+  h->Delete();
+  f->Delete();
+  delete fitFunction;
+  delete fitter;
+  delete EPChi2;
 }
 
 void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float y1, float y2, float &xmax, float &ymax)
@@ -388,94 +366,121 @@ void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float
 }
 std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_fast(const std::vector<std::vector<float>> &chnlvector)
 {
-  std::vector<std::vector<float>> fit_values;
-  int nchnls = chnlvector.size();
-  for (int m = 0; m < nchnls; m++)
+  CaloWaveformBuffer waveforms;
+  waveforms.assign(chnlvector);
+  calo_processing_fast(waveforms);
+  return waveforms.get_results();
+}
+
+void CaloWaveformFitting::calo_processing_fast(CaloWaveformBuffer &waveforms)
+{
+  waveforms.init_results();
+  for (size_t m = 0; m < waveforms.size(); m++)
   {
-    const std::vector<float> &v = chnlvector.at(m);
-    int nsamples = v.size();
+    process_channel_fast(waveforms.samples(m), waveforms.results(m));
+  }
+}
 
-    double maxy = v.at(0);
-    float amp = 0;
-    float time = 0;
-    float ped = 0;
-    float chi2 = std::numeric_limits<float>::quiet_NaN();
-    if (nsamples == 2)
+void CaloWaveformFitting::process_channel_fast(std::span<const float> v, std::span<float> result)
+{
+  int nsamples = v.size();
+
+  double maxy = v[0];
+  float amp = 0;
+  float time = 0;
+  float ped = 0;
+  float chi2 = std::numeric_limits<float>::quiet_NaN();
+  if (nsamples == 2)
+  {
+    amp = v[1];
+    time = std::numeric_limits<float>::quiet_NaN();
+    ped = v[0];
+    if (v[0] != 0 && v[1] == 0)  // check if post-sample is 0, if so set high chi2
     {
-      amp = v.at(1);
-      time = std::numeric_limits<float>::quiet_NaN();
-      ped = v.at(0);
-      if (v.at(0) != 0 && v.at(1) == 0)  // check if post-sample is 0, if so set high chi2
-      {
-        chi2 = 1000000;
-      }
+      chi2 = 1000000;
     }
-    else if (nsamples >= 3)
+  }
+  else if (nsamples >= 3)
+  {
+    int maxx = 0;
+    for (int i = 0; i < nsamples; i++)
     {
-      int maxx = 0;
-      for (int i = 0; i < nsamples; i++)
+      if (i < 3)
       {
-        if (i < 3)
-        {
-          ped += v.at(i);
-        }
-        if (v.at(i) > maxy)
-        {
-          maxy = v.at(i);
-          maxx = i;
-        }
+        ped += v[i];
       }
-      ped /= 3;
-      // if maxx <=5 nsample >=10 use the last two sample for pedestal(for HCal TP)
-      if (maxx <= 5 && nsamples >= 10)
+      if (v[i] > maxy)
       {
-        ped = 0.5 * (v.at(nsamples - 2) + v.at(nsamples - 1));
-      }
-      if (maxx == 0 || maxx == nsamples - 1)
-      {
-        amp = maxy;
-        time = maxx;
-      }
-      else
-      {
-        FastMax(maxx - 1, maxx, maxx + 1, v.at(maxx - 1), v.at(maxx), v.at(maxx + 1), time, amp);
+        maxy = v[i];
+        maxx = i;
       }
     }
-    amp -= ped;
-    std::vector<float> val = {amp, time, ped, chi2, 0, 0};
-    fit_values.push_back(val);
-    val.clear();
+    ped /= 3;
+    // if maxx <=5 nsample >=10 use the last two sample for pedestal(for HCal TP)
+    if (maxx <= 5 && nsamples >= 10)
+    {
+      ped = 0.5 * (v[nsamples - 2] + v[nsamples - 1]);
+    }
+    if (maxx == 0 || maxx == nsamples - 1)
+    {
+      amp = maxy;
+      time = maxx;
+    }
+    else
+    {
+      FastMax(maxx - 1, maxx, maxx + 1, v[maxx - 1], v[maxx], v[maxx + 1], time, amp);
+    }
   }
-  return fit_values;
+  amp -= ped;
+  result[0] = amp;
+  result[1] = time;
+  result[2] = ped;
+  result[3] = chi2;
+  result[4] = 0;
+  result[5] = 0;
 }
 
 std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_nyquist(const std::vector<std::vector<float>> &chnlvector)
 {
-  std::vector<std::vector<float>> fit_values;
-  int nchnls = chnlvector.size();
-  for (int m = 0; m < nchnls; m++)
+  CaloWaveformBuffer waveforms;
+  waveforms.assign(chnlvector);
+  calo_processing_nyquist(waveforms);
+  return waveforms.get_results();
+}
+
+void CaloWaveformFitting::calo_processing_nyquist(CaloWaveformBuffer &waveforms)
+{
+  waveforms.init_results();
+  for (size_t m = 0; m < waveforms.size(); m++)
   {
-    std::vector<float> v = chnlvector.at(m);
-    int nsamples = (int) v.size();
+    process_channel_nyquist(waveforms.samples(m), waveforms.results(m));
+  }
+}
+
+void CaloWaveformFitting::process_channel_nyquist(std::span<const float> v, std::span<float> result)
+{
+  int nsamples = (int) v.size();
 
-    if (nsamples == 2)
+  if (nsamples == 2)
+  {
+    float chi2 = std::numeric_limits<float>::quiet_NaN();
+    if (v[0] != 0 && v[1] == 0)  // check if post-sample is 0, if so set high chi2
     {
-      float chi2 = std::numeric_limits<float>::quiet_NaN();
-      if (v.at(0) != 0 && v.at(1) == 0)  // check if post-sample is 0, if so set high chi2
-      {
-        chi2 = 1000000;
-      }
-      fit_values.push_back({v.at(1) - v.at(0), std::numeric_limits<float>::quiet_NaN(), v.at(0), chi2, 0, 0});
-      continue;
+      chi2 = 1000000;
     }
-
-    std::vector<float> result = NyquistInterpolation(v);
-    fit_values.push_back(result);
+    result[0] = v[1] - v[0];
+    result[1] = std::numeric_limits<float>::quiet_NaN();
+    result[2] = v[0];
+    result[3] = chi2;
+    result[4] = 0;
+    result[5] = 0;
+    return;
   }
-  return fit_values;
+
+  NyquistInterpolation(v, result);
 }
 // mabye I can find a way to make it thread safe
-std::vector<float> CaloWaveformFitting::NyquistInterpolation(std::vector<float> &vec_signal_samples)
+void CaloWaveformFitting::NyquistInterpolation(std::span<const float> vec_signal_samples, std::span<float> result)
 {
   // int N = (int) vec_signal_samples.size();
   auto max_elem_iter = std::max_element(vec_signal_samples.begin(), vec_signal_samples.end());
@@ -540,8 +545,12 @@ std::vector<float> CaloWaveformFitting::NyquistInterpolation(std::vector<float>
     float diff = vec_signal_samples[i] - template_function(xval, par);
     chi2 += diff * diff;
   }
-  std::vector<float> val = {max - pedestal, maxpos, pedestal, chi2, 0, 0};
-  return val;
+  result[0] = max - pedestal;
+  result[1] = maxpos;
+  result[2] = pedestal;
+  result[3] = chi2;
+  result[4] = 0;
+  result[5] = 0;
 }
 
 // for odd N
@@ -571,7 +580,7 @@ double CaloWaveformFitting::Dkernel(double x, int N)
   return sum;
 }
 
-float CaloWaveformFitting::stablepsinc(float time, std::vector<float> &vec_signal_samples)
+float CaloWaveformFitting::stablepsinc(float time, std::span<const float> vec_signal_samples)
 {
   int N = (int) vec_signal_samples.size();
   float sum = 0;
@@ -592,7 +601,7 @@ float CaloWaveformFitting::stablepsinc(float time, std::vector<float> &vec_signa
   return sum;
 }
 
-float CaloWaveformFitting::psinc(float time, std::vector<float> &vec_signal_samples)
+float CaloWaveformFitting::psinc(float time, std::span<const float> vec_signal_samples)
 {
   int N = (int) vec_signal_samples.size();
 
@@ -603,7 +612,7 @@ float CaloWaveformFitting::psinc(float time, std::vector<float> &vec_signal_samp
       return stablepsinc(time, vec_signal_samples);
     }
 
-    return vec_signal_samples.at(std::round(time));
+    return vec_signal_samples[static_cast<size_t>(std::round(time))];
   }
 
   float sum = 0;
@@ -705,254 +714,276 @@ double CaloWaveformFitting::SignalShape_FermiExp(double *x, double *par) //NOLIN
 
 std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_funcfit(const std::vector<std::vector<float>> &chnlvector)
 {
-  std::vector<std::vector<float>> fit_values;
-  int nchnls = chnlvector.size();
+  CaloWaveformBuffer waveforms;
+  waveforms.assign(chnlvector);
+  calo_processing_funcfit(waveforms);
+  return waveforms.get_results();
+}
 
-  for (int m = 0; m < nchnls; m++)
+void CaloWaveformFitting::calo_processing_funcfit(CaloWaveformBuffer &waveforms)
+{
+  waveforms.init_results();
+  for (size_t m = 0; m < waveforms.size(); m++)
   {
-    const std::vector<float> &v = chnlvector.at(m);
-    int nsamples = v.size();
+    process_channel_funcfit(waveforms.samples(m), waveforms.results(m));
+  }
+}
 
-    float amp = 0;
-    float time = 0;
-    float ped = 0;
-    float chi2 = std::numeric_limits<float>::quiet_NaN();
+void CaloWaveformFitting::process_channel_funcfit(std::span<const float> v, std::span<float> result)
+{
+  int nsamples = v.size();
 
-    // Handle zero-suppressed samples (2-sample case)
-    if (nsamples == _nzerosuppresssamples)
-    {
-      amp = v.at(1) - v.at(0);
-      time = std::numeric_limits<float>::quiet_NaN();
-      ped = v.at(0);
-      if (v.at(0) != 0 && v.at(1) == 0)
-      {
-        chi2 = 1000000;
-      }
-      fit_values.push_back({amp, time, ped, chi2, 0, 0});
-      continue;
-    }
+  float amp = 0;
+  float time = 0;
+  float ped = 0;
+  float chi2 = std::numeric_limits<float>::quiet_NaN();
 
-    // Find peak position and estimate pedestal
-    float maxheight = 0;
-    int maxbin = 0;
-    for (int i = 0; i < nsamples; i++)
+  // Handle zero-suppressed samples (2-sample case)
+  if (nsamples == _nzerosuppresssamples)
+  {
+    amp = v[1] - v[0];
+    time = std::numeric_limits<float>::quiet_NaN();
+    ped = v[0];
+    if (v[0] != 0 && v[1] == 0)
     {
-      if (v.at(i) > maxheight)
-      {
-        maxheight = v.at(i);
-        maxbin = i;
-      }
+      chi2 = 1000000;
     }
+    result[0] = amp;
+    result[1] = time;
+    result[2] = ped;
+    result[3] = chi2;
+    result[4] = 0;
+    result[5] = 0;
+    return;
+  }
 
-    float pedestal = 1500;
-    if (maxbin > 4)
-    {
-      pedestal = 0.5 * (v.at(maxbin - 4) + v.at(maxbin - 5));
-    }
-    else if (maxbin > 3)
+  // Find peak position and estimate pedestal
+  float maxheight = 0;
+  int maxbin = 0;
+  for (int i = 0; i < nsamples; i++)
+  {
+    if (v[i] > maxheight)
     {
-      pedestal = v.at(maxbin - 4);
+      maxheight = v[i];
+      maxbin = i;
     }
-    else
+  }
+
+  float pedestal = 1500;
+  if (maxbin > 4)
+  {
+    pedestal = 0.5 * (v[maxbin - 4] + v[maxbin - 5]);
+  }
+  else if (maxbin > 3)
+  {
+    pedestal = v[maxbin - 4];
+  }
+  else
+  {
+    pedestal = 0.5 * (v[nsamples - 3] + v[nsamples - 2]);
+  }
+
+  // Software zero suppression check
+  if ((_bdosoftwarezerosuppression && v[6] - v[0] < _nsoftwarezerosuppression) ||
+      (_maxsoftwarezerosuppression && maxheight - pedestal < _nsoftwarezerosuppression))
+  {
+    amp = v[6] - v[0];
+    time = std::numeric_limits<float>::quiet_NaN();
+    ped = v[0];
+    if (v[0] != 0 && v[1] == 0)
     {
-      pedestal = 0.5 * (v.at(nsamples - 3) + v.at(nsamples - 2));
+      chi2 = 1000000;
     }
+    result[0] = amp;
+    result[1] = time;
+    result[2] = ped;
+    result[3] = chi2;
+    result[4] = 0;
+    result[5] = 0;
+    return;
+  }
 
-    // Software zero suppression check
-    if ((_bdosoftwarezerosuppression && v.at(6) - v.at(0) < _nsoftwarezerosuppression) ||
-        (_maxsoftwarezerosuppression && maxheight - pedestal < _nsoftwarezerosuppression))
+  // Create histogram for fitting
+  TH1F h("h_funcfit", "", nsamples, -0.5, nsamples - 0.5);
+  int ndata = 0;
+  for (int i = 0; i < nsamples; ++i)
+  {
+    if ((v[i] == 16383) && _handleSaturation)
     {
-      amp = v.at(6) - v.at(0);
-      time = std::numeric_limits<float>::quiet_NaN();
-      ped = v.at(0);
-      if (v.at(0) != 0 && v.at(1) == 0)
-      {
-        chi2 = 1000000;
-      }
-      fit_values.push_back({amp, time, ped, chi2, 0, 0});
       continue;
     }
+    h.SetBinContent(i + 1, v[i]);
+    h.SetBinError(i + 1, 1);
+    ndata++;
+  }
 
-    // Create histogram for fitting
-    TH1F h("h_funcfit", "", nsamples, -0.5, nsamples - 0.5);
-    int ndata = 0;
+  // If too many saturated, use all data
+  if (ndata < (nsamples - 4))
+  {
+    ndata = nsamples;
     for (int i = 0; i < nsamples; ++i)
     {
-      if ((v.at(i) == 16383) && _handleSaturation)
-      {
-        continue;
-      }
-      h.SetBinContent(i + 1, v.at(i));
+      h.SetBinContent(i + 1, v[i]);
       h.SetBinError(i + 1, 1);
-      ndata++;
     }
+  }
+
+  double fit_amp = 0;
+  double fit_time = 0;
+  double fit_ped = 0;
+  double chi2val = 0;
+  int validfit = 0;
+  int npar = 0;
 
-    // If too many saturated, use all data
-    if (ndata < (nsamples - 4))
+  if (m_funcfit_type == POWERLAWEXP)
+  {
+    // Create fit function with 5 parameters
+    TF1 f("f_powerlaw", SignalShape_PowerLawExp, 0, nsamples, 5);
+    npar = 5;
+
+    // Set initial parameters
+    double risetime = m_powerlaw_power / m_powerlaw_decay;
+    double par[5];
+    par[0] = maxheight - pedestal;  // Amplitude
+    par[1] = maxbin - risetime;     // t0
+    par[1] = std::max<double>(par[1], 0);
+    par[2] = m_powerlaw_power;  // Power
+    par[3] = m_powerlaw_decay;  // Decay
+    par[4] = pedestal;          // Pedestal
+
+    f.SetParameters(par);
+    f.SetParLimits(0, (maxheight - pedestal) * 0.5, (maxheight - pedestal) * 10);
+    f.SetParLimits(1, 0, nsamples);
+    f.SetParLimits(2, 0, 10.0);
+    f.SetParLimits(3, 0, 10.0);
+    f.SetParLimits(4, pedestal - std::abs(maxheight - pedestal), pedestal + std::abs(maxheight - pedestal));
+
+    // Perform fit
+    TFitResultPtr fitres = h.Fit(&f, "SQRN0W", "", 0, nsamples);
+
+    // Calculate peak amplitude and time from fit parameters
+    // Peak height is (p0 * Power(p2/p3, p2)) / exp(p2)
+    fit_amp = (f.GetParameter(0) * pow(f.GetParameter(2) / f.GetParameter(3), f.GetParameter(2))) / exp(f.GetParameter(2));
+    // Peak time is t0 + power/decay
+    fit_time = f.GetParameter(1) + f.GetParameter(2) / f.GetParameter(3);
+    fit_ped = f.GetParameter(4);
+
+    // Calculate chi2
+    for (int i = 0; i < nsamples; i++)
     {
-      ndata = nsamples;
-      for (int i = 0; i < nsamples; ++i)
+      if (h.GetBinContent(i + 1) > 0)
       {
-        h.SetBinContent(i + 1, v.at(i));
-        h.SetBinError(i + 1, 1);
+        double diff = h.GetBinContent(i + 1) - f.Eval(i);
+        chi2val += diff * diff;
       }
     }
-
-    double fit_amp = 0;
-    double fit_time = 0;
-    double fit_ped = 0;
-    double chi2val = 0;
-    int validfit = 0;
-    int npar = 0;
-
-    if (m_funcfit_type == POWERLAWEXP)
-    {
-      // Create fit function with 5 parameters
-      TF1 f("f_powerlaw", SignalShape_PowerLawExp, 0, nsamples, 5);
-      npar = 5;
-
-      // Set initial parameters
-      double risetime = m_powerlaw_power / m_powerlaw_decay;
-      double par[5];
-      par[0] = maxheight - pedestal;  // Amplitude
-      par[1] = maxbin - risetime;     // t0
-      par[1] = std::max<double>(par[1], 0);
-      par[2] = m_powerlaw_power;  // Power
-      par[3] = m_powerlaw_decay;  // Decay
-      par[4] = pedestal;          // Pedestal
-
-      f.SetParameters(par);
-      f.SetParLimits(0, (maxheight - pedestal) * 0.5, (maxheight - pedestal) * 10);
-      f.SetParLimits(1, 0, nsamples);
-      f.SetParLimits(2, 0, 10.0);
-      f.SetParLimits(3, 0, 10.0);
-      f.SetParLimits(4, pedestal - std::abs(maxheight - pedestal), pedestal + std::abs(maxheight - pedestal));
-
-      // Perform fit
-      TFitResultPtr fitres = h.Fit(&f, "SQRN0W", "", 0, nsamples);
-
-      // Calculate peak amplitude and time from fit parameters
-      // Peak height is (p0 * Power(p2/p3, p2)) / exp(p2)
-      fit_amp = (f.GetParameter(0) * pow(f.GetParameter(2) / f.GetParameter(3), f.GetParameter(2))) / exp(f.GetParameter(2));
-      // Peak time is t0 + power/decay
-      fit_time = f.GetParameter(1) + f.GetParameter(2) / f.GetParameter(3);
-      fit_ped = f.GetParameter(4);
-
-      // Calculate chi2
-      for (int i = 0; i < nsamples; i++)
-      {
-        if (h.GetBinContent(i + 1) > 0)
-        {
-          double diff = h.GetBinContent(i + 1) - f.Eval(i);
-          chi2val += diff * diff;
-        }
-      }
-      if (fitres.Get()) { validfit = fitres.Get()->Status(); }
-    }
-    else if(m_funcfit_type == POWERLAWDOUBLEEXP)
-    {
-      // Create fit function with 7 parameters
-      TF1 f("f_doubleexp", SignalShape_PowerLawDoubleExp, 0, nsamples, 7);
-      npar = 7;
-
-      // Set initial parameters
-      double risetime = 2.0;
-      double par[7];
-      par[0] = (maxheight - pedestal) * 0.7;  // Amplitude
-      par[1] = maxbin - risetime;             // t0
-      par[1] = std::max<double>(par[1], 0);
-      par[2] = m_doubleexp_power;      // Power
-      par[3] = m_doubleexp_peaktime1;  // Peak Time 1
-      par[4] = pedestal;               // Pedestal
-      par[5] = m_doubleexp_ratio;      // Amplitude ratio
-      par[6] = m_doubleexp_peaktime2;  // Peak Time 2
-
-      f.SetParameters(par);
-      f.SetParLimits(0, (maxheight - pedestal) * -1.5, (maxheight - pedestal) * 1.5);
-      f.SetParLimits(1, maxbin - 3 * risetime, maxbin + risetime);
-      f.SetParLimits(2, 1, 5.0);
-      f.SetParLimits(3, risetime * 0.5, risetime * 4);
-      f.SetParLimits(4, pedestal - std::abs(maxheight - pedestal), pedestal + std::abs(maxheight - pedestal));
-      f.SetParLimits(5, 0, 1);
-      f.SetParLimits(6, risetime * 0.5, risetime * 4);
-
-      // Perform fit
-      TFitResultPtr fitres = h.Fit(&f, "SQRN0W", "", 0, nsamples);
-
-      // Find peak by evaluating the function
-      double peakpos1 = f.GetParameter(3);
-      double peakpos2 = f.GetParameter(6);
-      double max_peakpos = f.GetParameter(1) + (peakpos1 > peakpos2 ? peakpos1 : peakpos2);
-      max_peakpos = std::min<double>(max_peakpos, nsamples - 1);
-
-      fit_time = f.GetMaximumX(f.GetParameter(1), max_peakpos);
-      fit_amp = f.Eval(fit_time) - f.GetParameter(4);
-      fit_ped = f.GetParameter(4);
-
-      // Calculate chi2
-      for (int i = 0; i < nsamples; i++)
+    if (fitres.Get()) { validfit = fitres.Get()->Status(); }
+  }
+  else if(m_funcfit_type == POWERLAWDOUBLEEXP)
+  {
+    // Create fit function with 7 parameters
+    TF1 f("f_doubleexp", SignalShape_PowerLawDoubleExp, 0, nsamples, 7);
+    npar = 7;
+
+    // Set initial parameters
+    double risetime = 2.0;
+    double par[7];
+    par[0] = (maxheight - pedestal) * 0.7;  // Amplitude
+    par[1] = maxbin - risetime;             // t0
+    par[1] = std::max<double>(par[1], 0);
+    par[2] = m_doubleexp_power;      // Power
+    par[3] = m_doubleexp_peaktime1;  // Peak Time 1
+    par[4] = pedestal;               // Pedestal
+    par[5] = m_doubleexp_ratio;      // Amplitude ratio
+    par[6] = m_doubleexp_peaktime2;  // Peak Time 2
+
+    f.SetParameters(par);
+    f.SetParLimits(0, (maxheight - pedestal) * -1.5, (maxheight - pedestal) * 1.5);
+    f.SetParLimits(1, maxbin - 3 * risetime, maxbin + risetime);
+    f.SetParLimits(2, 1, 5.0);
+    f.SetParLimits(3, risetime * 0.5, risetime * 4);
+    f.SetParLimits(4, pedestal - std::abs(maxheight - pedestal), pedestal + std::abs(maxheight - pedestal));
+    f.SetParLimits(5, 0, 1);
+    f.SetParLimits(6, risetime * 0.5, risetime * 4);
+
+    // Perform fit
+    TFitResultPtr fitres = h.Fit(&f, "SQRN0W", "", 0, nsamples);
+
+    // Find peak by evaluating the function
+    double peakpos1 = f.GetParameter(3);
+    double peakpos2 = f.GetParameter(6);
+    double max_peakpos = f.GetParameter(1) + (peakpos1 > peakpos2 ? peakpos1 : peakpos2);
+    max_peakpos = std::min<double>(max_peakpos, nsamples - 1);
+
+    fit_time = f.GetMaximumX(f.GetParameter(1), max_peakpos);
+    fit_amp = f.Eval(fit_time) - f.GetParameter(4);
+    fit_ped = f.GetParameter(4);
+
+    // Calculate chi2
+    for (int i = 0; i < nsamples; i++)
+    {
+      if (h.GetBinContent(i + 1) > 0)
       {
-        if (h.GetBinContent(i + 1) > 0)
-        {
-          double diff = h.GetBinContent(i + 1) - f.Eval(i);
-          chi2val += diff * diff;
-        }
+        double diff = h.GetBinContent(i + 1) - f.Eval(i);
+        chi2val += diff * diff;
       }
-      if (fitres.Get()) { validfit = fitres.Get()->Status(); }
     }
-    else if(m_funcfit_type == FERMIEXP)
-    {
-      TF1 f("f_fermiexp", SignalShape_FermiExp, 0, nsamples, 5);
-      npar = 5;
+    if (fitres.Get()) { validfit = fitres.Get()->Status(); }
+  }
+  else if(m_funcfit_type == FERMIEXP)
+  {
+    TF1 f("f_fermiexp", SignalShape_FermiExp, 0, nsamples, 5);
+    npar = 5;
 
-      // Set initial parameters
-      double par[5];
-      par[0] = maxheight - pedestal; // Amplitude
-      par[1] = maxbin ;              // t0
-      par[2] = 1.0;                  // width
-      par[3] = 2.0;                  // Peak Time 1
-      par[4] = pedestal;             // Pedestal
+    // Set initial parameters
+    double par[5];
+    par[0] = maxheight - pedestal; // Amplitude
+    par[1] = maxbin ;              // t0
+    par[2] = 1.0;                  // width
+    par[3] = 2.0;                  // Peak Time 1
+    par[4] = pedestal;             // Pedestal
 
-      f.SetParameters(par);
-      f.SetParLimits(0, maxheight-pedestal, 3*(maxheight-pedestal));
-      f.SetParLimits(1, maxbin-1, maxbin);
-      f.SetParLimits(2, 0.025, 2.0);
-      f.SetParLimits(3, 0.5, 4.0);
-      f.SetParLimits(4, pedestal-500, pedestal+500);
+    f.SetParameters(par);
+    f.SetParLimits(0, maxheight-pedestal, 3*(maxheight-pedestal));
+    f.SetParLimits(1, maxbin-1, maxbin);
+    f.SetParLimits(2, 0.025, 2.0);
+    f.SetParLimits(3, 0.5, 4.0);
+    f.SetParLimits(4, pedestal-500, pedestal+500);
 
-      f.FixParameter(2, 0.1);  
+    f.FixParameter(2, 0.1);  
 
-      TFitResultPtr fitres = h.Fit(&f, "SQRN0W", "", 0, nsamples);
+    TFitResultPtr fitres = h.Fit(&f, "SQRN0W", "", 0, nsamples);
 
-      fit_time = f.GetParameter(1);
-      fit_amp = f.GetParameter(0);
-      fit_ped = f.GetParameter(4);
+    fit_time = f.GetParameter(1);
+    fit_amp = f.GetParameter(0);
+    fit_ped = f.GetParameter(4);
 
-      // Calculate chi2
-      for (int i = 0; i < nsamples; i++)
+    // Calculate chi2
+    for (int i = 0; i < nsamples; i++)
+    {
+      if (h.GetBinContent(i + 1) > 0)
       {
-        if (h.GetBinContent(i + 1) > 0)
-        {
-          double diff = h.GetBinContent(i + 1) - f.Eval(i);
-          chi2val += diff * diff;
-        }
+        double diff = h.GetBinContent(i + 1) - f.Eval(i);
+        chi2val += diff * diff;
       }
-      if (fitres.Get()) { validfit = fitres.Get()->Status(); }
-    }
-
-    int ndf = ndata - npar;
-    if (ndf > 0)
-    {
-      chi2val /= ndf;
-    }
-    else
-    {
-      chi2val = std::numeric_limits<double>::quiet_NaN();
     }
+    if (fitres.Get()) { validfit = fitres.Get()->Status(); }
+  }
 
-    fit_values.push_back({static_cast<float>(fit_amp), static_cast<float>(fit_time),
-                          static_cast<float>(fit_ped), static_cast<float>(chi2val), 0, static_cast<float>(validfit)});
+  int ndf = ndata - npar;
+  if (ndf > 0)
+  {
+    chi2val /= ndf;
+  }
+  else
+  {
+    chi2val = std::numeric_limits<double>::quiet_NaN();
   }
 
-  return fit_values;
+  result[0] = static_cast<float>(fit_amp);
+  result[1] = static_cast<float>(fit_time);
+  result[2] = static_cast<float>(fit_ped);
+  result[3] = static_cast<float>(chi2val);
+  result[4] = 0;
+  result[5] = static_cast<float>(validfit);
 }
@@ -1,9 +1,11 @@
 #ifndef CALORECO_CALOWAVEFORMFITTING_H
 #define CALORECO_CALOWAVEFORMFITTING_H
 
+#include <span>
 #include <string>
 #include <vector>
 
+class CaloWaveformBuffer;
 class TProfile;
 
 class CaloWaveformFitting
@@ -65,11 +67,18 @@ class CaloWaveformFitting
   }
 
   std::vector<std::vector<float>> process_waveform(std::vector<std::vector<float>> waveformvector);
+  // vector per channel interfaces, the template fit expects the channel number appended to each waveform
   std::vector<std::vector<float>> calo_processing_templatefit(std::vector<std::vector<float>> chnlvector);
   static std::vector<std::vector<float>> calo_processing_fast(const std::vector<std::vector<float>> &chnlvector);
   std::vector<std::vector<float>> calo_processing_nyquist(const std::vector<std::vector<float>> &chnlvector);
   std::vector<std::vector<float>> calo_processing_funcfit(const std::vector<std::vector<float>> &chnlvector);
 
+  // buffer interfaces, the fit results are stored in the buffer
+  void calo_processing_templatefit(CaloWaveformBuffer &waveforms);
+  static void calo_processing_fast(CaloWaveformBuffer &waveforms);
+  void calo_processing_nyquist(CaloWaveformBuffer &waveforms);
+  void calo_processing_funcfit(CaloWaveformBuffer &waveforms);
+
   void initialize_processing(const std::string &templatefile);
 
   // Power-law fit function: amplitude * (x-t0)^power * exp(-(x-t0)*decay) + pedestal
@@ -98,14 +107,20 @@ class CaloWaveformFitting
   }
 
  private:
+  // single channel processing, v are the samples and result the six fit values
+  void process_channel_templatefit(std::span<const float> v, int channel, std::span<float> result);
+  static void process_channel_fast(std::span<const float> v, std::span<float> result);
+  void process_channel_nyquist(std::span<const float> v, std::span<float> result);
+  void process_channel_funcfit(std::span<const float> v, std::span<float> result);
+
   static void FastMax(float x0, float x1, float x2, float y0, float y1, float y2, float &xmax, float &ymax);
-  std::vector<float> NyquistInterpolation(std::vector<float> &vec_signal_samples);
+  void NyquistInterpolation(std::span<const float> vec_signal_samples, std::span<float> result);
   static double Dkernelodd(double x, int N);
   static double Dkernel(double x, int N);
 
-  static float stablepsinc(float t, std::vector<float> &vec_signal_samples);
+  static float stablepsinc(float t, std::span<const float> vec_signal_samples);
 
-  static float psinc(float t, std::vector<float> &vec_signal_samples);
+  static float psinc(float t, std::span<const float> vec_signal_samples);
   double template_function(double *x, double *par);
 
   TProfile *h_template{nullptr};
@@ -1,4 +1,5 @@
 #include "CaloWaveformProcessing.h"
+#include "CaloWaveformBuffer.h"
 #include "CaloWaveformFitting.h"
 
 #include <ffamodules/CDBInterface.h>
@@ -82,134 +83,143 @@ void CaloWaveformProcessing::initialize_processing()
 
 std::vector<std::vector<float>> CaloWaveformProcessing::process_waveform(std::vector<std::vector<float>> waveformvector)
 {
-  unsigned int size1 = waveformvector.size();
-  std::vector<std::vector<float>> fitresults;
+  CaloWaveformBuffer waveforms;
+  waveforms.assign(waveformvector);
+  process_waveform(waveforms);
+  return waveforms.get_results();
+}
+
+void CaloWaveformProcessing::process_waveform(CaloWaveformBuffer &waveforms)
+{
+  waveforms.init_results();
   if (m_processingtype == CaloWaveformProcessing::TEMPLATE || m_processingtype == CaloWaveformProcessing::TEMPLATE_NOSAT)
   {
-    for (unsigned int i = 0; i < size1; i++)
-    {
-      waveformvector.at(i).push_back((float) i);
-    }
-    fitresults = m_Fitter->calo_processing_templatefit(waveformvector);
+    m_Fitter->calo_processing_templatefit(waveforms);
   }
   if (m_processingtype == CaloWaveformProcessing::ONNX)
   {
-    fitresults = CaloWaveformProcessing::calo_processing_ONNX(waveformvector);
+    calo_processing_ONNX(waveforms);
   }
   if (m_processingtype == CaloWaveformProcessing::FAST)
   {
-    fitresults = CaloWaveformFitting::calo_processing_fast(waveformvector);
+    CaloWaveformFitting::calo_processing_fast(waveforms);
   }
   if (m_processingtype == CaloWaveformProcessing::NYQUIST)
   {
-    fitresults = m_Fitter->calo_processing_nyquist(waveformvector);
+    m_Fitter->calo_processing_nyquist(waveforms);
   }
   if (m_processingtype == CaloWaveformProcessing::FUNCFIT)
   {
-    fitresults = m_Fitter->calo_processing_funcfit(waveformvector);
+    m_Fitter->calo_processing_funcfit(waveforms);
   }
-  return fitresults;
 }
 
 std::vector<std::vector<float>> CaloWaveformProcessing::calo_processing_ONNX(const std::vector<std::vector<float>> &chnlvector)
 {
-  std::vector<std::vector<float>> fit_values;
-  std::vector<float> val;  // single row to return
-  unsigned int nchnls = chnlvector.size();
-  for (unsigned int m = 0; m < nchnls; m++)
-  {
-    val.clear();
-    const std::vector<float> &v = chnlvector.at(m);
-    int size1 = v.size();
-    if (size1 == _nzerosuppresssamples)
+  CaloWaveformBuffer waveforms;
+  waveforms.assign(chnlvector);
+  calo_processing_ONNX(waveforms);
+  return waveforms.get_results();
+}
+
+void CaloWaveformProcessing::calo_processing_ONNX(CaloWaveformBuffer &waveforms)
+{
+  waveforms.init_results();
+  for (size_t m = 0; m < waveforms.size(); m++)
+  {
+    process_channel_ONNX(waveforms.samples(m), waveforms.results(m));
+  }
+}
+
+void CaloWaveformProcessing::process_channel_ONNX(std::span<const float> v, std::span<float> result)
+{
+  int size1 = v.size();
+  if (size1 == _nzerosuppresssamples)
+  {
+    result[0] = v[1] - v[0];
+    result[1] = std::numeric_limits<float>::quiet_NaN();
+    result[2] = v[0];
+    if (v[0] != 0 && v[1] == 0)  // check if post-sample is 0, if so set high chi2
+    {
+      result[3] = 1000000;
+    }
+    else
+    {
+      result[3] = std::numeric_limits<float>::quiet_NaN();
+    }
+    result[4] = 0;
+    result[5] = 0;
+    return;
+  }
+
+  float maxheight = 0;
+  int maxbin = 0;
+  for (int i = 0; i < size1; i++)
+  {
+    if (v[i] > maxheight)
+    {
+      maxheight = v[i];
+      maxbin = i;
+    }
+  }
+  float pedestal = 1500;
+  if (maxbin > 4)
+  {
+    pedestal = 0.5 * (v[maxbin - 4] + v[maxbin - 5]);
+  }
+  else if (maxbin > 3)
+  {
+    pedestal = (v[maxbin - 4]);
+  }
+  else
+  {
+    pedestal = 0.5 * (v[size1 - 3] + v[size1 - 2]);
+  }
+
+  if ((_bdosoftwarezerosuppression && v[6] - v[0] < _nsoftwarezerosuppression) || (_maxsoftwarezerosuppression && maxheight - pedestal < _nsoftwarezerosuppression))
+  {
+    result[0] = v[6] - v[0];
+    result[1] = std::numeric_limits<float>::quiet_NaN();
+    result[2] = v[0];
+    if (v[0] != 0 && v[1] == 0)  // check if post-sample is 0, if so set high chi2
     {
-      val.push_back(v.at(1) - v.at(0));
-      val.push_back(std::numeric_limits<float>::quiet_NaN());
-      val.push_back(v.at(0));
-      if (v.at(0) != 0 && v.at(1) == 0)  // check if post-sample is 0, if so set high chi2
-      {
-        val.push_back(1000000);
-      }
-      else
-      {
-        val.push_back(std::numeric_limits<float>::quiet_NaN());
-      }
-      val.push_back(0);
-      val.push_back(0);
-      fit_values.push_back(val);
+      result[3] = 1000000;
     }
     else
     {
-      float maxheight = 0;
-      int maxbin = 0;
-      for (int i = 0; i < size1; i++)
-      {
-        if (v.at(i) > maxheight)
-        {
-          maxheight = v.at(i);
-          maxbin = i;
-        }
-      }
-      float pedestal = 1500;
-      if (maxbin > 4)
-      {
-        pedestal = 0.5 * (v.at(maxbin - 4) + v.at(maxbin - 5));
-      }
-      else if (maxbin > 3)
-      {
-        pedestal = (v.at(maxbin - 4));
-      }
-      else
-      {
-        pedestal = 0.5 * (v.at(size1 - 3) + v.at(size1 - 2));
-      }
-
-      if ((_bdosoftwarezerosuppression && v.at(6) - v.at(0) < _nsoftwarezerosuppression) || (_maxsoftwarezerosuppression && maxheight - pedestal < _nsoftwarezerosuppression))
-      {
-        val.push_back(v.at(6) - v.at(0));
-        val.push_back(std::numeric_limits<float>::quiet_NaN());
-        val.push_back(v.at(0));
-        if (v.at(0) != 0 && v.at(1) == 0)  // check if post-sample is 0, if so set high chi2
-        {
-          val.push_back(1000000);
-        }
-        else
-        {
-          val.push_back(std::numeric_limits<float>::quiet_NaN());
-        }
-        val.push_back(0);
-        val.push_back(0);
-        fit_values.push_back(val);
-      }
-      else
-      {
-        unsigned int nsamples = v.size();
-        if (nsamples == 12)
-        {
-          // downstream onnx does not have a static input vector API,
-          // so we need to make a copy
-          std::vector<float> vtmp(v);  // NOLINT(performance-unnecessary-copy-initialization)
-          val = onnxInference(onnxmodule, vtmp, 1, onnxlib::n_input, onnxlib::n_output);
-          unsigned int nvals = val.size();
-          for (unsigned int i = 0; i < nvals; i++)
-          {
-            val.at(i) = val.at(i) * m_Onnx_factor.at(i) + m_Onnx_offset.at(i);
-          }
-          val.push_back(2000);
-          val.push_back(0);
-          val.push_back(0);
-          fit_values.push_back(val);
-        }
-        else
-        {
-          float v_diff = v[1] - v[0];
-          std::vector<float> val1{v_diff, std::numeric_limits<float>::quiet_NaN(), v[1], std::numeric_limits<float>::quiet_NaN(), 0, 0};
-          fit_values.push_back(val1);
-        }
-      }
+      result[3] = std::numeric_limits<float>::quiet_NaN();
+    }
+    result[4] = 0;
+    result[5] = 0;
+    return;
+  }
+
+  unsigned int nsamples = v.size();
+  if (nsamples == 12)
+  {
+    // downstream onnx does not have a static input vector API,
+    // so we need to make a copy
+    std::vector<float> vtmp(v.begin(), v.end());
+    std::vector<float> val = onnxInference(onnxmodule, vtmp, 1, onnxlib::n_input, onnxlib::n_output);
+    unsigned int nvals = val.size();
+    for (unsigned int i = 0; i < nvals; i++)
+    {
+      val.at(i) = val.at(i) * m_Onnx_factor.at(i) + m_Onnx_offset.at(i);
     }
+    val.push_back(2000);
+    val.push_back(0);
+    val.push_back(0);
+    std::copy_n(val.begin(), std::min<size_t>(val.size(), result.size()), result.begin());
+  }
+  else
+  {
+    result[0] = v[1] - v[0];
+    result[1] = std::numeric_limits<float>::quiet_NaN();
+    result[2] = v[1];
+    result[3] = std::numeric_limits<float>::quiet_NaN();
+    result[4] = 0;
+    result[5] = 0;
   }
-  return fit_values;
 }
 
 int CaloWaveformProcessing::get_nthreads()
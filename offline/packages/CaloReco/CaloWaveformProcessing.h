@@ -4,9 +4,11 @@
 #include <fun4all/SubsysReco.h>
 
 #include <array>
+#include <span>
 #include <string>
 #include <vector>
 
+class CaloWaveformBuffer;
 class CaloWaveformFitting;
 
 class CaloWaveformProcessing : public SubsysReco
@@ -99,6 +101,10 @@ class CaloWaveformProcessing : public SubsysReco
   std::vector<std::vector<float>> process_waveform(std::vector<std::vector<float>> waveformvector);
   std::vector<std::vector<float>> calo_processing_ONNX(const std::vector<std::vector<float>> &chnlvector);
 
+  //! process all channels of the buffer, the fit results are stored in the buffer
+  void process_waveform(CaloWaveformBuffer &waveforms);
+  void calo_processing_ONNX(CaloWaveformBuffer &waveforms);
+
   void initialize_processing();
 
   // onnx options
@@ -106,6 +112,8 @@ class CaloWaveformProcessing : public SubsysReco
   void set_onnx_offset(const int i, const double val) { m_Onnx_offset.at(i) = val; }
 
  private:
+  void process_channel_ONNX(std::span<const float> v, std::span<float> result);
+
   CaloWaveformFitting *m_Fitter{nullptr};
 
   CaloWaveformProcessing::process m_processingtype{CaloWaveformProcessing::TEMPLATE};
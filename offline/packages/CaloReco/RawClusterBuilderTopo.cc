@@ -20,13 +20,14 @@
 #include <phool/getClass.h>
 #include <phool/phool.h>
 
+#include <omp.h>
+
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>  // for abs
 #include <exception>
 #include <iostream>
 #include <iterator>  // for begin, end
-#include <list>
 #include <memory>  // for allocator_traits<>::valu...
 #include <stdexcept>
 #include <utility>
@@ -198,24 +199,50 @@ std::vector<int> RawClusterBuilderTopo::get_adjacent_towers_by_ID(int ID)
   return adjacent_towers;
 }
 
-void RawClusterBuilderTopo::export_single_cluster(const std::vector<int> &original_towers)
+void RawClusterBuilderTopo::init_geometry()
+{
+  // HCal IDs come before the first EMCal ID, the EMCal ones follow
+  const int n_EM_towers = _EMCAL_NETA * _EMCAL_NPHI;
+  const int n_IDs = std::max(2 * _HCAL_NETA * _HCAL_NPHI, n_EM_towers) + n_EM_towers;
+
+  _TOWER_E.assign(n_IDs, 0);
+  _TOWER_KEY.assign(n_IDs, 0);
+  _TOWER_STATUS.assign(n_IDs, -2);
+
+  // tabulate adjacent towers, IDs which do not correspond to a tower have none
+  _adjacent_offsets.assign(n_IDs + 1, 0);
+  _adjacent_IDs.clear();
+  for (int ID = 0; ID < n_IDs; ID++)
+  {
+    const bool is_tower = (ID < n_EM_towers) ? (ID < 2 * _HCAL_NETA * _HCAL_NPHI) : true;
+    if (is_tower)
+    {
+      const std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(ID);
+      _adjacent_IDs.insert(_adjacent_IDs.end(), adjacent_tower_IDs.begin(), adjacent_tower_IDs.end());
+    }
+    _adjacent_offsets[ID + 1] = _adjacent_IDs.size();
+  }
+}
+
+void RawClusterBuilderTopo::export_single_cluster(const std::vector<int> &original_towers, SplitScratch &scratch, std::vector<OutputCluster> &output)
 {
   if (Verbosity() > 2)
   {
     std::cout << "RawClusterBuilderTopo::export_single_cluster called " << std::endl;
   }
 
-  std::map<int, std::pair<int, int> > tower_ownership;
   for (const int &original_tower : original_towers)
   {
-    tower_ownership[original_tower] = std::pair<int, int>(0, -1);  // all towers owned by cluster 0
+    // all towers owned by cluster 0
+    scratch.owner_first[original_tower] = 0;
+    scratch.owner_second[original_tower] = -1;
   }
-  export_clusters(original_towers, tower_ownership, 1, std::vector<float>(), std::vector<float>(), std::vector<float>());
+  export_clusters(original_towers, scratch, 1, output);
 
   return;
 }
 
-void RawClusterBuilderTopo::export_clusters(const std::vector<int> &original_towers, std::map<int, std::pair<int, int> > tower_ownership, unsigned int n_clusters, const std::vector<float> &pseudocluster_sumE, const std::vector<float> &pseudocluster_eta, const std::vector<float> &pseudocluster_phi)
+void RawClusterBuilderTopo::export_clusters(const std::vector<int> &original_towers, const SplitScratch &scratch, unsigned int n_clusters, std::vector<OutputCluster> &clusters)
 {
   if (n_clusters != 1)  // if we didn't just pass down from export_single_cluster
   {
@@ -224,60 +251,48 @@ void RawClusterBuilderTopo::export_clusters(const std::vector<int> &original_tow
       std::cout << "RawClusterBuilderTopo::export_clusters called on an initial cluster with " << n_clusters << " final clusters " << std::endl;
     }
   }
-  // build a RawCluster for output
-  std::vector<RawCluster *> clusters;
-  std::vector<float> clusters_E;
-  std::vector<float> clusters_absE;
-  std::vector<float> clusters_x;
-  std::vector<float> clusters_y;
-  std::vector<float> clusters_z;
-
-  for (unsigned int pc = 0; pc < n_clusters; pc++)
-  {
-    clusters.push_back(new RawClusterv1());
-    clusters_E.push_back(0);
-    clusters_absE.push_back(0);
-    clusters_x.push_back(0);
-    clusters_y.push_back(0);
-    clusters_z.push_back(0);
-  }
+  const std::vector<float> &pseudocluster_sumE = scratch.pseudocluster_sumE;
+  const std::vector<float> &pseudocluster_eta = scratch.pseudocluster_eta;
+  const std::vector<float> &pseudocluster_phi = scratch.pseudocluster_phi;
+
+  // clusters are accumulated here, and copied to RawClusters once all of them are known
+  clusters.resize(n_clusters);
 
   for (int original_tower : original_towers)
   {
     int this_ID = original_tower;
-    std::pair<int, int> the_pair = tower_ownership[this_ID];
+    std::pair<int, int> the_pair(scratch.owner_first[this_ID], scratch.owner_second[this_ID]);
 
     if (Verbosity() > 5)
     {
       std::cout << "RawClusterBuilderTopo::export_clusters -> assigning tower " << original_tower << " with ownership ( " << the_pair.first << ", " << the_pair.second << " ) " << std::endl;
     }
-    int this_ieta = get_ieta_from_ID(this_ID);
-    int this_iphi = get_iphi_from_ID(this_ID);
+    if (the_pair.first < 0 || the_pair.first >= (int) n_clusters)
+    {
+      if (Verbosity() > 2)
+      {
+        std::cout << "RawClusterBuilderTopo::export_clusters -> ERROR! tower " << original_tower << " is not owned by any pseudocluster, skipping it " << std::endl;
+      }
+      continue;
+    }
     int this_layer = get_ilayer_from_ID(this_ID);
     float this_E = get_E_from_ID(this_ID);
 
-    int this_key = 0;
-    if (this_layer == 2)
-    {
-      this_key = _EMTOWERMAP_KEY_ETA_PHI[this_ieta][this_iphi];
-    }
-    else
-    {
-      this_key = _TOWERMAP_KEY_LAYER_ETA_PHI[this_layer][this_ieta][this_iphi];
-    }
+    int this_key = _TOWER_KEY[this_ID];
 
     RawTowerGeom *tower_geom = _geom_containers[this_layer]->get_tower_geometry(this_key);
 
     if (the_pair.second == -1)
     {
       // assigned only to one cluster, easy
-      clusters[the_pair.first]->addTower(this_key, this_E);
-      clusters_E[the_pair.first] = clusters_E[the_pair.first] + this_E;
-      clusters_absE[the_pair.first] = clusters_absE[the_pair.first] + std::fabs(this_E);
+      OutputCluster &cluster = clusters[the_pair.first];
+      cluster.towers.emplace_back(this_key, this_E);
+      cluster.E = cluster.E + this_E;
+      cluster.absE = cluster.absE + std::fabs(this_E);
       // calculate position mean using absolute energy as weights
-      clusters_x[the_pair.first] = clusters_x[the_pair.first] + std::fabs(this_E) * tower_geom->get_center_x();
-      clusters_y[the_pair.first] = clusters_y[the_pair.first] + std::fabs(this_E) * tower_geom->get_center_y();
-      clusters_z[the_pair.first] = clusters_z[the_pair.first] + std::fabs(this_E) * tower_geom->get_center_z();
+      cluster.x = cluster.x + std::fabs(this_E) * tower_geom->get_center_x();
+      cluster.y = cluster.y + std::fabs(this_E) * tower_geom->get_center_y();
+      cluster.z = cluster.z + std::fabs(this_E) * tower_geom->get_center_z();
 
       if (Verbosity() > 5)
       {
@@ -296,1135 +311,1150 @@ void RawClusterBuilderTopo::export_clusters(const std::vector<int> &original_tow
       {
         std::cout << " tower ID " << this_ID << " has dR1 = " << dR1 << " to pseudocluster " << the_pair.first << " , and dR2 = " << dR2 << " to pseudocluster " << the_pair.second << ", so frac1 = " << frac1 << std::endl;
       }
-      clusters[the_pair.first]->addTower(this_key, this_E * frac1);
-      clusters_E[the_pair.first] = clusters_E[the_pair.first] + this_E * frac1;
-      clusters_absE[the_pair.first] = clusters_absE[the_pair.first] + std::fabs(this_E) * frac1;
-      clusters_x[the_pair.first] = clusters_x[the_pair.first] + std::fabs(this_E) * tower_geom->get_center_x() * frac1;
-      clusters_y[the_pair.first] = clusters_y[the_pair.first] + std::fabs(this_E) * tower_geom->get_center_y() * frac1;
-      clusters_z[the_pair.first] = clusters_z[the_pair.first] + std::fabs(this_E) * tower_geom->get_center_z() * frac1;
-
-      clusters[the_pair.second]->addTower(this_key, this_E * (1 - frac1));
-      clusters_E[the_pair.second] = clusters_E[the_pair.second] + this_E * (1 - frac1);
-      clusters_absE[the_pair.second] = clusters_absE[the_pair.second] + std::fabs(this_E) * (1 - frac1);
-      clusters_x[the_pair.second] = clusters_x[the_pair.second] + std::fabs(this_E) * tower_geom->get_center_x() * (1 - frac1);
-      clusters_y[the_pair.second] = clusters_y[the_pair.second] + std::fabs(this_E) * tower_geom->get_center_y() * (1 - frac1);
-      clusters_z[the_pair.second] = clusters_z[the_pair.second] + std::fabs(this_E) * tower_geom->get_center_z() * (1 - frac1);
+      OutputCluster &cluster1 = clusters[the_pair.first];
+      cluster1.towers.emplace_back(this_key, this_E * frac1);
+      cluster1.E = cluster1.E + this_E * frac1;
+      cluster1.absE = cluster1.absE + std::fabs(this_E) * frac1;
+      cluster1.x = cluster1.x + std::fabs(this_E) * tower_geom->get_center_x() * frac1;
+      cluster1.y = cluster1.y + std::fabs(this_E) * tower_geom->get_center_y() * frac1;
+      cluster1.z = cluster1.z + std::fabs(this_E) * tower_geom->get_center_z() * frac1;
+
+      OutputCluster &cluster2 = clusters[the_pair.second];
+      cluster2.towers.emplace_back(this_key, this_E * (1 - frac1));
+      cluster2.E = cluster2.E + this_E * (1 - frac1);
+      cluster2.absE = cluster2.absE + std::fabs(this_E) * (1 - frac1);
+      cluster2.x = cluster2.x + std::fabs(this_E) * tower_geom->get_center_x() * (1 - frac1);
+      cluster2.y = cluster2.y + std::fabs(this_E) * tower_geom->get_center_y() * (1 - frac1);
+      cluster2.z = cluster2.z + std::fabs(this_E) * tower_geom->get_center_z() * (1 - frac1);
     }
   }
 
-  // iterate through and add to official container
+  return;
+}
 
-  for (unsigned int cl = 0; cl < n_clusters; cl++)
+void RawClusterBuilderTopo::save_clusters(const std::vector<OutputCluster> &clusters)
+{
+  // iterate through and add to official container
+  for (const OutputCluster &cluster : clusters)
   {
-    if (clusters_absE[cl] < _min_cluster_E)
+    if (cluster.absE < _min_cluster_E)
     {
       if (Verbosity() > 2)
       {
-        std::cout << "RawClusterBuilderTopo::export_clusters: skipping cluster with E = " << clusters_E[cl] << " and absE = " << clusters_absE[cl] << " due to low energy " << std::endl;
+        std::cout << "RawClusterBuilderTopo::export_clusters: skipping cluster with E = " << cluster.E << " and absE = " << cluster.absE << " due to low energy " << std::endl;
       }
       continue;
     }
-    clusters[cl]->set_energy(clusters_E[cl]);
+    RawCluster *rawcluster = new RawClusterv1();
+    for (const auto &[key, E] : cluster.towers)
+    {
+      rawcluster->addTower(key, E);
+    }
+    rawcluster->set_energy(cluster.E);
 
-    float mean_x = clusters_x[cl] / clusters_absE[cl];
-    float mean_y = clusters_y[cl] / clusters_absE[cl];
-    float mean_z = clusters_z[cl] / clusters_absE[cl];
+    float mean_x = cluster.x / cluster.absE;
+    float mean_y = cluster.y / cluster.absE;
+    float mean_z = cluster.z / cluster.absE;
 
-    clusters[cl]->set_r(std::sqrt((mean_y * mean_y) + (mean_x * mean_x)));
-    clusters[cl]->set_phi(std::atan2(mean_y, mean_x));
-    clusters[cl]->set_z(mean_z);
+    rawcluster->set_r(std::sqrt((mean_y * mean_y) + (mean_x * mean_x)));
+    rawcluster->set_phi(std::atan2(mean_y, mean_x));
+    rawcluster->set_z(mean_z);
 
-    _clusters->AddCluster(clusters[cl]);
+    _clusters->AddCluster(rawcluster);
 
     if (Verbosity() > 1)
     {
-      std::cout << "RawClusterBuilderTopo::export_clusters: added cluster with E = " << clusters_E[cl] << ", eta = " << -1 * log(tan(std::atan2(std::sqrt((mean_y * mean_y) + (mean_x * mean_x)), mean_z) / 2.0)) << ", phi = " << std::atan2(mean_y, mean_x) << std::endl;
+      std::cout << "RawClusterBuilderTopo::export_clusters: added cluster with E = " << cluster.E << ", eta = " << -1 * log(tan(std::atan2(std::sqrt((mean_y * mean_y) + (mean_x * mean_x)), mean_z) / 2.0)) << ", phi = " << std::atan2(mean_y, mean_x) << std::endl;
     }
   }
 
   return;
 }
 
-RawClusterBuilderTopo::RawClusterBuilderTopo(const std::string &name)
-  : SubsysReco(name)
-{
-  // geometry defined at run-time
-
-  std::fill(std::begin(_geom_containers), std::end(_geom_containers), nullptr);
-  _noise_LAYER[0] = 0.0025;
-  _noise_LAYER[1] = 0.006;
-  _noise_LAYER[2] = 0.03;  // EM
-
-  _local_max_minE_LAYER[0] = 1;
-  _local_max_minE_LAYER[1] = 1;
-  _local_max_minE_LAYER[2] = 1;
-}
-
-int RawClusterBuilderTopo::InitRun(PHCompositeNode *topNode)
-{
-  try
-  {
-    CreateNodes(topNode);
-  }
-  catch (std::exception &e)
-  {
-    std::cout << PHWHERE << ": " << e.what() << std::endl;
-    throw;
-  }
-
-  if (Verbosity() > 0)
-  {
-    std::cout << "RawClusterBuilderTopo::InitRun: initialized with EMCal enable = " << _enable_EMCal << " and I+OHCal enable = " << _enable_HCal << std::endl;
-    std::cout << "RawClusterBuilderTopo::InitRun: initialized with sigma_noise in EMCal / IHCal / OHCal = " << _noise_LAYER[2] << " / " << _noise_LAYER[0] << " / " << _noise_LAYER[1] << std::endl;
-    std::cout << "RawClusterBuilderTopo::InitRun: initialized with noise multiples for seeding / growth / perimeter ( S / N / P ) = " << _sigma_seed << " / " << _sigma_grow << " / " << _sigma_peri << std::endl;
-    std::cout << "RawClusterBuilderTopo::InitRun: initialized with allow_corner_neighbor = " << _allow_corner_neighbor << " (in HCal)" << std::endl;
-    std::cout << "RawClusterBuilderTopo::InitRun: initialized with use_absE = " << _use_absE << std::endl;
-    std::cout << "RawClusterBuilderTopo::InitRun: initialized with do_split = " << _do_split << " , R_shower = " << _R_shower << " (angular units) " << std::endl;
-    std::cout << "RawClusterBuilderTopo::InitRun: initialized with minE for local max in EMCal / IHCal / OHCal = " << _local_max_minE_LAYER[2] << " / " << _local_max_minE_LAYER[0] << " / " << _local_max_minE_LAYER[1] << std::endl;
-  }
-
-  return Fun4AllReturnCodes::EVENT_OK;
-}
-
-int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
+void RawClusterBuilderTopo::split_cluster(int cl, const std::vector<int> &original_towers, SplitScratch &scratch, std::vector<OutputCluster> &output)
 {
-
-  std::string towerinfoNodenameEM = "TOWERINFO_CALIB_CEMC";
-  std::string towerinfoNodenameIH = "TOWERINFO_CALIB_HCALIN";
-  std::string towerinfoNodenameOH = "TOWERINFO_CALIB_HCALOUT";
-  if (!_inputnodeprefix.empty())
+  if (!_do_split)
   {
-    towerinfoNodenameEM = _inputnodeprefix + "_CEMC";
-    towerinfoNodenameIH = _inputnodeprefix + "_HCALIN";
-    towerinfoNodenameOH = _inputnodeprefix + "_HCALOUT";
+    // don't run splitting, just export entire cluster as it is
+    if (Verbosity() > 2)
+    {
+      std::cout << "RawClusterBuilderTopo::process_event: splitting step disabled, cluster " << cl << " is final" << std::endl;
+    }
+    export_single_cluster(original_towers, scratch, output);
+    return;
   }
 
-  TowerInfoContainer *towerinfosEM = findNode::getClass<TowerInfoContainer>(topNode, towerinfoNodenameEM);
-  TowerInfoContainer *towerinfosIH = findNode::getClass<TowerInfoContainer>(topNode, towerinfoNodenameIH);
-  TowerInfoContainer *towerinfosOH = findNode::getClass<TowerInfoContainer>(topNode, towerinfoNodenameOH);
+  std::vector<std::pair<int, float> > &local_maxima_ID = scratch.local_maxima_ID;
+  local_maxima_ID.clear();
 
-  if (!towerinfosEM)
-  {
-    std::cout << " RawClusterBuilderTopo::process_event : container TOWERINFO_CALIB_CEMC does not exist, aborting " << std::endl;
-    return Fun4AllReturnCodes::ABORTEVENT;
-  }
-  if (!towerinfosIH)
-  {
-    std::cout << " RawClusterBuilderTopo::process_event : container TOWERINFO_CALIB_HCALIN does not exist, aborting " << std::endl;
-    return Fun4AllReturnCodes::ABORTEVENT;
-  }
-  if (!towerinfosOH)
+  // iterate through each tower, looking for maxima
+  for (int tower_ID : original_towers)
   {
-    std::cout << " RawClusterBuilderTopo::process_event : container TOWERINFO_CALIB_HCALOUT does not exist, aborting " << std::endl;
-    return Fun4AllReturnCodes::ABORTEVENT;
-  }
+    if (Verbosity() > 10)
+    {
+      std::cout << " -> examining tower ID " << tower_ID << " for possible local maximum " << std::endl;
+    }
 
-  _geom_containers[0] = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
-  _geom_containers[1] = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALOUT");
-  _geom_containers[2] = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_CEMC");
+    // check minimum energy
+    if (get_E_from_ID(tower_ID) < _local_max_minE_LAYER[get_ilayer_from_ID(tower_ID)])
+    {
+      if (Verbosity() > 10)
+      {
+        std::cout << " -> -> energy E = " << get_E_from_ID(tower_ID) << " < " << _local_max_minE_LAYER[get_ilayer_from_ID(tower_ID)] << " too low" << std::endl;
+      }
+      continue;
+    }
 
-  if (!_geom_containers[0])
-  {
-    std::cout << " RawClusterBuilderTopo::process_event : container TOWERGEOM_HCALIN does not exist, aborting " << std::endl;
-    return Fun4AllReturnCodes::ABORTEVENT;
-  }
-  if (!_geom_containers[1])
-  {
-    std::cout << " RawClusterBuilderTopo::process_event : container TOWERGEOM_HCALOUT does not exist, aborting " << std::endl;
-    return Fun4AllReturnCodes::ABORTEVENT;
-  }
-  if (!_geom_containers[2])
-  {
-    std::cout << " RawClusterBuilderTopo::process_event : container TOWERGEOM_CEMC does not exist, aborting " << std::endl;
-    return Fun4AllReturnCodes::ABORTEVENT;
-  }
+    // examine neighbors
+    int neighbors_in_cluster = 0;
 
-  if (Verbosity() > 10)
-  {
-    std::cout << "RawClusterBuilderTopo::process_event: " << towerinfosEM->size() << " TOWERINFO_CALIB_CEMC towers" << std::endl;
-    std::cout << "RawClusterBuilderTopo::process_event: " << towerinfosIH->size() << " TOWERINFO_CALIB_HCALIN towers" << std::endl;
-    std::cout << "RawClusterBuilderTopo::process_event: " << towerinfosOH->size() << " TOWERINFO_CALIB_HCALOUT towers" << std::endl;
+    // check for higher neighbor
+    bool has_higher_neighbor = false;
+    for (int this_adjacent_tower_ID : get_adjacent_towers(tower_ID))
+    {
+      if (get_status_from_ID(this_adjacent_tower_ID) != cl)
+      {
+        continue;  // only consider neighbors in cluster, obviously
+      }
 
-    std::cout << "RawClusterBuilderTopo::process_event: pointer to TOWERGEOM_CEMC: " << _geom_containers[2] << std::endl;
-    std::cout << "RawClusterBuilderTopo::process_event: pointer to TOWERGEOM_HCALIN: " << _geom_containers[0] << std::endl;
-    std::cout << "RawClusterBuilderTopo::process_event: pointer to TOWERGEOM_HCALOUT: " << _geom_containers[1] << std::endl;
-  }
+      neighbors_in_cluster++;
 
-  if (_EMCAL_NETA < 0)
-  {
-    // define geometry only once if it has not been yet
-    _EMCAL_NETA = _geom_containers[2]->get_etabins();
-    _EMCAL_NPHI = _geom_containers[2]->get_phibins();
+      if (get_E_from_ID(this_adjacent_tower_ID) > get_E_from_ID(tower_ID))
+      {
+        if (Verbosity() > 10)
+        {
+          std::cout << " -> -> has higher-energy neighbor ID / E = " << this_adjacent_tower_ID << " / " << get_E_from_ID(this_adjacent_tower_ID) << std::endl;
+        }
+        has_higher_neighbor = true;  // at this point we can break -- we won't need to count the number of good neighbors, since we won't even pass the E_neighbor test
+        break;
+      }
+    }
 
-    _EMTOWERMAP_STATUS_ETA_PHI.resize(_EMCAL_NETA, std::vector<int>(_EMCAL_NPHI, -2));
-    _EMTOWERMAP_KEY_ETA_PHI.resize(_EMCAL_NETA, std::vector<int>(_EMCAL_NPHI, 0));
-    _EMTOWERMAP_E_ETA_PHI.resize(_EMCAL_NETA, std::vector<float>(_EMCAL_NPHI, 0));
-  }
+    if (has_higher_neighbor)
+    {
+      continue;  // if we broke out, now continue
+    }
 
-  if (_HCAL_NETA < 0)
-  {
-    // define geometry only once if it has not been yet
-    _HCAL_NETA = _geom_containers[1]->get_etabins();
-    _HCAL_NPHI = _geom_containers[1]->get_phibins();
+    // check number of neighbors
+    if (neighbors_in_cluster < 4)
+    {
+      if (Verbosity() > 10)
+      {
+        std::cout << " -> -> too few neighbors N = " << neighbors_in_cluster << std::endl;
+      }
+      continue;
+    }
 
-    _TOWERMAP_STATUS_LAYER_ETA_PHI.resize(2, std::vector<std::vector<int> >(_HCAL_NETA, std::vector<int>(_HCAL_NPHI, -2)));
-    _TOWERMAP_KEY_LAYER_ETA_PHI.resize(2, std::vector<std::vector<int> >(_HCAL_NETA, std::vector<int>(_HCAL_NPHI, 0)));
-    _TOWERMAP_E_LAYER_ETA_PHI.resize(2, std::vector<std::vector<float> >(_HCAL_NETA, std::vector<float>(_HCAL_NPHI, 0)));
+    local_maxima_ID.emplace_back(tower_ID, get_E_from_ID(tower_ID));
   }
 
-  // reset maps
-  // but note -- do not reset keys!
-  for (int ieta = 0; ieta < _EMCAL_NETA; ieta++)
+  // check for possible EMCal-OHCal seed overlaps
+  for (unsigned int n = 0; n < local_maxima_ID.size(); n++)
   {
-    for (int iphi = 0; iphi < _EMCAL_NPHI; iphi++)
+    // only look at I/OHCal local maxima
+    std::pair<int, float> this_LM = local_maxima_ID.at(n);
+    if (get_ilayer_from_ID(this_LM.first) == 2)
     {
-      _EMTOWERMAP_STATUS_ETA_PHI[ieta][iphi] = -2;  // set tower does not exist
-      _EMTOWERMAP_E_ETA_PHI[ieta][iphi] = 0;        // set zero energy
+      continue;
     }
-  }
-  for (int ilayer = 0; ilayer < 2; ilayer++)
-  {
-    for (int ieta = 0; ieta < _HCAL_NETA; ieta++)
+
+    float this_phi = _geom_containers[get_ilayer_from_ID(this_LM.first)]->get_phicenter(get_iphi_from_ID(this_LM.first));
+    if (this_phi > M_PI)
     {
-      for (int iphi = 0; iphi < _HCAL_NPHI; iphi++)
-      {
-        _TOWERMAP_STATUS_LAYER_ETA_PHI[ilayer][ieta][iphi] = -2;  // set tower does not exist
-        _TOWERMAP_E_LAYER_ETA_PHI[ilayer][ieta][iphi] = 0;        // set zero energy
-      }
+      this_phi -= 2 * M_PI;
     }
-  }
+    float this_eta = _geom_containers[get_ilayer_from_ID(this_LM.first)]->get_etacenter(get_ieta_from_ID(this_LM.first));
 
-  // setup
-  std::vector<std::pair<int, float> > list_of_seeds;
+    bool has_EM_overlap = false;
 
-  // translate towers to our internal representation
-  if (_enable_EMCal)
-  {
-    TowerInfo *towerInfo = nullptr;
-    unsigned int n_EM_towers = towerinfosEM->size();
-    for (unsigned int iEM = 0; iEM < n_EM_towers; iEM++)
+    // check all other local maxima for overlaps
+    for (unsigned int n2 = 0; n2 < local_maxima_ID.size(); n2++)
     {
-      towerInfo = towerinfosEM->get_tower_at_channel(iEM);
-      if (_only_good_towers && (!towerInfo->get_isGood()))
+      if (n == n2)
       {
-        continue;
+        continue;  // don't check the same one
       }
-      unsigned int towerinfo_key = towerinfosEM->encode_key(iEM);
-      int ti_ieta = towerinfosEM->getTowerEtaBin(towerinfo_key);
-      int ti_iphi = towerinfosEM->getTowerPhiBin(towerinfo_key);
-      const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::CEMC, ti_ieta, ti_iphi);
-
-      // RawTowerGeom *tower_geom = _geom_containers[2]->get_tower_geometry(key);
-
-      // int ieta = _geom_containers[2]->get_etabin(tower_geom->get_eta());
-      // int iphi = _geom_containers[2]->get_phibin(tower_geom->get_phi());
-
-      int ieta = ti_ieta;
-      int iphi = ti_iphi;
-
-      float this_E = towerInfo->get_energy();
 
-      // if not using abs E, short circuit all negative towers right here (same for IHCal, OHCal below)
-      if (!_use_absE && this_E < 1.E-10)
+      // only look at EMCal local mazima
+      std::pair<int, float> this_LM2 = local_maxima_ID.at(n2);
+      if (get_ilayer_from_ID(this_LM2.first) != 2)
       {
         continue;
       }
 
-      _EMTOWERMAP_STATUS_ETA_PHI[ieta][iphi] = -1;  // change status to unknown
-      _EMTOWERMAP_E_ETA_PHI[ieta][iphi] = this_E;
-      _EMTOWERMAP_KEY_ETA_PHI[ieta][iphi] = key;
+      float this_phi2 = _geom_containers[get_ilayer_from_ID(this_LM2.first)]->get_phicenter(get_iphi_from_ID(this_LM2.first));
+      if (this_phi2 > M_PI)
+      {
+        this_phi -= 2 * M_PI;
+      }
+      float this_eta2 = _geom_containers[get_ilayer_from_ID(this_LM2.first)]->get_etacenter(get_ieta_from_ID(this_LM2.first));
 
-      // use fabs() here for simplicity - if we're not using abs E, negative towers are already excluded
-      if (std::fabs(this_E) >= _sigma_seed * _noise_LAYER[2])
+      // calculate geometric dR
+      float dR = calculate_dR(this_eta, this_eta2, this_phi, this_phi2);
+
+      // check for and report overlaps
+      if (dR < 0.15)
       {
-        int ID = get_ID(2, ieta, iphi);
-        list_of_seeds.emplace_back(ID, this_E);
-        if (Verbosity() > 10)
+        has_EM_overlap = true;
+        if (Verbosity() > 2)
         {
-          std::cout << "RawClusterBuilderTopo::process_event: adding EMCal tower at ieta / iphi = " << ieta << " / " << iphi << " with E = " << this_E << std::endl;
-          std::cout << " --> ID = " << ID << " , check ilayer / ieta / iphi = " << get_ilayer_from_ID(ID) << " / " << get_ieta_from_ID(ID) << " / " << get_iphi_from_ID(ID) << std::endl;
-        };
+          std::cout << "RawClusterBuilderTopo::process_event : removing I/OHal local maximum (ID,E,phi,eta = " << this_LM.first << ", " << this_LM.second << ", " << this_phi << ", " << this_eta << "), ";
+          std::cout << "due to EM overlap (ID,E,phi,eta = " << this_LM2.first << ", " << this_LM2.second << ", " << this_phi2 << ", " << this_eta2 << "), dR = " << dR << std::endl;
+        }
+        break;
       }
     }
+
+    if (has_EM_overlap)
+    {
+      // remove the I/OHCal local maximum from the list
+      local_maxima_ID.erase(local_maxima_ID.begin() + n);
+      // make sure to back up one index...
+      n = n - 1;
+    }  // otherwise, keep this local maximum
   }
 
-  // translate towers to our internal representation
-  if (_enable_HCal)
+  // only now print out full set of local maxima
+  if (Verbosity() > 2)
   {
-    TowerInfo *towerInfo = nullptr;
-    unsigned int n_IH_towers = towerinfosIH->size();
-    for (unsigned int iIH = 0; iIH < n_IH_towers; iIH++)
+    for (auto this_LM : local_maxima_ID)
     {
-      towerInfo = towerinfosIH->get_tower_at_channel(iIH);
-      if (_only_good_towers && (!towerInfo->get_isGood()))
+      int tower_ID = this_LM.first;
+      std::cout << "RawClusterBuilderTopo::process_event in cluster " << cl << ", tower ID " << tower_ID << " is LOCAL MAXIMUM with layer / E = " << get_ilayer_from_ID(tower_ID) << " / " << get_E_from_ID(tower_ID) << ", ";
+      float this_phi = _geom_containers[get_ilayer_from_ID(tower_ID)]->get_phicenter(get_iphi_from_ID(tower_ID));
+      if (this_phi > M_PI)
       {
-        continue;
+        this_phi -= 2 * M_PI;
       }
-      unsigned int towerinfo_key = towerinfosIH->encode_key(iIH);
-      int ti_ieta = towerinfosIH->getTowerEtaBin(towerinfo_key);
-      int ti_iphi = towerinfosIH->getTowerPhiBin(towerinfo_key);
-      const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::HCALIN, ti_ieta, ti_iphi);
+      std::cout << " eta / phi = " << _geom_containers[get_ilayer_from_ID(tower_ID)]->get_etacenter(get_ieta_from_ID(tower_ID)) << " / " << this_phi << std::endl;
+    }
+  }
 
-      RawTowerGeom *tower_geom = _geom_containers[0]->get_tower_geometry(key);
+  // do we have only 1 or 0 local maxima?
+  if (local_maxima_ID.size() <= 1)
+  {
+    if (Verbosity() > 2)
+    {
+      std::cout << "RawClusterBuilderTopo::process_event cluster " << cl << " has only " << local_maxima_ID.size() << " local maxima, not splitting " << std::endl;
+    }
+    export_single_cluster(original_towers, scratch, output);
 
-      int ieta = _geom_containers[0]->get_etabin(tower_geom->get_eta());
-      int iphi = _geom_containers[0]->get_phibin(tower_geom->get_phi());
-      float this_E = towerInfo->get_energy();
+    return;
+  }
 
-      if (!_use_absE && this_E < 1.E-10)
-      {
-        continue;
-      }
+  // engage splitting procedure!
 
-      _TOWERMAP_STATUS_LAYER_ETA_PHI[0][ieta][iphi] = -1;  // change status to unknown
-      _TOWERMAP_E_LAYER_ETA_PHI[0][ieta][iphi] = this_E;
-      _TOWERMAP_KEY_LAYER_ETA_PHI[0][ieta][iphi] = key;
+  if (Verbosity() > 2)
+  {
+    std::cout << "RawClusterBuilderTopo::process_event splitting cluster " << cl << " into " << local_maxima_ID.size() << " according to local maxima!" << std::endl;
+  }
+  const int n_local_maxima = local_maxima_ID.size();
+
+  // keep track of the ownership of all cluster towers
+  // -1 means unseen
+  // -2 means seen and in the seed list now (e.g. don't add it to the seed list again)
+  // -3 shared tower, ignore going forward...
+  std::vector<int> &owner_first = scratch.owner_first;
+  std::vector<int> &owner_second = scratch.owner_second;
+  for (int original_tower : original_towers)
+  {
+    // initialize all towers as un-seen
+    owner_first[original_tower] = -1;
+    owner_second[original_tower] = -1;
+  }
+  std::vector<int> &seed_list = scratch.seed_list;
+  std::vector<int> &neighbor_list = scratch.neighbor_list;
+  std::vector<int> &shared_list = scratch.shared_list;
+  seed_list.clear();
+  neighbor_list.clear();
+  shared_list.clear();
+
+  // sort maxima before populating seed list
+  std::sort(local_maxima_ID.begin(), local_maxima_ID.end(), sort_by_pair_second);
+
+  // initialize neighbor list
+  for (int s = 0; s < n_local_maxima; s++)
+  {
+    owner_first[local_maxima_ID.at(s).first] = s;
+    owner_second[local_maxima_ID.at(s).first] = -1;
+    neighbor_list.push_back(local_maxima_ID.at(s).first);
+  }
 
-      if (std::fabs(this_E) >= _sigma_seed * _noise_LAYER[0])
-      {
-        int ID = get_ID(0, ieta, iphi);
-        list_of_seeds.emplace_back(ID, this_E);
-        if (Verbosity() > 10)
-        {
-          std::cout << "RawClusterBuilderTopo::process_event: adding IHCal tower at ieta / iphi = " << ieta << " / " << iphi << " with E = " << this_E << std::endl;
-          std::cout << " --> ID = " << ID << " , check ilayer / ieta / iphi = " << get_ilayer_from_ID(ID) << " / " << get_ieta_from_ID(ID) << " / " << get_iphi_from_ID(ID) << std::endl;
-        };
-      }
-    }
-    unsigned int n_OH_towers = towerinfosOH->size();
-    for (unsigned int iOH = 0; iOH < n_OH_towers; iOH++)
-    {
-      towerInfo = towerinfosOH->get_tower_at_channel(iOH);
-      if (_only_good_towers && (!towerInfo->get_isGood()))
-      {
-        continue;
-      }
-      unsigned int towerinfo_key = towerinfosOH->encode_key(iOH);
-      int ti_ieta = towerinfosOH->getTowerEtaBin(towerinfo_key);
-      int ti_iphi = towerinfosOH->getTowerPhiBin(towerinfo_key);
-      const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::HCALOUT, ti_ieta, ti_iphi);
-
-      RawTowerGeom *tower_geom = _geom_containers[1]->get_tower_geometry(key);
-
-      int ieta = _geom_containers[1]->get_etabin(tower_geom->get_eta());
-      int iphi = _geom_containers[1]->get_phibin(tower_geom->get_phi());
-      float this_E = towerInfo->get_energy();
-
-      if (!_use_absE && this_E < 1.E-10)
-      {
-        continue;
-      }
-
-      _TOWERMAP_STATUS_LAYER_ETA_PHI[1][ieta][iphi] = -1;  // change status to unknown
-      _TOWERMAP_E_LAYER_ETA_PHI[1][ieta][iphi] = this_E;
-      _TOWERMAP_KEY_LAYER_ETA_PHI[1][ieta][iphi] = key;
-
-      if (std::fabs(this_E) >= _sigma_seed * _noise_LAYER[1])
-      {
-        int ID = get_ID(1, ieta, iphi);
-        list_of_seeds.emplace_back(ID, this_E);
-        if (Verbosity() > 10)
-        {
-          std::cout << "RawClusterBuilderTopo::process_event: adding OHCal tower at ieta / iphi = " << ieta << " / " << iphi << " with E = " << this_E << std::endl;
-          std::cout << " --> ID = " << ID << " , check ilayer / ieta / iphi = " << get_ilayer_from_ID(ID) << " / " << get_ieta_from_ID(ID) << " / " << get_iphi_from_ID(ID) << std::endl;
-        };
-      }
-    }
-  }
-
-  if (Verbosity() > 10)
-  {
-    for (unsigned int n = 0; n < list_of_seeds.size(); n++)
-    {
-      std::cout << "RawClusterBuilderTopo::process_event: unsorted seed element n = " << n << " , ID / E = " << list_of_seeds.at(n).first << " / " << list_of_seeds.at(n).second << std::endl;
-    }
-  }
-
-  std::sort(list_of_seeds.begin(), list_of_seeds.end(), sort_by_pair_second);
-
-  if (Verbosity() > 10)
+  if (Verbosity() > 100)
   {
-    for (unsigned int n = 0; n < list_of_seeds.size(); n++)
+    for (int original_tower : original_towers)
     {
-      std::cout << "RawClusterBuilderTopo::process_event: sorted seed element n = " << n << " , ID / E = " << list_of_seeds.at(n).first << " / " << list_of_seeds.at(n).second << std::endl;
+      std::cout << " Debug Pre-Split: tower_ownership[ " << original_tower << " ] = ( " << owner_first[original_tower] << ", " << owner_second[original_tower] << " ) ";
+      std::cout << " , layer / ieta / iphi = " << get_ilayer_from_ID(original_tower) << " / " << get_ieta_from_ID(original_tower) << " / " << get_iphi_from_ID(original_tower);
+      std::cout << std::endl;
     }
   }
 
-  if (Verbosity() > 0)
-  {
-    std::cout << "RawClusterBuilderTopo::process_event: initialized with " << list_of_seeds.size() << " seeds with E > 4*sigma " << std::endl;
-  }
+  // pseudoclusters adjacent to a given tower
+  std::vector<char> &pseudocluster_adjacency = scratch.pseudocluster_adjacency;
 
-  int cluster_index = 0;  // begin counting clusters
+  std::vector<int> &new_ownerships = scratch.new_ownerships;
+  std::vector<int> &new_neighbor_list = scratch.new_neighbor_list;
 
-  std::vector<std::vector<int> > all_cluster_towers;  // store final cluster tower lists here
+  bool first_pass = true;
 
-  while (!list_of_seeds.empty())
+  do
   {
-    int seed_ID = list_of_seeds.at(0).first;
-    list_of_seeds.erase(list_of_seeds.begin());
-
-    if (Verbosity() > 5)
-    {
-      std::cout << " RawClusterBuilderTopo::process_event: in seeded loop, current seed has ID = " << seed_ID << " , length of remaining seed vector = " << list_of_seeds.size() << std::endl;
-    }
-
-    // if this seed was already claimed by some other seed during its growth, remove it and do nothing
-    int seed_status = get_status_from_ID(seed_ID);
-    if (seed_status > -1)
-    {
-      if (Verbosity() > 10)
-      {
-        std::cout << " --> already owned by cluster # " << seed_status << std::endl;
-      }
-      continue;  // go onto the next iteration of the loop
-    }
-
-    // this seed tower now owned by new cluster
-    set_status_by_ID(seed_ID, cluster_index);
-
-    std::vector<int> cluster_tower_ID;
-    cluster_tower_ID.push_back(seed_ID);
-
-    std::vector<int> grow_tower_ID;
-    grow_tower_ID.push_back(seed_ID);
-
-    // iteratively process growth towers, adding > 2 * sigma neighbors to the list for further checking
-
     if (Verbosity() > 5)
     {
-      std::cout << " RawClusterBuilderTopo::process_event: Entering Growth stage for cluster " << cluster_index << std::endl;
+      std::cout << " -> starting split loop with " << seed_list.size() << " seed, " << neighbor_list.size() << " neighbor, and " << shared_list.size() << " shared towers " << std::endl;
     }
+    // go through neighbor list, assigning ownership only via the seed list
+    new_ownerships.clear();
 
-    while (!grow_tower_ID.empty())
+    for (unsigned int n = 0; n < neighbor_list.size(); n++)
     {
-      int grow_ID = grow_tower_ID.at(0);
-      grow_tower_ID.erase(grow_tower_ID.begin());
+      int neighbor_ID = neighbor_list.at(n);
 
-      if (Verbosity() > 5)
+      if (Verbosity() > 10)
       {
-        std::cout << " --> cluster " << cluster_index << ", growth stage, examining neighbors of ID " << grow_ID << ", " << grow_tower_ID.size() << " grow towers left" << std::endl;
+        std::cout << " -> -> looking at neighbor " << n << " (tower ID " << neighbor_ID << " ) of " << neighbor_list.size() << " total" << std::endl;
       }
-
-      std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(grow_ID);
-
-      for (int this_adjacent_tower_ID : adjacent_tower_IDs)
+      if (first_pass)
       {
         if (Verbosity() > 10)
         {
-          std::cout << " --> --> --> checking possible adjacent tower with ID " << this_adjacent_tower_ID << " : ";
+          std::cout << " -> -> -> special first pass rules, this tower already owned by pseudocluster " << owner_first[neighbor_ID] << std::endl;
         }
-        int test_layer = get_ilayer_from_ID(this_adjacent_tower_ID);
+        new_ownerships.push_back(owner_first[neighbor_ID]);
+      }
+      else
+      {
+        pseudocluster_adjacency.assign(n_local_maxima, false);
 
-        // if tower does not exist, continue
-        if (get_status_from_ID(this_adjacent_tower_ID) == -2)
+        // look over all towers THIS one is adjacent to, and count up...
+        for (int this_adjacent_tower_ID : get_adjacent_towers(neighbor_ID))
         {
-          if (Verbosity() > 10)
+          if (get_status_from_ID(this_adjacent_tower_ID) != cl)
           {
-            std::cout << "does not exist " << std::endl;
+            continue;
           }
-          continue;
-        }
 
-        // if tower is owned by THIS cluster already, continue
-        if (get_status_from_ID(this_adjacent_tower_ID) == cluster_index)
-        {
-          if (Verbosity() > 10)
+          if (owner_first[this_adjacent_tower_ID] > -1)
           {
-            std::cout << "already owned by this cluster index " << cluster_index << std::endl;
+            if (Verbosity() > 20)
+            {
+              std::cout << " -> -> -> adjacent tower to this one, with ID " << this_adjacent_tower_ID << " , is owned by pseudocluster " << owner_first[this_adjacent_tower_ID] << std::endl;
+            }
+            if (owner_first[this_adjacent_tower_ID] < n_local_maxima)
+            {
+              pseudocluster_adjacency[owner_first[this_adjacent_tower_ID]] = true;
+            }
           }
-          continue;
         }
-
-        // if tower has < 2*sigma energy, continue
-        if (std::fabs(get_E_from_ID(this_adjacent_tower_ID)) < _sigma_grow * _noise_LAYER[test_layer])
+        int n_pseudocluster_adjacent = 0;
+        int last_adjacent_pseudocluster = -1;
+        for (int s = 0; s < n_local_maxima; s++)
         {
-          if (Verbosity() > 10)
+          if (pseudocluster_adjacency[s])
           {
-            std::cout << "E = " << get_E_from_ID(this_adjacent_tower_ID) << " under 2*sigma threshold " << std::endl;
+            last_adjacent_pseudocluster = s;
+            n_pseudocluster_adjacent++;
+            if (Verbosity() > 20)
+            {
+              std::cout << " -> -> adjacent to pseudocluster " << s << std::endl;
+            }
           }
-          continue;
         }
 
-        // if tower is owned by somebody else, continue (although should this really happen?)
-        if (get_status_from_ID(this_adjacent_tower_ID) > -1)
+        if (n_pseudocluster_adjacent == 0)
+        {
+          std::cout << " -> -> ERROR! How can a neighbor tower at this stage be adjacent to no pseudoclusters?? " << std::endl;
+          new_ownerships.push_back(9999);
+        }
+        else if (n_pseudocluster_adjacent == 1)
         {
           if (Verbosity() > 10)
           {
-            std::cout << "ERROR! in growth stage, encountered >2sigma tower which is already owned?!" << std::endl;
+            std::cout << " -> -> neighbor tower " << neighbor_ID << " is ONLY adjacent to one pseudocluster # " << last_adjacent_pseudocluster << std::endl;
           }
-          continue;
+          new_ownerships.push_back(last_adjacent_pseudocluster);
         }
-
-        // tower good to be added to cluster and to list of grow towers
-        grow_tower_ID.push_back(this_adjacent_tower_ID);
-        cluster_tower_ID.push_back(this_adjacent_tower_ID);
-        set_status_by_ID(this_adjacent_tower_ID, cluster_index);
-        if (Verbosity() > 10)
+        else
         {
-          std::cout << "add this tower ( ID " << this_adjacent_tower_ID << " ) to grow list " << std::endl;
+          if (Verbosity() > 10)
+          {
+            std::cout << " -> -> neighbor tower " << neighbor_ID << " is adjacent to " << n_pseudocluster_adjacent << " pseudoclusters, move to shared list " << std::endl;
+          }
+          new_ownerships.push_back(-3);
         }
       }
-
-      if (Verbosity() > 5)
-      {
-        std::cout << " --> after examining neighbors, grow list is now " << grow_tower_ID.size() << ", # of towers in cluster = " << cluster_tower_ID.size() << std::endl;
-      }
     }
 
-    // done growing cluster, now add on perimeter towers with E > 0 * sigma
     if (Verbosity() > 5)
     {
-      std::cout << " RawClusterBuilderTopo::process_event: Entering Perimeter stage for cluster " << cluster_index << std::endl;
+      std::cout << " -> now updating status of all " << neighbor_list.size() << " original neighbors " << std::endl;
     }
-    // we'll be adding on to the cluster list, so get the # of core towers first
-    int n_core_towers = cluster_tower_ID.size();
-
-    for (int ic = 0; ic < n_core_towers; ic++)
+    // transfer neighbor list to seed list or shared list
+    for (unsigned int n = 0; n < neighbor_list.size(); n++)
     {
-      int core_ID = cluster_tower_ID.at(ic);
-
-      if (Verbosity() > 5)
+      int neighbor_ID = neighbor_list.at(n);
+      if (new_ownerships.at(n) > -1)
       {
-        std::cout << " --> cluster " << cluster_index << ", perimeter stage, examining neighbors of ID " << core_ID << ", core cluster # " << ic << " of " << n_core_towers << " total " << std::endl;
+        owner_first[neighbor_ID] = new_ownerships.at(n);
+        owner_second[neighbor_ID] = -1;
+        seed_list.push_back(neighbor_ID);
+        if (Verbosity() > 20)
+        {
+          std::cout << " -> -> neighbor ID " << neighbor_ID << " has new status " << new_ownerships.at(n) << std::endl;
+        }
       }
-      std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(core_ID);
-
-      for (int this_adjacent_tower_ID : adjacent_tower_IDs)
+      if (new_ownerships.at(n) == -3)
       {
-        if (Verbosity() > 10)
+        owner_first[neighbor_ID] = -3;
+        owner_second[neighbor_ID] = -1;
+        shared_list.push_back(neighbor_ID);
+        if (Verbosity() > 20)
         {
-          std::cout << " --> --> --> checking possible adjacent tower with ID " << this_adjacent_tower_ID << " : ";
+          std::cout << " -> -> neighbor ID " << neighbor_ID << " has new status " << -3 << std::endl;
         }
+      }
+    }
 
-        int test_layer = get_ilayer_from_ID(this_adjacent_tower_ID);
-
-        // if tower does not exist, continue
-        if (get_status_from_ID(this_adjacent_tower_ID) == -2)
+    if (Verbosity() > 5)
+    {
+      std::cout << " producing a new neighbor list ... " << std::endl;
+    }
+    // populate a new neighbor list from the about-to-be-owned towers before transferring this one
+    new_neighbor_list.clear();
+    for (unsigned int n = 0; n < neighbor_list.size(); n++)
+    {
+      int neighbor_ID = neighbor_list.at(n);
+      if (new_ownerships.at(n) > -1)
+      {
+        for (int this_adjacent_tower_ID : get_adjacent_towers(neighbor_ID))
         {
-          if (Verbosity() > 10)
+          if (get_status_from_ID(this_adjacent_tower_ID) != cl)
           {
-            std::cout << "does not exist " << std::endl;
+            continue;
           }
-          continue;
-        }
-
-        // if tower is owned by somebody else (including current cluster), continue. ( allowed during perimeter fixing state )
-        if (get_status_from_ID(this_adjacent_tower_ID) > -1)
-        {
-          if (Verbosity() > 10)
+          if (owner_first[this_adjacent_tower_ID] == -1)
           {
-            std::cout << "already owned by other cluster index " << get_status_from_ID(this_adjacent_tower_ID) << std::endl;
+            new_neighbor_list.push_back(this_adjacent_tower_ID);
+            if (Verbosity() > 5)
+            {
+              std::cout << " -> queueing up to add tower " << this_adjacent_tower_ID << " , neighbor of tower " << neighbor_ID << " to new neighbor list" << std::endl;
+            }
           }
-          continue;
         }
+      }
+    }
 
-        // if tower has < 0*sigma energy, continue
-        if (std::fabs(get_E_from_ID(this_adjacent_tower_ID)) < _sigma_peri * _noise_LAYER[test_layer])
+    if (Verbosity() > 5)
+    {
+      std::cout << " new neighbor list has size " << new_neighbor_list.size() << ", but after removing duplicate elements: ";
+    }
+
+    std::sort(new_neighbor_list.begin(), new_neighbor_list.end());
+    new_neighbor_list.erase(std::unique(new_neighbor_list.begin(), new_neighbor_list.end()), new_neighbor_list.end());
+
+    if (Verbosity() > 5)
+    {
+      std::cout << new_neighbor_list.size() << std::endl;
+    }
+
+    // now transfer over new neighbor list
+    neighbor_list.swap(new_neighbor_list);
+
+    first_pass = false;
+
+  } while (!neighbor_list.empty());
+
+  if (Verbosity() > 100)
+  {
+    for (int original_tower : original_towers)
+    {
+      std::cout << " Debug Mid-Split: tower_ownership[ " << original_tower << " ] = ( " << owner_first[original_tower] << ", " << owner_second[original_tower] << " ) ";
+      std::cout << " , layer / ieta / iphi = " << get_ilayer_from_ID(original_tower) << " / " << get_ieta_from_ID(original_tower) << " / " << get_iphi_from_ID(original_tower);
+      std::cout << std::endl;
+      if (owner_first[original_tower] == -1)
+      {
+        for (int this_adjacent_tower_ID : get_adjacent_towers(original_tower))
         {
-          if (Verbosity() > 10)
+          if (get_status_from_ID(this_adjacent_tower_ID) != cl)
           {
-            std::cout << "E = " << get_E_from_ID(this_adjacent_tower_ID) << " under 0*sigma threshold " << std::endl;
+            continue;
           }
-          continue;
+          std::cout << "    -> adjacent to add tower " << this_adjacent_tower_ID << " , which has status " << owner_first[this_adjacent_tower_ID] << std::endl;
         }
+      }
+    }
+  }
 
-        // perimeter tower good to be added to cluster
-        cluster_tower_ID.push_back(this_adjacent_tower_ID);
-        set_status_by_ID(this_adjacent_tower_ID, cluster_index);
+  // calculate pseudocluster energies and positions
+  std::vector<float> &pseudocluster_sumeta = scratch.pseudocluster_sumeta;
+  std::vector<float> &pseudocluster_sumphi = scratch.pseudocluster_sumphi;
+  std::vector<float> &pseudocluster_sumE = scratch.pseudocluster_sumE;
+  std::vector<int> &pseudocluster_ntower = scratch.pseudocluster_ntower;
+  std::vector<float> &pseudocluster_eta = scratch.pseudocluster_eta;
+  std::vector<float> &pseudocluster_phi = scratch.pseudocluster_phi;
+
+  pseudocluster_sumeta.assign(n_local_maxima, 0);
+  pseudocluster_sumphi.assign(n_local_maxima, 0);
+  pseudocluster_sumE.assign(n_local_maxima, 0);
+  pseudocluster_ntower.assign(n_local_maxima, 0);
+  pseudocluster_eta.clear();
+  pseudocluster_phi.clear();
+
+  for (int original_tower : original_towers)
+  {
+    const int owner = owner_first[original_tower];
+    if (owner > -1 && owner < n_local_maxima)
+    {
+      int this_ID = original_tower;
+      pseudocluster_sumE[owner] += get_E_from_ID(this_ID);
+      float this_eta = _geom_containers[get_ilayer_from_ID(this_ID)]->get_etacenter(get_ieta_from_ID(this_ID));
+      float this_phi = _geom_containers[get_ilayer_from_ID(this_ID)]->get_phicenter(get_iphi_from_ID(this_ID));
+
+      pseudocluster_sumeta[owner] += this_eta;
+      pseudocluster_sumphi[owner] += this_phi;
+      pseudocluster_ntower[owner] += 1;
+    }
+  }
+
+  for (int pc = 0; pc < n_local_maxima; pc++)
+  {
+    pseudocluster_eta.push_back(pseudocluster_sumeta.at(pc) / pseudocluster_ntower.at(pc));
+    pseudocluster_phi.push_back(pseudocluster_sumphi.at(pc) / pseudocluster_ntower.at(pc));
+
+    if (Verbosity() > 2)
+    {
+      std::cout << "RawClusterBuilderTopo::process_event pseudocluster #" << pc << ", E / eta / phi / Ntower = " << pseudocluster_sumE.at(pc) << " / " << pseudocluster_eta.at(pc) << " / " << pseudocluster_phi.at(pc) << " / " << pseudocluster_ntower.at(pc) << std::endl;
+    }
+  }
+
+  if (Verbosity() > 2)
+  {
+    std::cout << "RawClusterBuilderTopo::process_event now splitting up shared clusters (including unassigned clusters), initial shared list has size " << shared_list.size() << std::endl;
+  }
+  // iterate through shared cells, identifying which two they belong to
+  // the shared list grows while it is processed, towers are taken in order from shared_head on
+  for (size_t shared_head = 0; shared_head < shared_list.size();)
+  {
+    // pick the first cell and pop off list
+    int shared_ID = shared_list[shared_head++];
+
+    if (Verbosity() > 5)
+    {
+      std::cout << " -> looking at shared tower " << shared_ID << ", after this one there are " << shared_list.size() - shared_head << " shared towers left " << std::endl;
+    }
+    // look through adjacent pseudoclusters, taking two with highest energies
+    pseudocluster_adjacency.assign(n_local_maxima, false);
+
+    for (int this_adjacent_tower_ID : get_adjacent_towers(shared_ID))
+    {
+      if (get_status_from_ID(this_adjacent_tower_ID) != cl)
+      {
+        continue;
+      }
+      if (owner_first[this_adjacent_tower_ID] > -1 && owner_first[this_adjacent_tower_ID] < n_local_maxima)
+      {
+        pseudocluster_adjacency[owner_first[this_adjacent_tower_ID]] = true;
+      }
+      if (owner_second[this_adjacent_tower_ID] > -1)
+      {  // can inherit adjacency from shared cluster
+        pseudocluster_adjacency[owner_second[this_adjacent_tower_ID]] = true;
+      }
+      // at the same time, add unowned towers to the list for later examination
+      if (owner_first[this_adjacent_tower_ID] == -1)
+      {
+        shared_list.push_back(this_adjacent_tower_ID);
+        owner_first[this_adjacent_tower_ID] = -3;
+        owner_second[this_adjacent_tower_ID] = -1;
         if (Verbosity() > 10)
         {
-          std::cout << "add this tower ( ID " << this_adjacent_tower_ID << " ) to cluster " << std::endl;
+          std::cout << " -> while looking at neighbors, have added un-examined tower " << this_adjacent_tower_ID << " to shared list " << std::endl;
         }
       }
+    }
 
-      if (Verbosity() > 5)
+    // now figure out which pseudoclusters this shared tower is adjacent to...
+    int highest_pseudocluster_index = -1;
+    int second_highest_pseudocluster_index = -1;
+
+    float highest_pseudocluster_E = -999;
+    float second_highest_pseudocluster_E = -999;
+
+    for (int n = 0; n < n_local_maxima; n++)
+    {
+      if (!pseudocluster_adjacency[n])
       {
-        std::cout << " --> after examining perimeter neighbors, # of towers in cluster is now = " << cluster_tower_ID.size() << std::endl;
+        continue;
+      }
+
+      if (pseudocluster_sumE[n] > highest_pseudocluster_E)
+      {
+        second_highest_pseudocluster_E = highest_pseudocluster_E;
+        second_highest_pseudocluster_index = highest_pseudocluster_index;
+
+        highest_pseudocluster_E = pseudocluster_sumE[n];
+        highest_pseudocluster_index = n;
+      }
+      else if (pseudocluster_sumE[n] > second_highest_pseudocluster_E)
+      {
+        second_highest_pseudocluster_E = pseudocluster_sumE[n];
+        second_highest_pseudocluster_index = n;
       }
     }
 
-    // keep track of these
-    all_cluster_towers.push_back(cluster_tower_ID);
+    if (Verbosity() > 5)
+    {
+      std::cout << " -> highest pseudoclusters its adjacent to are " << highest_pseudocluster_index << " ( E = " << highest_pseudocluster_E << " ) and " << second_highest_pseudocluster_index << " ( E = " << second_highest_pseudocluster_E << " ) " << std::endl;
+    }
+    // assign these clusters as owners
+    owner_first[shared_ID] = highest_pseudocluster_index;
+    owner_second[shared_ID] = second_highest_pseudocluster_index;
+  }
 
-    // increment cluster index for next one
-    cluster_index++;
+  if (Verbosity() > 100)
+  {
+    for (int original_tower : original_towers)
+    {
+      std::cout << " Debug Post-Split: tower_ownership[ " << original_tower << " ] = ( " << owner_first[original_tower] << ", " << owner_second[original_tower] << " ) ";
+      std::cout << " , layer / ieta / iphi = " << get_ilayer_from_ID(original_tower) << " / " << get_ieta_from_ID(original_tower) << " / " << get_iphi_from_ID(original_tower);
+      std::cout << std::endl;
+      if (owner_first[original_tower] == -1)
+      {
+        for (int this_adjacent_tower_ID : get_adjacent_towers(original_tower))
+        {
+          if (get_status_from_ID(this_adjacent_tower_ID) != cl)
+          {
+            continue;
+          }
+          std::cout << " -> adjacent to add tower " << this_adjacent_tower_ID << " , which has status " << owner_first[this_adjacent_tower_ID] << std::endl;
+        }
+      }
+    }
+  }
+
+  // call helper function
+  export_clusters(original_towers, scratch, n_local_maxima, output);
+}
+
+RawClusterBuilderTopo::RawClusterBuilderTopo(const std::string &name)
+  : SubsysReco(name)
+{
+  // geometry defined at run-time
+
+  std::fill(std::begin(_geom_containers), std::end(_geom_containers), nullptr);
+  _noise_LAYER[0] = 0.0025;
+  _noise_LAYER[1] = 0.006;
+  _noise_LAYER[2] = 0.03;  // EM
+
+  _local_max_minE_LAYER[0] = 1;
+  _local_max_minE_LAYER[1] = 1;
+  _local_max_minE_LAYER[2] = 1;
+}
+
+int RawClusterBuilderTopo::InitRun(PHCompositeNode *topNode)
+{
+  try
+  {
+    CreateNodes(topNode);
+  }
+  catch (std::exception &e)
+  {
+    std::cout << PHWHERE << ": " << e.what() << std::endl;
+    throw;
   }
 
   if (Verbosity() > 0)
   {
-    std::cout << "RawClusterBuilderTopo::process_event: " << cluster_index << " topo-clusters initially reconstructed, entering splitting step" << std::endl;
+    std::cout << "RawClusterBuilderTopo::InitRun: initialized with EMCal enable = " << _enable_EMCal << " and I+OHCal enable = " << _enable_HCal << std::endl;
+    std::cout << "RawClusterBuilderTopo::InitRun: initialized with sigma_noise in EMCal / IHCal / OHCal = " << _noise_LAYER[2] << " / " << _noise_LAYER[0] << " / " << _noise_LAYER[1] << std::endl;
+    std::cout << "RawClusterBuilderTopo::InitRun: initialized with noise multiples for seeding / growth / perimeter ( S / N / P ) = " << _sigma_seed << " / " << _sigma_grow << " / " << _sigma_peri << std::endl;
+    std::cout << "RawClusterBuilderTopo::InitRun: initialized with allow_corner_neighbor = " << _allow_corner_neighbor << " (in HCal)" << std::endl;
+    std::cout << "RawClusterBuilderTopo::InitRun: initialized with use_absE = " << _use_absE << std::endl;
+    std::cout << "RawClusterBuilderTopo::InitRun: initialized with do_split = " << _do_split << " , R_shower = " << _R_shower << " (angular units) " << std::endl;
+    std::cout << "RawClusterBuilderTopo::InitRun: initialized with minE for local max in EMCal / IHCal / OHCal = " << _local_max_minE_LAYER[2] << " / " << _local_max_minE_LAYER[0] << " / " << _local_max_minE_LAYER[1] << std::endl;
   }
 
-  int original_cluster_index = cluster_index;  // since it may be updated
+  return Fun4AllReturnCodes::EVENT_OK;
+}
 
-  // now entering cluster splitting stage
+int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
+{
+
+  std::string towerinfoNodenameEM = "TOWERINFO_CALIB_CEMC";
+  std::string towerinfoNodenameIH = "TOWERINFO_CALIB_HCALIN";
+  std::string towerinfoNodenameOH = "TOWERINFO_CALIB_HCALOUT";
+  if (!_inputnodeprefix.empty())
+  {
+    towerinfoNodenameEM = _inputnodeprefix + "_CEMC";
+    towerinfoNodenameIH = _inputnodeprefix + "_HCALIN";
+    towerinfoNodenameOH = _inputnodeprefix + "_HCALOUT";
+  }
+
+  TowerInfoContainer *towerinfosEM = findNode::getClass<TowerInfoContainer>(topNode, towerinfoNodenameEM);
+  TowerInfoContainer *towerinfosIH = findNode::getClass<TowerInfoContainer>(topNode, towerinfoNodenameIH);
+  TowerInfoContainer *towerinfosOH = findNode::getClass<TowerInfoContainer>(topNode, towerinfoNodenameOH);
+
+  if (!towerinfosEM)
+  {
+    std::cout << " RawClusterBuilderTopo::process_event : container TOWERINFO_CALIB_CEMC does not exist, aborting " << std::endl;
+    return Fun4AllReturnCodes::ABORTEVENT;
+  }
+  if (!towerinfosIH)
+  {
+    std::cout << " RawClusterBuilderTopo::process_event : container TOWERINFO_CALIB_HCALIN does not exist, aborting " << std::endl;
+    return Fun4AllReturnCodes::ABORTEVENT;
+  }
+  if (!towerinfosOH)
+  {
+    std::cout << " RawClusterBuilderTopo::process_event : container TOWERINFO_CALIB_HCALOUT does not exist, aborting " << std::endl;
+    return Fun4AllReturnCodes::ABORTEVENT;
+  }
+
+  _geom_containers[0] = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
+  _geom_containers[1] = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALOUT");
+  _geom_containers[2] = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_CEMC");
+
+  if (!_geom_containers[0])
+  {
+    std::cout << " RawClusterBuilderTopo::process_event : container TOWERGEOM_HCALIN does not exist, aborting " << std::endl;
+    return Fun4AllReturnCodes::ABORTEVENT;
+  }
+  if (!_geom_containers[1])
+  {
+    std::cout << " RawClusterBuilderTopo::process_event : container TOWERGEOM_HCALOUT does not exist, aborting " << std::endl;
+    return Fun4AllReturnCodes::ABORTEVENT;
+  }
+  if (!_geom_containers[2])
+  {
+    std::cout << " RawClusterBuilderTopo::process_event : container TOWERGEOM_CEMC does not exist, aborting " << std::endl;
+    return Fun4AllReturnCodes::ABORTEVENT;
+  }
+
+  if (Verbosity() > 10)
+  {
+    std::cout << "RawClusterBuilderTopo::process_event: " << towerinfosEM->size() << " TOWERINFO_CALIB_CEMC towers" << std::endl;
+    std::cout << "RawClusterBuilderTopo::process_event: " << towerinfosIH->size() << " TOWERINFO_CALIB_HCALIN towers" << std::endl;
+    std::cout << "RawClusterBuilderTopo::process_event: " << towerinfosOH->size() << " TOWERINFO_CALIB_HCALOUT towers" << std::endl;
 
-  for (int cl = 0; cl < original_cluster_index; cl++)
+    std::cout << "RawClusterBuilderTopo::process_event: pointer to TOWERGEOM_CEMC: " << _geom_containers[2] << std::endl;
+    std::cout << "RawClusterBuilderTopo::process_event: pointer to TOWERGEOM_HCALIN: " << _geom_containers[0] << std::endl;
+    std::cout << "RawClusterBuilderTopo::process_event: pointer to TOWERGEOM_HCALOUT: " << _geom_containers[1] << std::endl;
+  }
+
+  if (_EMCAL_NETA < 0 || _HCAL_NETA < 0)
   {
-    std::vector<int> original_towers = all_cluster_towers.at(cl);
+    // define geometry only once if it has not been yet
+    _EMCAL_NETA = _geom_containers[2]->get_etabins();
+    _EMCAL_NPHI = _geom_containers[2]->get_phibins();
+
+    _HCAL_NETA = _geom_containers[1]->get_etabins();
+    _HCAL_NPHI = _geom_containers[1]->get_phibins();
+
+    init_geometry();
+  }
+
+  // reset maps
+  // but note -- do not reset keys!
+  std::fill(_TOWER_STATUS.begin(), _TOWER_STATUS.end(), -2);  // set tower does not exist
+  std::fill(_TOWER_E.begin(), _TOWER_E.end(), 0);             // set zero energy
+
+  // setup
+  std::vector<std::pair<int, float> > &list_of_seeds = _list_of_seeds;
+  list_of_seeds.clear();
 
-    if (!_do_split)
+  // translate towers to our internal representation
+  if (_enable_EMCal)
+  {
+    TowerInfo *towerInfo = nullptr;
+    unsigned int n_EM_towers = towerinfosEM->size();
+    for (unsigned int iEM = 0; iEM < n_EM_towers; iEM++)
     {
-      // don't run splitting, just export entire cluster as it is
-      if (Verbosity() > 2)
+      towerInfo = towerinfosEM->get_tower_at_channel(iEM);
+      if (_only_good_towers && (!towerInfo->get_isGood()))
       {
-        std::cout << "RawClusterBuilderTopo::process_event: splitting step disabled, cluster " << cluster_index << " is final" << std::endl;
+        continue;
       }
-      export_single_cluster(original_towers);
-      continue;
-    }
+      unsigned int towerinfo_key = towerinfosEM->encode_key(iEM);
+      int ti_ieta = towerinfosEM->getTowerEtaBin(towerinfo_key);
+      int ti_iphi = towerinfosEM->getTowerPhiBin(towerinfo_key);
+      const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::CEMC, ti_ieta, ti_iphi);
 
-    std::vector<std::pair<int, float> > local_maxima_ID;
+      // RawTowerGeom *tower_geom = _geom_containers[2]->get_tower_geometry(key);
 
-    // iterate through each tower, looking for maxima
-    for (int tower_ID : original_towers)
-    {
-      if (Verbosity() > 10)
+      // int ieta = _geom_containers[2]->get_etabin(tower_geom->get_eta());
+      // int iphi = _geom_containers[2]->get_phibin(tower_geom->get_phi());
+
+      int ieta = ti_ieta;
+      int iphi = ti_iphi;
+
+      float this_E = towerInfo->get_energy();
+
+      // if not using abs E, short circuit all negative towers right here (same for IHCal, OHCal below)
+      if (!_use_absE && this_E < 1.E-10)
       {
-        std::cout << " -> examining tower ID " << tower_ID << " for possible local maximum " << std::endl;
+        continue;
       }
 
-      // check minimum energy
-      if (get_E_from_ID(tower_ID) < _local_max_minE_LAYER[get_ilayer_from_ID(tower_ID)])
+      int ID = get_ID(2, ieta, iphi);
+      _TOWER_STATUS[ID] = -1;  // change status to unknown
+      _TOWER_E[ID] = this_E;
+      _TOWER_KEY[ID] = key;
+
+      // use fabs() here for simplicity - if we're not using abs E, negative towers are already excluded
+      if (std::fabs(this_E) >= _sigma_seed * _noise_LAYER[2])
       {
+        list_of_seeds.emplace_back(ID, this_E);
         if (Verbosity() > 10)
         {
-          std::cout << " -> -> energy E = " << get_E_from_ID(tower_ID) << " < " << _local_max_minE_LAYER[get_ilayer_from_ID(tower_ID)] << " too low" << std::endl;
-        }
-        continue;
+          std::cout << "RawClusterBuilderTopo::process_event: adding EMCal tower at ieta / iphi = " << ieta << " / " << iphi << " with E = " << this_E << std::endl;
+          std::cout << " --> ID = " << ID << " , check ilayer / ieta / iphi = " << get_ilayer_from_ID(ID) << " / " << get_ieta_from_ID(ID) << " / " << get_iphi_from_ID(ID) << std::endl;
+        };
       }
+    }
+  }
 
-      // examine neighbors
-      std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(tower_ID);
-      int neighbors_in_cluster = 0;
-
-      // check for higher neighbor
-      bool has_higher_neighbor = false;
-      for (int this_adjacent_tower_ID : adjacent_tower_IDs)
+  // translate towers to our internal representation
+  if (_enable_HCal)
+  {
+    TowerInfo *towerInfo = nullptr;
+    unsigned int n_IH_towers = towerinfosIH->size();
+    for (unsigned int iIH = 0; iIH < n_IH_towers; iIH++)
+    {
+      towerInfo = towerinfosIH->get_tower_at_channel(iIH);
+      if (_only_good_towers && (!towerInfo->get_isGood()))
       {
-        if (get_status_from_ID(this_adjacent_tower_ID) != cl)
-        {
-          continue;  // only consider neighbors in cluster, obviously
-        }
+        continue;
+      }
+      unsigned int towerinfo_key = towerinfosIH->encode_key(iIH);
+      int ti_ieta = towerinfosIH->getTowerEtaBin(towerinfo_key);
+      int ti_iphi = towerinfosIH->getTowerPhiBin(towerinfo_key);
+      const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::HCALIN, ti_ieta, ti_iphi);
 
-        neighbors_in_cluster++;
+      RawTowerGeom *tower_geom = _geom_containers[0]->get_tower_geometry(key);
 
-        if (get_E_from_ID(this_adjacent_tower_ID) > get_E_from_ID(tower_ID))
-        {
-          if (Verbosity() > 10)
-          {
-            std::cout << " -> -> has higher-energy neighbor ID / E = " << this_adjacent_tower_ID << " / " << get_E_from_ID(this_adjacent_tower_ID) << std::endl;
-          }
-          has_higher_neighbor = true;  // at this point we can break -- we won't need to count the number of good neighbors, since we won't even pass the E_neighbor test
-          break;
-        }
-      }
+      int ieta = _geom_containers[0]->get_etabin(tower_geom->get_eta());
+      int iphi = _geom_containers[0]->get_phibin(tower_geom->get_phi());
+      float this_E = towerInfo->get_energy();
 
-      if (has_higher_neighbor)
+      if (!_use_absE && this_E < 1.E-10)
       {
-        continue;  // if we broke out, now continue
+        continue;
       }
 
-      // check number of neighbors
-      if (neighbors_in_cluster < 4)
+      int ID = get_ID(0, ieta, iphi);
+      _TOWER_STATUS[ID] = -1;  // change status to unknown
+      _TOWER_E[ID] = this_E;
+      _TOWER_KEY[ID] = key;
+
+      if (std::fabs(this_E) >= _sigma_seed * _noise_LAYER[0])
       {
+        list_of_seeds.emplace_back(ID, this_E);
         if (Verbosity() > 10)
         {
-          std::cout << " -> -> too few neighbors N = " << neighbors_in_cluster << std::endl;
-        }
+          std::cout << "RawClusterBuilderTopo::process_event: adding IHCal tower at ieta / iphi = " << ieta << " / " << iphi << " with E = " << this_E << std::endl;
+          std::cout << " --> ID = " << ID << " , check ilayer / ieta / iphi = " << get_ilayer_from_ID(ID) << " / " << get_ieta_from_ID(ID) << " / " << get_iphi_from_ID(ID) << std::endl;
+        };
+      }
+    }
+    unsigned int n_OH_towers = towerinfosOH->size();
+    for (unsigned int iOH = 0; iOH < n_OH_towers; iOH++)
+    {
+      towerInfo = towerinfosOH->get_tower_at_channel(iOH);
+      if (_only_good_towers && (!towerInfo->get_isGood()))
+      {
         continue;
       }
+      unsigned int towerinfo_key = towerinfosOH->encode_key(iOH);
+      int ti_ieta = towerinfosOH->getTowerEtaBin(towerinfo_key);
+      int ti_iphi = towerinfosOH->getTowerPhiBin(towerinfo_key);
+      const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::HCALOUT, ti_ieta, ti_iphi);
 
-      local_maxima_ID.emplace_back(tower_ID, get_E_from_ID(tower_ID));
-    }
+      RawTowerGeom *tower_geom = _geom_containers[1]->get_tower_geometry(key);
 
-    // check for possible EMCal-OHCal seed overlaps
-    for (unsigned int n = 0; n < local_maxima_ID.size(); n++)
-    {
-      // only look at I/OHCal local maxima
-      std::pair<int, float> this_LM = local_maxima_ID.at(n);
-      if (get_ilayer_from_ID(this_LM.first) == 2)
+      int ieta = _geom_containers[1]->get_etabin(tower_geom->get_eta());
+      int iphi = _geom_containers[1]->get_phibin(tower_geom->get_phi());
+      float this_E = towerInfo->get_energy();
+
+      if (!_use_absE && this_E < 1.E-10)
       {
         continue;
       }
 
-      float this_phi = _geom_containers[get_ilayer_from_ID(this_LM.first)]->get_phicenter(get_iphi_from_ID(this_LM.first));
-      if (this_phi > M_PI)
+      int ID = get_ID(1, ieta, iphi);
+      _TOWER_STATUS[ID] = -1;  // change status to unknown
+      _TOWER_E[ID] = this_E;
+      _TOWER_KEY[ID] = key;
+
+      if (std::fabs(this_E) >= _sigma_seed * _noise_LAYER[1])
       {
-        this_phi -= 2 * M_PI;
+        list_of_seeds.emplace_back(ID, this_E);
+        if (Verbosity() > 10)
+        {
+          std::cout << "RawClusterBuilderTopo::process_event: adding OHCal tower at ieta / iphi = " << ieta << " / " << iphi << " with E = " << this_E << std::endl;
+          std::cout << " --> ID = " << ID << " , check ilayer / ieta / iphi = " << get_ilayer_from_ID(ID) << " / " << get_ieta_from_ID(ID) << " / " << get_iphi_from_ID(ID) << std::endl;
+        };
       }
-      float this_eta = _geom_containers[get_ilayer_from_ID(this_LM.first)]->get_etacenter(get_ieta_from_ID(this_LM.first));
+    }
+  }
 
-      bool has_EM_overlap = false;
+  if (Verbosity() > 10)
+  {
+    for (unsigned int n = 0; n < list_of_seeds.size(); n++)
+    {
+      std::cout << "RawClusterBuilderTopo::process_event: unsorted seed element n = " << n << " , ID / E = " << list_of_seeds.at(n).first << " / " << list_of_seeds.at(n).second << std::endl;
+    }
+  }
 
-      // check all other local maxima for overlaps
-      for (unsigned int n2 = 0; n2 < local_maxima_ID.size(); n2++)
-      {
-        if (n == n2)
-        {
-          continue;  // don't check the same one
-        }
+  std::sort(list_of_seeds.begin(), list_of_seeds.end(), sort_by_pair_second);
 
-        // only look at EMCal local mazima
-        std::pair<int, float> this_LM2 = local_maxima_ID.at(n2);
-        if (get_ilayer_from_ID(this_LM2.first) != 2)
-        {
-          continue;
-        }
+  if (Verbosity() > 10)
+  {
+    for (unsigned int n = 0; n < list_of_seeds.size(); n++)
+    {
+      std::cout << "RawClusterBuilderTopo::process_event: sorted seed element n = " << n << " , ID / E = " << list_of_seeds.at(n).first << " / " << list_of_seeds.at(n).second << std::endl;
+    }
+  }
 
-        float this_phi2 = _geom_containers[get_ilayer_from_ID(this_LM2.first)]->get_phicenter(get_iphi_from_ID(this_LM2.first));
-        if (this_phi2 > M_PI)
-        {
-          this_phi -= 2 * M_PI;
-        }
-        float this_eta2 = _geom_containers[get_ilayer_from_ID(this_LM2.first)]->get_etacenter(get_ieta_from_ID(this_LM2.first));
+  if (Verbosity() > 0)
+  {
+    std::cout << "RawClusterBuilderTopo::process_event: initialized with " << list_of_seeds.size() << " seeds with E > 4*sigma " << std::endl;
+  }
 
-        // calculate geometric dR
-        float dR = calculate_dR(this_eta, this_eta2, this_phi, this_phi2);
+  int cluster_index = 0;  // begin counting clusters
 
-        // check for and report overlaps
-        if (dR < 0.15)
-        {
-          has_EM_overlap = true;
-          if (Verbosity() > 2)
-          {
-            std::cout << "RawClusterBuilderTopo::process_event : removing I/OHal local maximum (ID,E,phi,eta = " << this_LM.first << ", " << this_LM.second << ", " << this_phi << ", " << this_eta << "), ";
-            std::cout << "due to EM overlap (ID,E,phi,eta = " << this_LM2.first << ", " << this_LM2.second << ", " << this_phi2 << ", " << this_eta2 << "), dR = " << dR << std::endl;
-          }
-          break;
-        }
-      }
+  // store final cluster tower lists here
+  // the tower lists of the previous event are cleared but keep their memory
+  std::vector<std::vector<int> > &all_cluster_towers = _all_cluster_towers;
 
-      if (has_EM_overlap)
-      {
-        // remove the I/OHCal local maximum from the list
-        local_maxima_ID.erase(local_maxima_ID.begin() + n);
-        // make sure to back up one index...
-        n = n - 1;
-      }  // otherwise, keep this local maximum
-    }
+  for (unsigned int iseed = 0; iseed < list_of_seeds.size(); iseed++)
+  {
+    int seed_ID = list_of_seeds[iseed].first;
 
-    // only now print out full set of local maxima
-    if (Verbosity() > 2)
+    if (Verbosity() > 5)
     {
-      for (auto this_LM : local_maxima_ID)
-      {
-        int tower_ID = this_LM.first;
-        std::cout << "RawClusterBuilderTopo::process_event in cluster " << cl << ", tower ID " << tower_ID << " is LOCAL MAXIMUM with layer / E = " << get_ilayer_from_ID(tower_ID) << " / " << get_E_from_ID(tower_ID) << ", ";
-        float this_phi = _geom_containers[get_ilayer_from_ID(tower_ID)]->get_phicenter(get_iphi_from_ID(tower_ID));
-        if (this_phi > M_PI)
-        {
-          this_phi -= 2 * M_PI;
-        }
-        std::cout << " eta / phi = " << _geom_containers[get_ilayer_from_ID(tower_ID)]->get_etacenter(get_ieta_from_ID(tower_ID)) << " / " << this_phi << std::endl;
-      }
+      std::cout << " RawClusterBuilderTopo::process_event: in seeded loop, current seed has ID = " << seed_ID << " , length of remaining seed vector = " << list_of_seeds.size() - iseed - 1 << std::endl;
     }
 
-    // do we have only 1 or 0 local maxima?
-    if (local_maxima_ID.size() <= 1)
+    // if this seed was already claimed by some other seed during its growth, remove it and do nothing
+    int seed_status = get_status_from_ID(seed_ID);
+    if (seed_status > -1)
     {
-      if (Verbosity() > 2)
+      if (Verbosity() > 10)
       {
-        std::cout << "RawClusterBuilderTopo::process_event cluster " << cl << " has only " << local_maxima_ID.size() << " local maxima, not splitting " << std::endl;
+        std::cout << " --> already owned by cluster # " << seed_status << std::endl;
       }
-      export_single_cluster(original_towers);
-
-      continue;
+      continue;  // go onto the next iteration of the loop
     }
 
-    // engage splitting procedure!
+    // this seed tower now owned by new cluster
+    set_status_by_ID(seed_ID, cluster_index);
 
-    if (Verbosity() > 2)
-    {
-      std::cout << "RawClusterBuilderTopo::process_event splitting cluster " << cl << " into " << local_maxima_ID.size() << " according to local maxima!" << std::endl;
-    }
-    // translate all cluster towers to a map which keeps track of their ownership
-    // -1 means unseen
-    // -2 means seen and in the seed list now (e.g. don't add it to the seed list again)
-    // -3 shared tower, ignore going forward...
-    std::map<int, std::pair<int, int> > tower_ownership;
-    for (int &original_tower : original_towers)
+    if (cluster_index == (int) all_cluster_towers.size())
     {
-      tower_ownership[original_tower] = std::pair<int, int>(-1, -1);  // initialize all towers as un-seen
+      all_cluster_towers.emplace_back();
     }
-    std::vector<int> seed_list;
-    std::vector<int> neighbor_list;
-    std::vector<int> shared_list;
+    std::vector<int> &cluster_tower_ID = all_cluster_towers[cluster_index];
+    cluster_tower_ID.clear();
+    cluster_tower_ID.push_back(seed_ID);
 
-    // sort maxima before populating seed list
-    std::sort(local_maxima_ID.begin(), local_maxima_ID.end(), sort_by_pair_second);
+    // growth towers are processed in order, from grow_head on
+    std::vector<int> &grow_tower_ID = _grow_tower_ID;
+    grow_tower_ID.clear();
+    grow_tower_ID.push_back(seed_ID);
+    size_t grow_head = 0;
 
-    // initialize neighbor list
-    for (unsigned int s = 0; s < local_maxima_ID.size(); s++)
-    {
-      tower_ownership[local_maxima_ID.at(s).first] = std::pair<int, int>(s, -1);
-      neighbor_list.push_back(local_maxima_ID.at(s).first);
-    }
+    // iteratively process growth towers, adding > 2 * sigma neighbors to the list for further checking
 
-    if (Verbosity() > 100)
+    if (Verbosity() > 5)
     {
-      for (int &original_tower : original_towers)
-      {
-        std::pair<int, int> the_pair = tower_ownership[original_tower];
-        std::cout << " Debug Pre-Split: tower_ownership[ " << original_tower << " ] = ( " << the_pair.first << ", " << the_pair.second << " ) ";
-        std::cout << " , layer / ieta / iphi = " << get_ilayer_from_ID(original_tower) << " / " << get_ieta_from_ID(original_tower) << " / " << get_iphi_from_ID(original_tower);
-        std::cout << std::endl;
-      }
+      std::cout << " RawClusterBuilderTopo::process_event: Entering Growth stage for cluster " << cluster_index << std::endl;
     }
 
-    bool first_pass = true;
-
-    do
+    while (grow_head < grow_tower_ID.size())
     {
+      int grow_ID = grow_tower_ID[grow_head++];
+
       if (Verbosity() > 5)
       {
-        std::cout << " -> starting split loop with " << seed_list.size() << " seed, " << neighbor_list.size() << " neighbor, and " << shared_list.size() << " shared towers " << std::endl;
+        std::cout << " --> cluster " << cluster_index << ", growth stage, examining neighbors of ID " << grow_ID << ", " << grow_tower_ID.size() - grow_head << " grow towers left" << std::endl;
       }
-      // go through neighbor list, assigning ownership only via the seed list
-      std::vector<int> new_ownerships;
 
-      for (unsigned int n = 0; n < neighbor_list.size(); n++)
+      for (int this_adjacent_tower_ID : get_adjacent_towers(grow_ID))
       {
-        int neighbor_ID = neighbor_list.at(n);
-
         if (Verbosity() > 10)
         {
-          std::cout << " -> -> looking at neighbor " << n << " (tower ID " << neighbor_ID << " ) of " << neighbor_list.size() << " total" << std::endl;
+          std::cout << " --> --> --> checking possible adjacent tower with ID " << this_adjacent_tower_ID << " : ";
         }
-        if (first_pass)
+        int test_layer = get_ilayer_from_ID(this_adjacent_tower_ID);
+        const int adjacent_status = get_status_from_ID(this_adjacent_tower_ID);
+
+        // if tower does not exist, continue
+        if (adjacent_status == -2)
         {
           if (Verbosity() > 10)
           {
-            std::cout << " -> -> -> special first pass rules, this tower already owned by pseudocluster " << tower_ownership[neighbor_ID].first << std::endl;
-          }
-          new_ownerships.push_back(tower_ownership[neighbor_ID].first);
-        }
-        else
-        {
-          std::map<int, bool> pseudocluster_adjacency;
-          for (unsigned int s = 0; s < local_maxima_ID.size(); s++)
-          {
-            pseudocluster_adjacency[s] = false;
-          }
-          // look over all towers THIS one is adjacent to, and count up...
-          std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(neighbor_ID);
-
-          for (int this_adjacent_tower_ID : adjacent_tower_IDs)
-          {
-            if (get_status_from_ID(this_adjacent_tower_ID) != cl)
-            {
-              continue;
-            }
-
-            if (tower_ownership[this_adjacent_tower_ID].first > -1)
-            {
-              if (Verbosity() > 20)
-              {
-                std::cout << " -> -> -> adjacent tower to this one, with ID " << this_adjacent_tower_ID << " , is owned by pseudocluster " << tower_ownership[this_adjacent_tower_ID].first << std::endl;
-              }
-              pseudocluster_adjacency[tower_ownership[this_adjacent_tower_ID].first] = true;
-            }
-          }
-          int n_pseudocluster_adjacent = 0;
-          int last_adjacent_pseudocluster = -1;
-          for (unsigned int s = 0; s < local_maxima_ID.size(); s++)
-          {
-            if (pseudocluster_adjacency[s])
-            {
-              last_adjacent_pseudocluster = s;
-              n_pseudocluster_adjacent++;
-              if (Verbosity() > 20)
-              {
-                std::cout << " -> -> adjacent to pseudocluster " << s << std::endl;
-              }
-            }
-          }
-
-          if (n_pseudocluster_adjacent == 0)
-          {
-            std::cout << " -> -> ERROR! How can a neighbor tower at this stage be adjacent to no pseudoclusters?? " << std::endl;
-            new_ownerships.push_back(9999);
-          }
-          else if (n_pseudocluster_adjacent == 1)
-          {
-            if (Verbosity() > 10)
-            {
-              std::cout << " -> -> neighbor tower " << neighbor_ID << " is ONLY adjacent to one pseudocluster # " << last_adjacent_pseudocluster << std::endl;
-            }
-            new_ownerships.push_back(last_adjacent_pseudocluster);
-          }
-          else
-          {
-            if (Verbosity() > 10)
-            {
-              std::cout << " -> -> neighbor tower " << neighbor_ID << " is adjacent to " << n_pseudocluster_adjacent << " pseudoclusters, move to shared list " << std::endl;
-            }
-            new_ownerships.push_back(-3);
+            std::cout << "does not exist " << std::endl;
           }
+          continue;
         }
-      }
 
-      if (Verbosity() > 5)
-      {
-        std::cout << " -> now updating status of all " << neighbor_list.size() << " original neighbors " << std::endl;
-      }
-      // transfer neighbor list to seed list or shared list
-      for (unsigned int n = 0; n < neighbor_list.size(); n++)
-      {
-        int neighbor_ID = neighbor_list.at(n);
-        if (new_ownerships.at(n) > -1)
+        // if tower is owned by THIS cluster already, continue
+        if (adjacent_status == cluster_index)
         {
-          tower_ownership[neighbor_ID] = std::pair<int, int>(new_ownerships.at(n), -1);
-          seed_list.push_back(neighbor_ID);
-          if (Verbosity() > 20)
+          if (Verbosity() > 10)
           {
-            std::cout << " -> -> neighbor ID " << neighbor_ID << " has new status " << new_ownerships.at(n) << std::endl;
+            std::cout << "already owned by this cluster index " << cluster_index << std::endl;
           }
+          continue;
         }
-        if (new_ownerships.at(n) == -3)
+
+        // if tower has < 2*sigma energy, continue
+        if (std::fabs(get_E_from_ID(this_adjacent_tower_ID)) < _sigma_grow * _noise_LAYER[test_layer])
         {
-          tower_ownership[neighbor_ID] = std::pair<int, int>(-3, -1);
-          shared_list.push_back(neighbor_ID);
-          if (Verbosity() > 20)
+          if (Verbosity() > 10)
           {
-            std::cout << " -> -> neighbor ID " << neighbor_ID << " has new status " << -3 << std::endl;
+            std::cout << "E = " << get_E_from_ID(this_adjacent_tower_ID) << " under 2*sigma threshold " << std::endl;
           }
+          continue;
         }
-      }
 
-      if (Verbosity() > 5)
-      {
-        std::cout << " producing a new neighbor list ... " << std::endl;
-      }
-      // populate a new neighbor list from the about-to-be-owned towers before transferring this one
-      std::list<int> new_neighbor_list;
-      for (unsigned int n = 0; n < neighbor_list.size(); n++)
-      {
-        int neighbor_ID = neighbor_list.at(n);
-        if (new_ownerships.at(n) > -1)
+        // if tower is owned by somebody else, continue (although should this really happen?)
+        if (adjacent_status > -1)
         {
-          std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(neighbor_ID);
-
-          for (int this_adjacent_tower_ID : adjacent_tower_IDs)
+          if (Verbosity() > 10)
           {
-            if (get_status_from_ID(this_adjacent_tower_ID) != cl)
-            {
-              continue;
-            }
-            if (tower_ownership[this_adjacent_tower_ID].first == -1)
-            {
-              new_neighbor_list.push_back(this_adjacent_tower_ID);
-              if (Verbosity() > 5)
-              {
-                std::cout << " -> queueing up to add tower " << this_adjacent_tower_ID << " , neighbor of tower " << neighbor_ID << " to new neighbor list" << std::endl;
-              }
-            }
+            std::cout << "ERROR! in growth stage, encountered >2sigma tower which is already owned?!" << std::endl;
           }
+          continue;
         }
-      }
-
-      if (Verbosity() > 5)
-      {
-        std::cout << " new neighbor list has size " << new_neighbor_list.size() << ", but after removing duplicate elements: ";
-      }
-
-      new_neighbor_list.sort();
-      new_neighbor_list.unique();
-
-      if (Verbosity() > 5)
-      {
-        std::cout << new_neighbor_list.size() << std::endl;
-      }
-
-      // clear neighbor list!
-      neighbor_list.clear();
-
-      // now transfer over new neighbor list
-      for (; !new_neighbor_list.empty();)
-      {
-        neighbor_list.push_back(new_neighbor_list.front());
-        new_neighbor_list.pop_front();
-      }
-
-      first_pass = false;
-
-    } while (!neighbor_list.empty());
 
-    if (Verbosity() > 100)
-    {
-      for (int &original_tower : original_towers)
-      {
-        std::pair<int, int> the_pair = tower_ownership[original_tower];
-        std::cout << " Debug Mid-Split: tower_ownership[ " << original_tower << " ] = ( " << the_pair.first << ", " << the_pair.second << " ) ";
-        std::cout << " , layer / ieta / iphi = " << get_ilayer_from_ID(original_tower) << " / " << get_ieta_from_ID(original_tower) << " / " << get_iphi_from_ID(original_tower);
-        std::cout << std::endl;
-        if (the_pair.first == -1)
+        // tower good to be added to cluster and to list of grow towers
+        grow_tower_ID.push_back(this_adjacent_tower_ID);
+        cluster_tower_ID.push_back(this_adjacent_tower_ID);
+        set_status_by_ID(this_adjacent_tower_ID, cluster_index);
+        if (Verbosity() > 10)
         {
-          std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(original_tower);
-
-          for (int this_adjacent_tower_ID : adjacent_tower_IDs)
-          {
-            if (get_status_from_ID(this_adjacent_tower_ID) != cl)
-            {
-              continue;
-            }
-            std::cout << "    -> adjacent to add tower " << this_adjacent_tower_ID << " , which has status " << tower_ownership[this_adjacent_tower_ID].first << std::endl;
-          }
+          std::cout << "add this tower ( ID " << this_adjacent_tower_ID << " ) to grow list " << std::endl;
         }
       }
-    }
-
-    // calculate pseudocluster energies and positions
-    std::vector<float> pseudocluster_sumeta;
-    std::vector<float> pseudocluster_sumphi;
-    std::vector<float> pseudocluster_sumE;
-    std::vector<int> pseudocluster_ntower;
-    std::vector<float> pseudocluster_eta;
-    std::vector<float> pseudocluster_phi;
-
-    pseudocluster_sumeta.resize(local_maxima_ID.size(), 0);
-    pseudocluster_sumphi.resize(local_maxima_ID.size(), 0);
-    pseudocluster_sumE.resize(local_maxima_ID.size(), 0);
-    pseudocluster_ntower.resize(local_maxima_ID.size(), 0);
 
-    for (int &original_tower : original_towers)
-    {
-      std::pair<int, int> the_pair = tower_ownership[original_tower];
-      if (the_pair.first > -1)
+      if (Verbosity() > 5)
       {
-        float this_ID = original_tower;
-        pseudocluster_sumE[the_pair.first] += get_E_from_ID(this_ID);
-        float this_eta = _geom_containers[get_ilayer_from_ID(this_ID)]->get_etacenter(get_ieta_from_ID(this_ID));
-        float this_phi = _geom_containers[get_ilayer_from_ID(this_ID)]->get_phicenter(get_iphi_from_ID(this_ID));
-
-        pseudocluster_sumeta[the_pair.first] += this_eta;
-        pseudocluster_sumphi[the_pair.first] += this_phi;
-        pseudocluster_ntower[the_pair.first] += 1;
+        std::cout << " --> after examining neighbors, grow list is now " << grow_tower_ID.size() - grow_head << ", # of towers in cluster = " << cluster_tower_ID.size() << std::endl;
       }
     }
 
-    for (unsigned int pc = 0; pc < local_maxima_ID.size(); pc++)
+    // done growing cluster, now add on perimeter towers with E > 0 * sigma
+    if (Verbosity() > 5)
     {
-      pseudocluster_eta.push_back(pseudocluster_sumeta.at(pc) / pseudocluster_ntower.at(pc));
-      pseudocluster_phi.push_back(pseudocluster_sumphi.at(pc) / pseudocluster_ntower.at(pc));
-
-      if (Verbosity() > 2)
-      {
-        std::cout << "RawClusterBuilderTopo::process_event pseudocluster #" << pc << ", E / eta / phi / Ntower = " << pseudocluster_sumE.at(pc) << " / " << pseudocluster_eta.at(pc) << " / " << pseudocluster_phi.at(pc) << " / " << pseudocluster_ntower.at(pc) << std::endl;
-      }
+      std::cout << " RawClusterBuilderTopo::process_event: Entering Perimeter stage for cluster " << cluster_index << std::endl;
     }
+    // we'll be adding on to the cluster list, so get the # of core towers first
+    int n_core_towers = cluster_tower_ID.size();
 
-    if (Verbosity() > 2)
-    {
-      std::cout << "RawClusterBuilderTopo::process_event now splitting up shared clusters (including unassigned clusters), initial shared list has size " << shared_list.size() << std::endl;
-    }
-    // iterate through shared cells, identifying which two they belong to
-    while (!shared_list.empty())
+    for (int ic = 0; ic < n_core_towers; ic++)
     {
-      // pick the first cell and pop off list
-      int shared_ID = shared_list.at(0);
-      shared_list.erase(shared_list.begin());
+      int core_ID = cluster_tower_ID[ic];
 
       if (Verbosity() > 5)
       {
-        std::cout << " -> looking at shared tower " << shared_ID << ", after this one there are " << shared_list.size() << " shared towers left " << std::endl;
+        std::cout << " --> cluster " << cluster_index << ", perimeter stage, examining neighbors of ID " << core_ID << ", core cluster # " << ic << " of " << n_core_towers << " total " << std::endl;
       }
-      // look through adjacent pseudoclusters, taking two with highest energies
-      std::vector<bool> pseudocluster_adjacency;
-      pseudocluster_adjacency.resize(local_maxima_ID.size(), false);
 
-      std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(shared_ID);
-
-      for (int this_adjacent_tower_ID : adjacent_tower_IDs)
+      for (int this_adjacent_tower_ID : get_adjacent_towers(core_ID))
       {
-        if (get_status_from_ID(this_adjacent_tower_ID) != cl)
-        {
-          continue;
-        }
-        if (tower_ownership[this_adjacent_tower_ID].first > -1)
+        if (Verbosity() > 10)
         {
-          pseudocluster_adjacency[tower_ownership[this_adjacent_tower_ID].first] = true;
-        }
-        if (tower_ownership[this_adjacent_tower_ID].second > -1)
-        {  // can inherit adjacency from shared cluster
-          pseudocluster_adjacency[tower_ownership[this_adjacent_tower_ID].second] = true;
+          std::cout << " --> --> --> checking possible adjacent tower with ID " << this_adjacent_tower_ID << " : ";
         }
-        // at the same time, add unowned towers to the list for later examination
-        if (tower_ownership[this_adjacent_tower_ID].first == -1)
+
+        int test_layer = get_ilayer_from_ID(this_adjacent_tower_ID);
+        const int adjacent_status = get_status_from_ID(this_adjacent_tower_ID);
+
+        // if tower does not exist, continue
+        if (adjacent_status == -2)
         {
-          shared_list.push_back(this_adjacent_tower_ID);
-          tower_ownership[this_adjacent_tower_ID] = std::pair<int, int>(-3, -1);
           if (Verbosity() > 10)
           {
-            std::cout << " -> while looking at neighbors, have added un-examined tower " << this_adjacent_tower_ID << " to shared list " << std::endl;
+            std::cout << "does not exist " << std::endl;
           }
+          continue;
         }
-      }
-
-      // now figure out which pseudoclusters this shared tower is adjacent to...
-      int highest_pseudocluster_index = -1;
-      int second_highest_pseudocluster_index = -1;
-
-      float highest_pseudocluster_E = -999;
-      float second_highest_pseudocluster_E = -999;
 
-      for (unsigned int n = 0; n < pseudocluster_adjacency.size(); n++)
-      {
-        if (!pseudocluster_adjacency[n])
+        // if tower is owned by somebody else (including current cluster), continue. ( allowed during perimeter fixing state )
+        if (adjacent_status > -1)
         {
+          if (Verbosity() > 10)
+          {
+            std::cout << "already owned by other cluster index " << adjacent_status << std::endl;
+          }
           continue;
         }
 
-        if (pseudocluster_sumE[n] > highest_pseudocluster_E)
+        // if tower has < 0*sigma energy, continue
+        if (std::fabs(get_E_from_ID(this_adjacent_tower_ID)) < _sigma_peri * _noise_LAYER[test_layer])
         {
-          second_highest_pseudocluster_E = highest_pseudocluster_E;
-          second_highest_pseudocluster_index = highest_pseudocluster_index;
-
-          highest_pseudocluster_E = pseudocluster_sumE[n];
-          highest_pseudocluster_index = n;
+          if (Verbosity() > 10)
+          {
+            std::cout << "E = " << get_E_from_ID(this_adjacent_tower_ID) << " under 0*sigma threshold " << std::endl;
+          }
+          continue;
         }
-        else if (pseudocluster_sumE[n] > second_highest_pseudocluster_E)
+
+        // perimeter tower good to be added to cluster
+        cluster_tower_ID.push_back(this_adjacent_tower_ID);
+        set_status_by_ID(this_adjacent_tower_ID, cluster_index);
+        if (Verbosity() > 10)
         {
-          second_highest_pseudocluster_E = pseudocluster_sumE[n];
-          second_highest_pseudocluster_index = n;
+          std::cout << "add this tower ( ID " << this_adjacent_tower_ID << " ) to cluster " << std::endl;
         }
       }
 
       if (Verbosity() > 5)
       {
-        std::cout << " -> highest pseudoclusters its adjacent to are " << highest_pseudocluster_index << " ( E = " << highest_pseudocluster_E << " ) and " << second_highest_pseudocluster_index << " ( E = " << second_highest_pseudocluster_E << " ) " << std::endl;
+        std::cout << " --> after examining perimeter neighbors, # of towers in cluster is now = " << cluster_tower_ID.size() << std::endl;
       }
-      // assign these clusters as owners
-      tower_ownership[shared_ID] = std::pair<int, int>(highest_pseudocluster_index, second_highest_pseudocluster_index);
     }
 
-    if (Verbosity() > 100)
-    {
-      for (int &original_tower : original_towers)
-      {
-        std::pair<int, int> the_pair = tower_ownership[original_tower];
-        std::cout << " Debug Post-Split: tower_ownership[ " << original_tower << " ] = ( " << the_pair.first << ", " << the_pair.second << " ) ";
-        std::cout << " , layer / ieta / iphi = " << get_ilayer_from_ID(original_tower) << " / " << get_ieta_from_ID(original_tower) << " / " << get_iphi_from_ID(original_tower);
-        std::cout << std::endl;
-        if (the_pair.first == -1)
-        {
-          std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(original_tower);
+    // increment cluster index for next one
+    cluster_index++;
+  }
 
-          for (int this_adjacent_tower_ID : adjacent_tower_IDs)
-          {
-            if (get_status_from_ID(this_adjacent_tower_ID) != cl)
-            {
-              continue;
-            }
-            std::cout << " -> adjacent to add tower " << this_adjacent_tower_ID << " , which has status " << tower_ownership[this_adjacent_tower_ID].first << std::endl;
-          }
-        }
-      }
+  if (Verbosity() > 0)
+  {
+    std::cout << "RawClusterBuilderTopo::process_event: " << cluster_index << " topo-clusters initially reconstructed, entering splitting step" << std::endl;
+  }
+
+  // now entering cluster splitting stage
+  // tower status no longer changes, so that topo-clusters can be split independently
+  // output clusters are saved afterwards, in topo-cluster order
+  const int nthreads = Verbosity() > 0 ? 1 : (_num_threads >= 1 ? _num_threads : omp_get_max_threads());
+  if ((int) _split_scratch.size() < nthreads)
+  {
+    _split_scratch.resize(nthreads);
+  }
+  if ((int) _output_clusters.size() < cluster_index)
+  {
+    _output_clusters.resize(cluster_index);
+  }
+
+#pragma omp parallel num_threads(nthreads) if (cluster_index > 1)
+  {
+    SplitScratch &scratch = _split_scratch[omp_get_thread_num()];
+    scratch.owner_first.resize(_TOWER_STATUS.size(), -1);
+    scratch.owner_second.resize(_TOWER_STATUS.size(), -1);
+
+#pragma omp for schedule(dynamic)
+    for (int cl = 0; cl < cluster_index; cl++)
+    {
+      _output_clusters[cl].clear();
+      split_cluster(cl, all_cluster_towers[cl], scratch, _output_clusters[cl]);
     }
+  }
 
-    // call helper function
-    export_clusters(original_towers, tower_ownership, local_maxima_ID.size(), pseudocluster_sumE, pseudocluster_eta, pseudocluster_phi);
+  for (int cl = 0; cl < cluster_index; cl++)
+  {
+    save_clusters(_output_clusters[cl]);
   }
 
   if (Verbosity() > 1)
@@ -9,7 +9,7 @@
 
 #include <fun4all/SubsysReco.h>
 
-#include <map>
+#include <span>
 #include <string>
 #include <utility>  // for pair
 #include <vector>
@@ -103,9 +103,53 @@ class RawClusterBuilderTopo : public SubsysReco
     _inputnodeprefix = inputPrefix;
   }
 
+  /// number of threads used to split the topo-clusters. Zero or negative uses the OpenMP default
+  /** everything runs on a single thread when Verbosity() > 0 */
+  void set_num_threads(int value)
+  {
+    _num_threads = value;
+  }
+
  private:
+  //! output cluster, before it is copied to a RawCluster
+  struct OutputCluster
+  {
+    std::vector<std::pair<int, float> > towers;
+    float E{0};
+    float absE{0};
+    float x{0};
+    float y{0};
+    float z{0};
+  };
+
+  //! per thread scratch memory for the splitting step, reused from cluster to cluster
+  struct SplitScratch
+  {
+    // pseudocluster ownership, indexed by tower ID
+    std::vector<int> owner_first;
+    std::vector<int> owner_second;
+
+    std::vector<std::pair<int, float> > local_maxima_ID;
+    std::vector<int> seed_list;
+    std::vector<int> neighbor_list;
+    std::vector<int> new_neighbor_list;
+    std::vector<int> shared_list;
+    std::vector<int> new_ownerships;
+    std::vector<char> pseudocluster_adjacency;
+
+    std::vector<float> pseudocluster_sumeta;
+    std::vector<float> pseudocluster_sumphi;
+    std::vector<float> pseudocluster_sumE;
+    std::vector<int> pseudocluster_ntower;
+    std::vector<float> pseudocluster_eta;
+    std::vector<float> pseudocluster_phi;
+  };
+
   void CreateNodes(PHCompositeNode *topNode);
 
+  //! size the tower arrays and tabulate adjacent towers, once the geometry is known
+  void init_geometry();
+
   // geometric constants to express IHCal<->EMCal overlap in eta
   static int RawClusterBuilderTopo_constants_EMCal_eta_start_given_IHCal[];
 
@@ -126,11 +170,23 @@ class RawClusterBuilderTopo : public SubsysReco
 
   std::vector<int> get_adjacent_towers_by_ID(int ID);
 
+  //! tabulated adjacent towers, same content and order as get_adjacent_towers_by_ID
+  std::span<const int> get_adjacent_towers(int ID) const
+  {
+    return {_adjacent_IDs.data() + _adjacent_offsets[ID], _adjacent_IDs.data() + _adjacent_offsets[ID + 1]};
+  }
+
   static float calculate_dR(float, float, float, float);
 
-  void export_single_cluster(const std::vector<int> &);
+  //! split topo-cluster cl around its local maxima (if enabled) into output clusters
+  void split_cluster(int cl, const std::vector<int> &, SplitScratch &, std::vector<OutputCluster> &);
 
-  void export_clusters(const std::vector<int> &, std::map<int, std::pair<int, int> >, unsigned int, const std::vector<float> &, const std::vector<float> &, const std::vector<float> &);
+  void export_single_cluster(const std::vector<int> &, SplitScratch &, std::vector<OutputCluster> &);
+
+  void export_clusters(const std::vector<int> &, const SplitScratch &, unsigned int, std::vector<OutputCluster> &);
+
+  //! copy output clusters to the node
+  void save_clusters(const std::vector<OutputCluster> &);
 
   int get_ID(int ilayer, int ieta, int iphi)
   {
@@ -177,34 +233,19 @@ class RawClusterBuilderTopo : public SubsysReco
     }
   }
 
-  int get_status_from_ID(int ID)
+  int get_status_from_ID(int ID) const
   {
-    if (ID < _EMCAL_NPHI * _EMCAL_NETA)
-    {
-      return _TOWERMAP_STATUS_LAYER_ETA_PHI[get_ilayer_from_ID(ID)][get_ieta_from_ID(ID)][get_iphi_from_ID(ID)];
-    }
-    return _EMTOWERMAP_STATUS_ETA_PHI[get_ieta_from_ID(ID)][get_iphi_from_ID(ID)];
+    return _TOWER_STATUS[ID];
   }
 
-  float get_E_from_ID(int ID)
+  float get_E_from_ID(int ID) const
   {
-    if (ID < _EMCAL_NPHI * _EMCAL_NETA)
-    {
-      return _TOWERMAP_E_LAYER_ETA_PHI[get_ilayer_from_ID(ID)][get_ieta_from_ID(ID)][get_iphi_from_ID(ID)];
-    }
-    return _EMTOWERMAP_E_ETA_PHI[get_ieta_from_ID(ID)][get_iphi_from_ID(ID)];
+    return _TOWER_E[ID];
   }
 
   void set_status_by_ID(int ID, int status)
   {
-    if (ID < _EMCAL_NPHI * _EMCAL_NETA)
-    {
-      _TOWERMAP_STATUS_LAYER_ETA_PHI[get_ilayer_from_ID(ID)][get_ieta_from_ID(ID)][get_iphi_from_ID(ID)] = status;
-    }
-    else
-    {
-      _EMTOWERMAP_STATUS_ETA_PHI[get_ieta_from_ID(ID)][get_iphi_from_ID(ID)] = status;
-    }
+    _TOWER_STATUS[ID] = status;
   }
 
   RawClusterContainer *_clusters {nullptr};
@@ -236,13 +277,24 @@ class RawClusterBuilderTopo : public SubsysReco
   bool _do_split {true};
   bool _only_good_towers {true};
 
-  std::vector<std::vector<std::vector<float> > > _TOWERMAP_E_LAYER_ETA_PHI;
-  std::vector<std::vector<std::vector<int> > > _TOWERMAP_KEY_LAYER_ETA_PHI;
-  std::vector<std::vector<std::vector<int> > > _TOWERMAP_STATUS_LAYER_ETA_PHI;
+  int _num_threads {1};
+
+  // tower energy, key and status, indexed by tower ID
+  // status is -2 for missing towers, -1 for unclustered towers, the topo-cluster index otherwise
+  std::vector<float> _TOWER_E;
+  std::vector<int> _TOWER_KEY;
+  std::vector<int> _TOWER_STATUS;
+
+  // adjacent tower IDs of each tower ID, compressed sparse rows
+  std::vector<int> _adjacent_offsets;
+  std::vector<int> _adjacent_IDs;
 
-  std::vector<std::vector<float> > _EMTOWERMAP_E_ETA_PHI;
-  std::vector<std::vector<int> > _EMTOWERMAP_KEY_ETA_PHI;
-  std::vector<std::vector<int> > _EMTOWERMAP_STATUS_ETA_PHI;
+  // event level scratch memory
+  std::vector<std::pair<int, float> > _list_of_seeds;
+  std::vector<int> _grow_tower_ID;
+  std::vector<std::vector<int> > _all_cluster_towers;
+  std::vector<SplitScratch> _split_scratch;
+  std::vector<std::vector<OutputCluster> > _output_clusters;
 
   std::string _inputnodeprefix;
   std::string ClusterNodeName {"TOPOCLUSTER_HCAL"};
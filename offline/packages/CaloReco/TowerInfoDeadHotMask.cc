@@ -3,6 +3,7 @@
 #include <calobase/TowerInfo.h>
 #include <calobase/TowerInfoContainer.h>
 #include <calobase/TowerInfoDefs.h>
+#include <calobase/TowerInfov6.h>
 #include <calobase/RawTowerDeadMap.h>
 #include <calobase/RawTowerGeomContainer.h>
 #include <calobase/RawTowerGeom.h>
@@ -16,6 +17,7 @@
 #include <fstream>
 #include <iostream>
 #include <set>                               // for _Rb_tree_const_iterator
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -33,6 +35,10 @@ int TowerInfoDeadHotMask::InitRun(PHCompositeNode *topNode)
 {
   CreateNodeTree(topNode);
 
+  // the dead map of the run is read on the first event
+  m_deadChannels.clear();
+  m_deadChannelsFilled = false;
+
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -43,22 +49,51 @@ int TowerInfoDeadHotMask::process_event(PHCompositeNode * /*topNode*/)
     std::cout << Name() << "::" << m_detector << "::process_event - Entry" << std::endl;
   }
 
-  RawTowerDeadMap::Map map = m_deadMap->getDeadTowers();
+  if (!m_deadChannelsFilled)
+  {
+    FillDeadChannels();
+  }
 
-  RawTowerDeadMap::Map::iterator itr;
+  std::span<float> energy = m_calibTowerInfos->get_energy_array();
+  std::span<short> time = m_calibTowerInfos->get_time_array();
+  if (!energy.empty())
+  {
+    const short dead_time = TowerInfov6::encode_time(-10);
+    for (unsigned int channel : m_deadChannels)
+    {
+      energy[channel] = 0.;
+      time[channel] = dead_time;
+    }
+    return Fun4AllReturnCodes::EVENT_OK;
+  }
 
-  for(itr = map.begin(); itr != map.end(); ++itr)
+  for (unsigned int channel : m_deadChannels)
   {
-    int iphi = m_geometry->get_tower_geometry(*itr)->get_binphi();
-    int ieta = m_geometry->get_tower_geometry(*itr)->get_bineta();
-    unsigned int key = TowerInfoDefs::encode_emcal(ieta, iphi);
-    m_calibTowerInfos->get_tower_at_key(key)->set_energy(0.);
-    m_calibTowerInfos->get_tower_at_key(key)->set_time(-10);
+    TowerInfo *tower = m_calibTowerInfos->get_tower_at_channel(channel);
+    tower->set_energy(0.);
+    tower->set_time(-10);
   }
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void TowerInfoDeadHotMask::FillDeadChannels()
+{
+  m_deadChannelsFilled = true;
+  if (!m_deadMap)
+  {
+    return;
+  }
+
+  for (const auto &tower_key : m_deadMap->getDeadTowers())
+  {
+    int iphi = m_geometry->get_tower_geometry(tower_key)->get_binphi();
+    int ieta = m_geometry->get_tower_geometry(tower_key)->get_bineta();
+    unsigned int key = TowerInfoDefs::encode_emcal(ieta, iphi);
+    m_deadChannels.push_back(m_calibTowerInfos->decode_key(key));
+  }
+}
+
 void TowerInfoDeadHotMask::CreateNodeTree(PHCompositeNode *topNode)
 {
   m_calibTowerInfos = findNode::getClass<TowerInfoContainer>(topNode, "TOWERINFO_CALIB_" + m_detector);
@@ -4,6 +4,7 @@
 #include <fun4all/SubsysReco.h>
 
 #include <string>
+#include <vector>
 
 class PHCompositeNode;
 class RawClusterContainer;
@@ -29,11 +30,17 @@ class TowerInfoDeadHotMask : public SubsysReco
  private:
   void CreateNodeTree(PHCompositeNode *topNode);
 
+  // channels of the towers of the dead map
+  void FillDeadChannels();
+
   std::string m_detector;
 
   RawTowerDeadMap *m_deadMap;
   TowerInfoContainer *m_calibTowerInfos;
   RawTowerGeomContainer *m_geometry;
+
+  std::vector<unsigned int> m_deadChannels;
+  bool m_deadChannelsFilled{false};
 };
 
 #endif
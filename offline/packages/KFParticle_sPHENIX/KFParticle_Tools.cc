@@ -62,6 +62,8 @@
 
 #include <Eigen/Dense>
 
+#include <omp.h>
+
 #include <algorithm>  // for max, remove, minmax_el...
 #include <cmath>      // for sqrt, pow, M_PI
 #include <cstdlib>    // for abs, NULL
@@ -70,6 +72,7 @@
 #include <limits>
 #include <map>        // for _Rb_tree_iterator, map
 #include <memory>     // for allocator_traits<>::va...
+#include <numeric>
 
 /// KFParticle constructor
 KFParticle_Tools::KFParticle_Tools()
@@ -534,253 +537,309 @@ std::vector<int> KFParticle_Tools::findAllGoodTracks(const std::vector<KFParticl
   return goodTrackIndex;
 }
 
-std::vector<std::vector<int>> KFParticle_Tools::findTwoProngs(std::vector<KFParticle> daughterParticles, std::vector<int> goodTrackIndex, int nTracks, const std::vector<KFParticle> &primaryVertices)
+std::vector<std::vector<int>> KFParticle_Tools::findTwoProngs(const std::vector<KFParticle> &daughterParticles, const std::vector<int> &goodTrackIndex, int nTracks, const std::vector<KFParticle> &primaryVertices)
 {
-  std::vector<std::vector<int>> goodTracksThatMeet;
+  const size_t nGoodTracks = goodTrackIndex.size();
 
-  for (std::vector<int>::iterator i_it = goodTrackIndex.begin(); i_it != goodTrackIndex.end(); ++i_it)
+  // bunch crossing of each track, looked up once instead of once per pair
+  std::vector<short> crossing(nGoodTracks, 0);
+  std::vector<unsigned char> hasCrossing(nGoodTracks, 0);
+  if (m_require_bunch_crossing_match)
   {
-    for (std::vector<int>::iterator j_it = goodTrackIndex.begin(); j_it != goodTrackIndex.end(); ++j_it)
+    for (size_t i = 0; i < nGoodTracks; ++i)
     {
-      if (i_it < j_it)
+      SvtxTrack *thisTrack = KFParticle_truthAndDetTools::getTrack(daughterParticles[goodTrackIndex[i]].Id(), m_dst_trackmap);
+      if (thisTrack)
       {
-        std::vector<KFParticle> dummy_tracks = {daughterParticles[*i_it], daughterParticles[*j_it]};
-        if (m_require_bunch_crossing_match)
-        {
-          std::vector<int> crossings;
-          crossings.reserve(dummy_tracks.size());
-          for (const auto &track : dummy_tracks)
-          {
-            SvtxTrack *thisTrack = KFParticle_truthAndDetTools::getTrack(track.Id(), m_dst_trackmap);
-            if (thisTrack)
-            {
-              crossings.push_back(thisTrack->get_crossing());
-            }
-          }
-          
-          removeDuplicates(crossings);
-          
-          if (crossings.size() !=1)
-          {
-            continue;
-          }
-        }
+        crossing[i] = thisTrack->get_crossing();
+        hasCrossing[i] = 1;
+      }
+    }
+  }
 
-        KFParticle dummy_mother;
-        dummy_mother.SetConstructMethod(2);
+  // pairs passing the crossing match, in loop order
+  // the tracks found in the track map must all have the same crossing, and at least one must be found
+  std::vector<std::pair<int, int>> pairs;
+  std::vector<unsigned char> keep(nGoodTracks, 1);
+  for (size_t i = 0; i < nGoodTracks; ++i)
+  {
+    if (m_require_bunch_crossing_match)
+    {
+      const unsigned char found_i = hasCrossing[i];
+      const short crossing_i = crossing[i];
+      for (size_t j = i + 1; j < nGoodTracks; ++j)
+      {
+        keep[j] = (found_i & hasCrossing[j] & (crossing_i == crossing[j])) | (found_i ^ hasCrossing[j]);
+      }
+    }
 
-        for (auto &track : dummy_tracks)
-        {
-          dummy_mother.AddDaughter(track);
-        }
-        for (auto &track : dummy_tracks)
-        {
-          track.SetProductionVertex(dummy_mother);
-        }
+    for (size_t j = i + 1; j < nGoodTracks; ++j)
+    {
+      if (keep[j])
+      {
+        pairs.emplace_back(i, j);
+      }
+    }
+  }
 
-        float dca = dummy_tracks[0].GetDistanceFromParticle(dummy_tracks[1]);
-        float dca_xy = std::abs(dummy_tracks[0].GetDistanceFromParticleXY(dummy_tracks[1]));
+  // vertex fits of the remaining pairs, on several threads
+  std::vector<unsigned char> accepted(pairs.size(), 0);
+  const int nthreads = m_verbosity > 0 ? 1 : (m_num_threads >= 1 ? m_num_threads : omp_get_max_threads());
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic, 16)
+  for (size_t i_pair = 0; i_pair < pairs.size(); ++i_pair)
+  {
+    accepted[i_pair] = isGoodTwoProng(daughterParticles[goodTrackIndex[pairs[i_pair].first]],
+                                      daughterParticles[goodTrackIndex[pairs[i_pair].second]],
+                                      nTracks, primaryVertices);
+  }
 
-        if (m_verbosity >= 10)
-        {
-          printSelectionCheck("This track pair", "passed", "failed", "the DCA selection", (dca <= m_comb_DCA) && (dca_xy <= m_comb_DCA_xy));
-          if (m_verbosity >= 11)
-          {
-            printSelectionCheck("Pair DCA", 0., dca, m_comb_DCA);
-            printSelectionCheck("Pair DCA xy", 0., dca_xy, m_comb_DCA_xy);
-          }
-        }
+  std::vector<std::vector<int>> goodTracksThatMeet;
+  for (size_t i_pair = 0; i_pair < pairs.size(); ++i_pair)
+  {
+    if (accepted[i_pair])
+    {
+      goodTracksThatMeet.push_back({goodTrackIndex[pairs[i_pair].first], goodTrackIndex[pairs[i_pair].second]});
+    }
+  }
 
-        if (dca <= m_comb_DCA && dca_xy <= m_comb_DCA_xy)
-        {
-          KFVertex twoParticleVertex;
-          twoParticleVertex += dummy_tracks[0];
-          twoParticleVertex += dummy_tracks[1];
-          float vertexchi2ndof = twoParticleVertex.GetChi2() / twoParticleVertex.GetNDF();
-          float sv_radial_position = sqrt(pow(twoParticleVertex.GetX(), 2) + pow(twoParticleVertex.GetY(), 2));
-          std::vector<int> combination = {*i_it, *j_it};
-
-          if (nTracks == 2 && m_verbosity >= 10)
-          {
-            printSelectionCheck("This track pair", "passed", "failed", "the quality and radius selection", (vertexchi2ndof <= m_vertex_chi2ndof) && (sv_radial_position >= m_min_radial_SV));
-            if (m_verbosity >= 11)
-            {
-              printSelectionCheck("SV chi^2/nDoF", 0., vertexchi2ndof, m_vertex_chi2ndof);
-              printSelectionCheck("SV radius", m_min_radial_SV, sv_radial_position, std::numeric_limits<float>::max());
-            }
-          }
-
-          //Now check if tracks are good as we need full reco to make DCA calc make sense
-          if (nTracks == 2)
-          {
-            if (vertexchi2ndof > m_vertex_chi2ndof)
-            {
-              continue;
-            }
-
-            if (sv_radial_position < m_min_radial_SV)
-            {
-              continue;
-            }
-       
-            bool rejectComboDueToTrack = false;
-
-            for (auto &track : dummy_tracks)
-            {
-              bool trackPassesCuts = isGoodTrack(track, primaryVertices);
-              if (!trackPassesCuts)
-              {
-                rejectComboDueToTrack = true;
-              }
-            }
-
-            if (rejectComboDueToTrack)
-            {
-              continue;
-            }
-
-          }
-
-          goodTracksThatMeet.push_back(combination);
-        }
+  return goodTracksThatMeet;
+}
+
+bool KFParticle_Tools::isGoodTwoProng(const KFParticle &track_a, const KFParticle &track_b, int nTracks, const std::vector<KFParticle> &primaryVertices)
+{
+  std::vector<KFParticle> dummy_tracks = {track_a, track_b};
+
+  KFParticle dummy_mother;
+  dummy_mother.SetConstructMethod(2);
+
+  for (auto &track : dummy_tracks)
+  {
+    dummy_mother.AddDaughter(track);
+  }
+  for (auto &track : dummy_tracks)
+  {
+    track.SetProductionVertex(dummy_mother);
+  }
+
+  float dca = dummy_tracks[0].GetDistanceFromParticle(dummy_tracks[1]);
+  float dca_xy = std::abs(dummy_tracks[0].GetDistanceFromParticleXY(dummy_tracks[1]));
+
+  if (m_verbosity >= 10)
+  {
+    printSelectionCheck("This track pair", "passed", "failed", "the DCA selection", (dca <= m_comb_DCA) && (dca_xy <= m_comb_DCA_xy));
+    if (m_verbosity >= 11)
+    {
+      printSelectionCheck("Pair DCA", 0., dca, m_comb_DCA);
+      printSelectionCheck("Pair DCA xy", 0., dca_xy, m_comb_DCA_xy);
+    }
+  }
+
+  if (dca > m_comb_DCA || dca_xy > m_comb_DCA_xy)
+  {
+    return false;
+  }
+
+  KFVertex twoParticleVertex;
+  twoParticleVertex += dummy_tracks[0];
+  twoParticleVertex += dummy_tracks[1];
+  float vertexchi2ndof = twoParticleVertex.GetChi2() / twoParticleVertex.GetNDF();
+  float sv_radial_position = sqrt(pow(twoParticleVertex.GetX(), 2) + pow(twoParticleVertex.GetY(), 2));
+
+  if (nTracks == 2 && m_verbosity >= 10)
+  {
+    printSelectionCheck("This track pair", "passed", "failed", "the quality and radius selection", (vertexchi2ndof <= m_vertex_chi2ndof) && (sv_radial_position >= m_min_radial_SV));
+    if (m_verbosity >= 11)
+    {
+      printSelectionCheck("SV chi^2/nDoF", 0., vertexchi2ndof, m_vertex_chi2ndof);
+      printSelectionCheck("SV radius", m_min_radial_SV, sv_radial_position, std::numeric_limits<float>::max());
+    }
+  }
+
+  //Now check if tracks are good as we need full reco to make DCA calc make sense
+  if (nTracks == 2)
+  {
+    if (vertexchi2ndof > m_vertex_chi2ndof)
+    {
+      return false;
+    }
+
+    if (sv_radial_position < m_min_radial_SV)
+    {
+      return false;
+    }
+
+    bool rejectComboDueToTrack = false;
+
+    for (auto &track : dummy_tracks)
+    {
+      bool trackPassesCuts = isGoodTrack(track, primaryVertices);
+      if (!trackPassesCuts)
+      {
+        rejectComboDueToTrack = true;
       }
     }
+
+    if (rejectComboDueToTrack)
+    {
+      return false;
+    }
   }
 
-  return goodTracksThatMeet;
+  return true;
 }
 
 std::vector<std::vector<int>> KFParticle_Tools::findNProngs(const std::vector<KFParticle> &daughterParticles,
                                                             const std::vector<int> &goodTrackIndex,
-                                                            std::vector<std::vector<int>> goodTracksThatMeet,
+                                                            const std::vector<std::vector<int>> &goodTracksThatMeet,
                                                             int nRequiredTracks, unsigned int nProngs, const std::vector<KFParticle> &primaryVertices)
 {
-  unsigned int nGoodProngs = goodTracksThatMeet.size();
+  const size_t nGoodTracks = goodTrackIndex.size();
+  const unsigned int nGoodProngs = goodTracksThatMeet.size();
 
-  for (const auto &i_it : goodTrackIndex)
+  // accepted (nProngs-1)-prong combinations for every track, on several threads
+  std::vector<std::vector<unsigned int>> acceptedProngs(nGoodTracks);
+  const int nthreads = m_verbosity > 0 ? 1 : (m_num_threads >= 1 ? m_num_threads : omp_get_max_threads());
+#pragma omp parallel num_threads(nthreads)
   {
-    for (unsigned int i_prongs = 0; i_prongs < nGoodProngs; ++i_prongs)
+    std::vector<int> combination;
+    combination.reserve(nProngs);
+
+#pragma omp for schedule(dynamic, 4)
+    for (size_t i_track = 0; i_track < nGoodTracks; ++i_track)
     {
-      bool trackNotUsedAlready = true;
-      for (unsigned int i_trackCheck = 0; i_trackCheck < nProngs - 1; ++i_trackCheck)
+      const int i_it = goodTrackIndex[i_track];
+      for (unsigned int i_prongs = 0; i_prongs < nGoodProngs; ++i_prongs)
       {
-        if (i_it == goodTracksThatMeet[i_prongs][i_trackCheck])
+        const auto &prongs = goodTracksThatMeet[i_prongs];
+        if (std::find(prongs.begin(), prongs.begin() + nProngs - 1, i_it) != prongs.begin() + nProngs - 1)
         {
-          trackNotUsedAlready = false;
-        }
-      }
-      if (trackNotUsedAlready)
-      {
-        bool dcaMet = true;
-
-        //Need to propagate all tracks first
-        KFVertex particleVertex;
-        particleVertex += daughterParticles[i_it];
-        std::vector<int> combination;
-        combination.push_back(i_it);
-        for (unsigned int i = 0; i < nProngs - 1; ++i)
-        {
-          particleVertex += daughterParticles[goodTracksThatMeet[i_prongs][i]];
-          combination.push_back(goodTracksThatMeet[i_prongs][i]);
+          continue;
         }
 
-        KFParticle dummy_mother;
-        std::vector<KFParticle> dummy_tracks;
-        dummy_tracks.reserve(combination.size());
-        for (auto &id : combination)
+        combination.assign(1, i_it);
+        combination.insert(combination.end(), prongs.begin(), prongs.begin() + nProngs - 1);
+        if (isGoodNProng(daughterParticles, combination, nRequiredTracks, nProngs, primaryVertices))
         {
-          dummy_tracks.push_back(daughterParticles[id]);
+          acceptedProngs[i_track].push_back(i_prongs);
         }
-        dummy_mother.SetConstructMethod(2);
+      }
+    }
+  }
 
-        for (auto &track : dummy_tracks)
-        {
-          dummy_mother.AddDaughter(track);
-        }
-        for (auto &track : dummy_tracks)
-        {
-          track.SetProductionVertex(dummy_mother);
-        }
+  std::vector<std::vector<int>> goodTracksThatMeetN;
+  for (size_t i_track = 0; i_track < nGoodTracks; ++i_track)
+  {
+    for (const auto &i_prongs : acceptedProngs[i_track])
+    {
+      std::vector<int> combination = {goodTrackIndex[i_track]};
+      combination.insert(combination.end(), goodTracksThatMeet[i_prongs].begin(), goodTracksThatMeet[i_prongs].begin() + nProngs - 1);
+      sort(combination.begin(), combination.end());
+      goodTracksThatMeetN.push_back(combination);
+    }
+  }
+  removeDuplicates(goodTracksThatMeetN);
 
-        for (unsigned int i = 1; i < combination.size(); ++i)
-        {
-          float dca = dummy_tracks[0].GetDistanceFromParticle(dummy_tracks[i]);
-          float dca_xy = dummy_tracks[0].GetDistanceFromParticleXY(dummy_tracks[i]);
-
-         if (m_verbosity >= 10)
-         {
-           printSelectionCheck("This track", "combined", "did not combine", "with a SV set", (dca <= m_comb_DCA) && (dca_xy <= m_comb_DCA_xy));
-           if (m_verbosity >= 11)
-           {
-             printSelectionCheck("Pair DCA", 0., dca, m_comb_DCA);
-             printSelectionCheck("Pair DCA xy", 0., dca_xy, m_comb_DCA_xy);
-           }
-         }
-
-          if (dca > m_comb_DCA || dca_xy > m_comb_DCA_xy)
-          {
-            dcaMet = false;
-          }
-        }
+  return goodTracksThatMeetN;
+}
 
-        if (dcaMet)
-        {
-          float vertexchi2ndof = particleVertex.GetChi2() / particleVertex.GetNDF();
-          float sv_radial_position = sqrt(pow(particleVertex.GetX(), 2) + pow(particleVertex.GetY(), 2));
-
-          if ((unsigned int) nRequiredTracks == nProngs && m_verbosity >= 10)
-          {
-            printSelectionCheck("This SV combination", "passed", "failed", "the quality and radius selection", (vertexchi2ndof <= m_vertex_chi2ndof) && (sv_radial_position >= m_min_radial_SV));
-            if (m_verbosity >= 11)
-            {
-              printSelectionCheck("SV chi^2/nDoF", 0., vertexchi2ndof, m_vertex_chi2ndof);
-              printSelectionCheck("SV radius", m_min_radial_SV, sv_radial_position, std::numeric_limits<float>::max());
-            }
-          }
-
-          if ((unsigned int) nRequiredTracks == nProngs)
-          {
-            if (vertexchi2ndof > m_vertex_chi2ndof)
-            {
-              continue;
-            }
-
-            if (sv_radial_position < m_min_radial_SV)
-            {
-              continue;
-            }
-
-            bool rejectComboDueToTrack = false;
-
-            for (auto &track : dummy_tracks)
-            {
-              bool trackPassesCuts = isGoodTrack(track, primaryVertices);
-              if (!trackPassesCuts)
-              {
-                rejectComboDueToTrack = true;
-              }
-            }
-
-            if (rejectComboDueToTrack)
-            {
-              continue;
-            }
-          }
-
-          goodTracksThatMeet.push_back(combination);
-        }
+bool KFParticle_Tools::isGoodNProng(const std::vector<KFParticle> &daughterParticles, const std::vector<int> &combination,
+                                    int nRequiredTracks, unsigned int nProngs, const std::vector<KFParticle> &primaryVertices)
+{
+  //Need to propagate all tracks first
+  KFVertex particleVertex;
+  for (const auto &id : combination)
+  {
+    particleVertex += daughterParticles[id];
+  }
+
+  KFParticle dummy_mother;
+  std::vector<KFParticle> dummy_tracks;
+  dummy_tracks.reserve(combination.size());
+  for (const auto &id : combination)
+  {
+    dummy_tracks.push_back(daughterParticles[id]);
+  }
+  dummy_mother.SetConstructMethod(2);
+
+  for (auto &track : dummy_tracks)
+  {
+    dummy_mother.AddDaughter(track);
+  }
+  for (auto &track : dummy_tracks)
+  {
+    track.SetProductionVertex(dummy_mother);
+  }
+
+  bool dcaMet = true;
+  for (unsigned int i = 1; i < combination.size(); ++i)
+  {
+    float dca = dummy_tracks[0].GetDistanceFromParticle(dummy_tracks[i]);
+    float dca_xy = dummy_tracks[0].GetDistanceFromParticleXY(dummy_tracks[i]);
+
+    if (m_verbosity >= 10)
+    {
+      printSelectionCheck("This track", "combined", "did not combine", "with a SV set", (dca <= m_comb_DCA) && (dca_xy <= m_comb_DCA_xy));
+      if (m_verbosity >= 11)
+      {
+        printSelectionCheck("Pair DCA", 0., dca, m_comb_DCA);
+        printSelectionCheck("Pair DCA xy", 0., dca_xy, m_comb_DCA_xy);
       }
     }
+
+    if (dca > m_comb_DCA || dca_xy > m_comb_DCA_xy)
+    {
+      dcaMet = false;
+    }
   }
 
-  goodTracksThatMeet.erase(goodTracksThatMeet.begin(), goodTracksThatMeet.begin() + nGoodProngs);
-  for (auto &i : goodTracksThatMeet)
+  if (!dcaMet)
   {
-    sort(i.begin(), i.end());
+    return false;
   }
-  removeDuplicates(goodTracksThatMeet);
 
-  return goodTracksThatMeet;
+  float vertexchi2ndof = particleVertex.GetChi2() / particleVertex.GetNDF();
+  float sv_radial_position = sqrt(pow(particleVertex.GetX(), 2) + pow(particleVertex.GetY(), 2));
+
+  if ((unsigned int) nRequiredTracks == nProngs && m_verbosity >= 10)
+  {
+    printSelectionCheck("This SV combination", "passed", "failed", "the quality and radius selection", (vertexchi2ndof <= m_vertex_chi2ndof) && (sv_radial_position >= m_min_radial_SV));
+    if (m_verbosity >= 11)
+    {
+      printSelectionCheck("SV chi^2/nDoF", 0., vertexchi2ndof, m_vertex_chi2ndof);
+      printSelectionCheck("SV radius", m_min_radial_SV, sv_radial_position, std::numeric_limits<float>::max());
+    }
+  }
+
+  if ((unsigned int) nRequiredTracks == nProngs)
+  {
+    if (vertexchi2ndof > m_vertex_chi2ndof)
+    {
+      return false;
+    }
+
+    if (sv_radial_position < m_min_radial_SV)
+    {
+      return false;
+    }
+
+    bool rejectComboDueToTrack = false;
+
+    for (auto &track : dummy_tracks)
+    {
+      bool trackPassesCuts = isGoodTrack(track, primaryVertices);
+      if (!trackPassesCuts)
+      {
+        rejectComboDueToTrack = true;
+      }
+    }
+
+    if (rejectComboDueToTrack)
+    {
+      return false;
+    }
+  }
+
+  return true;
 }
 
 std::vector<std::vector<int>> KFParticle_Tools::appendTracksToIntermediates(KFParticle intermediateResonances[], const std::vector<KFParticle> &daughterParticles, const std::vector<int> &goodTrackIndex, int num_remaining_tracks, const std::vector<KFParticle> &primaryVertices)
@@ -1314,12 +1373,34 @@ void KFParticle_Tools::removeDuplicates(std::vector<int> &v)
 
 void KFParticle_Tools::removeDuplicates(std::vector<std::vector<int>> &v)
 {
-  auto end = v.end();
-  for (auto it = v.begin(); it != end; ++it)
+  // keeps the first of equal combinations, in their original order
+  std::vector<size_t> order(v.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&v](size_t a, size_t b)
+                   { return v[a] < v[b]; });
+
+  std::vector<unsigned char> duplicate(v.size(), 0);
+  for (size_t i = 1; i < order.size(); ++i)
   {
-    end = remove(it + 1, end, *it);
+    if (v[order[i]] == v[order[i - 1]])
+    {
+      duplicate[order[i]] = 1;
+    }
   }
-  v.erase(end, v.end());
+
+  size_t nUnique = 0;
+  for (size_t i = 0; i < v.size(); ++i)
+  {
+    if (!duplicate[i])
+    {
+      if (nUnique != i)
+      {
+        v[nUnique] = std::move(v[i]);
+      }
+      ++nUnique;
+    }
+  }
+  v.resize(nUnique);
 }
 
 void KFParticle_Tools::removeDuplicates(std::vector<std::vector<std::string>> &v)
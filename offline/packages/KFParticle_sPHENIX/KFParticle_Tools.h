@@ -75,13 +75,20 @@ class KFParticle_Tools : protected KFParticle_MVA
 
   std::vector<int> findAllGoodTracks(const std::vector<KFParticle> &daughterParticles);//, const std::vector<KFParticle> &primaryVertices);
 
-  std::vector<std::vector<int>> findTwoProngs(std::vector<KFParticle> daughterParticles, std::vector<int> goodTrackIndex, int nTracks, const std::vector<KFParticle> &primaryVertices);
+  /// Pairs are first required to share a bunch crossing, using the crossings of all tracks looked up once.
+  /// The vertex fits of the remaining pairs run on m_num_threads threads
+  std::vector<std::vector<int>> findTwoProngs(const std::vector<KFParticle> &daughterParticles, const std::vector<int> &goodTrackIndex, int nTracks, const std::vector<KFParticle> &primaryVertices);
+
+  bool isGoodTwoProng(const KFParticle &track_a, const KFParticle &track_b, int nTracks, const std::vector<KFParticle> &primaryVertices);
 
   std::vector<std::vector<int>> findNProngs(const std::vector<KFParticle> &daughterParticles,
                                             const std::vector<int> &goodTrackIndex,
-                                            std::vector<std::vector<int>> goodTracksThatMeet,
+                                            const std::vector<std::vector<int>> &goodTracksThatMeet,
                                             int nRequiredTracks, unsigned int nProngs, const std::vector<KFParticle> &primaryVertices);
 
+  bool isGoodNProng(const std::vector<KFParticle> &daughterParticles, const std::vector<int> &combination,
+                    int nRequiredTracks, unsigned int nProngs, const std::vector<KFParticle> &primaryVertices);
+
   std::vector<std::vector<int>> appendTracksToIntermediates(KFParticle intermediateResonances[], const std::vector<KFParticle> &daughterParticles, const std::vector<int> &goodTrackIndex, int num_remaining_tracks, const std::vector<KFParticle> &primaryVertices);
 
   /// Calculates the cosine of the angle betweent the flight direction and momentum
@@ -266,6 +273,8 @@ class KFParticle_Tools : protected KFParticle_MVA
 
   bool m_require_track_and_vertex_match{false};
 
+  int m_num_threads{1};
+
   std::string m_vtx_map_node_name;
   std::string m_trk_map_node_name;
   GlobalVertexMap *m_dst_globalvertexmap{nullptr};
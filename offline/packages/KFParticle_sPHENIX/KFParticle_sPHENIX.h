@@ -212,6 +212,9 @@ class KFParticle_sPHENIX : public SubsysReco, public KFParticle_nTuple, public K
 
   void setMaximumVertexchi2nDOF(float vertexchi2nDOF) { m_vertex_chi2ndof = vertexchi2nDOF; }
 
+  /// threads for the two prong vertex fits, 1 by default, 0 uses all available
+  void setNumberOfThreads(int nthreads) { m_num_threads = nthreads; }
+
   void setFlightDistancechi2(float fdchi2) { m_fdchi2 = fdchi2; }
 
   void setMinDIRA(float dira_min) { m_dira_min = dira_min; }
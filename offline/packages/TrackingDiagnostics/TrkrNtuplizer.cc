@@ -2047,7 +2047,7 @@ void TrkrNtuplizer::FillTrack(float fX[50], SvtxTrack* track, GlobalVertexMap* v
       fX[n_track::ntrknprdedx] = f_proton_minus->Eval(-trptot);
     }
 
-    for (SvtxTrack::ConstClusterKeyIter iter_local = tpcseed->begin_cluster_keys();
+    for (TrackSeed::ConstClusterKeyIter iter_local = tpcseed->begin_cluster_keys();
          iter_local != tpcseed->end_cluster_keys();
          ++iter_local)
     {
@@ -2090,7 +2090,7 @@ void TrkrNtuplizer::FillTrack(float fX[50], SvtxTrack* track, GlobalVertexMap* v
   }
   if (silseed)
   {
-    for (SvtxTrack::ConstClusterKeyIter iter_local = silseed->begin_cluster_keys();
+    for (TrackSeed::ConstClusterKeyIter iter_local = silseed->begin_cluster_keys();
          iter_local != silseed->end_cluster_keys();
          ++iter_local)
     {
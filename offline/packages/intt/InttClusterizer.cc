@@ -4,7 +4,7 @@
 #include <trackbase/InttDefs.h>
 #include <trackbase/TrkrClusterContainerv4.h>
 #include <trackbase/TrkrClusterCrossingAssocv1.h>
-#include <trackbase/TrkrClusterHitAssocv3.h>
+#include <trackbase/TrkrClusterHitAssocv4.h>
 #include <trackbase/TrkrClusterv5.h>
 #include <trackbase/TrkrHit.h>
 #include <trackbase/TrkrHitSet.h>
@@ -163,7 +163,7 @@ int InttClusterizer::InitRun(PHCompositeNode* topNode)
       dstNode->addNode(DetNode);
     }
 
-    clusterhitassoc = new TrkrClusterHitAssocv3;
+    clusterhitassoc = new TrkrClusterHitAssocv4;
     PHIODataNode<PHObject>* newNode = new PHIODataNode<PHObject>(clusterhitassoc, "TRKR_CLUSTERHITASSOC", "PHObject");
     DetNode->addNode(newNode);
   }
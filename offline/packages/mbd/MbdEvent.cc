@@ -202,6 +202,7 @@ int MbdEvent::InitRun()
     for (int ifeech = 0; ifeech < MbdDefs::BBC_N_FEECH; ifeech++)
     {
       _mbdsig[ifeech].SetCalib(_mbdcal);
+      _mbdsig[ifeech].SetMinuitCheck(_doeval > 0);
 
       // Do evt-by-evt pedestal using sample range below
       if ( _calpass==1 || _is_online || _no_sampmax>0 )
@@ -432,6 +433,7 @@ int MbdEvent::End()
     {
       sig.WritePedvsEvent();
       sig.WriteChi2Hist();
+      sig.WriteMinuitCheckHists();
     }
 
     orig_dir->cd();
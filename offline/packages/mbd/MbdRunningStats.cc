@@ -4,57 +4,63 @@
 #include <iostream>
  
 MbdRunningStats::MbdRunningStats(const unsigned int imaxnum) :
-  maxnum{imaxnum}
+  values(imaxnum)
+  , maxnum{imaxnum}
 {
   Clear();
 }
 
 void MbdRunningStats::Clear()
 {
-  while ( !values.empty() )
-  {
-    values.pop();
-  }
+  first = 0;
+  nvalues = 0;
   S1 = S2 = 0.0;
 }
 
 void MbdRunningStats::Push(double x)
 {
+  if ( maxnum == 0 )
+  {
+    return;
+  }
+
   if ( Size() == maxnum )
   {
-    double lastval = values.front();
-    values.pop();
+    double lastval = values[first];
+    first = (first + 1) % maxnum;
+    nvalues--;
     S1 -= lastval;
     S2 -= (lastval*lastval);
   }
 
-  values.push(x);
+  values[(first + nvalues) % maxnum] = static_cast<int>(x);
+  nvalues++;
   S1 += x;
   S2 += (x*x);
 }
 
 double MbdRunningStats::Mean() const
 {
-  if ( values.empty() ) 
+  if ( nvalues == 0 ) 
   {
     //return std::numeric_limits<double>::infinity();
     //return std::numeric_limits<float>::quiet_NaN();
     return 0.;
   }
 
-  return S1/values.size();
+  return S1/nvalues;
 }
 
 double MbdRunningStats::Variance() const
 {
-  if ( values.empty() ) 
+  if ( nvalues == 0 ) 
   {
     //return std::numeric_limits<double>::infinity();
     //return std::numeric_limits<float>::quiet_NaN();
     return 0.;
   }
 
-  double var = (S2/values.size()) - (Mean()*Mean());
+  double var = (S2/nvalues) - (Mean()*Mean());
   /*
   std::cout << "RMS " << S2 << "\t" << values.size() << "\t" << Mean() << "\t" << Mean()*Mean() << "\t" << var << std::endl;
   */
@@ -1,10 +1,11 @@
 #ifndef __MBDRUNNINGSTATS_H__
 #define __MBDRUNNINGSTATS_H__
  
-#include <queue>
+#include <vector>
 
 /**
  * Class to calculate running average and RMS
+ * The last maxnum values are kept in a ring buffer, so that Push() does not allocate
  */
 class MbdRunningStats
 {
@@ -13,7 +14,7 @@ public:
   void Clear();
   void Push(double x);
 
-  unsigned int Size() const { return static_cast<unsigned int>(values.size()); }
+  unsigned int Size() const { return nvalues; }
   unsigned int MaxNum() const { return maxnum; }
 
   double Mean() const;
@@ -22,8 +23,10 @@ public:
   double RMS() const;
 
 private:
-  std::queue<int> values;
+  std::vector<int> values;
   unsigned int maxnum; // max values in sum
+  unsigned int first{0};   // oldest value in ring buffer
+  unsigned int nvalues{0}; // values in ring buffer
   double S1{0.};  // sum of values
   double S2{0.};  // sum of squares
 };
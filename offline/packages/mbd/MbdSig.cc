@@ -11,17 +11,145 @@
 #include <TH2.h>
 #include <TMath.h>
 #include <TPad.h>
+#include <TProfile.h>
 #include <TSpectrum.h>
-#include <TSpline.h>
 #include <TTree.h>
-#include <TVirtualFitter.h>
 
 #include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <limits>
 
+namespace
+{
+  // adc values near the edge are not trusted
+  constexpr Double_t adc_saturated = 16370.;
+
+  // range of the pedestal hists, only values inside are used for the event pedestal
+  constexpr Double_t ped_hist_min = -0.5;
+  constexpr Double_t ped_hist_max = 2999.5;
+
+  // compass search stops when the steps are below this fraction of the initial steps
+  constexpr Double_t compass_tolerance = 1e-4;
+  constexpr int compass_maxcalls = 2000;
+
+  /**
+   * chi2 (unit errors) of a sum of nshape shapes to the points with x in [xmin,xmax], x is increasing.
+   * shape(x,f) fills the shapes at x and returns false if the point is rejected.
+   * The amplitudes of the shapes are linear parameters and are solved in closed form
+   */
+  template <int nshape, class Shape>
+  Double_t linear_chi2(const std::vector<Double_t> &x, const std::vector<Double_t> &y, const int n,
+                       const Double_t xmin, const Double_t xmax, Shape shape, Double_t *ampl, int &npoints)
+  {
+    Double_t a[nshape][nshape]{};
+    Double_t b[nshape]{};
+    Double_t f[nshape]{};
+    Double_t sumy2 = 0.;
+    npoints = 0;
+    for (int i = 0; i < n && x[i] <= xmax; i++)
+    {
+      if (x[i] < xmin || !shape(x[i], f))
+      {
+        continue;
+      }
+      npoints++;
+      sumy2 += y[i] * y[i];
+      for (int j = 0; j < nshape; j++)
+      {
+        b[j] += f[j] * y[i];
+        for (int k = 0; k < nshape; k++)
+        {
+          a[j][k] += f[j] * f[k];
+        }
+      }
+    }
+
+    ampl[0] = (a[0][0] > 0.) ? b[0] / a[0][0] : 0.;
+    if constexpr (nshape == 2)
+    {
+      ampl[1] = 0.;
+      const Double_t det = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+      if (std::abs(det) > 1e-12 * a[0][0] * a[1][1])
+      {
+        ampl[0] = (b[0] * a[1][1] - b[1] * a[0][1]) / det;
+        ampl[1] = (a[0][0] * b[1] - a[1][0] * b[0]) / det;
+      }
+    }
+
+    // sum of (y - ampl*f)^2, from the sums of the normal equations
+    Double_t chi2 = sumy2;
+    for (int j = 0; j < nshape; j++)
+    {
+      chi2 -= 2. * ampl[j] * b[j];
+      for (int k = 0; k < nshape; k++)
+      {
+        chi2 += ampl[j] * a[j][k] * ampl[k];
+      }
+    }
+
+    return std::max(chi2, 0.);
+  }
+
+  /**
+   * local minimum of fcn(par) with a compass search,
+   * starting from par, with initial steps step0 that are halved when no step improves fcn
+   */
+  template <class Fcn>
+  void compass_minimize(const int npar, Double_t *par, const Double_t *step0, Fcn fcn)
+  {
+    Double_t fmin = fcn(par);
+    Double_t scale = 1.;
+    int ncalls = 1;
+    while (scale > compass_tolerance && ncalls < compass_maxcalls)
+    {
+      bool improved = false;
+      for (int ipar = 0; ipar < npar && !improved; ipar++)
+      {
+        for (const Double_t dir : {1., -1.})
+        {
+          const Double_t start = par[ipar];
+          par[ipar] = start + dir * scale * step0[ipar];
+          const Double_t f = fcn(par);
+          ncalls++;
+          if (f < fmin)
+          {
+            fmin = f;
+            improved = true;
+            break;
+          }
+          par[ipar] = start;
+        }
+      }
+
+      if (!improved)
+      {
+        scale *= 0.5;
+      }
+    }
+  }
+
+  // microseconds since start, for the fit times of the Minuit check
+  Double_t elapsed_us(const std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<Double_t, std::micro>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  // SignalTail shape, for unit amplitude
+  Double_t signal_tail(const Double_t x, const Double_t time, const Double_t width)
+  {
+    if ((x - time) < 0.)
+    {
+      return 1.;
+    }
+    return TMath::Gaus(x, time, width);
+  }
+}  // namespace
+
 MbdSig::MbdSig(const int chnum, const int nsamp)
   : _ch{chnum}
   , _nsamples{nsamp}
@@ -59,13 +187,14 @@ void MbdSig::Init()
 
   ped0stats = new MbdRunningStats(8);  // use the last 8 samples for running pedestal
 
+  m_xsamp.resize(_nsamples);
+  m_rawsamp.resize(_nsamples);
+  m_subsamp.resize(_nsamples);
+
   name = "hPed0_";
   name += _ch;
-  hPed0 = new TH1F(name, name, 3000, -0.5, 2999.5);
+  hPed0 = new TH1F(name, name, 3000, ped_hist_min, ped_hist_max);
   // hPed0 = new TH1F(name,name,10000,1,0); // automatically determine the range
-  name = "hPedEvt_";
-  name += _ch;
-  hPedEvt = new TH1F(name, name, 3000, -0.5, 2999.5);
   if ( _pedstudyflag )
   {
     gPedvsEvent = new TGraphErrors();
@@ -86,6 +215,23 @@ void MbdSig::Init()
   name = "h_chi2ndf"; name += _ch;
   h_chi2ndf = new TH1F(name,name,2000,0,100);
 
+  // Minuit check, the refits are less constrained than the first fit
+  const std::array<const char *, kNMinuitCheckFits> minuit_fitname{"", "_twotemplate", "_saturated", "_pileup", "_pileuptail"};
+  for (int ifit = 0; ifit < kNMinuitCheckFits; ifit++)
+  {
+    const Double_t dtmax = (ifit == kFirstFit) ? 0.5 : 5.;
+    const Double_t damax = (ifit == kFirstFit) ? 0.05 : 0.5;
+    name = "h_minuit_dtime"; name += minuit_fitname[ifit]; name += _ch;
+    h_minuit_dtime[ifit] = new TH1F(name,name,1000,-dtmax,dtmax);
+    name = "h_minuit_dampl"; name += minuit_fitname[ifit]; name += _ch;
+    h_minuit_dampl[ifit] = new TH1F(name,name,1000,-damax,damax);
+  }
+  const Double_t nfits = kNMinuitCheckFits;
+  name = "h_compass_us"; name += _ch;
+  h_compass_us = new TProfile(name,name,kNMinuitCheckFits,-0.5,nfits-0.5);
+  name = "h_minuit_us"; name += _ch;
+  h_minuit_us = new TProfile(name,name,kNMinuitCheckFits,-0.5,nfits-0.5);
+
   // uncomment this to write out waveforms from events that have pileup from prev. crossing or next crossing
   /*
   name = "mbdsig"; name += _ch; name += ".txt";
@@ -142,24 +288,28 @@ MbdSig::~MbdSig()
   {
     _pileupfile->close();
   }
-  // ROOT keeps the current fitter as a process-wide cache after Fit().
-  TVirtualFitter::SetFitter(nullptr, 0);
   delete hRawPulse;
   delete hSubPulse;
   delete gRawPulse;
   delete gSubPulse;
   delete ped0stats;
   delete hPed0;
-  delete hPedEvt;
   delete h2Template;
   delete h2Residuals;
   delete hAmpl;
   delete hTime;
   delete template_fcn;
   delete twotemplate_fcn;
-  delete ped_fcn;
   delete fit_pileup;
+  delete ped_fcn;
   delete h_chi2ndf;
+  for (int ifit = 0; ifit < kNMinuitCheckFits; ifit++)
+  {
+    delete h_minuit_dtime[ifit];
+    delete h_minuit_dampl[ifit];
+  }
+  delete h_compass_us;
+  delete h_minuit_us;
   if ( _pedstudyflag )
   {
     delete gPedvsEvent;
@@ -183,6 +333,10 @@ void MbdSig::SetCalib(MbdCalib *m)
   _pileup_p0 = m->get_pileup(_ch,0);
   _pileup_p1 = m->get_pileup(_ch,1);
   _pileup_p2 = m->get_pileup(_ch,2);
+  for (int ipar=0; ipar<4; ipar++)
+  {
+    _pileup_tcorr[ipar] = m->get_pileup(_ch,ipar+1);
+  }
 }
 
 // This sets y, and x to sample number (starts at 0)
@@ -193,14 +347,18 @@ void MbdSig::SetY(const Float_t* y, const int invert)
     Init();
   }
 
-  hpulse->Reset();
   f_ampl = -9999.;
   f_time = -9999.;
 
+  m_xsamp.resize(_nsamples);
+  m_rawsamp.resize(_nsamples);
+  m_subsamp.resize(_nsamples);
+  m_rawerr = 0.;  // no errors on raw samples
+
   for (int isamp = 0; isamp < _nsamples; isamp++)
   {
-    hRawPulse->SetBinContent(isamp + 1, y[isamp]);
-    gRawPulse->SetPoint(isamp, Double_t(isamp), y[isamp]);
+    m_xsamp[isamp] = isamp;
+    m_rawsamp[isamp] = y[isamp];
   }
 
   // Apply pedestal
@@ -227,11 +385,9 @@ void MbdSig::SetY(const Float_t* y, const int invert)
 
     for (int isamp = 0; isamp < _nsamples; isamp++)
     {
-      hSubPulse->SetBinContent(isamp + 1, invert * (y[isamp] - ped0));
-      hSubPulse->SetBinError(isamp + 1, ped0rms);
-      gSubPulse->SetPoint(isamp, (Double_t) isamp, invert * (y[isamp] - ped0));
-      gSubPulse->SetPointError(isamp, 0., ped0rms);
+      m_subsamp[isamp] = invert * (y[isamp] - ped0);
     }
+    m_nsubsamp = _nsamples;
 
     if ( ispileup==1 && !std::isnan(_pileup_p0) )
     {
@@ -248,8 +404,6 @@ void MbdSig::SetXY(const Float_t* x, const Float_t* y, const int invert)
     Init();
   }
 
-  hRawPulse->Reset();
-  hSubPulse->Reset();
   _status = 0;
 
   f_ampl = -9999.;
@@ -258,15 +412,20 @@ void MbdSig::SetXY(const Float_t* x, const Float_t* y, const int invert)
   // std::cout << "_nsamples " << _nsamples << std::endl;
   // std::cout << "use_ped0 " << use_ped0 << "\t" << ped0 << std::endl;
 
+  m_xsamp.resize(_nsamples);
+  m_rawsamp.resize(_nsamples);
+  m_subsamp.resize(_nsamples);
+  m_rawerr = 4.0;
+
   for (int isamp = 0; isamp < _nsamples; isamp++)
   {
     // std::cout << "aaa\t" << isamp << "\t" << x[isamp] << "\t" << y[isamp] << std::endl;
-    hRawPulse->SetBinContent(isamp + 1, y[isamp]);
-    gRawPulse->SetPoint(isamp, x[isamp], y[isamp]);
-    gRawPulse->SetPointError(isamp, 0, 4.0);
+    m_xsamp[isamp] = x[isamp];
+    m_rawsamp[isamp] = y[isamp];
   }
   if ( _verbose && _ch==9 )
   {
+    FillGraphs();
     gRawPulse->Draw("ap");
     gRawPulse->GetHistogram()->SetTitle(gRawPulse->GetName());
     gPad->SetGridx(1);
@@ -299,11 +458,9 @@ void MbdSig::SetXY(const Float_t* x, const Float_t* y, const int invert)
       {
         std::cout << "bbb ch " << _ch << "\t" << isamp << "\t" << x[isamp] << "\t" << invert*(y[isamp]-ped0) << std::endl;
       }
-      hSubPulse->SetBinContent(isamp + 1, invert * (y[isamp] - ped0));
-      hSubPulse->SetBinError(isamp + 1, ped0rms);
-      gSubPulse->SetPoint(isamp, x[isamp], invert * (y[isamp] - ped0));
-      gSubPulse->SetPointError(isamp, 0., ped0rms);
+      m_subsamp[isamp] = invert * (y[isamp] - ped0);
     }
+    m_nsubsamp = _nsamples;
 
     if ( ispileup==1 )
     {
@@ -322,6 +479,44 @@ void MbdSig::SetXY(const Float_t* x, const Float_t* y, const int invert)
   _verbose = 0;
 }
 
+void MbdSig::FillGraphs()
+{
+  if (hRawPulse == nullptr)
+  {
+    return;
+  }
+
+  hRawPulse->Reset();
+  hSubPulse->Reset();
+
+  for (int isamp = 0; isamp < static_cast<int>(m_rawsamp.size()); isamp++)
+  {
+    hRawPulse->SetBinContent(isamp + 1, m_rawsamp[isamp]);
+    gRawPulse->SetPoint(isamp, m_xsamp[isamp], m_rawsamp[isamp]);
+    gRawPulse->SetPointError(isamp, 0, m_rawerr);
+  }
+
+  for (int isamp = 0; isamp < m_nsubsamp; isamp++)
+  {
+    hSubPulse->SetBinContent(isamp + 1, m_subsamp[isamp]);
+    hSubPulse->SetBinError(isamp + 1, ped0rms);
+    gSubPulse->SetPoint(isamp, m_xsamp[isamp], m_subsamp[isamp]);
+    gSubPulse->SetPointError(isamp, 0., ped0rms);
+  }
+}
+
+TH1 *MbdSig::GetHist()
+{
+  FillGraphs();
+  return hpulse;
+}
+
+TGraphErrors *MbdSig::GetGraph()
+{
+  FillGraphs();
+  return gpulse;
+}
+
 void MbdSig::Remove_Pileup()
 {
   _verbose = 0;
@@ -341,33 +536,22 @@ void MbdSig::Remove_Pileup()
 
   if ( (_ch/8)%2 == 0 )   // time ch
   {
-    double x_at_max = TMath::LocMax( 5, gSubPulse->GetY() );
+    Long64_t x_at_max = TMath::LocMax( 5, m_subsamp.data() );
 
     if ( x_at_max != 0 )
     {
       // time hit in prev crossing
-      if ( fit_pileup == nullptr )
-      {
-        TString name = "fit_pileup"; name += _ch;
-        fit_pileup = new TF1(name,"pol3",0,16000);
-        fit_pileup->SetLineColor(7);
-        for (int ipar=0; ipar<4; ipar++)
-        {
-          fit_pileup->SetParameter( ipar, _mbdcal->get_pileup(_ch,ipar+1) );
-        }
-      }
-
       int sampmax = _mbdcal->get_sampmax(_ch);
       if ( (sampmax-6) > 0 )
       {
-        double x_sampmax = gSubPulse->GetPointX(sampmax);
-        double y_sampmax = gSubPulse->GetPointY(sampmax);
-        double y_min6 = gSubPulse->GetPointY(sampmax-6);
+        double y_sampmax = m_subsamp[sampmax];
+        double y_min6 = m_subsamp[sampmax-6];
 
-        double offset = y_min6*fit_pileup->Eval(y_min6);
+        // pol3 correction
+        double corr = _pileup_tcorr[0] + y_min6*(_pileup_tcorr[1] + y_min6*(_pileup_tcorr[2] + y_min6*_pileup_tcorr[3]));
+        double offset = y_min6*corr;
 
-        hSubPulse->SetBinContent( sampmax + 1, y_sampmax - offset );
-        gSubPulse->SetPoint( sampmax, x_sampmax, y_sampmax - offset );
+        m_subsamp[sampmax] = y_sampmax - offset;
       }
       else
       {
@@ -382,79 +566,100 @@ void MbdSig::Remove_Pileup()
     else
     {
       // time hit in 2 crossings before
-      float offset = _pileup_p0*gSubPulse->GetPointY(0);
+      float offset = _pileup_p0*m_subsamp[0];
 
       for (int isamp = 0; isamp < _nsamples; isamp++)
       {
-        double x = gSubPulse->GetPointX(isamp);
-        double y = gSubPulse->GetPointY(isamp);
-
-        hSubPulse->SetBinContent( isamp + 1, y - offset );
-        gSubPulse->SetPoint( isamp, x, y - offset );
+        m_subsamp[isamp] -= offset;
       }
     }
   }
   else  // charge ch
   {
-    double ymax = TMath::MaxElement( 5, gSubPulse->GetY() );
-    double x_at_max = TMath::LocMax( 5, gSubPulse->GetY() );
+    double ymax = TMath::MaxElement( 5, m_subsamp.data() );
+    Long64_t x_at_max = TMath::LocMax( 5, m_subsamp.data() );
+
+    Double_t ampl{ymax};
+    Double_t par[2]{0., 0.};
 
     if ( x_at_max != 0 )
     {
       // Fit a pulse in prev crossing
-      template_fcn->SetParameters(ymax, x_at_max);
-      template_fcn->SetRange(0, x_at_max+2.1);
+      par[0] = x_at_max;
+      Double_t ndf{0.};
+      const auto fitstart = std::chrono::steady_clock::now();
+      FitTemplates(1, x_at_max+2.1, &ampl, par, ndf);
 
-      if (_verbose == 0)
+      if ( _minuitcheck )
       {
-        //std::cout << PHWHERE << std::endl;
-        gSubPulse->Fit(template_fcn, "RNQ");
+        const Double_t compass_us = elapsed_us(fitstart);
+        template_fcn->SetParameters(ymax, x_at_max);
+        MinuitCheck(kPileupFit, template_fcn, 0, x_at_max+2.1, 1, &ampl, par, compass_us);
       }
-      else
+
+      if (_verbose)
       {
         std::cout << "pre-pileup " << _ch << "\t" << x_at_max << "\t" << ymax << std::endl;
-        gSubPulse->Fit(template_fcn, "R");
+        template_fcn->SetParameters(ampl, par[0]);
+        template_fcn->SetRange(0, x_at_max+2.1);
+        FillGraphs();
         gSubPulse->Draw("ap");
         gSubPulse->GetHistogram()->SetTitle(gSubPulse->GetName());
+        template_fcn->Draw("same");
         gPad->SetGridy(1);
         PadUpdate();
-        //gSubPulse->Print("ALL");
       }
     }
     else
     {
-      // Fit the tail
-      if ( fit_pileup == nullptr )
-      {
-        TString name = "fit_pileup"; name += _ch;
-        //fit_pileup = new TF1(name,"gaus",-0.1,4.1);
-        fit_pileup = new TF1(name, this, &MbdSig::SignalTail, -0.1, 4.1, 3, "MbdSig", "SignalTail");
-        fit_pileup->SetLineColor(6);
-      }
+      // Fit the tail, the width is limited to twice the calibrated width
+      par[0] = _pileup_p1;
+      par[1] = _pileup_p2;
+      const Double_t maxwidth = (_pileup_p2 > 0.) ? 2*_pileup_p2 : DBL_MAX;
 
-      fit_pileup->SetRange(-0.1,4.1);
-      fit_pileup->SetParameters( _pileup_p0*gSubPulse->GetPointY(0), _pileup_p1, _pileup_p2 );
-
-      // fix par limits
-      double plow{0.};
-      double phigh{0.};
-      fit_pileup->GetParLimits(2,plow,phigh);
-      if ( phigh < _pileup_p2 )
+      auto chi2 = [this, maxwidth](const Double_t *p)
+      {
+        if ( p[1] < 0. || p[1] > maxwidth )
+        {
+          return DBL_MAX;
+        }
+        Double_t a{0.};
+        int npoints{0};
+        return linear_chi2<1>(m_xsamp, m_subsamp, m_nsubsamp, -0.1, 4.1, [p](const Double_t x, Double_t *f)
+                              { f[0] = signal_tail(x, p[0], p[1]); return true; }, &a, npoints);
+      };
+      const Double_t step[2]{0.25, 0.1*std::max(std::abs(par[1]), 1.)};
+      const auto fitstart = std::chrono::steady_clock::now();
+      compass_minimize(2, par, step, chi2);
+
+      int npoints{0};
+      linear_chi2<1>(m_xsamp, m_subsamp, m_nsubsamp, -0.1, 4.1, [&par](const Double_t x, Double_t *f)
+                     { f[0] = signal_tail(x, par[0], par[1]); return true; }, &ampl, npoints);
+
+      // the previous SignalTail fit, (ampl, time, width) with the width limit
+      if ( _minuitcheck )
       {
-        phigh = 2*_pileup_p2;
-        fit_pileup->SetParLimits(2,plow,phigh);
+        const Double_t compass_us = elapsed_us(fitstart);
+        if ( fit_pileup == nullptr )
+        {
+          TString name = "fit_pileup"; name += _ch;
+          fit_pileup = new TF1(name, this, &MbdSig::SignalTail, -0.1, 4.1, 3, "MbdSig", "SignalTail");
+          fit_pileup->SetLineColor(6);
+        }
+        fit_pileup->SetParameters( _pileup_p0*m_subsamp[0], _pileup_p1, _pileup_p2 );
+        if ( _pileup_p2 > 0. )
+        {
+          fit_pileup->SetParLimits( 2, 0., maxwidth );
+        }
+        MinuitCheck(kPileupTailFit, fit_pileup, -0.1, 4.1, 1, &ampl, par, compass_us);
       }
 
       if ( _verbose )
       {
-        gSubPulse->Fit( fit_pileup, "R" );
+        FillGraphs();
         gSubPulse->Draw("ap");
         PadUpdate();
       }
-      else
-      {
-        gSubPulse->Fit( fit_pileup, "RNQ" );
-      }
     }
 
     // subtract pre-pulse
@@ -464,26 +669,27 @@ void MbdSig::Remove_Pileup()
       double bkg = 0.;
       if ( x_at_max != 0 )
       { 
-        bkg = template_fcn->Eval(isamp);
+        Double_t value{0.};
+        TemplatePoint(isamp, par[0], value);
+        bkg = ampl*value;
       }
       else
       {
-        bkg = fit_pileup->Eval(isamp);
+        bkg = ampl*signal_tail(isamp, par[0], par[1]);
       }
 
-      double x = gSubPulse->GetPointX(isamp);
-      double y = gSubPulse->GetPointY(isamp);
+      double y = m_subsamp[isamp];
 
       float newval = static_cast<float>( y - bkg );
 
-      hSubPulse->SetBinContent( isamp + 1, newval );
-      gSubPulse->SetPoint( isamp, x, newval );
+      m_subsamp[isamp] = newval;
     }
   }
 
   if ( _verbose )
   {
     std::cout << "pileup sub " << _ch << std::endl;
+    FillGraphs();
     gSubPulse->Draw("ap");
     PadUpdate();
   }
@@ -493,21 +699,97 @@ void MbdSig::Remove_Pileup()
 
 Double_t MbdSig::GetSplineAmpl()
 {
-  if (gSubPulse == nullptr)
+  const int n = m_nsubsamp;
+  if (n < 2)
   {
-    std::cout << "gsub bad " << (uint64_t) gSubPulse << std::endl;
+    std::cout << "gsub bad " << n << std::endl;
     return 0.;
   }
 
-  TSpline3 s3("s3", gSubPulse);
+  // cubic spline through the samples, with not-a-knot end conditions (as TSpline3).
+  // b are the slopes at the samples, from a tridiagonal system with diagonal c and upper diagonal d,
+  // then c and d are reused for the polynomial coefficients
+  const std::vector<Double_t>& x = m_xsamp;
+  const std::vector<Double_t>& y = m_subsamp;
+  std::vector<Double_t>& b = m_spline_b;
+  std::vector<Double_t>& c = m_spline_c;
+  std::vector<Double_t>& d = m_spline_d;
+  b.assign(n, 0.);
+  c.assign(n, 0.);
+  d.assign(n, 0.);
+
+  if (n == 2)
+  {
+    b[0] = b[1] = (y[1] - y[0]) / (x[1] - x[0]);
+  }
+  else if (n == 3)
+  {
+    // parabola
+    const Double_t h0 = x[1] - x[0];
+    const Double_t h1 = x[2] - x[1];
+    const Double_t del0 = (y[1] - y[0]) / h0;
+    const Double_t del1 = (y[2] - y[1]) / h1;
+    const Double_t curv = (del1 - del0) / (h0 + h1);
+    b[0] = del0 - curv * h0;
+    b[1] = del0 + curv * h0;
+    b[2] = del1 + curv * h1;
+  }
+  else
+  {
+    auto h = [&x](const int i) { return x[i + 1] - x[i]; };
+    auto del = [&x, &y](const int i) { return (y[i + 1] - y[i]) / (x[i + 1] - x[i]); };
+
+    c[0] = h(1);
+    d[0] = h(0) + h(1);
+    b[0] = ((h(0) + 2. * d[0]) * h(1) * del(0) + h(0) * h(0) * del(1)) / d[0];
+    for (int i = 1; i < n - 1; i++)
+    {
+      c[i] = 2. * (h(i - 1) + h(i));
+      d[i] = h(i - 1);
+      b[i] = 3. * (h(i) * del(i - 1) + h(i - 1) * del(i));
+    }
+    const Double_t g = h(n - 3) + h(n - 2);
+    c[n - 1] = h(n - 3);
+    b[n - 1] = ((h(n - 2) + 2. * g) * h(n - 3) * del(n - 2) + h(n - 2) * h(n - 2) * del(n - 3)) / g;
+
+    // Thomas algorithm, the lower diagonal is h(i), and g in the last row
+    for (int i = 1; i < n; i++)
+    {
+      const Double_t w = ((i < n - 1) ? h(i) : g) / c[i - 1];
+      c[i] -= w * d[i - 1];
+      b[i] -= w * b[i - 1];
+    }
+    b[n - 1] /= c[n - 1];
+    for (int i = n - 2; i >= 0; i--)
+    {
+      b[i] = (b[i] - d[i] * b[i + 1]) / c[i];
+    }
+  }
+
+  // cubic coefficients in each interval
+  for (int i = 0; i < n - 1; i++)
+  {
+    const Double_t dx = x[i + 1] - x[i];
+    const Double_t divdf1 = (y[i + 1] - y[i]) / dx;
+    const Double_t divdf3 = b[i] + b[i + 1] - 2. * divdf1;
+    c[i] = (divdf1 - b[i] - divdf3) / dx;
+    d[i] = (divdf3 / dx) / dx;
+  }
 
   // First find maximum, to rescale
   f_ampl = -999999.;
   double step_size = 0.01;
   // std::cout << "step size " << step_size << std::endl;
+  int k = 0;
   for (double ix = 0; ix < _nsamples; ix += step_size)
   {
-    Double_t val = s3.Eval(ix);
+    // interval, beyond the last sample the last interval is extrapolated
+    while (k < n - 2 && ix > x[k + 1])
+    {
+      k++;
+    }
+    const Double_t dx = ix - x[k];
+    Double_t val = y[k] + dx * (b[k] + dx * (c[k] + dx * d[k]));
     f_ampl = std::max(val, f_ampl);
   }
 
@@ -519,6 +801,39 @@ void MbdSig::WriteChi2Hist()
   h_chi2ndf->Write();
 }
 
+void MbdSig::WriteMinuitCheckHists()
+{
+  for (int ifit = 0; ifit < kNMinuitCheckFits; ifit++)
+  {
+    h_minuit_dtime[ifit]->Write();
+    h_minuit_dampl[ifit]->Write();
+  }
+  h_compass_us->Write();
+  h_minuit_us->Write();
+}
+
+void MbdSig::MinuitCheck(const MinuitCheckFit ifit, TF1 *fcn, const Double_t xmin, const Double_t xmax,
+                         const int npulses, const Double_t *ampl, const Double_t *time, const Double_t compass_us)
+{
+  FillGraphs();
+  fcn->SetRange(xmin, xmax);
+
+  const auto start = std::chrono::steady_clock::now();
+  gSubPulse->Fit(fcn, "RNQ");
+  h_minuit_us->Fill(ifit, elapsed_us(start));
+  h_compass_us->Fill(ifit, compass_us);
+
+  for (int ipulse = 0; ipulse < npulses; ipulse++)
+  {
+    h_minuit_dtime[ifit]->Fill( time[ipulse] - fcn->GetParameter(2*ipulse+1) );
+    Double_t minuit_ampl = fcn->GetParameter(2*ipulse);
+    if ( minuit_ampl != 0. )
+    {
+      h_minuit_dampl[ifit]->Fill( (ampl[ipulse] - minuit_ampl)/minuit_ampl );
+    }
+  }
+}
+
 void MbdSig::WritePedHist()
 {
   hPed0->Write();
@@ -534,12 +849,9 @@ void MbdSig::WritePedvsEvent()
 
 void MbdSig::FillPed0(const Int_t sampmin, const Int_t sampmax)
 {
-  Double_t x;
-  Double_t y;
-  for (int isamp = sampmin; isamp <= sampmax; isamp++)
+  for (int isamp = std::max(sampmin, 0); isamp <= std::min(sampmax, static_cast<int>(m_rawsamp.size()) - 1); isamp++)
   {
-    gRawPulse->GetPoint(isamp, x, y);
-    // gRawPulse->Print("all");
+    Double_t y = m_rawsamp[isamp];
     hPed0->Fill(y);
 
     // std::cout << "ped0 " << _ch << " " << n << "\t" << ped0 << std::endl;
@@ -549,12 +861,11 @@ void MbdSig::FillPed0(const Int_t sampmin, const Int_t sampmax)
 
 void MbdSig::FillPed0(const Double_t begin, const Double_t end)
 {
-  Double_t x;
-  Double_t y;
-  Int_t n = gRawPulse->GetN();
+  Int_t n = static_cast<Int_t>(m_rawsamp.size());
   for (int isamp = 0; isamp < n; isamp++)
   {
-    gRawPulse->GetPoint(isamp, x, y);
+    Double_t x = m_xsamp[isamp];
+    Double_t y = m_rawsamp[isamp];
     if (x >= begin && x <= end)
     {
       hPed0->Fill(y);
@@ -590,24 +901,29 @@ void MbdSig::SetPed0(const Double_t mean, const Double_t rms)
 void MbdSig::CalcEventPed0(const Int_t minpedsamp, const Int_t maxpedsamp)
 {
   // if (_ch==8) std::cout << "In MbdSig::CalcEventPed0(int,int)" << std::endl;
-  hPedEvt->Reset();
-
-  Double_t x;
-  Double_t y;
-  for (int isamp = minpedsamp; isamp <= maxpedsamp; isamp++)
+  // mean and rms of the samples inside the pedestal hist range
+  Double_t sumw{0.};
+  Double_t sumy{0.};
+  Double_t sumy2{0.};
+  for (int isamp = std::max(minpedsamp, 0); isamp <= std::min(maxpedsamp, static_cast<int>(m_rawsamp.size()) - 1); isamp++)
   {
-    gRawPulse->GetPoint(isamp, x, y);
+    Double_t y = m_rawsamp[isamp];
 
     hPed0->Fill(y);
-    hPedEvt->Fill(y);
+    if ( y >= ped_hist_min && y < ped_hist_max )
+    {
+      sumw += 1.;
+      sumy += y;
+      sumy2 += y*y;
+    }
     // ped0stats->Push( y );
     // if ( _ch==8 ) std::cout << "ped0stats " << isamp << "\t" << y << std::endl;
   }
 
   // use straight mean for pedestal
   // Could consider using fit to hPed0 to remove outliers
-  float mean = hPedEvt->GetMean();
-  float rms = hPedEvt->GetRMS();
+  float mean = (sumw > 0.) ? sumy/sumw : 0.;
+  float rms = (sumw > 0.) ? std::sqrt(std::abs(sumy2/sumw - (sumy/sumw)*(sumy/sumw))) : 0.;
 
   SetPed0(mean, rms);
   // if (_ch==8) std::cout << "ped0stats mean, rms " << mean << "\t" << rms << std::endl;
@@ -616,27 +932,35 @@ void MbdSig::CalcEventPed0(const Int_t minpedsamp, const Int_t maxpedsamp)
 // Get Event by Event Ped0 if requested
 void MbdSig::CalcEventPed0(const Double_t minpedx, const Double_t maxpedx)
 {
-  hPedEvt->Reset();
-
-  Double_t x;
-  Double_t y;
-  Int_t n = gRawPulse->GetN();
+  // mean and rms of the samples inside the pedestal hist range
+  Double_t sumw{0.};
+  Double_t sumy{0.};
+  Double_t sumy2{0.};
+  Int_t n = static_cast<Int_t>(m_rawsamp.size());
 
   for (int isamp = 0; isamp < n; isamp++)
   {
-    gRawPulse->GetPoint(isamp, x, y);
+    Double_t x = m_xsamp[isamp];
+    Double_t y = m_rawsamp[isamp];
 
     if (x >= minpedx && x <= maxpedx)
     {
       hPed0->Fill(y);
-      hPedEvt->Fill(y);
+      if ( y >= ped_hist_min && y < ped_hist_max )
+      {
+        sumw += 1.;
+        sumy += y;
+        sumy2 += y*y;
+      }
       // ped0stats->Push( y );
     }
   }
 
   // use straight mean for pedestal
   // Could consider using fit to hPed0 to remove outliers
-  SetPed0(hPedEvt->GetMean(), hPedEvt->GetRMS());
+  Double_t mean = (sumw > 0.) ? sumy/sumw : 0.;
+  Double_t rms = (sumw > 0.) ? std::sqrt(std::abs(sumy2/sumw - mean*mean)) : 0.;
+  SetPed0(mean, rms);
 }
 
 // Get Event by Event Ped0, num samples before peak
@@ -654,7 +978,7 @@ int MbdSig::CalcEventPed0_PreSamp(const int presample, const int nsamps)
   Long64_t max = ped_presamp_maxsamp;
 
   // actual max from event
-  Long64_t actual_max = TMath::LocMax(gRawPulse->GetN(), gRawPulse->GetY());
+  Long64_t actual_max = TMath::LocMax(static_cast<Long64_t>(m_rawsamp.size()), m_rawsamp.data());
 
   if ( ped_presamp_maxsamp == -1 ) // if there is no maxsamp set, use the max found in this event
   {
@@ -700,12 +1024,34 @@ int MbdSig::CalcEventPed0_PreSamp(const int presample, const int nsamps)
     rms = 5.0;
   }
 
-  ped_fcn->SetRange(minsamp-0.1,maxsamp+0.1);
-  ped_fcn->SetParameter(0,1500.);
+  // fit of a constant to the samples in the ped range, which is their mean
+  int nsamp = static_cast<int>(m_rawsamp.size());
+  double pedfit = 0.;
+  int npedsamp = 0;
+  for (int isamp = 0; isamp < nsamp; isamp++)
+  {
+    if ( m_xsamp[isamp] >= (minsamp-0.1) && m_xsamp[isamp] <= (maxsamp+0.1) )
+    {
+      pedfit += m_rawsamp[isamp];
+      npedsamp++;
+    }
+  }
+  if ( npedsamp>0 )
+  {
+    pedfit /= npedsamp;
+  }
 
-  gRawPulse->Fit( ped_fcn, "RNQ" );
-  double chi2 = ped_fcn->GetChisquare();
-  double ndf = ped_fcn->GetNDF();
+  double chi2 = 0.;
+  double ndf = npedsamp - 1;
+  for (int isamp = 0; isamp < nsamp; isamp++)
+  {
+    if ( m_xsamp[isamp] >= (minsamp-0.1) && m_xsamp[isamp] <= (maxsamp+0.1) )
+    {
+      chi2 += (m_rawsamp[isamp]-pedfit)*(m_rawsamp[isamp]-pedfit);
+    }
+  }
+  double rawerr = (m_rawerr > 0.) ? m_rawerr : 1.;
+  chi2 /= (rawerr*rawerr);
 
   /*
   if ( chi2/ndf>4 )
@@ -716,27 +1062,27 @@ int MbdSig::CalcEventPed0_PreSamp(const int presample, const int nsamps)
 
   if ( _verbose )
   {
-    gRawPulse->Fit( ped_fcn, "RQ" );
+    ped_fcn->SetRange(minsamp-0.1,maxsamp+0.1);
+    ped_fcn->SetParameter(0,pedfit);
 
-    double chi2ndf = ped_fcn->GetChisquare()/ped_fcn->GetNDF();
+    double chi2ndf = chi2/ndf;
     if ( chi2ndf > 4.0 )
     {
+      FillGraphs();
       gRawPulse->Draw("ap");
       ped_fcn->Draw("same");
       PadUpdate();
     }
   }
 
-  if ( chi2/ndf < 4.0 )
+  if ( npedsamp>0 && chi2/ndf < 4.0 )
   {
-    mean = ped_fcn->GetParameter(0);
-
-    Double_t x;
-    Double_t y;
+    mean = pedfit;
 
-    for (int isamp = minsamp; isamp <= maxsamp; isamp++)
+    for (int isamp = minsamp; isamp <= std::min(maxsamp, nsamp-1); isamp++)
     {
-      gRawPulse->GetPoint(isamp, x, y);
+      Double_t x = m_xsamp[isamp];
+      Double_t y = m_rawsamp[isamp];
 
       // exclude outliers
       if ( fabs(y-mean) < 4.0*rms )
@@ -789,6 +1135,7 @@ int MbdSig::CalcEventPed0_PreSamp(const int presample, const int nsamps)
 
       if ( _verbose )
       {
+        FillGraphs();
         gRawPulse->Draw("ap");
         PadUpdate();
 
@@ -834,9 +1181,9 @@ Double_t MbdSig::LeadingEdge(const Double_t threshold)
   // Find first point above threshold
   // We also make sure the next point is above threshold
   // to get rid of a high fluctuation
-  int n = gSubPulse->GetN();
-  Double_t* x = gSubPulse->GetX();
-  Double_t* y = gSubPulse->GetY();
+  int n = m_nsubsamp;
+  const Double_t* x = m_xsamp.data();
+  const Double_t* y = m_subsamp.data();
 
   int sample = -1;
   for (int isamp = 0; isamp < n; isamp++)
@@ -870,9 +1217,9 @@ Double_t MbdSig::dCFD(const Double_t fraction_threshold)
   // Find first point above threshold
   // We also make sure the next point is above threshold
   // to get rid of a high fluctuation
-  int n = gSubPulse->GetN();
-  Double_t* x = gSubPulse->GetX();
-  Double_t* y = gSubPulse->GetY();
+  int n = m_nsubsamp;
+  const Double_t* x = m_xsamp.data();
+  const Double_t* y = m_subsamp.data();
 
   // Get max amplitude
   Double_t ymax = TMath::MaxElement(n, y);
@@ -915,9 +1262,9 @@ Double_t MbdSig::MBDTDC(const Int_t max_samp)
 {
   // Get the amplitude of a fixed sample (max_samp) to get time
   // Used in MBD Time Channels
-  Double_t* y = gSubPulse->GetY();
+  const Double_t* y = m_subsamp.data();
 
-  if (y == nullptr)
+  if (m_nsubsamp == 0)
   {
     std::cout << "ERROR y == 0" << std::endl;
     return std::numeric_limits<Double_t>::quiet_NaN();
@@ -943,9 +1290,9 @@ Double_t MbdSig::MBDTDC(const Int_t max_samp)
 
 Double_t MbdSig::Integral(const Double_t xmin, const Double_t xmax)
 {
-  Int_t n = gSubPulse->GetN();
-  Double_t* x = gSubPulse->GetX();
-  Double_t* y = gSubPulse->GetY();
+  Int_t n = m_nsubsamp;
+  const Double_t* x = m_xsamp.data();
+  const Double_t* y = m_subsamp.data();
 
   f_integral = 0.;
   for (int ix = 0; ix < n; ix++)
@@ -966,15 +1313,16 @@ void MbdSig::LocMax(Double_t& x_at_max, Double_t& ymax, Double_t xminrange, Doub
   _verbose = 0;
   if ( _verbose && _ch==250 )
   {
+    FillGraphs();
     gSubPulse->Draw("ap");
     gPad->Modified();
     gPad->Update();
   }
 
   // Find index of maximum peak
-  Int_t n = gSubPulse->GetN();
-  Double_t* x = gSubPulse->GetX();
-  Double_t* y = gSubPulse->GetY();
+  Int_t n = m_nsubsamp;
+  const Double_t* x = m_xsamp.data();
+  const Double_t* y = m_subsamp.data();
 
   // if flipped or equal, we search the whole range
   if (xmaxrange <= xminrange)
@@ -1017,9 +1365,9 @@ void MbdSig::LocMax(Double_t& x_at_max, Double_t& ymax, Double_t xminrange, Doub
 void MbdSig::LocMin(Double_t& x_at_min, Double_t& ymin, Double_t xminrange, Double_t xmaxrange)
 {
   // Find index of minimum peak (for neg signals)
-  Int_t n = gSubPulse->GetN();
-  Double_t* x = gSubPulse->GetX();
-  Double_t* y = gSubPulse->GetY();
+  Int_t n = m_nsubsamp;
+  const Double_t* x = m_xsamp.data();
+  const Double_t* y = m_subsamp.data();
 
   // if flipped or equal, we search the whole range
   if (xmaxrange <= xminrange)
@@ -1058,6 +1406,7 @@ void MbdSig::Print()
   Double_t x;
   Double_t y;
   std::cout << "CH " << _ch << std::endl;
+  FillGraphs();
   for (int isamp = 0; isamp < _nsamples; isamp++)
   {
     gpulse->GetPoint(isamp, x, y);
@@ -1073,6 +1422,7 @@ void MbdSig::DrawWaveform()
     _verbose = 6;
   }
 
+  FillGraphs();
   gSubPulse->Draw("ap");
   gSubPulse->GetHistogram()->SetTitle(gSubPulse->GetName());
   gPad->SetGridy(1);
@@ -1137,55 +1487,37 @@ Double_t MbdSig::TemplateFcn(const Double_t* x, const Double_t* par)
   // par[0] is the amplitude (relative to the spline amplitude)
   // par[1] is the start time (in sample number)
   // x[0] units are in sample number
-  Double_t xx = x[0] - par[1];
   Double_t f = 0.;
-
-  int verbose = 0;
-  if ( verbose )
+  if ( !TemplatePoint(x[0], par[1], f) )
   {
-    std::cout << PHWHERE << " " << _ch << " x par0 par1 " << x[0] << "\t" << par[0] << "\t" << par[1] << std::endl;
+    TF1::RejectPoint();
   }
 
+  return par[0] * f;
+}
+
+bool MbdSig::TemplatePoint(const Double_t x, const Double_t time, Double_t &value) const
+{
+  Double_t xx = x - time;
 
   // When fit is out of limits of good part of spline, ignore fit
   if (xx < template_begintime || xx > template_endtime || std::isnan(xx) )
   {
-    TF1::RejectPoint();
-
     if ( std::isnan(xx) )
     {
-      if (verbose > 0)
-      {
-	std::cout << PHWHERE << " " << _evt_counter << ", " << _ch
-		  << " ERROR x par0 par1 " << x[0] << "\t" << par[0] << "\t" << par[1] << std::endl;
-	if ( x[0] == 0. )
-	{
-	  gSubPulse->Print("ALL");
-	}
-      }
-      return 0.;
+      value = 0.;
     }
-
-    if (xx < template_begintime)
+    else if (xx < template_begintime)
     {
-      // Double_t x0,y0;
-      Double_t y0 = template_y[0];
-      return par[0] * y0;
+      value = template_y[0];
     }
-    if (xx > template_endtime)
+    else
     {
-      // Double_t x0,y0;
-      Double_t y0 = template_y[template_npointsx - 1];
-      return par[0] * y0;
+      value = template_y[template_npointsx - 1];
     }
+    return false;
   }
 
-  // Linear Interpolation of template
-  Double_t x0 = 0.;
-  Double_t y0 = 0.;
-  Double_t x1 = 0.;
-  Double_t y1 = 0.;
-
   // find the index in the vector which is closest to xx
   Double_t step = (template_endtime - template_begintime) / (template_npointsx - 1);
   Double_t index = (xx - template_begintime) / step;
@@ -1193,59 +1525,84 @@ Double_t MbdSig::TemplateFcn(const Double_t* x, const Double_t* par)
 
   int ilow = TMath::FloorNint(index);
   int ihigh = TMath::CeilNint(index);
-  if (ilow < 0 || ihigh >= template_npointsx)
+  if (ilow < 0)
   {
-    if (verbose > 0)
-    {
-      std::cout << "ERROR, ilow ihigh " << ilow << "\t" << ihigh << std::endl;
-      std::cout << " " << xx << " " << x[0] << " " << par[1] << std::endl;
-    }
-
-    if (ilow < 0)
-    {
-      ilow = 0;
-    }
-    else if (ihigh >= template_npointsx)
-    {
-      ihigh = template_npointsx - 1;
-    }
+    ilow = 0;
+  }
+  else if (ihigh >= template_npointsx)
+  {
+    ihigh = template_npointsx - 1;
   }
 
   if (ilow == ihigh)
   {
-    f = par[0] * template_y[ilow];
+    value = template_y[ilow];
   }
   else
   {
-    x0 = template_begintime + ilow * step;
-    y0 = template_y[ilow];
-    x1 = template_begintime + ihigh * step;
-    y1 = template_y[ihigh];
-    f = par[0] * (y0 + ((y1 - y0) / (x1 - x0)) * (xx - x0));  // linear interpolation
+    // Linear Interpolation of template
+    Double_t x0 = template_begintime + ilow * step;
+    Double_t y0 = template_y[ilow];
+    Double_t x1 = template_begintime + ihigh * step;
+    Double_t y1 = template_y[ihigh];
+    value = y0 + ((y1 - y0) / (x1 - x0)) * (xx - x0);
   }
 
   // reject points with very bad rms in shape
   /*
   if (template_yrms[ilow] >= 1.0 || template_yrms[ihigh] >= 1.0)
   {
-    TF1::RejectPoint();
-    // return f;
+    return false;
   }
   */
 
   // Reject points where ADC saturates
-  int samp_point = static_cast<int>(x[0]);
-  Double_t temp_x;
-  Double_t temp_y;
-  gRawPulse->GetPoint(samp_point, temp_x, temp_y);
-  if (temp_y > 16370)
+  int samp_point = static_cast<int>(x);
+  if (samp_point >= 0 && samp_point < static_cast<int>(m_rawsamp.size()) && m_rawsamp[samp_point] > adc_saturated)
   {
-    //if ( _ch==185 ) std::cout << "ADCSATURATED " << _ch << "\t" << samp_point << "\t" << temp_x << "\t" << temp_y << std::endl;
-    TF1::RejectPoint();
+    //if ( _ch==185 ) std::cout << "ADCSATURATED " << _ch << "\t" << samp_point << "\t" << m_rawsamp[samp_point] << std::endl;
+    return false;
   }
 
-  //verbose = 0;
-  return f;
+  return true;
+}
+
+Double_t MbdSig::TemplateChi2(const int ntemplates, const Double_t *time, const Double_t xmax, Double_t *ampl, int &npoints) const
+{
+  if ( ntemplates == 1 )
+  {
+    return linear_chi2<1>(m_xsamp, m_subsamp, m_nsubsamp, 0., xmax, [this, time](const Double_t x, Double_t *f)
+                          { return TemplatePoint(x, time[0], f[0]); }, ampl, npoints);
+  }
+
+  // a point is rejected if it is rejected for either template
+  return linear_chi2<2>(m_xsamp, m_subsamp, m_nsubsamp, 0., xmax, [this, time](const Double_t x, Double_t *f)
+                        {
+                          bool good0 = TemplatePoint(x, time[0], f[0]);
+                          bool good1 = TemplatePoint(x, time[1], f[1]);
+                          return good0 && good1; }, ampl, npoints);
+}
+
+Double_t MbdSig::FitTemplates(const int ntemplates, const Double_t xmax, Double_t *ampl, Double_t *time, Double_t &ndf) const
+{
+  // the amplitudes are linear, so only the times are searched for
+  auto chi2 = [this, ntemplates, xmax](const Double_t *t)
+  {
+    Double_t a[2]{0., 0.};
+    int npoints{0};
+    return TemplateChi2(ntemplates, t, xmax, a, npoints);
+  };
+  const Double_t step[2]{0.25, 0.25};
+  compass_minimize(ntemplates, time, step, chi2);
+
+  int npoints{0};
+  Double_t fitchi2 = TemplateChi2(ntemplates, time, xmax, ampl, npoints);
+  ndf = npoints - 2*ntemplates;
+
+  // all points have the pedestal rms as error
+  Double_t err = (ped0rms > 0.) ? ped0rms : 1.;
+
+  return fitchi2 / (err*err);
 }
 
 // sampmax>0 means fit to the peak near sampmax
@@ -1274,7 +1631,7 @@ int MbdSig::FitTemplate( const Int_t sampmax )
   f_fitmode = 0;
 
   // Check if channel is empty
-  if (gSubPulse->GetN() == 0)
+  if (m_nsubsamp == 0)
   {
     f_ampl = 0.;
     f_time = std::numeric_limits<Float_t>::quiet_NaN();
@@ -1283,12 +1640,10 @@ int MbdSig::FitTemplate( const Int_t sampmax )
   }
 
   // Determine if channel is saturated
-  Double_t *rawsamps = gRawPulse->GetY();
-  Int_t nrawsamps = gRawPulse->GetN();
   int nsaturated = 0;
-  for (int ipt=0; ipt<nrawsamps; ipt++)
+  for (const auto rawsamp : m_rawsamp)
   {
-    if ( rawsamps[ipt] > 16370. ) // don't trust adc near edge
+    if ( rawsamp > adc_saturated ) // don't trust adc near edge
     {
       nsaturated++;
     }
@@ -1313,11 +1668,11 @@ int MbdSig::FitTemplate( const Int_t sampmax )
   {
     for (int isamp=sampmax-1; isamp<=sampmax+1; isamp++)
     {
-      if ( (isamp>=gSubPulse->GetN()) )
+      if ( (isamp>=m_nsubsamp) )
       {
         continue;
       }
-      double adcval = gSubPulse->GetPointY(isamp);
+      double adcval = m_subsamp[isamp];
       if ( adcval>ymax )
       {
         ymax = adcval;
@@ -1337,8 +1692,8 @@ int MbdSig::FitTemplate( const Int_t sampmax )
   }
   else
   {
-    ymax = TMath::MaxElement( gSubPulse->GetN(), gSubPulse->GetY() );
-    x_at_max = TMath::LocMax( gSubPulse->GetN(), gSubPulse->GetY() );
+    ymax = TMath::MaxElement( m_nsubsamp, m_subsamp.data() );
+    x_at_max = TMath::LocMax( m_nsubsamp, m_subsamp.data() );
   }
 
   // Threshold cut
@@ -1350,6 +1705,7 @@ int MbdSig::FitTemplate( const Int_t sampmax )
     {
       // for checking pedestal
       std::cout << "skipping, ymax < 20" << std::endl;
+      FillGraphs();
       gSubPulse->Draw("ap");
       gSubPulse->GetHistogram()->SetTitle(gSubPulse->GetName());
       gPad->SetGridy(1);
@@ -1362,39 +1718,46 @@ int MbdSig::FitTemplate( const Int_t sampmax )
   }
 
   // Start with fit over early part of waveform to reduce pileup and afterpulse effects
-  template_fcn->SetParameters(ymax, x_at_max);
+  Double_t fitmax{0.};
   if ( nsaturated==0 )
   {
-    template_fcn->SetRange(0, x_at_max+4.2);
+    fitmax = x_at_max+4.2;
     f_fitmode = 1;
   }
   else
   {
-    template_fcn->SetRange(0, sampmax + nsaturated + 0.5);
+    fitmax = sampmax + nsaturated + 0.5;
     f_fitmode = 4;
   }
 
-  if (_verbose == 0)
+  // Get fit parameters
+  f_ampl = ymax;
+  f_time = x_at_max;
+  auto fitstart = std::chrono::steady_clock::now();
+  f_chi2 = FitTemplates(1, fitmax, &f_ampl, &f_time, f_ndf);
+  Double_t compass_us = elapsed_us(fitstart);
+
+  // same fit with Minuit, from the same start values
+  if ( _minuitcheck )
   {
-    //std::cout << PHWHERE << std::endl;
-    gSubPulse->Fit(template_fcn, "RNQ");
+    template_fcn->SetParameters(ymax, x_at_max);
+    MinuitCheck(kFirstFit, template_fcn, 0, fitmax, 1, &f_ampl, &f_time, compass_us);
   }
-  else
+  template_fcn->SetParameters(f_ampl, f_time);
+  template_fcn->SetRange(0, fitmax);
+
+  if (_verbose > 0)
   {
     std::cout << "doing fit1 " << x_at_max << "\t" << ymax << std::endl;
-    gSubPulse->Fit(template_fcn, "R");
+    FillGraphs();
     gSubPulse->Draw("ap");
     gSubPulse->GetHistogram()->SetTitle(gSubPulse->GetName());
+    template_fcn->Draw("same");
     gPad->SetGridy(1);
     PadUpdate();
     //gSubPulse->Print("ALL");
   }
 
-  // Get fit parameters
-  f_ampl = template_fcn->GetParameter(0);
-  f_time = template_fcn->GetParameter(1);
-  f_chi2 = template_fcn->GetChisquare();
-  f_ndf = template_fcn->GetNDF();
   Double_t chi2ndf = 1e9;
   if ( f_ndf>0. )
   {
@@ -1433,31 +1796,37 @@ int MbdSig::FitTemplate( const Int_t sampmax )
       PadUpdate();
     }
 
-    twotemplate_fcn->SetParameters(ymax,x_at_max,ymax,10);
-    twotemplate_fcn->SetRange(0,_nsamples-0.9);
+    Double_t ampls[2]{ymax, ymax};
+    Double_t times[2]{x_at_max, 10.};
+    Double_t newndf{0.};
+    fitstart = std::chrono::steady_clock::now();
+    Double_t newchi2 = FitTemplates(2, _nsamples-0.9, ampls, times, newndf);
+    compass_us = elapsed_us(fitstart);
 
-    if (_verbose == 0)
+    if ( _minuitcheck )
     {
-      gSubPulse->Fit(twotemplate_fcn, "RNQ");
+      twotemplate_fcn->SetParameters(ymax, x_at_max, ymax, 10.);
+      MinuitCheck(kTwoTemplateFit, twotemplate_fcn, 0, _nsamples-0.9, 2, ampls, times, compass_us);
     }
-    else
+    twotemplate_fcn->SetParameters(ampls[0], times[0], ampls[1], times[1]);
+    twotemplate_fcn->SetRange(0,_nsamples-0.9);
+
+    if (_verbose > 0)
     {
       std::cout << "doing 2wave fit " << x_at_max << "\t" << ymax << std::endl;
-      gSubPulse->Fit(twotemplate_fcn, "R");
       gSubPulse->Draw("ap");
       gSubPulse->GetHistogram()->SetTitle(gSubPulse->GetName());
+      twotemplate_fcn->Draw("same");
       gPad->SetGridy(1);
       PadUpdate();
       //gSubPulse->Print("ALL");
     }
 
     // Check two component fit
-    Double_t ampl1 = twotemplate_fcn->GetParameter(0);
-    Double_t time1 = twotemplate_fcn->GetParameter(1);
-    Double_t ampl2 = twotemplate_fcn->GetParameter(2);
-    Double_t time2 = twotemplate_fcn->GetParameter(3);
-    Double_t newchi2 = twotemplate_fcn->GetChisquare();
-    Double_t newndf = twotemplate_fcn->GetNDF();
+    Double_t ampl1 = ampls[0];
+    Double_t time1 = times[0];
+    Double_t ampl2 = ampls[1];
+    Double_t time2 = times[1];
     Double_t newchi2ndf = 0.;
     if ( newndf>0.) 
     {
@@ -1507,31 +1876,35 @@ int MbdSig::FitTemplate( const Int_t sampmax )
   }
 
   // Try a refit of saturated waveform with different range
-  template_fcn->SetParameters(ymax, x_at_max);
-  template_fcn->SetRange( 0., _nsamples-0.5 );
+  Double_t newampl{ymax};
+  Double_t newtime{x_at_max};
+  Double_t newndf{0.};
+  fitstart = std::chrono::steady_clock::now();
+  Double_t newchi2 = FitTemplates(1, _nsamples-0.5, &newampl, &newtime, newndf);
+  compass_us = elapsed_us(fitstart);
 
-  if (_verbose == 0)
+  if ( _minuitcheck )
   {
-    //std::cout << PHWHERE << std::endl;
-    gSubPulse->Fit(template_fcn, "RNQ");
+    template_fcn->SetParameters(ymax, x_at_max);
+    MinuitCheck(kSaturatedFit, template_fcn, 0., _nsamples-0.5, 1, &newampl, &newtime, compass_us);
+    template_fcn->SetParameters(f_ampl, f_time);
+    template_fcn->SetRange(0, fitmax);
   }
-  else
+
+  if (_verbose > 0)
   {
-    gSubPulse->Fit(template_fcn, "R");
     //gSubPulse->Print("ALL");
     std::cout << "ampl time before refit " << f_ampl << "\t" << f_time << std::endl;
-    f_ampl = template_fcn->GetParameter(0);
-    f_time = template_fcn->GetParameter(1);
-    std::cout << "ampl time after  refit " << f_ampl << "\t" << f_time << std::endl;
+    std::cout << "ampl time after  refit " << newampl << "\t" << newtime << std::endl;
   }
 
   // pick lower chi2/ndf of two saturated fits
-  Double_t newchi2 = template_fcn->GetChisquare();
-  Double_t newndf = template_fcn->GetNDF();
   if ( (newchi2/newndf)<f_chi2/f_ndf )
   {
-    f_ampl = template_fcn->GetParameter(0);
-    f_time = template_fcn->GetParameter(1);
+    template_fcn->SetParameters(newampl, newtime);
+    template_fcn->SetRange( 0., _nsamples-0.5 );
+    f_ampl = newampl;
+    f_time = newtime;
     f_chi2 = newchi2;
     f_ndf = newndf;
     f_fitmode = 5;
@@ -1543,7 +1916,8 @@ int MbdSig::FitTemplate( const Int_t sampmax )
   {
     _verbose = 12;
     std::cout << "FitTemplate " << _ch << "\t" << f_ampl << "\t" << f_time << std::endl;
-    std::cout << "            " << template_fcn->GetChisquare()/template_fcn->GetNDF() << std::endl;
+    std::cout << "            " << f_chi2/f_ndf << std::endl;
+    FillGraphs();
     gSubPulse->Draw("ap");
     gSubPulse->GetHistogram()->SetTitle(gSubPulse->GetName());
     gPad->SetGridx(1);
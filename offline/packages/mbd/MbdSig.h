@@ -5,6 +5,7 @@
 
 #include <Rtypes.h>
 
+#include <array>
 #include <fstream>
 #include <limits>
 #include <vector>
@@ -14,12 +15,17 @@ class TF1;
 class TGraphErrors;
 class TH1;
 class TH2;
+class TProfile;
 class MbdCalib;
 
 /**
 
 MbdSig: Single Channel digital signal class, includes processing
 
+The samples are kept in plain arrays, and the pedestal and template fits
+are done on them without ROOT fits. The histograms and graphs of the
+waveform are only filled on request (GetHist(), GetGraph(), drawing).
+
 */
 
 class MbdSig
@@ -40,8 +46,8 @@ class MbdSig
 
   void SetCalib(MbdCalib *mcal);
 
-  TH1 *GetHist() { return hpulse; }
-  TGraphErrors *GetGraph() { return gpulse; }
+  TH1 *GetHist();
+  TGraphErrors *GetGraph();
   Double_t GetAmpl() { return f_ampl; }
   Double_t GetTime() { return f_time; }
   Double_t GetIntegral() { return f_integral; }
@@ -129,6 +135,10 @@ class MbdSig
   void WritePedHist();
   void WritePedvsEvent();
   void WriteChi2Hist();
+  void WriteMinuitCheckHists();
+
+  //! also do the template and pileup fits with Minuit, and histogram the differences and the fit times to the compass search (slow, for eval)
+  void SetMinuitCheck(const bool b = true) { _minuitcheck = b; }
 
   void DrawWaveform();      /// Draw Subtracted Waveform
   void PadUpdate() const;
@@ -138,6 +148,34 @@ class MbdSig
  private:
   void Init();
 
+  /** fill the waveform hists and graphs from the samples */
+  void FillGraphs();
+
+  /** template value at x for a pulse starting at time, returns false if the point is outside the template or saturated */
+  bool TemplatePoint(const Double_t x, const Double_t time, Double_t &value) const;
+
+  /** chi2 (without errors) of ntemplates templates starting at time to the points up to xmax, amplitudes are solved in closed form */
+  Double_t TemplateChi2(const int ntemplates, const Double_t *time, const Double_t xmax, Double_t *ampl, int &npoints) const;
+
+  /** fit ntemplates (1 or 2) templates to the points up to xmax, time holds the start values. Returns the chi2 */
+  Double_t FitTemplates(const int ntemplates, const Double_t xmax, Double_t *ampl, Double_t *time, Double_t &ndf) const;
+
+  /** fits cross-checked with Minuit */
+  enum MinuitCheckFit
+  {
+    kFirstFit = 0,
+    kTwoTemplateFit,
+    kSaturatedFit,
+    kPileupFit,
+    kPileupTailFit,
+    kNMinuitCheckFits
+  };
+
+  /** fit fcn with Minuit from its current parameters over [xmin,xmax], and histogram the compass - Minuit
+   *  differences of the npulses (ampl, time) pairs, which are parameters 2i and 2i+1 of fcn */
+  void MinuitCheck(const MinuitCheckFit ifit, TF1 *fcn, const Double_t xmin, const Double_t xmax,
+                   const int npulses, const Double_t *ampl, const Double_t *time, const Double_t compass_us);
+
   int _ch;
   int _nsamples;
   int _status{0};
@@ -147,7 +185,7 @@ class MbdSig
   float _pileup_p0{0.};
   float _pileup_p1{0.};
   float _pileup_p2{0.};
-  TF1 *fit_pileup{nullptr};
+  std::array<float, 4> _pileup_tcorr{};  // pol3 correction for time ch pileup
 
   /** fit values*/
   // should make an array for the different methods
@@ -169,10 +207,21 @@ class MbdSig
   TGraphErrors *gSubPulse{nullptr};  //!
   TGraphErrors *gpulse{nullptr};     //!
 
+  /** samples of the current event, hists and graphs are filled from them */
+  std::vector<Double_t> m_xsamp;     //! sample x
+  std::vector<Double_t> m_rawsamp;   //! raw adc
+  std::vector<Double_t> m_subsamp;   //! pedestal subtracted adc
+  int m_nsubsamp{0};                 //! 0 if no pedestal subtracted waveform
+  Double_t m_rawerr{0.};             //! error on raw adc
+
+  /** scratch for GetSplineAmpl() */
+  std::vector<Double_t> m_spline_b;  //!
+  std::vector<Double_t> m_spline_c;  //!
+  std::vector<Double_t> m_spline_d;  //!
+
   /** for CalcPed0 */
   MbdRunningStats *ped0stats{nullptr};    //! running pedestal
   TH1 *hPed0{nullptr};                //! all events
-  TH1 *hPedEvt{nullptr};              //! evt-by-event pedestal
   TGraphErrors *gPedvsEvent{nullptr}; //! Keep track of pedestal vs evtnum
   TF1 *ped_fcn{nullptr};
   Double_t ped0{0.};                  //!
@@ -203,6 +252,7 @@ class MbdSig
   std::vector<float> template_yrms;
   TF1 *template_fcn{nullptr};
   TF1 *twotemplate_fcn{nullptr};
+  TF1 *fit_pileup{nullptr};  //! pileup tail, only for the Minuit check
   Double_t fit_min_time{};  //! min time for fit, in original units of waveform data
   Double_t fit_max_time{};  //! max time for fit, in original units of waveform data
 
@@ -210,9 +260,14 @@ class MbdSig
                                         // use for calibrating out the tail from these events
 
   TH1 *h_chi2ndf{nullptr};  //! for eval
+  std::array<TH1 *, kNMinuitCheckFits> h_minuit_dtime{};  //! for eval, compass - Minuit time
+  std::array<TH1 *, kNMinuitCheckFits> h_minuit_dampl{};  //! for eval, (compass - Minuit)/Minuit ampl
+  TProfile *h_compass_us{nullptr};  //! for eval, compass fit time [us] vs fit
+  TProfile *h_minuit_us{nullptr};   //! for eval, Minuit fit time [us] vs fit
 
   int _verbose{0};
   bool _pedstudyflag{false};
+  bool _minuitcheck{false};
 };
 
 #endif  // __MBDSIG_H__
@@ -13,7 +13,7 @@
 #include <trackbase/ClusHitsVerbosev1.h>
 #include <trackbase/MvtxDefs.h>
 #include <trackbase/TrkrClusterContainerv4.h>
-#include <trackbase/TrkrClusterHitAssocv3.h>
+#include <trackbase/TrkrClusterHitAssocv4.h>
 #include <trackbase/TrkrClusterv3.h>
 #include <trackbase/TrkrClusterv4.h>
 #include <trackbase/TrkrClusterv5.h>
@@ -175,7 +175,7 @@ int MvtxClusterizer::InitRun(PHCompositeNode *topNode)
       dstNode->addNode(DetNode);
     }
 
-    clusterhitassoc = new TrkrClusterHitAssocv3;
+    clusterhitassoc = new TrkrClusterHitAssocv4;
     PHIODataNode<PHObject> *newNode = new PHIODataNode<PHObject>(clusterhitassoc, "TRKR_CLUSTERHITASSOC", "PHObject");
     DetNode->addNode(newNode);
   }
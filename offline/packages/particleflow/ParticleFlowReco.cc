@@ -30,6 +30,20 @@
 #include <cmath>
 #include <iostream>
 
+namespace
+{
+  // one empty list per element, keeping the memory of the lists of previous events
+  template <typename T>
+  void reset_lists(std::vector<std::vector<T> > &lists, size_t size)
+  {
+    lists.resize(size);
+    for (auto &list : lists)
+    {
+      list.clear();
+    }
+  }
+}  // namespace
+
 // examine second value of std::pair, sort by smallest
 bool sort_by_pair_second_lowest(const std::pair<int, float> &a, const std::pair<int, float> &b)
 {
@@ -121,9 +135,6 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
   _pflow_TRK_p.clear();
   _pflow_TRK_eta.clear();
   _pflow_TRK_phi.clear();
-  _pflow_TRK_match_EM.clear();
-  _pflow_TRK_match_HAD.clear();
-  _pflow_TRK_addtl_match_EM.clear();
   _pflow_TRK_trk.clear();
   _pflow_TRK_EMproj_phi.clear();
   _pflow_TRK_EMproj_eta.clear();
@@ -133,19 +144,13 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
   _pflow_EM_E.clear();
   _pflow_EM_eta.clear();
   _pflow_EM_phi.clear();
-  _pflow_EM_tower_eta.clear();
-  _pflow_EM_tower_phi.clear();
-  _pflow_EM_match_HAD.clear();
-  _pflow_EM_match_TRK.clear();
+  _pflow_EM_towers.reset(0.025 * 2.5);
   _pflow_EM_cluster.clear();
 
   _pflow_HAD_E.clear();
   _pflow_HAD_eta.clear();
   _pflow_HAD_phi.clear();
-  _pflow_HAD_tower_eta.clear();
-  _pflow_HAD_tower_phi.clear();
-  _pflow_HAD_match_EM.clear();
-  _pflow_HAD_match_TRK.clear();
+  _pflow_HAD_towers.reset(0.1 * 1.5);
   _pflow_HAD_cluster.clear();
 
   GlobalVertexMap *vertexmap = findNode::getClass<GlobalVertexMap>(topNode, "GlobalVertexMap");
@@ -201,9 +206,6 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
       _pflow_TRK_p.push_back(track->get_p());
       _pflow_TRK_eta.push_back(track->get_eta());
       _pflow_TRK_phi.push_back(track->get_phi());
-      _pflow_TRK_match_EM.emplace_back();
-      _pflow_TRK_match_HAD.emplace_back();
-      _pflow_TRK_addtl_match_EM.emplace_back();
 
       SvtxTrackState *cemcstate = track->get_state(cemcradius);
       SvtxTrackState *ohstate = track->get_state(ohcalradius);
@@ -258,16 +260,13 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
       _pflow_EM_eta.push_back(cluster_eta);
       _pflow_EM_phi.push_back(cluster_phi);
       _pflow_EM_cluster.push_back(hiter->second);
-      _pflow_EM_match_HAD.emplace_back();
-      _pflow_EM_match_TRK.emplace_back();
 
       if (Verbosity() > 5 && cluster_E > 0.2)
       {
         std::cout << " EM topoCluster with E = " << cluster_E << ", eta / phi = " << cluster_eta << " / " << cluster_phi << " , nTow = " << hiter->second->getNTowers() << std::endl;
       }
 
-      std::vector<float> this_cluster_tower_eta;
-      std::vector<float> this_cluster_tower_phi;
+      const int cluster_index = _pflow_EM_cluster.size() - 1;
 
       // read in towers
       RawCluster::TowerConstRange begin_end_towers = hiter->second->get_towers();
@@ -277,8 +276,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
         {
           RawTowerGeom *tower_geom = geomEM->get_tower_geometry(iter->first);
 
-          this_cluster_tower_phi.push_back(tower_geom->get_phi());
-          this_cluster_tower_eta.push_back(tower_geom->get_eta());
+          _pflow_EM_towers.add_tower(cluster_index, tower_geom->get_eta(), tower_geom->get_phi());
         }
         else
         {
@@ -287,9 +285,6 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
         }
       }  // close tower loop
 
-      _pflow_EM_tower_eta.push_back(this_cluster_tower_eta);
-      _pflow_EM_tower_phi.push_back(this_cluster_tower_phi);
-
     }  // close cluster loop
 
   }  // close
@@ -319,16 +314,12 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
       _pflow_HAD_phi.push_back(cluster_phi);
       _pflow_HAD_cluster.push_back(hiter->second);
 
-      _pflow_HAD_match_EM.emplace_back();
-      _pflow_HAD_match_TRK.emplace_back();
-
       if (Verbosity() > 5 && cluster_E > 0.2)
       {
         std::cout << " HAD topoCluster with E = " << cluster_E << ", eta / phi = " << cluster_eta << " / " << cluster_phi << " , nTow = " << hiter->second->getNTowers() << std::endl;
       }
 
-      std::vector<float> this_cluster_tower_eta;
-      std::vector<float> this_cluster_tower_phi;
+      const int cluster_index = _pflow_HAD_cluster.size() - 1;
 
       // read in towers
       RawCluster::TowerConstRange begin_end_towers = hiter->second->get_towers();
@@ -338,16 +329,14 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
         {
           RawTowerGeom *tower_geom = geomIH->get_tower_geometry(iter->first);
 
-          this_cluster_tower_phi.push_back(tower_geom->get_phi());
-          this_cluster_tower_eta.push_back(tower_geom->get_eta());
+          _pflow_HAD_towers.add_tower(cluster_index, tower_geom->get_eta(), tower_geom->get_phi());
         }
 
         else if (RawTowerDefs::decode_caloid(iter->first) == RawTowerDefs::CalorimeterId::HCALOUT)
         {
           RawTowerGeom *tower_geom = geomOH->get_tower_geometry(iter->first);
 
-          this_cluster_tower_phi.push_back(tower_geom->get_phi());
-          this_cluster_tower_eta.push_back(tower_geom->get_eta());
+          _pflow_HAD_towers.add_tower(cluster_index, tower_geom->get_eta(), tower_geom->get_phi());
         }
         else
         {
@@ -357,13 +346,22 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
 
       }  // close tower loop
 
-      _pflow_HAD_tower_eta.push_back(this_cluster_tower_eta);
-      _pflow_HAD_tower_phi.push_back(this_cluster_tower_phi);
-
     }  // close cluster loop
 
   }  // close
 
+  // index the cluster towers in (eta, phi) for the linking
+  _pflow_EM_towers.build();
+  _pflow_HAD_towers.build();
+
+  reset_lists(_pflow_TRK_match_EM, _pflow_TRK_p.size());
+  reset_lists(_pflow_TRK_match_HAD, _pflow_TRK_p.size());
+  reset_lists(_pflow_TRK_addtl_match_EM, _pflow_TRK_p.size());
+  reset_lists(_pflow_EM_match_HAD, _pflow_EM_E.size());
+  reset_lists(_pflow_EM_match_TRK, _pflow_EM_E.size());
+  reset_lists(_pflow_HAD_match_EM, _pflow_HAD_E.size());
+  reset_lists(_pflow_HAD_match_TRK, _pflow_HAD_E.size());
+
   // BEGIN LINKING STEP
 
   // Link TRK -> EM (best match, but keep reserve of others), and TRK -> HAD (best match)
@@ -383,56 +381,27 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
     float min_em_dR = 0.2;
     int min_em_index = -1;
 
-    for (unsigned int em = 0; em < _pflow_EM_E.size(); em++)
+    // only EMs with a tower overlapping with the track projection are possible matches
+    _pflow_EM_towers.find_clusters(_pflow_TRK_EMproj_eta[trk], _pflow_TRK_EMproj_phi[trk], _pflow_overlap_clusters);
+    for (int em : _pflow_overlap_clusters)
     {
       float dR = calculate_dR(_pflow_TRK_EMproj_eta[trk], _pflow_EM_eta[em], _pflow_TRK_EMproj_phi[trk], _pflow_EM_phi[em]);
 
       if (dR > 0.2)
-      {
-        continue;
-      }
-
-      bool has_overlap = false;
-
-      for (unsigned int tow = 0; tow < _pflow_EM_tower_eta.at(em).size(); tow++)
-      {
-        float tower_eta = _pflow_EM_tower_eta.at(em).at(tow);
-        float tower_phi = _pflow_EM_tower_phi.at(em).at(tow);
-
-        float deta = tower_eta - _pflow_TRK_EMproj_eta[trk];
-        float dphi = tower_phi - _pflow_TRK_EMproj_phi[trk];
-        if (dphi > M_PI)
-        {
-          dphi -= 2 * M_PI;
-        }
-        if (dphi < -M_PI)
-        {
-          dphi += 2 * M_PI;
-        }
-
-        if (std::fabs(deta) < 0.025 * 2.5 && std::fabs(dphi) < 0.025 * 2.5)
-        {
-          has_overlap = true;
-          break;
-        }
-      }
-
-      if (has_overlap)
       {
         if (Verbosity() > 5)
         {
-          std::cout << " -> possible match to EM " << em << " with dR = " << dR << std::endl;
+          std::cout << " -> no match to EM " << em << " (tower overlap, but dR = " << dR << " )" << std::endl;
         }
-
-        _pflow_TRK_addtl_match_EM.at(trk).emplace_back(em, dR);
+        continue;
       }
-      else
+
+      if (Verbosity() > 5)
       {
-        if (Verbosity() > 5)
-        {
-          std::cout << " -> no match to EM " << em << " (even though dR = " << dR << " )" << std::endl;
-        }
+        std::cout << " -> possible match to EM " << em << " with dR = " << dR << std::endl;
       }
+
+      _pflow_TRK_addtl_match_EM.at(trk).emplace_back(em, dR);
     }
 
     // sort possible matches
@@ -479,60 +448,31 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
     float max_had_pt = 0;
 
     // TODO: sequential linking should better happen here -- i.e. allow EM-matched HAD's into the possible pool
-    for (unsigned int had = 0; had < _pflow_HAD_E.size(); had++)
+    // only HADs with a tower overlapping with the track projection are possible matches
+    _pflow_HAD_towers.find_clusters(_pflow_TRK_HADproj_eta[trk], _pflow_TRK_HADproj_phi[trk], _pflow_overlap_clusters);
+    for (int had : _pflow_overlap_clusters)
     {
       float dR = calculate_dR(_pflow_TRK_HADproj_eta[trk], _pflow_HAD_eta[had], _pflow_TRK_HADproj_phi[trk], _pflow_HAD_phi[had]);
 
       if (dR > 0.5)
       {
-        continue;
-      }
-
-      bool has_overlap = false;
-
-      for (unsigned int tow = 0; tow < _pflow_HAD_tower_eta.at(had).size(); tow++)
-      {
-        float tower_eta = _pflow_HAD_tower_eta.at(had).at(tow);
-        float tower_phi = _pflow_HAD_tower_phi.at(had).at(tow);
-
-        float deta = tower_eta - _pflow_TRK_HADproj_eta[trk];
-        float dphi = tower_phi - _pflow_TRK_HADproj_phi[trk];
-        if (dphi > M_PI)
-        {
-          dphi -= 2 * M_PI;
-        }
-        if (dphi < -M_PI)
-        {
-          dphi += 2 * M_PI;
-        }
-
-        if (std::fabs(deta) < 0.1 * 1.5 && std::fabs(dphi) < 0.1 * 1.5)
+        if (Verbosity() > 5)
         {
-          has_overlap = true;
-          break;
+          std::cout << " -> no match to HAD " << had << " (tower overlap, but dR = " << dR << " )" << std::endl;
         }
+        continue;
       }
 
-      if (has_overlap)
+      if (Verbosity() > 5)
       {
-        if (Verbosity() > 5)
-        {
-          std::cout << " -> possible match to HAD " << had << " with dR = " << dR << std::endl;
-        }
-
-        if (_pflow_HAD_E.at(had) > max_had_pt)
-        {
-          max_had_pt = _pflow_HAD_E.at(had);
-          min_had_index = had;
-          min_had_dR = dR;
-        }
+        std::cout << " -> possible match to HAD " << had << " with dR = " << dR << std::endl;
       }
-      else
+
+      if (_pflow_HAD_E.at(had) > max_had_pt)
       {
-        if (Verbosity() > 5)
-        {
-          std::cout << " -> no match to HAD " << had << " (even though dR = " << dR << " )" << std::endl;
-        }
+        max_had_pt = _pflow_HAD_E.at(had);
+        min_had_index = had;
+        min_had_dR = dR;
       }
     }
 
@@ -573,59 +513,31 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
     int min_had_index = -1;
     float max_had_pt = 0;
 
-    for (unsigned int had = 0; had < _pflow_HAD_E.size(); had++)
+    // only HADs with a tower overlapping with the EM position are possible matches
+    _pflow_HAD_towers.find_clusters(_pflow_EM_eta[em], _pflow_EM_phi[em], _pflow_overlap_clusters);
+    for (int had : _pflow_overlap_clusters)
     {
       float dR = calculate_dR(_pflow_EM_eta[em], _pflow_HAD_eta[had], _pflow_EM_phi[em], _pflow_HAD_phi[had]);
-      if (dR > 0.5)
-      {
-        continue;
-      }
-
-      bool has_overlap = false;
 
-      for (unsigned int tow = 0; tow < _pflow_HAD_tower_eta.at(had).size(); tow++)
+      if (dR > 0.5)
       {
-        float tower_eta = _pflow_HAD_tower_eta.at(had).at(tow);
-        float tower_phi = _pflow_HAD_tower_phi.at(had).at(tow);
-
-        float deta = tower_eta - _pflow_EM_eta[em];
-        float dphi = tower_phi - _pflow_EM_phi[em];
-        if (dphi > M_PI)
-        {
-          dphi -= 2 * M_PI;
-        }
-        if (dphi < -M_PI)
-        {
-          dphi += 2 * M_PI;
-        }
-
-        if (std::fabs(deta) < 0.1 * 1.5 && std::fabs(dphi) < 0.1 * 1.5)
+        if (Verbosity() > 5)
         {
-          has_overlap = true;
-          break;
+          std::cout << " -> no match to HAD " << had << " (tower overlap, but dR = " << dR << " )" << std::endl;
         }
+        continue;
       }
 
-      if (has_overlap)
+      if (Verbosity() > 5)
       {
-        if (Verbosity() > 5)
-        {
-          std::cout << " -> possible match to HAD " << had << " with dR = " << dR << std::endl;
-        }
-
-        if (_pflow_HAD_E.at(had) > max_had_pt)
-        {
-          max_had_pt = _pflow_HAD_E.at(had);
-          min_had_index = had;
-          min_had_dR = dR;
-        }
+        std::cout << " -> possible match to HAD " << had << " with dR = " << dR << std::endl;
       }
-      else
+
+      if (_pflow_HAD_E.at(had) > max_had_pt)
       {
-        if (Verbosity() > 5)
-        {
-          std::cout << " -> no match to HAD " << had << " (even though dR = " << dR << " )" << std::endl;
-        }
+        max_had_pt = _pflow_HAD_E.at(had);
+        min_had_index = had;
+        min_had_dR = dR;
       }
     }
 
@@ -7,6 +7,8 @@
 /// \author Dennis V. Perepelitsa
 //===========================================================
 
+#include "ParticleFlowTowerGrid.h"
+
 #include <fun4all/SubsysReco.h>
 
 #include <gsl/gsl_rng.h>
@@ -65,8 +67,7 @@ class ParticleFlowReco : public SubsysReco
   std::vector<float> _pflow_EM_eta;
   std::vector<float> _pflow_EM_phi;
   std::vector<RawCluster *> _pflow_EM_cluster;
-  std::vector<std::vector<float> > _pflow_EM_tower_eta;
-  std::vector<std::vector<float> > _pflow_EM_tower_phi;
+  ParticleFlowTowerGrid _pflow_EM_towers;
   std::vector<std::vector<int> > _pflow_EM_match_HAD;
   std::vector<std::vector<int> > _pflow_EM_match_TRK;
 
@@ -74,11 +75,13 @@ class ParticleFlowReco : public SubsysReco
   std::vector<float> _pflow_HAD_eta;
   std::vector<float> _pflow_HAD_phi;
   std::vector<RawCluster *> _pflow_HAD_cluster;
-  std::vector<std::vector<float> > _pflow_HAD_tower_eta;
-  std::vector<std::vector<float> > _pflow_HAD_tower_phi;
+  ParticleFlowTowerGrid _pflow_HAD_towers;
   std::vector<std::vector<int> > _pflow_HAD_match_EM;
   std::vector<std::vector<int> > _pflow_HAD_match_TRK;
 
+  // clusters with towers overlapping with the track or cluster being linked
+  std::vector<int> _pflow_overlap_clusters;
+
   std::string _track_map_name {"SvtxTrackMap"};
 };
 
@@ -0,0 +1,149 @@
+#include "ParticleFlowTowerGrid.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+  // cells are a bit larger than the window, so that rounding cannot move
+  // an overlapping tower out of the neighbouring cells
+  constexpr double cell_margin = 1.01;
+}  // namespace
+
+void ParticleFlowTowerGrid::reset(double window)
+{
+  _window = window;
+  _tower_cluster.clear();
+  _tower_eta.clear();
+  _tower_phi.clear();
+}
+
+void ParticleFlowTowerGrid::add_tower(int cluster, float eta, float phi)
+{
+  _tower_cluster.push_back(cluster);
+  _tower_eta.push_back(eta);
+  _tower_phi.push_back(phi);
+}
+
+int ParticleFlowTowerGrid::phi_cell(float phi) const
+{
+  double cell = std::fmod(std::floor((phi + M_PI) / _phi_cell_size), _n_phi_cells);
+  if (cell < 0)
+  {
+    cell += _n_phi_cells;
+  }
+  return static_cast<int>(cell);
+}
+
+void ParticleFlowTowerGrid::build()
+{
+  _n_eta_cells = 0;
+  _n_phi_cells = 0;
+  _cell_towers.clear();
+
+  // towers with an undefined position never overlap with anything
+  double eta_min = std::numeric_limits<double>::max();
+  double eta_max = std::numeric_limits<double>::lowest();
+  int max_cluster = -1;
+  for (unsigned int tow = 0; tow < _tower_eta.size(); tow++)
+  {
+    if (!std::isfinite(_tower_eta[tow]) || !std::isfinite(_tower_phi[tow]))
+    {
+      continue;
+    }
+    eta_min = std::min<double>(eta_min, _tower_eta[tow]);
+    eta_max = std::max<double>(eta_max, _tower_eta[tow]);
+    max_cluster = std::max(max_cluster, _tower_cluster[tow]);
+  }
+  if (max_cluster < 0 || !(_window > 0))
+  {
+    return;
+  }
+
+  const double cell_size = _window * cell_margin;
+  _eta_min = eta_min;
+  _eta_cell_size = cell_size;
+  _n_eta_cells = static_cast<int>((eta_max - eta_min) / cell_size) + 1;
+  _n_phi_cells = std::max(1, static_cast<int>(2 * M_PI / cell_size));
+  _phi_cell_size = 2 * M_PI / _n_phi_cells;
+
+  // count the towers per cell, then sort them by cell keeping their order
+  _cell_begin.assign(_n_eta_cells * _n_phi_cells + 1, 0);
+  _tower_cell.assign(_tower_eta.size(), -1);
+  for (unsigned int tow = 0; tow < _tower_eta.size(); tow++)
+  {
+    if (!std::isfinite(_tower_eta[tow]) || !std::isfinite(_tower_phi[tow]))
+    {
+      continue;
+    }
+    const int eta_cell = std::min(_n_eta_cells - 1, static_cast<int>((_tower_eta[tow] - _eta_min) / _eta_cell_size));
+    _tower_cell[tow] = eta_cell * _n_phi_cells + phi_cell(_tower_phi[tow]);
+    ++_cell_begin[_tower_cell[tow] + 1];
+  }
+  for (unsigned int cell = 0; cell + 1 < _cell_begin.size(); cell++)
+  {
+    _cell_begin[cell + 1] += _cell_begin[cell];
+  }
+
+  _cell_towers.resize(_cell_begin.back());
+  _cell_fill.assign(_cell_begin.begin(), _cell_begin.end() - 1);
+  for (unsigned int tow = 0; tow < _tower_cell.size(); tow++)
+  {
+    if (_tower_cell[tow] >= 0)
+    {
+      _cell_towers[_cell_fill[_tower_cell[tow]]++] = tow;
+    }
+  }
+
+  _cluster_query.assign(max_cluster + 1, 0);
+  _query = 0;
+}
+
+void ParticleFlowTowerGrid::find_clusters(float eta, float phi, std::vector<int> &clusters)
+{
+  clusters.clear();
+  if (_n_eta_cells == 0 || !std::isfinite(eta) || !std::isfinite(phi))
+  {
+    return;
+  }
+
+  // only the cells next to the one of the position can hold overlapping towers
+  const double eta_pos = std::floor((eta - _eta_min) / _eta_cell_size);
+  if (eta_pos < -1 || eta_pos > _n_eta_cells)
+  {
+    return;
+  }
+  const int eta_cell = static_cast<int>(eta_pos);
+  const int first_eta_cell = std::max(0, eta_cell - 1);
+  const int last_eta_cell = std::min(_n_eta_cells - 1, eta_cell + 1);
+
+  // with less than 3 cells in phi, all of them are neighbours
+  const int phi_pos = phi_cell(phi);
+  const int n_phi_search = std::min(3, _n_phi_cells);
+  const int first_phi_cell = _n_phi_cells < 3 ? 0 : phi_pos - 1 + _n_phi_cells;
+
+  ++_query;
+  for (int ieta = first_eta_cell; ieta <= last_eta_cell; ieta++)
+  {
+    for (int iphi = 0; iphi < n_phi_search; iphi++)
+    {
+      const int cell = ieta * _n_phi_cells + (first_phi_cell + iphi) % _n_phi_cells;
+      for (unsigned int i = _cell_begin[cell]; i < _cell_begin[cell + 1]; i++)
+      {
+        const unsigned int tow = _cell_towers[i];
+        const int cluster = _tower_cluster[tow];
+        if (_cluster_query[cluster] == _query)
+        {
+          continue;
+        }
+        if (overlaps(_tower_eta[tow], _tower_phi[tow], eta, phi, _window))
+        {
+          _cluster_query[cluster] = _query;
+          clusters.push_back(cluster);
+        }
+      }
+    }
+  }
+
+  std::sort(clusters.begin(), clusters.end());
+}
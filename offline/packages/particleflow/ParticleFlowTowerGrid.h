@@ -0,0 +1,73 @@
+#ifndef PARTICLEFLOWTOWERGRID_H
+#define PARTICLEFLOWTOWERGRID_H
+
+//===========================================================
+/// \file ParticleFlowTowerGrid.h
+/// \brief (eta, phi) grid of the towers of calorimeter clusters, for track/cluster matching
+//===========================================================
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/// Towers of the clusters of one calorimeter, binned in (eta, phi) cells at least
+/// as large as the overlap window. A position only needs to be compared to the
+/// towers in the 3x3 cells around it to find the clusters overlapping with it.
+/// The grid is refilled every event, reset() keeps the allocated memory
+class ParticleFlowTowerGrid
+{
+ public:
+  /// remove all towers, towers overlap with a position if |deta| and |dphi| are below window
+  void reset(double window);
+
+  void add_tower(int cluster, float eta, float phi);
+
+  /// bin the towers, to be called after all towers are added and before any find_clusters()
+  void build();
+
+  /// clusters with at least one tower overlapping with (eta, phi), in increasing order
+  void find_clusters(float eta, float phi, std::vector<int> &clusters);
+
+  /// the overlap condition of a tower with a position
+  static bool overlaps(float tower_eta, float tower_phi, float eta, float phi, double window)
+  {
+    float deta = tower_eta - eta;
+    float dphi = tower_phi - phi;
+    if (dphi > M_PI)
+    {
+      dphi -= 2 * M_PI;
+    }
+    if (dphi < -M_PI)
+    {
+      dphi += 2 * M_PI;
+    }
+    return std::fabs(deta) < window && std::fabs(dphi) < window;
+  }
+
+ private:
+  int phi_cell(float phi) const;
+
+  double _window {0};
+
+  // towers in the order they were added
+  std::vector<int> _tower_cluster;
+  std::vector<float> _tower_eta;
+  std::vector<float> _tower_phi;
+  std::vector<int> _tower_cell;
+
+  // cells, the towers of cell i are _cell_towers[_cell_begin[i]] to _cell_towers[_cell_begin[i+1]]
+  int _n_eta_cells {0};
+  int _n_phi_cells {0};
+  double _eta_min {0};
+  double _eta_cell_size {1};
+  double _phi_cell_size {1};
+  std::vector<unsigned int> _cell_begin;
+  std::vector<unsigned int> _cell_towers;
+  std::vector<unsigned int> _cell_fill;
+
+  // query number at which a cluster was last found, to report it once per query
+  std::vector<uint32_t> _cluster_query;
+  uint32_t _query {0};
+};
+
+#endif  // PARTICLEFLOWTOWERGRID_H
@@ -12,7 +12,7 @@
 #include <trackbase/ClusHitsVerbosev1.h>
 #include <trackbase/TpcDefs.h>
 #include <trackbase/TrkrClusterContainerv4.h>
-#include <trackbase/TrkrClusterHitAssocv3.h>
+#include <trackbase/TrkrClusterHitAssocv4.h>
 #include <trackbase/TrkrClusterv3.h>
 #include <trackbase/TrkrClusterv4.h>
 #include <trackbase/TrkrClusterv5.h>
@@ -75,8 +75,6 @@ namespace
     return x * x;
   }
 
-  using assoc = std::pair<TrkrDefs::cluskey, TrkrDefs::hitkey>;
-
   struct ihit
   {
     unsigned short iphi = 0;
@@ -163,7 +161,7 @@ namespace
     bool maskHot  = false;
     bool debug = false;
 
-    std::vector<assoc> association_vector;
+    TrkrClusterHitAssoc::AssocList association_vector;
     std::vector<TrkrCluster *> cluster_vector;
     std::vector<TrainingHits *> v_hits;
     int verbosity = 0;
@@ -1472,7 +1470,7 @@ int TpcClusterizer::InitRun(PHCompositeNode *topNode)
       dstNode->addNode(DetNode);
     }
 
-    clusterhitassoc = new TrkrClusterHitAssocv3;
+    clusterhitassoc = new TrkrClusterHitAssocv4;
     PHIODataNode<PHObject> *newNode = new PHIODataNode<PHObject>(clusterhitassoc, "TRKR_CLUSTERHITASSOC", "PHObject");
     DetNode->addNode(newNode);
   }
@@ -1831,14 +1829,7 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
         }
 
         // copy hit associations to map
-        for (const auto &[index, hkey] : thread_pair.data.association_vector)
-        {
-          // generate cluster key
-          const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
-
-          // add to association table
-          m_clusterhitassoc->addAssoc(ckey, hkey);
-        }
+        m_clusterhitassoc->addAssocs(hitsetkey, thread_pair.data.association_vector);
       }
 //      count++;
     }
@@ -1960,14 +1951,7 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
         }
 
         // copy hit associations to map
-        for (const auto &[index, hkey] : thread_pair.data.association_vector)
-        {
-          // generate cluster key
-          const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
-
-          // add to association table
-          m_clusterhitassoc->addAssoc(ckey, hkey);
-        }
+        m_clusterhitassoc->addAssocs(hitsetkey, thread_pair.data.association_vector);
       }
 //      count++;
     }
@@ -2018,14 +2002,7 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
       }
 
       // copy hit associations to map
-      for (const auto &[index, hkey] : thread_pair.data.association_vector)
-      {
-        // generate cluster key
-        const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
-
-        // add to association table
-        m_clusterhitassoc->addAssoc(ckey, hkey);
-      }
+      m_clusterhitassoc->addAssocs(hitsetkey, thread_pair.data.association_vector);
 
       for (auto *v_hit : thread_pair.data.v_hits)
       {
@@ -3,7 +3,7 @@
 #include <trackbase/TpcDefs.h>
 
 #include <trackbase/TrkrClusterContainerv4.h>
-#include <trackbase/TrkrClusterHitAssocv3.h>
+#include <trackbase/TrkrClusterHitAssocv4.h>
 #include <trackbase/TrkrClusterv3.h>
 #include <trackbase/TrkrDefs.h>  // for hitkey, getLayer
 #include <trackbase/TrkrHitSet.h>
@@ -54,7 +54,6 @@ namespace
 
   using iphiz = std::pair<unsigned short, unsigned short>;
   using ihit = std::pair<unsigned short, iphiz>;
-  using assoc = std::pair<uint32_t, TrkrDefs::hitkey>;
 
   struct thread_data
   {
@@ -72,7 +71,7 @@ namespace
     unsigned short zoffset = 0;
     double par0_neg = 0;
     double par0_pos = 0;
-    std::vector<assoc> association_vector;
+    TrkrClusterHitAssoc::AssocList association_vector;
     std::vector<TrkrCluster *> cluster_vector;
   };
 
@@ -432,7 +431,7 @@ int TpcSimpleClusterizer::InitRun(PHCompositeNode *topNode)
       dstNode->addNode(DetNode);
     }
 
-    clusterhitassoc = new TrkrClusterHitAssocv3;
+    clusterhitassoc = new TrkrClusterHitAssocv4;
     PHIODataNode<PHObject> *newNode = new PHIODataNode<PHObject>(clusterhitassoc, "TRKR_CLUSTERHITASSOC", "PHObject");
     DetNode->addNode(newNode);
   }
@@ -610,14 +609,7 @@ int TpcSimpleClusterizer::process_event(PHCompositeNode *topNode)
     }
 
     // copy hit associations to map
-    for (const auto &[index, hkey] : thread_pair.data.association_vector)
-    {
-      // generate cluster key
-      const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
-
-      // add to association table
-      m_clusterhitassoc->addAssoc(ckey, hkey);
-    }
+    m_clusterhitassoc->addAssocs(hitsetkey, thread_pair.data.association_vector);
   }
 
   if (Verbosity() > 0)
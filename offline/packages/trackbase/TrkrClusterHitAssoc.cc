@@ -8,3 +8,20 @@ void TrkrClusterHitAssoc::Reset()
   std::cout << "TrkrClusterHitAssoc: Reset() not implemented by daughter class" << std::endl;
   gSystem->Exit(1);
 }
+
+void TrkrClusterHitAssoc::addAssocs(TrkrDefs::hitsetkey hitsetkey, const AssocList& assocs)
+{
+  for (const auto& [index, hitkey] : assocs)
+  {
+    addAssoc(TrkrDefs::genClusKey(hitsetkey, index), hitkey);
+  }
+}
+
+void TrkrClusterHitAssoc::getHitKeys(TrkrDefs::cluskey ckey, HitKeyList& hitkeys)
+{
+  const auto range = getHits(ckey);
+  for (auto iter = range.first; iter != range.second; ++iter)
+  {
+    hitkeys.push_back(iter->second);
+  }
+}
@@ -15,6 +15,7 @@
 #include <iostream>  // for cout, ostream
 #include <map>
 #include <utility>  // for pair
+#include <vector>
 
 /**
  * @brief Base class for associating clusters to the hits that went into them
@@ -28,6 +29,12 @@ class TrkrClusterHitAssoc : public PHObject
   using ConstIterator = Map::const_iterator;
   using ConstRange = std::pair<Map::const_iterator, Map::const_iterator>;
 
+  //! list of (cluster index in hitset, hit key) pairs, as filled by the clusterizers
+  using AssocList = std::vector<std::pair<unsigned int, TrkrDefs::hitkey>>;
+
+  //! list of hit keys
+  using HitKeyList = std::vector<TrkrDefs::hitkey>;
+
   void Reset() override;
 
   //! remove all associations matching a given hitsetkey
@@ -41,6 +48,13 @@ class TrkrClusterHitAssoc : public PHObject
    */
   virtual void addAssoc(TrkrDefs::cluskey ckey, unsigned int hidx) = 0;
 
+  /**
+   * @brief Add all associations of a hitset at once
+   * @param[in] hitsetkey Hitset key
+   * @param[in] assocs (cluster index, hit key) pairs. Cluster keys are generated from hitset key and index
+   */
+  virtual void addAssocs(TrkrDefs::hitsetkey hitsetkey, const AssocList& assocs);
+
   //! get pointer to cluster-to-hit map corresponding to a given hitset id
   virtual Map* getClusterMap(TrkrDefs::hitsetkey) { return nullptr; }
 
@@ -52,6 +66,13 @@ class TrkrClusterHitAssoc : public PHObject
 
   virtual ConstRange getHits(TrkrDefs::cluskey) = 0;
 
+  /**
+   * @brief Copy the keys of all the hits associated with a cluster
+   * @param[in] ckey Cluster key
+   * @param[out] hitkeys hit keys associated with @c ckey are appended to this list
+   */
+  virtual void getHitKeys(TrkrDefs::cluskey ckey, HitKeyList& hitkeys);
+
   virtual unsigned int size() const { return 0; }
 
  protected:
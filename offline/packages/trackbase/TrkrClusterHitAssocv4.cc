@@ -0,0 +1,256 @@
+/**
+ * @file trackbase/TrkrClusterHitAssocv4.cc
+ * @brief TrkrClusterHitAssocv4 implementation
+ */
+
+#include "TrkrClusterHitAssocv4.h"
+#include "TrkrDefs.h"
+
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <ostream>  // for operator<<, endl, basic_ostream, ostream, basic_o...
+
+namespace
+{
+  TrkrClusterHitAssocv4::Map dummy_map;
+
+  //! protects the on demand multimaps when getHits is called from several threads
+  std::mutex cluster_map_mutex;
+}  // namespace
+
+//_________________________________________________________________________
+void TrkrClusterHitAssocv4::Reset()
+{
+  // keep the allocated memory for the next event
+  m_hitsetkeys.clear();
+  m_hitset_offsets.assign(1, 0);
+  m_cluster_offsets.assign(1, 0);
+  m_hitkeys.clear();
+  m_cluster_maps.clear();
+}
+
+//_________________________________________________________________________
+void TrkrClusterHitAssocv4::identify(std::ostream& os) const
+{
+  os << "-----TrkrClusterHitAssocv4-----" << std::endl;
+  os << "Number of associations: " << size() << std::endl;
+  for (size_t hitset = 0; hitset < m_hitsetkeys.size(); ++hitset)
+  {
+    for (auto slot = m_hitset_offsets[hitset]; slot < m_hitset_offsets[hitset + 1]; ++slot)
+    {
+      const auto ckey = TrkrDefs::genClusKey(m_hitsetkeys[hitset], slot - m_hitset_offsets[hitset]);
+      for (auto hit = m_cluster_offsets[slot]; hit < m_cluster_offsets[slot + 1]; ++hit)
+      {
+        os << "clus key " << ckey << std::dec
+           << " layer " << (unsigned int) TrkrDefs::getLayer(ckey)
+           << " hit key: " << m_hitkeys[hit] << std::endl;
+      }
+    }
+  }
+  os << "------------------------------" << std::endl;
+
+  return;
+}
+
+//_________________________________________________________________________
+void TrkrClusterHitAssocv4::removeAssocs(TrkrDefs::hitsetkey hitsetkey)
+{
+  const auto hitset = findHitSet(hitsetkey);
+  if (hitset == m_hitsetkeys.size())
+  {
+    return;
+  }
+
+  m_cluster_maps.clear();
+
+  const auto slot_begin = m_hitset_offsets[hitset];
+  const auto slot_end = m_hitset_offsets[hitset + 1];
+  const auto hit_begin = m_cluster_offsets[slot_begin];
+  const auto hit_end = m_cluster_offsets[slot_end];
+  const auto nslots = slot_end - slot_begin;
+  const auto nhits = hit_end - hit_begin;
+
+  // remove hits and cluster slots, shift the following offsets
+  m_hitkeys.erase(m_hitkeys.begin() + hit_begin, m_hitkeys.begin() + hit_end);
+  m_cluster_offsets.erase(m_cluster_offsets.begin() + slot_begin, m_cluster_offsets.begin() + slot_end);
+  std::for_each(m_cluster_offsets.begin() + slot_begin, m_cluster_offsets.end(), [nhits](unsigned int& offset)
+                { offset -= nhits; });
+
+  m_hitsetkeys.erase(m_hitsetkeys.begin() + hitset);
+  m_hitset_offsets.erase(m_hitset_offsets.begin() + hitset + 1);
+  std::for_each(m_hitset_offsets.begin() + hitset + 1, m_hitset_offsets.end(), [nslots](unsigned int& offset)
+                { offset -= nslots; });
+}
+
+//_________________________________________________________________________
+void TrkrClusterHitAssocv4::addAssoc(TrkrDefs::cluskey ckey, unsigned int hidx)
+{
+  m_cluster_maps.clear();
+
+  // get hitset from cluster, create if not found
+  const auto hitset = findOrInsertHitSet(TrkrDefs::getHitSetKeyFromClusKey(ckey));
+  const auto index = TrkrDefs::getClusIndex(ckey);
+  resizeHitSet(hitset, index + 1);
+
+  // insert after the existing hits of this cluster
+  const auto slot = m_hitset_offsets[hitset] + index;
+  m_hitkeys.insert(m_hitkeys.begin() + m_cluster_offsets[slot + 1], hidx);
+  std::for_each(m_cluster_offsets.begin() + slot + 1, m_cluster_offsets.end(), [](unsigned int& offset)
+                { ++offset; });
+}
+
+//_________________________________________________________________________
+void TrkrClusterHitAssocv4::addAssocs(TrkrDefs::hitsetkey hitsetkey, const AssocList& assocs)
+{
+  if (assocs.empty())
+  {
+    return;
+  }
+
+  // hitset already has associations, insert one by one
+  if (findHitSet(hitsetkey) != m_hitsetkeys.size())
+  {
+    TrkrClusterHitAssoc::addAssocs(hitsetkey, assocs);
+    return;
+  }
+
+  m_cluster_maps.clear();
+
+  // count hits per cluster index
+  unsigned int nslots = 0;
+  for (const auto& assoc : assocs)
+  {
+    nslots = std::max(nslots, assoc.first + 1);
+  }
+  std::vector<unsigned int> offsets(nslots + 1, 0);
+  for (const auto& assoc : assocs)
+  {
+    ++offsets[assoc.first + 1];
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  const auto hitset = findOrInsertHitSet(hitsetkey);
+  const auto slot_begin = m_hitset_offsets[hitset];
+  const auto hit_begin = m_cluster_offsets[slot_begin];
+  const auto nhits = static_cast<unsigned int>(assocs.size());
+
+  // place hits by cluster index, keeping the input order within a cluster
+  m_hitkeys.insert(m_hitkeys.begin() + hit_begin, nhits, 0);
+  {
+    auto position = offsets;
+    for (const auto& [index, hitkey] : assocs)
+    {
+      m_hitkeys[hit_begin + position[index]++] = hitkey;
+    }
+  }
+
+  // cluster slots, and shift the offsets of following hitsets
+  m_cluster_offsets.insert(m_cluster_offsets.begin() + slot_begin, nslots, 0);
+  for (unsigned int slot = 0; slot < nslots; ++slot)
+  {
+    m_cluster_offsets[slot_begin + slot] = hit_begin + offsets[slot];
+  }
+  std::for_each(m_cluster_offsets.begin() + slot_begin + nslots, m_cluster_offsets.end(), [nhits](unsigned int& offset)
+                { offset += nhits; });
+  std::for_each(m_hitset_offsets.begin() + hitset + 1, m_hitset_offsets.end(), [nslots](unsigned int& offset)
+                { offset += nslots; });
+}
+
+//_________________________________________________________________________
+TrkrClusterHitAssocv4::ConstRange TrkrClusterHitAssocv4::getHits(TrkrDefs::cluskey ckey)
+{
+  const TrkrDefs::hitsetkey hitsetkey = TrkrDefs::getHitSetKeyFromClusKey(ckey);
+  const auto hitset = findHitSet(hitsetkey);
+  if (hitset == m_hitsetkeys.size())
+  {
+    return std::make_pair(dummy_map.cbegin(), dummy_map.cend());
+  }
+
+  std::lock_guard<std::mutex> lock(cluster_map_mutex);
+  auto [iter, inserted] = m_cluster_maps.try_emplace(hitsetkey);
+  auto& clusterMap = iter->second;
+  if (inserted)
+  {
+    for (auto slot = m_hitset_offsets[hitset]; slot < m_hitset_offsets[hitset + 1]; ++slot)
+    {
+      const auto key = TrkrDefs::genClusKey(hitsetkey, slot - m_hitset_offsets[hitset]);
+      for (auto hit = m_cluster_offsets[slot]; hit < m_cluster_offsets[slot + 1]; ++hit)
+      {
+        clusterMap.emplace_hint(clusterMap.end(), key, m_hitkeys[hit]);
+      }
+    }
+  }
+
+  return std::make_pair(clusterMap.lower_bound(ckey), clusterMap.upper_bound(ckey));
+}
+
+//_________________________________________________________________________
+void TrkrClusterHitAssocv4::getHitKeys(TrkrDefs::cluskey ckey, HitKeyList& hitkeys)
+{
+  const auto range = getHitKeyRange(ckey);
+  hitkeys.insert(hitkeys.end(), range.first, range.second);
+}
+
+//_________________________________________________________________________
+TrkrClusterHitAssocv4::HitKeyRange TrkrClusterHitAssocv4::getHitKeyRange(TrkrDefs::cluskey ckey) const
+{
+  const auto hitset = findHitSet(TrkrDefs::getHitSetKeyFromClusKey(ckey));
+  if (hitset == m_hitsetkeys.size())
+  {
+    return {nullptr, nullptr};
+  }
+
+  const auto slot = m_hitset_offsets[hitset] + TrkrDefs::getClusIndex(ckey);
+  if (slot >= m_hitset_offsets[hitset + 1])
+  {
+    return {nullptr, nullptr};
+  }
+
+  return {m_hitkeys.data() + m_cluster_offsets[slot], m_hitkeys.data() + m_cluster_offsets[slot + 1]};
+}
+
+//_________________________________________________________________________
+size_t TrkrClusterHitAssocv4::findHitSet(TrkrDefs::hitsetkey hitsetkey) const
+{
+  const auto iter = std::lower_bound(m_hitsetkeys.begin(), m_hitsetkeys.end(), hitsetkey);
+  if (iter == m_hitsetkeys.end() || *iter != hitsetkey)
+  {
+    return m_hitsetkeys.size();
+  }
+  return iter - m_hitsetkeys.begin();
+}
+
+//_________________________________________________________________________
+size_t TrkrClusterHitAssocv4::findOrInsertHitSet(TrkrDefs::hitsetkey hitsetkey)
+{
+  // hitsets are usually added in increasing order
+  const auto iter = (m_hitsetkeys.empty() || m_hitsetkeys.back() < hitsetkey) ? m_hitsetkeys.end() : std::lower_bound(m_hitsetkeys.begin(), m_hitsetkeys.end(), hitsetkey);
+  const size_t hitset = iter - m_hitsetkeys.begin();
+  if (iter == m_hitsetkeys.end() || *iter != hitsetkey)
+  {
+    // new hitset, with no cluster slots
+    const auto slot_begin = m_hitset_offsets[hitset];
+    m_hitsetkeys.insert(iter, hitsetkey);
+    m_hitset_offsets.insert(m_hitset_offsets.begin() + hitset, slot_begin);
+  }
+  return hitset;
+}
+
+//_________________________________________________________________________
+void TrkrClusterHitAssocv4::resizeHitSet(size_t hitset, unsigned int nclusters)
+{
+  const auto slot_end = m_hitset_offsets[hitset + 1];
+  const auto current = slot_end - m_hitset_offsets[hitset];
+  if (nclusters <= current)
+  {
+    return;
+  }
+
+  // new slots are empty, they all start at the end of the last cluster of the hitset
+  const auto nslots = nclusters - current;
+  const auto hit_end = m_cluster_offsets[slot_end];
+  m_cluster_offsets.insert(m_cluster_offsets.begin() + slot_end, nslots, hit_end);
+  std::for_each(m_hitset_offsets.begin() + hitset + 1, m_hitset_offsets.end(), [nslots](unsigned int& offset)
+                { offset += nslots; });
+}
@@ -0,0 +1,91 @@
+#ifndef TRACKBASE_TRKRCLUSTERHITASSOCV4_H
+#define TRACKBASE_TRKRCLUSTERHITASSOCV4_H
+/**
+ * @file trackbase/TrkrClusterHitAssocv4.h
+ * @brief Version 4 of class for associating clusters to the hits that went into them
+ */
+
+#include "TrkrClusterHitAssoc.h"
+#include "TrkrDefs.h"
+
+#include <iostream>  // for cout, ostream
+#include <map>
+#include <utility>  // for pair
+#include <vector>
+
+/**
+ * @brief Class for associating clusters to the hits that went into them
+ *
+ * Associations are stored in compressed sparse rows: hitsets sorted by key,
+ * one slot per cluster index in each hitset, and the hit keys of all clusters packed in a single array.
+ * Lookups only need a binary search on the hitset, the cluster slot is addressed directly by the cluster index.
+ * The flat arrays are written memberwise by ROOT.
+ *
+ * Hitsets are best filled in one go with addAssocs, in increasing hitset key order.
+ * addAssoc and filling in any other order are supported, but require moving the following entries.
+ */
+class TrkrClusterHitAssocv4 : public TrkrClusterHitAssoc
+{
+ public:
+  //! contiguous range of hit keys
+  using HitKeyRange = std::pair<const TrkrDefs::hitkey*, const TrkrDefs::hitkey*>;
+
+  TrkrClusterHitAssocv4() = default;
+
+  void Reset() override;
+
+  void identify(std::ostream& os = std::cout) const override;
+
+  //! remove all associations matching a given hitsetkey
+  void removeAssocs(TrkrDefs::hitsetkey) override;
+
+  //! add cluster to hit association
+  void addAssoc(TrkrDefs::cluskey, unsigned int) override;
+
+  //! add all associations of a hitset
+  void addAssocs(TrkrDefs::hitsetkey, const AssocList&) override;
+
+  //! get all hits matching a given cluster key
+  /**
+   * the multimap of the cluster hitset is built on first access and kept until the container is modified.
+   * Prefer getHitKeys or getHitKeyRange, which read the packed arrays directly
+   */
+  ConstRange getHits(TrkrDefs::cluskey) override;
+
+  //! copy the keys of all hits matching a given cluster key
+  void getHitKeys(TrkrDefs::cluskey, HitKeyList&) override;
+
+  //! keys of all hits matching a given cluster key. Valid until the container is modified
+  HitKeyRange getHitKeyRange(TrkrDefs::cluskey) const;
+
+  unsigned int size() const override { return m_hitkeys.size(); }
+
+ private:
+  //! index of a hitset in m_hitsetkeys, size of m_hitsetkeys if not found
+  size_t findHitSet(TrkrDefs::hitsetkey) const;
+
+  //! index of a hitset in m_hitsetkeys, inserted with no clusters if not found
+  size_t findOrInsertHitSet(TrkrDefs::hitsetkey);
+
+  //! make sure a hitset has at least nclusters cluster slots
+  void resizeHitSet(size_t hitset, unsigned int nclusters);
+
+  //! sorted hitset keys
+  std::vector<TrkrDefs::hitsetkey> m_hitsetkeys;
+
+  //! first cluster slot of each hitset, followed by the total number of slots
+  std::vector<unsigned int> m_hitset_offsets{0};
+
+  //! first hit of each cluster slot, followed by the total number of hits
+  std::vector<unsigned int> m_cluster_offsets{0};
+
+  //! hit keys of all clusters
+  std::vector<TrkrDefs::hitkey> m_hitkeys;
+
+  //! per hitset multimaps, built on demand for getHits
+  std::map<TrkrDefs::hitsetkey, Map> m_cluster_maps;  //!
+
+  ClassDefOverride(TrkrClusterHitAssocv4, 1);
+};
+
+#endif  // TRACKBASE_TRKRCLUSTERHITASSOCV4_H
@@ -0,0 +1,8 @@
+#ifdef __CINT__
+
+#pragma link C++ class TrkrClusterHitAssocv4 + ;
+
+// the getHits multimaps are not persistent. Clear them on read, so that they get rebuilt from the new content
+#pragma read sourceClass = "TrkrClusterHitAssocv4" version = "[1-]" targetClass = "TrkrClusterHitAssocv4" source = "" target = "m_cluster_maps" code = "{ m_cluster_maps.clear(); }"
+
+#endif /* __CINT__ */
@@ -0,0 +1,147 @@
+// unit test of TrkrClusterHitAssocv4 against a multimap reference
+// run with "make check"
+
+#include "TrkrClusterHitAssocv4.h"
+#include "TrkrDefs.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  int nfailed = 0;
+  int nlookups = 0;
+
+  void check(const bool condition, const std::string &what)
+  {
+    if (!condition)
+    {
+      std::cout << "TrkrClusterHitAssocv4Test - FAILED: " << what << std::endl;
+      ++nfailed;
+    }
+  }
+
+  using Reference = std::multimap<TrkrDefs::cluskey, TrkrDefs::hitkey>;
+
+  // every cluster of every hitset, through getHitKeys, getHitKeyRange and getHits
+  void compare(TrkrClusterHitAssocv4 &assoc, const Reference &reference, const std::vector<TrkrDefs::hitsetkey> &hitsetkeys, const std::string &what)
+  {
+    unsigned int size = 0;
+    for (const auto hitsetkey : hitsetkeys)
+    {
+      for (unsigned int index = 0; index < 40; ++index)
+      {
+        const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
+        TrkrClusterHitAssoc::HitKeyList expected;
+        const auto range = reference.equal_range(ckey);
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+          expected.push_back(iter->second);
+        }
+        std::sort(expected.begin(), expected.end());
+        size += expected.size();
+
+        TrkrClusterHitAssoc::HitKeyList hitkeys;
+        assoc.getHitKeys(ckey, hitkeys);
+        std::sort(hitkeys.begin(), hitkeys.end());
+        check(hitkeys == expected, what + ": getHitKeys");
+
+        const auto keyrange = assoc.getHitKeyRange(ckey);
+        TrkrClusterHitAssoc::HitKeyList rangekeys(keyrange.first, keyrange.second);
+        std::sort(rangekeys.begin(), rangekeys.end());
+        check(rangekeys == expected, what + ": getHitKeyRange");
+
+        TrkrClusterHitAssoc::HitKeyList mapkeys;
+        const auto maprange = assoc.getHits(ckey);
+        for (auto iter = maprange.first; iter != maprange.second; ++iter)
+        {
+          check(iter->first == ckey, what + ": getHits cluster key");
+          mapkeys.push_back(iter->second);
+        }
+        std::sort(mapkeys.begin(), mapkeys.end());
+        check(mapkeys == expected, what + ": getHits");
+        ++nlookups;
+      }
+    }
+    check(assoc.size() == size, what + ": size");
+  }
+
+  void test_random(const unsigned int seed)
+  {
+    std::mt19937 rng(seed);
+    std::vector<TrkrDefs::hitsetkey> hitsetkeys;
+    for (uint8_t layer = 0; layer < 12; ++layer)
+    {
+      hitsetkeys.push_back(TrkrDefs::genHitSetKey(TrkrDefs::tpcId, layer + 7));
+    }
+
+    TrkrClusterHitAssocv4 assoc;
+    Reference reference;
+    for (int step = 0; step < 60; ++step)
+    {
+      const auto hitsetkey = hitsetkeys[rng() % hitsetkeys.size()];
+      switch (rng() % 4)
+      {
+      case 0:
+      {
+        // bulk fill of a hitset, in any hitset order
+        TrkrClusterHitAssoc::AssocList assocs;
+        const unsigned int nassocs = rng() % 50;
+        for (unsigned int i = 0; i < nassocs; ++i)
+        {
+          const unsigned int index = rng() % 40;
+          const TrkrDefs::hitkey hitkey = rng();
+          assocs.emplace_back(index, hitkey);
+          reference.emplace(TrkrDefs::genClusKey(hitsetkey, index), hitkey);
+        }
+        assoc.addAssocs(hitsetkey, assocs);
+        break;
+      }
+      case 1:
+      {
+        // removal of a whole hitset
+        assoc.removeAssocs(hitsetkey);
+        reference.erase(reference.lower_bound(TrkrDefs::genClusKey(hitsetkey, 0)),
+                        reference.upper_bound(TrkrDefs::genClusKey(hitsetkey, 39)));
+        break;
+      }
+      default:
+      {
+        // single associations
+        const unsigned int index = rng() % 40;
+        const TrkrDefs::hitkey hitkey = rng();
+        assoc.addAssoc(TrkrDefs::genClusKey(hitsetkey, index), hitkey);
+        reference.emplace(TrkrDefs::genClusKey(hitsetkey, index), hitkey);
+        break;
+      }
+      }
+      // getHits multimaps must follow every modification
+      compare(assoc, reference, hitsetkeys, "random sequence " + std::to_string(seed));
+    }
+
+    assoc.Reset();
+    reference.clear();
+    compare(assoc, reference, hitsetkeys, "after Reset");
+  }
+}  // namespace
+
+int main()
+{
+  for (unsigned int seed = 0; seed < 8; ++seed)
+  {
+    test_random(seed);
+  }
+
+  if (nfailed)
+  {
+    std::cout << "TrkrClusterHitAssocv4Test - " << nfailed << " checks failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "TrkrClusterHitAssocv4Test - all checks passed, " << nlookups << " lookups" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -6,6 +6,8 @@
 #include <trackbase/TrkrDefs.h>
 #include <g4main/PHG4HitDefs.h>
 #include <cmath>
+#include <cstddef>
+#include <iterator>
 #include <limits>
 #include <set>
 
@@ -13,8 +15,92 @@ class TrackSeed : public PHObject
 {
  public:
   typedef std::set<TrkrDefs::cluskey> ClusterKeySet;
-  typedef ClusterKeySet::const_iterator ConstClusterKeyIter;
-  typedef ClusterKeySet::iterator ClusterKeyIter;
+
+  //! read only iterator over the sorted cluster keys of a seed
+  /*!
+   * it walks either a ClusterKeySet (TrackSeed_v1, TrackSeed_v2), or contiguous sorted keys (TrackSeed_v3).
+   * ClusterKeySet iterators convert implicitly
+   */
+  class ClusterKeyIterator
+  {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = TrkrDefs::cluskey;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const TrkrDefs::cluskey*;
+    using reference = const TrkrDefs::cluskey&;
+
+    ClusterKeyIterator() = default;
+
+    //! iterator over a ClusterKeySet
+    ClusterKeyIterator(ClusterKeySet::const_iterator iter)  // NOLINT(google-explicit-constructor)
+      : m_set_iter(iter)
+    {
+    }
+
+    //! iterator over contiguous keys. key must not be null
+    explicit ClusterKeyIterator(const TrkrDefs::cluskey* key)
+      : m_key(key)
+    {
+    }
+
+    reference operator*() const { return m_key ? *m_key : *m_set_iter; }
+    pointer operator->() const { return &operator*(); }
+
+    ClusterKeyIterator& operator++()
+    {
+      if (m_key)
+      {
+        ++m_key;
+      }
+      else
+      {
+        ++m_set_iter;
+      }
+      return *this;
+    }
+
+    ClusterKeyIterator operator++(int)
+    {
+      ClusterKeyIterator tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+
+    ClusterKeyIterator& operator--()
+    {
+      if (m_key)
+      {
+        --m_key;
+      }
+      else
+      {
+        --m_set_iter;
+      }
+      return *this;
+    }
+
+    ClusterKeyIterator operator--(int)
+    {
+      ClusterKeyIterator tmp(*this);
+      --(*this);
+      return tmp;
+    }
+
+    bool operator==(const ClusterKeyIterator& other) const
+    {
+      return m_key == other.m_key && (m_key || m_set_iter == other.m_set_iter);
+    }
+
+    bool operator!=(const ClusterKeyIterator& other) const { return !(*this == other); }
+
+   private:
+    const TrkrDefs::cluskey* m_key = nullptr;
+    ClusterKeySet::const_iterator m_set_iter;
+  };
+
+  typedef ClusterKeyIterator ConstClusterKeyIter;
+  typedef ClusterKeyIterator ClusterKeyIter;
 
   ~TrackSeed() override = default;
 
@@ -0,0 +1,150 @@
+#include "TrackSeed_v3.h"
+
+#include <algorithm>
+
+TrackSeed_v3::TrackSeed_v3(const TrackSeed& seed)
+{
+  TrackSeed_v3::CopyFrom(seed);
+}
+
+// have to suppress missingMemberCopy from cppcheck, it does not
+// go down to the CopyFrom method where things are done correctly
+// cppcheck-suppress missingMemberCopy
+TrackSeed_v3::TrackSeed_v3(const TrackSeed_v3& seed)
+  : TrackSeed(seed)
+{
+  TrackSeed_v3::CopyFrom(seed);
+}
+
+TrackSeed_v3& TrackSeed_v3::operator=(const TrackSeed_v3& seed)
+{
+  if (this != &seed)
+  {
+    CopyFrom(seed);
+  }
+  return *this;
+}
+
+void TrackSeed_v3::CopyFrom(const TrackSeed& seed)
+{
+  if (this == &seed)
+  {
+    return;
+  }
+  TrackSeed::CopyFrom(seed);
+
+  m_qOverR = seed.get_qOverR();
+  m_X0 = seed.get_X0();
+  m_Y0 = seed.get_Y0();
+  m_slope = seed.get_slope();
+  m_Z0 = seed.get_Z0();
+  m_crossing = seed.get_crossing();
+  m_phi = seed.get_phi();
+  set_cluster_keys(seed.begin_cluster_keys(), seed.end_cluster_keys());
+}
+
+void TrackSeed_v3::identify(std::ostream& os) const
+{
+  os << "TrackSeed_v3 object ";
+  os << "charge " << get_charge() << std::endl;
+  os << "beam crossing " << get_crossing() << std::endl;
+  os << "(pt,pz) = (" << get_pt()
+     << ", " << get_pz() << ")" << std::endl;
+  os << " phi " << m_phi << " eta " << get_eta() << std::endl;
+  os << "(X0,Y0,Z0) = (" << m_X0 << ", " << m_Y0 << ", " << m_Z0
+     << ")" << std::endl;
+  os << "R and slope " << fabs(1. / m_qOverR) << ", " << m_slope << std::endl;
+  os << "list of cluster keys size: " << m_cluster_keys.size() << std::endl;
+  for (auto iter = begin_cluster_keys(); iter != end_cluster_keys(); ++iter)
+  {
+    os << *iter << ", ";
+  }
+
+  os << std::endl;
+  return;
+}
+
+void TrackSeed_v3::clear_cluster_keys()
+{
+  m_cluster_keys.clear();
+}
+
+void TrackSeed_v3::set_cluster_keys(ConstClusterKeyIter begin, ConstClusterKeyIter end)
+{
+  m_cluster_keys.assign(begin, end);
+}
+
+const TrkrDefs::cluskey* TrackSeed_v3::find_key(TrkrDefs::cluskey key) const
+{
+  const auto* first = keys();
+  const auto* last = first + m_cluster_keys.size();
+  const auto* iter = std::lower_bound(first, last, key);
+  return (iter != last && *iter == key) ? iter : last;
+}
+
+void TrackSeed_v3::insert_cluster_key(TrkrDefs::cluskey key)
+{
+  const auto iter = std::lower_bound(m_cluster_keys.begin(), m_cluster_keys.end(), key);
+  if (iter == m_cluster_keys.end() || *iter != key)
+  {
+    m_cluster_keys.insert(iter, key);
+  }
+}
+
+size_t TrackSeed_v3::erase_cluster_key(TrkrDefs::cluskey key)
+{
+  const auto iter = std::lower_bound(m_cluster_keys.begin(), m_cluster_keys.end(), key);
+  if (iter == m_cluster_keys.end() || *iter != key)
+  {
+    return 0;
+  }
+  m_cluster_keys.erase(iter);
+  return 1;
+}
+
+float TrackSeed_v3::get_pt() const
+{
+  /// Scaling factor for radius in 1.4T field
+  return 0.3 * 1.4 / 100. * fabs(1. / m_qOverR);
+}
+
+float TrackSeed_v3::get_theta() const
+{
+  float theta = atan(1. / m_slope);
+  /// Normalize to 0<theta<pi
+  if (theta < 0)
+  {
+    theta += M_PI;
+  }
+  return theta;
+}
+
+float TrackSeed_v3::get_eta() const
+{
+  return -log(tan(get_theta() / 2.));
+}
+
+float TrackSeed_v3::get_p() const
+{
+  return get_pt() * std::cosh(get_eta());
+}
+
+float TrackSeed_v3::get_px() const
+{
+  return get_pt() * std::cos(m_phi);
+}
+
+float TrackSeed_v3::get_py() const
+{
+  return get_pt() * std::sin(m_phi);
+}
+
+float TrackSeed_v3::get_pz() const
+{
+  return get_p() * std::cos(get_theta());
+}
+
+int TrackSeed_v3::get_charge() const
+{
+  return (m_qOverR < 0) ? -1 : 1;
+}
@@ -0,0 +1,113 @@
+#ifndef TRACKBASEHISTORIC_TRACKSEED_V3_H
+#define TRACKBASEHISTORIC_TRACKSEED_V3_H
+
+#include "TrackSeed.h"
+
+#include <trackbase/TrkrDefs.h>
+
+#include <limits.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+//! track seed with cluster keys stored sorted and contiguous
+/*!
+ * the keys are in one sorted vector, a single allocation per seed instead of one per key
+ * for the std::set of TrackSeed_v2. Only the stored keys are written out.
+ * Lookup is a binary search, iteration is linear.
+ */
+class TrackSeed_v3 : public TrackSeed
+{
+ public:
+  TrackSeed_v3() = default;
+
+  /// Copy constructors
+  TrackSeed_v3(const TrackSeed&);
+  TrackSeed_v3(const TrackSeed_v3&);
+  TrackSeed_v3& operator=(const TrackSeed_v3& seed);
+
+  void identify(std::ostream& os = std::cout) const override;
+  void Reset() override { *this = TrackSeed_v3(); }
+  int isValid() const override { return 1; }
+  void CopyFrom(const TrackSeed&) override;
+  void CopyFrom(TrackSeed* seed) override { CopyFrom(*seed); }
+  PHObject* CloneMe() const override { return new TrackSeed_v3(*this); }
+
+  ///@name accessors
+  //@{
+  float get_px() const override;
+  float get_py() const override;
+  float get_pz() const override;
+  float get_p() const override;
+  float get_pt() const override;
+
+  float get_eta() const override;
+  float get_theta() const override;
+
+  //methods that return member variables
+  int get_charge() const override;
+  float get_qOverR() const override { return m_qOverR; }
+  float get_X0() const override { return m_X0; }
+  float get_Y0() const override { return m_Y0; }
+  float get_Z0() const override { return m_Z0; }
+  float get_slope() const override { return m_slope; }
+  float get_phi() const override { return m_phi; }  // returns the stored phi
+  short int get_crossing() const override { return m_crossing; }
+
+  bool empty_cluster_keys() const override { return m_cluster_keys.empty(); }
+  size_t size_cluster_keys() const override { return m_cluster_keys.size(); }
+
+  ConstClusterKeyIter find_cluster_key(TrkrDefs::cluskey clusterid) const override { return ConstClusterKeyIter(find_key(clusterid)); }
+  ConstClusterKeyIter begin_cluster_keys() const override { return ConstClusterKeyIter(keys()); }
+  ConstClusterKeyIter end_cluster_keys() const override { return ConstClusterKeyIter(keys() + m_cluster_keys.size()); }
+  ClusterKeyIter find_cluster_keys(unsigned int clusterid) override { return ClusterKeyIter(find_key(clusterid)); }
+  ClusterKeyIter begin_cluster_keys() override { return ClusterKeyIter(keys()); }
+  ClusterKeyIter end_cluster_keys() override { return ClusterKeyIter(keys() + m_cluster_keys.size()); }
+
+  //@}
+
+  ///@modifiers
+  //@{
+
+  void set_crossing(const short int crossing) override { m_crossing = crossing; }
+  void set_qOverR(const float qOverR) override { m_qOverR = qOverR; }
+  void set_X0(const float X0) override { m_X0 = X0; }
+  void set_Y0(const float Y0) override { m_Y0 = Y0; }
+  void set_Z0(const float Z0) override { m_Z0 = Z0; }
+  void set_slope(const float slope) override { m_slope = slope; }
+  void set_phi(const float phi) override { m_phi = phi; }
+
+  void clear_cluster_keys() override;
+  void insert_cluster_key(TrkrDefs::cluskey clusterid) override;
+  size_t erase_cluster_key(TrkrDefs::cluskey clusterid) override;
+
+  //! replace all cluster keys. Input keys must be sorted and unique, as in any TrackSeed
+  void set_cluster_keys(ConstClusterKeyIter begin, ConstClusterKeyIter end);
+
+  //@}
+
+ private:
+  //! first key, never null so that iterators over an empty seed compare equal
+  const TrkrDefs::cluskey* keys() const { return m_cluster_keys.empty() ? &s_no_key : m_cluster_keys.data(); }
+
+  //! pointer to key, or to the end of the keys if not found
+  const TrkrDefs::cluskey* find_key(TrkrDefs::cluskey) const;
+
+  static constexpr TrkrDefs::cluskey s_no_key = 0;
+
+  //! sorted cluster keys
+  std::vector<TrkrDefs::cluskey> m_cluster_keys;
+
+  float m_qOverR = NAN;
+  float m_X0 = NAN;
+  float m_Y0 = NAN;
+  float m_slope = NAN;
+  float m_Z0 = NAN;
+  float m_phi = NAN;
+
+  short int m_crossing = std::numeric_limits<short int>::max();
+
+  ClassDefOverride(TrackSeed_v3, 1);
+};
+
+#endif
@@ -33,7 +33,7 @@
 #include <trackbase_historic/TrackSeedContainer.h>
 #include <trackbase_historic/TrackSeedContainer_v1.h>
 #include <trackbase_historic/TrackSeedHelper.h>
-#include <trackbase_historic/TrackSeed_v2.h>
+#include <trackbase_historic/TrackSeed_v3.h>
 
 #ifndef __clang__
 #pragma GCC diagnostic push
@@ -410,7 +410,7 @@ void PHActsSiliconSeeding::makeSvtxTracksWithTime(const std::vector<seed_type>&
         for (auto& intt_clus_vec : matched_intt_clusters)
         {
           // make the svtxtrack seed with both mvtx + intt clusters
-          auto trackSeed = std::make_unique<TrackSeed_v2>();
+          auto trackSeed = std::make_unique<TrackSeed_v3>();
           
           for (int spid = 0; spid < 3; spid++)
           {
@@ -436,7 +436,7 @@ void PHActsSiliconSeeding::makeSvtxTracksWithTime(const std::vector<seed_type>&
       else
       {
         /// make a single mvtx only seed
-        auto trackSeed = std::make_unique<TrackSeed_v2>();
+        auto trackSeed = std::make_unique<TrackSeed_v3>();
         for (int spid = 0; spid < 3; spid++)
         {
           const auto& cluskey = sps[spid]->externalSpacePoint()->Id();
@@ -476,7 +476,7 @@ void PHActsSiliconSeeding::makeSvtxTracks(const std::vector<seed_type>& seedVect
       std::vector<Acts::Vector3> globalPositions;
 
       std::map<TrkrDefs::cluskey, Acts::Vector3> positions;
-      auto trackSeed = std::make_unique<TrackSeed_v2>();
+      auto trackSeed = std::make_unique<TrackSeed_v3>();
 
       const auto& sps = seed.sp();
       for (int spid = 0; spid < 3; spid++)
@@ -62,6 +62,9 @@
 #include <Eigen/Dense>
 #include <Eigen/Geometry>
 
+#include <omp.h>
+
+#include <algorithm>
 #include <cmath>
 #include <filesystem>
 #include <iostream>
@@ -383,11 +386,14 @@ int PHActsTrkFitter::process_event(PHCompositeNode* topNode)
 
   eventTimer.stop();
   auto eventTime = eventTimer.get_accumulated_time();
+  m_totalEventTime += eventTime;
+  ++m_nTimedEvents;
 
-  if (Verbosity() > 1)
+  if (Verbosity() > 0)
   {
     std::cout << "PHActsTrkFitter total event time "
-              << eventTime << std::endl;
+              << eventTime << " ms for " << m_seedMap->size() << " seeds on "
+              << m_threads_used << " threads" << std::endl;
   }
 
   if (m_timeAnalysis)
@@ -449,7 +455,9 @@ int PHActsTrkFitter::End(PHCompositeNode* /*topNode*/)
   }
   if (Verbosity() > 0)
   {
-    std::cout << "Finished PHActsTrkFitter" << std::endl;
+    std::cout << "Finished PHActsTrkFitter, mean event time "
+              << (m_nTimedEvents > 0 ? m_totalEventTime / m_nTimedEvents : 0) << " ms over "
+              << m_nTimedEvents << " events on " << m_threads_used << " threads" << std::endl;
   }
   return Fun4AllReturnCodes::EVENT_OK;
 }
@@ -458,211 +466,242 @@ void PHActsTrkFitter::loopTracks(Acts::Logging::Level logLevel)
 {
   auto logger = Acts::getDefaultLogger("PHActsTrkFitter", logLevel);
 
-  for (auto track : *m_seedMap)
+  // the transient transformation map is the same object for all tracks
+  m_transient_geocontext = Acts::GeometryContext{m_alignmentTransformationMapTransient};
+
+  // store fitted track in the output map, with id matching its position
+  const auto store = [this](const std::unique_ptr<SvtxTrack_v4>& fitted)
   {
-    if (!track)
+    if (fitted)
     {
-      continue;
+      auto* trackMap = m_fitSiliconMMs ? m_directedTrackMap : m_trackMap;
+      trackMap->insertWithKey(fitted.get(), trackMap->size());
     }
-    
-    unsigned int tpcid = track->get_tpc_seed_index();
-    unsigned int siid = track->get_silicon_seed_index();
-    auto *siseed = m_siliconSeeds->get(siid);
-    auto *tpcseed = m_tpcSeeds->get(tpcid);
+  };
+
+  // the evaluator, the outlier finder, the alignment states, the timing histograms
+  // and the transient transforms share state between tracks. Fit one track after the other in these cases
+  const bool serial = m_actsEvaluator || m_useOutlierFinder || m_commissioning || m_timeAnalysis || !m_use_clustermover;
+  const int nthreads = serial ? 1 : (m_num_threads >= 1 ? m_num_threads : omp_get_max_threads());
+  m_threads_used = nthreads;
+  if (nthreads == 1)
+  {
+    for (auto *track : *m_seedMap)
+    {
+      store(fitSeed(track));
+    }
+    return;
+  }
+
+  // fit seeds in parallel, with one output buffer per seed
+  // the fitted tracks are then stored in seed order, which gives the same maps as the serial fit
+  const std::vector<TrackSeed*> seeds(m_seedMap->begin(), m_seedMap->end());
+
+  // fits only read the clusters and the geometry: MakeSourceLinks::getSourceLinksClusterMover
+  // moves copies of the cluster positions and leaves the clusters untouched, so seeds are independent
+  std::vector<std::unique_ptr<SvtxTrack_v4>> fitted(seeds.size());
+
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+  for (size_t iseed = 0; iseed < seeds.size(); ++iseed)
+  {
+    fitted[iseed] = fitSeed(seeds[iseed]);
+  }
 
-    short int best_crossing = track->get_crossing();  // best crossing between INTT clusters and TPC seed
+  for (const auto& track : fitted)
+  {
+    store(track);
+  }
+}
+
+std::unique_ptr<SvtxTrack_v4> PHActsTrkFitter::fitSeed(TrackSeed* track)
+{
+  if (!track)
+  {
+    return nullptr;
+  }
+
+  unsigned int tpcid = track->get_tpc_seed_index();
+  unsigned int siid = track->get_silicon_seed_index();
+  auto *siseed = m_siliconSeeds->get(siid);
+  auto *tpcseed = m_tpcSeeds->get(tpcid);
+
+  short int best_crossing = track->get_crossing();  // best crossing between INTT clusters and TPC seed
 
-    if(Verbosity() > 2 && siseed && tpcseed)
+  if(Verbosity() > 2 && siseed && tpcseed)
 	  {
 	    std::cout << "tpc and si id " << tpcid << ", " << siid << " silicon_crossing " << siseed->get_crossing()
 		      << " tpc crossing " << tpcseed->get_crossing()
 		      << " best crossing " << best_crossing << " crossing estimate " << track->get_crossing_estimate() << std::endl;
 	  }
-    
-    // capture the input crossing value, and set crossing parameters
-    //==============================
+  
+  // capture the input crossing value, and set crossing parameters
+  //==============================
 
-    short int crossing = best_crossing;
-    short int crossing_estimate = crossing;
+  short int crossing = best_crossing;
+  short int crossing_estimate = crossing;
 
-    if (m_enable_crossing_estimate)
-    {
-      crossing_estimate = track->get_crossing_estimate();  // geometric crossing estimate from matcher
-    }
-    //===============================
+  if (m_enable_crossing_estimate)
+  {
+    crossing_estimate = track->get_crossing_estimate();  // geometric crossing estimate from matcher
+  }
+  //===============================
 
-    // must have silicon seed with valid crossing if we are doing a SC calibration fit
-    if (m_fitSiliconMMs)
+  // must have silicon seed with valid crossing if we are doing a SC calibration fit
+  if (m_fitSiliconMMs)
+  {
+    if ((siid == std::numeric_limits<unsigned int>::max()) || (crossing == SHRT_MAX))
     {
-      if ((siid == std::numeric_limits<unsigned int>::max()) || (crossing == SHRT_MAX))
-      {
-        continue;
-      }
+      return nullptr;
     }
+  }
 
-    // do not skip TPC only tracks, just set crossing to the nominal zero
-    if (!siseed)
-    {
-      crossing = 0;
-    }
+  // do not skip TPC only tracks, just set crossing to the nominal zero
+  if (!siseed)
+  {
+    crossing = 0;
+  }
 
-    // no path forward in this case, move on
-    if(crossing == SHRT_MAX && crossing_estimate == SHRT_MAX) { continue; }
+  // no path forward in this case, move on
+  if(crossing == SHRT_MAX && crossing_estimate == SHRT_MAX) { return nullptr; }
 	
-    /// Need to also check that the tpc seed wasn't removed by the ghost finder
-    if (!tpcseed)
-    {
-      std::cout << "no tpc seed" << std::endl;
-      continue;
-    }
+  /// Need to also check that the tpc seed wasn't removed by the ghost finder
+  if (!tpcseed)
+  {
+    std::cout << "no tpc seed" << std::endl;
+    return nullptr;
+  }
 	
-    if (Verbosity() > 0)
-      {
+  if (Verbosity() > 0)
+    {
 	if (siseed)
-      {
-        const auto si_position = TrackSeedHelper::get_xyz(siseed);
-        const auto tpc_position = TrackSeedHelper::get_xyz(tpcseed);
-        std::cout << "    silicon seed position is (x,y,z) = " << si_position.x() << "  " << si_position.y() << "  " << si_position.z() << std::endl;
-        std::cout << "    tpc seed position is (x,y,z) = " << tpc_position.x() << "  " << tpc_position.y() << "  " << tpc_position.z() << std::endl;
-      }
+    {
+      const auto si_position = TrackSeedHelper::get_xyz(siseed);
+      const auto tpc_position = TrackSeedHelper::get_xyz(tpcseed);
+      std::cout << "    silicon seed position is (x,y,z) = " << si_position.x() << "  " << si_position.y() << "  " << si_position.z() << std::endl;
+      std::cout << "    tpc seed position is (x,y,z) = " << tpc_position.x() << "  " << tpc_position.y() << "  " << tpc_position.z() << std::endl;
     }
+  }
 
-    PHTimer trackTimer("TrackTimer");
-    trackTimer.stop();
-    trackTimer.restart();
+  PHTimer trackTimer("TrackTimer");
+  trackTimer.stop();
+  trackTimer.restart();
 
-    if (Verbosity() > 1 && siseed)
-    {
-      std::cout << " m_pp_mode " << m_pp_mode << " m_enable_crossing_estimate " << m_enable_crossing_estimate
-                << " best crossing " << crossing << " crossing_estimate " << crossing_estimate << std::endl;
-    }
+  if (Verbosity() > 1 && siseed)
+  {
+    std::cout << " m_pp_mode " << m_pp_mode << " m_enable_crossing_estimate " << m_enable_crossing_estimate
+              << " best crossing " << crossing << " crossing_estimate " << crossing_estimate << std::endl;
+  }
 
-    short int this_crossing = crossing;
-    bool use_estimate = false;
-    short int nvary = 0;
-    std::vector<float> chisq_ndf;
-    std::vector<SvtxTrack_v4> svtx_vec;
+  short int this_crossing = crossing;
+  bool use_estimate = false;
+  short int nvary = 0;
+  std::vector<float> chisq_ndf;
+  std::vector<SvtxTrack_v4> svtx_vec;
+  std::unique_ptr<SvtxTrack_v4> fitted;
 
-    if (m_pp_mode)
+  if (m_pp_mode)
+  {
+    if (m_enable_crossing_estimate && crossing == SHRT_MAX)
     {
-      if (m_enable_crossing_estimate && crossing == SHRT_MAX)
-      {
-        // this only happens if there is a silicon seed but no assigned INTT crossing, and only in pp_mode
-        // If there is no INTT crossing, start with the crossing_estimate value, vary up and down, fit, and choose the best chisq/ndf
-        use_estimate = true;
-        nvary = max_bunch_search;
-        if (Verbosity() > 1)
-        {
-          std::cout << " No INTT crossing: use crossing_estimate " << crossing_estimate << " with nvary " << nvary << std::endl;
-        }
-      }
-      else
+      // this only happens if there is a silicon seed but no assigned INTT crossing, and only in pp_mode
+      // If there is no INTT crossing, start with the crossing_estimate value, vary up and down, fit, and choose the best chisq/ndf
+      use_estimate = true;
+      nvary = max_bunch_search;
+      if (Verbosity() > 1)
       {
-        // use best crossing
-        crossing_estimate = crossing;
+        std::cout << " No INTT crossing: use crossing_estimate " << crossing_estimate << " with nvary " << nvary << std::endl;
       }
     }
     else
     {
-      // non pp mode, we want only crossing zero, veto others
-      if (siseed && best_crossing != 0)
-      {
-        crossing = 0;
-        // continue;
-      }
+      // use best crossing
       crossing_estimate = crossing;
     }
-	
-    // Fit this track assuming either:
-    //    crossing = best crossing value, if it exists (uses nvary = 0)
-    //    crossing = crossing_estimate +/- max_bunch_search, if no INTT value exists and m_enable_crossing_estimate flag is set.
-
-    for (short int ivary = -nvary; ivary <= nvary; ++ivary)
+  }
+  else
+  {
+    // non pp mode, we want only crossing zero, veto others
+    if (siseed && best_crossing != 0)
     {
-      this_crossing = crossing_estimate + ivary;
+      crossing = 0;
+      // return nullptr;
+    }
+    crossing_estimate = crossing;
+  }
+	
+  // Fit this track assuming either:
+  //    crossing = best crossing value, if it exists (uses nvary = 0)
+  //    crossing = crossing_estimate +/- max_bunch_search, if no INTT value exists and m_enable_crossing_estimate flag is set.
 
-      if (Verbosity() > 1)
-      {
-        std::cout << "   nvary " << nvary << " trial fit with ivary " << ivary << " this_crossing = " << this_crossing << std::endl;
-      }
+  for (short int ivary = -nvary; ivary <= nvary; ++ivary)
+  {
+    this_crossing = crossing_estimate + ivary;
 
-      ActsTrackFittingAlgorithm::MeasurementContainer measurements;
+    if (Verbosity() > 1)
+    {
+      std::cout << "   nvary " << nvary << " trial fit with ivary " << ivary << " this_crossing = " << this_crossing << std::endl;
+    }
 
-      SourceLinkVec sourceLinks;
+    ActsTrackFittingAlgorithm::MeasurementContainer measurements;
 
-      MakeSourceLinks makeSourceLinks;
-      makeSourceLinks.initialize(_tpccellgeo, m_tGeometry, _topNode);
-      makeSourceLinks.setVerbosity(Verbosity());
-      makeSourceLinks.set_pp_mode(m_pp_mode);
-      makeSourceLinks.set_cluster_edge_rejection(m_cluster_edge_rejection);
-      for (const auto& layer : m_ignoreLayer)
-      {
-        makeSourceLinks.ignoreLayer(layer);
-      }
-      // loop over modifiedTransformSet and replace transient elements modified for the previous track with the default transforms
-      // does nothing if m_transient_id_set is empty
-      makeSourceLinks.resetTransientTransformMap(
-          m_alignmentTransformationMapTransient,
-          m_transient_id_set,
-          m_tGeometry);
+    SourceLinkVec sourceLinks;
 
-      if (m_use_clustermover)
+    MakeSourceLinks makeSourceLinks;
+    makeSourceLinks.initialize(_tpccellgeo, m_tGeometry, _topNode);
+    makeSourceLinks.setVerbosity(Verbosity());
+    makeSourceLinks.set_pp_mode(m_pp_mode);
+    makeSourceLinks.set_cluster_edge_rejection(m_cluster_edge_rejection);
+    for (const auto& layer : m_ignoreLayer)
+    {
+      makeSourceLinks.ignoreLayer(layer);
+    }
+    // loop over modifiedTransformSet and replace transient elements modified for the previous track with the default transforms
+    // does nothing if m_transient_id_set is empty
+    makeSourceLinks.resetTransientTransformMap(
+        m_alignmentTransformationMapTransient,
+        m_transient_id_set,
+        m_tGeometry);
+
+    if (m_use_clustermover)
+    {
+      // make source links using cluster mover after making distortion correction
+      if (siseed && !m_ignoreSilicon)
       {
-        // make source links using cluster mover after making distortion correction
-        if (siseed && !m_ignoreSilicon)
-        {
-          // silicon source links
-          sourceLinks = makeSourceLinks.getSourceLinksClusterMover(
-              siseed,
-              measurements,
-              m_clusterContainer,
-              m_tGeometry,
-              m_globalPositionWrapper,
-              this_crossing);
-        }
-
-        // tpc source links
-        const auto tpcSourceLinks = makeSourceLinks.getSourceLinksClusterMover(
-            tpcseed,
+        // silicon source links
+        sourceLinks = makeSourceLinks.getSourceLinksClusterMover(
+            siseed,
             measurements,
             m_clusterContainer,
             m_tGeometry,
             m_globalPositionWrapper,
             this_crossing);
-
-        // add tpc sourcelinks to silicon source links
-        sourceLinks.insert(sourceLinks.end(), tpcSourceLinks.begin(), tpcSourceLinks.end());
       }
-      else
-      {
-        // make source links using transient transforms for distortion corrections
-        if (Verbosity() > 1)
-        {
-          std::cout << "Calling getSourceLinks for si seed, siid " << siid << " and tpcid " << tpcid << std::endl;
-        }
 
-        if (siseed && !m_ignoreSilicon)
-        {
-          // silicon source links
-          sourceLinks = makeSourceLinks.getSourceLinks(
-              siseed,
-              measurements,
-              m_clusterContainer,
-              m_tGeometry,
-              m_globalPositionWrapper,
-              m_alignmentTransformationMapTransient,
-              m_transient_id_set,
-              this_crossing);
-        }
-
-        if (Verbosity() > 1)
-        {
-          std::cout << "Calling getSourceLinks for tpc seed, siid " << siid << " and tpcid " << tpcid << std::endl;
-        }
+      // tpc source links
+      const auto tpcSourceLinks = makeSourceLinks.getSourceLinksClusterMover(
+          tpcseed,
+          measurements,
+          m_clusterContainer,
+          m_tGeometry,
+          m_globalPositionWrapper,
+          this_crossing);
+
+      // add tpc sourcelinks to silicon source links
+      sourceLinks.insert(sourceLinks.end(), tpcSourceLinks.begin(), tpcSourceLinks.end());
+    }
+    else
+    {
+      // make source links using transient transforms for distortion corrections
+      if (Verbosity() > 1)
+      {
+        std::cout << "Calling getSourceLinks for si seed, siid " << siid << " and tpcid " << tpcid << std::endl;
+      }
 
-        // tpc source links
-        const auto tpcSourceLinks = makeSourceLinks.getSourceLinks(
-            tpcseed,
+      if (siseed && !m_ignoreSilicon)
+      {
+        // silicon source links
+        sourceLinks = makeSourceLinks.getSourceLinks(
+            siseed,
             measurements,
             m_clusterContainer,
             m_tGeometry,
@@ -670,365 +709,364 @@ void PHActsTrkFitter::loopTracks(Acts::Logging::Level logLevel)
             m_alignmentTransformationMapTransient,
             m_transient_id_set,
             this_crossing);
+      }
 
-        // add tpc sourcelinks to silicon source links
-        sourceLinks.insert(sourceLinks.end(), tpcSourceLinks.begin(), tpcSourceLinks.end());
+      if (Verbosity() > 1)
+      {
+        std::cout << "Calling getSourceLinks for tpc seed, siid " << siid << " and tpcid " << tpcid << std::endl;
       }
 
-      Acts::GeometryContext geoContext{m_alignmentTransformationMapTransient};
+      // tpc source links
+      const auto tpcSourceLinks = makeSourceLinks.getSourceLinks(
+          tpcseed,
+          measurements,
+          m_clusterContainer,
+          m_tGeometry,
+          m_globalPositionWrapper,
+          m_alignmentTransformationMapTransient,
+          m_transient_id_set,
+          this_crossing);
 
-      // copy transient map for this track into transient geoContext
-      m_transient_geocontext = geoContext;
+      // add tpc sourcelinks to silicon source links
+      sourceLinks.insert(sourceLinks.end(), tpcSourceLinks.begin(), tpcSourceLinks.end());
+    }
 
-      // position comes from the silicon seed, unless there is no silicon seed
-      Acts::Vector3 position(0, 0, 0);
-      if (siseed && !m_ignoreSilicon)
-      {
-        position = TrackSeedHelper::get_xyz(siseed) * Acts::UnitConstants::cm;
-      }
-      if (!siseed || !is_valid(position) || m_forceTpcOnlyFit)
-      {
-        position = TrackSeedHelper::get_xyz(tpcseed) * Acts::UnitConstants::cm;
-      }
-      if (!is_valid(position))
+    // position comes from the silicon seed, unless there is no silicon seed
+    Acts::Vector3 position(0, 0, 0);
+    if (siseed && !m_ignoreSilicon)
+    {
+      position = TrackSeedHelper::get_xyz(siseed) * Acts::UnitConstants::cm;
+    }
+    if (!siseed || !is_valid(position) || m_forceTpcOnlyFit)
+    {
+      position = TrackSeedHelper::get_xyz(tpcseed) * Acts::UnitConstants::cm;
+    }
+    if (!is_valid(position))
+    {
+      if (Verbosity() > 4)
       {
-        if (Verbosity() > 4)
-        {
-          std::cout << "Invalid position of " << position.transpose() << std::endl;
-        }
-        continue;
+        std::cout << "Invalid position of " << position.transpose() << std::endl;
       }
+      continue;
+    }
 
-      // filter sourcelinks to remove detectors that we don't want to include in the fit
-      sourceLinks = filterSourceLinks( sourceLinks );
+    // filter sourcelinks to remove detectors that we don't want to include in the fit
+    sourceLinks = filterSourceLinks( sourceLinks );
 
-      if (sourceLinks.empty())
+    if (sourceLinks.empty())
+    {
+      continue;
+    }
+
+    /// If using directed navigation, collect surface list to navigate
+    SurfacePtrVec surfaces;
+    if (m_fitSiliconMMs || m_directNavigation)
+    {
+
+      // get surfaces matching source links
+      const auto surfaces_tmp = getSurfaceVector(sourceLinks);
+
+      // skip if there is no surfaces
+      if (surfaces_tmp.empty())
       {
         continue;
       }
 
-      /// If using directed navigation, collect surface list to navigate
-      SurfacePtrVec surfaces;
-      if (m_fitSiliconMMs || m_directNavigation)
+      for (const auto& surface_apr : m_materialSurfaces)
       {
-
-        // get surfaces matching source links
-        const auto surfaces_tmp = getSurfaceVector(sourceLinks);
-
-        // skip if there is no surfaces
-        if (surfaces_tmp.empty())
+        if (m_forceSiOnlyFit)
         {
-          continue;
+          if (surface_apr->geometryId().volume() > 12)
+          {
+            continue;
+          }
         }
-
-        for (const auto& surface_apr : m_materialSurfaces)
+        //else if (m_forceTpcOnlyFit)
+        //{
+        //  if (surface_apr->geometryId().volume() < 14)
+        //  {
+        //    continue;
+        //  }
+        //}
+        bool pop_flag = false;
+        if (surface_apr->geometryId().approach() == 1)
+        {
+          surfaces.push_back(surface_apr);
+        }
+        else
         {
-          if (m_forceSiOnlyFit)
+          pop_flag = true;
+          for (const auto& surface_sns : surfaces_tmp)
           {
-            if (surface_apr->geometryId().volume() > 12)
+            if (surface_apr->geometryId().volume() == surface_sns->geometryId().volume())
             {
-              continue;
+              if (surface_apr->geometryId().layer() == surface_sns->geometryId().layer())
+              {
+                pop_flag = false;
+                surfaces.push_back(surface_sns);
+              }
             }
           }
-          //else if (m_forceTpcOnlyFit)
-          //{
-          //  if (surface_apr->geometryId().volume() < 14)
-          //  {
-          //    continue;
-          //  }
-          //}
-          bool pop_flag = false;
-          if (surface_apr->geometryId().approach() == 1)
+          if (!pop_flag)
           {
             surfaces.push_back(surface_apr);
           }
           else
           {
-            pop_flag = true;
+            surfaces.pop_back();
+            pop_flag = false;
+          }
+          if (surface_apr->geometryId().volume() == 12 && surface_apr->geometryId().layer() == 8)
+          {
             for (const auto& surface_sns : surfaces_tmp)
             {
-              if (surface_apr->geometryId().volume() == surface_sns->geometryId().volume())
-              {
-                if (surface_apr->geometryId().layer() == surface_sns->geometryId().layer())
-                {
-                  pop_flag = false;
-                  surfaces.push_back(surface_sns);
-                }
-              }
-            }
-            if (!pop_flag)
-            {
-              surfaces.push_back(surface_apr);
-            }
-            else
-            {
-              surfaces.pop_back();
-              pop_flag = false;
-            }
-            if (surface_apr->geometryId().volume() == 12 && surface_apr->geometryId().layer() == 8)
-            {
-              for (const auto& surface_sns : surfaces_tmp)
+              if (14 == surface_sns->geometryId().volume())
               {
-                if (14 == surface_sns->geometryId().volume())
-                {
-                  surfaces.push_back(surface_sns);
-                }
+                surfaces.push_back(surface_sns);
               }
             }
           }
         }
-        // With an empty ACTS material map, m_materialSurfaces is empty.
-        // Use the measurement surfaces directly for directed navigation.
-        if (surfaces.empty())
-        {
-          surfaces = surfaces_tmp;
-        }
+      }
+      // With an empty ACTS material map, m_materialSurfaces is empty.
+      // Use the measurement surfaces directly for directed navigation.
+      if (surfaces.empty())
+      {
+        surfaces = surfaces_tmp;
+      }
 
-        checkSurfaceVec(surfaces);
-        if (Verbosity() > 1)
+      checkSurfaceVec(surfaces);
+      if (Verbosity() > 1)
+      {
+        for (const auto& surf : surfaces)
         {
-          for (const auto& surf : surfaces)
-          {
-            std::cout << "Surface vector : " << surf->geometryId() << std::endl;
-          }
+          std::cout << "Surface vector : " << surf->geometryId() << std::endl;
         }
+      }
 
-        if (m_fitSiliconMMs)
+      if (m_fitSiliconMMs)
+      {
+        // make sure micromegas are in the tracks, if required
+        if (m_useMicromegas &&
+            std::none_of(surfaces.begin(), surfaces.end(), [this](const auto& surface)
+                         { return m_tGeometry->maps().isMicromegasSurface(surface); }))
         {
-          // make sure micromegas are in the tracks, if required
-          if (m_useMicromegas &&
-              std::none_of(surfaces.begin(), surfaces.end(), [this](const auto& surface)
-                           { return m_tGeometry->maps().isMicromegasSurface(surface); }))
-          {
-            continue;
-          }
+          continue;
         }
       }
+    }
 
-      float px = std::numeric_limits<float>::quiet_NaN();
-      float py = std::numeric_limits<float>::quiet_NaN();
-      float pz = std::numeric_limits<float>::quiet_NaN();
+    float px = std::numeric_limits<float>::quiet_NaN();
+    float py = std::numeric_limits<float>::quiet_NaN();
+    float pz = std::numeric_limits<float>::quiet_NaN();
 
-      // get phi and theta from the silicon seed, momentum from the TPC seed
-      float seedphi = 0;
-      float seedtheta = 0;
-      float seedeta = 0;
-      if (siseed && !m_forceTpcOnlyFit)
-      {
-        seedphi = siseed->get_phi();
-        seedtheta = siseed->get_theta();
-        seedeta = siseed->get_eta();
-      }
-      else
-      {
-        seedphi = tpcseed->get_phi();
-        seedtheta = tpcseed->get_theta();
-        seedeta = tpcseed->get_eta();
-      }
+    // get phi and theta from the silicon seed, momentum from the TPC seed
+    float seedphi = 0;
+    float seedtheta = 0;
+    float seedeta = 0;
+    if (siseed && !m_forceTpcOnlyFit)
+    {
+      seedphi = siseed->get_phi();
+      seedtheta = siseed->get_theta();
+      seedeta = siseed->get_eta();
+    }
+    else
+    {
+      seedphi = tpcseed->get_phi();
+      seedtheta = tpcseed->get_theta();
+      seedeta = tpcseed->get_eta();
+    }
 
-      float seedpt = tpcseed->get_pt();
+    float seedpt = tpcseed->get_pt();
 
-      if (m_ConstField)
-      {
-        float pt = fabs(1. / tpcseed->get_qOverR()) * (0.3 / 100) * fieldstrength;
-        float phi = seedphi;
-        float eta = seedeta;
-        float theta = seedtheta;
-        px = pt * std::cos(phi);
-        py = pt * std::sin(phi);
-        pz = pt * std::cosh(eta) * std::cos(theta);
-      }
-      else
-      {
-        px = seedpt * std::cos(seedphi);
-        py = seedpt * std::sin(seedphi);
-        pz = seedpt * std::cosh(seedeta) * std::cos(seedtheta);
-      }
+    if (m_ConstField)
+    {
+      float pt = fabs(1. / tpcseed->get_qOverR()) * (0.3 / 100) * fieldstrength;
+      float phi = seedphi;
+      float eta = seedeta;
+      float theta = seedtheta;
+      px = pt * std::cos(phi);
+      py = pt * std::sin(phi);
+      pz = pt * std::cosh(eta) * std::cos(theta);
+    }
+    else
+    {
+      px = seedpt * std::cos(seedphi);
+      py = seedpt * std::sin(seedphi);
+      pz = seedpt * std::cosh(seedeta) * std::cos(seedtheta);
+    }
 
-      Acts::Vector3 momentum(px, py, pz);
-      if (!is_valid(momentum))
+    Acts::Vector3 momentum(px, py, pz);
+    if (!is_valid(momentum))
+    {
+      if (Verbosity() > 4)
       {
-        if (Verbosity() > 4)
-        {
-          std::cout << "Invalid momentum of " << momentum.transpose() << std::endl;
-        }
-        continue;
+        std::cout << "Invalid momentum of " << momentum.transpose() << std::endl;
       }
+      continue;
+    }
 
-      auto pSurface = Acts::Surface::makeShared<Acts::PerigeeSurface>(position);
+    auto pSurface = Acts::Surface::makeShared<Acts::PerigeeSurface>(position);
 
-      Acts::Vector4 actsFourPos(position(0), position(1), position(2), 10 * Acts::UnitConstants::ns);
-      Acts::BoundSquareMatrix cov = setDefaultCovariance();
+    Acts::Vector4 actsFourPos(position(0), position(1), position(2), 10 * Acts::UnitConstants::ns);
+    Acts::BoundSquareMatrix cov = setDefaultCovariance();
 
-      int charge = tpcseed->get_charge();
+    int charge = tpcseed->get_charge();
 
-      /// Reset the track seed with the dummy covariance
-      auto seed = ActsTrackFittingAlgorithm::TrackParameters::create(
-                      m_transient_geocontext,
-                      pSurface,
-                      actsFourPos,
-                      momentum,
-                      charge / momentum.norm(),
-                      cov,
-                      Acts::ParticleHypothesis::pion())
-                      .value();
+    /// Reset the track seed with the dummy covariance
+    auto seed = ActsTrackFittingAlgorithm::TrackParameters::create(
+                    m_transient_geocontext,
+                    pSurface,
+                    actsFourPos,
+                    momentum,
+                    charge / momentum.norm(),
+                    cov,
+                    Acts::ParticleHypothesis::pion())
+                    .value();
 
-      if (Verbosity() > 2)
-      {
-        printTrackSeed(seed);
-      }
+    if (Verbosity() > 2)
+    {
+      printTrackSeed(seed);
+    }
 
-      /// Set host of propagator options for Acts to do e.g. material integration
-      auto calibptr = std::make_unique<Calibrator>();
-      CalibratorAdapter calibrator{*calibptr, measurements};
+    /// Set host of propagator options for Acts to do e.g. material integration
+    auto calibptr = std::make_unique<Calibrator>();
+    CalibratorAdapter calibrator{*calibptr, measurements};
 
-      auto magcontext = m_tGeometry->geometry().magFieldContext;
-      auto calibcontext = m_tGeometry->geometry().calibContext;
-      auto ppPlainOptions = Acts::PropagatorPlainOptions(m_transient_geocontext, magcontext);
+    auto magcontext = m_tGeometry->geometry().magFieldContext;
+    auto calibcontext = m_tGeometry->geometry().calibContext;
+    auto ppPlainOptions = Acts::PropagatorPlainOptions(m_transient_geocontext, magcontext);
 
-      ActsTrackFittingAlgorithm::GeneralFitterOptions
-          kfOptions{
-              m_transient_geocontext,
-              magcontext,
-              calibcontext,
-              pSurface.get(),
-              ppPlainOptions};
+    ActsTrackFittingAlgorithm::GeneralFitterOptions
+        kfOptions{
+            m_transient_geocontext,
+            magcontext,
+            calibcontext,
+            pSurface.get(),
+            ppPlainOptions};
 
-      PHTimer fitTimer("FitTimer");
-      fitTimer.stop();
-      fitTimer.restart();
+    PHTimer fitTimer("FitTimer");
+    fitTimer.stop();
+    fitTimer.restart();
 
-      auto trackContainer = std::make_shared<Acts::VectorTrackContainer>();
-      auto trackStateContainer = std::make_shared<Acts::VectorMultiTrajectory>();
-      ActsTrackFittingAlgorithm::TrackContainer tracks(trackContainer, trackStateContainer);
+    auto trackContainer = std::make_shared<Acts::VectorTrackContainer>();
+    auto trackStateContainer = std::make_shared<Acts::VectorMultiTrajectory>();
+    ActsTrackFittingAlgorithm::TrackContainer tracks(trackContainer, trackStateContainer);
 
-      if (Verbosity() > 1)
-      {
-        std::cout << "Calling fitTrack for track with siid " << siid << " tpcid " << tpcid << " crossing " << crossing << std::endl;
-        std::cout << "surfaces size " << surfaces.size() << " and source links size " << sourceLinks.size() << std::endl;
-      }
+    if (Verbosity() > 1)
+    {
+      std::cout << "Calling fitTrack for track with siid " << siid << " tpcid " << tpcid << " crossing " << crossing << std::endl;
+      std::cout << "surfaces size " << surfaces.size() << " and source links size " << sourceLinks.size() << std::endl;
+    }
 
-      auto result = fitTrack(sourceLinks, seed, kfOptions, surfaces, calibrator, tracks);
-      fitTimer.stop();
+    auto result = fitTrack(sourceLinks, seed, kfOptions, surfaces, calibrator, tracks);
+    fitTimer.stop();
 
-      if (Verbosity() > 1)
-      {
-        const auto fitTime = fitTimer.get_accumulated_time();
-        std::cout << "PHActsTrkFitter Acts fit time " << fitTime << std::endl;
-      }
+    if (Verbosity() > 1)
+    {
+      const auto fitTime = fitTimer.get_accumulated_time();
+      std::cout << "PHActsTrkFitter Acts fit time " << fitTime << std::endl;
+    }
 
-      /// Check that the track fit result did not return an error
-      if (result.ok())
+    /// Check that the track fit result did not return an error
+    if (result.ok())
+    {
+      if (use_estimate)  // trial variation case
       {
-        if (use_estimate)  // trial variation case
-        {
-          // this is a trial variation of the crossing estimate for this track
-          // Capture the chisq/ndf so we can choose the best one after all trials
+        // this is a trial variation of the crossing estimate for this track
+        // Capture the chisq/ndf so we can choose the best one after all trials
 
-          SvtxTrack_v4 newTrack;
-          newTrack.set_tpc_seed(tpcseed);
-          newTrack.set_crossing(this_crossing);
-          newTrack.set_silicon_seed(siseed);
+        SvtxTrack_v4 newTrack;
+        newTrack.set_tpc_seed(tpcseed);
+        newTrack.set_crossing(this_crossing);
+        newTrack.set_silicon_seed(siseed);
 
-          if (getTrackFitResult(result, track, &newTrack, tracks, measurements))
+        if (getTrackFitResult(result, track, &newTrack, tracks, measurements))
+        {
+          float chi2ndf = newTrack.get_quality();
+          chisq_ndf.push_back(chi2ndf);
+          svtx_vec.push_back(newTrack);
+          if (Verbosity() > 1)
           {
-            float chi2ndf = newTrack.get_quality();
-            chisq_ndf.push_back(chi2ndf);
-            svtx_vec.push_back(newTrack);
-            if (Verbosity() > 1)
-            {
-              std::cout << "   tpcid " << tpcid << " siid " << siid << " ivary " << ivary << " this_crossing " << this_crossing << " chi2ndf " << chi2ndf << std::endl;
-            }
+            std::cout << "   tpcid " << tpcid << " siid " << siid << " ivary " << ivary << " this_crossing " << this_crossing << " chi2ndf " << chi2ndf << std::endl;
           }
+        }
 
-          if (ivary != nvary)
+        if (ivary != nvary)
+        {
+          if (Verbosity() > 3)
           {
-            if (Verbosity() > 3)
-            {
-              std::cout << "Skipping track fit for trial variation" << std::endl;
-            }
-            continue;
+            std::cout << "Skipping track fit for trial variation" << std::endl;
           }
+          continue;
+        }
 
-          // if we are here this is the last crossing iteration, evaluate the results
-          if (Verbosity() > 1)
+        // if we are here this is the last crossing iteration, evaluate the results
+        if (Verbosity() > 1)
+        {
+          std::cout << "Finished with trial fits, chisq_ndf size is " << chisq_ndf.size() << " chisq_ndf values are:" << std::endl;
+        }
+        float best_chisq = 1000.0;
+        short int best_ivary = 0;
+        for (unsigned int i = 0; i < chisq_ndf.size(); ++i)
+        {
+          if (chisq_ndf[i] < best_chisq)
           {
-            std::cout << "Finished with trial fits, chisq_ndf size is " << chisq_ndf.size() << " chisq_ndf values are:" << std::endl;
+            best_chisq = chisq_ndf[i];
+            best_ivary = i;
           }
-          float best_chisq = 1000.0;
-          short int best_ivary = 0;
-          for (unsigned int i = 0; i < chisq_ndf.size(); ++i)
+          if (Verbosity() > 1)
           {
-            if (chisq_ndf[i] < best_chisq)
-            {
-              best_chisq = chisq_ndf[i];
-              best_ivary = i;
-            }
-            if (Verbosity() > 1)
-            {
-              std::cout << "  trial " << i << " chisq_ndf " << chisq_ndf[i] << " best_chisq " << best_chisq << " best_ivary " << best_ivary << std::endl;
-            }
+            std::cout << "  trial " << i << " chisq_ndf " << chisq_ndf[i] << " best_chisq " << best_chisq << " best_ivary " << best_ivary << std::endl;
           }
-          unsigned int trid = m_trackMap->size();
-          svtx_vec[best_ivary].set_id(trid);
-
-          m_trackMap->insertWithKey(&svtx_vec[best_ivary], trid);
         }
-        else  // case where crossing is known
+        if (!svtx_vec.empty())
         {
-          SvtxTrack_v4 newTrack;
-          newTrack.set_tpc_seed(tpcseed);
-          newTrack.set_crossing(this_crossing);
-          newTrack.set_silicon_seed(siseed);
-
-          if (m_fitSiliconMMs)
-          {
-            unsigned int trid = m_directedTrackMap->size();
-            newTrack.set_id(trid);
-
-            if (getTrackFitResult(result, track, &newTrack, tracks, measurements))
-            {
-              // insert in dedicated map
-              m_directedTrackMap->insertWithKey(&newTrack, trid);
-            }
-
-          }  // end insert track for SC calib fit
-          else
-          {
-            unsigned int trid = m_trackMap->size();
-            newTrack.set_id(trid);
-
-            if (getTrackFitResult(result, track, &newTrack, tracks, measurements))
-            {
-              m_trackMap->insertWithKey(&newTrack, trid);
-            }
-          }  // end insert track for normal fit
-        }  // end case where crossing is known
+          fitted = std::make_unique<SvtxTrack_v4>(svtx_vec[best_ivary]);
+        }
       }
-      else if (!m_fitSiliconMMs)
+      else  // case where crossing is known
       {
-        /// Track fit failed, get rid of the track from the map
-        m_nBadFits++;
-        if (Verbosity() > 1)
+        SvtxTrack_v4 newTrack;
+        newTrack.set_tpc_seed(tpcseed);
+        newTrack.set_crossing(this_crossing);
+        newTrack.set_silicon_seed(siseed);
+
+        // SC calib fits go to a dedicated map
+        // the id is final when tracks are fitted and stored one after the other, it is reassigned when storing the track otherwise
+        const auto* trackMap = m_fitSiliconMMs ? m_directedTrackMap : m_trackMap;
+        newTrack.set_id(trackMap->size());
+
+        if (getTrackFitResult(result, track, &newTrack, tracks, measurements))
         {
-          std::cout << "Track fit failed for track " << m_seedMap->find(track)
-                    << " with Acts error message "
-                    << result.error() << ", " << result.error().message()
-                    << std::endl;
+          fitted = std::make_unique<SvtxTrack_v4>(newTrack);
         }
-      }  // end fit failed case
-    }  // end ivary loop
+      }  // end case where crossing is known
+    }
+    else if (!m_fitSiliconMMs)
+    {
+      /// Track fit failed, get rid of the track from the map
+#pragma omp atomic
+      m_nBadFits++;
+      if (Verbosity() > 1)
+      {
+        std::cout << "Track fit failed for track " << m_seedMap->find(track)
+                  << " with Acts error message "
+                  << result.error() << ", " << result.error().message()
+                  << std::endl;
+      }
+    }  // end fit failed case
+  }  // end ivary loop
 
-    trackTimer.stop();
-    auto trackTime = trackTimer.get_accumulated_time();
+  trackTimer.stop();
+  auto trackTime = trackTimer.get_accumulated_time();
 
-    if (Verbosity() > 1)
-    {
-      std::cout << "PHActsTrkFitter total single track time " << trackTime << std::endl;
-    }
+  if (Verbosity() > 1)
+  {
+    std::cout << "PHActsTrkFitter total single track time " << trackTime << std::endl;
   }
 
-  return;
+  return fitted;
 }
 
 bool PHActsTrkFitter::getTrackFitResult(
@@ -35,6 +35,7 @@
 class alignmentTransformationContainer;
 class ActsGeometry;
 class SvtxTrack;
+class SvtxTrack_v4;
 class SvtxTrackMap;
 class TrackSeed;
 class TrackSeedContainer;
@@ -157,6 +158,11 @@ class PHActsTrkFitter : public SubsysReco
   void setDirectNavigation(bool flag) { m_directNavigation = flag; }
   void setClusterEdgeRejection(int edge ) { m_cluster_edge_rejection = edge; }
 
+  /// number of threads used to fit the seeds, 1 by default. Zero or negative uses the OpenMP default
+  /** tracks are fitted on a single thread when using the evaluator, the outlier finder,
+   * commissioning, time analysis or transient transforms (no cluster mover) */
+  void set_num_threads(int value) { m_num_threads = value; }
+
   /// extrapolation mode
   enum class ExtrapolationMode
   {
@@ -179,6 +185,9 @@ class PHActsTrkFitter : public SubsysReco
 
   void loopTracks(Acts::Logging::Level logLevel);
 
+  /// fit a single seed, returns the fitted track or nullptr
+  std::unique_ptr<SvtxTrack_v4> fitSeed(TrackSeed* track);
+
   /// Convert the acts track fit result to an svtx track
   void updateSvtxTrack(
       const std::vector<Acts::TrackIndexType>& tips,
@@ -237,6 +246,14 @@ class PHActsTrkFitter : public SubsysReco
   /// Number of acts fits that returned an error
   int m_nBadFits = 0;
 
+  /// number of threads used to fit the seeds
+  int m_num_threads = 1;
+
+  /// threads used in the last event, and the fit time summed over the run, printed in End
+  int m_threads_used = 1;
+  double m_totalEventTime = 0;
+  int m_nTimedEvents = 0;
+
   /// Boolean to use normal tracking geometry navigator or the
   /// Acts::DirectedNavigator with a list of sorted silicon+MM surfaces
   bool m_fitSiliconMMs = false;
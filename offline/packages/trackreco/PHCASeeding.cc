@@ -38,13 +38,6 @@
 #include <TFile.h>
 #include <TNtuple.h>
 
-// BOOST for combi seeding
-#include <boost/geometry.hpp>
-#include <boost/geometry/geometries/box.hpp>
-#include <boost/geometry/geometries/point.hpp>
-#include <boost/geometry/index/rtree.hpp>
-#include <boost/geometry/policies/compare.hpp>
-
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
@@ -52,6 +45,7 @@
 #include <cmath>
 #include <filesystem>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <numeric>
 #include <unordered_set>
@@ -60,6 +54,8 @@
 
 #include <cstdint>  // for uint8_t, uint16_t, uint32_t
 
+#include <omp.h>
+
 //#define _DEBUG_
 
 #if defined(_DEBUG_)
@@ -168,8 +164,6 @@ namespace
 
 }  // namespace
 
-// using namespace ROOT::Minuit2;
-namespace bgi = boost::geometry::index;
 
 PHCASeeding::PHCASeeding(
     const std::string& name,
@@ -218,7 +212,128 @@ Acts::Vector3 PHCASeeding::getGlobalPosition(TrkrDefs::cluskey key, TrkrCluster*
   return _pp_mode ? m_tGeometry->getGlobalPosition(key, cluster) : m_globalPositionWrapper.getGlobalPositionDistortionCorrected(key, cluster, 0);
 }
 
-void PHCASeeding::QueryTree(const bgi::rtree<PHCASeeding::pointKey, bgi::quadratic<16>>& rtree, double phimin, double z_min, double phimax, double z_max, std::vector<pointKey>& returned_values) const
+void PHCASeeding::LayerGrid::fill(const keyList& ckeys, const PositionMap& globalPositions, float phi_width, float z_width)
+{
+  // binning
+  // bins are about the size of the search windows, with no more than about one bin per cluster
+  float zmin = 0;
+  float zmax = 0;
+  if (!ckeys.empty())
+  {
+    const auto [min, max] = std::minmax_element(ckeys.begin(), ckeys.end(), [&globalPositions](const auto& a, const auto& b)
+                                                { return globalPositions.at(a).z() < globalPositions.at(b).z(); });
+    zmin = globalPositions.at(*min).z();
+    zmax = globalPositions.at(*max).z();
+  }
+
+  m_nphi = phi_width > 0 ? std::max(static_cast<int>(std::min(2 * M_PI / phi_width, 1024.)), 1) : 1;
+  m_nz = z_width > 0 ? std::max(static_cast<int>(std::min((zmax - zmin) / z_width, 4096.F)), 1) : 1;
+  const size_t max_bins = std::max<size_t>(ckeys.size(), 1);
+  while (static_cast<size_t>(m_nphi) * m_nz > max_bins)
+  {
+    if (m_nz >= m_nphi)
+    {
+      m_nz = (m_nz + 1) / 2;
+    }
+    else
+    {
+      m_nphi = (m_nphi + 1) / 2;
+    }
+  }
+  m_zmin = zmin;
+  m_phi_bin_width = 2 * M_PI / m_nphi;
+  m_z_bin_width = zmax > zmin ? (zmax - zmin) / m_nz : 1;
+
+  // bin all clusters
+  std::vector<unsigned int> selected(ckeys.size());
+  std::iota(selected.begin(), selected.end(), 0);
+  bin(ckeys, selected, globalPositions);
+
+  // remove clusters found at the same position as a previous cluster
+  std::vector<bool> accepted(ckeys.size(), false);
+  std::vector<unsigned int> duplicates;
+  bool has_duplicates = false;
+  for (unsigned int i = 0; i < ckeys.size(); ++i)
+  {
+    const auto& globalpos = globalPositions.at(ckeys[i]);
+    const double clus_phi = get_phi(globalpos);
+    const double clus_z = globalpos.z();
+    duplicates.clear();
+    query(clus_phi - 0.00001, clus_z - 0.00001, clus_phi + 0.00001, clus_z + 0.00001, duplicates);
+    const bool is_duplicate = std::any_of(duplicates.begin(), duplicates.end(), [&](unsigned int index)
+                                          { const auto j = m_input_index[index]; return j < i && accepted[j]; });
+    accepted[i] = !is_duplicate;
+    has_duplicates |= is_duplicate;
+  }
+
+  if (has_duplicates)
+  {
+    selected.clear();
+    for (unsigned int i = 0; i < ckeys.size(); ++i)
+    {
+      if (accepted[i])
+      {
+        selected.push_back(i);
+      }
+    }
+    bin(ckeys, selected, globalPositions);
+  }
+
+  // clusters in input order
+  fill_order.resize(keys.size());
+  std::iota(fill_order.begin(), fill_order.end(), 0);
+  std::sort(fill_order.begin(), fill_order.end(), [this](unsigned int a, unsigned int b)
+            { return m_input_index[a] < m_input_index[b]; });
+}
+
+void PHCASeeding::LayerGrid::bin(const keyList& ckeys, const std::vector<unsigned int>& selected, const PositionMap& globalPositions)
+{
+  const size_t nbins = static_cast<size_t>(m_nphi) * m_nz;
+
+  // count clusters per bin
+  std::vector<unsigned int> cluster_bin(selected.size());
+  m_bin_offsets.assign(nbins + 1, 0);
+  for (size_t i = 0; i < selected.size(); ++i)
+  {
+    const auto& globalpos = globalPositions.at(ckeys[selected[i]]);
+    const float clus_phi = get_phi(globalpos);
+    const float clus_z = globalpos.z();
+    cluster_bin[i] = phi_bin(clus_phi) * m_nz + z_bin(clus_z);
+    ++m_bin_offsets[cluster_bin[i] + 1];
+  }
+  std::partial_sum(m_bin_offsets.begin(), m_bin_offsets.end(), m_bin_offsets.begin());
+
+  // store clusters, sorted by bin
+  keys.resize(selected.size());
+  phi.resize(selected.size());
+  z.resize(selected.size());
+  position.resize(selected.size());
+  m_input_index.resize(selected.size());
+  std::vector<unsigned int> next(m_bin_offsets.begin(), m_bin_offsets.end() - 1);
+  for (size_t i = 0; i < selected.size(); ++i)
+  {
+    const auto index = next[cluster_bin[i]]++;
+    const auto& ckey = ckeys[selected[i]];
+    const auto& globalpos = globalPositions.at(ckey);
+    keys[index] = ckey;
+    phi[index] = get_phi(globalpos);
+    z[index] = globalpos.z();
+    position[index] = globalpos;
+    m_input_index[index] = selected[i];
+  }
+}
+
+int PHCASeeding::LayerGrid::phi_bin(float value) const
+{
+  return std::clamp(static_cast<int>(std::floor(value / m_phi_bin_width)), 0, m_nphi - 1);
+}
+
+int PHCASeeding::LayerGrid::z_bin(float value) const
+{
+  return std::clamp(static_cast<int>(std::floor((value - m_zmin) / m_z_bin_width)), 0, m_nz - 1);
+}
+
+void PHCASeeding::LayerGrid::query(double phimin, double zmin, double phimax, double zmax, std::vector<unsigned int>& indices) const
 {
   bool query_both_ends = false;
   if (phimin < 0)
@@ -233,12 +348,36 @@ void PHCASeeding::QueryTree(const bgi::rtree<PHCASeeding::pointKey, bgi::quadrat
   }
   if (query_both_ends)
   {
-    rtree.query(bgi::intersects(box(point(phimin, z_min), point(2 * M_PI, z_max))), std::back_inserter(returned_values));
-    rtree.query(bgi::intersects(box(point(0., z_min), point(phimax, z_max))), std::back_inserter(returned_values));
+    query_range(phimin, zmin, 2 * M_PI, zmax, indices);
+    query_range(0., zmin, phimax, zmax, indices);
   }
   else
   {
-    rtree.query(bgi::intersects(box(point(phimin, z_min), point(phimax, z_max))), std::back_inserter(returned_values));
+    query_range(phimin, zmin, phimax, zmax, indices);
+  }
+}
+
+void PHCASeeding::LayerGrid::query_range(float phimin, float zmin, float phimax, float zmax, std::vector<unsigned int>& indices) const
+{
+  if (keys.empty() || phimin > phimax || zmin > zmax)
+  {
+    return;
+  }
+
+  const int iz_min = z_bin(zmin);
+  const int iz_max = z_bin(zmax);
+  for (int iphi = phi_bin(phimin); iphi <= phi_bin(phimax); ++iphi)
+  {
+    // bins are contiguous in z for a given phi bin
+    const auto begin = m_bin_offsets[iphi * m_nz + iz_min];
+    const auto end = m_bin_offsets[iphi * m_nz + iz_max + 1];
+    for (auto index = begin; index < end; ++index)
+    {
+      if (phi[index] >= phimin && phi[index] <= phimax && z[index] >= zmin && z[index] <= zmax)
+      {
+        indices.push_back(index);
+      }
+    }
   }
 }
 
@@ -288,51 +427,6 @@ std::pair<PHCASeeding::PositionMap, PHCASeeding::keyListPerLayer> PHCASeeding::F
   return std::make_pair(cachedPositions, ckeys);
 }
 
-std::vector<PHCASeeding::coordKey> PHCASeeding::FillTree(bgi::rtree<PHCASeeding::pointKey, bgi::quadratic<16>>& _rtree, const PHCASeeding::keyList& ckeys, const PHCASeeding::PositionMap& globalPositions, const int layer)
-{
-  // Fill _rtree with the clusters in ckeys; remove duplicates, and return a vector of the coordKeys
-  // Note that layer is only used for a cout statement
-  int n_dupli = 0;
-  std::vector<coordKey> coords;
-  _rtree.clear();
-  /* _rtree.reserve(ckeys.size()); */
-  for (const auto& ckey : ckeys)
-  {
-    const auto& globalpos_d = globalPositions.at(ckey);
-    const double clus_phi = get_phi(globalpos_d);
-    const double clus_z = globalpos_d.z();
-    if (Verbosity() > 5)
-    {
-      /* int layer = TrkrDefs::getLayer(ckey); */
-      std::cout << "Found cluster " << ckey << " in layer " << layer << std::endl;
-    }
-    std::vector<pointKey> testduplicate;
-    QueryTree(_rtree, clus_phi - 0.00001, clus_z - 0.00001, clus_phi + 0.00001, clus_z + 0.00001, testduplicate);
-    if (!testduplicate.empty())
-    {
-      ++n_dupli;
-      continue;
-    }
-    coords.push_back({{static_cast<float>(clus_phi), static_cast<float>(clus_z)}, ckey});
-    t_fill->restart();
-    _rtree.insert(std::make_pair(point(clus_phi, globalpos_d.z()), ckey));
-    t_fill->stop();
-  }
-  if (Verbosity() > 5)
-  {
-    std::cout << "nhits in layer(" << layer << "): " << coords.size() << std::endl;
-  }
-  if (Verbosity() > 3)
-  {
-    std::cout << "fill time: " << t_fill->get_accumulated_time() / 1000. << " sec" << std::endl;
-  }
-  if (Verbosity() > 3)
-  {
-    std::cout << "number of duplicates : " << n_dupli << std::endl;
-  }
-  return coords;
-}
-
 int PHCASeeding::Process(PHCompositeNode* /*topNode*/)
 {
   process_tupout_count();
@@ -350,6 +444,7 @@ int PHCASeeding::Process(PHCompositeNode* /*topNode*/)
     }
   }
 
+  t_process->restart();
   t_seed->restart();
   t_makebilinks->restart();
 
@@ -360,7 +455,7 @@ int PHCASeeding::Process(PHCompositeNode* /*topNode*/)
   t_seed->stop();
   if (Verbosity() > 0)
   {
-    std::cout << "Initial RTree fill time: " << t_seed->get_accumulated_time() / 1000 << " s" << std::endl;
+    std::cout << "Initial position fill time: " << t_seed->get_accumulated_time() / 1000 << " s" << std::endl;
   }
   t_seed->restart();
   int numberofseeds = 0;
@@ -374,6 +469,10 @@ int PHCASeeding::Process(PHCompositeNode* /*topNode*/)
   {
     std::cout << "Kalman filtering time: " << t_seed->get_accumulated_time() / 1000 << " s" << std::endl;
   }
+
+  // total seeding time, for throughput
+  t_process->stop();
+  m_total_seeds += numberofseeds;
   //  fpara.cd();
   //  fpara.Close();
   //  if(Verbosity()>0) std::cout << "fpara OK\n";
@@ -397,7 +496,7 @@ int PHCASeeding::FindSeedsWithMerger(const PHCASeeding::PositionMap& globalPosit
     t_makeseeds->stop();
     std::cout << "Time to make seeds: " << t_makeseeds->elapsed() / 1000 << " s" << std::endl;
   }
-  std::vector<TrackSeed_v2> seeds = RemoveBadClusters(trackSeedKeyLists, globalPositions);
+  std::vector<TrackSeed_v3> seeds = RemoveBadClusters(trackSeedKeyLists, globalPositions);
 
   publishSeeds(seeds);
   return seeds.size();
@@ -407,133 +506,111 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
 {
   keyLinks startLinks;        // bilinks at start of chains
   keyLinkPerLayer bodyLinks;  //  bilinks to build chains
-                              //
-  double cluster_find_time = 0;
-  double rtree_query_time = 0;
-  double transform_time = 0;
-  double compute_best_angle_time = 0;
-  double set_insert_time = 0;
-
-  // there are three coord_array (only the current layer is used at a time,
-  // but it is filled the same time as the _rtrees, which are used two at
-  // a time -- the prior padplane row and the next padplain row
-  std::array<std::vector<coordKey>, 3> coord_arr;
-  std::array<std::unordered_set<keyLink>, 2> previous_downlinks_arr;
-  std::array<std::unordered_set<TrkrDefs::cluskey>, 2> bottom_of_bilink_arr;
 
   // iterate from outer to inner layers
   const int inner_index = _start_layer - _FIRST_LAYER_TPC + 1;
   const int outer_index = _end_layer - _FIRST_LAYER_TPC - 2;
 
-  // fill the current and prior row coord and ttrees for the first iteration
-  int _index_above = (outer_index + 1) % 3;
-  int _index_current = (outer_index) % 3;
-  coord_arr[_index_above] = FillTree(_rtrees[_index_above], ckeys[outer_index + 1], globalPositions, outer_index + 1);
-  coord_arr[_index_current] = FillTree(_rtrees[_index_current], ckeys[outer_index], globalPositions, outer_index);
+#if defined(_PHCASEEDING_CLUSTERLOG_TUPOUT_)
+  // tuples are filled while searching links
+  const int nthreads = 1;
+#else
+  const int nthreads = m_num_threads >= 1 ? m_num_threads : omp_get_max_threads();
+#endif
 
-  for (int layer_index = outer_index; layer_index >= inner_index; --layer_index)
+  // bin the clusters of all the layers used in the search
+  t_fill->restart();
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+  for (int layer_index = inner_index - 1; layer_index <= outer_index + 1; ++layer_index)
   {
-    // these lines of code will rotates through all three _rtree's in the array,
-    // where the old lower becomes the new middle, the old middle the new upper,
-    // and the old upper drops out and that _rtree is filled with the new lower
+    // the grid is searched with the windows of this layer and the one above
     const unsigned int LAYER = layer_index + _FIRST_LAYER_TPC;
-    int index_above = (layer_index + 1) % 3;
-    int index_current = (layer_index) % 3;
-    int index_below = (layer_index - 1) % 3;
-
-    coord_arr[index_below] = FillTree(_rtrees[index_below], ckeys[layer_index - 1], globalPositions, layer_index - 1);
-
-    // NO DUPLICATES FOUND IN COORD_ARR
-
-    auto& _rtree_above = _rtrees[index_above];
-    const std::vector<coordKey>& coord = coord_arr[index_current];
-    auto& _rtree_below = _rtrees[index_below];
-
-    auto& curr_downlinks = previous_downlinks_arr[layer_index % 2];
-    auto& last_downlinks = previous_downlinks_arr[(layer_index + 1) % 2];
-
-    auto& curr_bottom_of_bilink = bottom_of_bilink_arr[layer_index % 2];
-    auto& last_bottom_of_bilink = bottom_of_bilink_arr[(layer_index + 1) % 2];
-
-    curr_downlinks.clear();
-    curr_bottom_of_bilink.clear();
-
-    // For all the clusters in coord, find nearest neighbors in the
-    // above and below layers and make links
-    // Any link to an above node which matches the same clusters
-    // on the previous iteration (to a "below node") becomes a "bilink"
-    // Check if this bilink links to a prior bilink or not
+    const unsigned int LAYER_ABOVE = std::min<unsigned int>(LAYER + 1, dphi_per_layer.size() - 1);
+    m_layer_grids[layer_index].fill(ckeys[layer_index], globalPositions,
+                                    std::max(dphi_per_layer[LAYER], dphi_per_layer[LAYER_ABOVE]),
+                                    std::max(dZ_per_layer[LAYER], dZ_per_layer[LAYER_ABOVE]));
+  }
+  t_fill->stop();
+  if (Verbosity() > 3)
+  {
+    std::cout << "fill time: " << t_fill->get_accumulated_time() / 1000. << " sec" << std::endl;
+  }
 
-    std::vector<keyLink> aboveLinks;
-    for (const auto& StartCluster : coord)
+  // For all the clusters in each layer, find nearest neighbors in the
+  // above and below layers and make links. Layers are independent.
+  // - downlinks (cluster, below cluster) are sorted, for searching
+  // - uplinks (above cluster, cluster) are ordered by cluster, then by above cluster key.
+  //   This sets the order of the start links, hence of the output seeds. The seeds themselves
+  //   do not depend on it, since every chain is grown independently in FollowBiLinks
+  keyLinkPerLayer downlinks;
+  keyLinkPerLayer uplinks;
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+  for (int layer_index = outer_index; layer_index >= inner_index; --layer_index)
+  {
+    const unsigned int LAYER = layer_index + _FIRST_LAYER_TPC;
+    const auto& grid_above = m_layer_grids[layer_index + 1];
+    const auto& grid = m_layer_grids[layer_index];
+    const auto& grid_below = m_layer_grids[layer_index - 1];
+
+    auto& curr_downlinks = downlinks[layer_index];
+    auto& curr_uplinks = uplinks[layer_index];
+
+    std::vector<unsigned int> ClustersAbove;
+    std::vector<unsigned int> ClustersBelow;
+    std::vector<std::array<double, 3>> delta_below;
+    std::vector<std::array<double, 3>> delta_above;
+    keyList bestAboveClusters;
+    for (const auto& istart : grid.fill_order)
     {
-      double StartPhi = StartCluster.first[0];
-      const auto& globalpos = globalPositions.at(StartCluster.second);
-      double StartX = globalpos(0);
-      double StartY = globalpos(1);
-      double StartZ = globalpos(2);
-      t_seed->stop();
-      cluster_find_time += t_seed->elapsed();
-      t_seed->restart();
+      const TrkrDefs::cluskey StartKey = grid.keys[istart];
+      const double StartPhi = grid.phi[istart];
+      const auto& globalpos = grid.position[istart];
+      const double StartX = globalpos(0);
+      const double StartY = globalpos(1);
+      const double StartZ = globalpos(2);
       LogDebug(" starting cluster:" << std::endl);
       LogDebug(" z: " << StartZ << std::endl);
       LogDebug(" phi: " << StartPhi << std::endl);
 
-      std::vector<pointKey> ClustersAbove;
-      std::vector<pointKey> ClustersBelow;
-
-      QueryTree(_rtree_below,
-                StartPhi - dphi_per_layer[LAYER],
-                StartZ - dZ_per_layer[LAYER],
-                StartPhi + dphi_per_layer[LAYER],
-                StartZ + dZ_per_layer[LAYER],
-                ClustersBelow);
+      ClustersBelow.clear();
+      grid_below.query(
+          StartPhi - dphi_per_layer[LAYER],
+          StartZ - dZ_per_layer[LAYER],
+          StartPhi + dphi_per_layer[LAYER],
+          StartZ + dZ_per_layer[LAYER],
+          ClustersBelow);
 
-      FillTupWinLink(_rtree_below, StartCluster, globalPositions);
+      FillTupWinLink(grid_below, StartKey, StartPhi, globalPositions);
 
-      QueryTree(_rtree_above,
-                StartPhi - dphi_per_layer[LAYER + 1],
-                StartZ - dZ_per_layer[LAYER + 1],
-                StartPhi + dphi_per_layer[LAYER + 1],
-                StartZ + dZ_per_layer[LAYER + 1],
-                ClustersAbove);
+      ClustersAbove.clear();
+      grid_above.query(
+          StartPhi - dphi_per_layer[LAYER + 1],
+          StartZ - dZ_per_layer[LAYER + 1],
+          StartPhi + dphi_per_layer[LAYER + 1],
+          StartZ + dZ_per_layer[LAYER + 1],
+          ClustersAbove);
 
-      t_seed->stop();
-      rtree_query_time += t_seed->elapsed();
-      t_seed->restart();
       LogDebug(" entries in below layer: " << ClustersBelow.size() << std::endl);
       LogDebug(" entries in above layer: " << ClustersAbove.size() << std::endl);
-      std::vector<std::array<double, 3>> delta_below;
-      std::vector<std::array<double, 3>> delta_above;
+
+      // calculate (delta_x, delta_y, delta_z) vector for each neighboring cluster
       delta_below.clear();
+      for (const auto& ibelow : ClustersBelow)
+      {
+        const auto& belowpos = grid_below.position[ibelow];
+        delta_below.push_back({belowpos(0) - StartX, belowpos(1) - StartY, belowpos(2) - StartZ});
+      }
+
       delta_above.clear();
-      delta_below.resize(ClustersBelow.size());
-      delta_above.resize(ClustersAbove.size());
-      // calculate (delta_z_, delta_phi) vector for each neighboring cluster
-
-      std::transform(ClustersBelow.begin(), ClustersBelow.end(), delta_below.begin(),
-                     [&](pointKey BelowCandidate)
-                     {
-          const auto& belowpos = globalPositions.at(BelowCandidate.second);
-          return std::array<double,3>{belowpos(0)-StartX,
-          belowpos(1)-StartY,
-          belowpos(2)-StartZ}; });
-
-      std::transform(ClustersAbove.begin(), ClustersAbove.end(), delta_above.begin(),
-                     [&](pointKey AboveCandidate)
-                     {
-          const auto& abovepos = globalPositions.at(AboveCandidate.second);
-          return std::array<double,3>{abovepos(0)-StartX,
-          abovepos(1)-StartY,
-          abovepos(2)-StartZ}; });
-      t_seed->stop();
-      transform_time += t_seed->elapsed();
-      t_seed->restart();
+      for (const auto& iabove : ClustersAbove)
+      {
+        const auto& abovepos = grid_above.position[iabove];
+        delta_above.push_back({abovepos(0) - StartX, abovepos(1) - StartY, abovepos(2) - StartZ});
+      }
 
       // find the three clusters closest to a straight line
       // (by maximizing the cos of the angle between the (delta_z_,delta_phi) vectors)
-      // double minSumLengths = 1e9;
-      std::unordered_set<TrkrDefs::cluskey> bestAboveClusters;
+      bestAboveClusters.clear();
       for (size_t iAbove = 0; iAbove < delta_above.size(); ++iAbove)
       {
         for (size_t iBelow = 0; iBelow < delta_below.size(); ++iBelow)
@@ -547,21 +624,20 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
           const double B_len_sq = (B[0] * B[0] + B[1] * B[1] + B[2] * B[2]);
           const double dot_prod = (A[0] * B[0] + A[1] * B[1] + A[2] * B[2]);
           const double cos_angle_sq = dot_prod * dot_prod / A_len_sq / B_len_sq;  // also same as cos(angle), where angle is between two vectors
-          FillTupWinCosAngle(ClustersAbove[iAbove].second, StartCluster.second, ClustersBelow[iBelow].second, globalPositions, cos_angle_sq, (dot_prod < 0.));
+          const auto& AboveKey = grid_above.keys[ClustersAbove[iAbove]];
+          const auto& BelowKey = grid_below.keys[ClustersBelow[iBelow]];
+          FillTupWinCosAngle(AboveKey, StartKey, BelowKey, globalPositions, cos_angle_sq, (dot_prod < 0.));
 
           constexpr double maxCosPlaneAngle = -0.95;
           constexpr double maxCosPlaneAngle_sq = maxCosPlaneAngle * maxCosPlaneAngle;
           if ((dot_prod < 0.) && (cos_angle_sq > maxCosPlaneAngle_sq))
           {
-            // maxCosPlaneAngle = cos(angle);
-            // minSumLengths = belowLength+aboveLength;
-            curr_downlinks.insert({StartCluster.second, ClustersBelow[iBelow].second});
-            bestAboveClusters.insert(ClustersAbove[iAbove].second);
-
+            curr_downlinks.emplace_back(StartKey, BelowKey);
+            bestAboveClusters.push_back(AboveKey);
             // fill the tuples for plotting
-            fill_tuple(_tupclus_links, 0, StartCluster.second, globalPositions.at(StartCluster.second));
-            fill_tuple(_tupclus_links, -1, ClustersBelow[iBelow].second, globalPositions.at(ClustersBelow[iBelow].second));
-            fill_tuple(_tupclus_links, 1, ClustersAbove[iAbove].second, globalPositions.at(ClustersAbove[iAbove].second));
+            fill_tuple(_tupclus_links, 0, StartKey, globalpos);
+            fill_tuple(_tupclus_links, -1, BelowKey, grid_below.position[ClustersBelow[iBelow]]);
+            fill_tuple(_tupclus_links, 1, AboveKey, grid_above.position[ClustersAbove[iAbove]]);
           }
         }
       }
@@ -569,55 +645,64 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
       // There was some old commented-out code here for allowing layers to be skipped. This
       // may be useful in the future. This chunk of code has been moved towards the
       // end fo the file under the title: "---OLD CODE 0: SKIP_LAYERS---"
-      t_seed->stop();
-      compute_best_angle_time += t_seed->elapsed();
-      t_seed->restart();
 
-      for (auto cluster : bestAboveClusters)
+      std::sort(bestAboveClusters.begin(), bestAboveClusters.end());
+      bestAboveClusters.erase(std::unique(bestAboveClusters.begin(), bestAboveClusters.end()), bestAboveClusters.end());
+      for (const auto& cluster : bestAboveClusters)
       {
-        keyLink uplink = std::make_pair(cluster, StartCluster.second);
+        curr_uplinks.emplace_back(cluster, StartKey);
+      }
+    }  // end loop over start clusters
 
-        if (last_downlinks.find(uplink) != last_downlinks.end())
+    std::sort(curr_downlinks.begin(), curr_downlinks.end());
+    curr_downlinks.erase(std::unique(curr_downlinks.begin(), curr_downlinks.end()), curr_downlinks.end());
+  }  // end loop over layers (to make links)
+
+  // Any link to an above node which matches a link from that node to a "below node"
+  // becomes a "bilink". Check if this bilink links to a prior bilink or not
+  keyList last_bottom_of_bilink;
+  keyList curr_bottom_of_bilink;
+  for (int layer_index = outer_index; layer_index >= inner_index; --layer_index)
+  {
+    curr_bottom_of_bilink.clear();
+    if (layer_index < outer_index)
+    {
+      const auto& last_downlinks = downlinks[layer_index + 1];
+      for (const auto& uplink : uplinks[layer_index])
+      {
+        if (!std::binary_search(last_downlinks.begin(), last_downlinks.end(), uplink))
         {
-          // this is a bilink
-          const auto& key_top = uplink.first;
-          const auto& key_bot = uplink.second;
-          curr_bottom_of_bilink.insert(key_bot);
-          fill_tuple(_tupclus_bilinks, 0, key_top, globalPositions.at(key_top));
-          fill_tuple(_tupclus_bilinks, 1, key_bot, globalPositions.at(key_bot));
-
-          if (last_bottom_of_bilink.find(key_top) == last_bottom_of_bilink.end())
-          {
-            startLinks.push_back(std::make_pair(key_top, key_bot));
-          }
-          else
-          {
-            bodyLinks[layer_index + 1].push_back(std::make_pair(key_top, key_bot));
-          }
+          continue;
         }
-      }  // end loop over all up-links
-    }    // end loop over start clusters
 
-    t_seed->stop();
-    set_insert_time += t_seed->elapsed();
-    t_seed->restart();
-    LogDebug(" max collinearity: " << maxCosPlaneAngle << std::endl);
-  }  // end loop over layers (to make links)
+        // this is a bilink
+        const auto& key_top = uplink.first;
+        const auto& key_bot = uplink.second;
+        curr_bottom_of_bilink.push_back(key_bot);
+        fill_tuple(_tupclus_bilinks, 0, key_top, globalPositions.at(key_top));
+        fill_tuple(_tupclus_bilinks, 1, key_bot, globalPositions.at(key_bot));
+
+        if (!std::binary_search(last_bottom_of_bilink.begin(), last_bottom_of_bilink.end(), key_top))
+        {
+          startLinks.push_back(uplink);
+        }
+        else
+        {
+          bodyLinks[layer_index + 1].push_back(uplink);
+        }
+      }  // end loop over all up-links
+    }
+    std::sort(curr_bottom_of_bilink.begin(), curr_bottom_of_bilink.end());
+    std::swap(last_bottom_of_bilink, curr_bottom_of_bilink);
+  }
 
   t_seed->stop();
   if (Verbosity() > 0)
   {
     std::cout << "triplet forming time: " << t_seed->get_accumulated_time() / 1000 << " s" << std::endl;
-    std::cout << "starting cluster setup: " << cluster_find_time / 1000 << " s" << std::endl;
-    std::cout << "RTree query: " << rtree_query_time / 1000 << " s" << std::endl;
-    std::cout << "Transform: " << transform_time / 1000 << " s" << std::endl;
-    std::cout << "Compute best triplet: " << compute_best_angle_time / 1000 << " s" << std::endl;
-    std::cout << "Set insert: " << set_insert_time / 1000 << " s" << std::endl;
   }
   t_seed->restart();
 
-  // sort the body links per layer so that links can be binary-searched per layer
-  /* for (auto& layer : bodyLinks) { std::sort(layer.begin(), layer.end()); } */
   return std::make_pair(startLinks, bodyLinks);
 }
 
@@ -641,31 +726,35 @@ double PHCASeeding::getMengerCurvature(TrkrDefs::cluskey a, TrkrDefs::cluskey b,
 
 PHCASeeding::keyLists PHCASeeding::FollowBiLinks(const PHCASeeding::keyLinks& trackSeedPairs, const PHCASeeding::keyLinkPerLayer& bilinks, const PHCASeeding::PositionMap& globalPositions) const
 {
+  // sort the bilinks of each layer by their top cluster, so that links matching a given head can be binary-searched
+  // the stable sort keeps the links sharing the same top cluster in their original order
+  keyLinkPerLayer sorted_bilinks = bilinks;
+  for (auto& layer_links : sorted_bilinks)
+  {
+    std::stable_sort(layer_links.begin(), layer_links.end(), [](const keyLink& a, const keyLink& b)
+                     { return a.first < b.first; });
+  }
+
   // form all possible starting 3-cluster tracks (we need that to calculate curvature)
   keyLists seeds;
   for (auto& startLink : trackSeedPairs)
   {
     TrkrDefs::cluskey trackHead = startLink.second;
     unsigned int trackHead_layer = TrkrDefs::getLayer(trackHead) - _FIRST_LAYER_TPC;
-    // the following call with get iterators to all bilinks which match the head
-    for (const auto& matchlink : bilinks[trackHead_layer])
+    // get all bilinks which match the head
+    const auto& layer_links = sorted_bilinks[trackHead_layer];
+    const auto matched_links = std::equal_range(layer_links.begin(), layer_links.end(), trackHead, CompKeyToBilink());
+    for (auto matchlink = matched_links.first; matchlink != matched_links.second; ++matchlink)
     {
-      /* auto matched_links = std::equal_range(bilinks[trackHead_layer].begin(), bilinks[trackHead_layer].end(), trackHead, CompKeyToBilink()); */
-      /* for (auto matchlink = matched_links.first; matchlink != matched_links.second; ++matchlink) */
-      /* { */
-      if (matchlink.first != trackHead)
-      {
-        continue;
-      }
       keyList trackSeedTriplet;
       trackSeedTriplet.push_back(startLink.first);
       trackSeedTriplet.push_back(startLink.second);
-      trackSeedTriplet.push_back(matchlink.second);
+      trackSeedTriplet.push_back(matchlink->second);
       seeds.push_back(trackSeedTriplet);
 
       fill_tuple(_tupclus_seeds, 0, startLink.first, globalPositions.at(startLink.first));
       fill_tuple(_tupclus_seeds, 1, startLink.second, globalPositions.at(startLink.second));
-      fill_tuple(_tupclus_seeds, 2, matchlink.second, globalPositions.at(matchlink.second));
+      fill_tuple(_tupclus_seeds, 2, matchlink->second, globalPositions.at(matchlink->second));
     }
   }
 
@@ -720,15 +809,12 @@ PHCASeeding::keyLists PHCASeeding::FollowBiLinks(const PHCASeeding::keyLinks& tr
         keySet link_matches{};
         for (const auto& head_key : head_keys)
         {
-          // also possible to sort the links and use a sorted search like:
-          // auto matched_links = std::equal_range(bilinks[trackHead_layer].begin(), bilinks[trackHead_layer].end(), trackHead, CompKeyToBilink());
-          // for (auto link = matched_links.first; link != matched_links.second; ++link)
-          for (auto& link : bilinks[iL])
-          {  // iL for "Index of Layer"
-            if (link.first == head_key)
-            {
-              link_matches.insert(link.second);
-            }
+          // iL for "Index of Layer"
+          const auto& layer_links = sorted_bilinks[iL];
+          const auto matched_links = std::equal_range(layer_links.begin(), layer_links.end(), head_key, CompKeyToBilink());
+          for (auto link = matched_links.first; link != matched_links.second; ++link)
+          {
+            link_matches.insert(link->second);
           }
         }
 
@@ -885,13 +971,13 @@ PHCASeeding::keyLists PHCASeeding::FollowBiLinks(const PHCASeeding::keyLinks& tr
   return grown_seeds;
 }
 
-std::vector<TrackSeed_v2> PHCASeeding::RemoveBadClusters(const std::vector<PHCASeeding::keyList>& chains, const PHCASeeding::PositionMap& globalPositions) const
+std::vector<TrackSeed_v3> PHCASeeding::RemoveBadClusters(const std::vector<PHCASeeding::keyList>& chains, const PHCASeeding::PositionMap& globalPositions) const
 {
   if (Verbosity() > 0)
   {
     std::cout << "removing bad clusters" << std::endl;
   }
-  std::vector<TrackSeed_v2> clean_chains;
+  std::vector<TrackSeed_v3> clean_chains;
 
   for (const auto& chain : chains)
   {
@@ -924,7 +1010,7 @@ std::vector<TrackSeed_v2> PHCASeeding::RemoveBadClusters(const std::vector<PHCAS
     const std::vector<double> xy_resid = TrackFitUtils::getCircleClusterResiduals(xy_pts, R, X0, Y0);
 
     // assign clusters to seed
-    TrackSeed_v2 trackseed;
+    TrackSeed_v3 trackseed;
     for (const auto& key : chain)
     {
       trackseed.insert_cluster_key(key);
@@ -939,11 +1025,11 @@ std::vector<TrackSeed_v2> PHCASeeding::RemoveBadClusters(const std::vector<PHCAS
   return clean_chains;
 }
 
-void PHCASeeding::publishSeeds(const std::vector<TrackSeed_v2>& seeds) const
+void PHCASeeding::publishSeeds(const std::vector<TrackSeed_v3>& seeds) const
 {
   for (const auto& seed : seeds)
   {
-    auto pseed = std::make_unique<TrackSeed_v2>(seed);
+    auto pseed = std::make_unique<TrackSeed_v3>(seed);
     if (Verbosity() > 4)
     {
       pseed->identify();
@@ -982,6 +1068,9 @@ int PHCASeeding::Setup(PHCompositeNode* topNode)  // This is called by ::InitRun
   t_makeseeds = std::make_unique<PHTimer>("t_makeseeds");
   t_makeseeds->stop();
 
+  t_process = std::make_unique<PHTimer>("t_process");
+  t_process->stop();
+
   auto geom_container =
       findNode::getClass<PHG4TpcGeomContainer>(topNode, "TPCGEOMCONTAINER");
   if (!geom_container)
@@ -1031,6 +1120,13 @@ int PHCASeeding::End()
   if (Verbosity() > 0)
   {
     std::cout << "Called End " << std::endl;
+    const double seconds = t_process->get_accumulated_time() / 1000;
+    std::cout << "PHCASeeding::End - " << m_total_seeds << " seeds in " << seconds << " s";
+    if (seconds > 0)
+    {
+      std::cout << " (" << m_total_seeds / seconds << " seeds/s)";
+    }
+    std::cout << std::endl;
   }
   write_tuples();  // if defined _PHCASEEDING_CLUSTERLOG_TUPOUT_
   return Fun4AllReturnCodes::EVENT_OK;
@@ -1170,26 +1266,25 @@ void PHCASeeding::process_tupout_count()
   _search_windows->Fill(_neighbor_z_width, _neighbor_phi_width, _start_layer, _end_layer, _clusadd_delta_dzdr_window, _clusadd_delta_dphidr2_window);
 }
 
-void PHCASeeding::FillTupWinLink(bgi::rtree<PHCASeeding::pointKey, bgi::quadratic<16>>& _rtree_below, const PHCASeeding::coordKey& StartCluster, const PHCASeeding::PositionMap& globalPositions) const
+void PHCASeeding::FillTupWinLink(const PHCASeeding::LayerGrid& grid_below, const TrkrDefs::cluskey StartKey, const double StartPhi, const PHCASeeding::PositionMap& globalPositions) const
 {
-  double StartPhi = StartCluster.first[0];
-  const auto& P0 = globalPositions.at(StartCluster.second);
+  const auto& P0 = globalPositions.at(StartKey);
   double StartZ = P0(2);
   // Fill TNTuple _tupwin_link
-  std::vector<pointKey> ClustersBelow;
-  QueryTree(_rtree_below,
-            StartPhi - 1.,
-            StartZ - 20.,
-            StartPhi + 1.,
-            StartZ + 20.,
-            ClustersBelow);
-
-  for (const auto& pkey : ClustersBelow)
+  std::vector<unsigned int> ClustersBelow;
+  grid_below.query(
+      StartPhi - 1.,
+      StartZ - 20.,
+      StartPhi + 1.,
+      StartZ + 20.,
+      ClustersBelow);
+
+  for (const auto& index : ClustersBelow)
   {
-    const auto P1 = globalPositions.at(pkey.second);
-    double dphi = bg::get<0>(pkey.first) - StartPhi;
+    const auto& P1 = grid_below.position[index];
+    double dphi = grid_below.phi[index] - StartPhi;
     double dZ = P1(2) - StartZ;
-    _tupwin_link->Fill(_tupout_count, TrkrDefs::getLayer(StartCluster.second), P0(0), P0(1), P0(2), TrkrDefs::getLayer(pkey.second), P1(0), P1(1), P1(2), dphi, dZ);
+    _tupwin_link->Fill(_tupout_count, TrkrDefs::getLayer(StartKey), P0(0), P0(1), P0(2), TrkrDefs::getLayer(grid_below.keys[index]), P1(0), P1(1), P1(2), dphi, dZ);
   }
 }
 
@@ -1258,7 +1353,7 @@ void PHCASeeding::write_tuples(){};
 void PHCASeeding::fill_tuple(TNtuple* /**/, float /**/, TrkrDefs::cluskey /**/, const Acts::Vector3& /**/) const {};
 void PHCASeeding::fill_tuple_with_seed(TNtuple* /**/, const PHCASeeding::keyList& /**/, const PHCASeeding::PositionMap& /**/) const {};
 void PHCASeeding::process_tupout_count(){};
-void PHCASeeding::FillTupWinLink(bgi::rtree<PHCASeeding::pointKey, bgi::quadratic<16>>& /**/, const PHCASeeding::coordKey& /**/, const PHCASeeding::PositionMap& /**/) const {};
+void PHCASeeding::FillTupWinLink(const PHCASeeding::LayerGrid& /**/, const TrkrDefs::cluskey /**/, const double /**/, const PHCASeeding::PositionMap& /**/) const {};
 void PHCASeeding::FillTupWinCosAngle(const TrkrDefs::cluskey /**/, const TrkrDefs::cluskey /**/, const TrkrDefs::cluskey /**/, const PHCASeeding::PositionMap& /**/, double /**/, bool /**/) const {};
 void PHCASeeding::FillTupWinGrowSeed(const PHCASeeding::keyList& /**/, const PHCASeeding::keyLink& /**/, const PHCASeeding::PositionMap& /**/) const {};
 #endif  // defined _PHCASEEDING_CLUSTERLOG_TUPOUT_
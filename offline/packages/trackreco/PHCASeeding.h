@@ -18,21 +18,14 @@
 #include <tpc/TpcGlobalPositionWrapper.h>
 
 #include <trackbase/TrkrDefs.h>  // for cluskey
-#include <trackbase_historic/TrackSeed_v2.h>
+#include <trackbase_historic/TrackSeed_v3.h>
 
 #include <phool/PHTimer.h>  // for PHTimer
 
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-#include <boost/geometry/geometries/box.hpp>  // for box
-#pragma GCC diagnostic pop
-
-#include <boost/geometry/geometries/point.hpp>  // for point
-#include <boost/geometry/index/rtree.hpp>       // for ca
-
+#include <array>
 #include <cmath>    // for M_PI
 #include <cstdint>  // for uint64_t
 #include <map>      // for map
@@ -54,9 +47,6 @@ class SvtxTrack_v3;
 class TpcDistortionCorrectionContainer;
 class TrkrCluster;
 
-namespace bg = boost::geometry;
-namespace bgi = boost::geometry::index;
-
 class PHCASeeding : public PHTrackSeeding
 {
  public:
@@ -64,11 +54,6 @@ class PHCASeeding : public PHTrackSeeding
   static const int _FIRST_LAYER_TPC = 7;
   // move `using` statements inside of the class to avoid polluting the global namespace
 
-  using point = bg::model::point<float, 2, bg::cs::cartesian>;
-  using box = bg::model::box<point>;
-  using pointKey = std::pair<point, TrkrDefs::cluskey>;                 // phi and z in the key
-  using coordKey = std::pair<std::array<float, 2>, TrkrDefs::cluskey>;  // just use phi and Z, no longer needs the layer
-
   using keyList = std::vector<TrkrDefs::cluskey>;
   using keyLists = std::vector<keyList>;
   using keyListPerLayer = std::array<keyList, _NLAYERS_TPC>;
@@ -156,6 +141,9 @@ class PHCASeeding : public PHTrackSeeding
   void setNitrogenFraction(double frac) { N2_frac = frac; };
   void setIsobutaneFraction(double frac) { isobutane_frac = frac; };
 
+  //! number of threads used to search links, 1 by default. 0 uses the OpenMP default
+  void set_num_threads(int value) { m_num_threads = value; }
+
  protected:
   int Setup(PHCompositeNode* topNode) override;
   int Process(PHCompositeNode* topNode) override;
@@ -190,7 +178,8 @@ class PHCASeeding : public PHTrackSeeding
   void fill_tuple(TNtuple*, float, TrkrDefs::cluskey, const Acts::Vector3&) const;
   void fill_tuple_with_seed(TNtuple*, const keyList&, const PositionMap&) const;
   void process_tupout_count();
-  void FillTupWinLink(bgi::rtree<pointKey, bgi::quadratic<16>>&, const coordKey&, const PositionMap&) const;
+  class LayerGrid;
+  void FillTupWinLink(const LayerGrid&, TrkrDefs::cluskey, double start_phi, const PositionMap&) const;
   void FillTupWinCosAngle(const TrkrDefs::cluskey, const TrkrDefs::cluskey, const TrkrDefs::cluskey, const PositionMap&, double cos_angle, bool isneg) const;
   void FillTupWinGrowSeed(const keyList& seed, const keyLink& link, const PositionMap& globalPositions) const;
   void fill_split_chains(const keyList& chain, const keyList& keylinks, const PositionMap& globalPositions, int& nchains) const;
@@ -212,6 +201,52 @@ class PHCASeeding : public PHTrackSeeding
   };
   std::pair<std::vector<keyLink>::iterator, std::vector<keyLink>::iterator> FindBilinks(const TrkrDefs::cluskey& key);
 
+  //! clusters of one TPC layer, binned in (phi, z)
+  /*!
+   * cluster data are stored in flat arrays, sorted by bin, and built once per event.
+   * phi and z are stored as float, and windows are inclusive, consistently with the former rtree search
+   */
+  class LayerGrid
+  {
+   public:
+    //! fill from cluster keys, skipping clusters found at the same (phi, z) as a previous one
+    /*! phi_width and z_width are the typical search window half widths, used to choose the binning */
+    void fill(const keyList& ckeys, const PositionMap& globalPositions, float phi_width, float z_width);
+
+    //! append to indices all clusters inside [phimin, phimax] x [zmin, zmax], phi being wrapped around 2pi
+    void query(double phimin, double zmin, double phimax, double zmax, std::vector<unsigned int>& indices) const;
+
+    //!@name cluster data, sorted by bin
+    //@{
+    std::vector<TrkrDefs::cluskey> keys;
+    std::vector<float> phi;
+    std::vector<float> z;
+    std::vector<Acts::Vector3> position;
+    //@}
+
+    //! cluster indices, in the order of the input keys
+    std::vector<unsigned int> fill_order;
+
+   private:
+    //! sort clusters by bin
+    void bin(const keyList& ckeys, const std::vector<unsigned int>& selected, const PositionMap& globalPositions);
+    void query_range(float phimin, float zmin, float phimax, float zmax, std::vector<unsigned int>& indices) const;
+    int phi_bin(float value) const;
+    int z_bin(float value) const;
+
+    int m_nphi = 1;
+    int m_nz = 1;
+    float m_zmin = 0;
+    float m_phi_bin_width = 2 * M_PI;
+    float m_z_bin_width = 1;
+
+    //! first cluster of each bin, plus total
+    std::vector<unsigned int> m_bin_offsets;
+
+    //! index of each cluster in the input keys
+    std::vector<unsigned int> m_input_index;
+  };
+
   /// tpc distortion correction utility class
   TpcDistortionCorrection m_distortionCorrection;
 
@@ -224,14 +259,12 @@ class PHCASeeding : public PHTrackSeeding
   std::pair<PositionMap, keyListPerLayer> FillGlobalPositions();
   std::pair<keyLinks, keyLinkPerLayer> CreateBiLinks(const PositionMap& globalPositions, const keyListPerLayer& ckeys);
   PHCASeeding::keyLists FollowBiLinks(const keyLinks& trackSeedPairs, const keyLinkPerLayer& bilinks, const PositionMap& globalPositions) const;
-  std::vector<coordKey> FillTree(bgi::rtree<pointKey, bgi::quadratic<16>>&, const keyList&, const PositionMap&, int layer);
   int FindSeedsWithMerger(const PositionMap&, const keyListPerLayer&);
 
-  void QueryTree(const bgi::rtree<pointKey, bgi::quadratic<16>>& rtree, double phimin, double zmin, double phimax, double zmax, std::vector<pointKey>& returned_values) const;
-  std::vector<TrackSeed_v2> RemoveBadClusters(const std::vector<keyList>& seeds, const PositionMap& globalPositions) const;
+  std::vector<TrackSeed_v3> RemoveBadClusters(const std::vector<keyList>& seeds, const PositionMap& globalPositions) const;
   double getMengerCurvature(TrkrDefs::cluskey a, TrkrDefs::cluskey b, TrkrDefs::cluskey c, const PositionMap& globalPositions) const;
 
-  void publishSeeds(const std::vector<TrackSeed_v2>& seeds) const;
+  void publishSeeds(const std::vector<TrackSeed_v3>& seeds) const;
 
   // int _nlayers_all;
   // unsigned int _nlayers_seeding;
@@ -272,8 +305,16 @@ class PHCASeeding : public PHTrackSeeding
   std::unique_ptr<PHTimer> t_fill;
   std::unique_ptr<PHTimer> t_makebilinks;
   std::unique_ptr<PHTimer> t_makeseeds;
-  /* std::array<bgi::rtree<pointKey, bgi::quadratic<16>>, _NLAYERS_TPC> _rtrees; */
-  std::array<bgi::rtree<pointKey, bgi::quadratic<16>>, 3> _rtrees;  // need three layers at a time
+
+  //! time spent in Process, and number of seeds found, accumulated over the run
+  std::unique_ptr<PHTimer> t_process;
+  uint64_t m_total_seeds = 0;
+
+  //! binned clusters, per TPC layer
+  std::array<LayerGrid, _NLAYERS_TPC> m_layer_grids;
+
+  //! number of threads. 0 uses the OpenMP default
+  int m_num_threads = 1;
 
   double Ne_frac = 0.00;
   double Ar_frac = 0.75;
@@ -9,15 +9,16 @@
 #include <trackbase/TrkrDefs.h>  // for cluskey, getLayer, TrkrId
 
 #include <trackbase_historic/TrackSeed.h>
-#include <trackbase_historic/TrackSeed_v2.h>
+#include <trackbase_historic/TrackSeed_v3.h>
 #include <trackbase_historic/TrackSeedContainer.h>
 #include <trackbase_historic/TrackSeedHelper.h>
 
-#include <cmath>     // for sqrt, fabs, atan2, cos
-#include <iostream>  // for operator<<, basic_ostream
-#include <map>       // for map
-#include <set>       // for _Rb_tree_const_iterator
-#include <utility>   // for pair, make_pair
+#include <omp.h>
+
+#include <algorithm>  // for sort, lower_bound, upper_bound
+#include <cmath>      // for sqrt, fabs, atan2, cos
+#include <iostream>   // for operator<<, basic_ostream
+#include <utility>    // for pair, make_pair
 
 //____________________________________________________________________________..
 bool PHGhostRejection::cut_from_clusters(int itrack) {
@@ -102,54 +103,112 @@ void PHGhostRejection::find_ghosts(const std::vector<float>& trackChi2)
   }
 
   // Elimate low-interest track, and try to eliminate repeated tracks
-  std::set<unsigned int> matches_set;
-  std::multimap<unsigned int, unsigned int> matches;
-  for (size_t trid1 = 0; trid1 < seeds.size(); ++trid1)
+  // seed parameters are computed once, and seeds are sorted by phi so that
+  // the candidate partners of a seed are found by binary search in a phi window
+  const size_t nseeds = seeds.size();
+  m_phi.assign(nseeds, 0);
+  m_eta.assign(nseeds, 0);
+  m_position.assign(nseeds, Acts::Vector3::Zero());
+
+  std::vector<unsigned int> sorted_ids;
+  sorted_ids.reserve(nseeds);
+  for (unsigned int trid = 0; trid < nseeds; ++trid)
+  {
+    if (m_rejected[trid])
+    {
+      continue;
+    }
+    const auto& track = seeds[trid];
+    m_phi[trid] = track.get_phi();
+    m_eta[trid] = track.get_eta();
+    m_position[trid] = TrackSeedHelper::get_xyz(&track);
+
+    // seeds with undefined phi never pass the phi cut
+    if (!std::isnan(m_phi[trid]))
+    {
+      sorted_ids.push_back(trid);
+    }
+  }
+
+  std::sort(sorted_ids.begin(), sorted_ids.end(), [this](unsigned int a, unsigned int b)
+            { return m_phi[a] < m_phi[b]; });
+
+  std::vector<double> sorted_phi;
+  sorted_phi.reserve(sorted_ids.size());
+  for (const auto& trid : sorted_ids)
   {
-    if (m_rejected[trid1]) { continue; }
-    const auto& track1 = seeds[trid1];
-    const float track1phi = track1.get_phi();
+    sorted_phi.push_back(m_phi[trid]);
+  }
+
+  // the window is slightly enlarged to account for the float precision of the phi difference
+  // the exact cuts are applied to every candidate pair
+  static constexpr double margin = 1e-4;
+  const double window = _phi_cut + margin;
 
-    const auto track1_pos = TrackSeedHelper::get_xyz(&track1);
-    const float track1eta = track1.get_eta();
-    for (size_t trid2 = trid1+1; trid2 < seeds.size(); ++trid2)
+  // matching partners of each seed, with higher seed index, in increasing order
+  std::vector<std::vector<unsigned int>> matches(nseeds);
+  const int nthreads = m_num_threads >= 1 ? m_num_threads : omp_get_max_threads();
+
+#pragma omp parallel num_threads(nthreads)
+  {
+    std::vector<unsigned int> candidates;
+    const auto add_candidates = [&](const unsigned int trid1, const double phimin, const double phimax)
     {
-      if (m_rejected[trid2])
+      const auto first = std::lower_bound(sorted_phi.begin(), sorted_phi.end(), phimin);
+      const auto last = std::upper_bound(first, sorted_phi.end(), phimax);
+      for (auto iter = first; iter != last; ++iter)
       {
-        continue;
+        const auto trid2 = sorted_ids[iter - sorted_phi.begin()];
+        if (trid2 > trid1)
+        {
+          candidates.push_back(trid2);
+        }
       }
+    };
 
-      const auto& track2 = seeds[trid2];
-      const auto track2_pos = TrackSeedHelper::get_xyz(&track2);
-      const float track2eta = track2.get_eta();
-      auto delta_phi = std::abs(track1phi - track2.get_phi());
+#pragma omp for schedule(dynamic, 16)
+    for (size_t i = 0; i < sorted_ids.size(); ++i)
+    {
+      const auto trid1 = sorted_ids[i];
+      const double phi1 = m_phi[trid1];
 
-      if (delta_phi > 2 * M_PI) {
-        delta_phi = delta_phi - 2*M_PI;
-      }
-      if (delta_phi < _phi_cut &&
-          std::abs(track1eta - track2eta) < _eta_cut &&
-          std::abs(track1_pos.x() - track2_pos.x()) < _x_cut &&
-          std::abs(track1_pos.y() - track2_pos.y()) < _y_cut &&
-          std::abs(track1_pos.z() - track2_pos.z()) < _z_cut)
-      {
-        matches_set.insert(trid1);
-        matches.insert(std::pair(trid1, trid2));
+      candidates.clear();
+      add_candidates(trid1, phi1 - window, phi1 + window);
 
-        if (m_verbosity > 1)
+      // phi differences larger than 2pi are shifted by 2pi before applying the cut
+      add_candidates(trid1, phi1 + 2 * M_PI - margin, phi1 + 2 * M_PI + window);
+      add_candidates(trid1, phi1 - 2 * M_PI - window, phi1 - 2 * M_PI + margin);
+
+      std::sort(candidates.begin(), candidates.end());
+      candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+      for (const auto& trid2 : candidates)
+      {
+        if (is_match(trid1, trid2))
         {
-          std::cout << "Found match for tracks " << trid1 << " and " << trid2 << std::endl;
+          matches[trid1].push_back(trid2);
         }
       }
     }
   }
 
-  for (auto set_it : matches_set)
+  if (m_verbosity > 1)
+  {
+    for (unsigned int trid1 = 0; trid1 < nseeds; ++trid1)
+    {
+      for (const auto& trid2 : matches[trid1])
+      {
+        std::cout << "Found match for tracks " << trid1 << " and " << trid2 << std::endl;
+      }
+    }
+  }
+
+  for (unsigned int set_it = 0; set_it < nseeds; ++set_it)
   {
+    if (matches[set_it].empty()) { continue; }
     if (m_rejected[set_it]) { continue; } // already rejected
-    auto match_list = matches.equal_range(set_it);
 
-    auto tr1 = seeds[set_it];
+    const auto& tr1 = seeds[set_it];
     double best_qual = trackChi2.at(set_it);
     unsigned int best_track = set_it;
 
@@ -158,14 +217,14 @@ void PHGhostRejection::find_ghosts(const std::vector<float>& trackChi2)
       std::cout << " ****** start checking track " << set_it << " with best quality " << best_qual << " best_track " << best_track << std::endl;
     }
 
-    for (auto it = match_list.first; it != match_list.second; ++it)
+    for (const auto& match : matches[set_it])
     {
       if (m_verbosity > 1)
       {
-        std::cout << "    match of track " << it->first << " to track " << it->second << std::endl;
+        std::cout << "    match of track " << set_it << " to track " << match << std::endl;
       }
 
-      auto tr2 = seeds[it->second];
+      const auto& tr2 = seeds[match];
 
       // Check that these two tracks actually share the same clusters, if not skip this pair
       bool is_same_track = checkClusterSharing(tr1, tr2);
@@ -175,7 +234,7 @@ void PHGhostRejection::find_ghosts(const std::vector<float>& trackChi2)
       }
 
       // which one has the best quality?
-      double tr2_qual = trackChi2.at(it->second);
+      double tr2_qual = trackChi2.at(match);
       if (m_verbosity > 1)
       {
         std::cout << "       Compare: best quality " << best_qual << " track 2 quality " << tr2_qual << std::endl;
@@ -193,21 +252,21 @@ void PHGhostRejection::find_ghosts(const std::vector<float>& trackChi2)
       {
         if (m_verbosity > 1)
         {
-          std::cout << "       --------- Track " << it->second << " has better quality, erase track " << best_track << std::endl;
+          std::cout << "       --------- Track " << match << " has better quality, erase track " << best_track << std::endl;
           std::cout << " rejecting track ID " << ((int)best_track) << "  because it is a ghost " << std::endl;
         }
         m_rejected[best_track] = true;
         best_qual = tr2_qual;
-        best_track = it->second;
+        best_track = match;
       }
       else
       {
         if (m_verbosity > 1)
         {
-          std::cout << "       --------- Track " << best_track << " has better quality, erase track " << it->second << std::endl;
+          std::cout << "       --------- Track " << best_track << " has better quality, erase track " << match << std::endl;
           std::cout << " rejecting track ID " << ((int)best_track) << "  because it is a ghost " << std::endl;
         }
-        m_rejected[it->second] = true;
+        m_rejected[match] = true;
       }
     }
     if (m_verbosity > 1)
@@ -234,6 +293,24 @@ void PHGhostRejection::find_ghosts(const std::vector<float>& trackChi2)
   }
 }
 
+//____________________________________________________________________________..
+bool PHGhostRejection::is_match(unsigned int trid1, unsigned int trid2) const
+{
+  float delta_phi = std::abs(m_phi[trid1] - m_phi[trid2]);
+  if (delta_phi > 2 * M_PI)
+  {
+    delta_phi = delta_phi - 2 * M_PI;
+  }
+
+  const auto& track1_pos = m_position[trid1];
+  const auto& track2_pos = m_position[trid2];
+  return delta_phi < _phi_cut &&
+         std::abs(m_eta[trid1] - m_eta[trid2]) < _eta_cut &&
+         std::abs(track1_pos.x() - track2_pos.x()) < _x_cut &&
+         std::abs(track1_pos.y() - track2_pos.y()) < _y_cut &&
+         std::abs(track1_pos.z() - track2_pos.z()) < _z_cut;
+}
+
 // there is no check, at this point, about which is the best chi2 track
 bool PHGhostRejection::checkClusterSharing(const TrackSeed& tr1, const TrackSeed& tr2) const
 {
@@ -13,7 +13,7 @@
 #include <fun4all/SubsysReco.h>
 #include <trackbase/ActsSurfaceMaps.h>
 #include <trackbase/ActsTrackingGeometry.h>
-#include <trackbase_historic/TrackSeed_v2.h>
+#include <trackbase_historic/TrackSeed_v3.h>
 
 
 #include <map>
@@ -29,7 +29,7 @@ class PHGhostRejection
 {
  public:
   /* PHGhostRejection() {} */
-  PHGhostRejection(unsigned int verbosity, const std::vector<TrackSeed_v2>& _seeds)
+  PHGhostRejection(unsigned int verbosity, const std::vector<TrackSeed_v3>& _seeds)
     : m_verbosity { verbosity }
     , seeds { _seeds }
     , m_rejected { std::vector<bool> (seeds.size(), false) }
@@ -58,9 +58,14 @@ class PHGhostRejection
   void set_y_cut(double d) { _y_cut = d; }
   void set_z_cut(double d) { _z_cut = d; }
 
+  //! number of threads used for the duplicate search, 1 by default. Zero or negative uses the OpenMP default
+  void set_num_threads(int value) { m_num_threads = value; }
+
  private:
+  //! true if two seeds pass the phi, eta and position cuts
+  bool is_match(unsigned int trid1, unsigned int trid2) const;
   unsigned int m_verbosity;
-  const std::vector<TrackSeed_v2>& seeds;
+  const std::vector<TrackSeed_v3>& seeds;
   std::vector<bool> m_rejected {}; // id
   double _phi_cut = std::numeric_limits<double>::max();
   double _eta_cut = std::numeric_limits<double>::max();
@@ -74,6 +79,13 @@ class PHGhostRejection
   bool   _must_span_sectors = false;
   size_t _min_clusters = 3;
 
+  int m_num_threads = 1;
+
+  //! seed parameters used in the duplicate search
+  std::vector<float> m_phi;
+  std::vector<float> m_eta;
+  std::vector<Acts::Vector3> m_position;
+
 
   /* TrackSeedContainer *m_trackMap = nullptr; */
 
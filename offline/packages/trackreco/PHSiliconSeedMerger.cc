@@ -13,6 +13,15 @@
 #include <trackbase_historic/TrackSeed.h>
 #include <trackbase_historic/TrackSeedContainer.h>
 
+#include <omp.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
 /**
  * @brief Construct a PHSiliconSeedMerger with the given subsystem name.
  *
@@ -70,6 +79,11 @@ int PHSiliconSeedMerger::InitRun(PHCompositeNode* topNode)
  * erased from the silicon track container and preserved seeds are updated to
  * include any newly merged MVTX cluster keys.
  *
+ * Candidate pairs are found through a cluster key to seed index: a seed can
+ * only contain all keys of another seed if it contains its smallest key.
+ * Candidates are tested in parallel, and the pairs are then processed in the
+ * same order as a loop over all pairs of seeds.
+ *
  * @return Fun4AllReturnCodes::EVENT_OK on successful processing.
  *
  */
@@ -78,25 +92,35 @@ int PHSiliconSeedMerger::process_event(PHCompositeNode* /*unused*/)
   std::multimap<unsigned int, std::set<TrkrDefs::cluskey>> matches;
   std::set<unsigned int> seedsToDelete;
 
+  const unsigned int nseeds = m_siliconTracks->size();
   if (Verbosity() > 0)
   {
-    std::cout << "Silicon seed track container has " << m_siliconTracks->size() << std::endl;
+    std::cout << "Silicon seed track container has " << nseeds << std::endl;
   }
 
-  for (unsigned int track1ID = 0;
-       track1ID != m_siliconTracks->size();
-       ++track1ID)
+  /// sorted cluster keys and strobe of each seed
+  std::vector<std::vector<TrkrDefs::cluskey>> seedKeys(nseeds);
+  std::vector<int> seedStrobes(nseeds, std::numeric_limits<int>::quiet_NaN());
+  std::vector<bool> validSeeds(nseeds, false);
+
+  /// cluster key to seed index, sorted by key and seed
+  std::vector<std::pair<TrkrDefs::cluskey, unsigned int>> keyToSeed;
+
+  /// seeds without any cluster key are contained in all other seeds
+  std::vector<unsigned int> emptySeeds;
+
+  for (unsigned int trackID = 0; trackID < nseeds; ++trackID)
   {
-    TrackSeed* track1 = m_siliconTracks->get(track1ID);
-    if (seedsToDelete.contains(track1ID))
+    const TrackSeed* track = m_siliconTracks->get(trackID);
+    if (track == nullptr)
     {
       continue;
     }
+    validSeeds[trackID] = true;
 
-    std::set<TrkrDefs::cluskey> mvtx1Keys;
-    int track1Strobe = std::numeric_limits<int>::quiet_NaN();
-    for (auto iter = track1->begin_cluster_keys();
-         iter != track1->end_cluster_keys();
+    auto& keys = seedKeys[trackID];
+    for (auto iter = track->begin_cluster_keys();
+         iter != track->end_cluster_keys();
          ++iter)
     {
       TrkrDefs::cluskey ckey = *iter;
@@ -105,50 +129,106 @@ int PHSiliconSeedMerger::process_event(PHCompositeNode* /*unused*/)
       {
         continue;
       }
-      if (TrkrDefs::getTrkrId(ckey) == TrkrDefs::TrkrId::mvtxId)
+      if (trkrid == TrkrDefs::TrkrId::mvtxId)
       {
-        track1Strobe = MvtxDefs::getStrobeId(ckey);
+        seedStrobes[trackID] = MvtxDefs::getStrobeId(ckey);
       }
-      mvtx1Keys.insert(ckey);
+      keys.push_back(ckey);
     }
 
-    /// We can speed up the code by only iterating over the track seeds
-    /// that are further in the map container from the current track,
-    /// since the comparison of e.g. track 1 with track 2 doesn't need
-    /// to be repeated with track 2 to track 1.
-    for (unsigned int track2ID = track1ID;
-         track2ID != m_siliconTracks->size();
-         ++track2ID)
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    if (keys.empty())
     {
-      if (track1ID == track2ID)
-      {
-        continue;
-      }
-      TrackSeed* track2 = m_siliconTracks->get(track2ID);
-      if (track2 == nullptr)
+      emptySeeds.push_back(trackID);
+    }
+
+    for (const auto& key : keys)
+    {
+      keyToSeed.emplace_back(key, trackID);
+    }
+  }
+  std::sort(keyToSeed.begin(), keyToSeed.end());
+
+  /// pairs of seeds for which the keys of one seed are all included in the other,
+  /// stored as (lower index, higher index)
+  std::vector<std::pair<unsigned int, unsigned int>> duplicates;
+  const int nthreads = m_num_threads >= 1 ? m_num_threads : omp_get_max_threads();
+
+#pragma omp parallel num_threads(nthreads)
+  {
+    std::vector<std::pair<unsigned int, unsigned int>> localDuplicates;
+
+#pragma omp for schedule(dynamic, 16)
+    for (unsigned int track1ID = 0; track1ID < nseeds; ++track1ID)
+    {
+      const auto& keys1 = seedKeys[track1ID];
+      if (keys1.empty())
       {
         continue;
       }
-      int track2Strobe = std::numeric_limits<int>::quiet_NaN();
 
-      std::set<TrkrDefs::cluskey> mvtx2Keys;
-      for (TrackSeed::ConstClusterKeyIter iter = track2->begin_cluster_keys();
-           iter != track2->end_cluster_keys();
-           ++iter)
+      /// only seeds containing the smallest key of this seed can contain all its keys
+      const auto first = std::lower_bound(keyToSeed.begin(), keyToSeed.end(), std::make_pair(keys1.front(), 0U));
+      const auto last = std::upper_bound(first, keyToSeed.end(), std::make_pair(keys1.front(), std::numeric_limits<unsigned int>::max()));
+      for (auto iter = first; iter != last; ++iter)
       {
-        TrkrDefs::cluskey ckey = *iter;
-        auto trkrid = TrkrDefs::getTrkrId(ckey);
-        if (m_mvtxOnly && trkrid == TrkrDefs::TrkrId::inttId)
+        const unsigned int track2ID = iter->second;
+        if (track2ID == track1ID)
         {
           continue;
         }
-        mvtx2Keys.insert(ckey);
-        if (TrkrDefs::getTrkrId(ckey) == TrkrDefs::TrkrId::mvtxId)
+
+        const auto& keys2 = seedKeys[track2ID];
+        if (std::includes(keys2.begin(), keys2.end(), keys1.begin(), keys1.end()))
         {
-          track2Strobe = MvtxDefs::getStrobeId(ckey);
+          localDuplicates.emplace_back(std::min(track1ID, track2ID), std::max(track1ID, track2ID));
         }
       }
+    }
+
+#pragma omp critical
+    duplicates.insert(duplicates.end(), localDuplicates.begin(), localDuplicates.end());
+  }
+
+  for (const auto& track1ID : emptySeeds)
+  {
+    for (unsigned int track2ID = 0; track2ID < nseeds; ++track2ID)
+    {
+      if (track2ID != track1ID && validSeeds[track2ID])
+      {
+        duplicates.emplace_back(std::min(track1ID, track2ID), std::max(track1ID, track2ID));
+      }
+    }
+  }
+
+  /// identical key sets are found from both seeds
+  std::sort(duplicates.begin(), duplicates.end());
+  duplicates.erase(std::unique(duplicates.begin(), duplicates.end()), duplicates.end());
+
+  /// a seed already marked for deletion when its turn comes is not compared to the following seeds
+  unsigned int currentTrack1ID = nseeds;
+  bool skipTrack1 = false;
+  for (const auto& [track1ID, track2ID] : duplicates)
+  {
+    if (track1ID != currentTrack1ID)
+    {
+      currentTrack1ID = track1ID;
+      skipTrack1 = seedsToDelete.contains(track1ID);
+    }
+    if (skipTrack1)
+    {
+      continue;
+    }
 
+    const auto& mvtx1Keys = seedKeys[track1ID];
+    const auto& mvtx2Keys = seedKeys[track2ID];
+    const int track1Strobe = seedStrobes[track1ID];
+    const int track2Strobe = seedStrobes[track2ID];
+
+    /// one of the tracks is completely duplicated
+    if (Verbosity() > 2)
+    {
       std::vector<TrkrDefs::cluskey> intersection;
       std::set_intersection(mvtx1Keys.begin(),
                             mvtx1Keys.end(),
@@ -156,58 +236,51 @@ int PHSiliconSeedMerger::process_event(PHCompositeNode* /*unused*/)
                             mvtx2Keys.end(),
                             std::back_inserter(intersection));
 
-      /// If the intersection fully encompasses one of the tracks, it is completely duplicated
-      if (intersection.size() == mvtx1Keys.size() || intersection.size() == mvtx2Keys.size())
+      std::cout << "Track " << track1ID << " keys " << std::endl;
+      for (const auto& key : mvtx1Keys)
       {
-        if (Verbosity() > 2)
-        {
-          std::cout << "Track " << track1ID << " keys " << std::endl;
-          for (const auto& key : mvtx1Keys)
-          {
-            std::cout << "   ckey: " << key << std::endl;
-          }
-          std::cout << "Track " << track2ID << " keys " << std::endl;
-          for (const auto& key : mvtx2Keys)
-          {
-            std::cout << "   ckey: " << key << std::endl;
-          }
-          std::cout << "Intersection keys " << std::endl;
-          for (auto& key : intersection)
-          {
-            std::cout << "   ckey: " << key << std::endl;
-          }
-        }
+        std::cout << "   ckey: " << key << std::endl;
+      }
+      std::cout << "Track " << track2ID << " keys " << std::endl;
+      for (const auto& key : mvtx2Keys)
+      {
+        std::cout << "   ckey: " << key << std::endl;
+      }
+      std::cout << "Intersection keys " << std::endl;
+      for (auto& key : intersection)
+      {
+        std::cout << "   ckey: " << key << std::endl;
+      }
+    }
 
-        /// one of the tracks is encompassed in the other. Take the larger one
-        std::set<TrkrDefs::cluskey> keysToKeep;
-        if (mvtx1Keys.size() >= mvtx2Keys.size())
-        {
-          keysToKeep = mvtx1Keys;
-          if (track1Strobe == track2Strobe && m_mergeSeeds)
-          {
-            keysToKeep.insert(mvtx2Keys.begin(), mvtx2Keys.end());
-          }
-          matches.insert(std::make_pair(track1ID, keysToKeep));
-          seedsToDelete.insert(track2ID);
-          if (Verbosity() > 2)
-          {
-            std::cout << "     will delete seed " << track2ID << std::endl;
-          }
-        }
-        else
-        {
-          keysToKeep = mvtx2Keys;
-          if (track1Strobe == track2Strobe && m_mergeSeeds)
-          {
-            keysToKeep.insert(mvtx1Keys.begin(), mvtx1Keys.end());
-          }
-          matches.insert(std::make_pair(track2ID, keysToKeep));
-          seedsToDelete.insert(track1ID);
-          if (Verbosity() > 2)
-          {
-            std::cout << "     will delete seed " << track1ID << std::endl;
-          }
-        }
+    /// one of the tracks is encompassed in the other. Take the larger one
+    std::set<TrkrDefs::cluskey> keysToKeep;
+    if (mvtx1Keys.size() >= mvtx2Keys.size())
+    {
+      keysToKeep.insert(mvtx1Keys.begin(), mvtx1Keys.end());
+      if (track1Strobe == track2Strobe && m_mergeSeeds)
+      {
+        keysToKeep.insert(mvtx2Keys.begin(), mvtx2Keys.end());
+      }
+      matches.insert(std::make_pair(track1ID, keysToKeep));
+      seedsToDelete.insert(track2ID);
+      if (Verbosity() > 2)
+      {
+        std::cout << "     will delete seed " << track2ID << std::endl;
+      }
+    }
+    else
+    {
+      keysToKeep.insert(mvtx2Keys.begin(), mvtx2Keys.end());
+      if (track1Strobe == track2Strobe && m_mergeSeeds)
+      {
+        keysToKeep.insert(mvtx1Keys.begin(), mvtx1Keys.end());
+      }
+      matches.insert(std::make_pair(track2ID, keysToKeep));
+      seedsToDelete.insert(track1ID);
+      if (Verbosity() > 2)
+      {
+        std::cout << "     will delete seed " << track1ID << std::endl;
       }
     }
   }
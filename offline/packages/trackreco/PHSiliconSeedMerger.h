@@ -48,6 +48,11 @@ class PHSiliconSeedMerger : public SubsysReco
    * When enabled, the module will merge overlapping silicon seed tracks where applicable.
    */
   void mergeSeeds() { m_mergeSeeds = true; }
+  /**
+   * Set the number of threads used to find duplicate seed candidates.
+   * 1 by default, zero or negative uses the OpenMP default.
+   */
+  void set_num_threads(int value) { m_num_threads = value; }
 
  private:
   int getNodes(PHCompositeNode *topNode);
@@ -71,6 +76,8 @@ class PHSiliconSeedMerger : public SubsysReco
    * When `false`, clusters from other silicon detectors are included.
    */
   bool m_mvtxOnly{false};
+
+  int m_num_threads{1};
 };
 
 #endif  // PHSILICONSEEDMERGER_H
@@ -24,6 +24,7 @@
 #include <fun4all/Fun4AllReturnCodes.h>
 
 #include <phool/PHCompositeNode.h>
+#include <phool/PHTimer.h>
 #include <phool/getClass.h>
 #include <phool/phool.h>
 #include <phool/sphenix_constants.h>
@@ -32,15 +33,122 @@
 #include <TFile.h>
 #include <TNtuple.h>
 
+#include <omp.h>
+
+#include <algorithm>
 #include <climits>   // for UINT_MAX
 #include <cmath>     // for fabs, sqrt
 #include <iostream>  // for operator<<, basic_ostream
+#include <limits>
 #include <memory>
+#include <numeric>  // for partial_sum
 #include <set>      // for _Rb_tree_const_iterator
 #include <utility>  // for pair
+#include <vector>
 
 using namespace std;
 
+namespace
+{
+  // seeds binned in eta and phi, with the seed ids of each bin stored contiguously
+  class EtaPhiGrid
+  {
+   public:
+    // bin the given seeds, ids must be in increasing order
+    template <class Projection>
+    void fill(const std::vector<unsigned int>& ids, const std::vector<Projection>& projections)
+    {
+      m_ids.clear();
+      m_offsets.clear();
+      if (ids.empty())
+      {
+        return;
+      }
+
+      m_etamin = m_etamax = projections[ids.front()].eta;
+      m_phimin = m_phimax = projections[ids.front()].phi;
+      for (const auto& id : ids)
+      {
+        m_etamin = std::min(m_etamin, projections[id].eta);
+        m_etamax = std::max(m_etamax, projections[id].eta);
+        m_phimin = std::min(m_phimin, projections[id].phi);
+        m_phimax = std::max(m_phimax, projections[id].phi);
+      }
+
+      // about two seeds per bin
+      const int nbins = std::clamp(static_cast<int>(std::sqrt(ids.size() / 2.)), 1, 256);
+      m_neta = nbins;
+      m_nphi = nbins;
+      m_eta_width = m_etamax > m_etamin ? (m_etamax - m_etamin) / m_neta : 1.;
+      m_phi_width = m_phimax > m_phimin ? (m_phimax - m_phimin) / m_nphi : 1.;
+
+      // counting sort, which keeps the ids of each bin in increasing order
+      std::vector<int> bins;
+      bins.reserve(ids.size());
+      m_offsets.assign(m_neta * m_nphi + 1, 0);
+      for (const auto& id : ids)
+      {
+        const int bin = eta_bin(projections[id].eta) * m_nphi + phi_bin(projections[id].phi);
+        bins.push_back(bin);
+        ++m_offsets[bin + 1];
+      }
+      std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+
+      m_ids.resize(ids.size());
+      auto position = m_offsets;
+      for (size_t i = 0; i < ids.size(); ++i)
+      {
+        m_ids[position[bins[i]]++] = ids[i];
+      }
+    }
+
+    // append ids of seeds in all bins overlapping the given window
+    void query(double etamin, double etamax, double phimin, double phimax, std::vector<unsigned int>& ids) const
+    {
+      if (m_ids.empty() ||
+          etamax < m_etamin || etamin > m_etamax ||
+          phimax < m_phimin || phimin > m_phimax)
+      {
+        return;
+      }
+
+      const int ieta_max = eta_bin(etamax);
+      const int iphi_min = phi_bin(phimin);
+      const int iphi_max = phi_bin(phimax);
+      for (int ieta = eta_bin(etamin); ieta <= ieta_max; ++ieta)
+      {
+        const auto first = m_ids.begin() + m_offsets[ieta * m_nphi + iphi_min];
+        const auto last = m_ids.begin() + m_offsets[ieta * m_nphi + iphi_max + 1];
+        ids.insert(ids.end(), first, last);
+      }
+    }
+
+   private:
+    int eta_bin(double eta) const
+    {
+      return static_cast<int>(std::clamp(std::floor((eta - m_etamin) / m_eta_width), 0., m_neta - 1.));
+    }
+
+    int phi_bin(double phi) const
+    {
+      return static_cast<int>(std::clamp(std::floor((phi - m_phimin) / m_phi_width), 0., m_nphi - 1.));
+    }
+
+    double m_etamin = 0;
+    double m_etamax = 0;
+    double m_phimin = 0;
+    double m_phimax = 0;
+    double m_eta_width = 1;
+    double m_phi_width = 1;
+    int m_neta = 1;
+    int m_nphi = 1;
+
+    std::vector<unsigned int> m_ids;
+    std::vector<size_t> m_offsets;
+  };
+}  // namespace
+
+
 //____________________________________________________________________________..
 PHSiliconTpcTrackMatching::PHSiliconTpcTrackMatching(const std::string &name)
   : SubsysReco(name)
@@ -153,7 +261,7 @@ void PHSiliconTpcTrackMatching::WindowMatcher::init_bools(const std::string& tag
 }
 
 bool PHSiliconTpcTrackMatching::WindowMatcher::in_window
-(const bool posQ, const double tpc_pt, const double tpc_X, const double si_X)
+(const bool posQ, const double tpc_pt, const double tpc_X, const double si_X) const
 {
   const auto delta = tpc_X-si_X;
   
@@ -176,6 +284,19 @@ bool PHSiliconTpcTrackMatching::WindowMatcher::in_window
   }
 }
 
+double PHSiliconTpcTrackMatching::WindowMatcher::max_abs(const bool posQ, const double tpc_pt) const
+{
+  if (posQ) {
+    double pt = (tpc_pt<min_pt_posQ) ? min_pt_posQ : tpc_pt;
+    const auto hi = fn_exp(posHi, posHi_b0, pt);
+    return fabs_max_posQ ? hi : std::max(fabs(fn_exp(posLo, posLo_b0, pt)), fabs(hi));
+  } else {
+    double pt = (tpc_pt<min_pt_negQ) ? min_pt_negQ : tpc_pt;
+    const auto hi = fn_exp(negHi, negHi_b0, pt);
+    return fabs_max_negQ ? hi : std::max(fabs(fn_exp(negLo, negLo_b0, pt)), fabs(hi));
+  }
+}
+
 //____________________________________________________________________________..
 int PHSiliconTpcTrackMatching::process_event(PHCompositeNode * /*unused*/)
 {
@@ -205,7 +326,16 @@ int PHSiliconTpcTrackMatching::process_event(PHCompositeNode * /*unused*/)
   std::multimap<unsigned int, unsigned int> tpc_matches;
   std::set<unsigned int> tpc_matched_set;
   std::set<unsigned int> tpc_unmatched_set;
+  PHTimer timer("MatchingTimer");
+  timer.restart();
   findEtaPhiMatches(tpc_matched_set, tpc_unmatched_set, tpc_matches);
+  m_matching_time += timer.elapsed();
+  m_matching_tpc_seeds += _track_map->size();
+  if (Verbosity() > 0)
+  {
+    cout << PHWHERE << " eta/phi matching: " << timer.elapsed() << " ms for " << _track_map->size()
+         << " TPC and " << _track_map_silicon->size() << " silicon seeds" << endl;
+  }
 
   // check z matching for all matches of tpc and si
   // for _pp_mode=false, assume zero crossings for all tracks
@@ -367,6 +497,12 @@ double PHSiliconTpcTrackMatching::getBunchCrossing(unsigned int trid, double z_m
 
 int PHSiliconTpcTrackMatching::End(PHCompositeNode * /*unused*/)
 {
+  if (Verbosity() > 0)
+  {
+    std::cout << "PHSiliconTpcTrackMatching::End - eta/phi matching: " << m_matching_time << " ms for "
+              << m_matching_tpc_seeds << " TPC seeds in " << m_event << " events" << std::endl;
+  }
+
   if(_test_windows)
   {
   _file->cd();
@@ -451,225 +587,284 @@ int PHSiliconTpcTrackMatching::GetNodes(PHCompositeNode *topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+bool PHSiliconTpcTrackMatching::isEtaPhiMatch(const SeedProjection &tpc, const SeedProjection &si) const
+{
+  const bool is_posQ = (tpc.q>0.);
+
+  bool eta_match = false;
+  if (window_deta.in_window(is_posQ, tpc.pt, tpc.eta, si.eta))
+  {
+    eta_match = true;
+  }
+  else if (fabs(tpc.eta-si.eta) < _deltaeta_min)
+  {
+    eta_match = true;
+  }
+  if (!eta_match)
+  {
+    return false;
+  }
+
+  if (!window_dx.in_window(is_posQ, tpc.pt, tpc.pos.x(), si.pos.x())
+   || !window_dy.in_window(is_posQ, tpc.pt, tpc.pos.y(), si.pos.y()))
+  {
+    return false;
+  }
+
+  if (window_dphi.in_window(is_posQ, tpc.pt, tpc.phi, si.phi))
+  {
+    return true;
+  }
+
+  // if phi fails, account for case where |tpc_phi-si_phi|>PI
+  if (fabs(tpc.phi-si.phi)>M_PI) {
+    auto tpc_phi_wrap = tpc.phi;
+    if ((tpc_phi_wrap - si.phi) > M_PI) {
+      tpc_phi_wrap -= 2*M_PI;
+    } else {
+      tpc_phi_wrap += 2*M_PI;
+    }
+    return window_dphi.in_window(is_posQ, tpc.pt, tpc_phi_wrap, si.phi);
+  }
+  return false;
+}
+
 void PHSiliconTpcTrackMatching::findEtaPhiMatches(
     std::set<unsigned int> &tpc_matched_set,
     std::set<unsigned int> &tpc_unmatched_set,
     std::multimap<unsigned int, unsigned int> &tpc_matches)
 {
-  // loop over the TPC track seeds
-  for (unsigned int phtrk_iter = 0;
-       phtrk_iter < _track_map->size();
-       ++phtrk_iter)
+  // the track parameters of all seeds are computed once
+  // in zero field they come from a straight line fit to the seed clusters
+  const auto get_projection = [this](TrackSeed *tracklet, const bool is_tpc)
   {
-    _tracklet_tpc = _track_map->get(phtrk_iter);
-    if (!_tracklet_tpc)
-    {
-      continue;
-    }
-
-    unsigned int tpcid = phtrk_iter;
-    if (Verbosity() > 1)
-    {
-      std::cout
-          << __LINE__
-          << ": Processing seed itrack: " << tpcid
-          << ": nhits: " << _tracklet_tpc->size_cluster_keys()
-          << ": Total tracks: " << _track_map->size()
-          << ": phi: " << _tracklet_tpc->get_phi()
-          << endl;
-    }
-
-    double tpc_phi;
-    double tpc_eta;
-    double tpc_pt;
-    float tpc_px;
-    float tpc_py;
-    float tpc_pz;
-    int tpc_q;
-    short int tpc_crossing = -999;
-    Acts::Vector3 tpc_pos;
+    SeedProjection proj;
     if (_zero_field) {
-      auto cluster_list = getTrackletClusterList(_tracklet_tpc);
+      auto cluster_list = getTrackletClusterList(tracklet);
 
       Acts::Vector3  mom;
       bool ok_track;
 
-      std::tie(ok_track, tpc_phi, tpc_eta, tpc_pt, tpc_pos, mom) =
+      std::tie(ok_track, proj.phi, proj.eta, proj.pt, proj.pos, mom) =
         TrackFitUtils::zero_field_track_params(_tGeometry, _cluster_map, cluster_list);
-      if (!ok_track) { continue; }
-      tpc_px = mom.x();
-      tpc_py = mom.y();
-      tpc_pz = mom.z();
-      tpc_q = -100;
+      if (!ok_track) { return proj; }
+      proj.px = mom.x();
+      proj.py = mom.y();
+      proj.pz = mom.z();
+      proj.q = -100;
+      if (!is_tpc) { proj.crossing = tracklet->get_crossing(); }
     } else {
-      tpc_phi = _tracklet_tpc->get_phi();
-      tpc_eta = _tracklet_tpc->get_eta();
-      tpc_pt = fabs(1. / _tracklet_tpc->get_qOverR()) * (0.3 / 100.) * fieldstrength;
+      proj.phi = tracklet->get_phi();
+      proj.eta = tracklet->get_eta();
+      if (is_tpc) { proj.pt = fabs(1. / tracklet->get_qOverR()) * (0.3 / 100.) * fieldstrength; }
 
-      tpc_crossing = _tracklet_tpc->get_crossing();
+      proj.crossing = tracklet->get_crossing();
 
-      tpc_pos = TrackSeedHelper::get_xyz(_tracklet_tpc);
+      proj.pos = TrackSeedHelper::get_xyz(tracklet);
 
-      tpc_px = _tracklet_tpc->get_px();
-      tpc_py = _tracklet_tpc->get_py();
-      tpc_pz = _tracklet_tpc->get_pz();
+      proj.px = tracklet->get_px();
+      proj.py = tracklet->get_py();
+      proj.pz = tracklet->get_pz();
 
-      tpc_q = _tracklet_tpc->get_charge();
+      proj.q = tracklet->get_charge();
     }
+    proj.valid = true;
+    return proj;
+  };
 
-    bool is_posQ = (tpc_q>0.);
-
-    if (Verbosity() > 8)
+  const unsigned int ntpc = _track_map->size();
+  std::vector<SeedProjection> tpc_projections(ntpc);
+  for (unsigned int phtrk_iter = 0; phtrk_iter < ntpc; ++phtrk_iter)
+  {
+    _tracklet_tpc = _track_map->get(phtrk_iter);
+    if (_tracklet_tpc)
     {
-      std::cout << " tpc stub: " << tpcid << " tpc crossing " << tpc_crossing << " eta " << tpc_eta << " phi " << tpc_phi << " pt " << tpc_pt << " tpc z " << TrackSeedHelper::get_z(_tracklet_tpc) << std::endl;
+      tpc_projections[phtrk_iter] = get_projection(_tracklet_tpc, true);
     }
+  }
 
-    if (Verbosity() > 3)
+  const unsigned int nsi = _track_map_silicon->size();
+  std::vector<SeedProjection> si_projections(nsi);
+  for (unsigned int phtrk_iter_si = 0; phtrk_iter_si < nsi; ++phtrk_iter_si)
+  {
+    _tracklet_si = _track_map_silicon->get(phtrk_iter_si);
+    if (_tracklet_si)
     {
-      cout << "TPC tracklet:" << endl;
-      _tracklet_tpc->identify();
+      si_projections[phtrk_iter_si] = get_projection(_tracklet_si, false);
     }
+  }
 
-
-    bool matched = false;
-
-    // Now search the silicon track list for a match in eta and phi
-    for (unsigned int phtrk_iter_si = 0;
-         phtrk_iter_si < _track_map_silicon->size();
-         ++phtrk_iter_si)
+  // silicon seeds binned in eta and phi
+  // seeds with undefined eta or phi never pass the matching windows
+  std::vector<unsigned int> si_ids;
+  si_ids.reserve(nsi);
+  for (unsigned int siid = 0; siid < nsi; ++siid)
+  {
+    const auto& si = si_projections[siid];
+    if (si.valid && !std::isnan(si.eta) && !std::isnan(si.phi))
     {
-      _tracklet_si = _track_map_silicon->get(phtrk_iter_si);
-      if (!_tracklet_si)
-      {
-
-        continue;
-      }
-
-      double si_phi;
-      double si_eta;
-      double si_pt;
-      float si_px;
-      float si_py;
-      float si_pz;
-      int si_q;
-      Acts::Vector3 si_pos;
-      if (_zero_field) {
-      auto cluster_list = getTrackletClusterList(_tracklet_si);
+      si_ids.push_back(siid);
+    }
+  }
+  EtaPhiGrid grid;
+  grid.fill(si_ids, si_projections);
 
-      Acts::Vector3  mom;
-      bool ok_track;
+  // matching silicon seeds of each TPC seed, in increasing order
+  std::vector<std::vector<unsigned int>> si_matches(ntpc);
 
-      std::tie(ok_track, si_phi, si_eta, si_pt, si_pos, mom) =
-        TrackFitUtils::zero_field_track_params(_tGeometry, _cluster_map, cluster_list);
-      if (!ok_track) { continue; }
-        si_px = mom.x();
-        si_py = mom.y();
-        si_pz = mom.z();
-        si_q = -100;
-      } else {
-        si_eta = _tracklet_si->get_eta();
-        si_phi = _tracklet_si->get_phi();
-
-        si_pos = TrackSeedHelper::get_xyz(_tracklet_si);
-        si_px = _tracklet_si->get_px();
-        si_py = _tracklet_si->get_py();
-        si_pz = _tracklet_si->get_pz();
-        si_q = _tracklet_si->get_charge();
-      }
-      int si_crossing = _tracklet_si->get_crossing();
-      unsigned int siid = phtrk_iter_si;
+  // the test ntuple is filled for all pairs, in the original order
+  const int nthreads = _test_windows ? 1 : (m_num_threads >= 1 ? m_num_threads : omp_get_max_threads());
 
-      if(_test_windows)
-      {
-        float data[] = {
-          (float) m_event, (float) si_crossing,
-          (float) si_q, (float) si_phi, (float) si_eta, (float) si_pos.x(), (float) si_pos.y(), (float) si_pos.z(), si_px, si_py, si_pz,
-          (float) tpc_q, (float) tpc_phi, (float) tpc_eta, (float) tpc_pos.x(), (float) tpc_pos.y(), (float) tpc_pos.z(), tpc_px, tpc_py, tpc_pz,
-          (float) tpcid, (float) siid
-	};
-        _tree->Fill(data);
-      }
+#pragma omp parallel num_threads(nthreads)
+  {
+    std::vector<unsigned int> candidates;
 
-      bool eta_match = false;
-      if (window_deta.in_window(is_posQ, tpc_pt, tpc_eta, si_eta))
-      {
-        eta_match = true;
-      }
-      else if (fabs(tpc_eta-si_eta) < _deltaeta_min)
-      {
-	eta_match = true;
-      }
-      if (!eta_match)
+#pragma omp for schedule(dynamic, 16)
+    for (unsigned int tpcid = 0; tpcid < ntpc; ++tpcid)
+    {
+      const auto& tpc = tpc_projections[tpcid];
+      if (!tpc.valid)
       {
         continue;
       }
 
-      bool position_match = false;
-      if (window_dx.in_window(is_posQ, tpc_pt, tpc_pos.x(), si_pos.x())
-       && window_dy.in_window(is_posQ, tpc_pt, tpc_pos.y(), si_pos.y()))
+      candidates.clear();
+      if (_test_windows)
       {
-        position_match = true;
+        for (unsigned int siid = 0; siid < nsi; ++siid)
+        {
+          if (si_projections[siid].valid)
+          {
+            candidates.push_back(siid);
+          }
+        }
       }
-      if (!position_match)
+      else if (!std::isnan(tpc.eta) && !std::isnan(tpc.phi))
       {
-        continue;
+        // search windows are enlarged by a small margin to account for rounding
+        // the exact windows are applied to all candidates
+        static constexpr double margin = 1e-6;
+        const bool is_posQ = (tpc.q>0.);
+        const double eta_win = std::max(window_deta.max_abs(is_posQ, tpc.pt), static_cast<double>(_deltaeta_min)) + margin;
+        const double phi_win = window_dphi.max_abs(is_posQ, tpc.pt) + margin;
+
+        // undefined windows select all seeds in the corresponding direction
+        const double etamin = std::isfinite(eta_win) ? tpc.eta - eta_win : -std::numeric_limits<double>::max();
+        const double etamax = std::isfinite(eta_win) ? tpc.eta + eta_win : std::numeric_limits<double>::max();
+        if (std::isfinite(phi_win))
+        {
+          // also look for silicon seeds across the 2pi boundary
+          for (const double phi : {tpc.phi, tpc.phi - 2 * M_PI, tpc.phi + 2 * M_PI})
+          {
+            grid.query(etamin, etamax, phi - phi_win, phi + phi_win, candidates);
+          }
+        }
+        else
+        {
+          grid.query(etamin, etamax, -std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), candidates);
+        }
+
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
       }
 
-      bool phi_match = false;
-      if (window_dphi.in_window(is_posQ, tpc_pt, tpc_phi, si_phi))
+      for (const auto& siid : candidates)
       {
-        phi_match = true;
-        // if phi fails, account for case where |tpc_phi-si_phi|>PI
-      } else if (fabs(tpc_phi-si_phi)>M_PI) {
-        auto tpc_phi_wrap = tpc_phi;
-        if ((tpc_phi_wrap - si_phi) > M_PI) {
-          tpc_phi_wrap -= 2*M_PI;
-        } else {
-          tpc_phi_wrap += 2*M_PI;
+        const auto& si = si_projections[siid];
+        if(_test_windows)
+        {
+          float data[] = {
+            (float) m_event, (float) si.crossing,
+            (float) si.q, (float) si.phi, (float) si.eta, (float) si.pos.x(), (float) si.pos.y(), (float) si.pos.z(), si.px, si.py, si.pz,
+            (float) tpc.q, (float) tpc.phi, (float) tpc.eta, (float) tpc.pos.x(), (float) tpc.pos.y(), (float) tpc.pos.z(), tpc.px, tpc.py, tpc.pz,
+            (float) tpcid, (float) siid
+          };
+          _tree->Fill(data);
+        }
+
+        if (isEtaPhiMatch(tpc, si))
+        {
+          si_matches[tpcid].push_back(siid);
         }
-        phi_match = window_dphi.in_window(is_posQ, tpc_pt, tpc_phi_wrap, si_phi);
-      }
-      if (!phi_match)
-      {
-        continue;
       }
+    }
+  }
+
+  // store matches
+  for (unsigned int tpcid = 0; tpcid < ntpc; ++tpcid)
+  {
+    auto *tracklet_tpc = _track_map->get(tpcid);
+    if (!tracklet_tpc)
+    {
+      continue;
+    }
 
+    const auto& tpc = tpc_projections[tpcid];
+    if (Verbosity() > 1)
+    {
+      std::cout
+          << __LINE__
+          << ": Processing seed itrack: " << tpcid
+          << ": nhits: " << tracklet_tpc->size_cluster_keys()
+          << ": Total tracks: " << ntpc
+          << ": phi: " << tracklet_tpc->get_phi()
+          << endl;
+    }
+
+    if (!tpc.valid)
+    {
+      continue;
+    }
+
+    if (Verbosity() > 8)
+    {
+      std::cout << " tpc stub: " << tpcid << " tpc crossing " << tpc.crossing << " eta " << tpc.eta << " phi " << tpc.phi << " pt " << tpc.pt << " tpc z " << TrackSeedHelper::get_z(tracklet_tpc) << std::endl;
+    }
+
+    if (Verbosity() > 3)
+    {
+      cout << "TPC tracklet:" << endl;
+      tracklet_tpc->identify();
+    }
+
+    for (const auto& siid : si_matches[tpcid])
+    {
+      const auto& si = si_projections[siid];
       if (Verbosity() > 3)
       {
-        cout << " testing for a match for TPC track " << tpcid << " with pT " << _tracklet_tpc->get_pt()
-             << " and eta " << _tracklet_tpc->get_eta() << " with Si track " << siid << " with crossing " << _tracklet_si->get_crossing() << endl;
-        cout << " tpc_phi " << tpc_phi << " si_phi " << si_phi << " dphi " << tpc_phi - si_phi << " phi search " << _phi_search_win << " tpc_eta " << tpc_eta
-             << " si_eta " << si_eta << " deta " << tpc_eta - si_eta << " eta search " << _eta_search_win  << endl;
-        std::cout << "      tpc x " << tpc_pos.x() << " si x " << si_pos.x() << " tpc y " << tpc_pos.y() << " si y " << si_pos.y() << " tpc_z " << tpc_pos.z() << " si z " << si_pos.z() << std::endl;
+        cout << " testing for a match for TPC track " << tpcid << " with pT " << tracklet_tpc->get_pt()
+             << " and eta " << tracklet_tpc->get_eta() << " with Si track " << siid << " with crossing " << _track_map_silicon->get(siid)->get_crossing() << endl;
+        cout << " tpc_phi " << tpc.phi << " si_phi " << si.phi << " dphi " << tpc.phi - si.phi << " phi search " << _phi_search_win << " tpc_eta " << tpc.eta
+             << " si_eta " << si.eta << " deta " << tpc.eta - si.eta << " eta search " << _eta_search_win  << endl;
+        std::cout << "      tpc x " << tpc.pos.x() << " si x " << si.pos.x() << " tpc y " << tpc.pos.y() << " si y " << si.pos.y() << " tpc_z " << tpc.pos.z() << " si z " << si.pos.z() << std::endl;
         std::cout << "      x search " << _x_search_win  << " y search " << _y_search_win << " z search " << _z_search_win << std::endl;
       }
 
       // got a match, add to the list
       // These stubs are matched in eta, phi, x and y already
-      matched = true;
       tpc_matches.insert(std::make_pair(tpcid, siid));
       tpc_matched_set.insert(tpcid);
 
       if (Verbosity() > 1)
       {
         cout << " found a match for TPC track " << tpcid << " with Si track " << siid << endl;
-        cout << "          tpc_phi " << tpc_phi << " si_phi " << si_phi << " phi_match " << phi_match
-             << " tpc_eta " << tpc_eta << " si_eta " << si_eta << " eta_match " << eta_match << endl;
-        std::cout << "      tpc x " << tpc_pos.x() << " si x " << si_pos.x() << " tpc y " << tpc_pos.y() << " si y " << si_pos.y() << " tpc_z " << tpc_pos.z() << " si z " << si_pos.z() << std::endl;
+        cout << "          tpc_phi " << tpc.phi << " si_phi " << si.phi << " phi_match " << true
+             << " tpc_eta " << tpc.eta << " si_eta " << si.eta << " eta_match " << true << endl;
+        std::cout << "      tpc x " << tpc.pos.x() << " si x " << si.pos.x() << " tpc y " << tpc.pos.y() << " si y " << si.pos.y() << " tpc_z " << tpc.pos.z() << " si z " << si.pos.z() << std::endl;
       }
 
       // temporary!
       if (_test_windows && Verbosity() > 1)
       {
-        cout << " Try_silicon: crossing" << si_crossing <<  "  pt " << tpc_pt << " tpc_phi " << tpc_phi << " si_phi " << si_phi << " dphi " << tpc_phi - si_phi <<  "   si_q" << si_q << "   tpc_q" << tpc_q
-             << " tpc_eta " << tpc_eta << " si_eta " << si_eta << " deta " << tpc_eta - si_eta << " tpc_x " << tpc_pos.x() << " tpc_y " << tpc_pos.y() << " tpc_z " << tpc_pos.z()
-             << " dx " << tpc_pos.x() - si_pos.x() << " dy " << tpc_pos.y() - si_pos.y() << " dz " << tpc_pos.z() - si_pos.z()
+        cout << " Try_silicon: crossing" << si.crossing <<  "  pt " << tpc.pt << " tpc_phi " << tpc.phi << " si_phi " << si.phi << " dphi " << tpc.phi - si.phi <<  "   si_q" << si.q << "   tpc_q" << tpc.q
+             << " tpc_eta " << tpc.eta << " si_eta " << si.eta << " deta " << tpc.eta - si.eta << " tpc_x " << tpc.pos.x() << " tpc_y " << tpc.pos.y() << " tpc_z " << tpc.pos.z()
+             << " dx " << tpc.pos.x() - si.pos.x() << " dy " << tpc.pos.y() - si.pos.y() << " dz " << tpc.pos.z() - si.pos.z()
 			 << endl;
       }
-
     }
+
     // if no match found, keep tpc seed for fitting
-    if (!matched)
+    if (si_matches[tpcid].empty())
     {
       if (Verbosity() > 1)
       {
@@ -8,8 +8,11 @@
 #include <tpc/TpcClusterZCrossingCorrection.h>
 #include <trackbase/ActsGeometry.h>
 
+#include <cstdint>
 #include <map>
+#include <set>
 #include <string>
+#include <vector>
 
 class PHCompositeNode;
 class TrackSeedContainer;
@@ -78,13 +81,16 @@ class PHSiliconTpcTrackMatching : public SubsysReco, public PHParameterInterface
       : posLo{_posLo}, posHi{_posHi}, negLo{_negLo}, negHi{_negHi},
       min_pt_posQ{_min_pt_posQ}, min_pt_negQ{_min_pt_negQ} {};
 
-    inline double fn_exp(const Arr3D& arr, const bool& b_is_0, double pT) {
+    inline double fn_exp(const Arr3D& arr, const bool& b_is_0, double pT) const {
       return (b_is_0 ? arr[0] : arr[0]+arr[1]*exp(arr[2]/pT));
     }
 
     void init_bools(const std::string& which_window="", const bool print=false);
 
-    bool in_window(bool posQ, const double tpc_pt, const double tpc_X, const double si_X);
+    bool in_window(bool posQ, const double tpc_pt, const double tpc_X, const double si_X) const;
+
+    // upper bound on |deltaX| for which in_window can be true
+    double max_abs(bool posQ, const double tpc_pt) const;
 
     // initialize to fn_lo < deltaX < fn_hi for +Q, and fn_lo < deltaX < fn_hi for -Q
 
@@ -150,6 +156,9 @@ class PHSiliconTpcTrackMatching : public SubsysReco, public PHParameterInterface
   }
   void set_max_crossing_diff(const short int diff) { _max_crossing_diff = diff; }
 
+  // number of threads used for the eta/phi matching, 1 by default, zero or negative uses the OpenMP default
+  void set_num_threads(int value) { m_num_threads = value; }
+
   int InitRun(PHCompositeNode *topNode) override;
 
   int process_event(PHCompositeNode *) override;
@@ -165,6 +174,23 @@ class PHSiliconTpcTrackMatching : public SubsysReco, public PHParameterInterface
  private:
   int GetNodes(PHCompositeNode *topNode);
 
+  // seed parameters used for the eta/phi matching, computed once per event
+  struct SeedProjection
+  {
+    bool valid = false;
+    double phi = 0;
+    double eta = 0;
+    double pt = 0;
+    float px = 0;
+    float py = 0;
+    float pz = 0;
+    int q = 0;
+    short int crossing = -999;
+    Acts::Vector3 pos = Acts::Vector3::Zero();
+  };
+
+  bool isEtaPhiMatch(const SeedProjection &tpc, const SeedProjection &si) const;
+
   void findEtaPhiMatches(std::set<unsigned int> &tpc_matched_set,
                          std::set<unsigned int> &tpc_unmatched_set,
                          std::multimap<unsigned int, unsigned int> &tpc_matches);
@@ -202,6 +228,11 @@ class PHSiliconTpcTrackMatching : public SubsysReco, public PHParameterInterface
   ActsGeometry *_tGeometry{nullptr};
   TrkrClusterCrossingAssoc *_cluster_crossing_map{nullptr};
   int m_event = 0;
+  int m_num_threads = 1;
+
+  // time spent in the eta/phi matching (ms) and number of TPC seeds, accumulated over the run
+  double m_matching_time = 0;
+  uint64_t m_matching_tpc_seeds = 0;
   std::map<unsigned int, double> _z_mismatch_map;
 
   short int _max_crossing_diff = 20;  // good for CA seeds, use 10 for polyseeding
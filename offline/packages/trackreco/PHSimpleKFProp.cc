@@ -9,7 +9,6 @@
 #include "GPUTPCTrackLinearisation.h"
 #include "GPUTPCTrackParam.h"
 #include "PHGhostRejection.h"
-#include "nanoflann.hpp"
 
 #include <ffamodules/CDBInterface.h>
 
@@ -31,7 +30,7 @@
 
 #include <trackbase_historic/ActsTransformations.h>
 #include <trackbase_historic/TrackSeedContainer.h>
-#include <trackbase_historic/TrackSeed_v2.h>
+#include <trackbase_historic/TrackSeed_v3.h>
 #include <trackbase_historic/TrackSeedHelper.h>
 
 #include <fun4all/Fun4AllReturnCodes.h>
@@ -49,11 +48,14 @@
 
 #include <omp.h>
 
-#include <bit>
+#include <algorithm>
 #include <cmath>
 #include <filesystem>
 #include <iostream>
+#include <limits>
+#include <numeric>
 #include <syncstream>
+#include <type_traits>
 #include <vector>
 
 // anonymous namespace for local functions
@@ -187,13 +189,13 @@ int PHSimpleKFProp::process_event(PHCompositeNode* topNode)
     return Fun4AllReturnCodes::ABORTEVENT;
   }
 
-  const auto globalPositions = PrepareKDTrees();
+  const auto globalPositions = PrepareLayerIndex();
   if (Verbosity())
-  { std::cout << "PHSimpleKFProp::process_event - PrepareKDTrees time: " << timer.elapsed() << " ms" << std::endl; }
+  { std::cout << "PHSimpleKFProp::process_event - PrepareLayerIndex time: " << timer.elapsed() << " ms" << std::endl; }
 
   // list of cluster chains
   std::vector<std::vector<TrkrDefs::cluskey>> new_chains;
-  std::vector<TrackSeed_v2> unused_tracks;
+  std::vector<TrackSeed_v3> unused_tracks;
 
   timer.restart();
   #pragma omp parallel
@@ -210,7 +212,10 @@ int PHSimpleKFProp::process_event(PHCompositeNode* topNode)
     PHTimer timer_mp("KFPropTimer_parallel");
 
     std::vector<std::vector<TrkrDefs::cluskey>> local_chains;
-    std::vector<TrackSeed_v2> local_unused;
+    std::vector<TrackSeed_v3> local_unused;
+
+    // per thread scratch, reused across seeds
+    std::vector<std::vector<TrkrDefs::cluskey>> keylist_A(1);
 
     #pragma omp for schedule(static)
     for (size_t track_it = 0; track_it != _track_map->size(); ++track_it)
@@ -236,8 +241,7 @@ int PHSimpleKFProp::process_event(PHCompositeNode* topNode)
       {
 
         // copy list of seed cluster keys
-        std::vector<std::vector<TrkrDefs::cluskey>> keylist_A(1);
-        std::copy(track->begin_cluster_keys(), track->end_cluster_keys(), std::back_inserter(keylist_A[0]));
+        keylist_A[0].assign(track->begin_cluster_keys(), track->end_cluster_keys());
 
         // copy seed clusters position into local map
         std::map<TrkrDefs::cluskey, Acts::Vector3> trackClusPositions;
@@ -436,21 +440,34 @@ Acts::Vector3 PHSimpleKFProp::getGlobalPosition(TrkrDefs::cluskey key, TrkrClust
     m_globalPositionWrapper.getGlobalPositionDistortionCorrected( key, cluster, 0 );
 }
 
-PositionMap PHSimpleKFProp::PrepareKDTrees()
+PositionMap PHSimpleKFProp::PrepareLayerIndex()
 {
   PositionMap globalPositions;
-  //***** convert clusters to kdhits, and divide by layer
-  std::vector<std::vector<std::vector<double>>> kdhits;
-  kdhits.resize(58);
+
+  // reset layer index, keeping allocated memory
+  m_layer_index.resize(58);
+  for (auto& layer_index : m_layer_index)
+  {
+    layer_index.clear();
+  }
+
   if (!_cluster_map)
   {
     std::cout << "WARNING: (tracking.PHTpcTrackerUtil.convert_clusters_to_hits) cluster map is not provided" << std::endl;
     return globalPositions;
   }
 
-  for (const auto& hitsetkey : _cluster_map->getHitSetKeys(TrkrDefs::TrkrId::tpcId))
+  // single thread when printing, to keep the output readable
+  const int nthreads = Verbosity() > 0 ? 1 : (m_num_threads >= 1 ? m_num_threads : omp_get_max_threads());
+
+  // calculate global positions in parallel over hitsets
+  const auto hitsetkeys = _cluster_map->getHitSetKeys(TrkrDefs::TrkrId::tpcId);
+  std::vector<std::vector<std::pair<TrkrDefs::cluskey, Acts::Vector3>>> hitset_positions(hitsetkeys.size());
+
+  #pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+  for (size_t i = 0; i < hitsetkeys.size(); ++i)
   {
-    auto range = _cluster_map->getClusters(hitsetkey);
+    auto range = _cluster_map->getClusters(hitsetkeys[i]);
     for (TrkrClusterContainer::ConstIterator it = range.first; it != range.second; ++it)
     {
       const auto& [cluskey,cluster] = *it;
@@ -465,40 +482,275 @@ PositionMap PHSimpleKFProp::PrepareKDTrees()
         continue;
       }
 
-      const auto globalpos = getGlobalPosition(cluskey, cluster);
-      globalPositions.emplace(cluskey, globalpos);
+      hitset_positions[i].emplace_back(cluskey, getGlobalPosition(cluskey, cluster));
+    }
+  }
+
+  // fill position map and layers
+  for (const auto& positions : hitset_positions)
+  {
+    for (const auto& [cluskey, globalpos] : positions)
+    {
+      globalPositions.emplace_hint(globalPositions.end(), cluskey, globalpos);
 
-      const int layer = TrkrDefs::getLayer(cluskey);
-      std::vector<double> kdhit{ globalpos.x(), globalpos.y(),  globalpos.z(), 0 };
-      const uint64_t key = cluskey;
-      std::memcpy(&kdhit[3], &key, sizeof(key));
+      auto& layer_index = m_layer_index[TrkrDefs::getLayer(cluskey)];
+      layer_index.x.push_back(globalpos.x());
+      layer_index.y.push_back(globalpos.y());
+      layer_index.z.push_back(globalpos.z());
+      layer_index.keys.push_back(cluskey);
+    }
+  }
 
-      //      HINT: way to get original uint64_t value from double:
-      //
-      //      LOG_DEBUG("tracking.PHTpcTrackerUtil.convert_clusters_to_hits")
-      //        << "orig: " << cluster->getClusKey() << ", readback: " << (*((int64_t*)&kdhit[3]));
+  // bin layers in azimuth and z, in parallel over layers
+  #pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+  for (size_t l = 0; l < m_layer_index.size(); ++l)
+  {
+    auto& layer_index = m_layer_index[l];
+    layer_index.build();
 
-      kdhits[layer].push_back(std::move(kdhit));
+    if (Verbosity() > 1 && !layer_index.keys.empty())
+    {
+      std::osyncstream(std::cout) << "PHSimpleKFProp::PrepareLayerIndex - layer: " << l << " clusters: " << layer_index.keys.size()
+        << " bins: " << layer_index.nphi << "x" << layer_index.nz << std::endl;
     }
   }
-  _ptclouds.resize(kdhits.size());
-  _kdtrees.resize(kdhits.size());
-  for (size_t l = 0; l < kdhits.size(); ++l)
+
+  return globalPositions;
+}
+
+//_________________________________________________________________
+void PHSimpleKFProp::LayerIndex::clear()
+{
+  x.clear();
+  y.clear();
+  z.clear();
+  keys.clear();
+  rmin = 0;
+  rmax = 0;
+  nphi = 0;
+  nz = 0;
+  phi_bin = 0;
+  zmin = 0;
+  z_bin = 0;
+  bin_offsets.clear();
+}
+
+//_________________________________________________________________
+void PHSimpleKFProp::LayerIndex::build()
+{
+  const size_t size = keys.size();
+  if (!size)
   {
-    if (Verbosity() > 1)
+    return;
+  }
+
+  std::vector<double> phi(size);
+  rmin = std::numeric_limits<double>::max();
+  rmax = 0;
+  zmin = std::numeric_limits<double>::max();
+  double zmax = std::numeric_limits<double>::lowest();
+  for (size_t i = 0; i < size; ++i)
+  {
+    phi[i] = std::atan2(y[i], x[i]);
+
+    const double r = std::sqrt(square(x[i]) + square(y[i]));
+    rmin = std::min(rmin, r);
+    rmax = std::max(rmax, r);
+    zmin = std::min(zmin, z[i]);
+    zmax = std::max(zmax, z[i]);
+  }
+
+  // about two clusters per bin, with bins of similar extent in azimuth (at the mean radius) and z
+  const double nbins = std::max(1., size / 2.);
+  const double length = std::max(zmax - zmin, 1.);
+  const double circumference = 2 * M_PI * std::max(0.5 * (rmin + rmax), 1.);
+  nz = std::clamp<int>(std::lround(std::sqrt(nbins * length / circumference)), 1, static_cast<int>(nbins));
+  nphi = std::max<int>(1, std::lround(nbins / nz));
+  phi_bin = 2 * M_PI / nphi;
+  z_bin = length / nz;
+
+  // counting sort into bins, keeping the original order inside each bin
+  std::vector<unsigned int> bins(size);
+  bin_offsets.assign(nphi * nz + 1, 0);
+  for (size_t i = 0; i < size; ++i)
+  {
+    const int iphi = std::min(nphi - 1, static_cast<int>((phi[i] + M_PI) / phi_bin));
+    const int iz = std::min(nz - 1, static_cast<int>((z[i] - zmin) / z_bin));
+    bins[i] = iphi * nz + iz;
+    ++bin_offsets[bins[i] + 1];
+  }
+  std::partial_sum(bin_offsets.begin(), bin_offsets.end(), bin_offsets.begin());
+
+  std::vector<size_t> order(size);
+  auto next = bin_offsets;
+  for (size_t i = 0; i < size; ++i)
+  {
+    order[next[bins[i]]++] = i;
+  }
+
+  const auto permute = [&order](auto& values)
+  {
+    std::remove_reference_t<decltype(values)> sorted;
+    sorted.reserve(order.size());
+    for (const auto& i : order)
     {
-      std::cout << "l: " << l << std::endl;
+      sorted.push_back(values[i]);
     }
-    _ptclouds[l] = std::make_shared<KDPointCloud<double>>();
-    _ptclouds[l]->pts = std::move(kdhits[l]);
+    values.swap(sorted);
+  };
+
+  permute(x);
+  permute(y);
+  permute(z);
+  permute(keys);
+}
 
-    _kdtrees[l] = std::make_shared<nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<double, KDPointCloud<double>>, KDPointCloud<double>, 3>>(3, *(_ptclouds[l]), nanoflann::KDTreeSingleIndexAdaptorParams(10));
-    _kdtrees[l]->buildIndex();
+//_________________________________________________________________
+size_t PHSimpleKFProp::LayerIndex::closest(double qx, double qy, double qz) const
+{
+  const size_t size = keys.size();
+  if (!size)
+  {
+    return size;
   }
 
-  return globalPositions;
+  const double qphi = std::atan2(qy, qx);
+  const double qr2 = square(qx) + square(qy);
+  const double qr = std::sqrt(qr2);
+
+  // lower bound on the squared transverse distance to any cluster at azimuth difference dphi.
+  // It does not decrease with |dphi|, so that bins can be scanned outward from the query azimuth
+  const auto min_distance2 = [&](double dphi)
+  {
+    const double cosdphi = std::cos(dphi);
+    const double r = std::clamp(qr * cosdphi, rmin, rmax);
+    return qr2 + square(r) - 2 * qr * r * cosdphi;
+  };
+
+  // absolute azimuth difference, in [0, pi]
+  const auto delta_phi = [qphi](double value)
+  { return std::abs(std::remainder(value - qphi, 2 * M_PI)); };
+
+  // smallest azimuth difference to a given azimuth bin
+  const auto bin_delta_phi = [&](int iphi)
+  {
+    const double low = -M_PI + iphi * phi_bin;
+    if (qphi >= low && qphi <= low + phi_bin)
+    {
+      return 0.;
+    }
+    return std::min(delta_phi(low), delta_phi(low + phi_bin));
+  };
+
+  // smallest z difference to a given z bin
+  const auto bin_delta_z = [&](int iz)
+  {
+    const double low = zmin + iz * z_bin;
+    return std::max({0., low - qz, qz - low - z_bin});
+  };
+
+  const int iphi0 = std::clamp(static_cast<int>(std::floor((qphi + M_PI) / phi_bin)), 0, nphi - 1);
+  const int iz0 = std::clamp(static_cast<int>(std::floor((qz - zmin) / z_bin)), 0, nz - 1);
+
+  // azimuth bin offsets, covering each azimuth bin once
+  const int dphi_min = -(nphi - 1) / 2;
+  const int dphi_max = nphi / 2;
+
+  // z bin offsets
+  const int dz_min = -iz0;
+  const int dz_max = nz - 1 - iz0;
+
+  size_t best = size;
+  double best_distance2 = std::numeric_limits<double>::max();
+
+  // scan one bin, unless it cannot contain a closer cluster. Small margin protects against rounding
+  const auto scan_bin = [&](int dphi, int dz)
+  {
+    const int iphi = (iphi0 + dphi + nphi) % nphi;
+    const int iz = iz0 + dz;
+    if (min_distance2(bin_delta_phi(iphi)) + square(bin_delta_z(iz)) > best_distance2 * (1 + 1e-9))
+    {
+      return;
+    }
+
+    const int bin = iphi * nz + iz;
+    for (size_t i = bin_offsets[bin]; i < bin_offsets[bin + 1]; ++i)
+    {
+      const double distance2 = square(x[i] - qx) + square(y[i] - qy) + square(z[i] - qz);
+      if (distance2 < best_distance2)
+      {
+        best_distance2 = distance2;
+        best = i;
+      }
+    }
+  };
+
+  // scan square rings of bins around the query bin, k bins away in azimuth or z
+  for (int k = 0;; ++k)
+  {
+    const bool has_dphi_up = k <= dphi_max;
+    const bool has_dphi_down = -k >= dphi_min;
+    const bool has_dz_up = k <= dz_max;
+    const bool has_dz_down = -k >= dz_min;
+    if (!(has_dphi_up || has_dphi_down || has_dz_up || has_dz_down))
+    {
+      break;
+    }
+
+    // lower bound on the squared distance to any bin at least k bins away
+    double ring_distance2 = std::numeric_limits<double>::max();
+    if (has_dphi_up)
+    {
+      ring_distance2 = std::min(ring_distance2, min_distance2(bin_delta_phi((iphi0 + k) % nphi)));
+    }
+    if (has_dphi_down)
+    {
+      ring_distance2 = std::min(ring_distance2, min_distance2(bin_delta_phi((iphi0 - k + nphi) % nphi)));
+    }
+    if (has_dz_up)
+    {
+      ring_distance2 = std::min(ring_distance2, square(bin_delta_z(iz0 + k)));
+    }
+    if (has_dz_down)
+    {
+      ring_distance2 = std::min(ring_distance2, square(bin_delta_z(iz0 - k)));
+    }
+    if (ring_distance2 > best_distance2 * (1 + 1e-9))
+    {
+      break;
+    }
+
+    const int dz_low = std::max(-k, dz_min);
+    const int dz_high = std::min(k, dz_max);
+    for (int dphi = std::max(-k, dphi_min); dphi <= std::min(k, dphi_max); ++dphi)
+    {
+      if (std::abs(dphi) == k)
+      {
+        // full z range of the ring
+        for (int dz = dz_low; dz <= dz_high; ++dz)
+        {
+          scan_bin(dphi, dz);
+        }
+      }
+      else
+      {
+        // ring edges only
+        if (has_dz_down)
+        {
+          scan_bin(dphi, -k);
+        }
+        if (has_dz_up)
+        {
+          scan_bin(dphi, k);
+        }
+      }
+    }
+  }
+
+  return best;
 }
 
+
 bool PHSimpleKFProp::TransportAndRotate(
   double old_radius,
   double new_radius,
@@ -891,14 +1143,12 @@ bool PHSimpleKFProp::PropagateStep(
   const double new_ty = new_tX * sin(current_phi) + new_tY * cos(current_phi);
   const double new_tz = kftrack.GetZ();
 
-  // search for closest available cluster within window
-  double query_pt[3] = {new_tx, new_ty, new_tz};
-  std::array<size_t, 1> index_out{};
-  std::array<double, 1> distance_out{};
-  int n_results = _kdtrees[next_layer]->knnSearch(&query_pt[0], 1, index_out.data(), distance_out.data());
+  // search for closest available cluster
+  const auto& layer_index = m_layer_index[next_layer];
+  const size_t closest_index = layer_index.closest(new_tx, new_ty, new_tz);
 
   // if no results, then no cluster to add, but propagation is not necessarily done
-  if (!n_results)
+  if (closest_index == layer_index.keys.size())
   {
     if (Verbosity() > 1)
     {
@@ -907,8 +1157,7 @@ bool PHSimpleKFProp::PropagateStep(
     current_layer = next_layer;
     return true;
   }
-  const std::vector<double>& point = _ptclouds[next_layer]->pts[index_out[0]];
-  TrkrDefs::cluskey closest_ckey = std::bit_cast<int64_t>(point[3]);
+  const TrkrDefs::cluskey closest_ckey = layer_index.keys[closest_index];
   TrkrCluster* clusterCandidate = _cluster_map->findCluster(closest_ckey);
   const auto &candidate_globalpos = globalPositions.at(closest_ckey);
   const double cand_x = candidate_globalpos(0);
@@ -1036,7 +1285,9 @@ std::vector<TrkrDefs::cluskey> PHSimpleKFProp::PropagateTrack(TrackSeed* track,
     std::cout << "track (px,py,pz) = (" << track_px << ", " << track_py << ", " << track_pz << ")" << std::endl;
   }
 
-  std::vector<Acts::Vector3> trkGlobPos;
+  // per thread scratch, reused across tracks
+  thread_local std::vector<Acts::Vector3> trkGlobPos;
+  trkGlobPos.clear();
   for (const auto& ckey : ckeys)
   {
     if (TrkrDefs::getTrkrId(ckey) == TrkrDefs::tpcId)
@@ -1327,7 +1578,7 @@ std::vector<keylist> PHSimpleKFProp::RemoveBadClusters(const std::vector<keylist
   return clean_chains;
 }
 
-void PHSimpleKFProp::rejectAndPublishSeeds(std::vector<TrackSeed_v2>& seeds, const PositionMap& positions, std::vector<float>& trackChi2)
+void PHSimpleKFProp::rejectAndPublishSeeds(std::vector<TrackSeed_v3>& seeds, const PositionMap& positions, std::vector<float>& trackChi2)
 {
 
   PHTimer timer("KFPropTimer");
@@ -1342,6 +1593,7 @@ void PHSimpleKFProp::rejectAndPublishSeeds(std::vector<TrackSeed_v2>& seeds, con
   rejector.set_x_cut(_ghost_x_cut);
   rejector.set_y_cut(_ghost_y_cut);
   rejector.set_z_cut(_ghost_z_cut);
+  rejector.set_num_threads(m_num_threads);
   // If you want to reject tracks (before they are are made) can set them here:
   // rejector.set_min_pt_cut(0.2);
   // rejector.set_must_span_sectors(true);
@@ -1420,7 +1672,7 @@ void PHSimpleKFProp::rejectAndPublishSeeds(std::vector<TrackSeed_v2>& seeds, con
 
 }
 
-void PHSimpleKFProp::publishSeeds(const std::vector<TrackSeed_v2>& seeds)
+void PHSimpleKFProp::publishSeeds(const std::vector<TrackSeed_v3>& seeds)
 {
   for (const auto& seed : seeds)
   {
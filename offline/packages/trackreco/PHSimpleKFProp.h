@@ -8,7 +8,6 @@
 #define TRACKRECO_PHSIMPLEKFPROP_H
 
 #include "ALICEKF.h"
-#include "nanoflann.hpp"
 
 // PHENIX includes
 #include <tpc/TpcGlobalPositionWrapper.h>
@@ -25,6 +24,7 @@
 
 // STL includes
 #include <limits>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -137,7 +137,8 @@ class PHSimpleKFProp : public SubsysReco
    */
   Acts::Vector3 getGlobalPosition(TrkrDefs::cluskey, TrkrCluster*) const;
 
-  PositionMap PrepareKDTrees();
+  /// calculate cluster global positions and fill per layer cluster index
+  PositionMap PrepareLayerIndex();
 
   bool TransportAndRotate(
     double old_radius,
@@ -162,51 +163,45 @@ class PHSimpleKFProp : public SubsysReco
   std::vector<TrkrDefs::cluskey> PropagateTrack(TrackSeed* track, std::vector<TrkrDefs::cluskey>& ckeys, PropagationDirection direction, GPUTPCTrackParam& aliceSeed, const PositionMap& globalPositions) const;
   std::vector<std::vector<TrkrDefs::cluskey>> RemoveBadClusters(const std::vector<std::vector<TrkrDefs::cluskey>>& chains, const PositionMap& globalPositions) const;
 
-  template <typename T>
-  struct KDPointCloud
+  /// clusters of a given layer, binned in azimuth and z, for closest cluster search
+  struct LayerIndex
   {
-    KDPointCloud() = default;
-
-    std::vector<std::vector<T>> pts;
-
-    inline size_t kdtree_get_point_count() const
-    {
-      return pts.size();
-    }
-
-    inline T kdtree_distance(const T* p1, const size_t idx_p2, size_t /*size*/) const
-    {
-      const T d0 = p1[0] - pts[idx_p2][0];
-      const T d1 = p1[1] - pts[idx_p2][1];
-      const T d2 = p1[2] - pts[idx_p2][2];
-      return d0 * d0 + d1 * d1 + d2 * d2;
-    }
-
-    inline T kdtree_get_pt(const size_t idx, int dim) const
-    {
-      if (dim == 0)
-        return pts[idx][0];
-      else if (dim == 1)
-        return pts[idx][1];
-      else
-        return pts[idx][2];
-    }
-
-    template <class BBOX>
-    bool kdtree_get_bbox(BBOX& /*bb*/) const
-    { return false; }
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    std::vector<TrkrDefs::cluskey> keys;
 
-  };
+    /// radial extent of the clusters, used to bound the distance to clusters at a given azimuth
+    double rmin = 0;
+    double rmax = 0;
+
+    /// bins, clusters are stored bin after bin, with bin = iphi*nz + iz
+    int nphi = 0;
+    int nz = 0;
+    double phi_bin = 0;
+    double zmin = 0;
+    double z_bin = 0;
+
+    /// index of the first cluster of each bin, followed by the total number of clusters
+    std::vector<unsigned int> bin_offsets;
 
-  std::vector<std::shared_ptr<KDPointCloud<double>>> _ptclouds;
+    void clear();
+
+    /// sort the clusters into bins, once they have all been added
+    void build();
+
+    /// index of the closest cluster (3D distance) to a given position, keys.size() if layer is empty
+    size_t closest(double x, double y, double z) const;
+  };
 
-  std::vector<std::shared_ptr<nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<double, KDPointCloud<double>>, KDPointCloud<double>, 3>>> _kdtrees;
+  /// per layer cluster index
+  std::vector<LayerIndex> m_layer_index;
 
   std::unique_ptr<ALICEKF> fitter;
 
-  void rejectAndPublishSeeds(std::vector<TrackSeed_v2>& seeds, const PositionMap& positions, std::vector<float>& trackChi2);
+  void rejectAndPublishSeeds(std::vector<TrackSeed_v3>& seeds, const PositionMap& positions, std::vector<float>& trackChi2);
 
-  void publishSeeds(const std::vector<TrackSeed_v2>&);
+  void publishSeeds(const std::vector<TrackSeed_v3>&);
 
   int _max_propagation_steps = 200;
 
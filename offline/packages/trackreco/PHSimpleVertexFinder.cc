@@ -8,7 +8,7 @@
 #include <trackbase/TrkrDefs.h>            // for cluskey, getLayer, TrkrId
 #include <trackbase/TrackFitUtils.h>
 #include <trackbase_historic/SvtxTrack.h>  // for SvtxTrack, SvtxTrack::C...
-#include <trackbase_historic/SvtxTrackMap_v2.h>
+#include <trackbase_historic/SvtxTrackMap.h>
 
 #include <globalvertex/SvtxVertexMap_v1.h>
 #include <globalvertex/SvtxVertex_v3.h>
@@ -23,9 +23,12 @@
 
 #include <Acts/Surfaces/PerigeeSurface.hpp>
 
+#include <omp.h>
+
 #include <cmath>  // for sqrt, fabs, atan2, cos
 #include <iomanip>
 #include <iostream>  // for operator<<, basic_ostream
+#include <limits>
 #include <map>       // for map
 #include <set>       // for _Rb_tree_const_iterator
 #include <utility>   // for pair, make_pair
@@ -34,6 +37,7 @@
 #include <cassert>
 #include <functional>
 #include <numeric>
+#include <tuple>
 #include <vector>
 
 #include <Eigen/Dense>
@@ -82,7 +86,8 @@ int PHSimpleVertexFinder::process_event(PHCompositeNode * /*topNode*/)
   // Write to a new map on the node tree that contains (crossing, trackid) pairs for all tracks
   // Later, will add to it a map  containing (crossing, vertexid)
 
-  std::set<short int> crossings;
+  // track keys for each crossing. The track map is sorted, so are the keys
+  std::map<short int, std::vector<unsigned int>> crossing_tracks;
   for (const auto &[trackkey, track] : *_track_map)
   {
     auto crossing = track->get_crossing();
@@ -104,162 +109,64 @@ int PHSimpleVertexFinder::process_event(PHCompositeNode * /*topNode*/)
       }
     }
     
-    crossings.insert(crossing);
+    crossing_tracks[crossing].push_back(trackkey);
     _track_vertex_crossing_map->addTrackAssoc(crossing, trackkey);    
   }
-  
-  unsigned int vertex_id = 0;
 
-  for (auto cross : crossings)
+  std::vector<Crossing> crossings;
+  crossings.reserve(crossing_tracks.size());
+  for (auto &[cross, tracks] : crossing_tracks)
   {
-    // reset maps for each crossing
-    _vertex_track_map.clear();
-    _track_pair_map.clear();
-    _track_pair_pca_map.clear();
-    _vertex_position_map.clear();
-    _vertex_covariance_map.clear();
-    _vertex_set.clear();
+    auto &crossing = crossings.emplace_back();
+    crossing.crossing = cross;
+    crossing.tracks = std::move(tracks);
+  }
 
-    if (Verbosity() > 0)
-    {
-      std::cout << "process tracks for beam crossing " << cross << std::endl;
-    }
+  // the crossings are independent and only read the track map, so they are processed in parallel.
+  // The track pairs of a single crossing are found in parallel too, when there is only one crossing
+  const int nthreads = Verbosity() > 0 ? 1 : (m_num_threads >= 1 ? m_num_threads : omp_get_max_threads());
 
-    // get the subset of tracks for this crossing
-    auto crossing_track_index = _track_vertex_crossing_map->getTracks(cross);
-    SvtxTrackMap *crossing_tracks = new SvtxTrackMap_v2;
-    for (auto iter = crossing_track_index.first; iter != crossing_track_index.second; ++iter)
-    {
-      unsigned int trackkey = (*iter).second;
-      SvtxTrack *track = _track_map->get(trackkey);
-      if(!track)
-      {
-        continue;
-      }
-      crossing_tracks->insertWithKey(track, trackkey);
-    }
+  // Find all instances where two tracks have a dca of < _dcacut,  and capture the pair details.
+  // If no pair is found in a crossing, the cut is relaxed for that crossing and all following ones,
+  // so pairs are found with the relaxed cut here and the cut is applied below
+  const double max_dcacut = std::max(_base_dcacut, 3.0 * _base_dcacut);
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic) if (crossings.size() > 1)
+  for (size_t i = 0; i < crossings.size(); ++i)
+  {
+    auto &crossing = crossings[i];
+    auto lines = _zero_field ? getTrackLinesZF(crossing.tracks) : getTrackLines(crossing.tracks);
+    crossing.candidate_pairs = findTrackPairs(lines, max_dcacut, nthreads);
+  }
 
-    // Find all instances where two tracks have a dca of < _dcacut,  and capture the pair details
-    // Fills _track_pair_map and _track_pair_pca_map
-    if(_zero_field)
-      {
-	checkDCAsZF(crossing_tracks);
-      }
-    else
-      {
-	checkDCAs(crossing_tracks);
-      }
+  for (auto &crossing : crossings)
+  {
+    const auto pass_dcacut = [this](const TrackPair &pair)
+    { return std::abs(pair.dca) < _active_dcacut; };
 
     /// If we didn't find any matches, try again with a slightly larger DCA cut
-    if (_track_pair_map.empty())
+    if (std::none_of(crossing.candidate_pairs.begin(), crossing.candidate_pairs.end(), pass_dcacut))
     {
       _active_dcacut = 3.0 * _base_dcacut;
-      if(_zero_field)
-	{
-	  checkDCAsZF(crossing_tracks);
-	}
-      else
-	{
-	  checkDCAs(crossing_tracks);
-	}
-    }
-    
-    if (Verbosity() > 0)
-    {
-      std::cout << "crossing " << cross << " track pair map size " << _track_pair_map.size() << std::endl;
-    }
-
-    // get all connected pairs of tracks by looping over the track_pair map
-    std::vector<std::set<unsigned int>> connected_tracks = findConnectedTracks();
-
-    // we want the biggest vertex first, sort the vector of connected track sets by size
-    for (unsigned int ivtx = 0; ivtx < connected_tracks.size(); ++ivtx)
-      {
-	bool isdone = true;	
-	for (unsigned int j = 0; j < connected_tracks.size() - ivtx - 1; j++) 
-	  {	
-	    if (connected_tracks[j].size() < connected_tracks[j + 1].size())
-	      {	  
-		swap(connected_tracks[j], connected_tracks[j + 1]);
-		isdone = false;
-	      }
-
-	    if(isdone)
-	    {
-	      break;
-	    }
-	  }
-      }
-    
-    // make vertices - each set of connected tracks is a vertex
-    for (unsigned int ivtx = 0; ivtx < connected_tracks.size(); ++ivtx)
-    {
-      if (Verbosity() > 0)
-      {
-        std::cout << "process vertex " << ivtx + vertex_id << std::endl;
-      }
-
-      for (auto it : connected_tracks[ivtx])
-      {
-        unsigned int id = it;
-        _vertex_track_map.insert(std::make_pair(ivtx, id));
-        if (Verbosity() > 0)
-        {
-          std::cout << "  adding track " << id << " to vertex " << ivtx + vertex_id << std::endl;
-        }
-      }
-    }
-
-    // make a list of vertices
-    for (auto it : _vertex_track_map)
-    {
-      if (Verbosity() > 1)
-      {
-        std::cout << " vertex " << it.first + vertex_id << " track " << it.second << std::endl;
-      }
-      _vertex_set.insert(it.first);
     }
+    crossing.dcacut = _active_dcacut;
+  }
 
-    // this finds average vertex positions after removal of outlying track pairs
-    removeOutlierTrackPairs();
-
-    // average covariance for accepted tracks
-    for (auto it : _vertex_set)
-    {
-      matrix_t avgCov = matrix_t::Zero();
-      double cov_wt = 0.0;
-
-      auto ret = _vertex_track_map.equal_range(it);
-      for (auto cit = ret.first; cit != ret.second; ++cit)
-      {
-        unsigned int trid = cit->second;
-        matrix_t cov;
-        auto *track = _track_map->get(trid);
-        for (int i = 0; i < 3; ++i)
-        {
-          for (int j = 0; j < 3; ++j)
-          {
-            cov(i, j) = track->get_error(i, j);
-          }
-        }
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic) if (crossings.size() > 1)
+  for (size_t i = 0; i < crossings.size(); ++i)
+  {
+    findVertices(crossings[i]);
+  }
 
-        avgCov += cov;
-        cov_wt++;
-      }
+  unsigned int vertex_id = 0;
 
-      avgCov /= sqrt(cov_wt);
-      if (Verbosity() > 2)
-      {
-        std::cout << "Average covariance for vertex " << it << " is:" << std::endl;
-        std::cout << std::setprecision(8) << avgCov << std::endl;
-      }
-      _vertex_covariance_map.insert(std::make_pair(it, avgCov));
-    }
+  for (const auto &crossing : crossings)
+  {
+    const auto cross = crossing.crossing;
 
     // Write the vertices to the vertex map on the node tree
     //==============================================
 
-    for (auto it : _vertex_set)
+    for (auto it : crossing.vertex_set)
     {
       unsigned int thisid = it + vertex_id;  // the address of the vertex in the event
 
@@ -271,7 +178,7 @@ int PHSimpleVertexFinder::process_event(PHCompositeNode * /*topNode*/)
       svtxVertex->set_id(thisid);
       svtxVertex->set_beam_crossing(cross);
 
-      auto ret = _vertex_track_map.equal_range(it);
+      auto ret = crossing.vertex_track_map.equal_range(it);
       for (auto cit = ret.first; cit != ret.second; ++cit)
       {
         unsigned int trid = cit->second;
@@ -300,7 +207,7 @@ int PHSimpleVertexFinder::process_event(PHCompositeNode * /*topNode*/)
         _track_map->get(trid)->set_vertex_id(thisid);
       }
 
-      Eigen::Vector3d pos = _vertex_position_map.find(it)->second;
+      Eigen::Vector3d pos = crossing.vertex_position_map.find(it)->second;
       svtxVertex->set_x(pos.x());
       svtxVertex->set_y(pos.y());
       svtxVertex->set_z(pos.z());
@@ -309,7 +216,7 @@ int PHSimpleVertexFinder::process_event(PHCompositeNode * /*topNode*/)
         std::cout << "   vertex " << thisid << " insert pos.x " << pos.x() << " pos.y " << pos.y() << " pos.z " << pos.z() << std::endl;
       }
 
-      auto vtxCov = _vertex_covariance_map.find(it)->second;
+      auto vtxCov = crossing.vertex_covariance_map.find(it)->second;
       for (int i = 0; i < 3; ++i)
       {
         for (int j = 0; j < 3; ++j)
@@ -321,16 +228,16 @@ int PHSimpleVertexFinder::process_event(PHCompositeNode * /*topNode*/)
       _svtx_vertex_map->insert(svtxVertex.release());
     }
 
-    vertex_id += _vertex_set.size();
+    vertex_id += crossing.vertex_set.size();
 
     /// Iterate through the tracks and assign the closest vtx id to
     /// the track position for propagating back to the vtx. Catches any
     /// tracks that were missed or were not  compatible with any of the
     /// identified vertices
     //=================================================
-    for (const auto &[trackkey, track] : *crossing_tracks)
+    for (const auto &trackkey : crossing.tracks)
     {
-      auto *thistrack = _track_map->get(trackkey);  // get the original, not the copy
+      auto *thistrack = _track_map->get(trackkey);
       auto vtxid = thistrack->get_vertex_id();
       if (Verbosity() > 1)
       {
@@ -346,9 +253,9 @@ int PHSimpleVertexFinder::process_event(PHCompositeNode * /*topNode*/)
       float maxdz = std::numeric_limits<float>::max();
       unsigned int newvtxid = std::numeric_limits<unsigned int>::max();
 
-      for (auto it : _vertex_set)
+      for (auto it : crossing.vertex_set)
       {
-        unsigned int thisid = it + vertex_id - _vertex_set.size();
+        unsigned int thisid = it + vertex_id - crossing.vertex_set.size();
 
         if (Verbosity() > 1)
         {
@@ -375,8 +282,6 @@ int PHSimpleVertexFinder::process_event(PHCompositeNode * /*topNode*/)
       }
     }
 
-    delete crossing_tracks;
-
   }  // end loop over crossings
 
   // update the crossing vertex map with the results
@@ -504,72 +409,52 @@ int PHSimpleVertexFinder::GetNodes(PHCompositeNode *topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
-void PHSimpleVertexFinder::checkDCAs(SvtxTrackMap *track_map)
+std::vector<PHSimpleVertexFinder::TrackLine> PHSimpleVertexFinder::getTrackLines(const std::vector<unsigned int> &tracks)
 {
-  // Loop over tracks and check for close DCA match with all other tracks
-  for (auto tr1_it = track_map->begin(); tr1_it != track_map->end(); ++tr1_it)
+  std::vector<TrackLine> lines;
+  lines.reserve(tracks.size());
+  for (const auto &id : tracks)
   {
-    auto id1 = tr1_it->first;
-    auto *tr1 = tr1_it->second;
-    if (tr1->get_quality() > _qual_cut)
+    auto *track = _track_map->get(id);
+    if (track->get_quality() > _qual_cut)
     {
       continue;
     }
-    if (_require_mvtx && !passClusterRequirement(tr1, "MVTX"))
+    if (_require_mvtx && !passClusterRequirement(track, "MVTX"))
     {
       continue;
     }
-    if (_require_intt && !passClusterRequirement(tr1, "INTT"))
+    if (_require_intt && !passClusterRequirement(track, "INTT"))
     {
       continue;
     }
-
-    // look for close DCA matches with all other such tracks
-    for (auto tr2_it = std::next(tr1_it); tr2_it != track_map->end(); ++tr2_it)
+    if (track->get_pt() < _track_pt_cut)
     {
-      auto id2 = tr2_it->first;
-      auto *tr2 = tr2_it->second;
-      if (tr2->get_quality() > _qual_cut)
-      {
-        continue;
-      }
-      if (_require_mvtx && !passClusterRequirement(tr2, "MVTX"))
-      {
-        continue;
-      }
-      if (_require_intt && !passClusterRequirement(tr2, "INTT"))
-      {
-        continue;
-      }
-
-      // find DCA of these two tracks
-      if (Verbosity() > 3)
-      {
-        std::cout << "Check DCA for tracks " << id1 << " and  " << id2 << std::endl;
-      }
-
-      findDcaTwoTracks(tr1, tr2);
+      continue;
     }
+
+    // get the line equations for the tracks
+    TrackLine line;
+    line.id = id;
+    line.a = Eigen::Vector3d(track->get_x(), track->get_y(), track->get_z());
+    line.b = Eigen::Vector3d(track->get_px() / track->get_p(), track->get_py() / track->get_p(), track->get_pz() / track->get_p());
+    lines.push_back(line);
   }
+
+  return lines;
 }
 
-void PHSimpleVertexFinder::checkDCAsZF(SvtxTrackMap *track_map)
+std::vector<PHSimpleVertexFinder::TrackLine> PHSimpleVertexFinder::getTrackLinesZF(const std::vector<unsigned int> &tracks)
 {
   // ZF tracks do not have an Acts fit, and the seeding does not give
   // reliable track parameters - refit clusters with straight lines
   // No distortion corrections applied in TPC at present
 
-  std::vector<unsigned int> cumulative_trackid_vec;
-  std::vector<unsigned int> cumulative_nmvtx_vec;
-  std::vector<unsigned int> cumulative_nintt_vec;
-  std::vector<std::vector<Acts::Vector3>> cumulative_global_vec;
-  std::vector<std::vector<TrkrDefs::cluskey>> cumulative_cluskey_vec;
-  std::vector<std::vector<float>> cumulative_fitpars_vec;
-
-  for (auto & tr1_it : *track_map)
+  std::vector<TrackLine> lines;
+  lines.reserve(tracks.size());
+  for (const auto &id1 : tracks)
   {
-    auto id1 = tr1_it.first;
-    auto *tr1 = tr1_it.second;
+    auto *tr1 = _track_map->get(id1);
 
     //    tr1->identify();
  
@@ -620,20 +505,6 @@ void PHSimpleVertexFinder::checkDCAsZF(SvtxTrackMap *track_map)
 	  }
       }
 
-    unsigned int nmvtx = 0;
-    unsigned int nintt = 0;
-    for (auto& key : cluskey_vec)
-      {
-        if (TrkrDefs::getTrkrId(key) == TrkrDefs::mvtxId)
-	  {
-	    nmvtx++;
-	  }
-	if(TrkrDefs::getTrkrId(key) == TrkrDefs::inttId)
-	  {
-	    nintt++;
-	  }
-      }
-    
     // store cluster global positions in a vector
     TrackFitUtils::getTrackletClusters(_tGeometry, _cluster_map, global_vec, cluskey_vec);
     
@@ -652,63 +523,21 @@ void PHSimpleVertexFinder::checkDCAsZF(SvtxTrackMap *track_map)
 	  }
       }
 
-    cumulative_trackid_vec.push_back(id1);   
-    cumulative_nmvtx_vec.push_back(nmvtx);   
-    cumulative_nintt_vec.push_back(nintt);   
-    cumulative_global_vec.push_back(global_vec);
-    cumulative_cluskey_vec.push_back(cluskey_vec);
-    cumulative_fitpars_vec.push_back(fitpars);
-  }
-
-  for(unsigned int i1 = 0; i1 < cumulative_trackid_vec.size(); ++i1)
+    if (fitpars.empty())
     {
-      if(cumulative_fitpars_vec[i1].empty()) { continue; }
-
-      for(unsigned int i2 = i1; i2 < cumulative_trackid_vec.size(); ++i2)
-	{
-	  if(cumulative_fitpars_vec[i2].empty()) { continue; }
-
-	  //  For straight line: fitpars[4] = { xyslope, y0, xzslope, z0 }
-	  Eigen::Vector3d a1(0.0, cumulative_fitpars_vec[i1][1],cumulative_fitpars_vec[i1][3]);      // point on track 1 at x = 0
-	  Eigen::Vector3d a2(0.0, cumulative_fitpars_vec[i2][1],cumulative_fitpars_vec[i2][3]);      // point on track 2 at x = 0
-	  // direction vectors made from dy/dx = xyslope and dz/dx = xzslope
-	  Eigen::Vector3d b1(1.0, cumulative_fitpars_vec[i1][0],cumulative_fitpars_vec[i1][2]);      // direction vector of track 1
-	  Eigen::Vector3d b2(1.0, cumulative_fitpars_vec[i2][0],cumulative_fitpars_vec[i2][2]);      // direction vector of track 2
-	  	  
-	  Eigen::Vector3d PCA1(0, 0, 0);
-	  Eigen::Vector3d PCA2(0, 0, 0);
-	  double dca = dcaTwoLines(a1, b1, a2, b2, PCA1, PCA2);
-
-
-	  // check dca cut is satisfied, and that PCA is close to beam line
-	  if (fabs(dca) < _active_dcacut
-	      && (PCA1.x() > _beamline_x_cut_lo && PCA1.x() < _beamline_x_cut_hi)
-	      && (PCA1.y() > _beamline_y_cut_lo && PCA1.y() < _beamline_y_cut_hi)
-	      && (PCA2.x() > _beamline_x_cut_lo && PCA2.x() < _beamline_x_cut_hi)
-	      && (PCA2.y() > _beamline_y_cut_lo && PCA2.y() < _beamline_y_cut_hi)
-	      )
-	    {
-	      int id1 = cumulative_trackid_vec[i1];
-	      int id2 = cumulative_trackid_vec[i2];
-
-	      if (Verbosity() > 3)
-		{
-		  std::cout << " good match for tracks " << id1 << " and " << id2 << std::endl;
-		  std::cout << "    a1.x " << a1.x() << " a1.y " << a1.y() << " a1.z " << a1.z() << std::endl;
-		  std::cout << "    a2.x  " << a2.x() << " a2.y " << a2.y() << " a2.z " << a2.z() << std::endl;
-		  std::cout << "    PCA1.x() " << PCA1.x() << " PCA1.y " << PCA1.y() << " PCA1.z " << PCA1.z() << std::endl;
-		  std::cout << "    PCA2.x() " << PCA2.x() << " PCA2.y " << PCA2.y() << " PCA2.z " << PCA2.z() << std::endl;
-		  std::cout << "    dca " << dca << std::endl;
-		}
-	      
-	      // capture the results for successful matches
-	      _track_pair_map.insert(std::make_pair(id1, std::make_pair(id2, dca)));
-	      _track_pair_pca_map.insert(std::make_pair(id1, std::make_pair(id2, std::make_pair(PCA1, PCA2))));
-	    }	  	  
-	}
+      continue;
     }
 
-  return; 
+    //  For straight line: fitpars[4] = { xyslope, y0, xzslope, z0 }
+    TrackLine line;
+    line.id = id1;
+    line.a = Eigen::Vector3d(0.0, fitpars[1], fitpars[3]);  // point on track at x = 0
+    // direction vector made from dy/dx = xyslope and dz/dx = xzslope
+    line.b = Eigen::Vector3d(1.0, fitpars[0], fitpars[2]);
+    lines.push_back(line);
+  }
+
+  return lines;
 }
 
 void PHSimpleVertexFinder::getTrackletClusterList(TrackSeed* tracklet, std::vector<TrkrDefs::cluskey>& cluskey_vec)
@@ -751,109 +580,235 @@ void PHSimpleVertexFinder::getTrackletClusterList(TrackSeed* tracklet, std::vect
   }  // end loop over clusters for this track
 }
 
-void PHSimpleVertexFinder::checkDCAs()
+std::vector<PHSimpleVertexFinder::TrackPair> PHSimpleVertexFinder::findTrackPairs(std::vector<TrackLine> &lines, double dcacut, int nthreads) const
 {
-  // Loop over tracks and check for close DCA match with all other tracks
-  for (auto tr1_it = _track_map->begin(); tr1_it != _track_map->end(); ++tr1_it)
+  // Both points of closest approach of an accepted pair are inside the beam spot box, and their distance is the pair dca.
+  // Their z are therefore within the z range of their own line inside the box, and closer than the dca cut.
+  // Lines are sorted by the lower end of that range and each line is only paired with the following lines
+  // whose range starts before the end of its own, extended by the cut.
+  // The tolerance covers the rounding in the PCA calculation, so that no accepted pair is missed
+  static constexpr double tolerance = 1e-4;  // cm
+  static constexpr double infinity = std::numeric_limits<double>::infinity();
+
+  const auto set_z_range = [this](TrackLine &line)
   {
-    auto id1 = tr1_it->first;
-    auto *tr1 = tr1_it->second;
-    if (tr1->get_quality() > _qual_cut)
+    // lines with invalid parameters never pass the dca cut
+    if (!line.a.allFinite() || !line.b.allFinite())
     {
-      continue;
+      return false;
     }
-    if (_require_mvtx && !passClusterRequirement(tr1, "MVTX"))
+
+    // range of the line parameter inside the box
+    double cmin = -infinity;
+    double cmax = infinity;
+    const auto clip = [&cmin, &cmax](double a, double b, double lo, double hi)
     {
-      continue;
+      lo -= tolerance;
+      hi += tolerance;
+      if (b == 0)
+      {
+        if (a <= lo || a >= hi)
+        {
+          cmin = infinity;
+          cmax = -infinity;
+        }
+        return;
+      }
+      const double c1 = (lo - a) / b;
+      const double c2 = (hi - a) / b;
+      cmin = std::max(cmin, std::min(c1, c2));
+      cmax = std::min(cmax, std::max(c1, c2));
+    };
+    clip(line.a.x(), line.b.x(), _beamline_x_cut_lo, _beamline_x_cut_hi);
+    clip(line.a.y(), line.b.y(), _beamline_y_cut_lo, _beamline_y_cut_hi);
+    if (cmin > cmax)
+    {
+      return false;
     }
-    if (_require_intt && !passClusterRequirement(tr1, "INTT"))
+
+    if (line.b.z() == 0)
     {
-      continue;
+      line.zmin = line.a.z();
+      line.zmax = line.a.z();
+    }
+    else
+    {
+      const double z1 = line.a.z() + cmin * line.b.z();
+      const double z2 = line.a.z() + cmax * line.b.z();
+      line.zmin = std::min(z1, z2);
+      line.zmax = std::max(z1, z2);
     }
+    return true;
+  };
+
+  lines.erase(std::remove_if(lines.begin(), lines.end(), [&set_z_range](TrackLine &line)
+                             { return !set_z_range(line); }),
+              lines.end());
+  std::sort(lines.begin(), lines.end(), [](const TrackLine &first, const TrackLine &second)
+            { return first.zmin < second.zmin; });
+
+  std::vector<TrackPair> pairs;
+
+  // only parallel when not already called from the parallel loop over crossings
+#pragma omp parallel num_threads(nthreads) if (!omp_in_parallel())
+  {
+    std::vector<TrackPair> thread_pairs;
 
-    // look for close DCA matches with all other such tracks
-    for (auto tr2_it = std::next(tr1_it); tr2_it != _track_map->end(); ++tr2_it)
+#pragma omp for schedule(dynamic, 16)
+    for (size_t i = 0; i < lines.size(); ++i)
     {
-      auto id2 = tr2_it->first;
-      auto *tr2 = tr2_it->second;
-      if (tr2->get_quality() > _qual_cut)
-      {
-        continue;
-      }
-      if (_require_mvtx && !passClusterRequirement(tr2, "MVTX"))
-      {
-        continue;
-      }
-      if (_require_intt && !passClusterRequirement(tr2, "INTT"))
+      const double zmax = lines[i].zmax + dcacut + tolerance;
+      for (size_t j = i + 1; j < lines.size() && lines[j].zmin < zmax; ++j)
       {
-        continue;
-      }
-      // find DCA of these two tracks
-      if (Verbosity() > 3)
-      {
-        std::cout << "Check DCA for tracks " << id1 << " and  " << id2 << std::endl;
+        // pair the tracks in the order of the track map
+        const bool ordered = lines[i].id < lines[j].id;
+        const auto &line1 = ordered ? lines[i] : lines[j];
+        const auto &line2 = ordered ? lines[j] : lines[i];
+
+        TrackPair pair;
+        pair.id1 = line1.id;
+        pair.id2 = line2.id;
+        pair.pca1 = Eigen::Vector3d(0, 0, 0);
+        pair.pca2 = Eigen::Vector3d(0, 0, 0);
+        pair.dca = dcaTwoLines(line1.a, line1.b, line2.a, line2.b, pair.pca1, pair.pca2);
+
+        // check dca cut is satisfied, and that PCA is close to beam line
+        if (fabs(pair.dca) < dcacut
+            && (pair.pca1.x() > _beamline_x_cut_lo && pair.pca1.x() < _beamline_x_cut_hi)
+            && (pair.pca1.y() > _beamline_y_cut_lo && pair.pca1.y() < _beamline_y_cut_hi)
+            && (pair.pca2.x() > _beamline_x_cut_lo && pair.pca2.x() < _beamline_x_cut_hi)
+            && (pair.pca2.y() > _beamline_y_cut_lo && pair.pca2.y() < _beamline_y_cut_hi))
+        {
+          thread_pairs.push_back(pair);
+        }
       }
+    }
 
-      findDcaTwoTracks(tr1, tr2);
+#pragma omp critical
+    pairs.insert(pairs.end(), thread_pairs.begin(), thread_pairs.end());
+  }
+
+  // same order as the loop over all track pairs
+  std::sort(pairs.begin(), pairs.end(), [](const TrackPair &first, const TrackPair &second)
+            { return std::tie(first.id1, first.id2) < std::tie(second.id1, second.id2); });
+
+  if (Verbosity() > 3)
+  {
+    for (const auto &pair : pairs)
+    {
+      std::cout << " good match for tracks " << pair.id1 << " and " << pair.id2 << std::endl;
+      std::cout << "    PCA1.x() " << pair.pca1.x() << " PCA1.y " << pair.pca1.y() << " PCA1.z " << pair.pca1.z() << std::endl;
+      std::cout << "    PCA2.x() " << pair.pca2.x() << " PCA2.y " << pair.pca2.y() << " PCA2.z " << pair.pca2.z() << std::endl;
+      std::cout << "    dca " << pair.dca << std::endl;
     }
   }
+
+  return pairs;
 }
 
-void PHSimpleVertexFinder::findDcaTwoTracks(SvtxTrack *tr1, SvtxTrack *tr2)
+void PHSimpleVertexFinder::findVertices(Crossing &crossing)
 {
-  if (tr1->get_pt() < _track_pt_cut)
+  // capture the results for successful matches
+  for (const auto &pair : crossing.candidate_pairs)
   {
-    return;
+    if (std::abs(pair.dca) < crossing.dcacut)
+    {
+      crossing.track_pair_map.insert(std::make_pair(pair.id1, std::make_pair(pair.id2, pair.dca)));
+      crossing.track_pair_pca_map.insert(std::make_pair(pair.id1, std::make_pair(pair.id2, std::make_pair(pair.pca1, pair.pca2))));
+    }
   }
-  if (tr2->get_pt() < _track_pt_cut)
+
+  if (Verbosity() > 0)
   {
-    return;
+    std::cout << "crossing " << crossing.crossing << " track pair map size " << crossing.track_pair_map.size() << std::endl;
   }
 
-  unsigned int id1 = tr1->get_id();
-  unsigned int id2 = tr2->get_id();
+  // get all connected pairs of tracks by looping over the track_pair map
+  std::vector<std::set<unsigned int>> connected_tracks = findConnectedTracks(crossing);
 
-  // get the line equations for the tracks
+  // we want the biggest vertex first, sort the vector of connected track sets by size
+  for (unsigned int ivtx = 0; ivtx < connected_tracks.size(); ++ivtx)
+  {
+    bool isdone = true;
+    for (unsigned int j = 0; j < connected_tracks.size() - ivtx - 1; j++)
+    {
+      if (connected_tracks[j].size() < connected_tracks[j + 1].size())
+      {
+        swap(connected_tracks[j], connected_tracks[j + 1]);
+        isdone = false;
+      }
 
-  Eigen::Vector3d a1(tr1->get_x(), tr1->get_y(), tr1->get_z());
-  Eigen::Vector3d b1(tr1->get_px() / tr1->get_p(), tr1->get_py() / tr1->get_p(), tr1->get_pz() / tr1->get_p());
-  Eigen::Vector3d a2(tr2->get_x(), tr2->get_y(), tr2->get_z());
-  Eigen::Vector3d b2(tr2->get_px() / tr2->get_p(), tr2->get_py() / tr2->get_p(), tr2->get_pz() / tr2->get_p());
+      if (isdone)
+      {
+        break;
+      }
+    }
+  }
 
-  Eigen::Vector3d PCA1(0, 0, 0);
-  Eigen::Vector3d PCA2(0, 0, 0);
-  double dca = dcaTwoLines(a1, b1, a2, b2, PCA1, PCA2);
+  // make vertices - each set of connected tracks is a vertex
+  for (unsigned int ivtx = 0; ivtx < connected_tracks.size(); ++ivtx)
+  {
+    if (Verbosity() > 0)
+    {
+      std::cout << "crossing " << crossing.crossing << " process vertex " << ivtx << std::endl;
+    }
 
-  if (Verbosity() > 3)
+    for (auto it : connected_tracks[ivtx])
     {
-      std::cout << " pair dca is " << dca << " _active_dcacut is " << _active_dcacut
-		<< " PCA1.x " << PCA1.x() << " PCA1.y " << PCA1.y()
-		<< " PCA2.x " << PCA2.x() << " PCA2.y " << PCA2.y() << std::endl;
+      unsigned int id = it;
+      crossing.vertex_track_map.insert(std::make_pair(ivtx, id));
+      if (Verbosity() > 0)
+      {
+        std::cout << "  adding track " << id << " to vertex " << ivtx << std::endl;
+      }
     }
-  
-  // check dca cut is satisfied, and that PCA is close to beam line
-  if (fabs(dca) < _active_dcacut
-      && (PCA1.x() > _beamline_x_cut_lo && PCA1.x() < _beamline_x_cut_hi)
-      && (PCA1.y() > _beamline_y_cut_lo && PCA1.y() < _beamline_y_cut_hi)
-      && (PCA2.x() > _beamline_x_cut_lo && PCA2.x() < _beamline_x_cut_hi)
-      && (PCA2.y() > _beamline_y_cut_lo && PCA2.y() < _beamline_y_cut_hi)   )
+  }
+
+  // make a list of vertices
+  for (auto it : crossing.vertex_track_map)
+  {
+    if (Verbosity() > 1)
     {
-      if (Verbosity() > 3)
-	{
-	  std::cout << " good match for tracks " << tr1->get_id() << " and " << tr2->get_id() << " with pT " << tr1->get_pt() << " and " << tr2->get_pt() << std::endl;
-	  std::cout << "    a1.x " << a1.x() << " a1.y " << a1.y() << " a1.z " << a1.z() << std::endl;
-	  std::cout << "    a2.x  " << a2.x() << " a2.y " << a2.y() << " a2.z " << a2.z() << std::endl;
-	  std::cout << "    PCA1.x() " << PCA1.x() << " PCA1.y " << PCA1.y() << " PCA1.z " << PCA1.z() << std::endl;
-	  std::cout << "    PCA2.x() " << PCA2.x() << " PCA2.y " << PCA2.y() << " PCA2.z " << PCA2.z() << std::endl;
-	  std::cout << "    dca " << dca << std::endl;
-	}
-      
-      // capture the results for successful matches
-      _track_pair_map.insert(std::make_pair(id1, std::make_pair(id2, dca)));
-      _track_pair_pca_map.insert(std::make_pair(id1, std::make_pair(id2, std::make_pair(PCA1, PCA2))));
+      std::cout << " vertex " << it.first << " track " << it.second << std::endl;
     }
-  
-  return;
+    crossing.vertex_set.insert(it.first);
+  }
+
+  // this finds average vertex positions after removal of outlying track pairs
+  removeOutlierTrackPairs(crossing);
+
+  // average covariance for accepted tracks
+  for (auto it : crossing.vertex_set)
+  {
+    matrix_t avgCov = matrix_t::Zero();
+    double cov_wt = 0.0;
+
+    auto ret = crossing.vertex_track_map.equal_range(it);
+    for (auto cit = ret.first; cit != ret.second; ++cit)
+    {
+      unsigned int trid = cit->second;
+      matrix_t cov;
+      auto *track = _track_map->get(trid);
+      for (int i = 0; i < 3; ++i)
+      {
+        for (int j = 0; j < 3; ++j)
+        {
+          cov(i, j) = track->get_error(i, j);
+        }
+      }
+
+      avgCov += cov;
+      cov_wt++;
+    }
+
+    avgCov /= sqrt(cov_wt);
+    if (Verbosity() > 2)
+    {
+      std::cout << "Average covariance for vertex " << it << " is:" << std::endl;
+      std::cout << std::setprecision(8) << avgCov << std::endl;
+    }
+    crossing.vertex_covariance_map.insert(std::make_pair(it, avgCov));
+  }
 }
 
 double PHSimpleVertexFinder::dcaTwoLines(const Eigen::Vector3d &a1, const Eigen::Vector3d &b1,
@@ -916,12 +871,12 @@ double PHSimpleVertexFinder::dcaTwoLines(const Eigen::Vector3d &a1, const Eigen:
   return dca;
 }
 
-std::vector<std::set<unsigned int>> PHSimpleVertexFinder::findConnectedTracks()
+std::vector<std::set<unsigned int>> PHSimpleVertexFinder::findConnectedTracks(const Crossing &crossing)
 {
   std::vector<std::set<unsigned int>> connected_tracks;
   std::set<unsigned int> connected;
   std::set<unsigned int> used;
-  for (auto it : _track_pair_map)
+  for (auto it : crossing.track_pair_map)
   {
     unsigned int id1 = it.first;
     unsigned int id2 = it.second.first;
@@ -929,7 +884,7 @@ std::vector<std::set<unsigned int>> PHSimpleVertexFinder::findConnectedTracks()
     
     if(Verbosity() > 2)
       {
-	auto rt = _track_pair_pca_map.equal_range(id1);
+	auto rt = crossing.track_pair_pca_map.equal_range(id1);
 	for (auto ct = rt.first; ct != rt.second; ++ct)
 	  {
 	    unsigned int idb = ct->second.first;
@@ -956,7 +911,7 @@ std::vector<std::set<unsigned int>> PHSimpleVertexFinder::findConnectedTracks()
       {
 	if (Verbosity() > 2)
 	  {
-	    auto rt1 = _track_pair_pca_map.equal_range(id1);
+	    auto rt1 = crossing.track_pair_pca_map.equal_range(id1);
 	    for (auto ct = rt1.first; ct != rt1.second; ++ct)
 	      {
 		unsigned int ida = ct->first;
@@ -990,7 +945,7 @@ std::vector<std::set<unsigned int>> PHSimpleVertexFinder::findConnectedTracks()
     used.insert(id1);
     connected.insert(id2);
     used.insert(id2);
-    for (auto cit : _track_pair_map)
+    for (auto cit : crossing.track_pair_map)
     {
       unsigned int id3 = cit.first;
       unsigned int id4 = cit.second.first;
@@ -1001,7 +956,7 @@ std::vector<std::set<unsigned int>> PHSimpleVertexFinder::findConnectedTracks()
         if (Verbosity() > 2)
 	  {
 
-	    auto rt2 = _track_pair_pca_map.equal_range(id3);
+	    auto rt2 = crossing.track_pair_pca_map.equal_range(id3);
 	    for (auto ct = rt2.first; ct != rt2.second; ++ct)
 	      {
 		unsigned int ida = ct->first;
@@ -1045,11 +1000,11 @@ std::vector<std::set<unsigned int>> PHSimpleVertexFinder::findConnectedTracks()
   return connected_tracks;
 }
 
-void PHSimpleVertexFinder::removeOutlierTrackPairs()
+void PHSimpleVertexFinder::removeOutlierTrackPairs(Crossing &crossing)
 {
-  //  Note: std::multimap<unsigned int, std::pair<unsigned int, std::pair<Eigen::Vector3d,  Eigen::Vector3d>>>  _track_pair_pca_map
+  //  Note: std::multimap<unsigned int, std::pair<unsigned int, std::pair<Eigen::Vector3d,  Eigen::Vector3d>>>  track_pair_pca_map
 
-  for (auto it : _vertex_set)
+  for (auto it : crossing.vertex_set)
   {
     unsigned int vtxid = it;
     if (Verbosity() > 1)
@@ -1069,7 +1024,7 @@ void PHSimpleVertexFinder::removeOutlierTrackPairs()
     Eigen::Vector3d new_pca_avge(0., 0., 0.);
     double new_wt = 0.0;
 
-    auto ret = _vertex_track_map.equal_range(vtxid);
+    auto ret = crossing.vertex_track_map.equal_range(vtxid);
 
     // Start by getting the positions for this vertex into vectors for the median calculation
     for (auto cit = ret.first; cit != ret.second; ++cit)
@@ -1081,7 +1036,7 @@ void PHSimpleVertexFinder::removeOutlierTrackPairs()
       }
 
       // find all pairs for this vertex with tr1id
-      auto pca_range = _track_pair_pca_map.equal_range(tr1id);
+      auto pca_range = crossing.track_pair_pca_map.equal_range(tr1id);
       for (auto pit = pca_range.first; pit != pca_range.second; ++pit)
       {
         unsigned int tr2id = pit->second.first;
@@ -1113,7 +1068,7 @@ void PHSimpleVertexFinder::removeOutlierTrackPairs()
       new_pca_avge.x() = getAverage(vx);
       new_pca_avge.y() = getAverage(vy);
       new_pca_avge.z() = getAverage(vz);
-      _vertex_position_map.insert(std::make_pair(vtxid, new_pca_avge));
+      crossing.vertex_position_map.insert(std::make_pair(vtxid, new_pca_avge));
       if (Verbosity() > 1)
       {
         std::cout << " Vertex has only 2 tracks, use average for PCA: " << new_pca_avge.x() << "  " << new_pca_avge.y() << "  " << new_pca_avge.z() << std::endl;
@@ -1141,7 +1096,7 @@ void PHSimpleVertexFinder::removeOutlierTrackPairs()
       }
 
       // find all pairs for this vertex with tr1id
-      auto pca_range = _track_pair_pca_map.equal_range(tr1id);
+      auto pca_range = crossing.track_pair_pca_map.equal_range(tr1id);
       for (auto pit = pca_range.first; pit != pca_range.second; ++pit)
       {
         unsigned int tr2id = pit->second.first;
@@ -1183,7 +1138,7 @@ void PHSimpleVertexFinder::removeOutlierTrackPairs()
       new_pca_avge.z() = pca_median_z;
     }
 
-    _vertex_position_map.insert(std::make_pair(vtxid, new_pca_avge));
+    crossing.vertex_position_map.insert(std::make_pair(vtxid, new_pca_avge));
   }
 
   return;
@@ -59,22 +59,81 @@ class PHSimpleVertexFinder : public SubsysReco
   void setTrkrClusterContainerName(const std::string &name){ m_clusterContainerName = name; }
   void set_pp_mode(bool mode = true) { _pp_mode = mode; }
 
+  /// number of threads used for the crossings and the track pairs, 1 by default. Zero or negative uses the OpenMP default
+  /** everything runs on a single thread when Verbosity() > 0 */
+  void set_num_threads(int value) { m_num_threads = value; }
+
  private:
+  using matrix_t = Eigen::Matrix<double, 3, 3>;
+
+  //! straight line approximation of a track, used for the pair dca
+  struct TrackLine
+  {
+    unsigned int id = 0;
+    Eigen::Vector3d a;  // point on the line
+    Eigen::Vector3d b;  // direction
+    // z range over which the line is inside the beam spot box
+    double zmin = 0;
+    double zmax = 0;
+  };
+
+  //! track pair passing the dca and beam spot cuts
+  struct TrackPair
+  {
+    unsigned int id1 = 0;
+    unsigned int id2 = 0;
+    double dca = 0;
+    Eigen::Vector3d pca1;
+    Eigen::Vector3d pca2;
+  };
+
+  //! vertex finding state for one bunch crossing
+  struct Crossing
+  {
+    short int crossing = 0;
+
+    // track keys, sorted
+    std::vector<unsigned int> tracks;
+
+    // pairs passing the loosest dca cut, sorted by track keys
+    std::vector<TrackPair> candidate_pairs;
+
+    // pair dca cut used for this crossing
+    double dcacut = 0;
+
+    std::multimap<unsigned int, unsigned int> vertex_track_map;
+    std::multimap<unsigned int, std::pair<unsigned int, double>> track_pair_map;
+    // Eigen::Vector3d is an Eigen::Matrix<double,3,1>
+    std::multimap<unsigned int, std::pair<unsigned int, std::pair<Eigen::Vector3d,
+                                                                  Eigen::Vector3d>>>
+        track_pair_pca_map;
+    std::map<unsigned int, Eigen::Vector3d> vertex_position_map;
+    std::map<unsigned int, matrix_t> vertex_covariance_map;
+    std::set<unsigned int> vertex_set;
+  };
+
   int GetNodes(PHCompositeNode *topNode);
   int CreateNodes(PHCompositeNode *topNode);
 
-  void checkDCAs(SvtxTrackMap *track_map);
-  void checkDCAsZF(SvtxTrackMap *track_map);
-  void checkDCAs();
+  //! track lines from the fitted track parameters, for tracks passing the quality cuts
+  std::vector<TrackLine> getTrackLines(const std::vector<unsigned int> &tracks);
+
+  //! track lines from straight line fits to the clusters, for zero field
+  std::vector<TrackLine> getTrackLinesZF(const std::vector<unsigned int> &tracks);
 
   void getTrackletClusterList(TrackSeed* tracklet, std::vector<TrkrDefs::cluskey>& cluskey_vec);
-  
-  void findDcaTwoTracks(SvtxTrack *tr1, SvtxTrack *tr2);
-  double dcaTwoLines(const Eigen::Vector3d &a1, const Eigen::Vector3d &b1,
-                     const Eigen::Vector3d &a2, const Eigen::Vector3d &b2,
-                     Eigen::Vector3d &PCA1, Eigen::Vector3d &PCA2);
-  std::vector<std::set<unsigned int>> findConnectedTracks();
-  void removeOutlierTrackPairs();
+
+  //! all pairs of lines with a dca below dcacut and both PCAs inside the beam spot box, sorted by track keys
+  std::vector<TrackPair> findTrackPairs(std::vector<TrackLine> &lines, double dcacut, int nthreads) const;
+
+  //! connected tracks, vertex positions and covariances for a crossing, from its accepted track pairs
+  void findVertices(Crossing &crossing);
+
+  static double dcaTwoLines(const Eigen::Vector3d &a1, const Eigen::Vector3d &b1,
+                            const Eigen::Vector3d &a2, const Eigen::Vector3d &b2,
+                            Eigen::Vector3d &PCA1, Eigen::Vector3d &PCA2);
+  std::vector<std::set<unsigned int>> findConnectedTracks(const Crossing &crossing);
+  void removeOutlierTrackPairs(Crossing &crossing);
   double getMedian(std::vector<double> &v);
   double getAverage(std::vector<double> &v);
   bool passClusterRequirement(SvtxTrack *track, const std::string &type = "MVTX");
@@ -107,16 +166,9 @@ class PHSimpleVertexFinder : public SubsysReco
 
   std::string _track_map_name = "SvtxTrackMap";
   std::string _vertex_map_name = "SvtxVertexMap";
-  std::multimap<unsigned int, unsigned int> _vertex_track_map;
-  using matrix_t = Eigen::Matrix<double, 3, 3>;
-  std::multimap<unsigned int, std::pair<unsigned int, double>> _track_pair_map;
-  // Eigen::Vector3d is an Eigen::Matrix<double,3,1>
-  std::multimap<unsigned int, std::pair<unsigned int, std::pair<Eigen::Vector3d,
-                                                                Eigen::Vector3d>>>
-      _track_pair_pca_map;
-  std::map<unsigned int, Eigen::Vector3d> _vertex_position_map;
-  std::map<unsigned int, matrix_t> _vertex_covariance_map;
-  std::set<unsigned int> _vertex_set;
+
+  // number of threads
+  int m_num_threads = 1;
 
   TrackVertexCrossingAssoc *_track_vertex_crossing_map{nullptr};
 
@@ -35,11 +35,129 @@
 #include <TNtuple.h>
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <string>
 #include <utility>
+#include <vector>
+
+namespace
+{
+  // tower grids, towers are indexed by etabin * nphi + phibin
+  const unsigned int emcal_nphi = 256;
+  const unsigned int emcal_ntowers = 96 * emcal_nphi;
+  const unsigned int hcal_nphi = 64;
+  const unsigned int hcal_ntowers = 24 * hcal_nphi;
+
+  // primitives of the calorimeters, with 16 2x2 sums each
+  const unsigned int emcal_nprimitives = 384;
+  const unsigned int hcal_nprimitives = 24;
+  const unsigned int calo_nsums = 16;
+
+  // 8x8 sums, 16 jet primitives of 24 sums
+  const unsigned int ll1_nprimitives = 16;
+  const unsigned int ll1_nsums = 24;
+
+  // overlapping 4x4 jet patches
+  const unsigned int jet_nphi = 32;
+  const unsigned int jet_neta = 9;
+
+  const unsigned int lut_size = 1024;
+
+  unsigned int tower_index(unsigned int key, unsigned int nphi)
+  {
+    return ((key >> 16U) * nphi) + (key & 0xffffU);
+  }
+
+  // samples of a tower in the peak - pedestal buffer, nullptr for towers outside the buffer
+  unsigned int *get_peak_sub_ped(std::vector<unsigned int> &peak_sub_ped, unsigned int nphi, unsigned int key, int nsample)
+  {
+    const size_t offset = static_cast<size_t>(tower_index(key, nphi)) * nsample;
+    if ((key & 0xffffU) >= nphi || offset + nsample > peak_sub_ped.size())
+    {
+      return nullptr;
+    }
+    return peak_sub_ped.data() + offset;
+  }
+
+  void clear_peak_sub_ped(std::vector<unsigned int> &peak_sub_ped, unsigned int nphi, unsigned int key, int nsample)
+  {
+    if (unsigned int *peak = get_peak_sub_ped(peak_sub_ped, nphi, key, nsample))
+    {
+      std::fill_n(peak, nsample, 0);
+    }
+  }
+
+  // peak - pedestal for samples [sample_start, sample_end), the pedestal is taken trig_sub_delay samples before
+  template <class Sample>
+  void fill_peak_sub_ped(unsigned int *peak, int sample_start, int sample_end, int trig_sub_delay, Sample sample)
+  {
+    for (int i = sample_start; i < sample_end; i++)
+    {
+      int16_t maxim = (sample(i) > sample(i + 1) ? sample(i) : sample(i + 1));
+      maxim = (maxim > sample(i + 2) ? maxim : sample(i + 2));
+      uint16_t sam = 0;
+      if (i >= trig_sub_delay)
+      {
+        sam = i - trig_sub_delay;
+      }
+      unsigned int sub = 0;
+      if (maxim > sample(sam))
+      {
+        sub = (((uint16_t) (maxim - sample(sam))) & 0x3fffU);
+      }
+      *peak++ = sub;
+    }
+  }
+
+  // 2x2 sum of the 8 bit LUT outputs of 4 towers, for all samples
+  void sum_towers(unsigned int *sum, const unsigned int *const peak[4], const uint8_t *const lut[4], int nsample, unsigned int sum_mask)
+  {
+    for (int is = 0; is < nsample; is++)
+    {
+      unsigned int temp_sum = 0;
+      for (int j = 0; j < 4; j++)
+      {
+        temp_sum += lut[j][(peak[j][is] >> 4U) & 0x3ffU];
+      }
+      sum[is] = ((temp_sum & sum_mask) >> 2U) & 0xffU;
+    }
+  }
+
+  void print_sums(const std::string &name, TriggerDefs::TriggerSumKey sumkey, const unsigned int *sum, int nsample)
+  {
+    for (int is = 0; is < nsample; is++)
+    {
+      if (sum[is] >= 1)
+      {
+        std::cout << __FILE__ << ":: " << name << " sum " << sumkey << " = " << sum[is] << std::endl;
+      }
+    }
+  }
+
+  // copy the sums into a primitive container, nsample values per sum in the order of the sum keys
+  void fill_primitives(TriggerPrimitiveContainer *primitives, const std::vector<unsigned int> &sums, int nsample)
+  {
+    if (!primitives)
+    {
+      return;
+    }
+    const unsigned int *sum = sums.data();
+    const unsigned int *sum_end = sums.data() + sums.size();
+    TriggerPrimitiveContainer::Range range = primitives->getTriggerPrimitives();
+    for (TriggerPrimitiveContainer::Iter iter = range.first; iter != range.second; ++iter)
+    {
+      TriggerPrimitive::Range sumrange = iter->second->getSums();
+      for (TriggerPrimitive::Iter iter_sum = sumrange.first; iter_sum != sumrange.second && sum + nsample <= sum_end; ++iter_sum)
+      {
+        iter_sum->second->assign(sum, sum + nsample);
+        sum += nsample;
+      }
+    }
+  }
+}  // namespace
 
 // constructor
 CaloTriggerEmulator::CaloTriggerEmulator(const std::string &name)
@@ -404,6 +522,8 @@ int CaloTriggerEmulator::InitRun(PHCompositeNode *topNode)
     return Fun4AllReturnCodes::ABORTRUN;
   }
 
+  build_tables();
+
   CreateNodes(topNode);
 
   return 0;
@@ -576,10 +696,10 @@ int CaloTriggerEmulator::process_event(PHCompositeNode *topNode)
 // RESET event procedure that takes all variables to 0 and clears the primitives.
 int CaloTriggerEmulator::ResetEvent(PHCompositeNode * /*topNode*/)
 {
-  // here, the peak minus pedestal map is cleanly disposed of
-  m_peak_sub_ped_emcal.clear();
-  m_peak_sub_ped_hcalin.clear();
-  m_peak_sub_ped_hcalout.clear();
+  // here, the peak minus pedestal is cleared, keeping the buffers for the next event
+  std::fill(m_peak_sub_ped_emcal.begin(), m_peak_sub_ped_emcal.end(), 0);
+  std::fill(m_peak_sub_ped_hcalin.begin(), m_peak_sub_ped_hcalin.end(), 0);
+  std::fill(m_peak_sub_ped_hcalout.begin(), m_peak_sub_ped_hcalout.end(), 0);
 
   return 0;
 }
@@ -592,6 +712,7 @@ int CaloTriggerEmulator::process_offline(PHCompositeNode *topNode)
     sample_start = m_trig_sample;
     sample_end = m_trig_sample + 1;
   }
+  const int nsample = sample_end - sample_start;
 
   if (m_do_emcal)
   {
@@ -637,64 +758,31 @@ int CaloTriggerEmulator::process_offline(PHCompositeNode *topNode)
             {
               for (int iskip = 0; iskip < 64; iskip++)
               {
-                std::vector<unsigned int> v_peak_sub_ped;
-                for (int i = sample_start; i < sample_end; i++)
-                {
-                  v_peak_sub_ped.push_back(0);
-                }
-                unsigned int key = TowerInfoDefs::encode_emcal(iwave);
-                m_peak_sub_ped_emcal[key] = v_peak_sub_ped;
+                clear_peak_sub_ped(m_peak_sub_ped_emcal, emcal_nphi, TowerInfoDefs::encode_emcal(iwave), nsample);
                 iwave++;
               }
             }
           }
-          std::vector<unsigned int> v_peak_sub_ped;
-          if (packet->iValue(channel, "SUPPRESSED"))
+          unsigned int *peak = get_peak_sub_ped(m_peak_sub_ped_emcal, emcal_nphi, TowerInfoDefs::encode_emcal(iwave), nsample);
+          if (peak)
           {
-            for (int i = sample_start; i < sample_end; i++)
+            if (packet->iValue(channel, "SUPPRESSED"))
             {
-              v_peak_sub_ped.push_back(0);
+              std::fill_n(peak, nsample, 0);
             }
-          }
-          else
-          {
-            for (int i = sample_start; i < sample_end; i++)
+            else
             {
-              int16_t maxim = (packet->iValue(i, channel) > packet->iValue(i + 1, channel) ? packet->iValue(i, channel) : packet->iValue(i + 1, channel));
-              maxim = (maxim > packet->iValue(i + 2, channel) ? maxim : packet->iValue(i + 2, channel));
-              uint16_t sam = 0;
-              if (i >= m_trig_sub_delay)
-              {
-                sam = i - m_trig_sub_delay;
-              }
-              else
-              {
-                sam = 0;
-              }
-              unsigned int sub = 0;
-              if (maxim > packet->iValue(sam, channel))
-              {
-                sub = (((uint16_t) (maxim - packet->iValue(sam, channel))) & 0x3fffU);
-              }
-
-              v_peak_sub_ped.push_back(sub);
+              fill_peak_sub_ped(peak, sample_start, sample_end, m_trig_sub_delay, [packet, channel](int i)
+                                { return packet->iValue(i, channel); });
             }
           }
-          unsigned int key = TowerInfoDefs::encode_emcal(iwave);
-          m_peak_sub_ped_emcal[key] = v_peak_sub_ped;
           iwave++;
         }
         if (nchannels < 192 && !(adc_skip_mask < 4))
         {
           for (int iskip = 0; iskip < 192 - nchannels; iskip++)
           {
-            std::vector<unsigned int> v_peak_sub_ped;
-            for (int i = sample_start; i < sample_end; i++)
-            {
-              v_peak_sub_ped.push_back(0);
-            }
-            unsigned int key = TowerInfoDefs::encode_emcal(iwave);
-            m_peak_sub_ped_emcal[key] = v_peak_sub_ped;
+            clear_peak_sub_ped(m_peak_sub_ped_emcal, emcal_nphi, TowerInfoDefs::encode_emcal(iwave), nsample);
             iwave++;
           }
         }
@@ -727,40 +815,19 @@ int CaloTriggerEmulator::process_offline(PHCompositeNode *topNode)
 
         for (int channel = 0; channel < nchannels; channel++)
         {
-          std::vector<unsigned int> v_peak_sub_ped;
-          if (packet->iValue(channel, "SUPPRESSED"))
+          unsigned int *peak = get_peak_sub_ped(m_peak_sub_ped_hcalout, hcal_nphi, TowerInfoDefs::encode_hcal(iwave), nsample);
+          if (peak)
           {
-            for (int i = sample_start; i < sample_end; i++)
+            if (packet->iValue(channel, "SUPPRESSED"))
             {
-              v_peak_sub_ped.push_back(0);
+              std::fill_n(peak, nsample, 0);
             }
-          }
-          else
-          {
-            for (int i = sample_start; i < sample_end; i++)
+            else
             {
-              int16_t maxim = (packet->iValue(i, channel) > packet->iValue(i + 1, channel) ? packet->iValue(i, channel) : packet->iValue(i + 1, channel));
-              maxim = (maxim > packet->iValue(i + 2, channel) ? maxim : packet->iValue(i + 2, channel));
-              uint16_t sam = 0;
-              if (i >= m_trig_sub_delay)
-              {
-                sam = i - m_trig_sub_delay;
-              }
-              else
-              {
-                sam = 0;
-              }
-              unsigned int sub = 0;
-              if (maxim > packet->iValue(sam, channel))
-              {
-                sub = (((uint16_t) (maxim - packet->iValue(sam, channel))) & 0x3fffU);
-              }
-
-              v_peak_sub_ped.push_back(sub);
+              fill_peak_sub_ped(peak, sample_start, sample_end, m_trig_sub_delay, [packet, channel](int i)
+                                { return packet->iValue(i, channel); });
             }
           }
-          unsigned int key = TowerInfoDefs::encode_hcal(iwave);
-          m_peak_sub_ped_hcalout[key] = v_peak_sub_ped;
           iwave++;
         }
       }
@@ -792,40 +859,19 @@ int CaloTriggerEmulator::process_offline(PHCompositeNode *topNode)
 
         for (int channel = 0; channel < nchannels; channel++)
         {
-          std::vector<unsigned int> v_peak_sub_ped;
-          if (packet->iValue(channel, "SUPPRESSED"))
+          unsigned int *peak = get_peak_sub_ped(m_peak_sub_ped_hcalin, hcal_nphi, TowerInfoDefs::encode_hcal(iwave), nsample);
+          if (peak)
           {
-            for (int i = sample_start; i < sample_end; i++)
+            if (packet->iValue(channel, "SUPPRESSED"))
             {
-              v_peak_sub_ped.push_back(0);
+              std::fill_n(peak, nsample, 0);
             }
-          }
-          else
-          {
-            for (int i = sample_start; i < sample_end; i++)
+            else
             {
-              int16_t maxim = (packet->iValue(i, channel) > packet->iValue(i + 1, channel) ? packet->iValue(i, channel) : packet->iValue(i + 1, channel));
-              maxim = (maxim > packet->iValue(i + 2, channel) ? maxim : packet->iValue(i + 2, channel));
-              uint16_t sam = 0;
-              if (i >= m_trig_sub_delay)
-              {
-                sam = i - m_trig_sub_delay;
-              }
-              else
-              {
-                sam = 0;
-              }
-              unsigned int sub = 0;
-              if (maxim > packet->iValue(sam, channel))
-              {
-                sub = (((uint16_t) (maxim - packet->iValue(sam, channel))) & 0x3fffU);
-              }
-
-              v_peak_sub_ped.push_back(sub);
+              fill_peak_sub_ped(peak, sample_start, sample_end, m_trig_sub_delay, [packet, channel](int i)
+                                { return packet->iValue(i, channel); });
             }
           }
-          unsigned int key = TowerInfoDefs::encode_hcal(iwave);
-          m_peak_sub_ped_hcalin[key] = v_peak_sub_ped;
           iwave++;
         }
       }
@@ -869,6 +915,7 @@ int CaloTriggerEmulator::process_waveforms(PHCompositeNode *topNode)
     sample_start = m_trig_sample;
     sample_end = m_trig_sample + 1;
   }
+  const int nsample = sample_end - sample_start;
 
   if (m_do_emcal)
   {
@@ -896,52 +943,25 @@ int CaloTriggerEmulator::process_waveforms(PHCompositeNode *topNode)
             {
               for (int iskip = 0; iskip < 64; iskip++)
               {
-                std::vector<unsigned int> v_peak_sub_ped;
-                for (int i = sample_start; i < sample_end; i++)
-                {
-                  v_peak_sub_ped.push_back(0);
-                }
-                unsigned int key = TowerInfoDefs::encode_emcal(iwave);
-                m_peak_sub_ped_emcal[key] = v_peak_sub_ped;
+                clear_peak_sub_ped(m_peak_sub_ped_emcal, emcal_nphi, TowerInfoDefs::encode_emcal(iwave), nsample);
                 iwave++;
               }
               continue;
             }
           }
-          std::vector<unsigned int> v_peak_sub_ped;
-          if (packet->iValue(channel, "SUPPRESSED"))
+          unsigned int *peak = get_peak_sub_ped(m_peak_sub_ped_emcal, emcal_nphi, TowerInfoDefs::encode_emcal(iwave), nsample);
+          if (peak)
           {
-            for (int i = sample_start; i < sample_end; i++)
+            if (packet->iValue(channel, "SUPPRESSED"))
             {
-              v_peak_sub_ped.push_back(0);
+              std::fill_n(peak, nsample, 0);
             }
-          }
-          else
-          {
-            for (int i = sample_start; i < sample_end; i++)
+            else
             {
-              int16_t maxim = (packet->iValue(i, channel) > packet->iValue(i + 1, channel) ? packet->iValue(i, channel) : packet->iValue(i + 1, channel));
-              maxim = (maxim > packet->iValue(i + 2, channel) ? maxim : packet->iValue(i + 2, channel));
-              uint16_t sam = 0;
-              if (i >= m_trig_sub_delay)
-              {
-                sam = i - m_trig_sub_delay;
-              }
-              else
-              {
-                sam = 0;
-              }
-              unsigned int sub = 0;
-              if (maxim > packet->iValue(sam, channel))
-              {
-                sub = (((uint16_t) (maxim - packet->iValue(sam, channel))) & 0x3fffU);
-              }
-
-              v_peak_sub_ped.push_back(sub);
+              fill_peak_sub_ped(peak, sample_start, sample_end, m_trig_sub_delay, [packet, channel](int i)
+                                { return packet->iValue(i, channel); });
             }
           }
-          unsigned int key = TowerInfoDefs::encode_emcal(iwave);
-          m_peak_sub_ped_emcal[key] = v_peak_sub_ped;
           iwave++;
         }
       }
@@ -965,40 +985,19 @@ int CaloTriggerEmulator::process_waveforms(PHCompositeNode *topNode)
 
         for (int channel = 0; channel < nchannels; channel++)
         {
-          std::vector<unsigned int> v_peak_sub_ped;
-          if (packet->iValue(channel, "SUPPRESSED"))
+          unsigned int *peak = get_peak_sub_ped(m_peak_sub_ped_hcalout, hcal_nphi, TowerInfoDefs::encode_hcal(iwave), nsample);
+          if (peak)
           {
-            for (int i = sample_start; i < sample_end; i++)
+            if (packet->iValue(channel, "SUPPRESSED"))
             {
-              v_peak_sub_ped.push_back(0);
+              std::fill_n(peak, nsample, 0);
             }
-          }
-          else
-          {
-            for (int i = sample_start; i < sample_end; i++)
+            else
             {
-              int16_t maxim = (packet->iValue(i, channel) > packet->iValue(i + 1, channel) ? packet->iValue(i, channel) : packet->iValue(i + 1, channel));
-              maxim = (maxim > packet->iValue(i + 2, channel) ? maxim : packet->iValue(i + 2, channel));
-              uint16_t sam = 0;
-              if (i >= m_trig_sub_delay)
-              {
-                sam = i - m_trig_sub_delay;
-              }
-              else
-              {
-                sam = 0;
-              }
-              unsigned int sub = 0;
-              if (maxim > packet->iValue(sam, channel))
-              {
-                sub = (((uint16_t) (maxim - packet->iValue(sam, channel))) & 0x3fffU);
-              }
-
-              v_peak_sub_ped.push_back(sub);
+              fill_peak_sub_ped(peak, sample_start, sample_end, m_trig_sub_delay, [packet, channel](int i)
+                                { return packet->iValue(i, channel); });
             }
           }
-          unsigned int key = TowerInfoDefs::encode_hcal(iwave);
-          m_peak_sub_ped_hcalout[key] = v_peak_sub_ped;
           iwave++;
         }
       }
@@ -1022,40 +1021,19 @@ int CaloTriggerEmulator::process_waveforms(PHCompositeNode *topNode)
 
         for (int channel = 0; channel < nchannels; channel++)
         {
-          std::vector<unsigned int> v_peak_sub_ped;
-          if (packet->iValue(channel, "SUPPRESSED"))
+          unsigned int *peak = get_peak_sub_ped(m_peak_sub_ped_hcalin, hcal_nphi, TowerInfoDefs::encode_hcal(iwave), nsample);
+          if (peak)
           {
-            for (int i = sample_start; i < sample_end; i++)
+            if (packet->iValue(channel, "SUPPRESSED"))
             {
-              v_peak_sub_ped.push_back(0);
+              std::fill_n(peak, nsample, 0);
             }
-          }
-          else
-          {
-            for (int i = sample_start; i < sample_end; i++)
+            else
             {
-              int16_t maxim = (packet->iValue(i, channel) > packet->iValue(i + 1, channel) ? packet->iValue(i, channel) : packet->iValue(i + 1, channel));
-              maxim = (maxim > packet->iValue(i + 2, channel) ? maxim : packet->iValue(i + 2, channel));
-              uint16_t sam = 0;
-              if (i >= m_trig_sub_delay)
-              {
-                sam = i - m_trig_sub_delay;
-              }
-              else
-              {
-                sam = 0;
-              }
-              unsigned int sub = 0;
-              if (maxim > packet->iValue(sam, channel))
-              {
-                sub = (((uint16_t) (maxim - packet->iValue(sam, channel))) & 0x3fffU);
-              }
-
-              v_peak_sub_ped.push_back(sub);
+              fill_peak_sub_ped(peak, sample_start, sample_end, m_trig_sub_delay, [packet, channel](int i)
+                                { return packet->iValue(i, channel); });
             }
           }
-          unsigned int key = TowerInfoDefs::encode_hcal(iwave);
-          m_peak_sub_ped_hcalin[key] = v_peak_sub_ped;
           iwave++;
         }
       }
@@ -1081,6 +1059,7 @@ int CaloTriggerEmulator::process_sim()
     sample_start = m_trig_sample;
     sample_end = m_trig_sample + 1;
   }
+  const int nsample = sample_end - sample_start;
 
   if (m_do_emcal)
   {
@@ -1095,42 +1074,21 @@ int CaloTriggerEmulator::process_sim()
     // for each waveform, clauclate the peak - pedestal given the sub-delay setting
     for (unsigned int iwave = 0; iwave < (unsigned int) m_waveforms_emcal->size(); iwave++)
     {
-      std::vector<unsigned int> v_peak_sub_ped;
       TowerInfo *tower = m_waveforms_emcal->get_tower_at_channel(iwave);
-      unsigned int key = TowerInfoDefs::encode_emcal(iwave);
+      unsigned int *peak = get_peak_sub_ped(m_peak_sub_ped_emcal, emcal_nphi, TowerInfoDefs::encode_emcal(iwave), nsample);
+      if (!peak)
+      {
+        continue;
+      }
       if (tower->get_isZS())
       {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          v_peak_sub_ped.push_back(0);
-        }
+        std::fill_n(peak, nsample, 0);
       }
       else
       {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          int16_t maxim = (tower->get_waveform_value(i) > tower->get_waveform_value(i + 1) ? tower->get_waveform_value(i) : tower->get_waveform_value(i + 1));
-          maxim = (maxim > tower->get_waveform_value(i + 2) ? maxim : tower->get_waveform_value(i + 2));
-          uint16_t sam = 0;
-          if (i >= m_trig_sub_delay)
-          {
-            sam = i - m_trig_sub_delay;
-          }
-          else
-          {
-            sam = 0;
-          }
-          unsigned int sub = 0;
-          if (maxim > tower->get_waveform_value(sam))
-          {
-            sub = (((uint16_t) (maxim - tower->get_waveform_value(sam))) & 0x3fffU);
-          }
-
-          v_peak_sub_ped.push_back(sub);
-        }
+        fill_peak_sub_ped(peak, sample_start, sample_end, m_trig_sub_delay, [tower](int i)
+                          { return tower->get_waveform_value(i); });
       }
-      // save in global.
-      m_peak_sub_ped_emcal[key] = v_peak_sub_ped;
     }
   }
   if (m_do_hcalout)
@@ -1140,7 +1098,6 @@ int CaloTriggerEmulator::process_sim()
       std::cout << __FILE__ << "::" << __FUNCTION__ << ":: ohcal" << std::endl;
     }
 
-    std::vector<int> wave;
     // for each waveform, clauclate the peak - pedestal given the sub-delay setting
     if (!m_waveforms_hcalout->size())
     {
@@ -1149,42 +1106,21 @@ int CaloTriggerEmulator::process_sim()
 
     for (unsigned int iwave = 0; iwave < (unsigned int) m_waveforms_hcalout->size(); iwave++)
     {
-      std::vector<unsigned int> v_peak_sub_ped;
       TowerInfo *tower = m_waveforms_hcalout->get_tower_at_channel(iwave);
-      unsigned int key = TowerInfoDefs::encode_hcal(iwave);
+      unsigned int *peak = get_peak_sub_ped(m_peak_sub_ped_hcalout, hcal_nphi, TowerInfoDefs::encode_hcal(iwave), nsample);
+      if (!peak)
+      {
+        continue;
+      }
       if (tower->get_isZS())
       {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          v_peak_sub_ped.push_back(0);
-        }
+        std::fill_n(peak, nsample, 0);
       }
       else
       {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          int16_t maxim = (tower->get_waveform_value(i) > tower->get_waveform_value(i + 1) ? tower->get_waveform_value(i) : tower->get_waveform_value(i + 1));
-          maxim = (maxim > tower->get_waveform_value(i + 2) ? maxim : tower->get_waveform_value(i + 2));
-          uint16_t sam = 0;
-          if (i >= m_trig_sub_delay)
-          {
-            sam = i - m_trig_sub_delay;
-          }
-          else
-          {
-            sam = 0;
-          }
-          unsigned int sub = 0;
-          if (maxim > tower->get_waveform_value(sam))
-          {
-            sub = (((uint16_t) (maxim - tower->get_waveform_value(sam))) & 0x3fffU);
-          }
-
-          v_peak_sub_ped.push_back(sub);
-        }
+        fill_peak_sub_ped(peak, sample_start, sample_end, m_trig_sub_delay, [tower](int i)
+                          { return tower->get_waveform_value(i); });
       }
-      // save in global.
-      m_peak_sub_ped_hcalout[key] = v_peak_sub_ped;
     }
   }
   if (m_do_hcalin)
@@ -1197,75 +1133,175 @@ int CaloTriggerEmulator::process_sim()
     {
       return Fun4AllReturnCodes::EVENT_OK;
     }
-    if (Verbosity())
-    {
-      std::cout << __FILE__ << "::" << __FUNCTION__ << ":: ihcal" << std::endl;
-    }
-
-    std::vector<unsigned int> wave;
 
     // for each waveform, clauclate the peak - pedestal given the sub-delay setting
     for (unsigned int iwave = 0; iwave < (unsigned int) m_waveforms_hcalin->size(); iwave++)
     {
-      std::vector<unsigned int> v_peak_sub_ped;
       TowerInfo *tower = m_waveforms_hcalin->get_tower_at_channel(iwave);
-      unsigned int key = TowerInfoDefs::encode_hcal(iwave);
+      unsigned int *peak = get_peak_sub_ped(m_peak_sub_ped_hcalin, hcal_nphi, TowerInfoDefs::encode_hcal(iwave), nsample);
+      if (!peak)
+      {
+        continue;
+      }
       if (tower->get_isZS())
       {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          v_peak_sub_ped.push_back(0);
-        }
+        std::fill_n(peak, nsample, 0);
       }
       else
       {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          int16_t maxim = (tower->get_waveform_value(i) > tower->get_waveform_value(i + 1) ? tower->get_waveform_value(i) : tower->get_waveform_value(i + 1));
-          maxim = (maxim > tower->get_waveform_value(i + 2) ? maxim : tower->get_waveform_value(i + 2));
-          uint16_t sam = 0;
-          if (i >= m_trig_sub_delay)
-          {
-            sam = i - m_trig_sub_delay;
-          }
-          else
-          {
-            sam = 0;
-          }
-          unsigned int sub = 0;
-          if (maxim > tower->get_waveform_value(sam))
-          {
-            sub = (((uint16_t) (maxim - tower->get_waveform_value(sam))) & 0x3fffU);
-          }
-
-          v_peak_sub_ped.push_back(sub);
-        }
+        fill_peak_sub_ped(peak, sample_start, sample_end, m_trig_sub_delay, [tower](int i)
+                          { return tower->get_waveform_value(i); });
       }
-      // save in global.
-      m_peak_sub_ped_hcalin[key] = v_peak_sub_ped;
     }
   }
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
-// procedure to process the peak - pedestal into primitives.
-int CaloTriggerEmulator::process_primitives()
+// lookup tables, tower maps and masks used by the emulation, computed once per run.
+void CaloTriggerEmulator::build_tables()
 {
-  int ip;
-  int i;
-  bool mask;
-  int nsample = m_nsamples - 1;
-  if (m_trig_sample > 0)
+  m_nsamples_trigger = (m_trig_sample > 0 ? 1 : m_nsamples - 1);
+  const size_t nsample = std::max(m_nsamples_trigger, 0);
+
+  m_peak_sub_ped_emcal.assign(emcal_ntowers * nsample, 0);
+  m_peak_sub_ped_hcalin.assign(hcal_ntowers * nsample, 0);
+  m_peak_sub_ped_hcalout.assign(hcal_ntowers * nsample, 0);
+  m_sums_emcal.assign(emcal_nprimitives * calo_nsums * nsample, 0);
+  m_sums_hcalin.assign(hcal_nprimitives * calo_nsums * nsample, 0);
+  m_sums_hcalout.assign(hcal_nprimitives * calo_nsums * nsample, 0);
+  m_sums_emcal_ll1.assign(ll1_nprimitives * ll1_nsums * nsample, 0);
+  m_sums_hcal_ll1.assign(ll1_nprimitives * ll1_nsums * nsample, 0);
+  m_sums_jet.assign(ll1_nprimitives * ll1_nsums * nsample, 0);
+  m_jet_rows.assign(jet_nphi * jet_neta * nsample, 0);
+  m_jet_patches.assign(jet_nphi * jet_neta * nsample, 0);
+
+  // towers of the 2x2 sums
+  m_towers_emcal.resize(emcal_nprimitives * calo_nsums * 4);
+  for (unsigned int ip = 0; ip < emcal_nprimitives; ip++)
+  {
+    for (unsigned int isum = 0; isum < calo_nsums; isum++)
+    {
+      for (unsigned int j = 0; j < 4; j++)
+      {
+        unsigned int key = TriggerDefs::GetTowerInfoKey(TriggerDefs::DetectorId::emcalDId, ip, isum, j);
+        m_towers_emcal[(ip * calo_nsums + isum) * 4 + j] = tower_index(key, emcal_nphi);
+      }
+    }
+  }
+
+  m_towers_hcal.resize(hcal_nprimitives * calo_nsums * 4);
+  m_hcal_ll1_sums.resize(hcal_nprimitives * calo_nsums);
+  for (unsigned int ip = 0; ip < hcal_nprimitives; ip++)
   {
-    nsample = 1;
+    for (unsigned int isum = 0; isum < calo_nsums; isum++)
+    {
+      for (unsigned int j = 0; j < 4; j++)
+      {
+        unsigned int key = TriggerDefs::GetTowerInfoKey(TriggerDefs::DetectorId::hcalDId, ip, isum, j);
+        m_towers_hcal[(ip * calo_nsums + isum) * 4 + j] = tower_index(key, hcal_nphi);
+      }
+
+      // location of the 2x2 sum in the 8x8 sums, phi major
+      unsigned int sumphi = ((ip / 3) * 4) + (isum / 4);
+      unsigned int sumeta = ((ip % 3) * 4) + (isum % 4);
+      m_hcal_ll1_sums[ip * calo_nsums + isum] = (sumphi * 12) + sumeta;
+    }
   }
 
+  // hcal 8x8 sum added to each jet sum
+  m_jet_hcal_sums.resize(ll1_nprimitives * ll1_nsums);
+  for (unsigned int ip = 0; ip < ll1_nprimitives; ip++)
+  {
+    for (unsigned int isum = 0; isum < ll1_nsums; isum++)
+    {
+      unsigned int jet_sum_loc = isum;
+      if (ip >= 12)
+      {
+        jet_sum_loc = ((isum / 12) % 2) + ((isum % 12) * 2);
+      }
+      m_jet_hcal_sums[ip * ll1_nsums + isum] = (ip * ll1_nsums) + jet_sum_loc;
+    }
+  }
+
+  // fiber and channel masks
+  auto fill_masks = [this](std::vector<uint8_t> &fiber_masks, std::vector<uint8_t> &channel_masks, TriggerDefs::DetectorId detid, unsigned int nprimitives)
+  {
+    fiber_masks.resize(nprimitives);
+    channel_masks.resize(nprimitives * calo_nsums);
+    for (unsigned int ip = 0; ip < nprimitives; ip++)
+    {
+      fiber_masks[ip] = CheckFiberMasks(TriggerDefs::getTriggerPrimKey(TriggerDefs::TriggerId::noneTId, detid, TriggerDefs::PrimitiveId::calPId, ip));
+      for (unsigned int isum = 0; isum < calo_nsums; isum++)
+      {
+        channel_masks[ip * calo_nsums + isum] = CheckChannelMasks(TriggerDefs::getTriggerSumKey(TriggerDefs::TriggerId::noneTId, detid, TriggerDefs::PrimitiveId::calPId, ip, isum));
+      }
+    }
+  };
+  fill_masks(m_fiber_masks_emcal, m_channel_masks_emcal, TriggerDefs::DetectorId::emcalDId, emcal_nprimitives);
+  fill_masks(m_fiber_masks_hcalin, m_channel_masks_hcalin, TriggerDefs::DetectorId::hcalinDId, hcal_nprimitives);
+  fill_masks(m_fiber_masks_hcalout, m_channel_masks_hcalout, TriggerDefs::DetectorId::hcaloutDId, hcal_nprimitives);
+
+  m_fiber_masks_emcal_ll1.resize(ll1_nprimitives);
+  for (unsigned int ip = 0; ip < ll1_nprimitives; ip++)
+  {
+    m_fiber_masks_emcal_ll1[ip] = CheckFiberMasks(TriggerDefs::getTriggerPrimKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::jetPId, ip));
+  }
+
+  // lookup tables, already shifted to the 8 bit output
+  auto fill_lut = [this](TowerLUT &lut, bool use_default, const std::map<unsigned int, TH1 *> &histos, unsigned int nphi, unsigned int ntowers)
+  {
+    lut.stride = 0;
+    lut.table.resize(lut_size);
+    for (unsigned int lut_input = 0; lut_input < lut_size; lut_input++)
+    {
+      lut.table[lut_input] = (m_l1_adc_table[lut_input] >> 2U) & 0xffU;
+    }
+    if (use_default)
+    {
+      return;
+    }
+
+    // one table per tower, the identity for towers without histogram
+    lut.stride = lut_size;
+    lut.table.resize(ntowers * lut_size);
+    for (unsigned int tower = 1; tower < ntowers; tower++)
+    {
+      std::copy_n(lut.table.begin(), lut_size, lut.table.begin() + (tower * lut_size));
+    }
+    for (const auto &[key, histo] : histos)
+    {
+      unsigned int tower = tower_index(key, nphi);
+      if (!histo || tower >= ntowers)
+      {
+        continue;
+      }
+      uint8_t *table = lut.table.data() + (tower * lut_size);
+      for (unsigned int lut_input = 0; lut_input < lut_size; lut_input++)
+      {
+        unsigned int lut_output = ((unsigned int) histo->GetBinContent(lut_input + 1)) & 0x3ffU;
+        table[lut_input] = (lut_output >> 2U) & 0xffU;
+      }
+    }
+  };
+  fill_lut(m_lut_emcal, m_default_lut_emcal, h_emcal_lut, emcal_nphi, emcal_ntowers);
+  fill_lut(m_lut_hcalin, m_default_lut_hcalin, h_hcalin_lut, hcal_nphi, hcal_ntowers);
+  fill_lut(m_lut_hcalout, m_default_lut_hcalout, h_hcalout_lut, hcal_nphi, hcal_ntowers);
+}
+
+// procedure to process the peak - pedestal into primitives.
+int CaloTriggerEmulator::process_primitives()
+{
+  const int nsample = m_nsamples_trigger;
+
   if (Verbosity())
   {
     std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing primitives" << std::endl;
   }
 
+  const unsigned int *peak[4];
+  const uint8_t *lut[4];
+
   if (m_do_emcal)
   {
     if (Verbosity())
@@ -1273,81 +1309,47 @@ int CaloTriggerEmulator::process_primitives()
       std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing primitives:: emcal" << std::endl;
     }
 
-    ip = 0;
-
-    // get the number of primitives needed to process
-    m_n_primitives = m_prim_map[TriggerDefs::DetectorId::emcalDId];
-    for (i = 0; i < m_n_primitives; i++, ip++)
+    for (unsigned int ip = 0; ip < emcal_nprimitives; ip++)
     {
-      if (Verbosity())
-      {
-        std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing primitives:: adding " << i << std::endl;
-      }
-      unsigned int tmp = 0;
-      // get the primitive key of what we are making, in order of the packet ID and channel number
-      TriggerDefs::TriggerPrimKey primkey = TriggerDefs::getTriggerPrimKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("EMCAL"), ip);
-
-      TriggerPrimitive *primitive = m_primitives_emcal->get_primitive_at_key(primkey);
-      unsigned int sum = 0;
       // check if masked Fiber;
-      mask = CheckFiberMasks(primkey);
+      bool mask = m_fiber_masks_emcal[ip];
 
       // calculate 16 sums
-      for (int isum = 0; isum < m_n_sums; isum++)
+      for (unsigned int isum = 0; isum < calo_nsums; isum++)
       {
-        // get sum key
-        TriggerDefs::TriggerSumKey sumkey = TriggerDefs::getTriggerSumKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("EMCAL"), ip, isum);
-
-        // calculate sums for all samples, hense the vector.
-        std::vector<unsigned int> *t_sum = primitive->get_sum_at_key(sumkey);
-        t_sum->clear();
+        const unsigned int ichannel = (ip * calo_nsums) + isum;
+        unsigned int *sum = &m_sums_emcal[ichannel * nsample];
 
         // check to mask channel (if fiber masked, automatically mask the channel)
-        bool mask_channel = mask || CheckChannelMasks(sumkey);
-        for (int is = 0; is < nsample; is++)
+        // if masked, just fill with 0s
+        if (mask || m_channel_masks_emcal[ichannel])
         {
-          sum = 0;
-          unsigned int temp_sum = 0;
-
-          // if masked, just fill with 0s
-          if (!mask_channel)
-          {
-            for (int j = 0; j < 4; j++)
-            {
-              // unsigned int iwave = 64*ip + isum*4 + j;
-              unsigned int key = TriggerDefs::GetTowerInfoKey(TriggerDefs::GetDetectorId("EMCAL"), ip, isum, j);
-              unsigned int lut_input = (m_peak_sub_ped_emcal[key].at(is) >> 4U) & 0x3ffU;
+          std::fill_n(sum, nsample, 0);
+          continue;
+        }
 
-              // shift before the sum
-              if (m_default_lut_emcal)
-              {
-                tmp = (m_l1_adc_table[lut_input] >> 2U);
-              }
-              else
-              {
-                unsigned int lut_output = ((unsigned int) h_emcal_lut[key]->GetBinContent(lut_input + 1)) & 0x3ffU;
-                tmp = (lut_output >> 2U);
-              }
-              temp_sum += (tmp & 0xffU);
-            }
-            // shift after the sum
-            sum = ((temp_sum & 0x3ffU) >> 2U) & 0xffU;
+        for (int j = 0; j < 4; j++)
+        {
+          unsigned int tower = m_towers_emcal[(ichannel * 4) + j];
+          peak[j] = &m_peak_sub_ped_emcal[tower * nsample];
+          lut[j] = m_lut_emcal.get(tower);
+        }
 
-            // sum is now 8 bits and sends it all to the LL1
-            if (Verbosity() >= 10 && sum >= 1)
-            {
-              std::cout << __FILE__ << "::" << __FUNCTION__ << ":: emcal sum " << sumkey << " = " << sum << std::endl;
-            }
-          }
-          if (Verbosity())
-          {
-            std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing primitives:: adding" << std::endl;
-          }
+        // LUT outputs are 8 bits, shift after the sum
+        // sum is now 8 bits and sends it all to the LL1
+        sum_towers(sum, peak, lut, nsample, 0x3ffU);
 
-          t_sum->push_back(sum);
+        if (Verbosity() >= 10)
+        {
+          print_sums("emcal", TriggerDefs::getTriggerSumKey(TriggerDefs::TriggerId::noneTId, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, ip, isum), sum, nsample);
         }
       }
     }
+
+    if (m_write_primitives)
+    {
+      fill_primitives(m_primitives_emcal, m_sums_emcal, nsample);
+    }
   }
   if (m_do_hcalout)
   {
@@ -1356,109 +1358,82 @@ int CaloTriggerEmulator::process_primitives()
       std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing primitives:: ohcal" << std::endl;
     }
 
-    ip = 0;
-
-    m_n_primitives = m_prim_map[TriggerDefs::DetectorId::hcaloutDId];
-
-    for (i = 0; i < m_n_primitives; i++, ip++)
+    for (unsigned int ip = 0; ip < hcal_nprimitives; ip++)
     {
-      TriggerDefs::TriggerPrimKey primkey = TriggerDefs::getTriggerPrimKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("HCALOUT"), TriggerDefs::GetPrimitiveId("HCALOUT"), ip);
-      TriggerPrimitive *primitive = m_primitives_hcalout->get_primitive_at_key(primkey);
-      unsigned int sum;
-      mask = CheckFiberMasks(primkey);
-      for (int isum = 0; isum < m_n_sums; isum++)
+      // a masked channel also masks the following sums of the primitive
+      bool mask = m_fiber_masks_hcalout[ip];
+      for (unsigned int isum = 0; isum < calo_nsums; isum++)
       {
-        TriggerDefs::TriggerSumKey sumkey = TriggerDefs::getTriggerSumKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("HCALOUT"), TriggerDefs::GetPrimitiveId("HCALOUT"), ip, isum);
-        std::vector<unsigned int> *t_sum = primitive->get_sum_at_key(sumkey);
-        mask |= CheckChannelMasks(sumkey);
-        for (int is = 0; is < nsample; is++)
+        const unsigned int ichannel = (ip * calo_nsums) + isum;
+        unsigned int *sum = &m_sums_hcalout[ichannel * nsample];
+        mask |= m_channel_masks_hcalout[ichannel];
+        if (mask)
         {
-          sum = 0;
-          unsigned int temp_sum = 0;
-          if (!mask)
-          {
-            for (int j = 0; j < 4; j++)
-            {
-              unsigned int key = TriggerDefs::GetTowerInfoKey(TriggerDefs::GetDetectorId("HCAL"), ip, isum, j);
-              unsigned int lut_input = (m_peak_sub_ped_hcalout[key].at(is) >> 4U) & 0x3ffU;
-              unsigned int tmp = 0;
-              if (m_default_lut_hcalout)
-              {
-                tmp = (m_l1_adc_table[lut_input] >> 2U);
-              }
-              else
-              {
-                unsigned int lut_output = ((unsigned int) h_hcalout_lut[key]->GetBinContent(lut_input + 1)) & 0x3ffU;
-                tmp = (lut_output >> 2U);
-              }
-              temp_sum += (tmp & 0xffU);
-            }
-            sum = ((temp_sum & 0x3ffU) >> 2U) & 0xffU;
+          std::fill_n(sum, nsample, 0);
+          continue;
+        }
 
-            if (Verbosity() >= 10 && sum >= 1)
-            {
-              std::cout << __FILE__ << "::" << __FUNCTION__ << ":: hcalout sum " << sumkey << " = " << sum << std::endl;
-            }
-          }
-          t_sum->push_back(sum);
+        for (int j = 0; j < 4; j++)
+        {
+          unsigned int tower = m_towers_hcal[(ichannel * 4) + j];
+          peak[j] = &m_peak_sub_ped_hcalout[tower * nsample];
+          lut[j] = m_lut_hcalout.get(tower);
+        }
+        sum_towers(sum, peak, lut, nsample, 0x3ffU);
+
+        if (Verbosity() >= 10)
+        {
+          print_sums("hcalout", TriggerDefs::getTriggerSumKey(TriggerDefs::TriggerId::noneTId, TriggerDefs::DetectorId::hcaloutDId, TriggerDefs::PrimitiveId::calPId, ip, isum), sum, nsample);
         }
       }
     }
+
+    if (m_write_primitives)
+    {
+      fill_primitives(m_primitives_hcalout, m_sums_hcalout, nsample);
+    }
   }
   if (m_do_hcalin)
   {
-    ip = 0;
-
     if (Verbosity())
     {
       std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing primitives:: ihcal" << std::endl;
     }
 
-    m_n_primitives = m_prim_map[TriggerDefs::DetectorId::hcalinDId];
-
-    for (i = 0; i < m_n_primitives; i++, ip++)
+    for (unsigned int ip = 0; ip < hcal_nprimitives; ip++)
     {
-      TriggerDefs::TriggerPrimKey primkey = TriggerDefs::getTriggerPrimKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("HCALIN"), TriggerDefs::GetPrimitiveId("HCALIN"), ip);
-      TriggerPrimitive *primitive = m_primitives_hcalin->get_primitive_at_key(primkey);
-      unsigned int sum;
-      mask = CheckFiberMasks(primkey);
-      for (int isum = 0; isum < m_n_sums; isum++)
+      // a masked channel also masks the following sums of the primitive
+      bool mask = m_fiber_masks_hcalin[ip];
+      for (unsigned int isum = 0; isum < calo_nsums; isum++)
       {
-        TriggerDefs::TriggerSumKey sumkey = TriggerDefs::getTriggerSumKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("HCALIN"), TriggerDefs::GetPrimitiveId("HCALIN"), ip, isum);
-        std::vector<unsigned int> *t_sum = primitive->get_sum_at_key(sumkey);
-        mask |= CheckChannelMasks(sumkey);
-        for (int is = 0; is < nsample; is++)
+        const unsigned int ichannel = (ip * calo_nsums) + isum;
+        unsigned int *sum = &m_sums_hcalin[ichannel * nsample];
+        mask |= m_channel_masks_hcalin[ichannel];
+        if (mask)
         {
-          sum = 0;
-          unsigned int temp_sum = 0;
-          if (!mask)
-          {
-            for (int j = 0; j < 4; j++)
-            {
-              unsigned int key = TriggerDefs::GetTowerInfoKey(TriggerDefs::GetDetectorId("HCAL"), ip, isum, j);
-              unsigned int lut_input = (m_peak_sub_ped_hcalin[key].at(is) >> 4U) & 0x3ffU;
-              unsigned int tmp = 0;
-              if (m_default_lut_hcalin)
-              {
-                tmp = (m_l1_adc_table[lut_input] >> 2U);
-              }
-              else
-              {
-                unsigned int lut_output = ((unsigned int) h_hcalin_lut[key]->GetBinContent(lut_input + 1)) & 0x3ffU;
-                tmp = (lut_output >> 2U);
-              }
-              temp_sum += (tmp & 0x3ffU);
-            }
-            sum = ((temp_sum & 0xfffU) >> 2U) & 0xffU;
-            if (Verbosity() >= 10 && sum >= 1)
-            {
-              std::cout << __FILE__ << "::" << __FUNCTION__ << ":: hcalin sum " << sumkey << " = " << sum << std::endl;
-            }
-          }
-          t_sum->push_back(sum);
+          std::fill_n(sum, nsample, 0);
+          continue;
+        }
+
+        for (int j = 0; j < 4; j++)
+        {
+          unsigned int tower = m_towers_hcal[(ichannel * 4) + j];
+          peak[j] = &m_peak_sub_ped_hcalin[tower * nsample];
+          lut[j] = m_lut_hcalin.get(tower);
+        }
+        sum_towers(sum, peak, lut, nsample, 0xfffU);
+
+        if (Verbosity() >= 10)
+        {
+          print_sums("hcalin", TriggerDefs::getTriggerSumKey(TriggerDefs::TriggerId::noneTId, TriggerDefs::DetectorId::hcalinDId, TriggerDefs::PrimitiveId::calPId, ip, isum), sum, nsample);
         }
       }
     }
+
+    if (m_write_primitives)
+    {
+      fill_primitives(m_primitives_hcalin, m_sums_hcalin, nsample);
+    }
   }
 
   return Fun4AllReturnCodes::EVENT_OK;
@@ -1466,21 +1441,18 @@ int CaloTriggerEmulator::process_primitives()
 
 // Unless this is the MBD or HCAL Cosmics trigger, EMCAL and HCAL will go through here.
 // This creates the 8x8 non-overlapping sum and the 4x4 overlapping sum.
+// The 8x8 sums and the jet sums are stored phi major, 32 x 12 sums
+// (or 16 jet primitives of 24 sums, in the order of the sum keys).
 
 int CaloTriggerEmulator::process_organizer()
 {
-  TriggerPrimitiveContainer::Range range;
   if (Verbosity())
   {
     std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing organizer" << std::endl;
   }
 
-  int nsample = m_nsamples - 1;
-  // bits are to say whether the trigger has fired. this is what is sent to the GL1
-  if (m_trig_sample > 0)
-  {
-    nsample = 1;
-  }
+  const int nsample = m_nsamples_trigger;
+
   // 8x8 non-overlapping sums in the EMCAL
   // create the 8x8 non-overlapping sum
   {
@@ -1491,84 +1463,43 @@ int CaloTriggerEmulator::process_organizer()
 
     m_triggerid = TriggerDefs::TriggerId::jetTId;
 
-    if (!m_primitives_emcal)
+    if (!m_do_emcal)
     {
       std::cout << "There is no primitive container" << std::endl;
       return Fun4AllReturnCodes::EVENT_OK;
     }
 
-    range = m_primitives_emcal_ll1->getTriggerPrimitives();
-    for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
-    {
-      TriggerPrimitivev1::Range sumrange = iter->second->getSums();
-      for (TriggerPrimitivev1::Iter siter = sumrange.first; siter != sumrange.second; ++siter)
-      {
-        for (int is = 0; is < nsample; is++)
-        {
-          siter->second->push_back(0);
-        }
-      }
-    }
-
-    if (Verbosity())
-    {
-      std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing getting emcal prims" << std::endl;
-    }
-
     // iterate through emcal primitives and organize into the 16 jet primitives each with the 8x8 nonoverlapping sum
-    range = m_primitives_emcal->getTriggerPrimitives();
-
-    for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
+    // with sumphi = ip / 12 and sumeta = ip % 12, the 8x8 sum has the index of the emcal primitive
+    for (unsigned int ip = 0; ip < emcal_nprimitives; ip++)
     {
-      // get key and see if masked
-      TriggerDefs::TriggerPrimKey key = (*iter).first;
-      if (CheckFiberMasks(key))
+      unsigned int *t_sum = &m_sums_emcal_ll1[ip * nsample];
+      std::fill_n(t_sum, nsample, 0);
+
+      if (m_fiber_masks_emcal[ip])
       {
         continue;
       }
 
-      uint16_t sumphi = TriggerDefs::getPrimitivePhiId_from_TriggerPrimKey(key);
-      uint16_t sumeta = TriggerDefs::getPrimitiveEtaId_from_TriggerPrimKey(key);
-
-      // based on where the primitive is in the detector, the location of the jet primitive is determined, 0 through 15 in phi.
-      uint16_t iprim = sumphi / 2;
-      // eta determines the location of the sum within the jet primitive.
-      uint16_t isum = (sumeta + ((sumphi % 2) * 12));
-
-      TriggerDefs::TriggerPrimKey jet_prim_key = TriggerDefs::getTriggerPrimKey(m_triggerid, TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim);
-
-      TriggerDefs::TriggerPrimKey jet_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim, isum);
-
-      // add to primitive previously made the sum of the 8x8 non-overlapping sum.
-      std::vector<unsigned int> *t_sum = m_primitives_emcal_ll1->get_primitive_at_key(jet_prim_key)->get_sum_at_key(jet_sum_key);
-
-      // get the primitive (16 2x2 sums)
-      TriggerPrimitive *primitive = (*iter).second;
-      TriggerPrimitivev1::Range sumrange = primitive->getSums();
-
       // iterate through all 16 sums and add together
-      for (TriggerPrimitivev1::Iter iter_sum = sumrange.first; iter_sum != sumrange.second; ++iter_sum)
+      for (unsigned int isum = 0; isum < calo_nsums; isum++)
       {
-        if (CheckChannelMasks(iter_sum->first))
+        const unsigned int ichannel = (ip * calo_nsums) + isum;
+        if (m_channel_masks_emcal[ichannel])
         {
           continue;
         }
-        int i = 0;
-        for (unsigned int &it_s : *(*iter_sum).second)
+        const unsigned int *sum = &m_sums_emcal[ichannel * nsample];
+        for (int is = 0; is < nsample; is++)
         {
-          t_sum->at(i) += (it_s & 0xffU);
-          i++;
+          t_sum[is] += (sum[is] & 0xffU);
         }
       }
 
-      // bit shift by 16 (divide by the 16 towers) to get an 8 bit energy sum.
-      for (unsigned int &it_s : *t_sum)
+      // saturate to an 8 bit energy sum.
+      for (int is = 0; is < nsample; is++)
       {
-        // unsigned int sumshift = ((it_s >> 0x2U) & 0x3ffU);
-        // unsigned int sum_lower = ( sumshift & 0x7fU );
-        // unsigned int sum_higher = ( ( sumshift >> 0x7U ) > 0 ? 0x1U : 0x0U );
-        // it_s = m_l1_8x8_table[sumshift];
-        it_s = std::min(it_s, 0xffU);
+        t_sum[is] = std::min(t_sum[is], 0xffU);
       }
     }
   }
@@ -1578,225 +1509,69 @@ int CaloTriggerEmulator::process_organizer()
       std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing HCAL" << std::endl;
     }
 
-    range = m_primitives_hcal_ll1->getTriggerPrimitives();
-    for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
-    {
-      TriggerPrimitivev1::Range sumrange = iter->second->getSums();
-      for (TriggerPrimitivev1::Iter siter = sumrange.first; siter != sumrange.second; ++siter)
-      {
-        for (int is = 0; is < nsample; is++)
-        {
-          siter->second->push_back(0);
-        }
-      }
-    }
+    std::fill(m_sums_hcal_ll1.begin(), m_sums_hcal_ll1.end(), 0);
 
-    if (m_primitives_hcalin)
+    // iterate through hcal primitives and organize into the 16 jet primitives each with the 8x8 nonoverlapping sum
+    auto add_hcal = [this, nsample](const std::vector<unsigned int> &sums, const std::vector<uint8_t> &fiber_masks, const std::vector<uint8_t> &channel_masks)
     {
-      if (Verbosity())
-      {
-        std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing organizer" << std::endl;
-      }
-
-      // iterate through emcal primitives and organize into the 16 jet primitives each with the 8x8 nonoverlapping sum
-      range = m_primitives_hcalin->getTriggerPrimitives();
-
-      // for hcalin: there are
-      for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
+      for (unsigned int ip = 0; ip < hcal_nprimitives; ip++)
       {
-        // get key and see if masked
-        TriggerDefs::TriggerPrimKey key = (*iter).first;
-        if (CheckFiberMasks(key))
+        if (fiber_masks[ip])
         {
           continue;
         }
-
-        // get the primitive (16 2x2 sums)
-        TriggerPrimitive *primitive = (*iter).second;
-        TriggerPrimitivev1::Range sumrange = primitive->getSums();
-
-        for (TriggerPrimitivev1::Iter iter_sum = sumrange.first; iter_sum != sumrange.second; ++iter_sum)
+        for (unsigned int isum = 0; isum < calo_nsums; isum++)
         {
-          TriggerDefs::TriggerSumKey sumkey = (*iter_sum).first;
-          uint16_t sumphi = (TriggerDefs::getPrimitivePhiId_from_TriggerSumKey(sumkey) * 4) + TriggerDefs::getSumPhiId(sumkey);
-          uint16_t sumeta = (TriggerDefs::getPrimitiveEtaId_from_TriggerSumKey(sumkey) * 4) + TriggerDefs::getSumEtaId(sumkey);
-
-          int i = 0;
-          if (CheckChannelMasks(sumkey))
+          const unsigned int ichannel = (ip * calo_nsums) + isum;
+          if (channel_masks[ichannel])
           {
             continue;
           }
-          // based on where the primitive is in the detector, the location of the jet primitive is determined, 0 through 15 in phi.
-          uint16_t iprim = sumphi / 2;
-          // eta determines the location of the sum within the jet primitive.
-          uint16_t isum = (sumeta + ((sumphi % 2) * 12));
-
-          TriggerDefs::TriggerPrimKey jet_prim_key = TriggerDefs::getTriggerPrimKey(m_triggerid, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim);
-
-          TriggerDefs::TriggerPrimKey jet_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim, isum);
-
-          // add to primitive previously made the sum of the 8x8 non-overlapping sum.
-          std::vector<unsigned int> *t_sum = m_primitives_hcal_ll1->get_primitive_at_key(jet_prim_key)->get_sum_at_key(jet_sum_key);
-
-          for (unsigned int &it_s : *(*iter_sum).second)
+          const unsigned int *sum = &sums[ichannel * nsample];
+          unsigned int *t_sum = &m_sums_hcal_ll1[m_hcal_ll1_sums[ichannel] * nsample];
+          for (int is = 0; is < nsample; is++)
           {
-            t_sum->at(i) += ((it_s & 0xffU) >> 1U);
-            i++;
+            t_sum[is] += ((sum[is] & 0xffU) >> 1U);
           }
         }
       }
-    }
+    };
 
-    if (m_primitives_hcalout)
+    if (m_do_hcalin)
     {
-      if (Verbosity())
-      {
-        std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing organizer" << std::endl;
-      }
-
-      // iterate through emcal primitives and organize into the 16 jet primitives each with the 8x8 nonoverlapping sum
-      range = m_primitives_hcalout->getTriggerPrimitives();
-
-      // for hcalin: there are
-      for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
-      {
-        // get key and see if masked
-        TriggerDefs::TriggerPrimKey key = (*iter).first;
-        if (CheckFiberMasks(key))
-        {
-          continue;
-        }
-
-        // get the primitive (16 2x2 sums)
-        TriggerPrimitive *primitive = (*iter).second;
-        TriggerPrimitivev1::Range sumrange = primitive->getSums();
-
-        for (TriggerPrimitivev1::Iter iter_sum = sumrange.first; iter_sum != sumrange.second; ++iter_sum)
-        {
-          TriggerDefs::TriggerSumKey sumkey = (*iter_sum).first;
-          uint16_t sumphi = (TriggerDefs::getPrimitivePhiId_from_TriggerSumKey(sumkey) * 4) + TriggerDefs::getSumPhiId(sumkey);
-          //		      uint16_t sumeta = TriggerDefs::getPrimitiveEtaId_from_TriggerSumKey(sumkey)*4 + TriggerDefs::getSumEtaId(sumkey);
-          uint16_t sumeta = (TriggerDefs::getPrimitiveEtaId_from_TriggerSumKey(sumkey) * 4) + TriggerDefs::getSumEtaId(sumkey);
-
-          int i = 0;
-
-          if (CheckChannelMasks(sumkey))
-          {
-            continue;
-          }
-          // based on where the primitive is in the detector, the location of the jet primitive is determined, 0 through 15 in phi.
-          uint16_t iprim = sumphi / 2;
-          // eta determines the location of the sum within the jet primitive.
-          uint16_t isum = sumeta + ((sumphi % 2) * 12);
-          TriggerDefs::TriggerPrimKey jet_prim_key = TriggerDefs::getTriggerPrimKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim);
-
-          TriggerDefs::TriggerPrimKey jet_sum_key = TriggerDefs::getTriggerSumKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim, isum);
-          if (Verbosity())
-          {
-            std::cout << __FILE__ << "::" << __FUNCTION__ << "::" << __LINE__ << ":: Processing organizer" << std::endl;
-          }
-
-          std::vector<unsigned int> *t_sum = m_primitives_hcal_ll1->get_primitive_at_key(jet_prim_key)->get_sum_at_key(jet_sum_key);
-          for (unsigned int &it_s : *(*iter_sum).second)
-          {
-            t_sum->at(i) += ((it_s & 0xffU) >> 1U);
-            i++;
-          }
-        }
-      }
+      add_hcal(m_sums_hcalin, m_fiber_masks_hcalin, m_channel_masks_hcalin);
     }
-
-    // iterate through emcal primitives and organize into the 16 jet primitives each with the 8x8 nonoverlapping sum
-    if (Verbosity())
+    if (m_do_hcalout)
     {
-      std::cout << __FILE__ << "::" << __FUNCTION__ << "::" << __LINE__ << ":: Processing organizer" << std::endl;
+      add_hcal(m_sums_hcalout, m_fiber_masks_hcalout, m_channel_masks_hcalout);
     }
 
-    range = m_primitives_hcal_ll1->getTriggerPrimitives();
-    for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
+    for (unsigned int &it_s : m_sums_hcal_ll1)
     {
-      TriggerPrimitive *primitive = (*iter).second;
-      TriggerPrimitivev1::Range sumrange = primitive->getSums();
-
-      for (TriggerPrimitivev1::Iter iter_sum = sumrange.first; iter_sum != sumrange.second; ++iter_sum)
-      {
-        for (unsigned int &it_s : *(*iter_sum).second)
-        {
-          it_s = (it_s & 0xffU);
-        }
-      }
+      it_s = (it_s & 0xffU);
     }
 
-    {
-      range = m_primitives_jet->getTriggerPrimitives();
-      for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
-      {
-        TriggerPrimitivev1::Range sumrange = iter->second->getSums();
-        for (TriggerPrimitivev1::Iter siter = sumrange.first; siter != sumrange.second; ++siter)
-        {
-          for (int is = 0; is < nsample; is++)
-          {
-            siter->second->push_back(0);
-          }
-        }
-      }
-    }
-    if (Verbosity())
-    {
-      std::cout << __FILE__ << "::" << __FUNCTION__ << "::" << __LINE__ << ":: Processing organizer" << std::endl;
-    }
     // get jet primitives (after EMCAL and HCAL sum)
-    range = m_primitives_jet->getTriggerPrimitives();
-    for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
+    const unsigned int nsums = ll1_nprimitives * ll1_nsums;
+    for (unsigned int isum = 0; isum < nsums; isum++)
     {
-      if (Verbosity())
+      const unsigned int *sum_hcal = &m_sums_hcal_ll1[m_jet_hcal_sums[isum] * nsample];
+      const unsigned int *sum_emcal = &m_sums_emcal_ll1[isum * nsample];
+      unsigned int *sum_jet = &m_sums_jet[isum * nsample];
+      for (int is = 0; is < nsample; is++)
       {
-        std::cout << __FILE__ << "::" << __FUNCTION__ << "::" << __LINE__ << ":: Processing organizer" << std::endl;
-      }
-
-      TriggerDefs::TriggerPrimKey jet_pkey = (*iter).first;
-      TriggerDefs::TriggerPrimKey hcal_pkey = TriggerDefs::getTriggerPrimKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), TriggerDefs::getPrimitiveLocId_from_TriggerPrimKey(jet_pkey));
-      TriggerDefs::TriggerPrimKey emcal_pkey = TriggerDefs::getTriggerPrimKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("JET"), TriggerDefs::getPrimitiveLocId_from_TriggerPrimKey(jet_pkey));
-      TriggerPrimitive *primitive = (*iter).second;
-      TriggerPrimitivev1::Range sumrange = primitive->getSums();
-      for (TriggerPrimitivev1::Iter iter_sum = sumrange.first; iter_sum != sumrange.second; ++iter_sum)
-      {
-        if (Verbosity())
-        {
-          std::cout << __FILE__ << "::" << __FUNCTION__ << "::" << __LINE__ << ":: Processing organizer" << std::endl;
-        }
-
-        TriggerDefs::TriggerSumKey jet_skey = (*iter_sum).first;
-	uint16_t jet_sum_loc =  TriggerDefs::getSumLocId(jet_skey);
-	uint16_t jet_prim_loc =  TriggerDefs::getPrimitiveLocId_from_TriggerSumKey(jet_skey);
-	if (jet_prim_loc >= 12)
-	  {
-	    uint16_t sumeta = TriggerDefs::getSumEtaId(jet_skey);
-	    uint16_t sumphi = TriggerDefs::getSumPhiId(jet_skey);
-	    jet_sum_loc = sumphi%2 + sumeta*2;
-	  }
-	TriggerDefs::TriggerSumKey hcal_skey = TriggerDefs::getTriggerSumKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), TriggerDefs::getPrimitiveLocId_from_TriggerPrimKey(jet_pkey), jet_sum_loc);
-
-	
-        TriggerDefs::TriggerSumKey emcal_skey = TriggerDefs::getTriggerSumKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("JET"), TriggerDefs::getPrimitiveLocId_from_TriggerPrimKey(jet_pkey), TriggerDefs::getSumLocId(jet_skey));
-
-        int i = 0;
-        if (Verbosity())
-        {
-          std::cout << __FILE__ << "::" << __FUNCTION__ << "::" << __LINE__ << ":: Processing organizer" << std::endl;
-        }
-
-        for (unsigned int &it_s : *(iter_sum->second))
-        {
-          unsigned int sum_hcal = m_primitives_hcal_ll1->get_primitive_at_key(hcal_pkey)->get_sum_at_key(hcal_skey)->at(i);
-          unsigned int sum_emcal = m_primitives_emcal_ll1->get_primitive_at_key(emcal_pkey)->get_sum_at_key(emcal_skey)->at(i);
-          it_s = ((sum_hcal >> 1U) + (sum_emcal >> 1U)) & 0xffU;
-          i++;
-        }
+        sum_jet[is] = ((sum_hcal[is] >> 1U) + (sum_emcal[is] >> 1U)) & 0xffU;
       }
     }
   }
 
+  if (m_write_primitives)
+  {
+    fill_primitives(m_primitives_emcal_ll1, m_sums_emcal_ll1, nsample);
+    fill_primitives(m_primitives_hcal_ll1, m_sums_hcal_ll1, nsample);
+    fill_primitives(m_primitives_jet, m_sums_jet, nsample);
+  }
+
   return 0;
 }
 
@@ -1804,24 +1579,13 @@ int CaloTriggerEmulator::process_organizer()
 
 int CaloTriggerEmulator::process_trigger()
 {
-  std::vector<unsigned int> bits;
+  const int nsample = m_nsamples_trigger;
 
-  int nsample = m_nsamples - 1;
   // bits are to say whether the trigger has fired. this is what is sent to the GL1
-  if (m_trig_sample > 0)
-  {
-    nsample = 1;
-  }
-  bits.reserve(nsample);
-  for (int is = 0; is < nsample; is++)
-  {
-    bits.push_back(0);
-  }
+  std::vector<unsigned int> bits(nsample, 0);
 
   // photon
   // 8x8 non-overlapping sums in the EMCAL
-  // create the 8x8 non-overlapping sum
-
   {
     m_triggerid = TriggerDefs::TriggerId::photonTId;
     std::vector<unsigned int> *trig_bits = m_ll1out_photon->GetTriggerBits();
@@ -1830,42 +1594,30 @@ int CaloTriggerEmulator::process_trigger()
       std::cout << __FUNCTION__ << " " << __LINE__ << " processing PHOTON trigger , bits before: " << trig_bits->size() << std::endl;
     }
 
-    TriggerPrimitiveContainer::Range range = m_primitives_emcal_ll1->getTriggerPrimitives();
-
-    for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
+    for (unsigned int ip = 0; ip < ll1_nprimitives; ip++)
     {
-      // get key and see if masked
-      TriggerDefs::TriggerPrimKey key = (*iter).first;
-      if (CheckFiberMasks(key))
+      // see if masked
+      if (m_fiber_masks_emcal_ll1[ip])
       {
         continue;
       }
 
-      // get the primitive (16 2x2 sums)
-      TriggerPrimitive *primitive = (*iter).second;
+      TriggerDefs::TriggerPrimKey key = TriggerDefs::getTriggerPrimKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::jetPId, ip);
 
-      TriggerPrimitivev1::Range sumrange = primitive->getSums();
-
-      // iterate through all 24 sums and add together
-      for (TriggerPrimitivev1::Iter iter_sum = sumrange.first; iter_sum != sumrange.second; ++iter_sum)
+      // check all 24 sums against the thresholds
+      for (unsigned int isum = 0; isum < ll1_nsums; isum++)
       {
-        // check if sum is greater than threshold.
-        if (Verbosity() >= 2)
-        {
-          std::cout << __FUNCTION__ << " " << __LINE__ << " processing PHOTON trigger" << std::endl;
-        }
-
-        std::vector<unsigned int> *t_sum = (*iter_sum).second;
-        TriggerDefs::TriggerSumKey sumk = (*iter_sum).first;
+        const unsigned int *t_sum = &m_sums_emcal_ll1[((ip * ll1_nsums) + isum) * nsample];
         for (int is = 0; is < nsample; is++)
         {
-          unsigned short bit = getBits(t_sum->at(is), TriggerDefs::TriggerId::photonTId);
+          unsigned short bit = getBits(t_sum[is], TriggerDefs::TriggerId::photonTId);
           if (bit)
           {
-            m_ll1out_photon->addTriggeredSum(sumk, t_sum->at(is));
+            TriggerDefs::TriggerSumKey sumk = TriggerDefs::getTriggerSumKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::jetPId, ip, isum);
+            m_ll1out_photon->addTriggeredSum(sumk, t_sum[is]);
             m_ll1out_photon->addTriggeredPrimitive(key);
           }
-          bits.at(is) |= bit;
+          bits[is] |= bit;
         }
       }
     }
@@ -1873,8 +1625,8 @@ int CaloTriggerEmulator::process_trigger()
     uint16_t pass = 0;
     for (int is = 0; is < nsample; is++)
     {
-      pass |= bits.at(is);
-      trig_bits->push_back(bits.at(is));
+      pass |= bits[is];
+      trig_bits->push_back(bits[is]);
     }
 
     if (pass)
@@ -1888,102 +1640,67 @@ int CaloTriggerEmulator::process_trigger()
       std::cout << __FUNCTION__ << " " << __LINE__ << " processing JET trigger" << std::endl;
     }
 
-    // Make the jet primitives
+    // Make the jet patches
     m_triggerid = TriggerDefs::TriggerId::jetTId;
     std::vector<unsigned int> *trig_bits = m_ll1out_jet->GetTriggerBits();
-    std::vector<unsigned int> jet_map[32][9]{};
-    for (auto &ie : jet_map)
+
+    // 4x4 overlapping sums of the 32 x 12 jet sums, wrapping around in phi.
+    // the window is summed in eta first, then in phi
+    for (unsigned int iphi = 0; iphi < jet_nphi; iphi++)
     {
-      for (auto &ip : ie)
+      for (unsigned int ieta = 0; ieta < jet_neta; ieta++)
       {
-        for (int is = 0; is < nsample; is++)
+        unsigned int *row = &m_jet_rows[((iphi * jet_neta) + ieta) * nsample];
+        const unsigned int *sum = &m_sums_jet[((iphi * 12) + ieta) * nsample];
+        std::copy_n(sum, nsample, row);
+        for (unsigned int jeta = 1; jeta < 4; jeta++)
         {
-          ip.push_back(0);
+          sum += nsample;
+          for (int is = 0; is < nsample; is++)
+          {
+            row[is] += sum[is];
+          }
         }
       }
     }
-
-    if (!m_primitives_jet)
-    {
-      std::cout << "There is no primitive container" << std::endl;
-      return Fun4AllReturnCodes::EVENT_OK;
-    }
-
-    // iterate through emcal primitives and organize into the 16 jet primitives each with the 8x8 nonoverlapping sum
-    TriggerPrimitiveContainer::Range range = m_primitives_jet->getTriggerPrimitives();
-
-    for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
+    for (unsigned int iphi = 0; iphi < jet_nphi; iphi++)
     {
-      // get the primitive (16 2x2 sums)
-      TriggerPrimitive *primitive = (*iter).second;
-      TriggerPrimitivev1::Range sumrange = primitive->getSums();
-
-      // iterate through all 16 sums and add together
-      for (TriggerPrimitivev1::Iter iter_sum = sumrange.first; iter_sum != sumrange.second; ++iter_sum)
+      for (unsigned int ieta = 0; ieta < jet_neta; ieta++)
       {
-        TriggerDefs::TriggerSumKey sumkey = (*iter_sum).first;
-
-        int i = 0;
-        int sum_phi = static_cast<int>((TriggerDefs::getPrimitivePhiId_from_TriggerSumKey(sumkey) * 2) + TriggerDefs::getSumPhiId(sumkey));
-        int sum_eta = static_cast<int>(TriggerDefs::getSumEtaId(sumkey));
-        if (Verbosity() >= 2)
+        unsigned int *patch = &m_jet_patches[((iphi * jet_neta) + ieta) * nsample];
+        std::copy_n(&m_jet_rows[((iphi * jet_neta) + ieta) * nsample], nsample, patch);
+        for (unsigned int jphi = 1; jphi < 4; jphi++)
         {
-          std::cout << __FUNCTION__ << " " << __LINE__ << " processing JET trigger " << sum_phi << " " << sum_eta << std::endl;
-        }
-
-        for (unsigned int &it_s : *(iter_sum->second))
-        {
-          for (int ijeta = (sum_eta <= 3 ? 0 : sum_eta - 3); ijeta <= (sum_eta > 8 ? 8 : sum_eta); ijeta++)
+          const unsigned int *row = &m_jet_rows[((((iphi + jphi) % jet_nphi) * jet_neta) + ieta) * nsample];
+          for (int is = 0; is < nsample; is++)
           {
-            for (int ijphi = sum_phi - 3; ijphi <= sum_phi; ijphi++)
-            {
-              int iphi = (ijphi < 0 ? 32 + ijphi : ijphi);
-              jet_map[iphi][ijeta].at(i) += it_s;
-            }
+            patch[is] += row[is];
           }
-          i++;
         }
       }
     }
-    if (Verbosity() >= 2)
-    {
-      std::cout << __FUNCTION__ << " " << __LINE__ << " processing JET trigger" << std::endl;
-    }
 
     int pass = 0;
-    for (int ijphi = 0; ijphi < 32; ijphi++)
+    for (unsigned int ijphi = 0; ijphi < jet_nphi; ijphi++)
     {
-      for (int ijeta = 0; ijeta < 9; ijeta++)
+      for (unsigned int ijeta = 0; ijeta < jet_neta; ijeta++)
       {
-        if (Verbosity() >= 2)
-        {
-          std::cout << __FUNCTION__ << " " << __LINE__ << " processing JET trigger " << ijphi << " " << ijeta << std::endl;
-        }
-
-        unsigned int sk = ((unsigned int) ijphi & 0xffffU) + (((unsigned int) ijeta & 0xffffU) << 16U);
+        unsigned int sk = (ijphi & 0xffffU) + ((ijeta & 0xffffU) << 16U);
         std::vector<unsigned int> *sum = m_ll1out_jet->get_word(sk);
-        if (Verbosity() >= 2)
-        {
-          std::cout << __FUNCTION__ << " " << __LINE__ << " processing JET trigger " << ijphi << " " << ijeta << std::endl;
-        }
+        const unsigned int *patch = &m_jet_patches[((ijphi * jet_neta) + ijeta) * nsample];
 
         for (int is = 0; is < nsample; is++)
         {
-          if (Verbosity() >= 2)
-          {
-            std::cout << __FUNCTION__ << " " << __LINE__ << " processing JET trigger " << ijphi << " " << ijeta << std::endl;
-          }
-
-          sum->push_back(jet_map[ijphi][ijeta].at(is));
-          unsigned short bit = getBits(jet_map[ijphi][ijeta].at(is), TriggerDefs::TriggerId::jetTId);
+          sum->push_back(patch[is]);
+          unsigned short bit = getBits(patch[is], TriggerDefs::TriggerId::jetTId);
 
           if (bit)
           {
-            m_ll1out_jet->addTriggeredSum(sk, jet_map[ijphi][ijeta].at(is));
+            m_ll1out_jet->addTriggeredSum(sk, patch[is]);
             m_ll1out_jet->addTriggeredPrimitive(sk);
             pass = 1;
           }
-          bits.at(is) |= bit;
+          bits[is] |= bit;
         }
       }
     }
@@ -1994,7 +1711,7 @@ int CaloTriggerEmulator::process_trigger()
 
     for (int is = 0; is < nsample; is++)
     {
-      trig_bits->push_back(bits.at(is));
+      trig_bits->push_back(bits[is]);
     }
 
     if (pass)
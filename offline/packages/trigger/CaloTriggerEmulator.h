@@ -5,6 +5,7 @@
 
 #include <fun4all/SubsysReco.h>
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -117,6 +118,9 @@ class CaloTriggerEmulator : public SubsysReco
     return;
   }
 
+  //! fill the primitive containers (2x2, 8x8 and jet sums). The LL1Out trigger words and bits are always filled
+  void setWritePrimitives(bool write) { m_write_primitives = write; }
+
   bool CheckFiberMasks(TriggerDefs::TriggerPrimKey key);
   void LoadFiberMasks();
   void SetIsData(bool isd) { m_isdata = isd; }
@@ -125,6 +129,17 @@ class CaloTriggerEmulator : public SubsysReco
   void identify();
 
  private:
+  //! lookup tables, tower maps and masks of the emulation
+  void build_tables();
+
+  //! 8 bit LUT output for each 10 bit input, one table per tower or a single table for all towers
+  struct TowerLUT
+  {
+    std::vector<uint8_t> table;
+    unsigned int stride{0};
+    const uint8_t *get(unsigned int tower) const { return table.data() + (tower * stride); }
+  };
+
   std::string m_ll1_nodename;
   std::string m_prim_nodename;
   std::string m_waveform_nodename;
@@ -204,9 +219,49 @@ class CaloTriggerEmulator : public SubsysReco
   CDBHistos *cdbttree_hcalin{nullptr};
   CDBHistos *cdbttree_hcalout{nullptr};
 
-  std::map<unsigned int, std::vector<unsigned int>> m_peak_sub_ped_emcal{};
-  std::map<unsigned int, std::vector<unsigned int>> m_peak_sub_ped_hcalin{};
-  std::map<unsigned int, std::vector<unsigned int>> m_peak_sub_ped_hcalout{};
+  TowerLUT m_lut_emcal{};
+  TowerLUT m_lut_hcalin{};
+  TowerLUT m_lut_hcalout{};
+
+  //! emulation buffers, m_nsamples_trigger values for each tower or sum
+  //@{
+  //! peak - pedestal, towers indexed by etabin * nphi + phibin
+  std::vector<unsigned int> m_peak_sub_ped_emcal{};
+  std::vector<unsigned int> m_peak_sub_ped_hcalin{};
+  std::vector<unsigned int> m_peak_sub_ped_hcalout{};
+
+  //! 2x2 sums, 16 per primitive
+  std::vector<unsigned int> m_sums_emcal{};
+  std::vector<unsigned int> m_sums_hcalin{};
+  std::vector<unsigned int> m_sums_hcalout{};
+
+  //! 8x8 sums and jet sums, 24 per jet primitive
+  std::vector<unsigned int> m_sums_emcal_ll1{};
+  std::vector<unsigned int> m_sums_hcal_ll1{};
+  std::vector<unsigned int> m_sums_jet{};
+
+  //! 4x4 jet patches, and their sums over eta
+  std::vector<unsigned int> m_jet_patches{};
+  std::vector<unsigned int> m_jet_rows{};
+  //@}
+
+  //! towers of the 2x2 sums
+  std::vector<unsigned int> m_towers_emcal{};
+  std::vector<unsigned int> m_towers_hcal{};
+
+  //! 8x8 sum of each hcal 2x2 sum, hcal 8x8 sum of each jet sum
+  std::vector<unsigned int> m_hcal_ll1_sums{};
+  std::vector<unsigned int> m_jet_hcal_sums{};
+
+  std::vector<uint8_t> m_fiber_masks_emcal{};
+  std::vector<uint8_t> m_fiber_masks_hcalin{};
+  std::vector<uint8_t> m_fiber_masks_hcalout{};
+  std::vector<uint8_t> m_fiber_masks_emcal_ll1{};
+  std::vector<uint8_t> m_channel_masks_emcal{};
+  std::vector<uint8_t> m_channel_masks_hcalin{};
+  std::vector<uint8_t> m_channel_masks_hcalout{};
+
+  bool m_write_primitives{true};
 
   //! Verbosity.
   int m_nevent{0};
@@ -218,6 +273,7 @@ class CaloTriggerEmulator : public SubsysReco
   int m_n_primitives;
   int m_trig_sub_delay;
   int m_trig_sample{-1};
+  int m_nsamples_trigger{0};
 
   unsigned int m_threshold{1};
   unsigned int m_threshold_jet[4] = {0};
@@ -3,14 +3,13 @@
 
 // an iterator to loop over all the TrkrClusters for a given track
 #include <trackbase/TrkrDefs.h>
-#include <set>
+#include <trackbase_historic/TrackSeed.h>
 
 class SvtxTrack;
 
 struct ClusKeyIter
 {
-  typedef std::set<TrkrDefs::cluskey> ClusterKeySet;
-  typedef ClusterKeySet::iterator ClusterKeyIter;
+  typedef TrackSeed::ConstClusterKeyIter ClusterKeyIter;
 
   ClusKeyIter(SvtxTrack* _track);
   // data
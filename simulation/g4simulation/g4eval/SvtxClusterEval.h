@@ -2,6 +2,7 @@
 #define G4EVAL_SVTXCLUSTEREVAL_H
 
 #include "SvtxHitEval.h"
+#include "SvtxTruthRelationTable.h"
 
 #include <trackbase/ActsGeometry.h>
 #include <trackbase/TrkrDefs.h>
@@ -49,6 +50,9 @@ class SvtxClusterEval
     _hiteval.set_verbosity(verbosity);
   }
 
+  //! number of threads used to fill the cluster/truth relations, 1 by default. 0 uses the OpenMP default
+  void set_num_threads(int nthreads) { _nthreads = nthreads; }
+
   // access the clustereval (and its cached values)
   SvtxHitEval* get_hit_eval() { return &_hiteval; }
   SvtxTruthEval* get_truth_eval() { return _hiteval.get_truth_eval(); }
@@ -82,7 +86,7 @@ class SvtxClusterEval
 
   std::pair<TrkrDefs::cluskey, TrkrCluster*> reco_cluster_from_truth_cluster(TrkrDefs::cluskey, const std::shared_ptr<TrkrCluster>& gclus);
 
-  unsigned int get_errors() { return _errors + _hiteval.get_errors(); }
+  unsigned int get_errors() { return _errors + _relations.get_errors() + _hiteval.get_errors(); }
 
  private:
   void get_node_pointers(PHCompositeNode* topNode);
@@ -90,6 +94,9 @@ class SvtxClusterEval
   //  void fill_g4hit_layer_map();
   bool has_node_pointers();
 
+  //! cluster/g4hit/particle relations, filled on first use in each event
+  const SvtxTruthRelationTable& relations();
+
   //! Fast approximation of atan2() for cluster searching
   //! From https://www.dsprelated.com/showarticle/1052.php
   float fast_approx_atan2(float y, float x);
@@ -113,15 +120,16 @@ class SvtxClusterEval
   Acts::Vector3 getGlobalPosition(TrkrDefs::cluskey cluster_key, TrkrCluster* cluster);
 
   bool _do_cache = true;
-  std::map<TrkrDefs::cluskey, std::set<PHG4Hit*>> _cache_all_truth_hits;
+  int _nthreads = 1;
+
+  //! replaces the per cluster, per g4hit and per particle caches
+  SvtxTruthRelationTable _relations;
+
   std::map<TrkrDefs::cluskey, std::map<TrkrDefs::cluskey, std::shared_ptr<TrkrCluster>>> _cache_all_truth_clusters;
   std::map<TrkrDefs::cluskey, PHG4Hit*> _cache_max_truth_hit_by_energy;
   std::map<TrkrDefs::cluskey, std::pair<TrkrDefs::cluskey, std::shared_ptr<TrkrCluster>>> _cache_max_truth_cluster_by_energy;
-  std::map<TrkrDefs::cluskey, std::set<PHG4Particle*>> _cache_all_truth_particles;
   std::map<TrkrDefs::cluskey, PHG4Particle*> _cache_max_truth_particle_by_energy;
   std::map<TrkrDefs::cluskey, PHG4Particle*> _cache_max_truth_particle_by_cluster_energy;
-  std::map<PHG4Particle*, std::set<TrkrDefs::cluskey>> _cache_all_clusters_from_particle;
-  std::map<PHG4Hit*, std::set<TrkrDefs::cluskey>> _cache_all_clusters_from_g4hit;
   std::map<PHG4Hit*, TrkrDefs::cluskey> _cache_best_cluster_from_g4hit;
   std::map<std::pair<int, int>, TrkrDefs::cluskey> _cache_best_cluster_from_gtrackid_layer;
   std::map<std::pair<TrkrDefs::cluskey, PHG4Particle*>, float> _cache_get_energy_contribution_g4particle;
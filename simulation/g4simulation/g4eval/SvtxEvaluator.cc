@@ -3729,7 +3729,7 @@ void SvtxEvaluator::fillOutputNtuples(PHCompositeNode* topNode)
           tpthe = tpcseed->get_theta();
           tpx0 = tpcseed->get_X0();
           tpy0 = tpcseed->get_Y0();
-          for (SvtxTrack::ConstClusterKeyIter local_iter = tpcseed->begin_cluster_keys();
+          for (TrackSeed::ConstClusterKeyIter local_iter = tpcseed->begin_cluster_keys();
                local_iter != tpcseed->end_cluster_keys();
                ++local_iter)
           {
@@ -3855,7 +3855,7 @@ void SvtxEvaluator::fillOutputNtuples(PHCompositeNode* topNode)
           sithe = silseed->get_theta();
           six0 = silseed->get_X0();
           siy0 = silseed->get_Y0();
-          for (SvtxTrack::ConstClusterKeyIter local_iter = silseed->begin_cluster_keys();
+          for (TrackSeed::ConstClusterKeyIter local_iter = silseed->begin_cluster_keys();
                local_iter != silseed->end_cluster_keys();
                ++local_iter)
           {
@@ -0,0 +1,131 @@
+#include "SvtxTruthRelationTable.h"
+
+#include <trackbase/TrkrClusterContainer.h>
+#include <trackbase/TrkrClusterHitAssoc.h>
+#include <trackbase/TrkrHitTruthAssoc.h>
+
+#include <g4main/PHG4Hit.h>
+#include <g4main/PHG4HitContainer.h>
+#include <g4main/PHG4TruthInfoContainer.h>
+
+#include <omp.h>
+
+void SvtxTruthRelationTable::clear()
+{
+  m_cluster_g4hits.clear();
+  m_cluster_particles.clear();
+  m_g4hit_clusters.clear();
+  m_particle_clusters.clear();
+  m_built = false;
+  m_errors = 0;
+}
+
+void SvtxTruthRelationTable::build(
+    TrkrClusterContainer* clustermap,
+    TrkrClusterHitAssoc* cluster_hit_map,
+    TrkrHitTruthAssoc* hit_truth_map,
+    const G4HitContainers& g4hitcontainers,
+    PHG4TruthInfoContainer* truthinfo,
+    int nthreads)
+{
+  clear();
+  m_built = true;
+
+  if (!clustermap || !cluster_hit_map || !hit_truth_map)
+  {
+    return;
+  }
+
+  // list all clusters
+  std::vector<TrkrDefs::cluskey> cluster_keys;
+  cluster_keys.reserve(clustermap->size());
+  for (const auto& hitsetkey : clustermap->getHitSetKeys())
+  {
+    const auto range = clustermap->getClusters(hitsetkey);
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+      cluster_keys.push_back(iter->first);
+    }
+  }
+
+  // find the g4hits of each cluster
+  // associations and g4hit containers are only read, so that clusters can be processed in parallel
+  std::vector<std::vector<PHG4Hit*>> cluster_g4hits(cluster_keys.size());
+  if (nthreads <= 0)
+  {
+    nthreads = omp_get_max_threads();
+  }
+
+#pragma omp parallel num_threads(nthreads)
+  {
+    TrkrHitTruthAssoc::MMap temp_map;
+    TrkrClusterHitAssoc::HitKeyList hitkeys;
+
+#pragma omp for schedule(dynamic, 64)
+    for (size_t i = 0; i < cluster_keys.size(); ++i)
+    {
+      const auto& cluster_key = cluster_keys[i];
+      const TrkrDefs::hitsetkey hitsetkey = TrkrDefs::getHitSetKeyFromClusKey(cluster_key);
+      const unsigned int trkrid = TrkrDefs::getTrkrId(hitsetkey);
+      auto* container = trkrid < g4hitcontainers.size() ? g4hitcontainers[trkrid] : nullptr;
+      if (!container)
+      {
+        continue;
+      }
+
+      hitkeys.clear();
+      cluster_hit_map->getHitKeys(cluster_key, hitkeys);
+      for (const auto& hitkey : hitkeys)
+      {
+        temp_map.clear();
+        hit_truth_map->getG4Hits(hitsetkey, hitkey, temp_map);
+        for (const auto& htiter : temp_map)
+        {
+          if (auto* g4hit = container->findHit(htiter.second.second))
+          {
+            cluster_g4hits[i].push_back(g4hit);
+          }
+        }
+      }
+    }
+  }
+
+  // fill relations
+  std::vector<std::pair<TrkrDefs::cluskey, PHG4Hit*>> cluster_g4hit_pairs;
+  std::vector<std::pair<PHG4Hit*, TrkrDefs::cluskey>> g4hit_cluster_pairs;
+  for (size_t i = 0; i < cluster_keys.size(); ++i)
+  {
+    for (auto* g4hit : cluster_g4hits[i])
+    {
+      cluster_g4hit_pairs.emplace_back(cluster_keys[i], g4hit);
+      g4hit_cluster_pairs.emplace_back(g4hit, cluster_keys[i]);
+    }
+  }
+
+  m_cluster_g4hits.fill(cluster_g4hit_pairs);
+  m_g4hit_clusters.fill(g4hit_cluster_pairs);
+
+  // particles, from the now unique cluster/g4hit pairs
+  // one indexed lookup per pair, cheap compared to the g4hit search above, so this stays serial
+  std::vector<std::pair<TrkrDefs::cluskey, PHG4Particle*>> cluster_particle_pairs;
+  std::vector<std::pair<PHG4Particle*, TrkrDefs::cluskey>> particle_cluster_pairs;
+  if (truthinfo)
+  {
+    cluster_particle_pairs.reserve(cluster_g4hit_pairs.size());
+    particle_cluster_pairs.reserve(cluster_g4hit_pairs.size());
+    for (const auto& [cluster_key, g4hit] : cluster_g4hit_pairs)
+    {
+      auto* particle = truthinfo->GetParticle(g4hit->get_trkid());
+      if (!particle)
+      {
+        ++m_errors;
+        continue;
+      }
+      cluster_particle_pairs.emplace_back(cluster_key, particle);
+      particle_cluster_pairs.emplace_back(particle, cluster_key);
+    }
+  }
+
+  m_cluster_particles.fill(cluster_particle_pairs);
+  m_particle_clusters.fill(particle_cluster_pairs);
+}
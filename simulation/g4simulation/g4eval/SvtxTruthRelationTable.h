@@ -0,0 +1,130 @@
+#ifndef G4EVAL_SVTXTRUTHRELATIONTABLE_H
+#define G4EVAL_SVTXTRUTHRELATIONTABLE_H
+
+#include <trackbase/TrkrDefs.h>
+
+#include <algorithm>
+#include <span>
+#include <utility>
+#include <vector>
+
+class PHG4Hit;
+class PHG4HitContainer;
+class PHG4Particle;
+class PHG4TruthInfoContainer;
+class TrkrClusterContainer;
+class TrkrClusterHitAssoc;
+class TrkrHitTruthAssoc;
+
+/*!
+ * flat many-to-many relations between reco clusters, g4hits and truth particles
+ * built once per event from the cluster-hit and hit-truth associations.
+ *
+ * each relation is stored as a sorted list of keys, a list of offsets and a flat list of values,
+ * so that lookups are a binary search and return a contiguous range.
+ * values are sorted (pointers by address, clusters by key), consistently with the std::set based
+ * interfaces of SvtxClusterEval
+ */
+class SvtxTruthRelationTable
+{
+ public:
+  //! g4hit containers, indexed by TrkrDefs::TrkrId
+  using G4HitContainers = std::vector<PHG4HitContainer*>;
+
+  //! fill all relations from the nodes
+  /*! the cluster to g4hit lookup runs in parallel over clusters, nthreads <= 0 uses the OpenMP default */
+  void build(TrkrClusterContainer*, TrkrClusterHitAssoc*, TrkrHitTruthAssoc*,
+             const G4HitContainers&, PHG4TruthInfoContainer*, int nthreads = 0);
+
+  //! clear all relations
+  void clear();
+
+  //! true if the relations have been built for the current event
+  bool is_built() const { return m_built; }
+
+  //! number of g4hits for which no truth particle was found
+  unsigned int get_errors() const { return m_errors; }
+
+  //!@name relations
+  //@{
+  std::span<PHG4Hit* const> g4hits(TrkrDefs::cluskey ckey) const
+  {
+    return m_cluster_g4hits.find(ckey);
+  }
+
+  std::span<PHG4Particle* const> particles(TrkrDefs::cluskey ckey) const
+  {
+    return m_cluster_particles.find(ckey);
+  }
+
+  std::span<const TrkrDefs::cluskey> clusters(PHG4Hit* g4hit) const
+  {
+    return m_g4hit_clusters.find(g4hit);
+  }
+
+  std::span<const TrkrDefs::cluskey> clusters(PHG4Particle* particle) const
+  {
+    return m_particle_clusters.find(particle);
+  }
+  //@}
+
+ private:
+  //! compressed sparse rows
+  template <class Key, class Value>
+  class Relation
+  {
+   public:
+    void clear()
+    {
+      m_keys.clear();
+      m_offsets.clear();
+      m_values.clear();
+    }
+
+    //! fill from (key, value) pairs. Pairs are sorted and duplicates removed
+    void fill(std::vector<std::pair<Key, Value>>& pairs)
+    {
+      std::sort(pairs.begin(), pairs.end());
+      pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+      clear();
+      m_values.reserve(pairs.size());
+      for (const auto& [key, value] : pairs)
+      {
+        if (m_keys.empty() || m_keys.back() != key)
+        {
+          m_keys.push_back(key);
+          m_offsets.push_back(m_values.size());
+        }
+        m_values.push_back(value);
+      }
+      m_offsets.push_back(m_values.size());
+    }
+
+    std::span<const Value> find(const Key& key) const
+    {
+      const auto iter = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+      if (iter == m_keys.end() || *iter != key)
+      {
+        return {};
+      }
+      const auto index = iter - m_keys.begin();
+      return {m_values.data() + m_offsets[index], m_values.data() + m_offsets[index + 1]};
+    }
+
+   private:
+    std::vector<Key> m_keys;
+    std::vector<size_t> m_offsets;
+    std::vector<Value> m_values;
+  };
+
+  Relation<TrkrDefs::cluskey, PHG4Hit*> m_cluster_g4hits;
+  Relation<TrkrDefs::cluskey, PHG4Particle*> m_cluster_particles;
+  Relation<PHG4Hit*, TrkrDefs::cluskey> m_g4hit_clusters;
+  Relation<PHG4Particle*, TrkrDefs::cluskey> m_particle_clusters;
+
+  bool m_built = false;
+  unsigned int m_errors = 0;
+};
+
+#endif  // G4EVAL_SVTXTRUTHRELATIONTABLE_H
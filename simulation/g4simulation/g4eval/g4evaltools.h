@@ -2,6 +2,7 @@
 #define G4EVAL_G4EVALTOOLS_H
 
 #include <trackbase/TrkrDefs.h>
+#include <trackbase_historic/TrackSeed.h>
 
 #include <fun4all/Fun4AllReturnCodes.h>
 
@@ -99,8 +100,7 @@ namespace G4Eval
   // }
   struct ClusKeyIter
   {
-    typedef std::set<TrkrDefs::cluskey> ClusterKeySet;
-    typedef ClusterKeySet::iterator ClusterKeyIter;
+    typedef TrackSeed::ConstClusterKeyIter ClusterKeyIter;
 
     ClusKeyIter(SvtxTrack* _track);
     // data
@@ -7,7 +7,6 @@
 
 #include "PHG4Hit.h"  // for PHG4Hit
 #include "PHG4HitContainer.h"
-#include "PHG4Hitv1.h"
 #include "PHG4Particle.h"  // for PHG4Particle
 #include "PHG4Particlev3.h"
 #include "PHG4TruthInfoContainer.h"
@@ -29,17 +28,96 @@
 
 #include <HepMC/GenEvent.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <map>
+#include <string>
 #include <utility>
+#include <vector>
 
 // convenient aliases for deep copying nodes
 namespace
 {
   using PHG4Particle_t = PHG4Particlev3;
   using PHG4VtxPoint_t = PHG4VtxPointv1;
-  using PHG4Hit_t = PHG4Hitv1;
+
+  //! correspondance between source index and destination index for vertices or tracks of a background event
+  /**
+   * destination ids are compact: they follow the last id of the merged event in the order of the source ids.
+   * when the source ids are dense (events from geant) the correspondance is stored in a table indexed by source id,
+   * otherwise (sparse ids, e.g. from an already merged file) it falls back to a map, so that memory stays bounded.
+   * ids are not shifted by a fixed offset: sparse source ids would leave the same gaps in the merged event,
+   * and the merged ids would grow with every background event instead of with the number of particles
+   */
+  class IdConversion
+  {
+   public:
+    explicit IdConversion(const std::string &name)
+      : m_name(name)
+    {
+    }
+
+    //! prepare for count source ids in [min_id, max_id]
+    void reset(const int min_id, const int max_id, const size_t count)
+    {
+      m_map.clear();
+      m_table.clear();
+      m_min = std::min(min_id, 0);
+      const int64_t range = static_cast<int64_t>(std::max(max_id, 0)) - m_min + 1;
+      m_dense = range <= static_cast<int64_t>(2 * count + 1024);
+      if (m_dense)
+      {
+        m_table.assign(static_cast<size_t>(range), 0);
+      }
+    }
+
+    void insert(const int source, const int dest)
+    {
+      if (m_dense)
+      {
+        m_table[source - m_min] = dest;
+      }
+      else
+      {
+        m_map.insert(std::make_pair(source, dest));
+      }
+    }
+
+    //! destination id, 0 if the source id was not converted
+    int find(const int source) const
+    {
+      if (m_dense)
+      {
+        const int64_t index = static_cast<int64_t>(source) - m_min;
+        return (index >= 0 && index < static_cast<int64_t>(m_table.size())) ? m_table[index] : 0;
+      }
+      const auto iter = m_map.find(source);
+      return iter == m_map.end() ? 0 : iter->second;
+    }
+
+    //! destination id. The source id is returned, with a message, if it was not converted
+    int convert(const int source) const
+    {
+      const int dest = find(source);
+      if (dest == 0)
+      {
+        std::cout << "Fun4AllDstPileupMerger::copy_background_event - " << m_name << " id " << source << " not found in map" << std::endl;
+        return source;
+      }
+      return dest;
+    }
+
+   private:
+    std::string m_name;
+    bool m_dense = true;
+    int m_min = 0;
+    std::vector<int> m_table;
+    std::map<int, int> m_map;
+  };
 
   //! utility class to find all PHG4Hit container nodes from the DST node
   class FindG4HitContainer : public PHNodeOperation
@@ -141,26 +219,31 @@ void Fun4AllDstPileupMerger::copy_background_event(PHCompositeNode *dstNode, dou
   }
 
   // copy truth container
-  // keep track of the correspondance between source index and destination index for vertices, tracks and showers
-  using ConversionMap = std::map<int, int>;
-  ConversionMap vtxid_map;
-  ConversionMap trkid_map;
+  // keep track of the correspondance between source index and destination index for vertices and tracks
+  IdConversion vtxid_map("vertex");
+  IdConversion trkid_map("track");
 
   auto *const container_truth = findNode::getClass<PHG4TruthInfoContainer>(dstNode, "G4TruthInfo");
   if (container_truth && m_g4truthinfo)
   {
+    vtxid_map.reset(container_truth->minvtxindex(), container_truth->maxvtxindex(), container_truth->GetVtxMap().size());
+    trkid_map.reset(container_truth->mintrkindex(), container_truth->maxtrkindex(), container_truth->GetMap().size());
+
     {
       // primary vertices
       auto key = m_g4truthinfo->maxvtxindex();
       const auto range = container_truth->GetPrimaryVtxRange();
       for (auto iter = range.first; iter != range.second; ++iter)
       {
-        // clone vertex, insert in map, and add index conversion
+        // clone vertex, shift time, insert in map, and add index conversion
         const auto &sourceVertex = iter->second;
         auto *newVertex = new PHG4VtxPoint_t(sourceVertex);
         newVertex->set_t(sourceVertex->get_t() + delta_t);
         m_g4truthinfo->AddVertex(++key, newVertex);
-        vtxid_map.insert(std::make_pair(sourceVertex->get_id(), key));
+        vtxid_map.insert(sourceVertex->get_id(), key);
+
+        // embed flag is stored only for primary vertices, consistently with PHG4TruthEventAction
+        m_g4truthinfo->AddEmbededVtxId(key, new_embed_id);
       }
     }
 
@@ -180,7 +263,7 @@ void Fun4AllDstPileupMerger::copy_background_event(PHCompositeNode *dstNode, dou
         auto *newVertex = new PHG4VtxPoint_t(sourceVertex);
         newVertex->set_t(sourceVertex->get_t() + delta_t);
         m_g4truthinfo->AddVertex(--key, newVertex);
-        vtxid_map.insert(std::make_pair(sourceVertex->get_id(), key));
+        vtxid_map.insert(sourceVertex->get_id(), key);
       }
     }
 
@@ -202,18 +285,13 @@ void Fun4AllDstPileupMerger::copy_background_event(PHCompositeNode *dstNode, dou
         dest->set_primary_id(dest->get_track_id());
 
         // update vertex
-        const auto keyiter = vtxid_map.find(source->get_vtx_id());
-        if (keyiter != vtxid_map.end())
-        {
-          dest->set_vtx_id(keyiter->second);
-        }
-        else
-        {
-          std::cout << "Fun4AllDstPileupMerger::copy_background_event - vertex id " << source->get_vtx_id() << " not found in map" << std::endl;
-        }
+        dest->set_vtx_id(vtxid_map.convert(source->get_vtx_id()));
 
         // insert in map
-        trkid_map.insert(std::make_pair(source->get_track_id(), dest->get_track_id()));
+        trkid_map.insert(source->get_track_id(), dest->get_track_id());
+
+        // embed flag is stored only for primary tracks, consistently with PHG4TruthEventAction
+        m_g4truthinfo->AddEmbededTrkId(key, new_embed_id);
       }
     }
 
@@ -236,41 +314,13 @@ void Fun4AllDstPileupMerger::copy_background_event(PHCompositeNode *dstNode, dou
         m_g4truthinfo->AddParticle(--key, dest);
         dest->set_track_id(key);
 
-        // update parent id
-        auto keyiter = trkid_map.find(source->get_parent_id());
-        if (keyiter != trkid_map.end())
-        {
-          dest->set_parent_id(keyiter->second);
-        }
-        else
-        {
-          std::cout << "Fun4AllDstPileupMerger::copy_background_event - track id " << source->get_parent_id() << " not found in map" << std::endl;
-        }
-
-        // update primary id
-        keyiter = trkid_map.find(source->get_primary_id());
-        if (keyiter != trkid_map.end())
-        {
-          dest->set_primary_id(keyiter->second);
-        }
-        else
-        {
-          std::cout << "Fun4AllDstPileupMerger::copy_background_event - track id " << source->get_primary_id() << " not found in map" << std::endl;
-        }
-
-        // update vertex
-        keyiter = vtxid_map.find(source->get_vtx_id());
-        if (keyiter != vtxid_map.end())
-        {
-          dest->set_vtx_id(keyiter->second);
-        }
-        else
-        {
-          std::cout << "Fun4AllDstPileupMerger::copy_background_event - vertex id " << source->get_vtx_id() << " not found in map" << std::endl;
-        }
+        // update parent, primary and vertex ids
+        dest->set_parent_id(trkid_map.convert(source->get_parent_id()));
+        dest->set_primary_id(trkid_map.convert(source->get_primary_id()));
+        dest->set_vtx_id(vtxid_map.convert(source->get_vtx_id()));
 
         // insert in map
-        trkid_map.insert(std::make_pair(source->get_track_id(), dest->get_track_id()));
+        trkid_map.insert(source->get_track_id(), dest->get_track_id());
       }
     }
 
@@ -287,76 +337,22 @@ void Fun4AllDstPileupMerger::copy_background_event(PHCompositeNode *dstNode, dou
           continue;
         }
 
-        auto keyiter = trkid_map.find(source->get_track_id());
-        if (keyiter == trkid_map.end()) // guard against missing track id in map
+        const int track_id = trkid_map.find(source->get_track_id());
+        if (track_id == 0) // guard against missing track id in map
         {
           std::cout << __PRETTY_FUNCTION__ << " - " << __LINE__ << " - track id " << source->get_track_id() << " not found in map" << std::endl;
           continue;
         }
 
         auto *dest = new PHG4Particle_t(source);
-        dest->set_track_id(keyiter->second);
-
-        if (source->get_parent_id() == 0)
-        {
-          dest->set_parent_id(0);
-        }
-        else
-        {
-          keyiter = trkid_map.find(source->get_parent_id());
-          if (keyiter != trkid_map.end())
-          {
-            dest->set_parent_id(keyiter->second);
-          }
-          else
-          {
-            std::cout << "Fun4AllDstPileupMerger::copy_background_event - track id " << source->get_parent_id() << " not found in map" << std::endl;
-          }
-        }
-
-        keyiter = trkid_map.find(source->get_primary_id());
-        if (keyiter != trkid_map.end())
-        {
-          dest->set_primary_id(keyiter->second);
-        }
-        else
-        {
-          std::cout << "Fun4AllDstPileupMerger::copy_background_event - track id " << source->get_primary_id() << " not found in map" << std::endl;
-        }
-
-        keyiter = vtxid_map.find(source->get_vtx_id());
-        if (keyiter != vtxid_map.end())
-        {
-          dest->set_vtx_id(keyiter->second);
-        }
-        else
-        {
-          std::cout << "Fun4AllDstPileupMerger::copy_background_event - vertex id " << source->get_vtx_id() << " not found in map" << std::endl;
-        }
+        dest->set_track_id(track_id);
+        dest->set_parent_id(source->get_parent_id() == 0 ? 0 : trkid_map.convert(source->get_parent_id()));
+        dest->set_primary_id(trkid_map.convert(source->get_primary_id()));
+        dest->set_vtx_id(vtxid_map.convert(source->get_vtx_id()));
 
         m_g4truthinfo->AddsPHENIXPrimaryParticle(dest->get_track_id(), dest);
       }
     }
-
-    // vertex embed flags
-    /* embed flag is stored only for primary vertices, consistently with PHG4TruthEventAction */
-    for (const auto &pair : vtxid_map)
-    {
-      if (pair.first > 0)
-      {
-        m_g4truthinfo->AddEmbededVtxId(pair.second, new_embed_id);
-      }
-    }
-
-    // track embed flags
-    /* embed flag is stored only for primary tracks, consistently with PHG4TruthEventAction */
-    for (const auto &pair : trkid_map)
-    {
-      if (pair.first > 0)
-      {
-        m_g4truthinfo->AddEmbededTrkId(pair.second, new_embed_id);
-      }
-    }
   }
 
   // copy g4hits
@@ -387,41 +383,46 @@ void Fun4AllDstPileupMerger::copy_background_event(PHCompositeNode *dstNode, dou
       }
     }
     {
-      // hits
-      const auto range = container_hit->getHits();
-      for (auto iter = range.first; iter != range.second; ++iter)
+      /*
+       * hits
+       * background hits are moved to the destination container rather than cloned.
+       * The source container is refilled when the next background event is read
+       */
+      auto hits = container_hit->ReleaseHits();
+
+      // hits are sorted by key, so that hits from the same detid are contiguous
+      // and can be appended to the destination container in one go
+      std::vector<PHG4Hit *> detid_hits;
+      for (auto iter = hits.begin(); iter != hits.end();)
       {
-        // clone hit
-        const auto &sourceHit = iter->second;
-        auto *newHit = new PHG4Hit_t(sourceHit);
+        const unsigned int detid = iter->second->get_detid();
+        detid_hits.clear();
+        for (; iter != hits.end() && iter->second->get_detid() == detid; ++iter)
+        {
+          auto *hit = iter->second;
 
-        // shift time
-        newHit->set_t(0, sourceHit->get_t(0) + delta_t);
-        newHit->set_t(1, sourceHit->get_t(1) + delta_t);
+          // shift time
+          hit->set_t(0, hit->get_t(0) + delta_t);
+          hit->set_t(1, hit->get_t(1) + delta_t);
 
-        // update track id
-        const auto keyiter = trkid_map.find(sourceHit->get_trkid());
-        if (keyiter != trkid_map.end())
-        {
-          newHit->set_trkid(keyiter->second);
-        }
-        else
-        {
-          std::cout << "Fun4AllDstPileupMerger::copy_background_event - track id " << sourceHit->get_trkid() << " not found in map" << std::endl;
-        }
+          // update track id
+          hit->set_trkid(trkid_map.convert(hit->get_trkid()));
 
-        /*
-         * reset shower ids
-         * it was decided that showers from the background events will not be copied to the merged event
-         * as such we just reset the hits shower id
-         */
-        newHit->set_shower_id(std::numeric_limits<int>::min());
+          /*
+           * reset shower ids
+           * it was decided that showers from the background events will not be copied to the merged event
+           * as such we just reset the hits shower id
+           */
+          hit->set_shower_id(std::numeric_limits<int>::min());
+
+          detid_hits.push_back(hit);
+        }
 
         /*
-         * this will generate a new key for the hit and assign it to the hit
+         * this will generate new keys for the hits, following the last hit of the 'main' event
          * this ensures that there is no conflict with the hits from the 'main' event
          */
-        pair.second->AddHit(newHit->get_detid(), newHit);
+        pair.second->AddHits(detid, detid_hits);
       }
     }
 
@@ -35,6 +35,7 @@ class Fun4AllDstPileupMerger final
   void load_nodes(PHCompositeNode *);
 
   //! time-shift and copy content of source nodes to destination
+  /*! g4hits are moved rather than copied, leaving the source hit containers empty */
   void copy_background_event(PHCompositeNode *, double delta_t) const;
 
   void copyDetectorActiveCrossings(const std::map<std::string, std::pair<double, double>> &dmap) { m_DetectorTiming = dmap; }
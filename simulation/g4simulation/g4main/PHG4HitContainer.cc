@@ -119,6 +119,34 @@ PHG4HitContainer::AddHit(const unsigned int detid, PHG4Hit *newhit)
   return hitmap.insert(std::make_pair(key, newhit)).first;
 }
 
+void PHG4HitContainer::AddHits(const unsigned int detid, const std::vector<PHG4Hit *> &newhits)
+{
+  if (newhits.empty())
+  {
+    return;
+  }
+
+  PHG4HitDefs::keytype key = genkey(detid);
+  const PHG4HitDefs::keytype lastkey = key + newhits.size() - 1;
+  if ((lastkey >> PHG4HitDefs::hit_idbits) != (key >> PHG4HitDefs::hit_idbits))
+  {
+    std::cout << PHWHERE << " too many hits for detector " << detid
+              << " hitmap.size: " << hitmap.size()
+              << " new hits: " << newhits.size() << " exiting now" << std::endl;
+    exit(1);
+  }
+  layers.insert(detid);
+
+  // all new keys go right before the first hit of the next detid
+  const auto hint = hitmap.upper_bound(lastkey);
+  for (auto *newhit : newhits)
+  {
+    newhit->set_hit_id(key);
+    hitmap.emplace_hint(hint, key, newhit);
+    ++key;
+  }
+}
+
 PHG4HitContainer::ConstRange PHG4HitContainer::getHits(const unsigned int detid) const
 {
   PHG4HitDefs::keytype detidlong = detid;
@@ -12,6 +12,7 @@
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 class PHG4Hit;
 
@@ -42,6 +43,21 @@ class PHG4HitContainer : public PHObject
 
   ConstIterator AddHit(const unsigned int detid, PHG4Hit *newhit);
 
+  //! append hits to a given detid, taking ownership
+  /*!
+   * hits get consecutive keys following the last hit of this detid, in input order.
+   * This is equivalent to calling AddHit(detid, hit) for each hit, without looking up the last key every time
+   */
+  void AddHits(const unsigned int detid, const std::vector<PHG4Hit *> &newhits);
+
+  //! transfer ownership of all hits to the caller, leaving the container empty
+  Map ReleaseHits()
+  {
+    Map released;
+    released.swap(hitmap);
+    return released;
+  }
+
   Iterator findOrAddHit(PHG4HitDefs::keytype key);
 
   PHG4Hit *findHit(PHG4HitDefs::keytype key);
@@ -7,8 +7,11 @@
 #include <algorithm>
 #include <boost/tuple/tuple.hpp>
 
+#include <atomic>
 #include <limits>
+#include <mutex>
 #include <string>
+#include <utility>
 
 PHG4TruthInfoContainer::~PHG4TruthInfoContainer() { Reset(); }
 
@@ -41,9 +44,75 @@ void PHG4TruthInfoContainer::Reset()
   particle_embed_flags.clear();
   vertex_embed_flags.clear();
 
+  m_particle_index.clear();
+  m_vtx_index.clear();
+  m_shower_index.clear();
+  m_index_valid = true;
+  m_index_dense = true;
+
   return;
 }
 
+void PHG4TruthInfoContainer::build_index() const
+{
+  m_particle_index.clear();
+  m_vtx_index.clear();
+  m_shower_index.clear();
+
+  m_index_dense = is_dense(particlemap) && is_dense(vtxmap) && is_dense(showermap);
+  if (m_index_dense)
+  {
+    for (const auto& [id, particle] : particlemap)
+    {
+      m_particle_index.set(id, particle);
+    }
+    for (const auto& [id, vtx] : vtxmap)
+    {
+      m_vtx_index.set(id, vtx);
+    }
+    for (const auto& [id, shower] : showermap)
+    {
+      m_shower_index.set(id, shower);
+    }
+  }
+}
+
+void PHG4TruthInfoContainer::ensure_index() const
+{
+  std::atomic_ref<bool> index_valid(m_index_valid);
+  if (index_valid.load(std::memory_order_acquire))
+  {
+    return;
+  }
+
+  // tables are only rebuilt after reading from file, one lock for all containers is enough
+  static std::mutex index_mutex;
+  std::lock_guard<std::mutex> lock(index_mutex);
+  if (!index_valid.load(std::memory_order_relaxed))
+  {
+    build_index();
+    index_valid.store(true, std::memory_order_release);
+  }
+}
+
+namespace
+{
+  //! insert in map, using end or begin as hint, since ids are usually appended in either direction
+  template <class T>
+  std::pair<typename std::map<int, T*>::const_iterator, bool> insert_hint(std::map<int, T*>& map, const int key, T* value)
+  {
+    if (map.empty() || key > map.rbegin()->first)
+    {
+      return std::make_pair(map.emplace_hint(map.end(), key, value), true);
+    }
+    if (key < map.begin()->first)
+    {
+      return std::make_pair(map.emplace_hint(map.begin(), key, value), true);
+    }
+    return map.insert(std::make_pair(key, value));
+  }
+}  // namespace
+
 void PHG4TruthInfoContainer::identify(std::ostream& os) const
 {
   os << "---particlemap--------------------------" << std::endl;
@@ -93,9 +162,10 @@ PHG4TruthInfoContainer::AddParticle(const int trackid, PHG4Particle* newparticle
   int key = trackid;
   ConstIterator it;
   bool added = false;
-  boost::tie(it, added) = particlemap.insert(std::make_pair(key, newparticle));
+  boost::tie(it, added) = insert_hint(particlemap, key, newparticle);
   if (added)
   {
+    update_index(m_particle_index, particlemap, key, newparticle);
     return it;
   }
 
@@ -138,17 +208,17 @@ PHG4TruthInfoContainer::AddsPHENIXPrimaryParticle(const int trackid, PHG4Particl
 
 PHG4Particle* PHG4TruthInfoContainer::GetParticle(const int trackid)
 {
-  int key = trackid;
-  Iterator it = particlemap.find(key);
-  if (it != particlemap.end())
-  {
-    return it->second;
-  }
-  return nullptr;
+  return std::as_const(*this).GetParticle(trackid);
 }
 
 PHG4Particle* PHG4TruthInfoContainer::GetParticle(const int trackid) const
 {
+  ensure_index();
+  if (m_index_dense)
+  {
+    return m_particle_index.find(trackid);
+  }
+
   int key = trackid;
   ConstIterator it = particlemap.find(key);
   if (it != particlemap.end())
@@ -164,12 +234,7 @@ PHG4Particle* PHG4TruthInfoContainer::GetPrimaryParticle(const int trackid)
   {
     return nullptr;
   }
-  Iterator it = particlemap.find(trackid);
-  if (it != particlemap.end())
-  {
-    return it->second;
-  }
-  return nullptr;
+  return GetParticle(trackid);
 }
 
 PHG4Particle* PHG4TruthInfoContainer::GetsPHENIXPrimaryParticle(const int trackid)
@@ -184,6 +249,12 @@ PHG4Particle* PHG4TruthInfoContainer::GetsPHENIXPrimaryParticle(const int tracki
 
 PHG4VtxPoint* PHG4TruthInfoContainer::GetVtx(const int vtxid)
 {
+  ensure_index();
+  if (m_index_dense)
+  {
+    return m_vtx_index.find(vtxid);
+  }
+
   int key = vtxid;
   VtxIterator it = vtxmap.find(key);
   if (it != vtxmap.end())
@@ -199,16 +270,17 @@ PHG4VtxPoint* PHG4TruthInfoContainer::GetPrimaryVtx(const int vtxid)
   {
     return nullptr;
   }
-  VtxIterator it = vtxmap.find(vtxid);
-  if (it != vtxmap.end())
-  {
-    return it->second;
-  }
-  return nullptr;
+  return GetVtx(vtxid);
 }
 
 PHG4Shower* PHG4TruthInfoContainer::GetShower(const int showerid)
 {
+  ensure_index();
+  if (m_index_dense)
+  {
+    return m_shower_index.find(showerid);
+  }
+
   int key = showerid;
   ShowerIterator it = showermap.find(key);
   if (it != showermap.end())
@@ -224,12 +296,7 @@ PHG4Shower* PHG4TruthInfoContainer::GetPrimaryShower(const int showerid)
   {
     return nullptr;
   }
-  ShowerIterator it = showermap.find(showerid);
-  if (it != showermap.end())
-  {
-    return it->second;
-  }
-  return nullptr;
+  return GetShower(showerid);
 }
 
 PHG4TruthInfoContainer::ConstVtxIterator
@@ -247,9 +314,10 @@ PHG4TruthInfoContainer::AddVertex(const int id, PHG4VtxPoint* newvtx)
     identify();
   }
 
-  boost::tie(it, added) = vtxmap.insert(std::make_pair(key, newvtx));
+  boost::tie(it, added) = insert_hint(vtxmap, key, newvtx);
   if (added)
   {
+    update_index(m_vtx_index, vtxmap, key, newvtx);
     newvtx->set_id(key);
     return it;
   }
@@ -274,9 +342,10 @@ PHG4TruthInfoContainer::AddShower(const int id, PHG4Shower* newshower)
     identify();
   }
 
-  boost::tie(it, added) = showermap.insert(std::make_pair(key, newshower));
+  boost::tie(it, added) = insert_hint(showermap, key, newshower);
   if (added)
   {
+    update_index(m_shower_index, showermap, key, newshower);
     newshower->set_id(key);
     return it;
   }
@@ -354,6 +423,7 @@ int PHG4TruthInfoContainer::minshowerindex() const
 
 void PHG4TruthInfoContainer::delete_particle(Iterator piter)
 {
+  update_index(m_particle_index, particlemap, piter->first, static_cast<PHG4Particle*>(nullptr));
   delete piter->second;
   particlemap.erase(piter);
   return;
@@ -370,6 +440,7 @@ void PHG4TruthInfoContainer::delete_particle(int trackid)
 
 void PHG4TruthInfoContainer::delete_vtx(VtxIterator viter)
 {
+  update_index(m_vtx_index, vtxmap, viter->first, static_cast<PHG4VtxPoint*>(nullptr));
   delete viter->second;
   vtxmap.erase(viter);
   return;
@@ -386,6 +457,7 @@ void PHG4TruthInfoContainer::delete_vtx(int vtxid)
 
 void PHG4TruthInfoContainer::delete_shower(ShowerIterator siter)
 {
+  update_index(m_shower_index, showermap, siter->first, static_cast<PHG4Shower*>(nullptr));
   delete siter->second;
   showermap.erase(siter);
   return;
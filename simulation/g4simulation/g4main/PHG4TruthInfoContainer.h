@@ -5,10 +5,13 @@
 
 #include <phool/PHObject.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
 #include <iterator>  // for distance
 #include <map>
 #include <utility>
+#include <vector>
 
 class PHG4Shower;
 class PHG4Particle;
@@ -205,6 +208,83 @@ class PHG4TruthInfoContainer : public PHObject
   int minshowerindex() const;
 
  private:
+  //! dense id to object lookup table
+  /**
+   * truth ids are contiguous ranges starting from +1 (primaries) and -1 (secondaries)
+   * which allows O(1) access, rather than O(log N) from the maps
+   */
+  template <class T>
+  class DenseIndex
+  {
+   public:
+    T* find(const int id) const
+    {
+      const auto& table = id > 0 ? m_positive : m_negative;
+      const auto index = static_cast<size_t>(id > 0 ? id : -id);
+      return index < table.size() ? table[index] : nullptr;
+    }
+
+    void set(const int id, T* value)
+    {
+      auto& table = id > 0 ? m_positive : m_negative;
+      const auto index = static_cast<size_t>(id > 0 ? id : -id);
+      if (index >= table.size())
+      {
+        table.resize(index + 1, nullptr);
+      }
+      table[index] = value;
+    }
+
+    void clear()
+    {
+      m_positive.clear();
+      m_negative.clear();
+    }
+
+   private:
+    std::vector<T*> m_positive;
+    std::vector<T*> m_negative;
+  };
+
+  //! true if ids in map are dense enough to be indexed
+  template <class T>
+  static bool is_dense(const std::map<int, T*>& map)
+  {
+    if (map.empty())
+    {
+      return true;
+    }
+    const auto range = static_cast<size_t>(std::max(map.rbegin()->first, 0) - std::min(map.begin()->first, 0));
+    return range <= 4 * map.size() + 1024;
+  }
+
+  //! rebuild dense lookup tables from the maps
+  void build_index() const;
+
+  //! rebuild the lookup tables if they were invalidated by reading from file.
+  /** thread safe, so that concurrent const lookups can be done from several threads */
+  void ensure_index() const;
+
+  //! update lookup tables for a single entry
+  template <class T>
+  void update_index(DenseIndex<T>& index, const std::map<int, T*>& map, const int id, T* value)
+  {
+    if (!m_index_valid || !m_index_dense)
+    {
+      return;
+    }
+    if (value && !is_dense(map))
+    {
+      // too sparse, fall back to map lookup
+      m_index_dense = false;
+      m_particle_index.clear();
+      m_vtx_index.clear();
+      m_shower_index.clear();
+      return;
+    }
+    index.set(id, value);
+  }
+
   /// particle storage map format description:
   /// primary particles are appended in the positive direction
   /// secondary particles are appended in the negative direction
@@ -243,6 +323,16 @@ class PHG4TruthInfoContainer : public PHObject
   std::map<int, int> particle_embed_flags;  //< trackid => embed flag
   std::map<int, int> vertex_embed_flags;    //< vtxid => embed flag
 
+  /// dense lookup tables, not persistent.
+  /// They are invalidated each time the object is read from file (see PHG4TruthInfoContainerLinkDef.h)
+  /// and rebuilt on the first lookup, under a lock (see ensure_index). Lookups fall back to the maps when ids are too sparse.
+  /// Insertions and deletions update the tables and must not run concurrently with lookups
+  mutable DenseIndex<PHG4Particle> m_particle_index;  //!
+  mutable DenseIndex<PHG4VtxPoint> m_vtx_index;       //!
+  mutable DenseIndex<PHG4Shower> m_shower_index;      //!
+  mutable bool m_index_valid = true;                  //!
+  mutable bool m_index_dense = true;                  //!
+
   ClassDefOverride(PHG4TruthInfoContainer, 2)
 };
 
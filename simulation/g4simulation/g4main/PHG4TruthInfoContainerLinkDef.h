@@ -2,4 +2,7 @@
 
 #pragma link C++ class PHG4TruthInfoContainer + ;
 
+// dense lookup tables are not persistent. Invalidate them on read, so that they get rebuilt on first access
+#pragma read sourceClass = "PHG4TruthInfoContainer" version = "[1-]" targetClass = "PHG4TruthInfoContainer" source = "" target = "m_index_valid" code = "{ m_index_valid = false; }"
+
 #endif /* __CINT__ */
@@ -11,14 +11,17 @@
 #include <g4detectors/PHG4TpcGeom.h>
 #include <g4detectors/PHG4TpcGeomContainer.h>
 
+#include <ffaobjects/EventHeader.h>
+
 #include <fun4all/Fun4AllReturnCodes.h>
 #include <fun4all/SubsysReco.h>  // for SubsysReco
-#
+
 #include <phool/PHCompositeNode.h>
 #include <phool/PHNode.h>  // for PHNode
 #include <phool/PHNodeIterator.h>
-#include <phool/PHRandomSeed.h>
+#include <phool/PHRandomStream.h>
 #include <phool/getClass.h>
+#include <phool/recoConsts.h>
 #include <phool/phool.h>  // for PHWHERE
 
 #include <gsl/gsl_randist.h>
@@ -26,19 +29,26 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>  // for exit
 #include <iostream>
 #include <limits>
 #include <memory>  // for allocator_tra...
+#include <syncstream>
+
+#include <omp.h>
 
 PHG4TpcDigitizer::PHG4TpcDigitizer(const std::string &name)
   : SubsysReco(name)
-  , RandomGenerator(gsl_rng_alloc(gsl_rng_mt19937))  // will be assigned in PHG4TpcDigitizer::InitRun
 {
-  unsigned int seed = PHRandomSeed();  // fixed seed is handled in this funtcion
-  std::cout << Name() << " random seed: " << seed << std::endl;
+  // one random stream per sector, seeded for each event from this key
+  m_random_key = PHRandomStream::GetKey(name);  // fixed seed is handled in this funtcion
+  std::cout << Name() << " random key: " << m_random_key << std::endl;
 
-  gsl_rng_set(RandomGenerator, seed);
+  for (auto &sector_data : m_sector_data)
+  {
+    sector_data.rng = gsl_rng_alloc(gsl_rng_mt19937);
+  }
 
   if (Verbosity() > 0)
   {
@@ -48,7 +58,10 @@ PHG4TpcDigitizer::PHG4TpcDigitizer(const std::string &name)
 
 PHG4TpcDigitizer::~PHG4TpcDigitizer()
 {
-  gsl_rng_free(RandomGenerator);
+  for (auto &sector_data : m_sector_data)
+  {
+    gsl_rng_free(sector_data.rng);
+  }
 }
 
 int PHG4TpcDigitizer::InitRun(PHCompositeNode *topNode)
@@ -64,6 +77,9 @@ int PHG4TpcDigitizer::InitRun(PHCompositeNode *topNode)
 
   ADCThreshold_mV = ADCThreshold * ADCNoiseConversionGain;
 
+  m_runnumber = recoConsts::instance()->get_IntFlag("RUNNUMBER", 0);
+  m_event = 0;
+
   //-------------
   // Add Hit Node
   //-------------
@@ -103,8 +119,26 @@ int PHG4TpcDigitizer::InitRun(PHCompositeNode *topNode)
 
 int PHG4TpcDigitizer::process_event(PHCompositeNode *topNode)
 {
+  // each sector stream is seeded from (run, event, sector), independently of the processing order.
+  // The event number is the one of the EventHeader, the local event count is only a fallback
+  uint32_t event_number = m_event;
+  auto *evtheader = findNode::getClass<EventHeader>(topNode, "EventHeader");
+  if (evtheader)
+  {
+    event_number = evtheader->get_EvtSequence();
+  }
+  else if (m_event == 0)
+  {
+    std::cout << PHWHERE << " EventHeader not found, random streams are seeded with the local event count" << std::endl;
+  }
+  for (unsigned int isector = 0; isector < m_nsectors; ++isector)
+  {
+    gsl_rng_set(m_sector_data[isector].rng, PHRandomStream::Seed(m_random_key, m_runnumber, event_number, isector));
+  }
+
   DigitizeCylinderCells(topNode);
 
+  ++m_event;
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -242,7 +276,17 @@ void PHG4TpcDigitizer::DigitizeCylinderCells(PHCompositeNode *topNode)
   // Digitization
   //-------------
 
-  // Loop over all TPC layers
+  // sort the signal hits by sector and side, using the same pad to sector mapping as for noise hits
+  for (auto &sector_data : m_sector_data)
+  {
+    sector_data.layer_hits.resize(TpcNLayers);
+    for (auto &hits : sector_data.layer_hits)
+    {
+      hits.clear();
+    }
+    sector_data.noise_hits.clear();
+  }
+
   for (unsigned int layer = TpcMinLayer; layer < TpcMinLayer + TpcNLayers; ++layer)
   {
     // we need the geometry object for this layer
@@ -252,294 +296,66 @@ void PHG4TpcDigitizer::DigitizeCylinderCells(PHCompositeNode *topNode)
       exit(1);
     }
 
-    int nphibins = layergeom->get_phibins();
+    const int nphibins = layergeom->get_phibins();
     if (Verbosity() > 1)
     {
       std::cout << "    nphibins " << nphibins << std::endl;
     }
 
-    for (unsigned int side = 0; side < 2; ++side)
+    // Loop over all hitsets containing signals for this layer and add them to the sector they belong to
+    TrkrHitSetContainer::ConstRange hitset_range = trkrhitsetcontainer->getHitSets(TrkrDefs::TrkrId::tpcId, layer);
+    for (TrkrHitSetContainer::ConstIterator hitset_iter = hitset_range.first;
+         hitset_iter != hitset_range.second;
+         ++hitset_iter)
     {
-      if (Verbosity() > 1)
-      {
-        std::cout << "TPC layer " << layer << " side " << side << std::endl;
-      }
-
-      // for this layer and side, use a vector of a vector of cells for each phibin
-      if (phi_sorted_hits.size() != static_cast<std::size_t>(nphibins))
-      {
-        phi_sorted_hits.clear();
-        phi_sorted_hits.resize(nphibins);
-      }
-      else
-      {
-        for (auto &hits : phi_sorted_hits)
-        {
-          hits.clear();
-        }
-      }
+      // we have an iterator to one TrkrHitSet for the Tpc from the trkrHitSetContainer
+      // get the hitset key
+      TrkrDefs::hitsetkey hitsetkey = hitset_iter->first;
+      unsigned int side = TpcDefs::getSide(hitsetkey);
 
-      // Loop over all hitsets containing signals for this layer and add them to phi_sorted_hits for their phibin
-      TrkrHitSetContainer::ConstRange hitset_range = trkrhitsetcontainer->getHitSets(TrkrDefs::TrkrId::tpcId, layer);
-      for (TrkrHitSetContainer::ConstIterator hitset_iter = hitset_range.first;
-           hitset_iter != hitset_range.second;
-           ++hitset_iter)
+      if (Verbosity() > 2)
       {
-        // we have an iterator to one TrkrHitSet for the Tpc from the trkrHitSetContainer
-        // get the hitset key
-        TrkrDefs::hitsetkey hitsetkey = hitset_iter->first;
-        unsigned int this_side = TpcDefs::getSide(hitsetkey);
-        // skip this hitset if it is not on this side
-        if (this_side != side)
-        {
-          continue;
-        }
-
-        if (Verbosity() > 2)
-        {
-          if (layer == print_layer)
-          {
-            std::cout << "new: PHG4TpcDigitizer:  processing signal hits for layer " << layer
-                      << " hitsetkey " << hitsetkey << " side " << side << std::endl;
-          }
-        }
-
-        // get all of the hits from this hitset
-        TrkrHitSet *hitset = hitset_iter->second;
-        TrkrHitSet::ConstRange hit_range = hitset->getHits();
-        for (TrkrHitSet::ConstIterator hit_iter = hit_range.first;
-             hit_iter != hit_range.second;
-             ++hit_iter)
+        if (layer == print_layer)
         {
-          // Fill the vector of signal hits for each phibin
-          unsigned int phibin = TpcDefs::getPad(hit_iter->first);
-          phi_sorted_hits[phibin].push_back(hit_iter);
+          std::cout << "new: PHG4TpcDigitizer:  processing signal hits for layer " << layer
+                    << " hitsetkey " << hitsetkey << " side " << side << std::endl;
         }
-        // For this hitset we now have the signal hits sorted into vectors for each phi
       }
 
-      // Process one phi bin at a time
-      if (Verbosity() > 1)
+      // get all of the hits from this hitset
+      TrkrHitSet *hitset = hitset_iter->second;
+      TrkrHitSet::ConstRange hit_range = hitset->getHits();
+      for (TrkrHitSet::ConstIterator hit_iter = hit_range.first;
+           hit_iter != hit_range.second;
+           ++hit_iter)
       {
-        std::cout << "    phi_sorted_hits size " << phi_sorted_hits.size() << " ntbins " << layergeom->get_zbins() << std::endl;
+        unsigned int phibin = TpcDefs::getPad(hit_iter->first);
+        unsigned int sector = 12 * phibin / nphibins;
+        m_sector_data[side * 12 + sector].layer_hits[layer - TpcMinLayer].push_back(hit_iter);
       }
+    }
+  }
 
-      for (unsigned int iphi = 0; iphi < phi_sorted_hits.size(); iphi++)
-      {
-        int ntbins = layergeom->get_zbins();
-        signal_hit_by_tbin.assign(ntbins, nullptr);
-
-        // add a signal hit from phi_sorted_hits for each t bin that has one
-        for (unsigned int it = 0; it < phi_sorted_hits[iphi].size(); it++)
-        {
-          int tbin = TpcDefs::getTBin(phi_sorted_hits[iphi][it]->first);
-          if (!signal_hit_by_tbin[tbin])
-          {
-            signal_hit_by_tbin[tbin] = phi_sorted_hits[iphi][it]->second;
-          }
-
-          if (Verbosity() > 2)
-          {
-            if (layer == print_layer)
-            {
-              TrkrDefs::hitkey hitkey = phi_sorted_hits[iphi][it]->first;
-              std::cout << "iphi " << iphi << " adding existing signal hit for layer " << layer
-                        << " side " << side
-                        << " tbin " << tbin << "  hitkey " << hitkey
-                        << " pad " << TpcDefs::getPad(hitkey)
-                        << " t bin " << TpcDefs::getTBin(hitkey)
-                        << "  energy " << (phi_sorted_hits[iphi][it]->second)->getEnergy()
-                        << std::endl;
-            }
-          }
-        }
-
-        // initialize entries to zero for each t bin
-        adc_input.assign(ntbins, 0.0);
-
-        // Now for this phibin we process all bins ordered by t into hits with noise
-        //======================================================
-        // For this step we take the edep value and convert it to mV at the ADC input
-        // See comments above for how to do this for signal and noise
-
-        for (int it = 0; it < ntbins; it++)
-        {
-          TrkrHit *signal_hit = signal_hit_by_tbin[it];
-          if (signal_hit)
-          {
-            // This tbin has a hit, add noise
-            float signal_with_noise = add_noise_to_bin(signal_hit->getEnergy());
-            adc_input[it] = signal_with_noise;
-
-            if (Verbosity() > 2)
-            {
-              if (layer == print_layer)
-              {
-                std::cout << "existing signal hit: layer " << layer << " iphi " << iphi << " it " << it
-                          << " edep " << signal_hit->getEnergy()
-                          << " adc gain " << ADCSignalConversionGain
-                          << " signal with noise " << signal_with_noise
-                          << " adc_input " << adc_input[it] << std::endl;
-              }
-            }
-          }
-          else
-          {
-            if (!skip_noise)
-            {
-              // This t bin does not have a filled cell, add noise
-              float noise = add_noise_to_bin(0.0);
-              adc_input[it] = noise;
-
-              if (Verbosity() > 2)
-              {
-                if (layer == print_layer)
-                {
-                  std::cout << "noise hit: layer " << layer << " side " << side << " iphi " << iphi << " it " << it
-                            << " adc gain " << ADCSignalConversionGain
-                            << " noise " << noise
-                            << " adc_input " << adc_input[it] << std::endl;
-                }
-              }
-            }
-          }
-        }
-
-        // Now we can digitize the entire stream of t bins for this phi bin
-        int binpointer = 0;
-
-        // Since we now store the local z of the hit as time of arrival at the readout plane,
-        // there is no difference between north and south
-        // The first to arrive is always bin 0
-
-        for (int it = 0; it < ntbins; it++)
-        {
-          if (it < binpointer)
-          {
-            continue;
-          }
-
-          // optionally do not trigger on bins with no signal
-          if (!signal_hit_by_tbin[it] && skip_noise)
-          {
-            binpointer++;
-            continue;
-          }
-
-          // convert threshold in "equivalent electrons" to mV
-          if (adc_input[it] > ADCThreshold_mV)
-          {
-            // digitize this bin and the following 4 bins
-
-            if (Verbosity() > 2)
-            {
-              if (layer == print_layer)
-              {
-                std::cout << std::endl
-                          << "Hit above threshold of "
-                          << ADCThreshold * ADCNoiseConversionGain << " for phibin " << iphi
-                          << " it " << it << " with adc_input " << adc_input[it]
-                          << " digitize this and 4 following bins: " << std::endl;
-              }
-            }
-
-            for (int itup = 0; itup < 5; itup++)
-            {
-              if (it + itup < ntbins && it + itup >= 0)  // stay within the bin limits
-              {
-                float input = 0;
-                TrkrHit *signal_hit = signal_hit_by_tbin[it + itup];
-                if (!signal_hit && skip_noise)
-                {
-                  input = add_noise_to_bin(0.0);  // no noise added to this bin previously because skip_noise is true
-                }
-                else
-                {
-                  input = adc_input[it + itup];
-                }
-                // input voltage x 1024 channels over 2200 mV max range
-                unsigned int adc_output = (unsigned int) (input * 1024.0 / 2200.0);
-
-                if (input < 0)
-                {
-                  adc_output = 0;
-                }
-                adc_output = std::min<unsigned int>(adc_output, 1023);
-
-                // Get the hitkey
-                TrkrDefs::hitkey hitkey = TpcDefs::genHitKey(iphi, it + itup);
-                TrkrHit *hit = nullptr;
-
-                if (Verbosity() > 2)
-                {
-                  if (layer == print_layer)
-                  {
-                    std::cout << "    Digitizing:  iphi " << iphi << "  it+itup " << it + itup
-                              << " adc_hitid " << (signal_hit ? hitkey : 0)
-                              << " is_populated " << (signal_hit ? 1 : 2)
-                              << "  adc_input " << adc_input[it + itup]
-                              << " ADCThreshold " << ADCThreshold * ADCNoiseConversionGain
-                              << " adc_output " << adc_output
-                              << " hitkey " << hitkey
-                              << " side " << side
-                              << "  binpointer " << binpointer
-                              << std::endl;
-                  }
-                }
-
-                if (signal_hit)
-                {
-                  // this is a signal hit, it already exists
-                  hit = signal_hit;
-                }
-                else
-                {
-                  // Hit does not exist yet, have to make one
-                  // we need the hitset key, requires (layer, sector, side)
-                  unsigned int sector = 12 * iphi / nphibins;
-                  TrkrDefs::hitsetkey hitsetkey = TpcDefs::genHitSetKey(layer, sector, side);
-                  auto hitset_iter = trkrhitsetcontainer->findOrAddHitSet(hitsetkey);
-
-                  hit = new TrkrHitv2();
-                  hitset_iter->second->addHitSpecificKey(hitkey, hit);
-
-                  if (Verbosity() > 2)
-                  {
-                    if (layer == print_layer)
-                    {
-                      std::cout << "      adding noise TrkrHit for iphi " << iphi
-                                << " tbin " << it + itup
-                                << " side " << side
-                                << " created new hit with hitkey " << hitkey
-                                << " energy " << adc_input[it + itup] << " adc " << adc_output
-                                << "  binpointer " << binpointer
-                                << std::endl;
-                    }
-                  }
-                }
-
-                hit->setAdc(adc_output);
-
-              }  // end boundary check
-              binpointer++;  // skip this bin in future
-            }  // end itup loop
+  // digitize sectors in parallel. Each sector has its own random stream,
+  // so that the result does not depend on the number of threads
+  const int nthreads = m_num_threads >= 1 ? m_num_threads : omp_get_max_threads();
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+  for (unsigned int isector = 0; isector < m_nsectors; ++isector)
+  {
+    DigitizeSector(geom_container, isector / 12, isector % 12, m_sector_data[isector]);
+  }
 
-          }  //  adc threshold if
-          else
-          {
-            // set adc value to zero if there is a hit
-            TrkrHit *hit = signal_hit_by_tbin[it];
-            if (hit)
-            {
-              hit->setAdc(0);
-            }
-            // bin below threshold, move on
-            binpointer++;
-          }  // end adc threshold if/else
-        }  // end time bin loop
-      }  // end phibins loop
-    }  // end loop over sides
-  }  // end loop over TPC layers
+  // add the new noise hits to the node tree, in sector order
+  for (const auto &sector_data : m_sector_data)
+  {
+    for (const auto &noise_hit : sector_data.noise_hits)
+    {
+      auto hitset_iter = trkrhitsetcontainer->findOrAddHitSet(noise_hit.hitsetkey);
+      auto *hit = new TrkrHitv2();
+      hit->setAdc(noise_hit.adc);
+      hitset_iter->second->addHitSpecificKey(noise_hit.hitkey, hit);
+    }
+  }
 
   //======================================================
   if (Verbosity() > 5)
@@ -664,19 +480,275 @@ void PHG4TpcDigitizer::DigitizeCylinderCells(PHCompositeNode *topNode)
   return;
 }
 
-float PHG4TpcDigitizer::add_noise_to_bin(float signal)
+void PHG4TpcDigitizer::DigitizeSector(PHG4TpcGeomContainer *geom_container, const unsigned int side, const unsigned int sector, SectorData &sector_data)
+{
+  // this method runs concurrently for different sectors
+  // it must only access the hits of its own sector, and add new hits to sector_data.noise_hits
+  const unsigned int print_layer = 18;
+
+  for (unsigned int layer = TpcMinLayer; layer < TpcMinLayer + TpcNLayers; ++layer)
+  {
+    PHG4TpcGeom *layergeom = geom_container->GetLayerCellGeom(layer);
+    const int nphibins = layergeom->get_phibins();
+    const int ntbins = layergeom->get_zbins();
+
+    // range of phibins belonging to this sector, such that sector = 12 * iphi / nphibins
+    const unsigned int phibin_begin = (sector * nphibins + 11) / 12;
+    const unsigned int phibin_end = ((sector + 1) * nphibins + 11) / 12;
+
+    if (Verbosity() > 1)
+    {
+      std::osyncstream(std::cout) << "TPC layer " << layer << " side " << side << " sector " << sector << std::endl;
+    }
+
+    // for this layer, side and sector, use a vector of a vector of cells for each phibin
+    auto &phi_sorted_hits = sector_data.phi_sorted_hits;
+    phi_sorted_hits.resize(phibin_end - phibin_begin);
+    for (auto &hits : phi_sorted_hits)
+    {
+      hits.clear();
+    }
+
+    // Fill the vector of signal hits for each phibin
+    for (const auto &hit_iter : sector_data.layer_hits[layer - TpcMinLayer])
+    {
+      unsigned int phibin = TpcDefs::getPad(hit_iter->first);
+      phi_sorted_hits[phibin - phibin_begin].push_back(hit_iter);
+    }
+
+    // Process one phi bin at a time
+    for (unsigned int iphi = phibin_begin; iphi < phibin_end; iphi++)
+    {
+      const auto &phibin_hits = phi_sorted_hits[iphi - phibin_begin];
+      auto &signal_hit_by_tbin = sector_data.signal_hit_by_tbin;
+      signal_hit_by_tbin.assign(ntbins, nullptr);
+
+      // add a signal hit from phi_sorted_hits for each t bin that has one
+      for (const auto &hit_iter : phibin_hits)
+      {
+        int tbin = TpcDefs::getTBin(hit_iter->first);
+        if (!signal_hit_by_tbin[tbin])
+        {
+          signal_hit_by_tbin[tbin] = hit_iter->second;
+        }
+
+        if (Verbosity() > 2)
+        {
+          if (layer == print_layer)
+          {
+            TrkrDefs::hitkey hitkey = hit_iter->first;
+            std::osyncstream(std::cout)
+                << "iphi " << iphi << " adding existing signal hit for layer " << layer
+                << " side " << side
+                << " tbin " << tbin << "  hitkey " << hitkey
+                << " pad " << TpcDefs::getPad(hitkey)
+                << " t bin " << TpcDefs::getTBin(hitkey)
+                << "  energy " << (hit_iter->second)->getEnergy()
+                << std::endl;
+          }
+        }
+      }
+
+      // initialize entries to zero for each t bin
+      auto &adc_input = sector_data.adc_input;
+      adc_input.assign(ntbins, 0.0);
+
+      // Now for this phibin we process all bins ordered by t into hits with noise
+      //======================================================
+      // For this step we take the edep value and convert it to mV at the ADC input
+      // See comments above for how to do this for signal and noise
+
+      for (int it = 0; it < ntbins; it++)
+      {
+        TrkrHit *signal_hit = signal_hit_by_tbin[it];
+        if (signal_hit)
+        {
+          // This tbin has a hit, add noise
+          float signal_with_noise = add_noise_to_bin(sector_data.rng, signal_hit->getEnergy());
+          adc_input[it] = signal_with_noise;
+
+          if (Verbosity() > 2)
+          {
+            if (layer == print_layer)
+            {
+              std::osyncstream(std::cout)
+                  << "existing signal hit: layer " << layer << " iphi " << iphi << " it " << it
+                  << " edep " << signal_hit->getEnergy()
+                  << " adc gain " << ADCSignalConversionGain
+                  << " signal with noise " << signal_with_noise
+                  << " adc_input " << adc_input[it] << std::endl;
+            }
+          }
+        }
+        else
+        {
+          if (!skip_noise)
+          {
+            // This t bin does not have a filled cell, add noise
+            float noise = add_noise_to_bin(sector_data.rng, 0.0);
+            adc_input[it] = noise;
+
+            if (Verbosity() > 2)
+            {
+              if (layer == print_layer)
+              {
+                std::osyncstream(std::cout)
+                    << "noise hit: layer " << layer << " side " << side << " iphi " << iphi << " it " << it
+                    << " adc gain " << ADCSignalConversionGain
+                    << " noise " << noise
+                    << " adc_input " << adc_input[it] << std::endl;
+              }
+            }
+          }
+        }
+      }
+
+      // Now we can digitize the entire stream of t bins for this phi bin
+      int binpointer = 0;
+
+      // Since we now store the local z of the hit as time of arrival at the readout plane,
+      // there is no difference between north and south
+      // The first to arrive is always bin 0
+
+      for (int it = 0; it < ntbins; it++)
+      {
+        if (it < binpointer)
+        {
+          continue;
+        }
+
+        // optionally do not trigger on bins with no signal
+        if (!signal_hit_by_tbin[it] && skip_noise)
+        {
+          binpointer++;
+          continue;
+        }
+
+        // convert threshold in "equivalent electrons" to mV
+        if (adc_input[it] > ADCThreshold_mV)
+        {
+          // digitize this bin and the following 4 bins
+
+          if (Verbosity() > 2)
+          {
+            if (layer == print_layer)
+            {
+              std::osyncstream(std::cout)
+                  << std::endl
+                  << "Hit above threshold of "
+                  << ADCThreshold * ADCNoiseConversionGain << " for phibin " << iphi
+                  << " it " << it << " with adc_input " << adc_input[it]
+                  << " digitize this and 4 following bins: " << std::endl;
+            }
+          }
+
+          for (int itup = 0; itup < 5; itup++)
+          {
+            if (it + itup < ntbins && it + itup >= 0)  // stay within the bin limits
+            {
+              float input = 0;
+              TrkrHit *signal_hit = signal_hit_by_tbin[it + itup];
+              if (!signal_hit && skip_noise)
+              {
+                input = add_noise_to_bin(sector_data.rng, 0.0);  // no noise added to this bin previously because skip_noise is true
+              }
+              else
+              {
+                input = adc_input[it + itup];
+              }
+              // input voltage x 1024 channels over 2200 mV max range
+              unsigned int adc_output = (unsigned int) (input * 1024.0 / 2200.0);
+
+              if (input < 0)
+              {
+                adc_output = 0;
+              }
+              adc_output = std::min<unsigned int>(adc_output, 1023);
+
+              // Get the hitkey
+              TrkrDefs::hitkey hitkey = TpcDefs::genHitKey(iphi, it + itup);
+
+              if (Verbosity() > 2)
+              {
+                if (layer == print_layer)
+                {
+                  std::osyncstream(std::cout)
+                      << "    Digitizing:  iphi " << iphi << "  it+itup " << it + itup
+                      << " adc_hitid " << (signal_hit ? hitkey : 0)
+                      << " is_populated " << (signal_hit ? 1 : 2)
+                      << "  adc_input " << adc_input[it + itup]
+                      << " ADCThreshold " << ADCThreshold * ADCNoiseConversionGain
+                      << " adc_output " << adc_output
+                      << " hitkey " << hitkey
+                      << " side " << side
+                      << "  binpointer " << binpointer
+                      << std::endl;
+                }
+              }
+
+              if (signal_hit)
+              {
+                // this is a signal hit, it already exists
+                signal_hit->setAdc(adc_output);
+              }
+              else
+              {
+                // Hit does not exist yet, have to make one
+                // it is added to the node tree once all sectors are digitized
+                // we need the hitset key, requires (layer, sector, side)
+                TrkrDefs::hitsetkey hitsetkey = TpcDefs::genHitSetKey(layer, sector, side);
+                sector_data.noise_hits.push_back({hitsetkey, hitkey, adc_output});
+
+                if (Verbosity() > 2)
+                {
+                  if (layer == print_layer)
+                  {
+                    std::osyncstream(std::cout)
+                        << "      adding noise TrkrHit for iphi " << iphi
+                        << " tbin " << it + itup
+                        << " side " << side
+                        << " created new hit with hitkey " << hitkey
+                        << " energy " << adc_input[it + itup] << " adc " << adc_output
+                        << "  binpointer " << binpointer
+                        << std::endl;
+                  }
+                }
+              }
+
+            }  // end boundary check
+            binpointer++;  // skip this bin in future
+          }  // end itup loop
+
+        }  //  adc threshold if
+        else
+        {
+          // set adc value to zero if there is a hit
+          TrkrHit *hit = signal_hit_by_tbin[it];
+          if (hit)
+          {
+            hit->setAdc(0);
+          }
+          // bin below threshold, move on
+          binpointer++;
+        }  // end adc threshold if/else
+      }  // end time bin loop
+    }  // end phibins loop
+  }  // end loop over TPC layers
+}
+
+float PHG4TpcDigitizer::add_noise_to_bin(gsl_rng *rng, float signal) const
 {
   // add noise to the signal and return adc input voltage
-  float adc_input_voltage = signal * ADCSignalConversionGain;                 // mV, see comments above
-  float noise_voltage = (Pedestal + added_noise()) * ADCNoiseConversionGain;  // mV - from definition of noise charge and pedestal charge
+  float adc_input_voltage = signal * ADCSignalConversionGain;                    // mV, see comments above
+  float noise_voltage = (Pedestal + added_noise(rng)) * ADCNoiseConversionGain;  // mV - from definition of noise charge and pedestal charge
   adc_input_voltage += noise_voltage;
 
   return adc_input_voltage;
 }
 
-float PHG4TpcDigitizer::added_noise()
+float PHG4TpcDigitizer::added_noise(gsl_rng *rng) const
 {
-  float noise = gsl_ran_gaussian(RandomGenerator, TpcEnc);
+  float noise = gsl_ran_gaussian(rng, TpcEnc);
 
   return noise;
 }
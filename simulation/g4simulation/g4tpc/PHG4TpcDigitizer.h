@@ -10,12 +10,16 @@
 
 #include <gsl/gsl_rng.h>
 
+#include <array>
+#include <cstdint>
+#include <limits>
 #include <map>
 #include <string>   // for string
 #include <utility>  // for pair, make_pair
 #include <vector>
 
 class PHCompositeNode;
+class PHG4TpcGeomContainer;
 class TrkrHit;
 
 class PHG4TpcDigitizer : public SubsysReco
@@ -41,11 +45,41 @@ class PHG4TpcDigitizer : public SubsysReco
   void SetENC(const float enc) { TpcEnc = enc; };
   void set_skip_noise_flag(const bool skip) { skip_noise = skip; }
 
+  //! number of threads used to digitize sectors
+  /**
+   * default is 1. 0 corresponds to allocating as many threads as available on the host
+   */
+  void set_num_threads(int value) { m_num_threads = value; }
+
  private:
+  //! new (noise) hit, added to the node tree once all sectors are digitized
+  struct NoiseHit
+  {
+    TrkrDefs::hitsetkey hitsetkey = 0;
+    TrkrDefs::hitkey hitkey = 0;
+    unsigned int adc = 0;
+  };
+
+  //! per sector random stream and work space
+  struct SectorData
+  {
+    //! random generator that conform with sPHENIX standard
+    gsl_rng *rng = nullptr;
+
+    //! signal hits for each layer
+    std::vector<std::vector<TrkrHitSet::ConstIterator> > layer_hits;
+
+    std::vector<std::vector<TrkrHitSet::ConstIterator> > phi_sorted_hits;
+    std::vector<float> adc_input;
+    std::vector<TrkrHit *> signal_hit_by_tbin;
+    std::vector<NoiseHit> noise_hits;
+  };
+
   void CalculateCylinderCellADCScale(PHCompositeNode *topNode);
   void DigitizeCylinderCells(PHCompositeNode *topNode);
-  float added_noise();
-  float add_noise_to_bin(float signal);
+  void DigitizeSector(PHG4TpcGeomContainer *, unsigned int side, unsigned int sector, SectorData &);
+  float added_noise(gsl_rng *) const;
+  float add_noise_to_bin(gsl_rng *, float signal) const;
 
   unsigned int TpcMinLayer {7};
   unsigned int TpcNLayers {48};
@@ -59,16 +93,23 @@ class PHG4TpcDigitizer : public SubsysReco
 
   bool skip_noise {false};
 
-  std::vector<std::vector<TrkrHitSet::ConstIterator> > phi_sorted_hits;
-  std::vector<float> adc_input;
-  std::vector<TrkrHit *> signal_hit_by_tbin;
+  //! number of threads
+  int m_num_threads {1};
+
+  //! PHRandomStream key
+  uint64_t m_random_key {0};
+
+  //! run number and local event count (fallback if there is no EventHeader), used to seed the sector random streams
+  int m_runnumber {0};
+  unsigned int m_event {0};
+
+  //! 12 sectors x 2 sides
+  static constexpr unsigned int m_nsectors = 24;
+  std::array<SectorData, m_nsectors> m_sector_data;
 
   // settings
   std::map<int, unsigned int> _max_adc;
   std::map<int, float> _energy_scale;
-
-  //! random generator that conform with sPHENIX standard
-  gsl_rng *RandomGenerator {nullptr};
 };
 
 #endif
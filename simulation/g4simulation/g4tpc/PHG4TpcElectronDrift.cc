@@ -36,6 +36,8 @@
 
 #include <pdbcalbase/PdbParameterMapContainer.h>
 
+#include <ffaobjects/EventHeader.h>
+
 #include <fun4all/Fun4AllReturnCodes.h>
 #include <fun4all/Fun4AllServer.h>
 #include <fun4all/SubsysReco.h>  // for SubsysReco
@@ -46,8 +48,9 @@
 #include <phool/PHNode.h>  // for PHNode
 #include <phool/PHNodeIterator.h>
 #include <phool/PHObject.h>  // for PHObject
-#include <phool/PHRandomSeed.h>
+#include <phool/PHRandomStream.h>
 #include <phool/getClass.h>
+#include <phool/recoConsts.h>
 #include <phool/phool.h>  // for PHWHERE
 
 #include <TFile.h>
@@ -59,15 +62,20 @@
 #include <gsl/gsl_randist.h>
 #include <gsl/gsl_rng.h>  // for gsl_rng_alloc
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cmath>    // for sqrt, abs, NAN
+#include <cstdint>
 #include <cstdlib>  // for exit
 #include <format>
 #include <iostream>
 #include <map>      // for _Rb_tree_cons...
+#include <syncstream>
 #include <utility>  // for pair
 
+#include <omp.h>
+
 namespace
 {
   template <class T>
@@ -84,8 +92,11 @@ PHG4TpcElectronDrift::PHG4TpcElectronDrift(const std::string &name)
   , single_hitsetcontainer(new TrkrHitSetContainerv1)
 {
   InitializeParameters();
-  RandomGenerator.reset(gsl_rng_alloc(gsl_rng_mt19937));
-  set_seed(PHRandomSeed());
+  for (auto &rng : RandomGenerators)
+  {
+    rng.reset(gsl_rng_alloc(gsl_rng_mt19937));
+  }
+  m_random_key = PHRandomStream::GetKey(name);
 }
 
 //_____________________________________________________________
@@ -196,6 +207,8 @@ int PHG4TpcElectronDrift::InitRun(PHCompositeNode *topNode)
   // from top of GEM stack to top of GEM stack
   tpc_length = 2 * (layergeom->get_max_driftlength() + layergeom->get_CM_halfwidth());
   
+  m_runnumber = recoConsts::instance()->get_IntFlag("RUNNUMBER", 0);
+
   UpdateParametersWithMacro();
   PHNodeIterator runIter(runNode);
   auto *RunDetNode = dynamic_cast<PHCompositeNode *>(runIter.findFirst("PHCompositeNode", detector));
@@ -438,15 +451,32 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
   PHG4TruthInfoContainer *truthinfo =
       findNode::getClass<PHG4TruthInfoContainer>(topNode, "G4TruthInfo");
 
+  m_drift_velocity = layergeom->get_drift_velocity_sim();
+
+  // each stream is seeded from (run, event, stream), independently of the processing order.
+  // The event number is the one of the EventHeader, the local event count is only a fallback
+  uint32_t event_number = event_num;
+  auto *evtheader = findNode::getClass<EventHeader>(topNode, "EventHeader");
+  if (evtheader)
+  {
+    event_number = evtheader->get_EvtSequence();
+  }
+  else if (event_num == 0)
+  {
+    std::cout << PHWHERE << " EventHeader not found, random streams are seeded with the local event count" << std::endl;
+  }
+  for (unsigned int istream = 0; istream < m_nrngstreams; ++istream)
+  {
+    gsl_rng_set(RandomGenerators[istream].get(), PHRandomStream::Seed(m_random_key, m_runnumber, event_number, istream));
+  }
+
   PHG4HitContainer::ConstRange hit_begin_end = g4hit->getHits();
-  unsigned int count_g4hits = 0;
   //  int count_electrons = 0;
 
   //  double ecollectedhits = 0.0;
   //  int ncollectedhits = 0;
   double ihit = 0;
   unsigned int dump_interval = 5000;  // dump temp_hitsetcontainer to the node tree after this many g4hits
-  unsigned int dump_counter = 0;
 
   int trkid = -1;
 
@@ -454,387 +484,225 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
   // if there is a big jump (such as crossing into the INTT area or out of the TPC)
   // then cluster the truth clusters before adding a new hit. This prevents
   // clustering loopers in the same HitSetKey surfaces in multiple passes
-  for (auto hiter = hit_begin_end.first; hiter != hit_begin_end.second; ++hiter)
+  auto hiter = hit_begin_end.first;
+  while (hiter != hit_begin_end.second)
   {
-    count_g4hits++;
-    dump_counter++;
-
-    const double t0 = std::fmax(hiter->second->get_t(0), hiter->second->get_t(1));
-    if (t0 > max_time)
+    // collect the next dump_interval g4hits and sort them by random stream
+    m_drifted_hits.clear();
+    for (auto &stream_hits : m_stream_hits)
     {
-      continue;
+      stream_hits.clear();
     }
 
-    int trkid_new = hiter->second->get_trkid();
-    if (trkid != trkid_new)
-    {  // starting a new track
-      prior_g4hit = nullptr;
-      if (truth_track)
+    for (unsigned int count = 0; hiter != hit_begin_end.second && count < dump_interval; ++hiter, ++count)
+    {
+      const double t0 = std::fmax(hiter->second->get_t(0), hiter->second->get_t(1));
+      if (t0 > max_time)
       {
-        truth_clusterer.cluster_hits(truth_track);
+        continue;
       }
-      trkid = trkid_new;
 
-      if (Verbosity() > 1000)
+      m_stream_hits[get_rng_stream(hiter->second)].push_back(m_drifted_hits.size());
+      auto &drifted_hit = m_drifted_hits.emplace_back();
+      drifted_hit.hiter = hiter;
+    }
+
+    // drift the electrons, one random stream per thread at a time
+    // each stream processes its g4hits in container order, so that the result does not depend on the number of threads
+    const int nthreads = m_num_threads >= 1 ? m_num_threads : omp_get_max_threads();
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+    for (unsigned int istream = 0; istream < m_nrngstreams; ++istream)
+    {
+      for (const auto &index : m_stream_hits[istream])
       {
-        std::cout << " New track : " << trkid << " is embed? : ";
+        drift_electrons(RandomGenerators[istream].get(), m_drifted_hits[index], ihit + index);
       }
+    }
 
-      if (truthinfo->isEmbeded(trkid))
-      {
-        truth_track = truthtracks->getTruthTrack(trkid, truthinfo);
-        truth_clusterer.b_collect_hits = true;
-        if (Verbosity() > 1000)
+    // map the drifted electrons to the pad plane in g4hit order
+    for (const auto &drifted_hit : m_drifted_hits)
+    {
+      const auto &drifted_hiter = drifted_hit.hiter;
+      int trkid_new = drifted_hiter->second->get_trkid();
+      if (trkid != trkid_new)
+      {  // starting a new track
+        prior_g4hit = nullptr;
+        if (truth_track)
         {
-          std::cout << " YES embedded" << std::endl;
+          truth_clusterer.cluster_hits(truth_track);
         }
-      }
-      else
-      {
-        truth_track = nullptr;
-        truth_clusterer.b_collect_hits = false;
+        trkid = trkid_new;
+
         if (Verbosity() > 1000)
         {
-          std::cout << " NOT embedded" << std::endl;
+          std::cout << " New track : " << trkid << " is embed? : ";
         }
-      }
-    }
 
-    // see if there is a jump in x or y relative to previous PHG4Hit
-    if (truth_clusterer.b_collect_hits)
-    {
-      if (prior_g4hit)
-      {
-        // if the g4hits jump in x or y by > max_g4hit_jump, cluster the truth tracks
-        if (std::abs(prior_g4hit->get_x(0) - hiter->second->get_x(0)) > max_g4hitstep || std::abs(prior_g4hit->get_y(0) - hiter->second->get_y(0)) > max_g4hitstep)
+        if (truthinfo->isEmbeded(trkid))
+        {
+          truth_track = truthtracks->getTruthTrack(trkid, truthinfo);
+          truth_clusterer.b_collect_hits = true;
+          if (Verbosity() > 1000)
+          {
+            std::cout << " YES embedded" << std::endl;
+          }
+        }
+        else
         {
-          if (truth_track)
+          truth_track = nullptr;
+          truth_clusterer.b_collect_hits = false;
+          if (Verbosity() > 1000)
           {
-            truth_clusterer.cluster_hits(truth_track);
+            std::cout << " NOT embedded" << std::endl;
           }
         }
       }
-      prior_g4hit = hiter->second;
-    }
-
-    // for very high occupancy events, accessing the TrkrHitsets on the node tree
-    // for every drifted electron seems to be very slow
-    // Instead, use a temporary map to accumulate the charge from all
-    // drifted electrons, then copy to the node tree later
-
-    double eion = hiter->second->get_eion();
-    unsigned int n_electrons = gsl_ran_poisson(RandomGenerator.get(), eion * electrons_per_gev);
-    //    count_electrons += n_electrons;
-
-    if (Verbosity() > 100)
-    {
-      std::cout << "  new hit with t0, " << t0 << " g4hitid " << hiter->first
-                << " eion " << eion << " n_electrons " << n_electrons
-                << " entry z " << hiter->second->get_z(0) << " exit z "
-                << hiter->second->get_z(1) << " avg z"
-                << (hiter->second->get_z(0) + hiter->second->get_z(1)) / 2.0
-                << std::endl;
-    }
 
-    if (n_electrons == 0)
-    {
-      continue;
-    }
-
-    if (Verbosity() > 100)
-    {
-      std::cout << std::endl
-                << "electron drift: g4hit " << hiter->first << " created electrons: "
-                << n_electrons << " from " << eion * 1000000 << " keV" << std::endl;
-      std::cout << " entry x,y,z = " << hiter->second->get_x(0) << "  "
-                << hiter->second->get_y(0) << "  " << hiter->second->get_z(0)
-                << " radius " << sqrt(pow(hiter->second->get_x(0), 2) + pow(hiter->second->get_y(0), 2)) << std::endl;
-      std::cout << " exit x,y,z = " << hiter->second->get_x(1) << "  "
-                << hiter->second->get_y(1) << "  " << hiter->second->get_z(1)
-                << " radius " << sqrt(pow(hiter->second->get_x(1), 2) + pow(hiter->second->get_y(1), 2)) << std::endl;
-    }
-
-    int notReachingReadout = 0;
-    //    int notInAcceptance = 0;
-    for (unsigned int i = 0; i < n_electrons; i++)
-    {
-      // We choose the electron starting position at random from a flat
-      // distribution along the path length the parameter t is the fraction of
-      // the distance along the path betwen entry and exit points, it has
-      // values between 0 and 1
-      const double f = gsl_ran_flat(RandomGenerator.get(), 0.0, 1.0);
-
-      const double x_start_glob = hiter->second->get_x(0) + f * (hiter->second->get_x(1) - hiter->second->get_x(0));
-      const double y_start_glob = hiter->second->get_y(0) + f * (hiter->second->get_y(1) - hiter->second->get_y(0));
-      const double z_start_glob = hiter->second->get_z(0) + f * (hiter->second->get_z(1) - hiter->second->get_z(0));
-      const double t_start = hiter->second->get_t(0) + f * (hiter->second->get_t(1) - hiter->second->get_t(0));
-
-      Acts::Vector3 start_glob(x_start_glob, y_start_glob, z_start_glob);
-      Acts::Vector3 start = m_tGeometry->transformTpcWorldToEnvelope(start_glob); // we drift in tpc envelope coords, where E is in the z direction
-
-      const double x_start = start.x();
-      const double y_start = start.y();
-      const double z_start = start.z();
-      /*
-      std::cout << " xg " << x_start_glob << " x " << x_start
-		<<" yg " << y_start_glob << " y " << y_start
-		<<" zg " << z_start_glob << " z " << z_start << std::endl;
-      */
-      unsigned int side = 0;
-      if (z_start > 0)
+      // see if there is a jump in x or y relative to previous PHG4Hit
+      if (truth_clusterer.b_collect_hits)
       {
-        side = 1;
+        if (prior_g4hit)
+        {
+          // if the g4hits jump in x or y by > max_g4hit_jump, cluster the truth tracks
+          if (std::abs(prior_g4hit->get_x(0) - drifted_hiter->second->get_x(0)) > max_g4hitstep || std::abs(prior_g4hit->get_y(0) - drifted_hiter->second->get_y(0)) > max_g4hitstep)
+          {
+            if (truth_track)
+            {
+              truth_clusterer.cluster_hits(truth_track);
+            }
+          }
+        }
+        prior_g4hit = drifted_hiter->second;
       }
 
-      const double r_sigma = diffusion_trans * sqrt(tpc_length / 2. - std::abs(z_start));
-      const double rantrans =
-          gsl_ran_gaussian(RandomGenerator.get(), r_sigma) +
-          gsl_ran_gaussian(RandomGenerator.get(), added_smear_sigma_trans);
-
-      const double t_path = (tpc_length / 2. - std::abs(z_start)) / layergeom->get_drift_velocity_sim();
-      const double t_sigma = diffusion_long * sqrt(tpc_length / 2. - std::abs(z_start)) / layergeom->get_drift_velocity_sim();
-      const double rantime =
-          gsl_ran_gaussian(RandomGenerator.get(), t_sigma) +
-	gsl_ran_gaussian(RandomGenerator.get(), added_smear_sigma_long) / layergeom->get_drift_velocity_sim();
-      double t_final = t_start + t_path + rantime;
-
-      if (t_final < min_time || t_final > max_time)
+      if (drifted_hit.n_electrons == 0)
       {
+        ++ihit;
         continue;
       }
 
-      double z_final;
-      if (z_start < 0)
-      {
-        z_final = -tpc_length / 2. + t_final * layergeom->get_drift_velocity_sim();
-      }
-      else
+      // for very high occupancy events, accessing the TrkrHitsets on the node tree
+      // for every drifted electron seems to be very slow
+      // Instead, use a temporary map to accumulate the charge from all
+      // drifted electrons, then copy to the node tree later
+      for (const auto &electron : drifted_hit.electrons)
       {
-        z_final = tpc_length / 2. - t_final * layergeom->get_drift_velocity_sim();
-      }
-
-      const double radstart = std::sqrt(square(x_start) + square(y_start));
-      const double phistart = std::atan2(y_start, x_start);
-      const double ranphi = gsl_ran_flat(RandomGenerator.get(), -M_PI, M_PI);
-
-      double x_final = x_start + rantrans * std::cos(ranphi);  // Initialize these to be only diffused first, will be overwritten if doing SC distortion
-      double y_final = y_start + rantrans * std::sin(ranphi);
-
-      double rad_final = sqrt(square(x_final) + square(y_final));
-      double phi_final = atan2(y_final, x_final);
+        padplane->MapToPadPlane(truth_clusterer, single_hitsetcontainer.get(),
+                                temp_hitsetcontainer.get(), hittruthassoc, electron.x, electron.y, electron.t,
+                                electron.side, drifted_hiter, ntpad, nthit);
+      }  // end loop over electrons for this g4hit
 
       if (do_ElectronDriftQAHistos)
       {
-        z_startmap->Fill(z_start, radstart);                   // map of starting location in Z vs. R
-        deltaphinodist->Fill(phistart, rantrans / rad_final);  // delta phi no distortion, just diffusion+smear
-        deltarnodist->Fill(radstart, rantrans);                // delta r no distortion, just diffusion+smear
+        ratioElectronsRR->Fill((double) (drifted_hit.n_electrons - drifted_hit.not_reaching_readout) / drifted_hit.n_electrons);
       }
 
-      if (m_distortionMap)
+      TrkrHitSetContainer::ConstRange single_hitset_range = single_hitsetcontainer->getHitSets(TrkrDefs::TrkrId::tpcId);
+      for (TrkrHitSetContainer::ConstIterator single_hitset_iter = single_hitset_range.first;
+           single_hitset_iter != single_hitset_range.second;
+           ++single_hitset_iter)
       {
-        // zhangcanyu
-        const double reaches = m_distortionMap->get_reaches_readout(radstart, phistart, z_start);
-        if (reaches < thresholdforreachesreadout)
-        {
-          notReachingReadout++;
-          continue;
-        }
-
-        const double r_distortion = m_distortionMap->get_r_distortion(radstart, phistart, z_start);
-        const double phi_distortion = m_distortionMap->get_rphi_distortion(radstart, phistart, z_start) / radstart;
-        const double z_distortion = m_distortionMap->get_z_distortion(radstart, phistart, z_start);
+        // we have an itrator to one TrkrHitSet for the Tpc from the single_hitsetcontainer
+        TrkrDefs::hitsetkey node_hitsetkey = single_hitset_iter->first;
+        const unsigned int layer = TrkrDefs::getLayer(node_hitsetkey);
+        const int sector = TpcDefs::getSectorId(node_hitsetkey);
+        const int side = TpcDefs::getSide(node_hitsetkey);
 
-        rad_final += r_distortion;
-        phi_final += phi_distortion;
-        z_final += z_distortion;
-        if (z_start < 0)
+        if (Verbosity() > 8)
         {
-          t_final = (z_final + tpc_length / 2.0) / layergeom->get_drift_velocity_sim();
+          std::cout << " hitsetkey " << node_hitsetkey << " layer " << layer << " sector " << sector << " side " << side << std::endl;
         }
-        else
-        {
-          t_final = (tpc_length / 2.0 - z_final) / layergeom->get_drift_velocity_sim();
-        }
-
-        x_final = rad_final * std::cos(phi_final);
-        y_final = rad_final * std::sin(phi_final);
-
-        //	if(i < 1)
-        //{std::cout << " electron " << i << " r_distortion " << r_distortion << " phi_distortion " << phi_distortion << " rad_final " << rad_final << " phi_final " << phi_final << " r*dphi distortion " << rad_final * phi_distortion << " z_distortion " << z_distortion << std::endl;}
-
-        if (do_ElectronDriftQAHistos)
+        // get all of the hits from the single hitset
+        TrkrHitSet::ConstRange single_hit_range = single_hitset_iter->second->getHits();
+        for (TrkrHitSet::ConstIterator single_hit_iter = single_hit_range.first;
+             single_hit_iter != single_hit_range.second;
+             ++single_hit_iter)
         {
-          const double phi_final_nodiff = phistart + phi_distortion;
-          const double rad_final_nodiff = radstart + r_distortion;
-          deltarnodiff->Fill(radstart, rad_final_nodiff - radstart);    // delta r no diffusion, just distortion
-          deltaphinodiff->Fill(phistart, phi_final_nodiff - phistart);  // delta phi no diffusion, just distortion
-          deltaphivsRnodiff->Fill(radstart, phi_final_nodiff - phistart);
-          deltaRphinodiff->Fill(radstart, rad_final_nodiff * phi_final_nodiff - radstart * phistart);
+          TrkrDefs::hitkey single_hitkey = single_hit_iter->first;
 
-          // Fill Diagnostic plots, written into ElectronDriftQA.root
-          hitmapstart->Fill(x_start, y_start);  // G4Hit starting positions
-          hitmapend->Fill(x_final, y_final);    // INcludes diffusion and distortion
-          hitmapstart_z->Fill(z_start, radstart);
-          hitmapend_z->Fill(z_final, rad_final);
-          deltar->Fill(radstart, rad_final - radstart);    // total delta r
-          deltaphi->Fill(phistart, phi_final - phistart);  // total delta phi
-          deltaz->Fill(z_start, z_distortion);             // map of distortion in Z (time)
+          // Add the hit-g4hit association
+          // no need to check for duplicates, since the hit is new
+          hittruthassoc->addAssoc(node_hitsetkey, single_hitkey, drifted_hiter->first);
+          if (Verbosity() > 100)
+          {
+            std::cout << "        adding assoc for node_hitsetkey " << node_hitsetkey << " single_hitkey " << single_hitkey << " g4hitkey " << drifted_hiter->first << std::endl;
+          }
         }
       }
 
-      // remove electrons outside of our acceptance. Careful though, electrons from just inside 30 cm can contribute in the 1st active layer readout, so leave a little margin
-      if (rad_final < min_active_radius - 2.0 || rad_final > max_active_radius + 1.0)
-      {
-        //        notInAcceptance++;
-        continue;
-      }
-
-      if (Verbosity() > 1000)
-      //      if(i < 1)
-      {
-        std::cout << "electron " << i << " g4hitid " << hiter->first << " f " << f << std::endl;
-        std::cout << "radstart " << radstart << " x_start: " << x_start
-                  << ", y_start: " << y_start
-                  << ",z_start: " << z_start
-                  << " t_start " << t_start
-                  << " t_path " << t_path
-                  << " t_sigma " << t_sigma
-                  << " rantime " << rantime
-                  << std::endl;
-
-        std::cout << "       rad_final " << rad_final << " x_final " << x_final
-                  << " y_final " << y_final
-                  << " z_final " << z_final << " t_final " << t_final
-                  << " zdiff " << z_final - z_start << std::endl;
-      }
+      ++ihit;
 
-      if (Verbosity() > 0)
-      {
-        assert(nt);
-        nt->Fill(ihit, t_start, t_final, t_sigma, rad_final, z_start, z_final);
-      }
-      padplane->MapToPadPlane(truth_clusterer, single_hitsetcontainer.get(),
-                              temp_hitsetcontainer.get(), hittruthassoc, x_final, y_final, t_final,
-                              side, hiter, ntpad, nthit);
-    }  // end loop over electrons for this g4hit
+      single_hitsetcontainer->Reset();
 
-    if (do_ElectronDriftQAHistos)
-    {
-      ratioElectronsRR->Fill((double) (n_electrons - notReachingReadout) / n_electrons);
-    }
+    }  // end loop over g4hits
 
-    TrkrHitSetContainer::ConstRange single_hitset_range = single_hitsetcontainer->getHitSets(TrkrDefs::TrkrId::tpcId);
-    for (TrkrHitSetContainer::ConstIterator single_hitset_iter = single_hitset_range.first;
-         single_hitset_iter != single_hitset_range.second;
-         ++single_hitset_iter)
+    // Dump the temp_hitsetcontainer to the node tree and reset it
+    //    - after every "dump_interval" g4hits
+    //    - if this is the last g4hit
+    double eg4hit = 0.0;
+    TrkrHitSetContainer::ConstRange temp_hitset_range = temp_hitsetcontainer->getHitSets(TrkrDefs::TrkrId::tpcId);
+    for (TrkrHitSetContainer::ConstIterator temp_hitset_iter = temp_hitset_range.first;
+         temp_hitset_iter != temp_hitset_range.second;
+         ++temp_hitset_iter)
     {
-      // we have an itrator to one TrkrHitSet for the Tpc from the single_hitsetcontainer
-      TrkrDefs::hitsetkey node_hitsetkey = single_hitset_iter->first;
+      // we have an itrator to one TrkrHitSet for the Tpc from the temp_hitsetcontainer
+      TrkrDefs::hitsetkey node_hitsetkey = temp_hitset_iter->first;
       const unsigned int layer = TrkrDefs::getLayer(node_hitsetkey);
       const int sector = TpcDefs::getSectorId(node_hitsetkey);
       const int side = TpcDefs::getSide(node_hitsetkey);
-
-      if (Verbosity() > 8)
+      if (Verbosity() > 100)
       {
-        std::cout << " hitsetkey " << node_hitsetkey << " layer " << layer << " sector " << sector << " side " << side << std::endl;
-      }
-      // get all of the hits from the single hitset
-      TrkrHitSet::ConstRange single_hit_range = single_hitset_iter->second->getHits();
-      for (TrkrHitSet::ConstIterator single_hit_iter = single_hit_range.first;
-           single_hit_iter != single_hit_range.second;
-           ++single_hit_iter)
-      {
-        TrkrDefs::hitkey single_hitkey = single_hit_iter->first;
-
-        // Add the hit-g4hit association
-        // no need to check for duplicates, since the hit is new
-        hittruthassoc->addAssoc(node_hitsetkey, single_hitkey, hiter->first);
-        if (Verbosity() > 100)
-        {
-          std::cout << "        adding assoc for node_hitsetkey " << node_hitsetkey << " single_hitkey " << single_hitkey << " g4hitkey " << hiter->first << std::endl;
-        }
+        std::cout << "PHG4TpcElectronDrift: temp_hitset with key: " << node_hitsetkey << " in layer " << layer
+                  << " with sector " << sector << " side " << side << std::endl;
       }
-    }
 
-    // Dump the temp_hitsetcontainer to the node tree and reset it
-    //    - after every "dump_interval" g4hits
-    //    - if this is the last g4hit
-    if (dump_counter >= dump_interval || count_g4hits == g4hit->size())
-    {
-      // std::cout << " dump_counter " << dump_counter << " count_g4hits " << count_g4hits << std::endl;
+      // find or add this hitset on the node tree
+      TrkrHitSetContainer::Iterator node_hitsetit = hitsetcontainer->findOrAddHitSet(node_hitsetkey);
 
-      double eg4hit = 0.0;
-      TrkrHitSetContainer::ConstRange temp_hitset_range = temp_hitsetcontainer->getHitSets(TrkrDefs::TrkrId::tpcId);
-      for (TrkrHitSetContainer::ConstIterator temp_hitset_iter = temp_hitset_range.first;
-           temp_hitset_iter != temp_hitset_range.second;
-           ++temp_hitset_iter)
+      // get all of the hits from the temporary hitset
+      TrkrHitSet::ConstRange temp_hit_range = temp_hitset_iter->second->getHits();
+      for (TrkrHitSet::ConstIterator temp_hit_iter = temp_hit_range.first;
+           temp_hit_iter != temp_hit_range.second;
+           ++temp_hit_iter)
       {
-        // we have an itrator to one TrkrHitSet for the Tpc from the temp_hitsetcontainer
-        TrkrDefs::hitsetkey node_hitsetkey = temp_hitset_iter->first;
-        const unsigned int layer = TrkrDefs::getLayer(node_hitsetkey);
-        const int sector = TpcDefs::getSectorId(node_hitsetkey);
-        const int side = TpcDefs::getSide(node_hitsetkey);
-        if (Verbosity() > 100)
+        TrkrDefs::hitkey temp_hitkey = temp_hit_iter->first;
+        TrkrHit *temp_tpchit = temp_hit_iter->second;
+        if (Verbosity() > 10 && layer == print_layer)
         {
-          std::cout << "PHG4TpcElectronDrift: temp_hitset with key: " << node_hitsetkey << " in layer " << layer
-                    << " with sector " << sector << " side " << side << std::endl;
-        }
+          std::cout << "      temp_hitkey " << temp_hitkey << " layer " << layer << " pad " << TpcDefs::getPad(temp_hitkey)
+                    << " z bin " << TpcDefs::getTBin(temp_hitkey)
+                    << "  energy " << temp_tpchit->getEnergy() << " eg4hit " << eg4hit << std::endl;
 
-        // find or add this hitset on the node tree
-        TrkrHitSetContainer::Iterator node_hitsetit = hitsetcontainer->findOrAddHitSet(node_hitsetkey);
-
-        // get all of the hits from the temporary hitset
-        TrkrHitSet::ConstRange temp_hit_range = temp_hitset_iter->second->getHits();
-        for (TrkrHitSet::ConstIterator temp_hit_iter = temp_hit_range.first;
-             temp_hit_iter != temp_hit_range.second;
-             ++temp_hit_iter)
-        {
-          TrkrDefs::hitkey temp_hitkey = temp_hit_iter->first;
-          TrkrHit *temp_tpchit = temp_hit_iter->second;
-          if (Verbosity() > 10 && layer == print_layer)
-          {
-            std::cout << "      temp_hitkey " << temp_hitkey << " layer " << layer << " pad " << TpcDefs::getPad(temp_hitkey)
-                      << " z bin " << TpcDefs::getTBin(temp_hitkey)
-                      << "  energy " << temp_tpchit->getEnergy() << " eg4hit " << eg4hit << std::endl;
-
-            eg4hit += temp_tpchit->getEnergy();
-            //            ecollectedhits += temp_tpchit->getEnergy();
-            //            ncollectedhits++;
-          }
-
-          // find or add this hit to the node tree
-          TrkrHit *node_hit = node_hitsetit->second->getHit(temp_hitkey);
-          if (!node_hit)
-          {
-            // Otherwise, create a new one
-            node_hit = new TrkrHitv2();
-            node_hitsetit->second->addHitSpecificKey(temp_hitkey, node_hit);
-          }
-
-          // Either way, add the energy to it
-          node_hit->addEnergy(temp_tpchit->getEnergy());
-
-        }  // end loop over temp hits
+          eg4hit += temp_tpchit->getEnergy();
+          //            ecollectedhits += temp_tpchit->getEnergy();
+          //            ncollectedhits++;
+        }
 
-        if (Verbosity() > 100 && layer == print_layer)
+        // find or add this hit to the node tree
+        TrkrHit *node_hit = node_hitsetit->second->getHit(temp_hitkey);
+        if (!node_hit)
         {
-          std::cout << "  ihit " << ihit << " collected energy = " << eg4hit << std::endl;
+          // Otherwise, create a new one
+          node_hit = new TrkrHitv2();
+          node_hitsetit->second->addHitSpecificKey(temp_hitkey, node_hit);
         }
 
-      }  // end loop over temp hitsets
+        // Either way, add the energy to it
+        node_hit->addEnergy(temp_tpchit->getEnergy());
 
-      // erase all entries in the temp hitsetcontainer
-      temp_hitsetcontainer->Reset();
+      }  // end loop over temp hits
 
-      // reset the dump counter
-      dump_counter = 0;
-    }  // end copy of temp hitsetcontainer to node tree hitsetcontainer
+      if (Verbosity() > 100 && layer == print_layer)
+      {
+        std::cout << "  ihit " << ihit << " collected energy = " << eg4hit << std::endl;
+      }
 
-    ++ihit;
+    }  // end loop over temp hitsets
 
-    single_hitsetcontainer->Reset();
+    // erase all entries in the temp hitsetcontainer
+    temp_hitsetcontainer->Reset();
 
-  }  // end loop over g4hits
+  }  // end loop over g4hit chunks
 
   if (truth_track)
   {
@@ -946,8 +814,222 @@ int PHG4TpcElectronDrift::End(PHCompositeNode * /*topNode*/)
 
 void PHG4TpcElectronDrift::set_seed(const unsigned int seed)
 {
-  gsl_rng_set(RandomGenerator.get(), seed);
+  m_random_key = seed;
+}
+
+unsigned int PHG4TpcElectronDrift::get_rng_stream(const PHG4Hit *g4hit)
+{
+  // sector is given by the entry point phi, side by the entry point z
+  // this only needs to be deterministic, not to match the TPC hitset sector exactly
+  const double phi = std::atan2(g4hit->get_y(0), g4hit->get_x(0));
+  auto sector = static_cast<unsigned int>(12 * (phi + M_PI) / (2 * M_PI));
+  sector = std::min(sector, 11U);
+  const unsigned int side = g4hit->get_z(0) > 0 ? 1 : 0;
+  return side * 12 + sector;
 }
+void PHG4TpcElectronDrift::drift_electrons(gsl_rng *rng, DriftedHit &drifted_hit, double ihit)
+{
+  const auto &hiter = drifted_hit.hiter;
+  drifted_hit.electrons.clear();
+  drifted_hit.not_reaching_readout = 0;
+
+  double eion = hiter->second->get_eion();
+  unsigned int n_electrons = gsl_ran_poisson(rng, eion * electrons_per_gev);
+  drifted_hit.n_electrons = n_electrons;
+
+  if (Verbosity() > 100)
+  {
+    std::osyncstream(std::cout)
+        << "  new hit with t0, " << std::fmax(hiter->second->get_t(0), hiter->second->get_t(1)) << " g4hitid " << hiter->first
+        << " eion " << eion << " n_electrons " << n_electrons
+        << " entry z " << hiter->second->get_z(0) << " exit z "
+        << hiter->second->get_z(1) << " avg z"
+        << (hiter->second->get_z(0) + hiter->second->get_z(1)) / 2.0
+        << std::endl;
+  }
+
+  if (n_electrons == 0)
+  {
+    return;
+  }
+
+  if (Verbosity() > 100)
+  {
+    std::osyncstream(std::cout)
+        << std::endl
+        << "electron drift: g4hit " << hiter->first << " created electrons: "
+        << n_electrons << " from " << eion * 1000000 << " keV" << std::endl
+        << " entry x,y,z = " << hiter->second->get_x(0) << "  "
+        << hiter->second->get_y(0) << "  " << hiter->second->get_z(0)
+        << " radius " << sqrt(pow(hiter->second->get_x(0), 2) + pow(hiter->second->get_y(0), 2)) << std::endl
+        << " exit x,y,z = " << hiter->second->get_x(1) << "  "
+        << hiter->second->get_y(1) << "  " << hiter->second->get_z(1)
+        << " radius " << sqrt(pow(hiter->second->get_x(1), 2) + pow(hiter->second->get_y(1), 2)) << std::endl;
+  }
+
+  drifted_hit.electrons.reserve(n_electrons);
+  for (unsigned int i = 0; i < n_electrons; i++)
+  {
+    // We choose the electron starting position at random from a flat
+    // distribution along the path length the parameter t is the fraction of
+    // the distance along the path betwen entry and exit points, it has
+    // values between 0 and 1
+    const double f = gsl_ran_flat(rng, 0.0, 1.0);
+
+    const double x_start_glob = hiter->second->get_x(0) + f * (hiter->second->get_x(1) - hiter->second->get_x(0));
+    const double y_start_glob = hiter->second->get_y(0) + f * (hiter->second->get_y(1) - hiter->second->get_y(0));
+    const double z_start_glob = hiter->second->get_z(0) + f * (hiter->second->get_z(1) - hiter->second->get_z(0));
+    const double t_start = hiter->second->get_t(0) + f * (hiter->second->get_t(1) - hiter->second->get_t(0));
+
+    Acts::Vector3 start_glob(x_start_glob, y_start_glob, z_start_glob);
+    Acts::Vector3 start = m_tGeometry->transformTpcWorldToEnvelope(start_glob);  // we drift in tpc envelope coords, where E is in the z direction
+
+    const double x_start = start.x();
+    const double y_start = start.y();
+    const double z_start = start.z();
+
+    unsigned int side = 0;
+    if (z_start > 0)
+    {
+      side = 1;
+    }
+
+    const double r_sigma = diffusion_trans * sqrt(tpc_length / 2. - std::abs(z_start));
+    const double rantrans =
+        gsl_ran_gaussian(rng, r_sigma) +
+        gsl_ran_gaussian(rng, added_smear_sigma_trans);
+
+    const double t_path = (tpc_length / 2. - std::abs(z_start)) / m_drift_velocity;
+    const double t_sigma = diffusion_long * sqrt(tpc_length / 2. - std::abs(z_start)) / m_drift_velocity;
+    const double rantime =
+        gsl_ran_gaussian(rng, t_sigma) +
+        gsl_ran_gaussian(rng, added_smear_sigma_long) / m_drift_velocity;
+    double t_final = t_start + t_path + rantime;
+
+    if (t_final < min_time || t_final > max_time)
+    {
+      continue;
+    }
+
+    double z_final;
+    if (z_start < 0)
+    {
+      z_final = -tpc_length / 2. + t_final * m_drift_velocity;
+    }
+    else
+    {
+      z_final = tpc_length / 2. - t_final * m_drift_velocity;
+    }
+
+    const double radstart = std::sqrt(square(x_start) + square(y_start));
+    const double phistart = std::atan2(y_start, x_start);
+    const double ranphi = gsl_ran_flat(rng, -M_PI, M_PI);
+
+    double x_final = x_start + rantrans * std::cos(ranphi);  // Initialize these to be only diffused first, will be overwritten if doing SC distortion
+    double y_final = y_start + rantrans * std::sin(ranphi);
+
+    double rad_final = sqrt(square(x_final) + square(y_final));
+    double phi_final = atan2(y_final, x_final);
+
+    if (do_ElectronDriftQAHistos)
+    {
+      // histograms are shared between threads
+#pragma omp critical(PHG4TpcElectronDrift_QA)
+      {
+        z_startmap->Fill(z_start, radstart);                   // map of starting location in Z vs. R
+        deltaphinodist->Fill(phistart, rantrans / rad_final);  // delta phi no distortion, just diffusion+smear
+        deltarnodist->Fill(radstart, rantrans);                // delta r no distortion, just diffusion+smear
+      }
+    }
+
+    if (m_distortionMap)
+    {
+      // zhangcanyu
+      const double reaches = m_distortionMap->get_reaches_readout(radstart, phistart, z_start);
+      if (reaches < thresholdforreachesreadout)
+      {
+        ++drifted_hit.not_reaching_readout;
+        continue;
+      }
+
+      const double r_distortion = m_distortionMap->get_r_distortion(radstart, phistart, z_start);
+      const double phi_distortion = m_distortionMap->get_rphi_distortion(radstart, phistart, z_start) / radstart;
+      const double z_distortion = m_distortionMap->get_z_distortion(radstart, phistart, z_start);
+
+      rad_final += r_distortion;
+      phi_final += phi_distortion;
+      z_final += z_distortion;
+      if (z_start < 0)
+      {
+        t_final = (z_final + tpc_length / 2.0) / m_drift_velocity;
+      }
+      else
+      {
+        t_final = (tpc_length / 2.0 - z_final) / m_drift_velocity;
+      }
+
+      x_final = rad_final * std::cos(phi_final);
+      y_final = rad_final * std::sin(phi_final);
+
+      if (do_ElectronDriftQAHistos)
+      {
+        const double phi_final_nodiff = phistart + phi_distortion;
+        const double rad_final_nodiff = radstart + r_distortion;
+
+#pragma omp critical(PHG4TpcElectronDrift_QA)
+        {
+          deltarnodiff->Fill(radstart, rad_final_nodiff - radstart);    // delta r no diffusion, just distortion
+          deltaphinodiff->Fill(phistart, phi_final_nodiff - phistart);  // delta phi no diffusion, just distortion
+          deltaphivsRnodiff->Fill(radstart, phi_final_nodiff - phistart);
+          deltaRphinodiff->Fill(radstart, rad_final_nodiff * phi_final_nodiff - radstart * phistart);
+
+          // Fill Diagnostic plots, written into ElectronDriftQA.root
+          hitmapstart->Fill(x_start, y_start);  // G4Hit starting positions
+          hitmapend->Fill(x_final, y_final);    // INcludes diffusion and distortion
+          hitmapstart_z->Fill(z_start, radstart);
+          hitmapend_z->Fill(z_final, rad_final);
+          deltar->Fill(radstart, rad_final - radstart);    // total delta r
+          deltaphi->Fill(phistart, phi_final - phistart);  // total delta phi
+          deltaz->Fill(z_start, z_distortion);             // map of distortion in Z (time)
+        }
+      }
+    }
+
+    // remove electrons outside of our acceptance. Careful though, electrons from just inside 30 cm can contribute in the 1st active layer readout, so leave a little margin
+    if (rad_final < min_active_radius - 2.0 || rad_final > max_active_radius + 1.0)
+    {
+      continue;
+    }
+
+    if (Verbosity() > 1000)
+    {
+      std::osyncstream(std::cout)
+          << "electron " << i << " g4hitid " << hiter->first << " f " << f << std::endl
+          << "radstart " << radstart << " x_start: " << x_start
+          << ", y_start: " << y_start
+          << ",z_start: " << z_start
+          << " t_start " << t_start
+          << " t_path " << t_path
+          << " t_sigma " << t_sigma
+          << " rantime " << rantime
+          << std::endl
+          << "       rad_final " << rad_final << " x_final " << x_final
+          << " y_final " << y_final
+          << " z_final " << z_final << " t_final " << t_final
+          << " zdiff " << z_final - z_start << std::endl;
+    }
+
+    if (Verbosity() > 0)
+    {
+      assert(nt);
+#pragma omp critical(PHG4TpcElectronDrift_QA)
+      nt->Fill(ihit, t_start, t_final, t_sigma, rad_final, z_start, z_final);
+    }
+
+    drifted_hit.electrons.push_back({x_final, y_final, t_final, side});
+  }  // end loop over electrons for this g4hit
+}
+
 
 void PHG4TpcElectronDrift::SetDefaultParameters()
 {
@@ -17,11 +17,14 @@
 
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
+class PHG4Hit;
 class PHG4TpcPadPlane;
 class PHG4TpcDistortion;
 class PHCompositeNode;
@@ -65,8 +68,18 @@ class PHG4TpcElectronDrift : public SubsysReco, public PHParameterInterface
   }
 
   //! random seed
+  /**
+   * the seed is used as PHRandomStream key. It initializes one independent random stream
+   * per TPC sector, side and event, so that the drifted electrons do not depend on the number of threads
+   */
   void set_seed(const unsigned int iseed);
 
+  //! number of threads used to drift electrons
+  /**
+   * default is 1. 0 corresponds to allocating as many threads as available on the host
+   */
+  void set_num_threads(int value) { m_num_threads = value; }
+
   //! setup TPC distortion
   void setTpcDistortion(PHG4TpcDistortion *);
 
@@ -162,7 +175,54 @@ class PHG4TpcElectronDrift : public SubsysReco, public PHParameterInterface
     //! deletion operator
     void operator()(gsl_rng *rng) const { gsl_rng_free(rng); }
   };
-  std::unique_ptr<gsl_rng, Deleter> RandomGenerator;
+
+  //! one random stream per sector and side
+  static constexpr unsigned int m_nrngstreams = 24;
+
+  //! PHRandomStream key
+  uint64_t m_random_key = 0;
+
+  //! run number, used to seed the random streams
+  int m_runnumber = 0;
+
+  std::array<std::unique_ptr<gsl_rng, Deleter>, m_nrngstreams> RandomGenerators;
+
+  //! electron position and time at the readout plane
+  struct DriftedElectron
+  {
+    double x = 0;
+    double y = 0;
+    double t = 0;
+    unsigned int side = 0;
+  };
+
+  //! drifted electrons from a single g4hit
+  struct DriftedHit
+  {
+    PHG4HitContainer::ConstIterator hiter;
+    unsigned int n_electrons = 0;
+    int not_reaching_readout = 0;
+    std::vector<DriftedElectron> electrons;
+  };
+
+  //! random stream (sector and side) a given g4hit is assigned to
+  static unsigned int get_rng_stream(const PHG4Hit *);
+
+  //! drift all electrons from a given g4hit to the readout plane
+  /** this method is called concurrently for g4hits belonging to different random streams */
+  void drift_electrons(gsl_rng *, DriftedHit &, double ihit);
+
+  //! g4hits being drifted, in container order
+  std::vector<DriftedHit> m_drifted_hits;
+
+  //! indices in m_drifted_hits, for each random stream
+  std::array<std::vector<size_t>, m_nrngstreams> m_stream_hits;
+
+  //! drift velocity, cached per event
+  double m_drift_velocity = std::numeric_limits<double>::quiet_NaN();
+
+  //! number of threads
+  int m_num_threads = 1;
 };
 
 #endif  // G4TPC_PHG4TPCELECTRONDRIFT_H
@@ -22,6 +22,7 @@
 #include <calobase/TowerInfoContainer.h>
 #include <calobase/TowerInfoContainerSimv3.h>
 #include <calobase/TowerInfoDefs.h>
+#include <calobase/TowerWaveformContainerv1.h>
 
 #include <caloreco/CaloTowerDefs.h>
 
@@ -43,6 +44,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <map>
+#include <span>
 
 double CaloWaveformSim::template_function(double *x, double *par)
 {
@@ -561,6 +563,14 @@ int CaloWaveformSim::process_event(PHCompositeNode *topNode)
       m_CaloWaveformContainer->get_tower_at_channel(i)->set_waveform_value(j, m_waveforms.at(i).at(j));
     }
   }
+  if (m_PackedWaveformContainer)
+  {
+    m_PackedWaveformContainer->Reset();
+    for (const auto &waveform : m_waveforms)
+    {
+      m_PackedWaveformContainer->add_waveform(std::span<const float>(waveform));
+    }
+  }
   delete f_fit;
   return Fun4AllReturnCodes::EVENT_OK;
 }
@@ -679,4 +689,11 @@ void CaloWaveformSim::CreateNodeTree(PHCompositeNode *topNode)
   }
   PHIODataNode<PHObject> *newTowerNode = new PHIODataNode<PHObject>(m_CaloWaveformContainer, "WAVEFORM_" + m_detector, "PHObject");
   DetNode->addNode(newTowerNode);
+
+  if (m_dopackedwaveforms)
+  {
+    m_PackedWaveformContainer = new TowerWaveformContainerv1(m_packedwaveformencoding);
+    PHIODataNode<PHObject> *newWaveformNode = new PHIODataNode<PHObject>(m_PackedWaveformContainer, "PACKEDWAVEFORM_" + m_detector, "PHObject");
+    DetNode->addNode(newWaveformNode);
+  }
 }
@@ -13,6 +13,7 @@
 #include <fun4all/SubsysReco.h>
 
 #include <calobase/TowerInfoDefs.h>
+#include <calobase/TowerWaveformContainerv1.h>
 #include <caloreco/CaloTowerDefs.h>
 
 #include <g4detectors/LightCollectionModel.h>
@@ -30,6 +31,7 @@ class PHG4CylinderCellGeom_Spacalv1;
 class PHG4CylinderGeom_Spacalv3;
 class CDBTTree;
 class TowerInfoContainer;
+class TowerWaveformContainer;
 
 class CaloWaveformSim : public SubsysReco
 {
@@ -155,6 +157,13 @@ class CaloWaveformSim : public SubsysReco
   void set_fixpedestal(int fixpedestal) { m_fixpedestal = fixpedestal; }
   void set_gaussian_noise(int gaussian_noise) { m_gaussian_noise = gaussian_noise; }
 
+  // also store the waveforms of all channels packed in one buffer, in the node PACKEDWAVEFORM_<detector>
+  void set_packed_waveforms(bool dopackedwaveforms = true, TowerWaveformContainerv1::Encoding encoding = TowerWaveformContainerv1::kPacked)
+  {
+    m_dopackedwaveforms = dopackedwaveforms;
+    m_packedwaveformencoding = encoding;
+  }
+
   // Light collection model access
   LightCollectionModel &get_light_collection_model() { return light_collection_model; }
 
@@ -173,6 +182,10 @@ class CaloWaveformSim : public SubsysReco
   // containers
   TowerInfoContainer *m_CaloWaveformContainer{nullptr};
   TowerInfoContainer *m_PedestalContainer{nullptr};
+  TowerWaveformContainer *m_PackedWaveformContainer{nullptr};
+
+  bool m_dopackedwaveforms{false};
+  TowerWaveformContainerv1::Encoding m_packedwaveformencoding{TowerWaveformContainerv1::kPacked};
 
   CDBTTree *cdbttree{nullptr};
   CDBTTree *cdbttree_MC{nullptr};